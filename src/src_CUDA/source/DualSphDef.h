@@ -305,6 +305,7 @@ typedef enum{
   SDAT_Vtk=2,        ///<VTK format .vtk
   SDAT_Csv=4,        ///<CSV format .csv
   SDAT_Info=8,
+  SDAT_Vtu=16,       ///<VTK XML format .vtu (binary)
   SDAT_None=0 
 }TpSaveDat; 
 
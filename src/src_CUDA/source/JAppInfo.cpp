@@ -25,6 +25,9 @@ You should have received a copy of the GNU Lesser General Public License along w
 #ifdef JAppInfo_UseLog
   #include "JLog2.h"
 #endif
+#ifdef JAppInfo_UseSeries
+  #include "JSeriesSink.h"
+#endif
 
 using namespace std;
 
@@ -39,6 +42,9 @@ JAppInfo::JAppInfo(std::string name,std::string ver,std::string date){
   #ifdef JAppInfo_UseLog
     Log=NULL;
   #endif
+  #ifdef JAppInfo_UseSeries
+    Series=NULL;
+  #endif
   Reset();
   MainName=name; MainVer=ver; Date=date;
 }
@@ -53,6 +59,9 @@ JAppInfo::JAppInfo(std::string name,std::string ver
   #ifdef JAppInfo_UseLog
     Log=NULL;
   #endif
+  #ifdef JAppInfo_UseSeries
+    Series=NULL;
+  #endif
   Reset();
   MainName=name; MainVer=ver; Date=date;
   SubName=subname;
@@ -80,6 +89,11 @@ void JAppInfo::Reset(){
   CreateDirs=true;
   CsvSepComa=false;
   DirOut=DirDataOut="";
+  //-Time series definition.
+  #ifdef JAppInfo_UseSeries
+    delete Series; Series=NULL;
+    SeriesCsv=true; SeriesBin=false;
+  #endif
   //-Log definition.
   #ifdef JAppInfo_UseLog
     delete Log; Log=NULL;
@@ -130,6 +144,37 @@ void JAppInfo::LogInit(std::string fname,bool mpirun,int mpirank,int mpilaunch){
 }
 #endif
 
+#ifdef JAppInfo_UseSeries
+//==============================================================================
+// Configures output formats of time series. The object is created on demand.
+//==============================================================================
+void JAppInfo::SeriesInit(bool svcsv,bool svbin){
+  delete Series; Series=NULL;
+  SeriesCsv=svcsv; SeriesBin=svbin;
+}
+
+//==============================================================================
+// Returns object to save time series (it is created when it does not exist).
+//==============================================================================
+JSeriesSink* JAppInfo::SeriesPtr(){
+  if(!Series){
+    #ifdef JAppInfo_UseLog
+      Series=new JSeriesSink(SeriesCsv,SeriesBin,CsvSepComa,Log);
+    #else
+      Series=new JSeriesSink(SeriesCsv,SeriesBin,CsvSepComa,NULL);
+    #endif
+  }
+  return(Series);
+}
+
+//==============================================================================
+// Writes all pending records of time series and closes their files.
+//==============================================================================
+void JAppInfo::SeriesFinish(){
+  if(Series)Series->Finish();
+}
+#endif
+
 
 //==============================================================================
 // Returns short application name.
@@ -26,6 +26,7 @@ You should have received a copy of the GNU Lesser General Public License along w
 //:# - Nuevos metodos ClearNameExtra() y AddNameExtra(). (23-05-2018)
 //:# - Nuevos metodos GetMainName(), GetMainVer() y GetDate(). (07-03-2019)
 //:# - El uso de JLog2 o no se define en JAppInfoDef.h. (17-06-2020)
+//:# - Recurso JSeriesSink para grabar series temporales (JAppInfo_UseSeries). (19-10-2026)
 //:#############################################################################
 
 /// \file JAppInfo.h \brief Declares the class \ref JAppInfo and the global object AppInfo.
@@ -39,6 +40,7 @@ You should have received a copy of the GNU Lesser General Public License along w
 #include <string>
 
 class JLog2;
+class JSeriesSink;
 
 //##############################################################################
 //# JAppInfo
@@ -72,6 +74,13 @@ private:
   JLog2* Log;
 #endif
 
+  //-Time series definition.
+#ifdef JAppInfo_UseSeries
+  JSeriesSink* Series;
+  bool SeriesCsv;    ///<Saves time series in CSV files (true by default).
+  bool SeriesBin;    ///<Saves time series in binary files (false by default).
+#endif
+
 public:
   JAppInfo(std::string name,std::string ver,std::string date);
   JAppInfo(std::string name,std::string ver,std::string subname,std::string subver,std::string date);
@@ -93,6 +102,12 @@ public:
   bool LogDefined()const{ return(false); }
 #endif
 
+#ifdef JAppInfo_UseSeries
+  void SeriesInit(bool svcsv,bool svbin);
+  JSeriesSink* SeriesPtr();
+  void SeriesFinish();
+#endif
+
   std::string GetShortName()const;
   std::string GetFullName()const;
 
@@ -17,4 +17,5 @@
 */
 
 #define JAppInfo_UseLog  //-Enables or disables the use of JLog2.
+#define JAppInfo_UseSeries  //-Enables or disables the use of JSeriesSink.
 
@@ -19,6 +19,7 @@
 /// \file JArraysCpu.cpp \brief Implements the class \ref JArraysCpu.
 
 #include "JArraysCpu.h"
+#include "JArraysCpuProfiler.h"
 #include "Functions.h"
 #include <cstdio>
 #include <algorithm>
@@ -36,6 +37,8 @@ JArraysCpuSize::JArraysCpuSize(unsigned elementsize):ElementSize(elementsize){
   for(unsigned c=0;c<MAXPOINTERS;c++)Pointers[c]=NULL;
   Count=0;
   CountMax=CountUsedMax=0;
+  AutoGrow=false;
+  CountGrown=0;
   Reset();
 }
 
@@ -151,6 +154,10 @@ void JArraysCpuSize::SetArraySize(unsigned size){
 /// Requests allocating an array.
 //==============================================================================
 void* JArraysCpuSize::Reserve(){
+  if(CountUsed==Count && AutoGrow && ArraySize && Count<MAXPOINTERS){
+    SetArrayCount(Count+1);
+    CountGrown++;
+  }
   if(CountUsed==Count||!ArraySize)Run_Exceptioon(fun::PrintStr("There are no arrays available with %u bytes.",ElementSize));
   CountUsed++;
   CountUsedMax=max(CountUsedMax,CountUsed);
@@ -246,6 +253,43 @@ llong JArraysCpu::GetAllocMemoryCpu()const{
   return(m);
 }
 
+//==============================================================================
+/// Reserva un array y lo notifica al profiler de memoria.
+/// Allocates an array and notifies it to the memory profiler.
+//==============================================================================
+void* JArraysCpu::ReserveArray(JArraysCpuSize *arrays,const char *name){
+  void *pointer=arrays->Reserve();
+  if(JArraysCpuProfiler::Active)JArraysCpuProfiler::Active->Reserve(pointer,name,arrays->GetElementSize(),arrays->GetArraySize());
+  return(pointer);
+}
+
+//==============================================================================
+/// Libera la reserva de un array y lo notifica al profiler de memoria.
+/// Frees an allocated array and notifies it to the memory profiler.
+//==============================================================================
+void JArraysCpu::FreeArray(JArraysCpuSize *arrays,void *pointer){
+  arrays->Free(pointer);
+  if(pointer && JArraysCpuProfiler::Active)JArraysCpuProfiler::Active->Free(pointer);
+}
+
+//==============================================================================
+/// Ajusta el numero de arrays de cada tamano al maximo usado y activa el
+/// crecimiento bajo demanda. Devuelve la memoria liberada.
+/// Reduces the number of arrays of each size to the maximum used and enables
+/// the allocation on demand. Returns the released memory.
+//==============================================================================
+llong JArraysCpu::TightenArrayCount(){
+  const llong mem0=GetAllocMemoryCpu();
+  JArraysCpuSize* vars[8]={Arrays1b,Arrays2b,Arrays4b,Arrays8b,Arrays12b,Arrays16b,Arrays24b,Arrays32b};
+  for(unsigned c=0;c<8;c++){
+    JArraysCpuSize* ars=vars[c];
+    const unsigned count=max(ars->GetArrayCountUsedMax(),ars->GetArrayCountUsed());
+    if(count<ars->GetArrayCount())ars->SetArrayCount(count);
+    ars->SetAutoGrow(true);
+  }
+  return(mem0-GetAllocMemoryCpu());
+}
+
 //==============================================================================
 /// Cambia el numero de elementos de los arrays.
 /// Si hay algun array en uso lanza una excepcion.
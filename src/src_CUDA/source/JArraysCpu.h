@@ -22,6 +22,10 @@
 //:# - Codigo creado a partir de JArraysGpu para usar con memoria CPU. (10-03-2014)
 //:# - Remplaza long long por llong. (01-10-2015)
 //:# - Mejora la gestion de excepciones. (06-05-2020)
+//:# - Las reservas pueden indicar el nombre del array y se notifican al
+//:#   profiler de memoria (JArraysCpuProfiler::Active). (19-10-2026)
+//:# - Nuevo metodo TightenArrayCount() que ajusta el numero de arrays de cada
+//:#   tamano al maximo usado y activa el crecimiento bajo demanda. (19-10-2026)
 //:#############################################################################
 
 /// \file JArraysCpu.h \brief Declares the class \ref JArraysCpu.
@@ -49,6 +53,8 @@ protected:
   unsigned CountUsed;
 
   unsigned CountMax,CountUsedMax;
+  bool AutoGrow;         ///<Allocates a new array when all of them are in use.
+  unsigned CountGrown;   ///<Number of arrays allocated on demand.
   
   void* AllocPointer(unsigned size)const;
   void FreePointer(void* pointer)const;
@@ -60,6 +66,8 @@ public:
   JArraysCpuSize(unsigned elementsize);
   ~JArraysCpuSize();
   void Reset();
+
+  unsigned GetElementSize()const{ return(ElementSize); }
   
   void SetArrayCount(unsigned count);
   unsigned GetArrayCount()const{ return(Count); }
@@ -68,6 +76,9 @@ public:
   unsigned GetArrayCountMax()const{ return(CountMax); }
   unsigned GetArrayCountUsedMax()const{ return(CountUsedMax); }
 
+  void SetAutoGrow(bool autogrow){ AutoGrow=autogrow; }
+  unsigned GetArrayCountGrown()const{ return(CountGrown); }
+
   void SetArraySize(unsigned size);
   unsigned GetArraySize()const{ return(ArraySize); }
 
@@ -98,6 +109,9 @@ protected:
   JArraysCpuSize *Arrays24b;
   JArraysCpuSize *Arrays32b;
   
+  void* ReserveArray(JArraysCpuSize *arrays,const char *name);
+  void FreeArray(JArraysCpuSize *arrays,void *pointer);
+
   JArraysCpuSize* GetArrays(TpArraySize tsize)const{ return(tsize==SIZE_32B? Arrays32b: (tsize==SIZE_24B? Arrays24b: (tsize==SIZE_16B? Arrays16b: (tsize==SIZE_12B? Arrays12b: (tsize==SIZE_8B? Arrays8b: (tsize==SIZE_4B? Arrays4b: (tsize==SIZE_2B? Arrays2b: Arrays1b))))))); }
 
 public:
@@ -110,38 +124,42 @@ public:
   void AddArrayCount(TpArraySize tsize,unsigned count=1){ SetArrayCount(tsize,GetArrayCount(tsize)+count); }
   unsigned GetArrayCount(TpArraySize tsize)const{ return(GetArrays(tsize)->GetArrayCount()); }
   unsigned GetArrayCountUsed(TpArraySize tsize)const{ return(GetArrays(tsize)->GetArrayCountUsed()); }
+  unsigned GetArrayCountUsedMax(TpArraySize tsize)const{ return(GetArrays(tsize)->GetArrayCountUsedMax()); }
+  unsigned GetArrayCountGrown(TpArraySize tsize)const{ return(GetArrays(tsize)->GetArrayCountGrown()); }
+  llong TightenArrayCount();
 
   void SetArraySize(unsigned size);
   unsigned GetArraySize()const{ return(Arrays1b->GetArraySize()); }
 
-  byte*        ReserveByte(){       return((byte*)Arrays1b->Reserve());         }
-  word*        ReserveWord(){       return((word*)Arrays2b->Reserve());         }
-  unsigned*    ReserveUint(){       return((unsigned*)Arrays4b->Reserve());     }
-  int*         ReserveInt(){        return((int*)Arrays4b->Reserve());          }
-  float*       ReserveFloat(){      return((float*)Arrays4b->Reserve());        }
-  tfloat3*     ReserveFloat3(){     return((tfloat3*)Arrays12b->Reserve());     }
-  tfloat4*     ReserveFloat4(){     return((tfloat4*)Arrays16b->Reserve());     }
-  double*      ReserveDouble(){     return((double*)Arrays8b->Reserve());       }
-  tdouble2*    ReserveDouble2(){    return((tdouble2*)Arrays16b->Reserve());    }
-  tdouble3*    ReserveDouble3(){    return((tdouble3*)Arrays24b->Reserve());    }
-  tsymatrix3f* ReserveSymatrix3f(){ return((tsymatrix3f*)Arrays24b->Reserve()); }
+  //-Reservations with name of the array (used by JArraysCpuProfiler).
+  byte*        ReserveByte      (const char *name=NULL){ return((byte*)       ReserveArray(Arrays1b ,name)); }
+  word*        ReserveWord      (const char *name=NULL){ return((word*)       ReserveArray(Arrays2b ,name)); }
+  unsigned*    ReserveUint      (const char *name=NULL){ return((unsigned*)   ReserveArray(Arrays4b ,name)); }
+  int*         ReserveInt       (const char *name=NULL){ return((int*)        ReserveArray(Arrays4b ,name)); }
+  float*       ReserveFloat     (const char *name=NULL){ return((float*)      ReserveArray(Arrays4b ,name)); }
+  tfloat3*     ReserveFloat3    (const char *name=NULL){ return((tfloat3*)    ReserveArray(Arrays12b,name)); }
+  tfloat4*     ReserveFloat4    (const char *name=NULL){ return((tfloat4*)    ReserveArray(Arrays16b,name)); }
+  double*      ReserveDouble    (const char *name=NULL){ return((double*)     ReserveArray(Arrays8b ,name)); }
+  tdouble2*    ReserveDouble2   (const char *name=NULL){ return((tdouble2*)   ReserveArray(Arrays16b,name)); }
+  tdouble3*    ReserveDouble3   (const char *name=NULL){ return((tdouble3*)   ReserveArray(Arrays24b,name)); }
+  tsymatrix3f* ReserveSymatrix3f(const char *name=NULL){ return((tsymatrix3f*)ReserveArray(Arrays24b,name)); }
 #ifdef CODE_SIZE4
-  typecode*    ReserveTypeCode(){   return(ReserveUint());                      }
+  typecode*    ReserveTypeCode  (const char *name=NULL){ return(ReserveUint(name));                           }
 #else
-  typecode*    ReserveTypeCode(){   return(ReserveWord());                      }
+  typecode*    ReserveTypeCode  (const char *name=NULL){ return(ReserveWord(name));                           }
 #endif
 
-  void Free(byte        *pointer){ Arrays1b->Free(pointer);  }
-  void Free(word        *pointer){ Arrays2b->Free(pointer);  }
-  void Free(unsigned    *pointer){ Arrays4b->Free(pointer);  }
-  void Free(int         *pointer){ Arrays4b->Free(pointer);  }
-  void Free(float       *pointer){ Arrays4b->Free(pointer);  }
-  void Free(tfloat3     *pointer){ Arrays12b->Free(pointer); }
-  void Free(tfloat4     *pointer){ Arrays16b->Free(pointer); }
-  void Free(double      *pointer){ Arrays8b->Free(pointer);  }
-  void Free(tdouble2    *pointer){ Arrays16b->Free(pointer); }
-  void Free(tdouble3    *pointer){ Arrays24b->Free(pointer); }
-  void Free(tsymatrix3f *pointer){ Arrays24b->Free(pointer); }
+  void Free(byte        *pointer){ FreeArray(Arrays1b ,pointer); }
+  void Free(word        *pointer){ FreeArray(Arrays2b ,pointer); }
+  void Free(unsigned    *pointer){ FreeArray(Arrays4b ,pointer); }
+  void Free(int         *pointer){ FreeArray(Arrays4b ,pointer); }
+  void Free(float       *pointer){ FreeArray(Arrays4b ,pointer); }
+  void Free(tfloat3     *pointer){ FreeArray(Arrays12b,pointer); }
+  void Free(tfloat4     *pointer){ FreeArray(Arrays16b,pointer); }
+  void Free(double      *pointer){ FreeArray(Arrays8b ,pointer); }
+  void Free(tdouble2    *pointer){ FreeArray(Arrays16b,pointer); }
+  void Free(tdouble3    *pointer){ FreeArray(Arrays24b,pointer); }
+  void Free(tsymatrix3f *pointer){ FreeArray(Arrays24b,pointer); }
 };
 
 
@@ -0,0 +1,272 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JArraysCpuProfiler.cpp \brief Implements the class \ref JArraysCpuProfiler.
+
+#include "JArraysCpuProfiler.h"
+#include "JArraysCpu.h"
+#include "JLog2.h"
+#include "JSaveCsv2.h"
+#include "Functions.h"
+#include <cstring>
+#include <climits>
+#include <algorithm>
+
+using namespace std;
+
+JArraysCpuProfiler* JArraysCpuProfiler::Active=NULL;
+
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JArraysCpuProfiler::JArraysCpuProfiler(JLog2 *log):Log(log){
+  ClassName="JArraysCpuProfiler";
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JArraysCpuProfiler::~JArraysCpuProfiler(){
+  DestructorActive=true;
+  SetActive(false);
+  Reset();
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JArraysCpuProfiler::Reset(){
+  Arrays.clear();
+  Overlap.assign(MAXARRAYS*MAXARRAYS,0);
+  Lives.clear();
+  Phases.clear();
+  for(unsigned c=0;c<POOLS;c++){
+    Pools[c].live=Pools[c].peak=0;
+    Pools[c].peakphase=NULL;
+    Pools[c].peakarrays.clear();
+  }
+  LiveBytes=PeakBytes=0;
+  PeakPhase=NULL;
+  PeakArrays.clear();
+  Unknown=0;
+}
+
+//==============================================================================
+/// Activates or deactivates the profiler.
+//==============================================================================
+void JArraysCpuProfiler::SetActive(bool active){
+  if(active)Active=this;
+  else if(Active==this)Active=NULL;
+}
+
+//==============================================================================
+/// Returns index of pool according to element size.
+//==============================================================================
+unsigned JArraysCpuProfiler::PoolIdx(unsigned elsize){
+  switch(elsize){
+    case 1:  return(0);
+    case 2:  return(1);
+    case 4:  return(2);
+    case 8:  return(3);
+    case 12: return(4);
+    case 16: return(5);
+    case 24: return(6);
+  }
+  return(7);
+}
+
+//==============================================================================
+/// Returns element size of pool.
+//==============================================================================
+unsigned JArraysCpuProfiler::PoolSize(unsigned ipool){
+  const unsigned sizes[POOLS]={1,2,4,8,12,16,24,32};
+  return(sizes[ipool]);
+}
+
+//==============================================================================
+/// Returns index of named array and creates it when it does not exist.
+//==============================================================================
+unsigned JArraysCpuProfiler::GetArrayIdx(const char *name,unsigned elsize){
+  const unsigned na=unsigned(Arrays.size());
+  //-Names are usually string literals, so pointers are compared first.
+  for(unsigned c=0;c<na;c++)if(Arrays[c].cname==name && Arrays[c].elsize==elsize)return(c);
+  const string txname=(name? string(name): fun::PrintStr("unnamed%uB",elsize));
+  for(unsigned c=0;c<na;c++)if(Arrays[c].elsize==elsize && Arrays[c].name==txname)return(c);
+  if(na>=MAXARRAYS)Run_Exceptioon("Number of named arrays exceeds the maximum.");
+  StArray a;
+  a.cname=name;
+  a.name=txname;
+  a.elsize=elsize;
+  a.reserves=0;
+  a.live=a.maxlive=0;
+  Arrays.push_back(a);
+  return(na);
+}
+
+//==============================================================================
+/// Records the reservation of an array.
+//==============================================================================
+void JArraysCpuProfiler::Reserve(const void *ptr,const char *name,unsigned elsize,unsigned arraysize){
+  const unsigned ia=GetArrayIdx(name,elsize);
+  StArray &a=Arrays[ia];
+  a.reserves++;
+  a.live++;
+  a.maxlive=max(a.maxlive,a.live);
+  const char *phase=CurrentPhase();
+  if(find(a.phases.begin(),a.phases.end(),phase)==a.phases.end())a.phases.push_back(phase);
+  //-Marks arrays used at the same time.
+  for(unsigned c=0;c<unsigned(Lives.size());c++){
+    const unsigned ia2=Lives[c].idx;
+    Overlap[ia*MAXARRAYS+ia2]=Overlap[ia2*MAXARRAYS+ia]=1;
+  }
+  StLive lv={ptr,ia,llong(elsize)*arraysize};
+  Lives.push_back(lv);
+  //-Updates use of pool.
+  StPool &pool=Pools[PoolIdx(elsize)];
+  pool.live++;
+  if(pool.live>pool.peak){
+    pool.peak=pool.live;
+    pool.peakphase=phase;
+    pool.peakarrays.clear();
+    for(unsigned c=0;c<unsigned(Lives.size());c++)if(Arrays[Lives[c].idx].elsize==elsize)pool.peakarrays.push_back(Lives[c].idx);
+  }
+  //-Updates memory in use.
+  LiveBytes+=lv.bytes;
+  if(LiveBytes>PeakBytes){
+    PeakBytes=LiveBytes;
+    PeakPhase=phase;
+    PeakArrays.clear();
+    for(unsigned c=0;c<unsigned(Lives.size());c++)PeakArrays.push_back(Lives[c].idx);
+  }
+}
+
+//==============================================================================
+/// Records the release of an array.
+//==============================================================================
+void JArraysCpuProfiler::Free(const void *ptr){
+  unsigned c=unsigned(Lives.size());
+  while(c && Lives[c-1].ptr!=ptr)c--;
+  if(!c){ Unknown++; return; }
+  const StLive lv=Lives[c-1];
+  Lives.erase(Lives.begin()+(c-1));
+  StArray &a=Arrays[lv.idx];
+  if(a.live)a.live--;
+  StPool &pool=Pools[PoolIdx(a.elsize)];
+  if(pool.live)pool.live--;
+  LiveBytes-=lv.bytes;
+}
+
+//==============================================================================
+/// Returns list of names of arrays.
+//==============================================================================
+std::string JArraysCpuProfiler::GetNames(const std::vector<unsigned> &idxs)const{
+  string tx;
+  for(unsigned c=0;c<unsigned(idxs.size());c++)tx=tx+(c? ",": "")+Arrays[idxs[c]].name;
+  return(tx);
+}
+
+//==============================================================================
+/// Returns list of phases of reservations of the array.
+//==============================================================================
+std::string JArraysCpuProfiler::GetPhases(const StArray &a)const{
+  string tx;
+  for(unsigned c=0;c<unsigned(a.phases.size());c++)tx=tx+(c? ",": "")+a.phases[c];
+  return(tx);
+}
+
+//==============================================================================
+/// Returns list of arrays with larger elements that were never used at the
+/// same time as the given array (so both could share the same memory).
+//==============================================================================
+std::string JArraysCpuProfiler::GetAliases(unsigned ia,unsigned nmax)const{
+  const StArray &a=Arrays[ia];
+  string tx;
+  unsigned n=0;
+  for(unsigned c=0;c<unsigned(Arrays.size());c++){
+    const StArray &a2=Arrays[c];
+    if(a2.elsize>a.elsize && !GetOverlap(ia,c)){
+      if(n<nmax)tx=tx+(n? ",": "")+a2.name+fun::PrintStr("(%uB)",a2.elsize);
+      n++;
+    }
+  }
+  if(n>nmax)tx=tx+fun::PrintStr(",... (%u arrays)",n);
+  return(tx);
+}
+
+//==============================================================================
+/// Shows peak use of the pools, spare arrays and arrays that could share
+/// memory.
+//==============================================================================
+void JArraysCpuProfiler::VisuSummary(const JArraysCpu *arrayscpu)const{
+  const double mb=1024.*1024.;
+  const unsigned arraysize=arrayscpu->GetArraySize();
+  Log->Print("[Memory of particle arrays]");
+  Log->Printf("  Arrays of %u elements: %.2f MB allocated, peak in use %.2f MB (phase %s)."
+    ,arraysize,arrayscpu->GetAllocMemoryCpu()/mb,PeakBytes/mb,(PeakPhase? PeakPhase: "-"));
+  Log->Printf("  %-5s %6s %6s %6s %10s %6s  %-16s %s","Size","Arrays","Peak","Spare","Spare[MB]","Grown","Phase of peak","In use at peak");
+  unsigned nspare=0;
+  llong spare=0;
+  for(unsigned c=0;c<POOLS;c++){
+    const unsigned elsize=PoolSize(c);
+    const JArraysCpu::TpArraySize tsize=JArraysCpu::TpArraySize(elsize);
+    const unsigned count=arrayscpu->GetArrayCount(tsize);
+    const unsigned peak=max(arrayscpu->GetArrayCountUsedMax(tsize),Pools[c].peak);
+    const unsigned grown=arrayscpu->GetArrayCountGrown(tsize);
+    if(!count && !peak)continue;
+    const unsigned ns=(count>peak? count-peak: 0);
+    nspare+=ns;
+    spare+=llong(ns)*elsize*arraysize;
+    Log->Printf("  %-5s %6u %6u %6u %10.2f %6u  %-16s %s",fun::PrintStr("%uB",elsize).c_str(),count,peak,ns
+      ,double(ns)*elsize*arraysize/mb,grown,(Pools[c].peakphase? Pools[c].peakphase: "-"),GetNames(Pools[c].peakarrays).c_str());
+  }
+  Log->Printf("  Spare arrays that could be released: %u (%.2f MB).",nspare,spare/mb);
+  //-Arrays of different size never used at the same time.
+  bool head=false;
+  for(unsigned c=0;c<unsigned(Arrays.size());c++){
+    const string tx=GetAliases(c,3);
+    if(!tx.empty()){
+      if(!head)Log->Print("  Arrays never used at the same time as larger arrays (they could share memory):");
+      head=true;
+      Log->Printf("    %-14s %3uB  ->  %s",Arrays[c].name.c_str(),Arrays[c].elsize,tx.c_str());
+    }
+  }
+  if(Unknown)Log->Printf("  Releases of arrays reserved before the activation of the profiler: %llu",Unknown);
+}
+
+//==============================================================================
+/// Saves use of named arrays in CSV file.
+//==============================================================================
+void JArraysCpuProfiler::SaveCsv(const std::string &file,bool csvsepcoma)const{
+  jcsv::JSaveCsv2 scsv(file,false,csvsepcoma);
+  scsv.SetHead();
+  scsv << "Array;ElementSize [B];Reserves;MaxInUse;InUseAtPeak;Phases;SharableWith" << jcsv::Endl();
+  scsv.SetData();
+  for(unsigned c=0;c<unsigned(Arrays.size());c++){
+    const StArray &a=Arrays[c];
+    const bool atpeak=(find(PeakArrays.begin(),PeakArrays.end(),c)!=PeakArrays.end());
+    string phases=GetPhases(a),aliases=GetAliases(c,UINT_MAX);
+    //-Lists are separated with spaces to keep the columns of CSV.
+    replace(phases.begin(),phases.end(),',',' ');
+    replace(aliases.begin(),aliases.end(),',',' ');
+    scsv << a.name << a.elsize << a.reserves << a.maxlive << (atpeak? 1: 0) << phases << aliases << jcsv::Endl();
+  }
+  scsv.SaveData(true);
+  if(Log)Log->AddFileInfo(file,"Saves use of memory of the particle arrays of JArraysCpu.");
+}
+
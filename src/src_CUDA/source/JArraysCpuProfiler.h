@@ -0,0 +1,132 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Profiler de memoria de los arrays de JArraysCpu. Registra las reservas
+//:#   por nombre de array y fase (timer activo), el uso maximo simultaneo de
+//:#   cada tamano y de memoria total, los arrays sobrantes y los arrays que
+//:#   nunca se usan a la vez y podrian compartir memoria. (19-10-2026)
+//:#############################################################################
+
+/// \file JArraysCpuProfiler.h \brief Declares the class \ref JArraysCpuProfiler.
+
+#ifndef _JArraysCpuProfiler_
+#define _JArraysCpuProfiler_
+
+#include "TypesDef.h"
+#include "JObject.h"
+#include <string>
+#include <vector>
+
+class JLog2;
+class JArraysCpu;
+
+//##############################################################################
+//# JArraysCpuProfiler
+//##############################################################################
+/// \brief Records the use of the arrays of \ref JArraysCpu (memory high-water mark).
+///
+/// Each reservation is identified by the name of the array (or its element
+/// size when it has no name) and the current phase, which is the innermost
+/// running CPU timer. The profiler stores the maximum number of arrays in use
+/// of each element size and the arrays in use at that moment, the peak of
+/// memory in use and whether two arrays were ever in use at the same time.
+/// Arrays of the same size are already shared by the pools, so the summary
+/// reports the spare arrays of each pool and the temporary arrays of different
+/// sizes that could share memory. Only one object can be active
+/// (JArraysCpuProfiler::Active).
+
+class JArraysCpuProfiler : protected JObject
+{
+public:
+  static JArraysCpuProfiler *Active;  ///<Active object (NULL: profiler is disabled).
+
+protected:
+  static const unsigned MAXARRAYS=128;   ///<Maximum number of named arrays.
+  static const unsigned POOLS=8;         ///<Number of element sizes.
+
+  ///Information of one named array.
+  typedef struct{
+    const char *cname;                ///<Name given in the reservation (to compare pointers).
+    std::string name;                 ///<Name of array.
+    unsigned elsize;                  ///<Size of element (in bytes).
+    ullong reserves;                  ///<Number of reservations.
+    unsigned live;                    ///<Number of instances in use.
+    unsigned maxlive;                 ///<Maximum number of instances in use.
+    std::vector<const char*> phases;  ///<Phases of reservations.
+  }StArray;
+
+  ///Array in use.
+  typedef struct{
+    const void *ptr;
+    unsigned idx;                     ///<Index in Arrays.
+    llong bytes;                      ///<Allocated memory.
+  }StLive;
+
+  ///Use of the arrays of one element size.
+  typedef struct{
+    unsigned live;                    ///<Arrays in use.
+    unsigned peak;                    ///<Maximum arrays in use.
+    const char *peakphase;            ///<Phase of peak.
+    std::vector<unsigned> peakarrays; ///<Arrays in use at peak.
+  }StPool;
+
+  JLog2 *Log;
+  std::vector<StArray> Arrays;
+  std::vector<byte> Overlap;          ///<Arrays were used at the same time [MAXARRAYS*MAXARRAYS].
+  std::vector<StLive> Lives;          ///<Arrays in use.
+  std::vector<const char*> Phases;    ///<Stack of running phases.
+  StPool Pools[POOLS];
+  llong LiveBytes;                    ///<Memory in use.
+  llong PeakBytes;                    ///<Maximum memory in use.
+  const char *PeakPhase;              ///<Phase of maximum memory in use.
+  std::vector<unsigned> PeakArrays;   ///<Arrays in use at maximum memory in use.
+  ullong Unknown;                     ///<Frees of arrays reserved before activation.
+
+  static unsigned PoolIdx(unsigned elsize);
+  static unsigned PoolSize(unsigned ipool);
+  unsigned GetArrayIdx(const char *name,unsigned elsize);
+  const char* CurrentPhase()const{ return(Phases.empty()? "-": Phases.back()); }
+  bool GetOverlap(unsigned a1,unsigned a2)const{ return(Overlap[a1*MAXARRAYS+a2]!=0); }
+  std::string GetNames(const std::vector<unsigned> &idxs)const;
+  std::string GetPhases(const StArray &a)const;
+  std::string GetAliases(unsigned ia,unsigned nmax)const;
+
+public:
+  JArraysCpuProfiler(JLog2 *log);
+  ~JArraysCpuProfiler();
+  void Reset();
+  void SetActive(bool active);
+
+  void PhaseStart(const char *phase){ Phases.push_back(phase); }
+  void PhaseStop(){ if(!Phases.empty())Phases.pop_back(); }
+
+  void Reserve(const void *ptr,const char *name,unsigned elsize,unsigned arraysize);
+  void Free(const void *ptr);
+
+  llong GetPeakBytes()const{ return(PeakBytes); }
+
+  void VisuSummary(const JArraysCpu *arrayscpu)const;
+  void SaveCsv(const std::string &file,bool csvsepcoma)const;
+};
+
+#endif
+
+
@@ -43,6 +43,7 @@
 //:# - Opcion en SaveFileXml() para grabar datos de arrays. (04-12-2014)
 //:# - Nuevos metodos CheckCopyArrayData() y CopyArrayData(). (13-04-2020)
 //:# - Mejora la gestion de excepciones. (06-05-2020)
+//:# - Nuevo metodo GetFileDataPos() para lecturas paralelas. (19-10-2026)
 //:#############################################################################
 
 /// \file JBinaryData.h \brief Declares the class \ref JBinaryData.
@@ -147,6 +148,7 @@ class JBinaryDataArray : protected JObject
   void ClearFileData();
   unsigned GetFileDataCount()const{ return(FileDataCount); }
   unsigned GetFileDataSize()const{ return(FileDataSize); }
+  llong GetFileDataPos()const{ return(FileDataPos); }
   void ReadFileData(bool resize);
 };
 
@@ -20,6 +20,7 @@
 
 #include "JCellDivCpu.h"
 #include "Functions.h"
+#include "JDsCheckpoint.h"
 #include <cfloat>
 #include <climits>
 
@@ -207,6 +208,76 @@ void JCellDivCpu::CheckMemoryNct(unsigned nctmin){
   else if(!BeginCell)AllocMemoryNct(SizeNct);  
 }
 
+//==============================================================================
+/// Adds state of last divide to checkpoint. Only BeginCell[] is required since
+/// particle data is already sorted.
+/// Anhade estado del ultimo divide al checkpoint. Solo se necesita BeginCell[]
+/// porque los datos de particulas ya estan ordenados.
+//==============================================================================
+void JCellDivCpu::SaveCheckpoint(JDsCheckpoint *chk)const{
+  chk->AddValue("cd.DomCellCode",DomCellCode);
+  chk->AddValue("cd.DomCelIni",DomCelIni);
+  chk->AddValue("cd.DomCelFin",DomCelFin);
+  chk->AddValue("cd.ScellDiv",ScellDiv);
+  chk->AddValue("cd.SizeNp",SizeNp);
+  chk->AddValue("cd.SizeNct",SizeNct);
+  chk->AddValue("cd.IncreaseNp",IncreaseNp);
+  chk->AddValue("cd.Ndiv",Ndiv);
+  chk->AddValue("cd.NdivFull",NdivFull);
+  const unsigned nps[]={Npb1,Npf1,Npb2,Npf2,Nptot,NpbOut,NpfOut,NpbOutIgnore,NpfOutIgnore,NpFinal,NpbFinal,NpbIgnore};
+  chk->AddArray("cd.Nps",sizeof(nps)/sizeof(unsigned),nps,true);
+  chk->AddValue("cd.CellDomainMin",CellDomainMin);
+  chk->AddValue("cd.CellDomainMax",CellDomainMax);
+  const unsigned ncs[]={Ncx,Ncy,Ncz,Nsheet,Nct,BoxBoundIgnore,BoxFluid,BoxBoundOut,BoxFluidOut,BoxBoundOutIgnore,BoxFluidOutIgnore};
+  chk->AddArray("cd.Ncs",sizeof(ncs)/sizeof(unsigned),ncs,true);
+  chk->AddValue("cd.Nctt",Nctt);
+  const byte oks[]={byte(BoundLimitOk? 1: 0),byte(BoundDivideOk? 1: 0),byte(DivideFull? 1: 0)};
+  chk->AddArray("cd.Oks",sizeof(oks),oks,true);
+  const tuint3 cells[]={BoundLimitCellMin,BoundLimitCellMax,BoundDivideCellMin,BoundDivideCellMax};
+  chk->AddArray("cd.BoundCells",4,cells,true);
+  chk->AddArray("cd.BeginCell",Nctt,BeginCell);
+}
+
+//==============================================================================
+/// Restores state of divide from checkpoint (with the same allocated memory).
+/// Restaura estado del divide desde checkpoint (con la misma memoria asignada).
+//==============================================================================
+void JCellDivCpu::LoadCheckpoint(const JDsCheckpoint *chk){
+  if(chk->GetValue<unsigned>("cd.DomCellCode")!=DomCellCode || chk->GetValue<tuint3>("cd.DomCelIni")!=DomCelIni
+    || chk->GetValue<tuint3>("cd.DomCelFin")!=DomCelFin || chk->GetValue<int>("cd.ScellDiv")!=ScellDiv)
+    Run_ExceptioonFile("Cell configuration of checkpoint does not match the current configuration.",chk->GetFileName());
+  //-Allocates the same memory to obtain the same divide sequence.
+  const unsigned sizenp=chk->GetValue<unsigned>("cd.SizeNp");
+  const unsigned sizenct=chk->GetValue<unsigned>("cd.SizeNct");
+  if(SizeNp!=sizenp || !CellPart)AllocMemoryNp(sizenp-PARTICLES_OVERMEMORY_MIN);
+  if(SizeNct!=sizenct || !BeginCell)AllocMemoryNct(sizenct);
+  IncreaseNp=chk->GetValue<unsigned>("cd.IncreaseNp");
+  Ndiv=chk->GetValue<unsigned>("cd.Ndiv");
+  NdivFull=chk->GetValue<unsigned>("cd.NdivFull");
+  unsigned nps[12];
+  chk->GetArray("cd.Nps",12,nps);
+  Npb1=nps[0]; Npf1=nps[1]; Npb2=nps[2]; Npf2=nps[3]; Nptot=nps[4];
+  NpbOut=nps[5]; NpfOut=nps[6]; NpbOutIgnore=nps[7]; NpfOutIgnore=nps[8];
+  NpFinal=nps[9]; NpbFinal=nps[10]; NpbIgnore=nps[11];
+  CellDomainMin=chk->GetValue<tuint3>("cd.CellDomainMin");
+  CellDomainMax=chk->GetValue<tuint3>("cd.CellDomainMax");
+  unsigned ncs[11];
+  chk->GetArray("cd.Ncs",11,ncs);
+  Ncx=ncs[0]; Ncy=ncs[1]; Ncz=ncs[2]; Nsheet=ncs[3]; Nct=ncs[4];
+  BoxBoundIgnore=ncs[5]; BoxFluid=ncs[6]; BoxBoundOut=ncs[7]; BoxFluidOut=ncs[8];
+  BoxBoundOutIgnore=ncs[9]; BoxFluidOutIgnore=ncs[10];
+  Nctt=chk->GetValue<ullong>("cd.Nctt");
+  if(Nctt>SizeBeginCell(SizeNct))Run_ExceptioonFile("Number of cells of checkpoint is invalid.",chk->GetFileName());
+  byte oks[3];
+  chk->GetArray("cd.Oks",3,oks);
+  BoundLimitOk=(oks[0]!=0); BoundDivideOk=(oks[1]!=0); DivideFull=(oks[2]!=0);
+  tuint3 cells[4];
+  chk->GetArray("cd.BoundCells",4,cells);
+  BoundLimitCellMin=cells[0]; BoundLimitCellMax=cells[1];
+  BoundDivideCellMin=cells[2]; BoundDivideCellMax=cells[3];
+  chk->GetArray("cd.BeginCell",Nctt,BeginCell);
+}
+
 //==============================================================================
 /// Define simulation domain to use.
 /// Define el dominio de simulacion a usar.
@@ -34,6 +34,8 @@
 
 //#define DBG_JCellDivCpu 1 //:DEL:
 
+class JDsCheckpoint;
+
 //##############################################################################
 //# JCellDivCpu
 //##############################################################################
@@ -198,6 +200,9 @@ public:
 
   void SetIncreaseNp(unsigned increasenp){ IncreaseNp=increasenp; }
 
+  void SaveCheckpoint(JDsCheckpoint *chk)const;
+  void LoadCheckpoint(const JDsCheckpoint *chk);
+
   //:bool CellNoEmpty(unsigned box,byte kind)const;
   //:unsigned CellBegin(unsigned box,byte kind)const;
   //:unsigned CellSize(unsigned box,byte kind)const;
@@ -0,0 +1,589 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JDsBenchCpu.cpp \brief Implements the class \ref JDsBenchCpu.
+
+#include "JDsBenchCpu.h"
+#include "JCellDivCpuSingle.h"
+#include "JCellSearch_inline.h"
+#include "FunSphKernel.h"
+#include "FunSphKernelsCfg.h"
+#include "FunSphEos.h"
+#include "JArraysCpu.h"
+#include "JRadixSort.h"
+#include "JAppInfo.h"
+#include "JLog2.h"
+#include "Functions.h"
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <climits>
+
+using namespace std;
+
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JDsBenchCpu::JDsBenchCpu(const StBenchCase &cfg,JLog2 *log):Cfg(cfg),LogRes(log){
+  ClassName="JDsBenchCpu";
+  LogCfg=new JLog2(JLog2::Out_None);
+  Log=LogCfg;
+  NgPairs=0;
+  SetupTime=0;
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JDsBenchCpu::~JDsBenchCpu(){
+  DestructorActive=true;
+  Log=NULL;
+  delete LogCfg; LogCfg=NULL;
+}
+
+//==============================================================================
+/// Returns current time in seconds.
+//==============================================================================
+double JDsBenchCpu::Now(){
+  return(std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+//==============================================================================
+/// Returns true when the kernel group was selected.
+//==============================================================================
+bool JDsBenchCpu::CheckKernel(const std::string &name)const{
+  if(Cfg.kernels.empty() || Cfg.kernels=="all")return(true);
+  return((string(",")+fun::StrLower(Cfg.kernels)+",").find(string(",")+name+",")!=string::npos);
+}
+
+//==============================================================================
+/// Adds new result and returns it.
+//==============================================================================
+JDsBenchCpu::StBenchResult& JDsBenchCpu::AddResult(const std::string &name,ullong items){
+  StBenchResult r;
+  r.name=name;
+  r.items=items;
+  Results.push_back(r);
+  return(Results.back());
+}
+
+//==============================================================================
+/// Returns name of lattice type.
+//==============================================================================
+std::string JDsBenchCpu::GetLatticeName(TpBenchLattice lattice){
+  switch(lattice){
+    case BLAT_Tank:      return("tank");
+    case BLAT_DamBreak:  return("dambreak");
+    case BLAT_Random:    return("random");
+  }
+  return("???");
+}
+
+//==============================================================================
+/// Returns lattice type according to name (exception when it is invalid).
+//==============================================================================
+TpBenchLattice JDsBenchCpu::GetLatticeType(const std::string &name){
+  const string tx=fun::StrLower(name);
+  if(tx=="tank")return(BLAT_Tank);
+  if(tx=="dambreak")return(BLAT_DamBreak);
+  if(tx=="random")return(BLAT_Random);
+  fun::Run_ExceptioonFun(string("Lattice type \'")+name+"\' is invalid.");
+  return(BLAT_Tank);
+}
+
+//==============================================================================
+/// Configures SPH constants as the default configuration of a case.
+//==============================================================================
+void JDsBenchCpu::ConfigConstantsBench(unsigned nzfluid){
+  Simulate2D=Cfg.sim2d;
+  Simulate2DPosY=0;
+  Symmetry=false;
+  Stable=false;
+  TStep=STEP_Verlet;
+  TKernel=Cfg.tkernel;
+  TVisco=VISCO_Artificial;
+  Visco=0.01f;
+  ViscoBoundFactor=1;
+  TDensity=DDT_DDT;
+  DDTValue=0.1f;
+  DDTArray=true;
+  TBoundary=BC_DBC;
+  FtMode=FTMODE_None;
+  UseDEM=false;
+  UseNormals=false;
+  CellMode=Cfg.cellmode;
+  Dp=0.01;
+  const double dim=(Simulate2D? 2: 3);
+  KernelH=float(1.2*sqrt(dim*Dp*Dp));
+  RhopZero=1000.f;
+  Gamma=7.f;
+  Gravity=TFloat3(0,0,-9.81f);
+  const double hswl=Dp*nzfluid;
+  const double cs0=20.*sqrt(fabs(Gravity.z)*hswl);
+  CteB=float(cs0*cs0*RhopZero/Gamma);
+  MassFluid=MassBound=float(RhopZero*pow(Dp,dim));
+  DtIni=DtMin=0;
+  ConfigConstants1(Simulate2D);
+  ConfigConstants2();
+}
+
+//==============================================================================
+/// Generates particles of the lattice (boundary particles first).
+//==============================================================================
+void JDsBenchCpu::GenerateParticles(std::vector<tdouble3> &pos,std::vector<typecode> &code
+  ,std::vector<tfloat4> &velrhop,unsigned &npb)const
+{
+  const unsigned np=max(Cfg.np,8u);
+  //-Fluid lattice (nx,ny,nz) and tank interior (nxt,nyt,nzt).
+  unsigned nx,ny,nz,nxt,nyt,nzt;
+  if(Cfg.lattice==BLAT_DamBreak){
+    nz=max(2u,unsigned(Simulate2D? sqrt(double(np))+0.5: cbrt(double(np))+0.5));
+    nx=nz; ny=(Simulate2D? 1: nz);
+    nxt=nx*4; nyt=ny; nzt=nz;
+  }
+  else{
+    nz=max(2u,unsigned(Simulate2D? sqrt(np/2.)+0.5: cbrt(np/4.)+0.5));
+    nx=nz*2; ny=(Simulate2D? 1: nz*2);
+    nxt=nx; nyt=ny; nzt=nz+nz/4;
+  }
+  const int layers=2;
+  const int jini=(Simulate2D? 0: -layers),jfin=(Simulate2D? 1: int(nyt)+layers);
+  //-Boundary walls (bottom and sides).
+  pos.clear(); code.clear(); velrhop.clear();
+  for(int k=-layers;k<int(nzt);k++)for(int j=jini;j<jfin;j++)for(int i=-layers;i<int(nxt)+layers;i++){
+    const bool in=(i>=0 && i<int(nxt) && (Simulate2D || (j>=0 && j<int(nyt))) && k>=0);
+    if(!in){
+      pos.push_back(TDouble3(Dp*i,Dp*j,Dp*k));
+      code.push_back(CODE_TYPE_FIXED);
+      velrhop.push_back(TFloat4(0,0,0,RhopZero));
+    }
+  }
+  npb=unsigned(pos.size());
+  //-Fluid particles with hydrostatic density.
+  const double hfluid=Dp*(nz-1);
+  std::mt19937 rng(1234567);
+  std::uniform_real_distribution<double> urand(0.,1.);
+  for(unsigned k=0;k<nz;k++)for(unsigned j=0;j<ny;j++)for(unsigned i=0;i<nx;i++){
+    tdouble3 ps=TDouble3(Dp*i,Dp*j,Dp*k);
+    tfloat3 vel=TFloat3(0);
+    if(Cfg.lattice==BLAT_Random){
+      ps=TDouble3(Dp*(nx-1)*urand(rng),(Simulate2D? 0: Dp*(ny-1)*urand(rng)),hfluid*urand(rng));
+      vel=TFloat3(float(urand(rng)-0.5),(Simulate2D? 0.f: float(urand(rng)-0.5)),float(urand(rng)-0.5))*0.2f;
+    }
+    const float rhop=float(RhopZero*pow(1.+RhopZero*fabs(Gravity.z)*(hfluid-ps.z)/CteB,1./Gamma));
+    pos.push_back(ps);
+    code.push_back(CODE_TYPE_FLUID);
+    velrhop.push_back(TFloat4(vel.x,vel.y,vel.z,rhop));
+  }
+}
+
+//==============================================================================
+/// Creates the case in memory and configures the cell division.
+//==============================================================================
+void JDsBenchCpu::ConfigCaseBench(){
+  const double t0=Now();
+  //-Configures OpenMP.
+  #ifdef OMP_USE
+    OmpThreads=(Cfg.ompthreads>0? Cfg.ompthreads: max(omp_get_num_procs(),1));
+    if(OmpThreads>OMP_MAXTHREADS)OmpThreads=OMP_MAXTHREADS;
+    omp_set_num_threads(OmpThreads);
+    JDsOmpTuner::SetScheduleDefault();
+  #else
+    OmpThreads=1;
+  #endif
+  //-Configures constants using the height of fluid.
+  {
+    const unsigned np=max(Cfg.np,8u);
+    const unsigned nz=max(2u,unsigned((Cfg.lattice==BLAT_DamBreak? (Cfg.sim2d? sqrt(double(np)): cbrt(double(np))): (Cfg.sim2d? sqrt(np/2.): cbrt(np/4.)))+0.5));
+    Simulate2D=Cfg.sim2d;
+    ConfigConstantsBench(nz);
+  }
+  //-Generates particles.
+  unsigned npb=0;
+  GenerateParticles(Pos0,Code0,Velrhop0,npb);
+  const unsigned np=unsigned(Pos0.size());
+  Idp0.resize(np);
+  for(unsigned p=0;p<np;p++)Idp0[p]=p;
+  CaseNp=np; CaseNbound=CaseNfixed=CaseNpb=npb; CaseNfluid=np-npb;
+  Np=np; Npb=npb; NpbOk=npb;
+  //-Computes limits of the map.
+  tdouble3 pmin=Pos0[0],pmax=Pos0[0];
+  for(unsigned p=1;p<np;p++){
+    pmin=MinValues(pmin,Pos0[p]);
+    pmax=MaxValues(pmax,Pos0[p]);
+  }
+  const double border=double(KernelH)*BORDER_MAP;
+  MapRealPosMin=pmin-TDouble3(border,(Simulate2D? Dp/2: border),border);
+  MapRealPosMax=pmax+TDouble3(border,(Simulate2D? Dp/2: border),border);
+  MapRealSize=MapRealPosMax-MapRealPosMin;
+  Map_PosMin=MapRealPosMin; Map_PosMax=MapRealPosMax;
+  Map_Size=Map_PosMax-Map_PosMin;
+  //-Configures cell division (as ConfigCellDivision() without VTK file).
+  ScellDiv=(CellMode==CELLMODE_Full? 1: 2);
+  Scell=KernelSize/ScellDiv;
+  MovLimit=Scell*0.9f;
+  Map_Cells=TUint3(unsigned(ceil(Map_Size.x/Scell)),unsigned(ceil(Map_Size.y/Scell)),unsigned(ceil(Map_Size.z/Scell)));
+  SelecDomain(TUint3(0,0,0),Map_Cells);
+  //-Allocates memory and loads particle data.
+  AllocCpuMemoryParticles(Np,0);
+  ReserveBasicArraysCpu();
+  Dcell0.resize(np);
+  LoadDcellParticles(np,Code0.data(),Pos0.data(),Dcell0.data());
+  RestoreParticles();
+  //-Creates cell division object.
+  CellDivSingle=new JCellDivCpuSingle(Stable,false,PeriActive,CellMode
+    ,Scell,Map_PosMin,Map_PosMax,Map_Cells,CaseNbound,CaseNfixed,CaseNpb,Log,DirOut);
+  CellDivSingle->DefineDomain(DomCellCode,DomCelIni,DomCelFin,DomPosMin,DomPosMax);
+  ConfigCellDiv((JCellDivCpu*)CellDivSingle);
+  BoundChanged=true;
+  RunCellDivide(false);
+  SetupTime=Now()-t0;
+}
+
+//==============================================================================
+/// Restores initial data of particles (lattice order).
+//==============================================================================
+void JDsBenchCpu::RestoreParticles(){
+  const unsigned np=unsigned(Pos0.size());
+  Np=np; Npb=CaseNpb; NpbOk=Npb;
+  memcpy(Idpc    ,Idp0.data()    ,sizeof(unsigned)*np);
+  memcpy(Codec   ,Code0.data()   ,sizeof(typecode)*np);
+  memcpy(Dcellc  ,Dcell0.data()  ,sizeof(unsigned)*np);
+  memcpy(Posc    ,Pos0.data()    ,sizeof(tdouble3)*np);
+  memcpy(Velrhopc,Velrhop0.data(),sizeof(tfloat4)*np);
+  if(VelrhopM1c)memcpy(VelrhopM1c,Velrhop0.data(),sizeof(tfloat4)*np);
+}
+
+//==============================================================================
+/// Cell division and reordering of particle data starting from lattice order.
+//==============================================================================
+void JDsBenchCpu::BenchCellDiv(){
+  const unsigned ridx=unsigned(Results.size());
+  AddResult("CellDivide",Np);
+  AddResult("SortArray(tdouble3)",Np);
+  AddResult("SortArray(tfloat4)",Np);
+  for(unsigned c=0;c<Cfg.warmup+Cfg.reps;c++){
+    RestoreParticles();
+    double t=Now();
+    CellDivSingle->Divide(Npb,Np-Npb,0,0,true,Dcellc,Codec,Idpc,Posc,Timers);
+    const double tdiv=Now()-t;
+    t=Now();
+    CellDivSingle->SortArray(Posc);
+    const double tsd3=Now()-t;
+    t=Now();
+    CellDivSingle->SortArray(Velrhopc);
+    const double tsf4=Now()-t;
+    if(c>=Cfg.warmup){
+      Results[ridx  ].times.push_back(tdiv);
+      Results[ridx+1].times.push_back(tsd3);
+      Results[ridx+2].times.push_back(tsf4);
+    }
+  }
+  //-Restores sorted state of particles for the next kernels.
+  RestoreParticles();
+  BoundChanged=true;
+  RunCellDivide(false);
+}
+
+//==============================================================================
+/// Sorting of cell keys with index and reordering of positions using JRadixSort.
+//==============================================================================
+void JDsBenchCpu::BenchRadixSort(){
+  const unsigned np=unsigned(Pos0.size());
+  const unsigned ridx=unsigned(Results.size());
+  AddResult("RadixSort(keys+index)",np);
+  AddResult("RadixSort(data tdouble3)",np);
+  JRadixSort rs(OmpThreads>1);
+  std::vector<unsigned> keys(np);
+  std::vector<tdouble3> res(np);
+  for(unsigned c=0;c<Cfg.warmup+Cfg.reps;c++){
+    memcpy(keys.data(),Dcell0.data(),sizeof(unsigned)*np);
+    double t=Now();
+    rs.Sort(true,np,keys.data());
+    const double tkey=Now()-t;
+    t=Now();
+    rs.SortData(np,Pos0.data(),res.data());
+    const double tdat=Now()-t;
+    if(c>=Cfg.warmup){
+      Results[ridx  ].times.push_back(tkey);
+      Results[ridx+1].times.push_back(tdat);
+    }
+  }
+}
+
+//==============================================================================
+/// Counts neighbour pairs of fluid particles with nsearch (bound and fluid cells).
+//==============================================================================
+ullong JDsBenchCpu::NgSearchCount()const{
+  const int pini=int(Npb),pfin=int(Np);
+  const StDivDataCpu dvd=DivData;
+  const tdouble3 *pos=Posc;
+  const unsigned *dcell=Dcellc;
+  const float ks2=KernelSize2;
+  ullong npairs=0;
+  #ifdef OMP_USE
+    #pragma omp parallel for schedule (guided) reduction(+:npairs)
+  #endif
+  for(int p1=pini;p1<pfin;p1++){
+    unsigned n=0;
+    const tdouble3 posp1=pos[p1];
+    for(byte tpfluid=0;tpfluid<=1;tpfluid++){
+      const StNgSearch ngs=nsearch::Init(dcell[p1],!tpfluid,dvd);
+      for(int z=ngs.zini;z<ngs.zfin;z++)for(int y=ngs.yini;y<ngs.yfin;y++){
+        const tuint2 pif=nsearch::ParticleRange(y,z,ngs,dvd);
+        for(unsigned p2=pif.x;p2<pif.y;p2++){
+          const float rr2=nsearch::Distance2(posp1,pos[p2]);
+          if(rr2<=ks2 && rr2>=ALMOSTZERO)n++;
+        }
+      }
+    }
+    npairs+=n;
+  }
+  return(npairs);
+}
+
+//==============================================================================
+/// Neighbour search of fluid particles.
+//==============================================================================
+void JDsBenchCpu::BenchNgSearch(){
+  StBenchResult &r=AddResult("NgSearch",Np-Npb);
+  for(unsigned c=0;c<Cfg.warmup+Cfg.reps;c++){
+    const double t=Now();
+    NgPairs=NgSearchCount();
+    if(c>=Cfg.warmup)r.times.push_back(Now()-t);
+  }
+}
+
+//==============================================================================
+/// Returns sum of kernel values (wab or fac) for n distances.
+//==============================================================================
+template<TpKernel tker> double JDsBenchCpu::KernelSumT(bool fac,unsigned n,const float *rr2)const{
+  const int nn=int(n);
+  double sum=0;
+  if(fac){
+    #ifdef OMP_USE
+      #pragma omp parallel for schedule (static) reduction(+:sum)
+    #endif
+    for(int c=0;c<nn;c++)sum+=fsph::GetKernel_Fac<tker>(CSP,rr2[c]);
+  }
+  else{
+    #ifdef OMP_USE
+      #pragma omp parallel for schedule (static) reduction(+:sum)
+    #endif
+    for(int c=0;c<nn;c++)sum+=fsph::GetKernel_Wab<tker>(CSP,rr2[c]);
+  }
+  return(sum);
+}
+
+//==============================================================================
+/// Returns sum of kernel values (wab or fac) for n distances.
+//==============================================================================
+double JDsBenchCpu::KernelSum(bool fac,unsigned n,const float *rr2)const{
+  if(TKernel==KERNEL_Cubic)return(KernelSumT<KERNEL_Cubic>(fac,n,rr2));
+  return(KernelSumT<KERNEL_Wendland>(fac,n,rr2));
+}
+
+//==============================================================================
+/// Evaluation of kernel functions GetKernel_Wab and GetKernel_Fac.
+//==============================================================================
+void JDsBenchCpu::BenchKernel(){
+  const unsigned n=max(1u<<20,Np*8);
+  std::vector<float> rr2(n);
+  std::mt19937 rng(7654321);
+  std::uniform_real_distribution<float> urand(ALMOSTZERO,KernelSize2);
+  for(unsigned c=0;c<n;c++)rr2[c]=urand(rng);
+  const unsigned ridx=unsigned(Results.size());
+  AddResult(fun::PrintStr("GetKernel_Wab<%s>",fsph::GetKernelName(TKernel).c_str()),n);
+  AddResult(fun::PrintStr("GetKernel_Fac<%s>",fsph::GetKernelName(TKernel).c_str()),n);
+  double chk=0;
+  for(unsigned c=0;c<Cfg.warmup+Cfg.reps;c++){
+    double t=Now();
+    chk+=KernelSum(false,n,rr2.data());
+    const double twab=Now()-t;
+    t=Now();
+    chk+=KernelSum(true,n,rr2.data());
+    const double tfac=Now()-t;
+    if(c>=Cfg.warmup){
+      Results[ridx  ].times.push_back(twab);
+      Results[ridx+1].times.push_back(tfac);
+    }
+  }
+  if(chk==DBL_MAX)LogRes->Print("");  //-Avoids removal of computation.
+}
+
+//==============================================================================
+/// Interaction of forces using the templates of JSphCpu (Fluid-Fluid,
+/// Fluid-Bound and Bound-Fluid).
+//==============================================================================
+void JDsBenchCpu::BenchInteraction(){
+  StBenchResult &r=AddResult("Interaction_Forces",Np);
+  PreInteraction_Forces();
+  const stinterparmsc parms=StInterparmsc(Np,Npb,NpbOk
+    ,DivData,Dcellc
+    ,Posc,Velrhopc,Idpc,Codec,Pressc,Arc,Acec,Deltac
+    ,ShiftingMode,ShiftPosfsc
+    ,SpsTauc,SpsGradvelc
+  );
+  for(unsigned c=0;c<Cfg.warmup+Cfg.reps;c++){
+    PreInteractionVars_Forces(Np,Npb);
+    StInterResultc res;
+    res.viscdt=0;
+    const double t=Now();
+    Interaction_Forces_ct(parms,res);
+    if(c>=Cfg.warmup)r.times.push_back(Now()-t);
+  }
+  PosInteraction_Forces();
+}
+
+//==============================================================================
+/// Creates the case and runs the selected kernels.
+//==============================================================================
+void JDsBenchCpu::RunBench(){
+  ConfigCaseBench();
+  if(CheckKernel("celldiv"))BenchCellDiv();
+  if(CheckKernel("radixsort"))BenchRadixSort();
+  if(CheckKernel("ngsearch"))BenchNgSearch();
+  if(CheckKernel("kernel"))BenchKernel();
+  if(CheckKernel("interaction"))BenchInteraction();
+}
+
+//==============================================================================
+/// Computes statistics of times: min, mean, median, max and standard deviation.
+//==============================================================================
+static void BenchStats(std::vector<double> v,double &vmin,double &vmean,double &vmedian,double &vmax,double &vstd){
+  vmin=vmean=vmedian=vmax=vstd=0;
+  const unsigned n=unsigned(v.size());
+  if(n){
+    sort(v.begin(),v.end());
+    vmin=v[0]; vmax=v[n-1];
+    vmedian=(n%2? v[n/2]: (v[n/2-1]+v[n/2])/2);
+    double sum=0,sum2=0;
+    for(unsigned c=0;c<n;c++){ sum+=v[c]; sum2+=v[c]*v[c]; }
+    vmean=sum/n;
+    vstd=sqrt(max(0.,sum2/n-vmean*vmean));
+  }
+}
+
+//==============================================================================
+/// Shows results using Log.
+//==============================================================================
+void JDsBenchCpu::VisuResults()const{
+  LogRes->Printf("\n[Benchmark %s%s]  Np:%u (fluid:%u)  CellMode:%s  Kernel:%s  Threads:%d  Reps:%u"
+    ,GetLatticeName(Cfg.lattice).c_str(),(Simulate2D? "-2D": "-3D"),Np,Np-Npb
+    ,GetNameCellMode(CellMode),fsph::GetKernelName(TKernel).c_str(),OmpThreads,Cfg.reps);
+  LogRes->Print("  Kernel                        Median [ms]    Min [ms]   Mean [ms]    Std [%]  ns/item");
+  for(unsigned c=0;c<unsigned(Results.size());c++){
+    const StBenchResult &r=Results[c];
+    double vmin,vmean,vmedian,vmax,vstd;
+    BenchStats(r.times,vmin,vmean,vmedian,vmax,vstd);
+    LogRes->Printf("  %-28s %12.4f %11.4f %11.4f %10.2f %8.3f",r.name.c_str(),vmedian*1e3,vmin*1e3,vmean*1e3
+      ,(vmean? vstd*100/vmean: 0),(r.items? vmedian*1e9/r.items: 0));
+  }
+  if(NgPairs)LogRes->Printf("  Neighbour pairs of fluid: %llu (%.2f per particle)",NgPairs,double(NgPairs)/max(1u,Np-Npb));
+}
+
+//==============================================================================
+/// Returns JSON object with the configuration and results of the case.
+//==============================================================================
+std::string JDsBenchCpu::GetJson()const{
+  std::vector<std::string> kers;
+  for(unsigned c=0;c<unsigned(Results.size());c++){
+    const StBenchResult &r=Results[c];
+    double vmin,vmean,vmedian,vmax,vstd;
+    BenchStats(r.times,vmin,vmean,vmedian,vmax,vstd);
+    std::vector<std::string> times;
+    for(unsigned ct=0;ct<unsigned(r.times.size());ct++)times.push_back(fun::DoubleStr(r.times[ct],"%.6e"));
+    std::vector<std::string> k;
+    k.push_back(fun::JSONProperty("name",r.name));
+    k.push_back(fun::JSONPropertyValue("items",fun::UlongStr(r.items)));
+    k.push_back(fun::JSONProperty("reps",unsigned(r.times.size())));
+    k.push_back(fun::JSONPropertyValue("min_s"   ,fun::DoubleStr(vmin   ,"%.6e")));
+    k.push_back(fun::JSONPropertyValue("mean_s"  ,fun::DoubleStr(vmean  ,"%.6e")));
+    k.push_back(fun::JSONPropertyValue("median_s",fun::DoubleStr(vmedian,"%.6e")));
+    k.push_back(fun::JSONPropertyValue("max_s"   ,fun::DoubleStr(vmax   ,"%.6e")));
+    k.push_back(fun::JSONPropertyValue("stddev_s",fun::DoubleStr(vstd   ,"%.6e")));
+    k.push_back(fun::JSONPropertyValue("ns_per_item",fun::DoubleStr(r.items? vmedian*1e9/r.items: 0,"%.6g")));
+    k.push_back(fun::JSONPropertyValue("times_s",fun::JSONArray(times)));
+    kers.push_back(fun::JSONObject(k));
+  }
+  std::vector<std::string> v;
+  v.push_back(fun::JSONProperty("lattice",GetLatticeName(Cfg.lattice)));
+  v.push_back(fun::JSONProperty("dim",(Simulate2D? 2: 3)));
+  v.push_back(fun::JSONProperty("np",Np));
+  v.push_back(fun::JSONProperty("npb",Npb));
+  v.push_back(fun::JSONProperty("npf",Np-Npb));
+  v.push_back(fun::JSONProperty("cellmode",string(GetNameCellMode(CellMode))));
+  v.push_back(fun::JSONProperty("kernel",fsph::GetKernelName(TKernel)));
+  v.push_back(fun::JSONProperty("ompthreads",OmpThreads));
+  v.push_back(fun::JSONPropertyValue("dp",fun::DoubleStr(Dp,"%.6g")));
+  v.push_back(fun::JSONPropertyValue("kernelsize",fun::DoubleStr(KernelSize,"%.6g")));
+  v.push_back(fun::JSONProperty("cells",fun::Uint3Str(Map_Cells)));
+  v.push_back(fun::JSONPropertyValue("ngpairs",fun::UlongStr(NgPairs)));
+  v.push_back(fun::JSONPropertyValue("setup_s",fun::DoubleStr(SetupTime,"%.6e")));
+  v.push_back(fun::JSONPropertyValue("kernels",fun::JSONArray(kers)));
+  return(fun::JSONObject(v));
+}
+
+//==============================================================================
+/// Returns JSON object with information of the build (compiler and options).
+//==============================================================================
+std::string JDsBenchCpu::GetBuildInfoJson(int ompthreads){
+  string compiler="unknown";
+  #if defined(__clang__)
+    compiler=string("clang ")+__clang_version__;
+  #elif defined(__GNUC__)
+    compiler=string("gcc ")+__VERSION__;
+  #elif defined(_MSC_VER)
+    compiler=string("msvc ")+fun::IntStr(_MSC_VER);
+  #endif
+  std::vector<std::string> flags;
+  #ifdef OMP_USE
+    flags.push_back(fun::JSONValue(string("openmp")));
+  #endif
+  #ifdef __FAST_MATH__
+    flags.push_back(fun::JSONValue(string("fast-math")));
+  #endif
+  #ifdef __OPTIMIZE__
+    flags.push_back(fun::JSONValue(string("optimize")));
+  #endif
+  #ifdef __AVX512F__
+    flags.push_back(fun::JSONValue(string("avx512f")));
+  #endif
+  #ifdef __AVX2__
+    flags.push_back(fun::JSONValue(string("avx2")));
+  #endif
+  #ifdef __AVX__
+    flags.push_back(fun::JSONValue(string("avx")));
+  #endif
+  #ifdef CODE_SIZE4
+    flags.push_back(fun::JSONValue(string("code_size4")));
+  #endif
+  #ifdef DISABLE_TIMERS
+    flags.push_back(fun::JSONValue(string("disable_timers")));
+  #endif
+  std::vector<std::string> v;
+  v.push_back(fun::JSONProperty("program",AppInfo.GetFullName()));
+  v.push_back(fun::JSONProperty("compiler",compiler));
+  v.push_back(fun::JSONPropertyValue("flags",fun::JSONArray(flags)));
+  v.push_back(fun::JSONProperty("date",fun::GetDateTime()));
+  v.push_back(fun::JSONProperty("ompthreads",ompthreads));
+  return(fun::JSONObject(v));
+}
+
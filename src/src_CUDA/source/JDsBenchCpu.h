@@ -0,0 +1,131 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Micro-benchmarks de los kernels principales de CPU (division en celdas,
+//:#   SortArray, JRadixSort, busqueda de vecinos, funciones kernel SPH e
+//:#   interaccion de fuerzas) sobre redes sinteticas de particulas creadas en
+//:#   memoria sin XML. Resultados con estadisticas en formato JSON. (19-10-2026)
+//:#############################################################################
+
+/// \file JDsBenchCpu.h \brief Declares the class \ref JDsBenchCpu.
+
+#ifndef _JDsBenchCpu_
+#define _JDsBenchCpu_
+
+#include "JSphCpuSingle.h"
+#include <string>
+#include <vector>
+
+class JLog2;
+
+///Types of synthetic lattice of particles.
+typedef enum{
+   BLAT_Tank=1      ///<Still tank completely filled with fluid.
+  ,BLAT_DamBreak=2  ///<Fluid column in the first quarter of the tank.
+  ,BLAT_Random=3    ///<Fluid particles at random positions of the tank with random velocity.
+}TpBenchLattice;
+
+///Structure with the configuration of a benchmark case.
+typedef struct{
+  TpBenchLattice lattice; ///<Type of lattice.
+  unsigned np;            ///<Requested number of fluid particles.
+  bool sim2d;             ///<2D simulation.
+  TpCellMode cellmode;    ///<Cell division mode.
+  TpKernel tkernel;       ///<Kernel type.
+  unsigned reps;          ///<Number of measured repetitions.
+  unsigned warmup;        ///<Number of repetitions before measurement.
+  int ompthreads;         ///<Number of OpenMP threads (0:all).
+  std::string kernels;    ///<List of benchmarked kernels separated by commas (empty:all).
+}StBenchCase;
+
+//##############################################################################
+//# JDsBenchCpu
+//##############################################################################
+/// \brief Micro-benchmarks of the hot kernels of the CPU code.
+///
+/// The case is created in memory (without XML or input files) as a lattice of
+/// particles with walls of boundary particles and the SPH configuration of
+/// JSph is loaded directly (Verlet, artificial viscosity, DDT Molteni, DBC).
+/// Each kernel is executed the requested number of times using the same code
+/// of the simulation (JCellDivCpuSingle, JRadixSort, nsearch, fsph and the
+/// interaction templates of JSphCpu) and the runtime statistics are returned
+/// in JSON format.
+
+class JDsBenchCpu : protected JSphCpuSingle
+{
+protected:
+  ///Results of a benchmarked kernel.
+  typedef struct{
+    std::string name;           ///<Name of kernel.
+    ullong items;               ///<Number of processed items per repetition.
+    std::vector<double> times;  ///<Runtime of each repetition (in seconds).
+  }StBenchResult;
+
+  const StBenchCase Cfg;
+  JLog2 *LogRes;                ///<Log to show results.
+  JLog2 *LogCfg;                ///<Quiet log used during configuration of the case.
+
+  //-Initial data of particles (lattice order).
+  std::vector<unsigned> Idp0;
+  std::vector<typecode> Code0;
+  std::vector<unsigned> Dcell0;
+  std::vector<tdouble3> Pos0;
+  std::vector<tfloat4>  Velrhop0;
+
+  ullong NgPairs;               ///<Neighbour pairs found by NgSearch.
+  double SetupTime;             ///<Time to create the case (in seconds).
+  std::vector<StBenchResult> Results;
+
+  static double Now();
+  bool CheckKernel(const std::string &name)const;
+  StBenchResult& AddResult(const std::string &name,ullong items);
+
+  void ConfigConstantsBench(unsigned nzfluid);
+  void GenerateParticles(std::vector<tdouble3> &pos,std::vector<typecode> &code,std::vector<tfloat4> &velrhop,unsigned &npb)const;
+  void ConfigCaseBench();
+  void RestoreParticles();
+
+  ullong NgSearchCount()const;
+  template<TpKernel tker> double KernelSumT(bool fac,unsigned n,const float *rr2)const;
+  double KernelSum(bool fac,unsigned n,const float *rr2)const;
+
+  void BenchCellDiv();
+  void BenchRadixSort();
+  void BenchNgSearch();
+  void BenchKernel();
+  void BenchInteraction();
+
+public:
+  JDsBenchCpu(const StBenchCase &cfg,JLog2 *log);
+  ~JDsBenchCpu();
+
+  void RunBench();
+  void VisuResults()const;
+  std::string GetJson()const;
+
+  static std::string GetLatticeName(TpBenchLattice lattice);
+  static TpBenchLattice GetLatticeType(const std::string &name);
+  static std::string GetBuildInfoJson(int ompthreads);
+};
+
+#endif
+
+
@@ -0,0 +1,429 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JDsBenchmark.cpp \brief Implements the class \ref JDsBenchmark.
+
+#include "JDsBenchmark.h"
+#include "JSphCfgRun.h"
+#include "JLog2.h"
+#include "JXml.h"
+#include "JCaseCtes.h"
+#include "JCaseEParms.h"
+#include "JCaseParts.h"
+#include "JPartDataBi4.h"
+#include "JPartNormalData.h"
+#include "Functions.h"
+#include "FunctionsMath.h"
+#include <cmath>
+#include <climits>
+#include <cfloat>
+#include <fstream>
+#include <algorithm>
+#ifdef OMP_USE
+  #include <omp.h>
+#endif
+
+using namespace std;
+
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JDsBenchmark::JDsBenchmark(const JSphCfgRun *cfg,const std::string &dirout,JLog2 *log)
+  :Log(log),Cfg(cfg),DirOut(fun::GetDirWithSlash(dirout))
+{
+  ClassName="JDsBenchmark";
+  Dp=0.01;
+  //-Loads list of numbers of threads.
+  if(!Cfg->BenchThreads.empty()){
+    std::vector<std::string> vth;
+    fun::VectorSplitStr(",",Cfg->BenchThreads,vth);
+    for(unsigned c=0;c<unsigned(vth.size());c++){
+      const int th=atoi(vth[c].c_str());
+      if(th<1)Run_Exceptioon(string("Number of threads \'")+vth[c]+"\' is invalid.");
+      Threads.push_back(th);
+    }
+  }
+  if(Threads.empty()){
+    int th=Cfg->OmpThreads;
+  #ifdef OMP_USE
+    if(th<=0)th=omp_get_num_procs();
+  #endif
+    Threads.push_back(max(1,th));
+  }
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JDsBenchmark::~JDsBenchmark(){
+  DestructorActive=true;
+}
+
+//==============================================================================
+/// Returns number of wall particles of the tank (bottom and sides without top)
+/// for the interior size nx*ny*nzt.
+//==============================================================================
+unsigned JDsBenchmark::CountWalls(unsigned nx,unsigned ny,unsigned nzt)const{
+  const ullong nzo=nzt+LAYERS;
+  if(Cfg->BenchSim2D)return(unsigned(ullong(nx+LAYERS*2)*nzo-ullong(nx)*nzt));
+  return(unsigned(ullong(nx+LAYERS*2)*ullong(ny+LAYERS*2)*nzo-ullong(nx)*ny*nzt));
+}
+
+//==============================================================================
+/// Computes size of the tank for the requested number of particles. The depth
+/// of fluid is selected to match the requested fraction of boundary particles.
+//==============================================================================
+JDsBenchmark::StBenchGeo JDsBenchmark::ComputeGeometry(unsigned np)const{
+  const bool sim2d=Cfg->BenchSim2D;
+  const double frac=max(0.,min(0.9,double(Cfg->BenchBoundFrac)));
+  StBenchGeo best;
+  memset(&best,0,sizeof(StBenchGeo));
+  double besterr=DBL_MAX;
+  for(unsigned nz=2;nz<100000;nz++){
+    const unsigned nzt=nz+nz/4+1;
+    //-Finds largest nx with total number of particles <= np.
+    unsigned n1=2,n2=(sim2d? np: unsigned(sqrt(double(np)))+2);
+    if(n2<n1)break;
+    while(n2-n1>1){
+      const unsigned nx=(n1+n2)/2;
+      const ullong nt=ullong(nx)*(sim2d? 1: nx)*nz+CountWalls(nx,(sim2d? 1: nx),nzt);
+      if(nt<=np)n1=nx; else n2=nx;
+    }
+    const unsigned nx=n1,ny=(sim2d? 1: nx);
+    const unsigned nfluid=nx*ny*nz,nfixed=CountWalls(nx,ny,nzt);
+    if(ullong(nfluid)+nfixed>np)break;
+    if(nx<nz/2)break;
+    const double err=fabs(double(nfixed)/(nfixed+nfluid)-frac)+fabs(double(np)-(nfixed+nfluid))/np;
+    if(err<besterr){
+      besterr=err;
+      best.nx=nx; best.ny=ny; best.nz=nz; best.nzt=nzt;
+      best.nfixed=nfixed; best.nfluid=nfluid;
+    }
+  }
+  if(!best.nx)Run_Exceptioon(fun::PrintStr("Number of particles %u is too small for benchmark case.",np));
+  //-Floating box at the centre of the free surface.
+  if(Cfg->BenchFloating){
+    const unsigned nft=max(2u,best.nz/3);
+    if(nft+2<=best.nz && nft+2<=best.nx && (sim2d || nft+2<=best.ny)){
+      best.nft=nft;
+      best.nfloat=nft*nft*(sim2d? 1: nft);
+      best.nfluid-=best.nfloat;
+    }
+    else Run_Exceptioon("Number of particles is too small for benchmark case with floating body.");
+  }
+  return(best);
+}
+
+//==============================================================================
+/// Creates the files of the synthetic case (XML, BI4 and normal data) and
+/// returns the name of the case (with path and without extension).
+//==============================================================================
+std::string JDsBenchmark::CreateCase(unsigned np,const std::string &dircase){
+  const bool sim2d=Cfg->BenchSim2D;
+  const StBenchGeo g=ComputeGeometry(np);
+  const unsigned npt=g.nfixed+g.nfloat+g.nfluid;
+  const string casename=fun::PrintStr("BenchCase_%u",npt);
+  const int nl=LAYERS;
+  //-Constants.
+  const tdouble3 gravity=TDouble3(0,0,-9.81);
+  const double dim=(sim2d? 2.: 3.);
+  const double rhop0=1000,gamma=7;
+  const double hswl=g.nz*Dp;
+  const double h=(sim2d? 1.2: 1.0)*sqrt(dim)*Dp;
+  const double cs0=20.*sqrt(-gravity.z*hswl);
+  const double b=cs0*cs0*rhop0/gamma;
+  const double mass=rhop0*pow(Dp,dim);
+  //-Generates particles (fixed, floating and fluid).
+  std::vector<unsigned> idp(npt);
+  std::vector<tdouble3> pos(npt);
+  std::vector<tfloat3> vel(npt,TFloat3(0));
+  std::vector<float> rhop(npt,float(rhop0));
+  std::vector<tdouble3> partnor(g.nfixed,TDouble3(0));
+  const int nyw=(sim2d? 0: nl);
+  const tdouble3 limmin=TDouble3(-Dp/2,(sim2d? 0: -Dp/2),-Dp/2);
+  const tdouble3 limmax=TDouble3((g.nx-0.5)*Dp,(sim2d? 0: (g.ny-0.5)*Dp),DBL_MAX);
+  unsigned cp=0;
+  for(int cz=-nl;cz<int(g.nzt);cz++)for(int cy=-nyw;cy<int(g.ny)+nyw;cy++)for(int cx=-nl;cx<int(g.nx)+nl;cx++){
+    if(cz<0 || cx<0 || cx>=int(g.nx) || cy<0 || cy>=int(g.ny)){
+      const tdouble3 ps=TDouble3(Dp*cx,Dp*cy,Dp*cz);
+      const tdouble3 pq=TDouble3(max(limmin.x,min(limmax.x,ps.x)),max(limmin.y,min(limmax.y,ps.y)),max(limmin.z,ps.z));
+      partnor[cp]=pq-ps;
+      pos[cp++]=ps;
+    }
+  }
+  //-Floating and fluid particles.
+  const unsigned ftx0=(g.nx-g.nft)/2,fty0=(sim2d? 0: (g.ny-g.nft)/2),ftz0=g.nz-g.nft;
+  unsigned cpft=g.nfixed,cpf=g.nfixed+g.nfloat;
+  tdouble3 ftcen=TDouble3(0);
+  for(unsigned cz=0;cz<g.nz;cz++)for(unsigned cy=0;cy<g.ny;cy++)for(unsigned cx=0;cx<g.nx;cx++){
+    const tdouble3 ps=TDouble3(Dp*cx,Dp*cy,Dp*cz);
+    const bool ft=(g.nft && cx>=ftx0 && cx<ftx0+g.nft && cz>=ftz0 && (sim2d || (cy>=fty0 && cy<fty0+g.nft)));
+    const unsigned p=(ft? cpft++: cpf++);
+    pos[p]=ps;
+    rhop[p]=float(rhop0*pow(1.+rhop0*(-gravity.z)*(hswl-ps.z)/b,1./gamma));
+    if(ft)ftcen=ftcen+ps;
+  }
+  if(cp!=g.nfixed || cpft!=g.nfixed+g.nfloat || cpf!=npt)Run_Exceptioon("Number of generated particles is invalid.");
+  for(unsigned p=0;p<npt;p++)idp[p]=p;
+  //-Domain limits.
+  tdouble3 posmin=pos[0],posmax=pos[0];
+  for(unsigned p=1;p<npt;p++){ posmin=MinValues(posmin,pos[p]); posmax=MaxValues(posmax,pos[p]); }
+  //-Configuration of constants.
+  JCaseCtes ctes;
+  ctes.SetData2D(sim2d,0);
+  ctes.SetGravity(gravity);
+  ctes.SetCFLnumber(0.2);
+  ctes.SetGamma(gamma);
+  ctes.SetRhop0(rhop0);
+  ctes.SetDp(Dp);
+  ctes.SetH(h);
+  ctes.SetB(b);
+  ctes.SetMassBound(mass);
+  ctes.SetMassFluid(mass);
+  //-Configuration of particle blocks.
+  JCaseParts parts;
+  parts.SetMkFirst(11,1);
+  parts.AddFixed(0,g.nfixed);
+  if(g.nfloat){
+    const double ftmass=800.*g.nfloat*pow(Dp,dim);
+    const double ftmp=ftmass/g.nfloat;
+    ftcen=ftcen/TDouble3(g.nfloat);
+    double ixx=0,iyy=0,izz=0,ixy=0,ixz=0,iyz=0;
+    for(unsigned p=g.nfixed;p<g.nfixed+g.nfloat;p++){
+      const tdouble3 d=pos[p]-ftcen;
+      ixx+=ftmp*(d.y*d.y+d.z*d.z); iyy+=ftmp*(d.x*d.x+d.z*d.z); izz+=ftmp*(d.x*d.x+d.y*d.y);
+      ixy-=ftmp*d.x*d.y; ixz-=ftmp*d.x*d.z; iyz-=ftmp*d.y*d.z;
+    }
+    const tmatrix3d inertia=TMatrix3d(ixx,ixy,ixz,ixy,iyy,iyz,ixz,iyz,izz);
+    parts.AddFloating(1,g.nfloat,ftmass,ftmp,ftcen,inertia,TInt3(1),TInt3(1)
+      ,TDouble3(0),TDouble3(0),NULL,NULL,NULL,NULL);
+  }
+  parts.AddFluid(0,g.nfluid);
+  parts.SetPosDomain(posmin,posmax);
+  //-Configuration of execution parameters.
+  JCaseEParms eparms;
+  eparms.Add("StepAlgorithm","2","Step Algorithm 1:Verlet, 2:Symplectic");
+  eparms.Add("VerletSteps","40","Verlet only: Number of steps to apply Euler timestepping");
+  eparms.Add("Kernel","2","Interaction Kernel 1:Cubic Spline, 2:Wendland");
+  eparms.Add("ViscoTreatment","1","Viscosity formulation 1:Artificial, 2:Laminar+SPS");
+  eparms.Add("Visco","0.01","Viscosity value");
+  eparms.Add("ViscoBoundFactor","1","Multiply viscosity value with boundary");
+  eparms.Add("DensityDT","2","Density Diffusion Term 0:None, 1:Molteni, 2:Fourtakas, 3:Fourtakas(full)");
+  eparms.Add("DensityDTvalue","0.1","DDT value");
+  eparms.Add("Shifting","0","Shifting mode 0:None, 1:Ignore bound, 2:Ignore fixed, 3:Full");
+  eparms.Add("RigidAlgorithm","1","Rigid Algorithm 1:SPH, 2:DEM, 3:Chrono");
+  eparms.Add("FtPause","0.0","Time to freeze the floatings at simulation start (warmup)","seconds");
+  eparms.Add("CoefDtMin","0.05","Coefficient to calculate minimum time step dtmin=coefdtmin*h/speedsound");
+  eparms.Add("DtAllParticles","0","Velocity of particles used to calculate DT. 1:All, 0:Only fluid/floating");
+  eparms.Add("TimeMax","100","Time of simulation","seconds");
+  eparms.Add("TimeOut","100","Time out data","seconds");
+  eparms.Add("RhopOutMin","700","Minimum rhop valid","kg/m^3");
+  eparms.Add("RhopOutMax","1300","Maximum rhop valid","kg/m^3");
+  eparms.Add("Boundary",(Cfg->TBoundary==2? "2": "1"),"Boundary method 1:DBC, 2:mDBC");
+  eparms.Add("SlipMode","1","Slip mode for mDBC 1:DBC vel=0, 2:No-slip, 3:Free slip");
+  //-Saves XML file.
+  fun::MkdirPath(dircase);
+  const string filecase=fun::GetDirWithSlash(dircase)+casename;
+  {
+    JXml xml;
+    ctes.SaveXmlRun(&xml,"case.execution.constants");
+    eparms.SaveXml(&xml,"case.execution.parameters");
+    parts.SaveXml(&xml,"case.execution.particles");
+    xml.SaveFile(filecase+".xml",ClassName,true);
+  }
+  //-Saves BI4 file.
+  {
+    JPartDataBi4 pd;
+    pd.ConfigBasic(0,1,"",ClassName,casename,sim2d,0,dircase);
+    pd.ConfigParticles(npt,g.nfixed,0,g.nfloat,g.nfluid,posmin,posmax);
+    pd.ConfigCtes(Dp,h,b,rhop0,gamma,mass,mass);
+    pd.AddPartInfo(0,0,npt,0,0,0,posmin,posmax);
+    pd.AddPartData(npt,idp.data(),pos.data(),vel.data(),rhop.data());
+    pd.SaveFileCase(casename);
+  }
+  //-Saves normals for mDBC.
+  {
+    JPartNormalData nd;
+    nd.ConfigBasic(ClassName,casename,sim2d,0,Dp,h,Dp/2,false);
+    nd.AddNormalData("BenchTank",g.nfixed,partnor.data());
+    nd.SaveFile(dircase);
+  }
+  Log->Printf("  Case %s: tank %ux%ux%u (fluid depth %u) -> Np:%u (fixed:%u floating:%u fluid:%u)  bound:%.1f%%"
+    ,casename.c_str(),g.nx,g.ny,g.nzt,g.nz,npt,g.nfixed,g.nfloat,g.nfluid,100.*(g.nfixed+g.nfloat)/npt);
+  return(filecase);
+}
+
+//==============================================================================
+/// Executes the synthetic case with a number of particles and threads.
+//==============================================================================
+JDsBenchmark::StBenchRun JDsBenchmark::RunCase(const std::string &scaling
+  ,int threads,unsigned np,const std::string &appname)
+{
+  const string dirrun=DirOut+fun::PrintStr("%s_np%u_th%d",scaling.c_str(),np,threads);
+  Log->Printf("\nRunning %s scaling with %d threads...",scaling.c_str(),threads);
+  const string casename=CreateCase(np,dirrun);
+  //-Configuration of execution.
+  JSphCfgRun cfg=*Cfg;
+  cfg.CaseName=casename;
+  cfg.RunName="";
+  cfg.DirOut=dirrun;
+  cfg.DirDataOut="";
+  cfg.OmpThreads=threads;
+  cfg.NstepsBreak=int(Cfg->BenchSteps);
+  cfg.PartBeginDir=""; cfg.PartBegin=0;
+  cfg.Sv_Binx=false; cfg.Sv_Info=false; cfg.Sv_Csv=false;
+  cfg.Sv_Vtk=false;  cfg.Sv_Vtu=false;  cfg.SvDomainVtk=false;
+  cfg.SvRes=false;   cfg.SvTimers=true;
+  cfg.PipsMode=max(1u,Cfg->PipsMode);
+  cfg.PipsSteps=max(1u,Cfg->BenchSteps/10);
+  //-Executes simulation with its own log file.
+  StBenchRun r;
+  r.scaling=scaling;
+  r.threads=threads;
+  {
+    JLog2 logrun(JLog2::Out_File);
+    logrun.Init(dirrun+"/Run.out");
+    JSphCpuSingle sph;
+    sph.Run(appname,&cfg,&logrun);
+    sph.GetRunSummary(r.rs);
+  }
+  r.np=r.rs.np;
+  r.npb=r.rs.npb;
+  const double sps=(r.rs.tsim? r.rs.nstep/r.rs.tsim: 0);
+  Log->Printf("  Steps:%u  Runtime:%.3f s  Steps/s:%.2f  Particle-steps/s:%.4e  GPIPS:%.4f"
+    ,r.rs.nstep,r.rs.tsim,sps,sps*r.np,(r.rs.tsim? r.rs.gpis/r.rs.tsim: 0));
+  return(r);
+}
+
+//==============================================================================
+/// Executes all configured runs.
+//==============================================================================
+void JDsBenchmark::Run(const std::string &appname){
+  const unsigned np=Cfg->BenchNp;
+  Log->Printf("Benchmark: Np:%u  Dim:%s  BoundFraction:%g  Floating:%s  mDBC:%s  Steps:%u"
+    ,np,(Cfg->BenchSim2D? "2D": "3D"),Cfg->BenchBoundFrac,(Cfg->BenchFloating? "True": "False")
+    ,(Cfg->TBoundary==2? "True": "False"),Cfg->BenchSteps);
+  string txth;
+  for(unsigned c=0;c<unsigned(Threads.size());c++)txth=txth+(c? ",": "")+fun::IntStr(Threads[c]);
+  Log->Printf("  Threads: %s  Scaling:%s%s",txth.c_str(),(Cfg->BenchScaling&1? " strong": ""),(Cfg->BenchScaling&2? " weak": ""));
+  Runs.clear();
+  const int th0=Threads[0];
+  if(Cfg->BenchScaling&1)for(unsigned c=0;c<unsigned(Threads.size());c++){
+    Runs.push_back(RunCase("strong",Threads[c],np,appname));
+  }
+  if(Cfg->BenchScaling&2)for(unsigned c=0;c<unsigned(Threads.size());c++){
+    const unsigned npw=unsigned(double(np)*Threads[c]/th0);
+    Runs.push_back(RunCase("weak",Threads[c],npw,appname));
+  }
+}
+
+//==============================================================================
+/// Computes speedup and parallel efficiency of run cr with respect to the
+/// first run of the same scaling test.
+//==============================================================================
+void JDsBenchmark::GetSpeedup(unsigned cr,double &speedup,double &efficiency)const{
+  const StBenchRun &r=Runs[cr];
+  unsigned c0=cr;
+  for(unsigned c=0;c<cr;c++)if(Runs[c].scaling==r.scaling){ c0=c; break; }
+  const StBenchRun &r0=Runs[c0];
+  const double t0=(r0.rs.nstep? r0.rs.tsim/r0.rs.nstep: 0);
+  const double t =(r.rs.nstep? r.rs.tsim/r.rs.nstep: 0);
+  if(r.scaling=="weak"){
+    //-Weak scaling: work per thread is constant.
+    efficiency=(t? t0/t: 0);
+    speedup=efficiency*r.threads/r0.threads;
+  }
+  else{
+    speedup=(t? t0/t: 0);
+    efficiency=speedup*r0.threads/r.threads;
+  }
+}
+
+//==============================================================================
+/// Shows results of benchmark.
+//==============================================================================
+void JDsBenchmark::VisuResults()const{
+  Log->Print("\n[Benchmark results]");
+  Log->Printf("%-7s %7s %10s %9s %11s %13s %9s %8s %8s","Scaling","Threads","Np","Steps/s","ms/step","Part-steps/s","GPIPS","Speedup","Effic.");
+  for(unsigned cr=0;cr<unsigned(Runs.size());cr++){
+    const StBenchRun &r=Runs[cr];
+    double speedup,efficiency;
+    GetSpeedup(cr,speedup,efficiency);
+    const double sps=(r.rs.tsim? r.rs.nstep/r.rs.tsim: 0);
+    Log->Printf("%-7s %7d %10u %9.2f %11.4f %13.4e %9.4f %8.3f %7.1f%%",r.scaling.c_str(),r.threads,r.np
+      ,sps,(sps? 1000./sps: 0),sps*r.np,(r.rs.tsim? r.rs.gpis/r.rs.tsim: 0),speedup,efficiency*100);
+  }
+  //-Per-phase timings.
+  Log->Print("\n[Benchmark phases (ms/step)]");
+  for(unsigned cr=0;cr<unsigned(Runs.size());cr++){
+    const StBenchRun &r=Runs[cr];
+    Log->Printf("%s scaling, %d threads, Np:%u",r.scaling.c_str(),r.threads,r.np);
+    for(unsigned ct=0;ct<TMC_COUNT;ct++)if(r.rs.timers[ct]>0){
+      Log->Printf("  %-30s %10.4f",TmcGetName(CsTypeTimerCPU(ct)),r.rs.timers[ct]*1000./max(1u,r.rs.nstep));
+    }
+  }
+}
+
+//==============================================================================
+/// Saves results of benchmark in JSON format.
+//==============================================================================
+void JDsBenchmark::SaveJson(const std::string &file)const{
+  std::vector<std::string> vruns;
+  for(unsigned cr=0;cr<unsigned(Runs.size());cr++){
+    const StBenchRun &r=Runs[cr];
+    double speedup,efficiency;
+    GetSpeedup(cr,speedup,efficiency);
+    const double sps=(r.rs.tsim? r.rs.nstep/r.rs.tsim: 0);
+    std::vector<std::string> vphases;
+    for(unsigned ct=0;ct<TMC_COUNT;ct++)if(r.rs.timers[ct]>=0){
+      vphases.push_back(fun::JSONPropertyValue(string(TmcGetName(CsTypeTimerCPU(ct))),fun::DoubleStr(r.rs.timers[ct]*1000./max(1u,r.rs.nstep),"%.6e")));
+    }
+    std::vector<std::string> v;
+    v.push_back(fun::JSONProperty("scaling",r.scaling));
+    v.push_back(fun::JSONProperty("threads",r.threads));
+    v.push_back(fun::JSONProperty("np",r.np));
+    v.push_back(fun::JSONProperty("npb",r.npb));
+    v.push_back(fun::JSONProperty("steps",r.rs.nstep));
+    v.push_back(fun::JSONPropertyValue("runtime_s",fun::DoubleStr(r.rs.tsim,"%.6e")));
+    v.push_back(fun::JSONPropertyValue("steps_per_s",fun::DoubleStr(sps,"%.6e")));
+    v.push_back(fun::JSONPropertyValue("particle_steps_per_s",fun::DoubleStr(sps*r.np,"%.6e")));
+    v.push_back(fun::JSONPropertyValue("gpips",fun::DoubleStr((r.rs.tsim? r.rs.gpis/r.rs.tsim: 0),"%.6e")));
+    v.push_back(fun::JSONPropertyValue("speedup",fun::DoubleStr(speedup,"%.6e")));
+    v.push_back(fun::JSONPropertyValue("efficiency",fun::DoubleStr(efficiency,"%.6e")));
+    v.push_back(fun::JSONPropertyValue("phases_ms_per_step",fun::JSONObject(vphases)));
+    vruns.push_back(fun::JSONObject(v));
+  }
+  std::vector<std::string> vcfg;
+  vcfg.push_back(fun::JSONProperty("np",Cfg->BenchNp));
+  vcfg.push_back(fun::JSONProperty("dim",(Cfg->BenchSim2D? 2: 3)));
+  vcfg.push_back(fun::JSONPropertyValue("boundfraction",fun::DoubleStr(Cfg->BenchBoundFrac,"%g")));
+  vcfg.push_back(fun::JSONProperty("floating",Cfg->BenchFloating));
+  vcfg.push_back(fun::JSONProperty("mdbc",Cfg->TBoundary==2));
+  vcfg.push_back(fun::JSONProperty("steps",Cfg->BenchSteps));
+  std::vector<std::string> vres;
+  vres.push_back(fun::JSONPropertyValue("config",fun::JSONObject(vcfg)));
+  vres.push_back(fun::JSONPropertyValue("runs",fun::JSONArray(vruns)));
+  ofstream pf;
+  pf.open(file.c_str());
+  if(!pf)Run_ExceptioonFile("Cannot open the file.",file);
+  pf << fun::JSONObject(vres) << endl;
+  if(pf.fail())Run_ExceptioonFile("File writing failure.",file);
+  pf.close();
+  Log->AddFileInfo(file,"Results of benchmark in JSON format.");
+}
+
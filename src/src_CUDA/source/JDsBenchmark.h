@@ -0,0 +1,105 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Modo benchmark (-benchmark) que genera un caso sintetico parametrizado
+//:#   (tanque con paredes, fraccion de contorno, floating opcional y normales
+//:#   para mDBC) sin GenCase y ejecuta K pasos con JSphCpuSingle para medir
+//:#   pasos/s, interacciones/s, tiempos por fase y escalado fuerte/debil
+//:#   en funcion del numero de hilos. (19-10-2026)
+//:#############################################################################
+
+/// \file JDsBenchmark.h \brief Declares the class \ref JDsBenchmark.
+
+#ifndef _JDsBenchmark_
+#define _JDsBenchmark_
+
+#include "JObject.h"
+#include "TypesDef.h"
+#include "JSphCpuSingle.h"
+#include <string>
+#include <vector>
+
+class JLog2;
+class JSphCfgRun;
+
+//##############################################################################
+//# JDsBenchmark
+//##############################################################################
+/// \brief Throughput benchmark of full simulation steps on CPU.
+///
+/// A still tank with walls of boundary particles (and optionally a floating
+/// box) is created for the requested number of particles and fraction of
+/// boundary particles. The case files (XML, BI4 and normal data for mDBC) are
+/// written using the same classes as GenCase. The case is executed with
+/// JSphCpuSingle for a number of steps and for each number of OpenMP threads
+/// (strong and/or weak scaling). Results are shown and saved in JSON format.
+
+class JDsBenchmark : protected JObject
+{
+protected:
+  ///Geometry of synthetic case.
+  typedef struct{
+    unsigned nx,ny,nz;      ///<Fluid lattice (before floating body).
+    unsigned nzt;           ///<Height of the tank (in particles).
+    unsigned nft;           ///<Size of floating box (in particles, 0:no floating).
+    unsigned nfixed;        ///<Number of fixed boundary particles.
+    unsigned nfloat;        ///<Number of floating particles.
+    unsigned nfluid;        ///<Number of fluid particles.
+  }StBenchGeo;
+
+  ///Results of one execution.
+  typedef struct{
+    std::string scaling;    ///<Scaling test (strong or weak).
+    int threads;            ///<Number of OpenMP threads.
+    unsigned np;            ///<Number of particles.
+    unsigned npb;           ///<Number of boundary particles.
+    StRunSummaryCpu rs;     ///<Summary of execution.
+  }StBenchRun;
+
+  JLog2 *Log;
+  const JSphCfgRun *Cfg;    ///<Configuration of execution (options of command line).
+  const std::string DirOut; ///<Output directory.
+
+  static const int LAYERS=2; ///<Number of layers of boundary walls.
+  double Dp;                ///<Distance between particles.
+
+  std::vector<int> Threads;
+  std::vector<StBenchRun> Runs;
+
+  unsigned CountWalls(unsigned nx,unsigned ny,unsigned nzt)const;
+  StBenchGeo ComputeGeometry(unsigned np)const;
+  std::string CreateCase(unsigned np,const std::string &dircase);
+  StBenchRun RunCase(const std::string &scaling,int threads,unsigned np,const std::string &appname);
+
+  void GetSpeedup(unsigned cr,double &speedup,double &efficiency)const;
+
+public:
+  JDsBenchmark(const JSphCfgRun *cfg,const std::string &dirout,JLog2 *log);
+  ~JDsBenchmark();
+
+  void Run(const std::string &appname);
+  void VisuResults()const;
+  void SaveJson(const std::string &file)const;
+};
+
+#endif
+
+
@@ -0,0 +1,210 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JDsCellModeAuto.cpp \brief Implements the class \ref JDsCellModeAuto.
+
+#include "JDsCellModeAuto.h"
+#include "JDsPips.h"
+#include "JLog2.h"
+#include "Functions.h"
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+#define CMAUTO_MODELMARGIN 1.5   ///<Estimated cost ratio to select the mode without timed trials.
+#define CMAUTO_SWITCHMARGIN 1.03 ///<Measured cost ratio to change the cell mode after timed trials.
+#define CMAUTO_MINGAP 20         ///<Minimum steps between selections (in units of TrialSteps).
+
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JDsCellModeAuto::JDsCellModeAuto(bool sim2d,unsigned trialsteps,float reevalfactor,JLog2 *log)
+  :Log(log),Sim2D(sim2d),TrialSteps(max(trialsteps,1u)),ReevalFactor(max(double(reevalfactor),1.1))
+{
+  ClassName="JDsCellModeAuto";
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JDsCellModeAuto::~JDsCellModeAuto(){
+  DestructorActive=true;
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JDsCellModeAuto::Reset(){
+  CellMode=CELLMODE_Full;
+  State=CMAUTO_Model;
+  TrialFirst=CELLMODE_Full;
+  TrialSkip=0;
+  TrialTimes.clear();
+  TrialCost[0]=TrialCost[1]=0;
+  RefOccupancy=0;
+  NstepSelec=0;
+  Decisions.clear();
+  NumTrials=NumSwitches=0;
+}
+
+//==============================================================================
+/// Configures initial cell mode and starts the first selection.
+//==============================================================================
+void JDsCellModeAuto::Config(TpCellMode cellmode){
+  Reset();
+  CellMode=cellmode;
+}
+
+//==============================================================================
+/// Shows configuration.
+//==============================================================================
+void JDsCellModeAuto::VisuConfig()const{
+  Log->Printf("CellMode auto: initial mode %s, trials of %u steps, reevaluation with change x%g of particles per cell."
+    ,GetNameCellMode(CellMode),TrialSteps,ReevalFactor);
+}
+
+//==============================================================================
+/// Returns number of particles per cell of size KernelSize of the divided
+/// domain (used to detect important changes in the distribution of particles).
+//==============================================================================
+double JDsCellModeAuto::GetOccupancy(unsigned np,const StDivDataCpu &dvd)const{
+  const double ncells=double(dvd.nc.x)*double(dvd.nc.y)*double(dvd.nc.z);
+  const double scelldiv=(dvd.scelldiv? dvd.scelldiv: 1);
+  const double ncellsfull=ncells/pow(scelldiv,(Sim2D? 2.: 3.));
+  return(ncellsfull>0? np/ncellsfull: 0);
+}
+
+//==============================================================================
+/// Returns median of values.
+//==============================================================================
+double JDsCellModeAuto::GetMedian(std::vector<double> v){
+  if(v.empty())return(0);
+  sort(v.begin(),v.end());
+  const size_t n=v.size();
+  return(n%2? v[n/2]: (v[n/2-1]+v[n/2])/2);
+}
+
+//==============================================================================
+/// Stores the selected cell mode and starts checking the distribution.
+//==============================================================================
+void JDsCellModeAuto::Select(unsigned nstep,double occupancy,TpCellMode cellmode,const std::string &method){
+  StDecision d={nstep,cellmode,method};
+  Decisions.push_back(d);
+  if(cellmode!=CellMode)NumSwitches++;
+  Log->Printf("CellMode auto: %s selected at step %u by %s (particles per cell: %.2f).",GetNameCellMode(cellmode),nstep,method.c_str(),occupancy);
+  CellMode=cellmode;
+  State=CMAUTO_Watch;
+  RefOccupancy=occupancy;
+  NstepSelec=nstep;
+}
+
+//==============================================================================
+/// Estimates the cost of both modes with the neighbour statistics of PIPS.
+/// Selects the mode when the difference is clear, otherwise starts timed
+/// trials. Returns the cell mode to apply.
+//==============================================================================
+TpCellMode JDsCellModeAuto::EvalModel(unsigned nstep,double occupancy,const JDsPips *pips){
+  if(pips && !pips->GetNumSamples())return(CellMode); //-Waits for the next sample of PIPS.
+  if(pips){
+    double chk[2],real[2],range[2],bytes[2];
+    for(unsigned cm=0;cm<2;cm++){
+      const TpCellMode cellmode=(!cm? CELLMODE_Full: CELLMODE_Half);
+      pips->GetModelCellMode(cellmode,chk[cm],real[cm],range[cm],bytes[cm]);
+    }
+    const double ratio=(bytes[0]? bytes[1]/bytes[0]: 1);
+    Log->Printf("CellMode auto: model at step %u  Full[eff:%.1f%% ranges:%.0f]  Half[eff:%.1f%% ranges:%.0f]  cost Half/Full: %.3f"
+      ,nstep,(chk[0]? real[0]*100/chk[0]: 0),range[0],(chk[1]? real[1]*100/chk[1]: 0),range[1],ratio);
+    if(ratio>CMAUTO_MODELMARGIN || ratio*CMAUTO_MODELMARGIN<1){
+      Select(nstep,occupancy,(ratio<1? CELLMODE_Half: CELLMODE_Full),"model");
+      return(CellMode);
+    }
+  }
+  //-Starts timed trials with the current mode.
+  State=CMAUTO_Trial;
+  TrialFirst=CellMode;
+  TrialSkip=WARMUP_STEPS;
+  TrialTimes.clear();
+  NumTrials++;
+  return(CellMode);
+}
+
+//==============================================================================
+/// Adds the last measured step to timed trials and changes to the other mode
+/// or selects the fastest one when the trial is finished. Returns the cell
+/// mode to apply.
+//==============================================================================
+TpCellMode JDsCellModeAuto::EvalTrial(unsigned nstep,double occupancy){
+  if(TrialTimes.size()<TrialSteps)return(CellMode);
+  TrialCost[ModeIdx(CellMode)]=GetMedian(TrialTimes);
+  TrialTimes.clear();
+  if(CellMode==TrialFirst){
+    //-Starts trial of the other mode.
+    CellMode=OtherMode(CellMode);
+    TrialSkip=WARMUP_STEPS;
+    NumSwitches++;
+  }
+  else{
+    const double cfirst=TrialCost[ModeIdx(TrialFirst)],cother=TrialCost[ModeIdx(CellMode)];
+    Log->Printf("CellMode auto: trial at step %u  Full: %s  Half: %s  (s per particle and step)",nstep
+      ,fun::DoubleStr(TrialCost[0],"%.4e").c_str(),fun::DoubleStr(TrialCost[1],"%.4e").c_str());
+    //-The other mode is kept only when it is clearly faster.
+    Select(nstep,occupancy,(cother*CMAUTO_SWITCHMARGIN<cfirst? OtherMode(TrialFirst): TrialFirst),"trial");
+  }
+  return(CellMode);
+}
+
+//==============================================================================
+/// Ends the measurement of the step after the cell division and returns the
+/// cell mode to apply from the next step.
+//==============================================================================
+TpCellMode JDsCellModeAuto::StepEnd(unsigned nstep,unsigned np,const StDivDataCpu &dvd,const JDsPips *pips){
+  TimerStep.Stop();
+  const double occupancy=GetOccupancy(np,dvd);
+  TpCellMode ret=CellMode;
+  if(State==CMAUTO_Model)ret=EvalModel(nstep,occupancy,pips);
+  else if(State==CMAUTO_Trial){
+    if(TrialSkip)TrialSkip--;
+    else{
+      TrialTimes.push_back(TimerStep.GetElapsedTimeD()/1000./max(np,1u));
+      ret=EvalTrial(nstep,occupancy);
+    }
+  }
+  else if(State==CMAUTO_Watch && nstep>=NstepSelec+TrialSteps*CMAUTO_MINGAP){
+    if(occupancy>RefOccupancy*ReevalFactor || occupancy*ReevalFactor<RefOccupancy){
+      Log->Printf("CellMode auto: reevaluation at step %u (particles per cell: %.2f -> %.2f).",nstep,RefOccupancy,occupancy);
+      State=CMAUTO_Model;
+      ret=EvalModel(nstep,occupancy,pips);
+    }
+  }
+  return(ret);
+}
+
+//==============================================================================
+/// Shows summary of the selections.
+//==============================================================================
+void JDsCellModeAuto::VisuSummary()const{
+  Log->Printf("[CellMode auto] %u selections (%u with timed trials), %u changes of cell mode, final mode %s."
+    ,unsigned(Decisions.size()),NumTrials,NumSwitches,GetNameCellMode(CellMode));
+  for(unsigned c=0;c<unsigned(Decisions.size());c++){
+    const StDecision &d=Decisions[c];
+    Log->Printf("  Step %-9u %-4s (%s)",d.nstep,GetNameCellMode(d.cellmode),d.method.c_str());
+  }
+}
+
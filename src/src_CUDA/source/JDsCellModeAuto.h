@@ -0,0 +1,123 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Seleccion automatica de CellMode (Full o Half) en CPU durante la
+//:#   simulacion (-cellmode:auto). El coste de ambos modos se estima con las
+//:#   estadisticas de vecinos de JDsPips y, cuando la estimacion no es
+//:#   concluyente, con pruebas cronometradas de unos pasos en cada modo. La
+//:#   seleccion se repite cuando cambia mucho el numero de particulas por
+//:#   celda. (19-10-2026)
+//:#############################################################################
+
+/// \file JDsCellModeAuto.h \brief Declares the class \ref JDsCellModeAuto.
+
+#ifndef _JDsCellModeAuto_
+#define _JDsCellModeAuto_
+
+#include "JObject.h"
+#include "DualSphDef.h"
+#include "JCellDivDataCpu.h"
+#include "JTimer.h"
+#include <string>
+#include <vector>
+
+class JLog2;
+class JDsPips;
+
+//##############################################################################
+//# JDsCellModeAuto
+//##############################################################################
+/// \brief Automatic selection of the cell division mode (Full or Half) on CPU.
+///
+/// The cost of both cell modes is first estimated from the neighbour
+/// statistics of PIPS (checked and real interactions and cell ranges of the
+/// current mode and estimation for the other one). When the estimated costs
+/// are similar, both modes are measured during a few steps (timed trials) and
+/// the fastest one is selected. The selection is repeated when the number of
+/// particles per cell of the divided domain changes by a given factor. The
+/// changes of cell mode are applied by the caller after a cell division.
+
+class JDsCellModeAuto : protected JObject
+{
+protected:
+  ///States of the selection.
+  typedef enum{
+     CMAUTO_Model=0   ///<Waits for neighbour statistics to estimate the cost of both modes.
+    ,CMAUTO_Trial=1   ///<Timed trials of both modes.
+    ,CMAUTO_Watch=2   ///<Mode is selected and the distribution of particles is checked.
+  }TpState;
+
+  ///Information of one selection.
+  typedef struct{
+    unsigned nstep;         ///<Step of the selection.
+    TpCellMode cellmode;    ///<Selected cell mode.
+    std::string method;     ///<Method of the selection (model or trial).
+  }StDecision;
+
+  static const unsigned WARMUP_STEPS=1; ///<Steps ignored after a change of cell mode.
+
+  JLog2 *Log;
+  const bool Sim2D;
+  const unsigned TrialSteps;  ///<Number of measured steps of each timed trial.
+  const double ReevalFactor;  ///<Change of particles per cell to repeat the selection.
+
+  TpCellMode CellMode;        ///<Current cell mode.
+  TpState State;
+  JTimer TimerStep;           ///<Measures runtime of current step.
+
+  TpCellMode TrialFirst;      ///<Cell mode at the beginning of timed trials.
+  unsigned TrialSkip;         ///<Remaining steps to ignore in current trial.
+  std::vector<double> TrialTimes; ///<Runtime per particle of the measured steps of current trial.
+  double TrialCost[2];        ///<Median runtime per particle and step of Full and Half.
+
+  double RefOccupancy;        ///<Particles per cell (of size KernelSize) at the last selection.
+  unsigned NstepSelec;        ///<Step of last selection.
+  std::vector<StDecision> Decisions;
+  unsigned NumTrials;         ///<Number of selections with timed trials.
+  unsigned NumSwitches;       ///<Number of changes of cell mode (including trials).
+
+  static unsigned ModeIdx(TpCellMode cellmode){ return(cellmode==CELLMODE_Half? 1: 0); }
+  static TpCellMode OtherMode(TpCellMode cellmode){ return(cellmode==CELLMODE_Half? CELLMODE_Full: CELLMODE_Half); }
+  double GetOccupancy(unsigned np,const StDivDataCpu &dvd)const;
+  static double GetMedian(std::vector<double> v);
+
+  TpCellMode EvalModel(unsigned nstep,double occupancy,const JDsPips *pips);
+  TpCellMode EvalTrial(unsigned nstep,double occupancy);
+  void Select(unsigned nstep,double occupancy,TpCellMode cellmode,const std::string &method);
+
+public:
+  JDsCellModeAuto(bool sim2d,unsigned trialsteps,float reevalfactor,JLog2 *log);
+  ~JDsCellModeAuto();
+  void Reset();
+  void Config(TpCellMode cellmode);
+  void VisuConfig()const;
+
+  TpCellMode GetCellMode()const{ return(CellMode); }
+
+  void StepStart(){ TimerStep.Start(); }
+  TpCellMode StepEnd(unsigned nstep,unsigned np,const StDivDataCpu &dvd,const JDsPips *pips);
+
+  void VisuSummary()const;
+};
+
+#endif
+
+
@@ -0,0 +1,575 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JDsCheckpoint.cpp \brief Implements the classes \ref JDsCheckpoint and \ref JDsCheckpointChain.
+
+#include "JDsCheckpoint.h"
+#include "Functions.h"
+#include <fstream>
+#include <cstdio>
+#include <algorithm>
+#include <ctime>
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+#endif
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+using namespace std;
+
+//-Header of checkpoint file.
+typedef struct{
+  char magic[8];      ///<Identifier "DSCHKPT1".
+  unsigned version;   ///<Version of format.
+  unsigned nitems;    ///<Number of items.
+  ullong tableoffset; ///<Offset of table of items.
+  ullong filesize;    ///<Total size of file.
+  byte reserved[32];
+}StChkHead;
+
+//==============================================================================
+/// Returns 64-bit hash of data block (multiply-rotate mixing of 8-byte words).
+//==============================================================================
+static ullong HashBlock(const byte *ptr,ullong size){
+  const ullong k1=0x87c37b91114253d5ULL,k2=0x4cf5ad432745937fULL;
+  ullong h=0x9e3779b97f4a7c15ULL^size;
+  const ullong n8=size/8;
+  for(ullong c=0;c<n8;c++){
+    ullong w; memcpy(&w,ptr+c*8,8);
+    h^=w*k1;
+    h=((h<<31)|(h>>33))*k2;
+  }
+  for(ullong c=n8*8;c<size;c++)h=(h^ptr[c])*k1;
+  h^=h>>33; h*=0xff51afd7ed558ccdULL;
+  h^=h>>33; h*=0xc4ceb9fe1a85ec53ULL;
+  h^=h>>33;
+  return(h);
+}
+
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JDsCheckpoint::JDsCheckpoint(){
+  ClassName="JDsCheckpoint";
+  Data=NULL; Prev=NULL;
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JDsCheckpoint::~JDsCheckpoint(){
+  DestructorActive=true;
+  Reset();
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JDsCheckpoint::Reset(){
+  CloseFile();
+  Items.clear();
+}
+
+//==============================================================================
+/// Releases data of loaded file.
+//==============================================================================
+void JDsCheckpoint::CloseFile(){
+  if(Data){
+   #ifndef _WIN32
+    if(Mapped)munmap(Data,size_t(DataSize));
+    else
+   #endif
+    delete[] Data;
+  }
+  Data=NULL;
+  DataSize=0;
+  Mapped=false;
+  FileName="";
+  delete Prev; Prev=NULL;
+  ChainIndex=0; ChainId=0;
+}
+
+//==============================================================================
+/// Adds new item for saving. Small data can be copied to allow temporary values.
+//==============================================================================
+void JDsCheckpoint::AddItem(const std::string &name,unsigned esize,ullong count,const void *ptr,bool copy){
+  if(name.empty() || name.size()>=NAMESIZE || name.find('@')!=string::npos || name.substr(0,6)=="chain.")
+    Run_Exceptioon(string("The name of item \'")+name+"\' is invalid.");
+  if(FindItem(name)!=UINT_MAX)Run_Exceptioon(string("The item \'")+name+"\' already exists.");
+  if(count && !ptr)Run_Exceptioon(string("The data of item \'")+name+"\' is missing.");
+  StItem item;
+  item.name=name;
+  item.esize=esize;
+  item.flags=0;
+  item.count=count;
+  item.ptr=(copy? NULL: ptr);
+  if(copy && count)item.value=string((const char*)ptr,size_t(esize*count));
+  item.offset=0;
+  item.size=ItemSize(item);
+  Items.push_back(item);
+}
+
+//==============================================================================
+/// Returns index of item with the given name (UINT_MAX when it does not exist).
+//==============================================================================
+unsigned JDsCheckpoint::FindItem(const std::string &name)const{
+  unsigned c=0;
+  const unsigned n=unsigned(Items.size());
+  for(;c<n && Items[c].name!=name;c++);
+  return(c<n? c: UINT_MAX);
+}
+
+//==============================================================================
+/// Returns item with the given name and checks size of element (when esize!=0).
+//==============================================================================
+const JDsCheckpoint::StItem& JDsCheckpoint::GetItem(const std::string &name,unsigned esize)const{
+  const unsigned c=FindItem(name);
+  if(c==UINT_MAX)Run_ExceptioonFile(string("The item \'")+name+"\' is missing.",FileName);
+  if(esize && Items[c].esize!=esize)Run_ExceptioonFile(string("The element size of item \'")+name+"\' is invalid.",FileName);
+  return(Items[c]);
+}
+
+//==============================================================================
+/// Returns size of saved data of delta item with the given blocks.
+//==============================================================================
+ullong JDsCheckpoint::DeltaSize(const StItem &item,const std::vector<unsigned> &blocks){
+  const ullong size=ItemSize(item);
+  const ullong nb=ullong(blocks.size());
+  ullong ret=nb*BLOCKSIZE;
+  if(nb && ullong(blocks[nb-1])*BLOCKSIZE+BLOCKSIZE>size)ret-=ullong(blocks[nb-1])*BLOCKSIZE+BLOCKSIZE-size;
+  return(ret);
+}
+
+//==============================================================================
+/// Computes hash of each block of data of item. Blocks are processed in parallel.
+//==============================================================================
+void JDsCheckpoint::ComputeHashes(const StItem &item,StHashes &hs){
+  const ullong size=ItemSize(item);
+  const byte *ptr=ItemPtr(item);
+  const int nb=int((size+BLOCKSIZE-1)/BLOCKSIZE);
+  hs.esize=item.esize;
+  hs.count=item.count;
+  hs.hashes.resize(nb);
+  ullong *hashes=(nb? &hs.hashes[0]: NULL);
+  #ifdef _OPENMP
+    #pragma omp parallel for schedule (static) if(nb>4)
+  #endif
+  for(int cb=0;cb<nb;cb++){
+    const ullong ini=ullong(cb)*BLOCKSIZE;
+    hashes[cb]=HashBlock(ptr+ini,min(ullong(BLOCKSIZE),size-ini));
+  }
+}
+
+//==============================================================================
+/// Copies data of item from loaded file. Big arrays are copied in parallel so
+/// page faults of mapped file are also served in parallel. Data of delta items
+/// is obtained from the previous checkpoints of the chain and the saved blocks
+/// are applied on it.
+//==============================================================================
+void JDsCheckpoint::CopyData(const StItem &item,void *dst)const{
+  if(!Data)Run_Exceptioon("There is no loaded file.");
+  if(item.offset+item.size>DataSize)Run_ExceptioonFile(string("The data of item \'")+item.name+"\' is out of file.",FileName);
+  const byte *src=Data+item.offset;
+  if(item.flags&ITEM_DELTA){
+    if(!Prev)Run_ExceptioonFile("The previous checkpoint of the chain is missing.",FileName);
+    const StItem &pitem=Prev->GetItem(item.name,item.esize);
+    if(pitem.count!=item.count)Run_ExceptioonFile(string("The number of elements of item \'")+item.name+"\' does not match the previous checkpoint.",FileName);
+    Prev->CopyData(pitem,dst);
+    std::vector<unsigned> blocks;
+    const StItem &bitem=GetItem(item.name+"@blocks",sizeof(unsigned));
+    blocks.resize(size_t(bitem.count));
+    if(bitem.count)memcpy(&blocks[0],Data+bitem.offset,size_t(bitem.size));
+    const ullong size=ItemSize(item);
+    const int nb=int(blocks.size());
+    #ifdef _OPENMP
+      #pragma omp parallel for schedule (static) if(nb>4)
+    #endif
+    for(int cb=0;cb<nb;cb++){
+      const ullong ini=ullong(blocks[cb])*BLOCKSIZE;
+      memcpy((byte*)dst+ini,src+ullong(cb)*BLOCKSIZE,size_t(min(ullong(BLOCKSIZE),size-ini)));
+    }
+    return;
+  }
+  const ullong size=item.size;
+  const ullong sizechunk=ullong(1)<<22;
+  const int nchunks=int((size+sizechunk-1)/sizechunk);
+  if(nchunks<=1)memcpy(dst,src,size_t(size));
+  else{
+    #ifdef _OPENMP
+      #pragma omp parallel for schedule (static)
+    #endif
+    for(int cc=0;cc<nchunks;cc++){
+      const ullong ini=sizechunk*ullong(cc);
+      const ullong n=min(sizechunk,size-ini);
+      memcpy((byte*)dst+ini,src+ini,size_t(n));
+    }
+  }
+}
+
+//==============================================================================
+/// Returns string value.
+//==============================================================================
+std::string JDsCheckpoint::GetStr(const std::string &name)const{
+  const StItem &item=GetItem(name,1);
+  string ret(size_t(item.count),' ');
+  if(item.count)CopyData(item,&ret[0]);
+  return(ret);
+}
+
+//==============================================================================
+/// Returns size of data of all items.
+//==============================================================================
+ullong JDsCheckpoint::GetDataSize()const{
+  ullong size=0;
+  for(unsigned c=0;c<unsigned(Items.size());c++)size+=ItemSize(Items[c]);
+  return(size);
+}
+
+//==============================================================================
+/// Saves all items in file and returns the size of saved data. Optionally
+/// computes the block hashes of the data for following delta checkpoints.
+//==============================================================================
+ullong JDsCheckpoint::SaveFile(const std::string &file,unsigned chainidx,TpHashes *hashes){
+  if(hashes){
+    hashes->clear();
+    for(unsigned c=0;c<unsigned(Items.size());c++)ComputeHashes(Items[c],(*hashes)[Items[c].name]);
+  }
+  std::vector<StItem> items;
+  NewChainItems(chainidx,items);
+  items.insert(items.end(),Items.begin(),Items.end());
+  SaveItems(file,items);
+  return(GetDataSize());
+}
+
+//==============================================================================
+/// Saves delta checkpoint with the blocks that changed since the previous
+/// checkpoint of the chain (prevfile) according to the given block hashes,
+/// which are updated with the current data. Items that changed their number
+/// of elements are saved complete. Returns the size of saved data.
+//==============================================================================
+ullong JDsCheckpoint::SaveFileDelta(const std::string &file,unsigned chainidx,const std::string &prevfile,ullong previd,TpHashes &hashes){
+  TpHashes newhashes;
+  std::vector<StItem> items;
+  NewChainItems(chainidx,items);
+  //-Name and identifier of previous file of the chain (in the same directory).
+  const string prevname=fun::GetFile(prevfile);
+  items.push_back(MakeItem("chain.Prev",1,prevname.size(),prevname.c_str()));
+  items.push_back(MakeItem("chain.PrevId",sizeof(ullong),1,&previd));
+  ullong size=0;
+  for(unsigned c=0;c<unsigned(Items.size());c++){
+    const StItem &item=Items[c];
+    StHashes &hs=newhashes[item.name];
+    ComputeHashes(item,hs);
+    TpHashes::const_iterator it=hashes.find(item.name);
+    const bool delta=(it!=hashes.end() && it->second.esize==item.esize && it->second.count==item.count
+      && ItemSize(item)>BLOCKSIZE && item.name.size()+7<NAMESIZE);
+    if(!delta){
+      items.push_back(item);
+      size+=item.size;
+    }
+    else{
+      //-Selects changed blocks.
+      const std::vector<ullong> &prevhs=it->second.hashes;
+      StItem ditem=item;
+      ditem.flags=ITEM_DELTA;
+      for(unsigned cb=0;cb<unsigned(hs.hashes.size());cb++)if(hs.hashes[cb]!=prevhs[cb])ditem.blocks.push_back(cb);
+      ditem.size=DeltaSize(ditem,ditem.blocks);
+      //-List of saved blocks.
+      const StItem bitem=MakeItem(item.name+"@blocks",sizeof(unsigned),ditem.blocks.size(),(ditem.blocks.empty()? NULL: &ditem.blocks[0]));
+      items.push_back(ditem);
+      items.push_back(bitem);
+      size+=ditem.size+bitem.size;
+    }
+  }
+  SaveItems(file,items);
+  hashes.swap(newhashes);
+  return(size);
+}
+
+//==============================================================================
+/// Returns item with a copy of the given data.
+//==============================================================================
+JDsCheckpoint::StItem JDsCheckpoint::MakeItem(const std::string &name,unsigned esize,ullong count,const void *ptr){
+  StItem item;
+  item.name=name;
+  item.esize=esize;
+  item.flags=0;
+  item.count=count;
+  item.ptr=NULL;
+  if(count)item.value=string((const char*)ptr,size_t(esize*count));
+  item.offset=0;
+  item.size=ItemSize(item);
+  return(item);
+}
+
+//==============================================================================
+/// Defines index and new unique identifier of the checkpoint to save and
+/// adds the corresponding items.
+//==============================================================================
+void JDsCheckpoint::NewChainItems(unsigned chainidx,std::vector<StItem> &items){
+  const ullong seed[]={ullong(time(NULL)),ullong(clock()),ullong(chainidx),ullong((size_t)this),ChainId};
+  ChainIndex=chainidx;
+  ChainId=HashBlock((const byte*)seed,sizeof(seed));
+  items.push_back(MakeItem("chain.Index",sizeof(unsigned),1,&ChainIndex));
+  items.push_back(MakeItem("chain.Id",sizeof(ullong),1,&ChainId));
+}
+
+//==============================================================================
+/// Saves items in file. Data is written in a temporary file which is renamed
+/// at the end. Only the selected blocks of delta items are written.
+//==============================================================================
+void JDsCheckpoint::SaveItems(const std::string &file,const std::vector<StItem> &items)const{
+  const unsigned nitems=unsigned(items.size());
+  //-Computes offset of each item.
+  std::vector<ullong> offsets(nitems);
+  ullong offset=sizeof(StChkHead);
+  for(unsigned c=0;c<nitems;c++){
+    offset=(offset+ALIGN-1)/ALIGN*ALIGN;
+    offsets[c]=offset;
+    offset+=items[c].size;
+  }
+  const ullong tableoffset=(offset+ALIGN-1)/ALIGN*ALIGN;
+  const unsigned sizeentry=NAMESIZE+sizeof(unsigned)*2+sizeof(ullong)*2;
+  //-Prepares header and table of items.
+  StChkHead head;
+  memset(&head,0,sizeof(StChkHead));
+  memcpy(head.magic,"DSCHKPT1",8);
+  head.version=VERSION;
+  head.nitems=nitems;
+  head.tableoffset=tableoffset;
+  head.filesize=tableoffset+ullong(sizeentry)*nitems;
+  std::vector<byte> table(size_t(sizeentry)*nitems,0);
+  for(unsigned c=0;c<nitems;c++){
+    byte *ptr=&table[size_t(sizeentry)*c];
+    const StItem &item=items[c];
+    memcpy(ptr,item.name.c_str(),item.name.size());  ptr+=NAMESIZE;
+    memcpy(ptr,&item.esize,sizeof(unsigned));       ptr+=sizeof(unsigned);
+    memcpy(ptr,&item.flags,sizeof(unsigned));       ptr+=sizeof(unsigned);
+    memcpy(ptr,&item.count,sizeof(ullong));         ptr+=sizeof(ullong);
+    memcpy(ptr,&offsets[c],sizeof(ullong));
+  }
+  //-Writes temporary file.
+  const string filetmp=file+".tmp";
+  ofstream pf;
+  pf.open(filetmp.c_str(),ios::binary|ios::out);
+  if(!pf)Run_ExceptioonFile("File could not be created.",filetmp);
+  pf.write((const char*)&head,sizeof(StChkHead));
+  ullong pos=sizeof(StChkHead);
+  const char zeros[ALIGN]={0};
+  for(unsigned c=0;c<nitems && pf;c++){
+    const StItem &item=items[c];
+    if(offsets[c]>pos)pf.write(zeros,std::streamsize(offsets[c]-pos));
+    const byte *data=ItemPtr(item);
+    if(item.flags&ITEM_DELTA){
+      const ullong size=ItemSize(item);
+      for(unsigned cb=0;cb<unsigned(item.blocks.size()) && pf;cb++){
+        const ullong ini=ullong(item.blocks[cb])*BLOCKSIZE;
+        pf.write((const char*)data+ini,std::streamsize(min(ullong(BLOCKSIZE),size-ini)));
+      }
+    }
+    else if(item.size)pf.write((const char*)data,std::streamsize(item.size));
+    pos=offsets[c]+item.size;
+  }
+  if(pf && tableoffset>pos)pf.write(zeros,std::streamsize(tableoffset-pos));
+  if(pf && nitems)pf.write((const char*)&table[0],std::streamsize(table.size()));
+  const bool ok=!pf.fail();
+  pf.close();
+  if(!ok || pf.fail())Run_ExceptioonFile("File could not be written.",filetmp);
+  //-Replaces previous file.
+ #ifdef _WIN32
+  remove(file.c_str());
+ #endif
+  if(rename(filetmp.c_str(),file.c_str()))Run_ExceptioonFile("File could not be renamed.",file);
+}
+
+//==============================================================================
+/// Loads checkpoint file. The file is mapped in memory when it is possible.
+//==============================================================================
+void JDsCheckpoint::LoadFile(const std::string &file){
+  Reset();
+  if(!fun::FileExists(file))Run_ExceptioonFile("File not found.",file);
+  ullong size=0;
+  {
+    ifstream pf;
+    pf.open(file.c_str(),ios::binary|ios::ate);
+    if(!pf)Run_ExceptioonFile("File could not be opened.",file);
+    size=ullong(pf.tellg());
+    pf.close();
+  }
+  if(size<sizeof(StChkHead))Run_ExceptioonFile("File is invalid.",file);
+ #ifndef _WIN32
+  {
+    const int fd=open(file.c_str(),O_RDONLY);
+    if(fd<0)Run_ExceptioonFile("File could not be opened.",file);
+    void *ptr=mmap(NULL,size_t(size),PROT_READ,MAP_PRIVATE,fd,0);
+    close(fd);
+    if(ptr!=MAP_FAILED){
+      madvise(ptr,size_t(size),MADV_WILLNEED);
+      Data=(byte*)ptr; Mapped=true;
+    }
+  }
+ #endif
+  if(!Data){
+    ifstream pf;
+    pf.open(file.c_str(),ios::binary);
+    if(!pf)Run_ExceptioonFile("File could not be opened.",file);
+    try{
+      Data=new byte[size_t(size)];
+    }
+    catch(const std::bad_alloc){
+      Run_ExceptioonFile(fun::PrintStr("Could not allocate the requested memory (%llu bytes).",size),file);
+    }
+    pf.read((char*)Data,std::streamsize(size));
+    const bool ok=!pf.fail();
+    pf.close();
+    if(!ok)Run_ExceptioonFile("File reading failed.",file);
+  }
+  DataSize=size;
+  FileName=file;
+  //-Checks header and loads table of items.
+  StChkHead head;
+  memcpy(&head,Data,sizeof(StChkHead));
+  if(strncmp(head.magic,"DSCHKPT1",8))Run_ExceptioonFile("File is not a valid checkpoint.",file);
+  if(head.version<1 || head.version>VERSION)Run_ExceptioonFile(fun::PrintStr("Version %u of checkpoint is not supported.",head.version),file);
+  if(head.filesize!=size)Run_ExceptioonFile("File size is invalid (the file is incomplete).",file);
+  const unsigned sizeentry=NAMESIZE+sizeof(unsigned)*2+sizeof(ullong)*2;
+  if(head.tableoffset+ullong(sizeentry)*head.nitems!=size)Run_ExceptioonFile("File is invalid.",file);
+  for(unsigned c=0;c<head.nitems;c++){
+    const byte *ptr=Data+head.tableoffset+ullong(sizeentry)*c;
+    char name[NAMESIZE+1];
+    memcpy(name,ptr,NAMESIZE); name[NAMESIZE]='\0';  ptr+=NAMESIZE;
+    StItem item;
+    item.name=name;
+    item.ptr=NULL;
+    memcpy(&item.esize,ptr,sizeof(unsigned));  ptr+=sizeof(unsigned);
+    memcpy(&item.flags,ptr,sizeof(unsigned));  ptr+=sizeof(unsigned);
+    memcpy(&item.count,ptr,sizeof(ullong));     ptr+=sizeof(ullong);
+    memcpy(&item.offset,ptr,sizeof(ullong));
+    item.size=ItemSize(item);
+    Items.push_back(item);
+  }
+  //-Computes size of delta items from their list of blocks.
+  for(unsigned c=0;c<head.nitems;c++){
+    StItem &item=Items[c];
+    if(item.flags&ITEM_DELTA){
+      const StItem &bitem=GetItem(item.name+"@blocks",sizeof(unsigned));
+      if(bitem.offset+bitem.size>head.tableoffset)Run_ExceptioonFile(string("The data of item \'")+bitem.name+"\' is invalid.",file);
+      std::vector<unsigned> blocks(size_t(bitem.count));
+      if(bitem.count)memcpy(&blocks[0],Data+bitem.offset,size_t(bitem.size));
+      const ullong nb=(ItemSize(item)+BLOCKSIZE-1)/BLOCKSIZE;
+      for(unsigned cb=0;cb<unsigned(blocks.size());cb++)if(blocks[cb]>=nb || (cb && blocks[cb]<=blocks[cb-1]))
+        Run_ExceptioonFile(string("The list of blocks of item \'")+item.name+"\' is invalid.",file);
+      item.size=DeltaSize(item,blocks);
+    }
+  }
+  for(unsigned c=0;c<head.nitems;c++)if(Items[c].offset+Items[c].size>head.tableoffset)
+    Run_ExceptioonFile(string("The data of item \'")+Items[c].name+"\' is invalid.",file);
+  //-Loads previous checkpoints of the chain.
+  if(ExistsItem("chain.Id")){
+    ChainIndex=GetValue<unsigned>("chain.Index");
+    ChainId=GetValue<ullong>("chain.Id");
+  }
+  if(ExistsItem("chain.Prev")){
+    const string prevname=GetStr("chain.Prev");
+    const string prevfile=file.substr(0,file.size()-fun::GetFile(file).size())+prevname;
+    if(prevname.empty() || prevname==fun::GetFile(file))Run_ExceptioonFile("The previous checkpoint of the chain is invalid.",file);
+    Prev=new JDsCheckpoint();
+    Prev->LoadFile(prevfile);
+    if(Prev->GetChainId()!=GetValue<ullong>("chain.PrevId"))
+      Run_ExceptioonFile("The previous checkpoint of the chain does not match (it was overwritten or belongs to another chain).",prevfile);
+  }
+}
+
+//==============================================================================
+/// Loads checkpoint file (and its chain) and saves all its data in a full
+/// checkpoint file which does not depend on other files.
+//==============================================================================
+void JDsCheckpoint::RebuildFile(const std::string &file,const std::string &fileout){
+  JDsCheckpoint chk;
+  chk.LoadFile(file);
+  JDsCheckpoint out;
+  for(unsigned c=0;c<unsigned(chk.Items.size());c++){
+    const StItem &item=chk.Items[c];
+    if(item.name.find('@')!=string::npos || item.name.substr(0,6)=="chain.")continue;
+    StItem oitem=MakeItem(item.name,item.esize,0,NULL);
+    oitem.count=item.count;
+    oitem.size=ItemSize(oitem);
+    oitem.value.resize(size_t(oitem.size));
+    if(oitem.size)chk.CopyData(item,&oitem.value[0]);
+    out.Items.push_back(oitem);
+  }
+  out.SaveFile(fileout,chk.GetChainIndex());
+}
+
+
+//##############################################################################
+//# JDsCheckpointChain
+//##############################################################################
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JDsCheckpointChain::JDsCheckpointChain(const std::string &fileprefix,unsigned numdelta,unsigned firstindex)
+  :FilePrefix(fileprefix),NumDelta(numdelta),FirstIndex(firstindex)
+{
+  ClassName="JDsCheckpointChain";
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JDsCheckpointChain::~JDsCheckpointChain(){
+  DestructorActive=true;
+  Reset();
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JDsCheckpointChain::Reset(){
+  Count=FirstIndex;
+  LastId=0;
+  Files.clear();
+  Hashes.clear();
+  SizeFull=SizeSaved=0;
+}
+
+//==============================================================================
+/// Saves new checkpoint of the chain and returns the name of the file. A full
+/// checkpoint starts a new chain and removes the files of the previous one.
+//==============================================================================
+std::string JDsCheckpointChain::Save(JDsCheckpoint &chk){
+  const bool full=(Files.empty() || unsigned(Files.size())>NumDelta);
+  const string file=(NumDelta? FilePrefix+fun::PrintStr("_%04u.dchk",Count): FilePrefix+".dchk");
+  if(full){
+    SizeSaved=chk.SaveFile(file,Count,(NumDelta? &Hashes: NULL));
+    for(unsigned c=0;c<unsigned(Files.size());c++)if(Files[c]!=file)remove(Files[c].c_str());
+    Files.clear();
+  }
+  else SizeSaved=chk.SaveFileDelta(file,Count,Files.back(),LastId,Hashes);
+  SizeFull=chk.GetDataSize();
+  LastId=chk.GetChainId();
+  Files.push_back(file);
+  Count++;
+  return(file);
+}
+
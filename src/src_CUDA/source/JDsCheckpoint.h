@@ -0,0 +1,198 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Fichero de checkpoint con el estado exacto de ejecucion (arrays en orden
+//:#   de celdas y variables). Los datos se graban en bloques alineados y se
+//:#   leen mapeando el fichero en memoria (mmap) cuando es posible. (19-10-2026)
+//:# - Checkpoints incrementales: los arrays se dividen en bloques con hash y
+//:#   solo se graban los bloques modificados respecto al checkpoint anterior
+//:#   de la cadena (JDsCheckpointChain). La carga reconstruye los datos a partir
+//:#   de la cadena de ficheros y RebuildFile() genera un checkpoint completo.
+//:#   (19-10-2026)
+//:#############################################################################
+
+/// \file JDsCheckpoint.h \brief Declares the classes \ref JDsCheckpoint and \ref JDsCheckpointChain.
+
+#ifndef _JDsCheckpoint_
+#define _JDsCheckpoint_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstring>
+#include <climits>
+#include "JObject.h"
+#include "TypesDef.h"
+
+//##############################################################################
+//# JDsCheckpoint
+//##############################################################################
+/// \brief Saves and loads checkpoint files with the exact state of execution.
+///
+/// File format (little-endian, native types):
+/// - Header [64 bytes]: magic "DSCHKPT1", version, number of items, offset of
+///   table of items and total file size.
+/// - Data of items aligned to ALIGN bytes.
+/// - Table of items: name[NAMESIZE], element size, flags, count and offset.
+/// The file is written in a temporary file that is renamed at the end, so an
+/// interrupted execution never leaves an incomplete checkpoint.
+///
+/// Delta checkpoints (version 2) only store the blocks of BLOCKSIZE bytes that
+/// changed since the previous checkpoint of the chain. Items "chain.Prev" and
+/// "chain.PrevId" keep the name and identifier of the previous file, delta
+/// items are marked with ITEM_DELTA and item "<name>@blocks" stores the indices
+/// of their saved blocks. The loading of a delta checkpoint rebuilds the data
+/// from all the files of the chain.
+
+class JDsCheckpoint : protected JObject
+{
+public:
+  static const unsigned BLOCKSIZE=65536;  ///<Size of blocks for delta checkpoints (in bytes).
+
+  /// Block hashes of one item (used to compute delta checkpoints).
+  typedef struct{
+    unsigned esize;                 ///<Size of one element (in bytes).
+    ullong count;                   ///<Number of elements.
+    std::vector<ullong> hashes;     ///<Hash of each block.
+  }StHashes;
+  typedef std::map<std::string,StHashes> TpHashes;
+
+protected:
+  static const unsigned VERSION=2;
+  static const unsigned NAMESIZE=48;
+  static const unsigned ALIGN=64;
+  static const unsigned ITEM_DELTA=1;  ///<Flag of item with changed blocks only.
+
+  /// Structure with the information of one item.
+  typedef struct{
+    std::string name;     ///<Name of item.
+    unsigned esize;       ///<Size of one element (in bytes).
+    unsigned flags;       ///<Flags of item (ITEM_DELTA).
+    ullong count;         ///<Number of elements.
+    const void *ptr;      ///<Pointer to data for saving (NULL when data is stored in value).
+    std::string value;    ///<Copy of small data (values).
+    std::vector<unsigned> blocks; ///<Blocks to save of delta item.
+    ullong offset;        ///<Offset of data in file.
+    ullong size;          ///<Size of data in file.
+  }StItem;
+
+  std::vector<StItem> Items;
+
+  //-Variables for loading.
+  std::string FileName;   ///<Name of loaded file.
+  byte *Data;             ///<Data of loaded file (mapped or allocated).
+  ullong DataSize;        ///<Size of loaded file.
+  bool Mapped;            ///<Data is mapped in memory.
+  JDsCheckpoint *Prev;    ///<Previous checkpoint of the chain (for delta files).
+
+  //-Variables of the chain (saved in items "chain.Index" and "chain.Id").
+  unsigned ChainIndex;    ///<Index of checkpoint in the execution.
+  ullong ChainId;         ///<Unique identifier of checkpoint file.
+
+  void AddItem(const std::string &name,unsigned esize,ullong count,const void *ptr,bool copy);
+  unsigned FindItem(const std::string &name)const;
+  const StItem& GetItem(const std::string &name,unsigned esize)const;
+  static const byte* ItemPtr(const StItem &item){ return((const byte*)(item.ptr? item.ptr: item.value.c_str())); }
+  static ullong ItemSize(const StItem &item){ return(ullong(item.esize)*item.count); }
+  static ullong DeltaSize(const StItem &item,const std::vector<unsigned> &blocks);
+  static void ComputeHashes(const StItem &item,StHashes &hs);
+  void CopyData(const StItem &item,void *dst)const;
+  static StItem MakeItem(const std::string &name,unsigned esize,ullong count,const void *ptr);
+  void NewChainItems(unsigned chainidx,std::vector<StItem> &items);
+  void SaveItems(const std::string &file,const std::vector<StItem> &items)const;
+
+public:
+  JDsCheckpoint();
+  ~JDsCheckpoint();
+  void Reset();
+  void CloseFile();
+
+  //-Saving.
+  template<class T> void AddValue(const std::string &name,const T &v){ AddItem(name,sizeof(T),1,&v,true); }
+  template<class T> void AddArray(const std::string &name,ullong count,const T *ptr,bool copy=false){ AddItem(name,sizeof(T),count,ptr,copy); }
+  void AddStr(const std::string &name,const std::string &v){ AddItem(name,1,v.size(),v.c_str(),true); }
+  ullong GetDataSize()const;
+  ullong SaveFile(const std::string &file,unsigned chainidx=0,TpHashes *hashes=NULL);
+  ullong SaveFileDelta(const std::string &file,unsigned chainidx,const std::string &prevfile,ullong previd,TpHashes &hashes);
+  unsigned GetChainIndex()const{ return(ChainIndex); }
+  ullong GetChainId()const{ return(ChainId); }
+
+  //-Loading.
+  void LoadFile(const std::string &file);
+  std::string GetFileName()const{ return(FileName); }
+  bool ExistsItem(const std::string &name)const{ return(FindItem(name)!=UINT_MAX); }
+  ullong GetCount(const std::string &name)const{ return(GetItem(name,0).count); }
+  template<class T> T GetValue(const std::string &name)const{
+    T v; const StItem &item=GetItem(name,sizeof(T));
+    if(item.count!=1)Run_ExceptioonFile(std::string("The item \'")+name+"\' is not a single value.",FileName);
+    CopyData(item,&v); return(v);
+  }
+  template<class T> void GetArray(const std::string &name,ullong count,T *ptr)const{
+    const StItem &item=GetItem(name,sizeof(T));
+    if(item.count!=count)Run_ExceptioonFile(std::string("The number of elements of item \'")+name+"\' is invalid.",FileName);
+    CopyData(item,ptr);
+  }
+  std::string GetStr(const std::string &name)const;
+  unsigned GetChainSize()const{ return(Prev? Prev->GetChainSize()+1: 1); }
+
+  static void RebuildFile(const std::string &file,const std::string &fileout);
+};
+
+//##############################################################################
+//# JDsCheckpointChain
+//##############################################################################
+/// \brief Manages the chain of full and delta checkpoint files of one execution.
+///
+/// The first checkpoint of each chain is a full checkpoint and the following
+/// NumDelta checkpoints only store the blocks that changed since the previous
+/// one. The files of the previous chain are removed when a new full checkpoint
+/// is written. With NumDelta=0 only full checkpoints are written in one file.
+
+class JDsCheckpointChain : protected JObject
+{
+protected:
+  const std::string FilePrefix;   ///<Path and prefix of checkpoint files.
+  const unsigned NumDelta;        ///<Number of delta checkpoints after each full checkpoint.
+  const unsigned FirstIndex;      ///<Index of first checkpoint (to continue the numbering after a restart).
+  unsigned Count;                 ///<Index of next checkpoint.
+  ullong LastId;                  ///<Identifier of last saved file.
+  std::vector<std::string> Files; ///<Files of current chain (the first one is the full checkpoint).
+  JDsCheckpoint::TpHashes Hashes; ///<Block hashes of the data of last checkpoint.
+  ullong SizeFull;                ///<Size of data of last checkpoint.
+  ullong SizeSaved;               ///<Size of data saved in last checkpoint.
+
+public:
+  JDsCheckpointChain(const std::string &fileprefix,unsigned numdelta,unsigned firstindex=0);
+  ~JDsCheckpointChain();
+  void Reset();
+  std::string Save(JDsCheckpoint &chk);
+
+  unsigned GetNumDelta()const{ return(NumDelta); }
+  unsigned GetNextIndex()const{ return(Count); }
+  std::string GetLastFile()const{ return(Files.empty()? std::string(): Files.back()); }
+  ullong GetSizeFull()const{ return(SizeFull); }
+  ullong GetSizeSaved()const{ return(SizeSaved); }
+  static std::string GetFilesPattern(const std::string &fileprefix,unsigned numdelta){ return(fileprefix+(numdelta? "_????.dchk": ".dchk")); }
+};
+
+#endif
+
+
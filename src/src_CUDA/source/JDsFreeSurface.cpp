@@ -0,0 +1,519 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JDsFreeSurface.cpp \brief Implements the classes \ref JDsFreeSurfaceItem and \ref JDsFreeSurface.
+
+#include "JDsFreeSurface.h"
+#include "JDsGaugeBatch.h"
+#include "JLog2.h"
+#include "JXml.h"
+#include "Functions.h"
+#include "FunctionsGeo3d.h"
+#include "JDataArrays.h"
+#include "JOutputVtu.h"
+#include "OmpDefs.h"
+#include <cfloat>
+#include <climits>
+#include <algorithm>
+
+using namespace std;
+
+///Tetrahedra of one cube of nodes (node i of cube is at offset (i&1,(i>>1)&1,(i>>2)&1)).
+static const byte FSURF_TETRAS[6][4]={{0,1,3,7},{0,1,5,7},{0,2,3,7},{0,2,6,7},{0,4,5,7},{0,4,6,7}};
+
+//##############################################################################
+//# JDsFreeSurfaceItem
+//##############################################################################
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JDsFreeSurfaceItem::JDsFreeSurfaceItem(unsigned idx,const std::string &name)
+  :Idx(idx),Name(name)
+{
+  ClassName="JDsFreeSurfaceItem";
+  Batch=NULL;
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JDsFreeSurfaceItem::~JDsFreeSurfaceItem(){
+  DestructorActive=true;
+  Reset();
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JDsFreeSurfaceItem::Reset(){
+  UseBox=false;
+  Point1=Point2=TDouble3(0);
+  Dp=0;
+  IsoLevel=0;
+  SaveDt=0;
+  SaveNext=DBL_MAX;
+  Simulate2D=false;
+  Nodes=TUint3(0);
+  NodeDp=TDouble3(0);
+  delete Batch; Batch=NULL;
+  CellNear.clear();
+  NodeBatch.clear();
+  Field.clear();
+  NodeVel.clear();
+  SlabEdges.clear();
+  NumSaves=0;
+  LastNodes=LastVerts=LastCells=0;
+}
+
+//==============================================================================
+/// Reads configuration from the XML element of the surface.
+//==============================================================================
+void JDsFreeSurfaceItem::ReadXml(const JXml *sxml,TiXmlElement* ele,double dp){
+  sxml->CheckElementNames(ele,true,"point1 point2 dp isolevel savedt");
+  UseBox=(sxml->GetFirstElement(ele,"point1",true)!=NULL);
+  if(UseBox!=(sxml->GetFirstElement(ele,"point2",true)!=NULL))Run_ExceptioonFile(fun::PrintStr("Both limits (point1 and point2) of surface \'%s\' must be defined.",Name.c_str()),sxml->ErrGetFileRow(ele));
+  if(UseBox){
+    Point1=sxml->ReadElementDouble3(ele,"point1");
+    Point2=sxml->ReadElementDouble3(ele,"point2");
+    if(Point1.x>Point2.x || Point1.y>Point2.y || Point1.z>Point2.z)Run_ExceptioonFile(fun::PrintStr("The limits of surface \'%s\' are invalid.",Name.c_str()),sxml->ErrGetFileRow(ele));
+  }
+  switch(sxml->CheckElementAttributes(ele,"dp","value coefdp",true,false)){
+    case 0:  Dp=dp;                                               break;
+    case 1:  Dp=sxml->ReadElementDouble(ele,"dp","value");        break;
+    case 2:  Dp=dp*sxml->ReadElementDouble(ele,"dp","coefdp");    break;
+  }
+  if(Dp<=0)Run_ExceptioonFile(fun::PrintStr("The dp (%g) of surface \'%s\' is invalid.",Dp,Name.c_str()),sxml->ErrGetFileRow(ele));
+  IsoLevel=float(sxml->ReadElementDouble(ele,"isolevel","value",true,0.5));
+  if(IsoLevel<=0)Run_ExceptioonFile(fun::PrintStr("The isolevel (%g) of surface \'%s\' is invalid.",IsoLevel,Name.c_str()),sxml->ErrGetFileRow(ele));
+  SaveDt=sxml->ReadElementDouble(ele,"savedt","value",true,0);
+  if(SaveDt<0)Run_ExceptioonFile(fun::PrintStr("The savedt of surface \'%s\' is invalid.",Name.c_str()),sxml->ErrGetFileRow(ele));
+  SaveNext=(SaveDt>0? SaveDt: DBL_MAX);
+}
+
+//==============================================================================
+/// Computes the nodes of the grid within the domain and allocates memory.
+//==============================================================================
+void JDsFreeSurfaceItem::ConfigNodes(const tdouble3 &domposmin,const tdouble3 &domposmax
+  ,bool simulate2d,double simulate2dposy)
+{
+  Simulate2D=simulate2d;
+  if(!UseBox){
+    Point1=domposmin;
+    Point2=domposmax;
+  }
+  else{
+    Point1=MaxValues(Point1,domposmin);
+    Point2=MinValues(Point2,domposmax);
+    if(Point1.x>Point2.x || Point1.y>Point2.y || Point1.z>Point2.z)Run_Exceptioon(fun::PrintStr("The box of surface \'%s\' is out of the domain.",Name.c_str()));
+  }
+  if(Simulate2D)Point1.y=Point2.y=simulate2dposy;
+  //-Computes number of nodes and distance in each direction.
+  const tdouble3 dis=Point2-Point1;
+  unsigned nc[3];
+  double dpc[3];
+  for(unsigned c=0;c<3;c++){
+    const double ds=(!c? dis.x: (c==1? dis.y: dis.z));
+    unsigned count=unsigned(ds/Dp);
+    if(ds-(Dp*count)>=Dp*0.1)count++;
+    count++;
+    nc[c]=count;
+    dpc[c]=(count>1? ds/(count-1): 0);
+  }
+  Nodes=TUint3(nc[0],nc[1],nc[2]);
+  NodeDp=TDouble3(dpc[0],dpc[1],dpc[2]);
+  const ullong np=ullong(Nodes.x)*Nodes.y*Nodes.z;
+  if(np>=UINT_MAX)Run_Exceptioon(fun::PrintStr("The number of nodes of surface \'%s\' is too large.",Name.c_str()));
+  if(Nodes.x<2 || Nodes.z<2 || (!Simulate2D && Nodes.y<2))Run_Exceptioon(fun::PrintStr("The box of surface \'%s\' is too small for the distance between nodes.",Name.c_str()));
+  Batch=new JGaugeBatch();
+  NodeBatch.resize(size_t(np));
+  Field.resize(size_t(np));
+  NodeVel.resize(size_t(np));
+  SlabEdges.resize(Nodes.z-1);
+}
+
+//==============================================================================
+/// Loads lines with configuration information.
+//==============================================================================
+void JDsFreeSurfaceItem::GetConfig(std::vector<std::string> &lines)const{
+  lines.push_back(fun::PrintStr("Box........: %s%s",fun::Double3gRangeStr(Point1,Point2).c_str(),(UseBox? "": "  (domain limits)")));
+  lines.push_back(fun::PrintStr("Nodes......: %u x %u x %u = %u  (dp:%g)",Nodes.x,Nodes.y,Nodes.z,GetNp(),Dp));
+  lines.push_back(fun::PrintStr("IsoLevel...: %g",IsoLevel));
+  if(SaveDt>0)lines.push_back(fun::PrintStr("SaveDt.....: %g",SaveDt));
+  else lines.push_back("SaveDt.....: with PART files");
+  lines.push_back(fun::PrintStr("Memory.....: %.2f MB",double((sizeof(unsigned)+sizeof(float)+sizeof(tfloat3))*NodeBatch.size())/(1024*1024)));
+}
+
+//==============================================================================
+/// Returns position of node n.
+//==============================================================================
+tdouble3 JDsFreeSurfaceItem::NodePos(ullong n)const{
+  const ullong nxy=ullong(Nodes.x)*Nodes.y;
+  const unsigned cz=unsigned(n/nxy);
+  const unsigned cy=unsigned((n%nxy)/Nodes.x);
+  const unsigned cx=unsigned(n%Nodes.x);
+  return(TDouble3(Point1.x+NodeDp.x*cx,Point1.y+NodeDp.y*cy,Point1.z+NodeDp.z*cz));
+}
+
+//==============================================================================
+/// Computes colour function and velocity on the nodes close to fluid. Cells
+/// of the division with fluid in the neighbour cells are marked first and only
+/// the nodes in these cells are computed using JGaugeBatch.
+//==============================================================================
+void JDsFreeSurfaceItem::ComputeField(const StCteSph &csp,const StDivDataCpu &dvd
+  ,const tdouble3 *pos,const typecode *code,const tfloat4 *velrhop)
+{
+  //-Marks cells with fluid in the neighbour cells.
+  const tint4 nc=dvd.nc;
+  const int sd=dvd.scelldiv;
+  CellNear.resize(size_t(nc.w)*nc.z);
+  byte *cellnear=(CellNear.empty()? NULL: &CellNear[0]);
+  #ifdef OMP_USE
+    #pragma omp parallel for schedule (static)
+  #endif
+  for(int cz=0;cz<nc.z;cz++){
+    for(int cy=0;cy<nc.y;cy++)for(int cx=0;cx<nc.x;cx++){
+      const int cxini=max(cx-sd,0),cxfin=min(cx+sd+1,nc.x);
+      const int yini=max(cy-sd,0),yfin=min(cy+sd+1,nc.y);
+      const int zini=max(cz-sd,0),zfin=min(cz+sd+1,nc.z);
+      bool near=false;
+      for(int z=zini;z<zfin && !near;z++)for(int y=yini;y<yfin && !near;y++){
+        const int v=nc.w*z+nc.x*y+int(dvd.cellfluid);
+        near=(dvd.begincell[v+cxini]<dvd.begincell[v+cxfin]);
+      }
+      cellnear[nc.w*cz+nc.x*cy+cx]=byte(near? 1: 0);
+    }
+  }
+  //-Marks nodes in cells close to fluid.
+  const int np=int(GetNp());
+  unsigned *nodebatch=&NodeBatch[0];
+  #ifdef OMP_USE
+    #pragma omp parallel for schedule (static) if(np>OMP_LIMIT_COMPUTELIGHT)
+  #endif
+  for(int p=0;p<np;p++){
+    const tdouble3 ps=NodePos(p);
+    const int cx=int((ps.x-dvd.domposmin.x)/dvd.scell)-dvd.cellzero.x;
+    const int cy=int((ps.y-dvd.domposmin.y)/dvd.scell)-dvd.cellzero.y;
+    const int cz=int((ps.z-dvd.domposmin.z)/dvd.scell)-dvd.cellzero.z;
+    const bool ok=(cx>=0 && cy>=0 && cz>=0 && cx<nc.x && cy<nc.y && cz<nc.z && cellnear[nc.w*cz+nc.x*cy+cx]);
+    nodebatch[p]=(ok? 0: UINT_MAX);
+  }
+  //-Computes kernel sums on marked nodes.
+  Batch->ClearPoints();
+  for(int p=0;p<np;p++)if(nodebatch[p]!=UINT_MAX)nodebatch[p]=Batch->AddPoint(NodePos(p));
+  LastNodes=Batch->GetCount();
+  Batch->Calcule(csp,dvd,pos,code,velrhop);
+  //-Stores colour function and velocity of nodes.
+  const JGaugeBatch *batch=Batch;
+  float *field=&Field[0];
+  tfloat3 *nodevel=&NodeVel[0];
+  #ifdef OMP_USE
+    #pragma omp parallel for schedule (static) if(np>OMP_LIMIT_COMPUTELIGHT)
+  #endif
+  for(int p=0;p<np;p++){
+    const unsigned cb=nodebatch[p];
+    field[p]=0;
+    nodevel[p]=TFloat3(0);
+    if(cb!=UINT_MAX){
+      const JGaugeBatch::StSums &s=batch->GetSums(cb);
+      if(s.sumwab>0){
+        field[p]=float(s.sumwab);
+        nodevel[p]=ToTFloat3(s.sumvel/s.sumwab);
+      }
+    }
+  }
+}
+
+//==============================================================================
+/// Returns position of the surface on the edge between nodes a and b.
+//==============================================================================
+static tdouble3 FsurfEdgePos(const tdouble3 &pa,const tdouble3 &pb,float fa,float fb,float iso){
+  const double t=(fa!=fb? double(iso-fa)/double(fb-fa): 0.5);
+  return(pa+(pb-pa)*min(max(t,0.),1.));
+}
+
+//==============================================================================
+/// Generates triangles of the cubes of slice cz by marching tetrahedra (3D).
+/// Each triangle is stored as the three edges of its vertices, oriented with
+/// the normal pointing out of the fluid.
+//==============================================================================
+void JDsFreeSurfaceItem::MarchTetras(unsigned cz){
+  std::vector<ullong> &edges=SlabEdges[cz];
+  edges.clear();
+  const ullong nn=GetNp();
+  const unsigned nx=Nodes.x,nxy=Nodes.x*Nodes.y;
+  const float *field=&Field[0];
+  for(unsigned cy=0;cy+1<Nodes.y;cy++)for(unsigned cx=0;cx+1<Nodes.x;cx++){
+    const unsigned n0=cx+cy*nx+cz*nxy;
+    unsigned nv[8];
+    float fv[8];
+    unsigned nin=0;
+    for(unsigned c=0;c<8;c++){
+      nv[c]=n0+(c&1)+((c>>1)&1)*nx+((c>>2)&1)*nxy;
+      fv[c]=field[nv[c]];
+      if(fv[c]>=IsoLevel)nin++;
+    }
+    if(!nin || nin==8)continue;
+    for(unsigned ct=0;ct<6;ct++){
+      unsigned vin[4],vout[4],ni=0,no=0;
+      for(unsigned c=0;c<4;c++){
+        const unsigned v=FSURF_TETRAS[ct][c];
+        if(fv[v]>=IsoLevel)vin[ni++]=v; else vout[no++]=v;
+      }
+      if(!ni || !no)continue;
+      //-Edges (inside,outside) of vertices of one or two triangles.
+      unsigned ein[4],eout[4],ne;
+      if(ni==1){ ne=3; for(unsigned c=0;c<3;c++){ ein[c]=vin[0]; eout[c]=vout[c]; } }
+      else if(ni==3){ ne=3; for(unsigned c=0;c<3;c++){ ein[c]=vin[c]; eout[c]=vout[0]; } }
+      else{
+        ne=4;
+        ein[0]=vin[0]; eout[0]=vout[0];
+        ein[1]=vin[0]; eout[1]=vout[1];
+        ein[2]=vin[1]; eout[2]=vout[1];
+        ein[3]=vin[1]; eout[3]=vout[0];
+      }
+      tdouble3 ep[4];
+      ullong ek[4];
+      for(unsigned c=0;c<ne;c++){
+        const unsigned a=nv[ein[c]],b=nv[eout[c]];
+        ep[c]=FsurfEdgePos(NodePos(a),NodePos(b),fv[ein[c]],fv[eout[c]],IsoLevel);
+        ek[c]=(a<b? ullong(a)*nn+b: ullong(b)*nn+a);
+      }
+      const tdouble3 dout=NodePos(nv[eout[0]])-NodePos(nv[ein[0]]);
+      for(unsigned tr=0;tr+2<ne;tr++){
+        const unsigned i1=tr+1,i2=tr+2;
+        const tdouble3 nor=fgeo::ProductVec(ep[i1]-ep[0],ep[i2]-ep[0]);
+        const double dot=nor.x*dout.x+nor.y*dout.y+nor.z*dout.z;
+        if(dot==0)continue; //-Degenerated triangle.
+        edges.push_back(ek[0]);
+        edges.push_back(ek[dot>0? i1: i2]);
+        edges.push_back(ek[dot>0? i2: i1]);
+      }
+    }
+  }
+}
+
+//==============================================================================
+/// Generates lines of the squares of row cz by marching triangles (2D).
+/// Each line is stored as the two edges of its vertices.
+//==============================================================================
+void JDsFreeSurfaceItem::MarchTriangles(unsigned cz){
+  static const byte tris[2][3]={{0,1,3},{0,3,2}};
+  std::vector<ullong> &edges=SlabEdges[cz];
+  edges.clear();
+  const ullong nn=GetNp();
+  const unsigned nx=Nodes.x;
+  const float *field=&Field[0];
+  for(unsigned cx=0;cx+1<Nodes.x;cx++){
+    const unsigned n0=cx+cz*nx;
+    const unsigned nv[4]={n0,n0+1,n0+nx,n0+nx+1};
+    float fv[4];
+    unsigned nin=0;
+    for(unsigned c=0;c<4;c++){
+      fv[c]=field[nv[c]];
+      if(fv[c]>=IsoLevel)nin++;
+    }
+    if(!nin || nin==4)continue;
+    for(unsigned ct=0;ct<2;ct++){
+      unsigned vin[3],vout[3],ni=0,no=0;
+      for(unsigned c=0;c<3;c++){
+        const unsigned v=tris[ct][c];
+        if(fv[v]>=IsoLevel)vin[ni++]=v; else vout[no++]=v;
+      }
+      if(!ni || !no)continue;
+      for(unsigned c=0;c<2;c++){
+        const unsigned a=nv[ni==1? vin[0]: vin[c]];
+        const unsigned b=nv[ni==1? vout[c]: vout[0]];
+        edges.push_back(a<b? ullong(a)*nn+b: ullong(b)*nn+a);
+      }
+    }
+  }
+}
+
+//==============================================================================
+/// Extracts the free surface and saves it in VTU file (on CPU).
+//==============================================================================
+void JDsFreeSurfaceItem::SaveCpu(double timestep,const StCteSph &csp,const StDivDataCpu &dvd
+  ,const tdouble3 *pos,const typecode *code,const tfloat4 *velrhop
+  ,const std::string &dirout,bool compress,JLog2 *log)
+{
+  ComputeField(csp,dvd,pos,code,velrhop);
+  //-Generates cells of each slice in parallel.
+  const int nslab=int(SlabEdges.size());
+  #ifdef OMP_USE
+    #pragma omp parallel for schedule (dynamic)
+  #endif
+  for(int cz=0;cz<nslab;cz++){
+    if(Simulate2D)MarchTriangles(unsigned(cz));
+    else MarchTetras(unsigned(cz));
+  }
+  //-Joins edges of all slices and obtains the list of vertices (shared edges).
+  size_t nedges=0;
+  for(int cz=0;cz<nslab;cz++)nedges+=SlabEdges[cz].size();
+  std::vector<ullong> keys;
+  keys.reserve(nedges);
+  for(int cz=0;cz<nslab;cz++)keys.insert(keys.end(),SlabEdges[cz].begin(),SlabEdges[cz].end());
+  std::vector<ullong> verts(keys);
+  sort(verts.begin(),verts.end());
+  verts.erase(unique(verts.begin(),verts.end()),verts.end());
+  const unsigned cellnv=(Simulate2D? 2: 3);
+  const int nk=int(nedges);
+  const int nv=int(verts.size());
+  LastVerts=unsigned(nv);
+  LastCells=unsigned(nedges/cellnv);
+  //-Computes connectivity, position and velocity of vertices.
+  unsigned *conn=new unsigned[nk];
+  tfloat3 *vpos=new tfloat3[nv];
+  tfloat3 *vvel=new tfloat3[nv];
+  const ullong nn=GetNp();
+  #ifdef OMP_USE
+    #pragma omp parallel for schedule (static) if(nk>OMP_LIMIT_COMPUTELIGHT)
+  #endif
+  for(int c=0;c<nk;c++)conn[c]=unsigned(lower_bound(verts.begin(),verts.end(),keys[c])-verts.begin());
+  #ifdef OMP_USE
+    #pragma omp parallel for schedule (static) if(nv>OMP_LIMIT_COMPUTELIGHT)
+  #endif
+  for(int c=0;c<nv;c++){
+    const unsigned a=unsigned(verts[c]/nn),b=unsigned(verts[c]%nn);
+    const float fa=Field[a],fb=Field[b];
+    const float t=(fa!=fb? min(max((IsoLevel-fa)/(fb-fa),0.f),1.f): 0.5f);
+    vpos[c]=ToTFloat3(FsurfEdgePos(NodePos(a),NodePos(b),fa,fb,IsoLevel));
+    vvel[c]=NodeVel[a]+(NodeVel[b]-NodeVel[a])*t;
+  }
+  //-Saves VTU file.
+  JDataArrays arrays;
+  arrays.AddArray("Pos",unsigned(nv),vpos,true);
+  arrays.AddArray("Vel",unsigned(nv),vvel,true);
+  const string file=dirout+"FreeSurface_"+Name+".vtu";
+  if(!NumSaves)log->AddFileInfo(fun::FileNameSec(file,UINT_MAX),fun::PrintStr("Saves mesh of free surface (by %s).",ClassName.c_str()));
+  JOutputVtu ovtu(compress);
+  ovtu.SaveVtuCells(fun::FileNameSec(file,NumSaves),arrays,"Pos",cellnv,LastCells,conn);
+  delete[] conn;
+  NumSaves++;
+  //-Updates SaveNext.
+  if(SaveDt>0){
+    const unsigned nt=unsigned(timestep/SaveDt);
+    SaveNext=SaveDt*nt;
+    if(SaveNext<=timestep)SaveNext=SaveDt*(nt+1);
+  }
+}
+
+
+//##############################################################################
+//# JDsFreeSurface
+//##############################################################################
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JDsFreeSurface::JDsFreeSurface(JLog2 *log):Log(log){
+  ClassName="JDsFreeSurface";
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JDsFreeSurface::~JDsFreeSurface(){
+  DestructorActive=true;
+  Reset();
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JDsFreeSurface::Reset(){
+  CSP=CteSphNull();
+  DomPosMin=DomPosMax=TDouble3(0);
+  DirOut="";
+  Compress=false;
+  for(unsigned c=0;c<GetCount();c++)delete List[c];
+  List.clear();
+}
+
+//==============================================================================
+/// Configures object.
+//==============================================================================
+void JDsFreeSurface::Config(const StCteSph &csp,tdouble3 domposmin,tdouble3 domposmax
+  ,const std::string &dirout,bool compress)
+{
+  CSP=csp;
+  DomPosMin=domposmin;
+  DomPosMax=domposmax;
+  DirOut=dirout;
+  Compress=compress;
+  //-Wendland kernel is used when Cubic is selected.
+  if(CSP.tkernel==KERNEL_Cubic && (!CSP.kwend.awen || !CSP.kwend.bwen))Run_Exceptioon("Constants of kernel Wendland are not defined.");
+}
+
+//==============================================================================
+/// Loads configuration from XML object.
+//==============================================================================
+void JDsFreeSurface::LoadXml(const JXml *sxml,const std::string &place){
+  for(unsigned c=0;c<GetCount();c++)delete List[c];
+  List.clear();
+  TiXmlNode* node=sxml->GetNodeSimple(place,false);
+  if(!node)Run_Exceptioon(std::string("Cannot find the element \'")+place+"\'.");
+  if(sxml->CheckNodeActive(node))ReadXml(sxml,node->ToElement());
+}
+
+//==============================================================================
+/// Reads list of surfaces in the XML node.
+//==============================================================================
+void JDsFreeSurface::ReadXml(const JXml *sxml,TiXmlElement* lis){
+  sxml->CheckElementNames(lis,true,"*surface");
+  TiXmlElement* ele=lis->FirstChildElement("surface");
+  while(ele){
+    if(sxml->CheckElementActive(ele)){
+      const string name=sxml->GetAttributeStr(ele,"name");
+      if(name.empty() || int(name.find_first_of("/\\:*?\"<>| "))>=0)Run_ExceptioonFile(fun::PrintStr("The surface name \'%s\' is invalid.",name.c_str()),sxml->ErrGetFileRow(ele));
+      for(unsigned c=0;c<GetCount();c++)if(List[c]->Name==name)Run_ExceptioonFile(fun::PrintStr("The surface name \'%s\' already exists.",name.c_str()),sxml->ErrGetFileRow(ele));
+      JDsFreeSurfaceItem* sf=new JDsFreeSurfaceItem(GetCount(),name);
+      List.push_back(sf);
+      sf->ReadXml(sxml,ele,CSP.dp);
+      sf->ConfigNodes(DomPosMin,DomPosMax,CSP.simulate2d,CSP.simulate2dposy);
+    }
+    ele=ele->NextSiblingElement("surface");
+  }
+}
+
+//==============================================================================
+/// Shows object configuration using Log.
+//==============================================================================
+void JDsFreeSurface::VisuConfig(std::string txhead,std::string txfoot)const{
+  if(!txhead.empty())Log->Print(txhead);
+  for(unsigned c=0;c<GetCount();c++){
+    std::vector<std::string> lines;
+    List[c]->GetConfig(lines);
+    Log->Printf("Surface_%u: \'%s\'",List[c]->Idx,List[c]->Name.c_str());
+    for(unsigned i=0;i<unsigned(lines.size());i++)Log->Print(string("  ")+lines[i]);
+  }
+  if(!txfoot.empty())Log->Print(txfoot);
+}
+
+//==============================================================================
+/// Extracts and saves the free surfaces when it is necessary (on CPU).
+//==============================================================================
+void JDsFreeSurface::SaveCpu(double timestep,bool svpart,const StDivDataCpu &dvd
+  ,const tdouble3 *pos,const typecode *code,const tfloat4 *velrhop)
+{
+  for(unsigned c=0;c<GetCount();c++){
+    JDsFreeSurfaceItem* sf=List[c];
+    if(sf->CheckSave(timestep,svpart))sf->SaveCpu(timestep,CSP,dvd,pos,code,velrhop,DirOut,Compress,Log);
+  }
+}
+
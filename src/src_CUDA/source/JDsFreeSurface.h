@@ -0,0 +1,162 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Extraccion de la superficie libre durante la simulacion. Se calcula la
+//:#   funcion de color en los nodos de una rejilla cercanos a celdas con fluido
+//:#   y se genera una malla de triangulos (lineas en 2D) que se graba en
+//:#   ficheros VTU binarios. (19-10-2026)
+//:#############################################################################
+
+/// \file JDsFreeSurface.h \brief Declares the classes \ref JDsFreeSurfaceItem and \ref JDsFreeSurface.
+
+#ifndef _JDsFreeSurface_
+#define _JDsFreeSurface_
+
+#include <string>
+#include <vector>
+#include "JObject.h"
+#include "DualSphDef.h"
+#include "JCellDivDataCpu.h"
+
+class JXml;
+class TiXmlElement;
+class JLog2;
+class JGaugeBatch;
+
+//##############################################################################
+//# XML format in _FmtXML_FreeSurface.xml.
+//##############################################################################
+//  <freesurface>
+//    <surface name="Free">
+//      <point1 x="0" y="0" z="0" comment="Minimum position of extraction box (default=domain limits)" />
+//      <point2 x="1.6" y="0" z="0.6" comment="Maximum position of extraction box (default=domain limits)" />
+//      <dp coefdp="1" comment="Distance between nodes (value or coefdp*Dp) (default coefdp=1)" />
+//      <isolevel value="0.5" comment="Value of colour function on the surface (default=0.5)" />
+//      <savedt value="0.1" comment="Time between saving of surfaces. 0:with PART files (default=0)" />
+//    </surface>
+//  </freesurface>
+
+//##############################################################################
+//# JDsFreeSurfaceItem
+//##############################################################################
+/// \brief Extracts the free surface of the fluid in one box.
+///
+/// The colour function (Shepard sum of kernel of fluid particles) is computed
+/// with JGaugeBatch only on the nodes whose cell of the division has fluid in
+/// the neighbour cells, the other nodes are empty. The surface is obtained by
+/// marching tetrahedra (each cube of nodes is divided in six tetrahedra) in 3D
+/// and marching triangles in 2D, with slices of cubes processed in parallel.
+/// Vertices are shared between triangles using the edge of nodes as key.
+
+class JDsFreeSurfaceItem : protected JObject
+{
+public:
+  const unsigned Idx;       ///<Index of surface.
+  const std::string Name;   ///<Name of surface.
+
+protected:
+  //-Definition.
+  bool UseBox;              ///<The limits of extraction box are defined in XML.
+  tdouble3 Point1;          ///<Minimum position of box.
+  tdouble3 Point2;          ///<Maximum position of box.
+  double Dp;                ///<Requested distance between nodes.
+  float IsoLevel;           ///<Value of colour function on the surface.
+  double SaveDt;            ///<Time between saving of surfaces (0:with PART files).
+  double SaveNext;          ///<Next time of saving.
+  bool Simulate2D;          ///<2D simulation (nodes on plane Y=Simulate2DPosY).
+  tuint3 Nodes;             ///<Number of nodes in each direction.
+  tdouble3 NodeDp;          ///<Distance between nodes in each direction.
+
+  //-Working data.
+  JGaugeBatch *Batch;               ///<Computes colour function on the nodes.
+  std::vector<byte> CellNear;       ///<Cells of division with fluid in neighbour cells.
+  std::vector<unsigned> NodeBatch;  ///<Index of each node in Batch (UINT_MAX for empty nodes).
+  std::vector<float> Field;         ///<Colour function on nodes.
+  std::vector<tfloat3> NodeVel;     ///<Velocity on nodes.
+  std::vector< std::vector<ullong> > SlabEdges; ///<Edges of vertices of cells generated by each slice.
+
+  //-Results of last extraction.
+  unsigned NumSaves;        ///<Number of saved files.
+  unsigned LastNodes;       ///<Number of evaluated nodes.
+  unsigned LastVerts;       ///<Number of vertices.
+  unsigned LastCells;       ///<Number of triangles (lines in 2D).
+
+  tdouble3 NodePos(ullong n)const;
+  void ComputeField(const StCteSph &csp,const StDivDataCpu &dvd
+    ,const tdouble3 *pos,const typecode *code,const tfloat4 *velrhop);
+  void MarchTetras(unsigned cz);
+  void MarchTriangles(unsigned cz);
+
+public:
+  JDsFreeSurfaceItem(unsigned idx,const std::string &name);
+  ~JDsFreeSurfaceItem();
+  void Reset();
+
+  void ReadXml(const JXml *sxml,TiXmlElement* ele,double dp);
+  void ConfigNodes(const tdouble3 &domposmin,const tdouble3 &domposmax,bool simulate2d,double simulate2dposy);
+  void GetConfig(std::vector<std::string> &lines)const;
+
+  unsigned GetNp()const{ return(Nodes.x*Nodes.y*Nodes.z); }
+  unsigned GetNumSaves()const{ return(NumSaves); }
+  bool CheckSave(double timestep,bool svpart)const{ return(SaveDt>0? timestep>=SaveNext: svpart); }
+
+  void SaveCpu(double timestep,const StCteSph &csp,const StDivDataCpu &dvd
+    ,const tdouble3 *pos,const typecode *code,const tfloat4 *velrhop
+    ,const std::string &dirout,bool compress,JLog2 *log);
+};
+
+
+//##############################################################################
+//# JDsFreeSurface
+//##############################################################################
+/// \brief Manages the in-situ extraction of free surfaces (only on CPU).
+
+class JDsFreeSurface : protected JObject
+{
+protected:
+  JLog2 *Log;
+  StCteSph CSP;             ///<Structure with main SPH constants values and configurations.
+  tdouble3 DomPosMin;       ///<Lower limit of simulation domain.
+  tdouble3 DomPosMax;       ///<Upper limit of simulation domain.
+  std::string DirOut;       ///<Directory for output files.
+  bool Compress;            ///<Compresses binary data of VTU files using zlib.
+  std::vector<JDsFreeSurfaceItem*> List;
+
+  void ReadXml(const JXml *sxml,TiXmlElement* lis);
+
+public:
+  JDsFreeSurface(JLog2 *log);
+  ~JDsFreeSurface();
+  void Reset();
+
+  void Config(const StCteSph &csp,tdouble3 domposmin,tdouble3 domposmax,const std::string &dirout,bool compress);
+  void LoadXml(const JXml *sxml,const std::string &place);
+  void VisuConfig(std::string txhead,std::string txfoot)const;
+
+  unsigned GetCount()const{ return(unsigned(List.size())); }
+
+  void SaveCpu(double timestep,bool svpart,const StDivDataCpu &dvd,const tdouble3 *pos
+    ,const typecode *code,const tfloat4 *velrhop);
+};
+
+#endif
+
+
@@ -32,6 +32,7 @@
 #include "JDataArrays.h"
 #include "JVtkLib.h"
 #include "JSaveCsv2.h"
+#include "JSeriesSink.h"
 #include "JAppInfo.h"
 #include "JSphMk.h"
 
@@ -421,17 +422,15 @@ void JDsFtForcePoints::SaveVtkPoints(unsigned numfile)const{
 //==============================================================================
 void JDsFtForcePoints::SaveCsvPoints(unsigned numfile)const{
   if(PtCount)Log->AddFileInfo("FtForcesPoints_ft????_pt??.csv","Saves CSV file with force points (Moordyn coupling).");
+  JSeriesSink *series=AppInfo.SeriesPtr();
   for(word cp=0;cp<PtCount;cp++){
     const string file=AppInfo.GetDirOut()+fun::PrintStr("FtForcePoints_ft%04d_pt%02u.csv",PtFtid[cp],cp);
-    jcsv::JSaveCsv2 scsv(file,true,AppInfo.GetCsvSepComa());
-    //-Saves head.
-    scsv.SetHead();
-    scsv << "Part;Time [s];PosX [m];PosY [m];PosZ [m];ForceX [N];ForceY [N];ForceZ [N];VelX [m/s];VelY [m/s];VelZ [m/s]" << jcsv::Endl();
-    //-Saves data.
-    scsv.SetData();
-    scsv << jcsv::Fmt(jcsv::TpDouble1,"%g") << jcsv::Fmt(jcsv::TpFloat3,"%g;%g;%g") << jcsv::Fmt(jcsv::TpDouble3,"%g;%g;%g");
-    scsv << numfile << TimeStep << PtPos[cp] << PtForce[cp] << PtVel[cp] << jcsv::Endl();
-    scsv.SaveData(true);
+    //-Returns the same stream for the next calls.
+    const unsigned id=series->AddStream(file,"Part;Time [s];PosX [m];PosY [m];PosZ [m];ForceX [N];ForceY [N];ForceZ [N];VelX [m/s];VelY [m/s];VelZ [m/s]",true);
+    JSeriesRec &rec=series->Rec(id);
+    rec << jcsv::Fmt(jcsv::TpDouble1,"%g") << jcsv::Fmt(jcsv::TpFloat3,"%g;%g;%g") << jcsv::Fmt(jcsv::TpDouble3,"%g;%g;%g");
+    rec << numfile << TimeStep << PtPos[cp] << PtForce[cp] << PtVel[cp] << jcsv::Endl();
+    series->Flush(id);
   }
 }
 
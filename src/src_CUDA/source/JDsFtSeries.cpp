@@ -0,0 +1,149 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JDsFtSeries.cpp \brief Implements the class \ref JDsFtSeries.
+
+#include "JDsFtSeries.h"
+#include "JSeriesSink.h"
+#include "JLog2.h"
+#include "Functions.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+using namespace std;
+
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JDsFtSeries::JDsFtSeries(JLog2 *log):Log(log){
+  ClassName="JDsFtSeries";
+  Sink=NULL;
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JDsFtSeries::~JDsFtSeries(){
+  DestructorActive=true;
+  Reset();
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JDsFtSeries::Reset(){
+  delete Sink; Sink=NULL;
+  FileCsv="";
+  SaveDt=0;
+  Gravity=TFloat3(0);
+  FtCount=0;
+  FtMass.clear();
+  StreamId=UINT_MAX;
+  NextTime=0;
+  NumSteps=0;
+  ForcesFree.clear();
+  ForcesFreeOk=false;
+}
+
+//==============================================================================
+/// Configures object and creates the stream of results.
+//==============================================================================
+void JDsFtSeries::Config(const std::string &dirout,double savedt,bool csvsepcoma
+  ,const tfloat3 &gravity,unsigned ftcount,const StFloatingData *ftobjs)
+{
+  Reset();
+  SaveDt=savedt;
+  Gravity=gravity;
+  FtCount=ftcount;
+  for(unsigned cf=0;cf<FtCount;cf++)FtMass.push_back(ftobjs[cf].mass);
+  ForcesFree.resize(FtCount);
+  //-Defines head of records.
+  string head="nstep;time [s];dt [s]";
+  for(unsigned cf=0;cf<FtCount;cf++){
+    const string mk=fun::PrintStr("mk%u_",ftobjs[cf].mkbound);
+    head=head+";"+mk+"center.x [m];"             +mk+"center.y [m];"             +mk+"center.z [m]";
+    head=head+";"+mk+"fvel.x [m/s];"             +mk+"fvel.y [m/s];"             +mk+"fvel.z [m/s]";
+    head=head+";"+mk+"fomega.x [rad/s];"         +mk+"fomega.y [rad/s];"         +mk+"fomega.z [rad/s]";
+    head=head+";"+mk+"face.x [m/s^2];"           +mk+"face.y [m/s^2];"           +mk+"face.z [m/s^2]";
+    head=head+";"+mk+"fomegaace.x [rad/s^2];"    +mk+"fomegaace.y [rad/s^2];"    +mk+"fomegaace.z [rad/s^2]";
+    head=head+";"+mk+"force.x [N];"              +mk+"force.y [N];"              +mk+"force.z [N]";
+    head=head+";"+mk+"reaction.x [N];"           +mk+"reaction.y [N];"           +mk+"reaction.z [N]";
+    head=head+";"+mk+"reactionace.x [rad/s^2];"  +mk+"reactionace.y [rad/s^2];"  +mk+"reactionace.z [rad/s^2]";
+  }
+  //-Creates stream with a ring buffer for about 1024 records.
+  const unsigned recsize=sizeof(unsigned)+sizeof(double)*2+(sizeof(tdouble3)+sizeof(tfloat3)*7)*FtCount;
+  const unsigned ringsize=max(262144u,unsigned(min(ullong(recsize)*1024,ullong(RINGSIZEMAX))));
+  Sink=new JSeriesSink(false,true,csvsepcoma,Log);
+  FileCsv=dirout+"FloatingSeries.csv";
+  StreamId=Sink->AddStream(FileCsv,head,false,"Saves time series of floating bodies.",ringsize);
+}
+
+//==============================================================================
+/// Shows object configuration using Log.
+//==============================================================================
+void JDsFtSeries::VisuConfig(std::string txhead,std::string txfoot)const{
+  if(!txhead.empty())Log->Print(txhead);
+  Log->Printf("  File.......: %s",fun::GetFile(JSeriesSink::GetFileBin(FileCsv)).c_str());
+  Log->Printf("  Floatings..: %u",FtCount);
+  if(SaveDt>0)Log->Printf("  SaveDt.....: %g s",SaveDt);
+  else Log->Printf("  SaveDt.....: all steps");
+  if(!txfoot.empty())Log->Print(txfoot);
+}
+
+//==============================================================================
+/// Stores the accelerations before applying motion constraints.
+//==============================================================================
+void JDsFtSeries::SetForcesFree(const StFtoForces *ftoforces){
+  for(unsigned cf=0;cf<FtCount;cf++)ForcesFree[cf]=ftoforces[cf];
+  ForcesFreeOk=true;
+}
+
+//==============================================================================
+/// Adds the record of the step using the final accelerations (with motion
+/// constraints) and the updated data of floating bodies.
+//==============================================================================
+void JDsFtSeries::AddStep(unsigned nstep,double timestep,double dt
+  ,const StFtoForces *ftoforces,const StFloatingData *ftobjs)
+{
+  const StFtoForces *ffree=(ForcesFreeOk? ForcesFree.data(): ftoforces);
+  JSeriesRec &rec=Sink->Rec(StreamId);
+  rec << nstep << timestep << dt;
+  for(unsigned cf=0;cf<FtCount;cf++){
+    const StFloatingData &fobj=ftobjs[cf];
+    const float mass=FtMass[cf];
+    rec << fobj.center << fobj.fvel << fobj.fomega;
+    rec << ffree[cf].face << ffree[cf].fomegaace;
+    rec << (ffree[cf].face-Gravity)*mass;
+    rec << (ftoforces[cf].face-ffree[cf].face)*mass;
+    rec << (ftoforces[cf].fomegaace-ffree[cf].fomegaace);
+  }
+  rec << jcsv::Endl();
+  ForcesFreeOk=false;
+  NumSteps++;
+  if(SaveDt>0)NextTime=SaveDt*(floor(timestep/SaveDt)+1);
+}
+
+//==============================================================================
+/// Writes pending records and closes the file.
+//==============================================================================
+void JDsFtSeries::Finish(){
+  if(Sink)Sink->Finish();
+}
+
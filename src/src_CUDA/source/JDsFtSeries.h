@@ -0,0 +1,91 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Grabacion de series temporales de los floatings (posicion, velocidades,
+//:#   aceleraciones, fuerzas y reacciones de las restricciones) en formato
+//:#   binario por columnas (.tsb) mediante JSeriesSink. (19-10-2026)
+//:#############################################################################
+
+/// \file JDsFtSeries.h \brief Declares the class \ref JDsFtSeries.
+
+#ifndef _JDsFtSeries_
+#define _JDsFtSeries_
+
+#include <string>
+#include <vector>
+#include "JObject.h"
+#include "DualSphDef.h"
+
+class JLog2;
+class JSeriesSink;
+
+//##############################################################################
+//# JDsFtSeries
+//##############################################################################
+/// \brief Saves time series of floating bodies in binary columnar format (.tsb).
+///
+/// For each saved step and each floating body: centre, linear and angular
+/// velocity, linear and angular acceleration without motion constraints, force
+/// of fluid and external forces (without gravity) and the reaction of motion
+/// constraints (mass by removed linear acceleration and removed angular
+/// acceleration). Records are stored in memory and written by the secondary
+/// thread of JSeriesSink. The file can be converted to CSV using the option
+/// -seriescsv of DualSPHysics or the class JSeriesReader.
+
+class JDsFtSeries : protected JObject
+{
+protected:
+  static const unsigned RINGSIZEMAX=67108864; ///<Maximum size of ring buffer (in bytes).
+
+  JLog2 *Log;
+  JSeriesSink *Sink;
+
+  std::string FileCsv;        ///<Name of stream (the binary file is FloatingSeries.tsb).
+  double SaveDt;              ///<Time between saved steps (0:all steps).
+  tfloat3 Gravity;            ///<Gravity acceleration.
+  unsigned FtCount;           ///<Number of floating bodies.
+  std::vector<float> FtMass;  ///<Mass of floating bodies [FtCount].
+
+  unsigned StreamId;          ///<Id of stream in Sink.
+  double NextTime;            ///<Time of next saved step.
+  unsigned NumSteps;          ///<Number of saved steps.
+  std::vector<StFtoForces> ForcesFree; ///<Accelerations without constraints of current step [FtCount].
+  bool ForcesFreeOk;          ///<ForcesFree was updated for current step.
+
+public:
+  JDsFtSeries(JLog2 *log);
+  ~JDsFtSeries();
+  void Reset();
+
+  void Config(const std::string &dirout,double savedt,bool csvsepcoma
+    ,const tfloat3 &gravity,unsigned ftcount,const StFloatingData *ftobjs);
+  void VisuConfig(std::string txhead,std::string txfoot)const;
+
+  bool CheckTime(double timestep)const{ return(timestep>=NextTime); }
+  void SetForcesFree(const StFtoForces *ftoforces);
+  void AddStep(unsigned nstep,double timestep,double dt
+    ,const StFtoForces *ftoforces,const StFloatingData *ftobjs);
+  void Finish();
+};
+
+#endif
+
+
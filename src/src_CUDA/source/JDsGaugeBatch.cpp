@@ -0,0 +1,196 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JDsGaugeBatch.cpp \brief Implements the class \ref JGaugeBatch.
+
+#include "JDsGaugeBatch.h"
+#include "JCellSearch_inline.h"
+#include "FunSphKernel.h"
+#include "FunSphEos.h"
+#include "OmpDefs.h"
+#include <cstring>
+#include <algorithm>
+
+using namespace std;
+
+//-Compares sample points according to their cell (z,y,x).
+class JGaugeBatchSortCell{
+  const std::vector<tint3> &Cells;
+public:
+  JGaugeBatchSortCell(const std::vector<tint3> &cells):Cells(cells){}
+  bool operator()(unsigned a,unsigned b)const{
+    const tint3 ca=Cells[a],cb=Cells[b];
+    return(ca.z<cb.z || (ca.z==cb.z && (ca.y<cb.y || (ca.y==cb.y && (ca.x<cb.x || (ca.x==cb.x && a<b))))));
+  }
+};
+
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JGaugeBatch::JGaugeBatch(){
+  ClassName="JGaugeBatch";
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JGaugeBatch::~JGaugeBatch(){
+  DestructorActive=true;
+  Reset();
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JGaugeBatch::Reset(){
+  Points.clear();
+  Sums.clear();
+  SortPoints.clear();
+  GroupBegin.clear();
+  SortOk=false;
+  SortPosMin=TDouble3(0);
+  SortScell=0;
+  NewCount=0;
+  RhopPress=false;
+}
+
+//==============================================================================
+/// Starts a new list of sample points. The previous sorting is reused when
+/// the same points are added again.
+//==============================================================================
+void JGaugeBatch::ClearPoints(){
+  NewCount=0;
+  RhopPress=false;
+}
+
+//==============================================================================
+/// Adds sample point and returns its index.
+//==============================================================================
+unsigned JGaugeBatch::AddPoint(const tdouble3 &pos){
+  if(NewCount<unsigned(Points.size()) && Points[NewCount].pos==pos)NewCount++;
+  else{
+    Points.resize(NewCount);
+    StPoint pt;
+    pt.pos=pos;
+    pt.cell=TInt3(0);
+    Points.push_back(pt);
+    NewCount++;
+    SortOk=false;
+  }
+  return(NewCount-1);
+}
+
+//==============================================================================
+/// Computes cells of points and sorts them by cell. Points of the same cell
+/// have the same range of neighbour cells in nsearch::Init().
+//==============================================================================
+void JGaugeBatch::ComputeCells(const StDivDataCpu &dvd){
+  const unsigned n=unsigned(Points.size());
+  std::vector<tint3> cells(n);
+  for(unsigned cp=0;cp<n;cp++){
+    const tdouble3 ps=Points[cp].pos;
+    cells[cp]=TInt3(int((ps.x-dvd.domposmin.x)/dvd.scell),int((ps.y-dvd.domposmin.y)/dvd.scell),int((ps.z-dvd.domposmin.z)/dvd.scell));
+    Points[cp].cell=cells[cp];
+  }
+  SortPoints.resize(n);
+  for(unsigned cp=0;cp<n;cp++)SortPoints[cp]=cp;
+  sort(SortPoints.begin(),SortPoints.end(),JGaugeBatchSortCell(cells));
+  //-Computes groups of points with the same cell.
+  GroupBegin.clear();
+  for(unsigned c=0;c<n;c++){
+    if(!c || cells[SortPoints[c]]!=cells[SortPoints[c-1]])GroupBegin.push_back(c);
+  }
+  GroupBegin.push_back(n);
+  SortPosMin=dvd.domposmin;
+  SortScell=dvd.scell;
+  SortOk=true;
+}
+
+//==============================================================================
+/// Computes kernel sums of fluid particles at the sample points. Each group of
+/// points in the same cell traverses its neighbouring particles once and the
+/// groups are processed in parallel.
+//==============================================================================
+template<TpKernel tker,bool rhoppress> void JGaugeBatch::CalculeT(const StCteSph &csp
+  ,const StDivDataCpu &dvd,const tdouble3 *pos,const typecode *code,const tfloat4 *velrhop)
+{
+  const int ng=int(GroupBegin.size())-1;
+  const unsigned *sortpoints=(SortPoints.empty()? NULL: &SortPoints[0]);
+  const StPoint *points=(Points.empty()? NULL: &Points[0]);
+  StSums *sums=(Sums.empty()? NULL: &Sums[0]);
+  #ifdef OMP_USE
+    #pragma omp parallel for schedule (dynamic) if(ng>1)
+  #endif
+  for(int cg=0;cg<ng;cg++){
+    const unsigned gini=GroupBegin[cg],gfin=GroupBegin[cg+1];
+    for(unsigned c=gini;c<gfin;c++)memset(sums+sortpoints[c],0,sizeof(StSums));
+    //-Search for fluid neighbours in adjacent cells (common to all points of the group).
+    const StNgSearch ngs=nsearch::Init(points[sortpoints[gini]].pos,false,dvd);
+    for(int z=ngs.zini;z<ngs.zfin;z++)for(int y=ngs.yini;y<ngs.yfin;y++){
+      const tuint2 pif=nsearch::ParticleRange(y,z,ngs,dvd);
+      for(unsigned p2=pif.x;p2<pif.y;p2++)if(CODE_IsFluid(code[p2])){
+        const tdouble3 pos2=pos[p2];
+        const tfloat4 velrhop2=velrhop[p2];
+        const float press2=(rhoppress? fsph::ComputePress(velrhop2.w,csp): 0);
+        for(unsigned c=gini;c<gfin;c++){
+          const unsigned cp=sortpoints[c];
+          const float rr2=nsearch::Distance2(points[cp].pos,pos2);
+          //-Interaction with real neighbouring particles.
+          if(rr2<=csp.kernelsize2 && rr2>=ALMOSTZERO){
+            float wab=fsph::GetKernel_Wab<tker>(csp,rr2);
+            wab*=csp.massfluid/velrhop2.w;
+            StSums &s=sums[cp];
+            s.sumwab+=wab;
+            s.sumvel.x+=wab*velrhop2.x;
+            s.sumvel.y+=wab*velrhop2.y;
+            s.sumvel.z+=wab*velrhop2.z;
+            s.summass+=wab*csp.massfluid;
+            if(rhoppress){
+              s.sumrhop+=wab*velrhop2.w;
+              s.sumpress+=wab*press2;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+//==============================================================================
+/// Computes kernel sums of fluid particles at the sample points (on CPU).
+//==============================================================================
+void JGaugeBatch::Calcule(const StCteSph &csp,const StDivDataCpu &dvd,const tdouble3 *pos
+  ,const typecode *code,const tfloat4 *velrhop)
+{
+  if(NewCount<unsigned(Points.size())){
+    Points.resize(NewCount);
+    SortOk=false;
+  }
+  if(!SortOk || SortPosMin!=dvd.domposmin || SortScell!=dvd.scell)ComputeCells(dvd);
+  Sums.resize(Points.size());
+  switch(csp.tkernel){
+    case KERNEL_Cubic:       //Kernel Wendland is used since Cubic is not available.
+    case KERNEL_Wendland:
+      if(RhopPress)CalculeT<KERNEL_Wendland,true> (csp,dvd,pos,code,velrhop);
+      else     CalculeT<KERNEL_Wendland,false>(csp,dvd,pos,code,velrhop);
+    break;
+    default: Run_Exceptioon("Kernel unknown.");
+  }
+}
+
@@ -0,0 +1,101 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Clase para calcular sumas de kernel en muchos puntos de medida a la vez.
+//:#   Los puntos se ordenan por celda y los puntos de la misma celda comparten
+//:#   el recorrido de vecinos. Las celdas se procesan en paralelo. (19-10-2026)
+//:# - Sumas de densidad y presion bajo demanda (RequestRhopPress()) para la
+//:#   medida en nubes de puntos (JGaugeCloud). (19-10-2026)
+//:#############################################################################
+
+/// \file JDsGaugeBatch.h \brief Declares the class \ref JGaugeBatch.
+
+#ifndef _JDsGaugeBatch_
+#define _JDsGaugeBatch_
+
+#include <vector>
+#include "JObject.h"
+#include "DualSphDef.h"
+#include "JCellDivDataCpu.h"
+
+//##############################################################################
+//# JGaugeBatch
+//##############################################################################
+/// \brief Computes kernel sums of fluid particles at many sample points (on CPU).
+///
+/// Points are grouped by the cell used for the neighbour search, so all the
+/// points of one cell share the same traversal of neighbouring particles and
+/// obtain the same sums as the single-point search of the gauges. The groups
+/// are processed in parallel and the sorting is reused while the cells of the
+/// points do not change.
+
+class JGaugeBatch : protected JObject
+{
+public:
+  ///Kernel sums at one sample point.
+  typedef struct{
+    double sumwab;    ///<Sum of wab*mass/rhop (Shepard normalisation).
+    tdouble3 sumvel;  ///<Sum of wab*mass/rhop*vel.
+    double summass;   ///<Sum of wab*mass/rhop*mass.
+    double sumrhop;   ///<Sum of wab*mass/rhop*rhop (only when RhopPress is requested).
+    double sumpress;  ///<Sum of wab*mass/rhop*press (only when RhopPress is requested).
+  }StSums;
+
+protected:
+  ///Sample point.
+  typedef struct{
+    tdouble3 pos;     ///<Position of point.
+    tint3 cell;       ///<Cell of point for neighbour search (according to DomPosMin).
+  }StPoint;
+
+  std::vector<StPoint> Points;      ///<Sample points.
+  std::vector<StSums> Sums;         ///<Results for each point.
+  std::vector<unsigned> SortPoints; ///<Points sorted by cell.
+  std::vector<unsigned> GroupBegin; ///<First position in SortPoints of each cell group (+1 final).
+  bool SortOk;                      ///<Sorting of points is valid.
+  tdouble3 SortPosMin;              ///<Domain position used to compute the cells of sorting.
+  float SortScell;                  ///<Cell size used to compute the cells of sorting.
+  unsigned NewCount;                ///<Number of points added since last ClearPoints().
+  bool RhopPress;                   ///<Computes also sums of density and pressure.
+
+  void ComputeCells(const StDivDataCpu &dvd);
+  template<TpKernel tker,bool rhoppress> void CalculeT(const StCteSph &csp,const StDivDataCpu &dvd
+    ,const tdouble3 *pos,const typecode *code,const tfloat4 *velrhop);
+
+public:
+  JGaugeBatch();
+  ~JGaugeBatch();
+  void Reset();
+
+  void ClearPoints();
+  unsigned AddPoint(const tdouble3 &pos);
+  unsigned GetCount()const{ return(unsigned(Points.size())); }
+  void RequestRhopPress(){ RhopPress=true; }
+
+  void Calcule(const StCteSph &csp,const StDivDataCpu &dvd,const tdouble3 *pos
+    ,const typecode *code,const tfloat4 *velrhop);
+
+  const StSums& GetSums(unsigned cp)const{ return(Sums[cp]); }
+};
+
+#endif
+
+
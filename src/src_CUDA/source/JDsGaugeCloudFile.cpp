@@ -0,0 +1,230 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JDsGaugeCloudFile.cpp \brief Implements the classes \ref JGaugeCloudFileSave and \ref JGaugeCloudFileLoad.
+
+#include "JDsGaugeCloudFile.h"
+#include "Functions.h"
+#include "JNumFormat.h"
+#include "OmpDefs.h"
+#include <cstring>
+#include <cstdio>
+
+using namespace std;
+
+//##############################################################################
+//# JGaugeCloudFileSave
+//##############################################################################
+//==============================================================================
+/// Constructor. Creates the file and saves the header and the points.
+//==============================================================================
+JGaugeCloudFileSave::JGaugeCloudFileSave(const std::string &file,unsigned np
+  ,const tdouble3 *points,unsigned nvar):FileName(file),Np(np),Nvar(nvar)
+{
+  ClassName="JGaugeCloudFileSave";
+  NumSteps=0;
+  Pf.open(FileName.c_str(),ios::binary|ios::out|ios::trunc);
+  if(!Pf)Run_ExceptioonFile("Cannot open the file.",FileName);
+  JGaugeCloudFileDef::StHead hd;
+  memset(&hd,0,sizeof(hd));
+  memcpy(hd.magic,"DSGCLOUD",8);
+  hd.version=JGaugeCloudFileDef::VERSION;
+  hd.np=Np;
+  hd.nvar=Nvar;
+  hd.chunksoffset=sizeof(hd)+sizeof(tdouble3)*ullong(Np);
+  Pf.write((const char*)&hd,sizeof(hd));
+  if(Np)Pf.write((const char*)points,sizeof(tdouble3)*Np);
+  Pf.flush();
+  if(Pf.fail())Run_ExceptioonFile("File writing failure.",FileName);
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JGaugeCloudFileSave::~JGaugeCloudFileSave(){
+  DestructorActive=true;
+  if(Pf.is_open())Pf.close();
+}
+
+//==============================================================================
+/// Appends chunk with nsteps time steps. The values are ordered by step in
+/// data [nsteps][np][nvar] and they are saved by point [np][nsteps][nvar].
+//==============================================================================
+void JGaugeCloudFileSave::AddChunk(unsigned nsteps,const double *times,const float *data){
+  if(!nsteps)return;
+  const size_t nv=size_t(Np)*Nvar*nsteps;
+  Buffer.resize(nv);
+  float *buf=(nv? &Buffer[0]: NULL);
+  const int np=int(Np);
+  #ifdef OMP_USE
+    #pragma omp parallel for schedule (static) if(np>OMP_LIMIT_COMPUTELIGHT)
+  #endif
+  for(int p=0;p<np;p++){
+    float *bp=buf+size_t(p)*Nvar*nsteps;
+    for(unsigned cs=0;cs<nsteps;cs++){
+      const float *dp=data+(size_t(cs)*Np+p)*Nvar;
+      for(unsigned cv=0;cv<Nvar;cv++)bp[cs*Nvar+cv]=dp[cv];
+    }
+  }
+  JGaugeCloudFileDef::StChunkHead ch;
+  ch.nsteps=nsteps;
+  ch.pad=0;
+  Pf.write((const char*)&ch,sizeof(ch));
+  Pf.write((const char*)times,sizeof(double)*nsteps);
+  if(nv)Pf.write((const char*)buf,sizeof(float)*nv);
+  Pf.flush();
+  if(Pf.fail())Run_ExceptioonFile("File writing failure.",FileName);
+  NumSteps+=nsteps;
+}
+
+
+//##############################################################################
+//# JGaugeCloudFileLoad
+//##############################################################################
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JGaugeCloudFileLoad::JGaugeCloudFileLoad(){
+  ClassName="JGaugeCloudFileLoad";
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JGaugeCloudFileLoad::~JGaugeCloudFileLoad(){
+  DestructorActive=true;
+  Reset();
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JGaugeCloudFileLoad::Reset(){
+  if(Pf.is_open())Pf.close();
+  FileName="";
+  Np=Nvar=0;
+  Points.clear();
+  Times.clear();
+  ChunkOffset.clear();
+  ChunkSteps.clear();
+}
+
+//==============================================================================
+/// Loads header, points and times of the file.
+//==============================================================================
+void JGaugeCloudFileLoad::LoadFile(const std::string &file){
+  Reset();
+  Pf.open(file.c_str(),ios::binary|ios::in);
+  if(!Pf)Run_ExceptioonFile("Cannot open the file.",file);
+  FileName=file;
+  Pf.seekg(0,ios::end);
+  const ullong fsize=ullong(Pf.tellg());
+  Pf.seekg(0,ios::beg);
+  //-Loads header and points.
+  JGaugeCloudFileDef::StHead hd;
+  if(fsize<sizeof(hd))Run_ExceptioonFile("The file is invalid.",file);
+  Pf.read((char*)&hd,sizeof(hd));
+  if(strncmp(hd.magic,"DSGCLOUD",8))Run_ExceptioonFile("The file format is invalid.",file);
+  if(hd.version!=JGaugeCloudFileDef::VERSION)Run_ExceptioonFile(fun::PrintStr("The version of file (%u) is not supported.",hd.version),file);
+  Np=hd.np;
+  Nvar=hd.nvar;
+  if(hd.chunksoffset!=sizeof(hd)+sizeof(tdouble3)*ullong(Np) || hd.chunksoffset>fsize)Run_ExceptioonFile("The file is invalid.",file);
+  Points.resize(Np);
+  if(Np)Pf.read((char*)&Points[0],sizeof(tdouble3)*Np);
+  //-Loads headers and times of chunks.
+  ullong pos=hd.chunksoffset;
+  while(pos+sizeof(JGaugeCloudFileDef::StChunkHead)<=fsize){
+    JGaugeCloudFileDef::StChunkHead ch;
+    Pf.seekg(pos,ios::beg);
+    Pf.read((char*)&ch,sizeof(ch));
+    const ullong size=JGaugeCloudFileDef::ChunkSize(Np,Nvar,ch.nsteps);
+    if(!ch.nsteps || pos+size>fsize)break; //-Incomplete chunk.
+    const size_t nt=Times.size();
+    Times.resize(nt+ch.nsteps);
+    Pf.read((char*)&Times[nt],sizeof(double)*ch.nsteps);
+    ChunkOffset.push_back(pos);
+    ChunkSteps.push_back(ch.nsteps);
+    pos+=size;
+  }
+  if(Pf.fail())Run_ExceptioonFile("File reading failure.",file);
+}
+
+//==============================================================================
+/// Returns the values of point p for all steps in values[GetNumSteps()*Nvar].
+//==============================================================================
+void JGaugeCloudFileLoad::GetPointValues(unsigned p,float *values)const{
+  if(p>=Np)Run_ExceptioonFile(fun::PrintStr("The point %u is invalid.",p),FileName);
+  const unsigned nc=GetNumChunks();
+  for(unsigned c=0;c<nc;c++){
+    const unsigned ns=ChunkSteps[c];
+    const ullong pos=ChunkOffset[c]+sizeof(JGaugeCloudFileDef::StChunkHead)+sizeof(double)*ns+sizeof(float)*ullong(p)*Nvar*ns;
+    Pf.seekg(pos,ios::beg);
+    Pf.read((char*)values,sizeof(float)*Nvar*ns);
+    values+=size_t(Nvar)*ns;
+  }
+  if(Pf.fail())Run_ExceptioonFile("File reading failure.",FileName);
+}
+
+//==============================================================================
+/// Saves the time series of point p in CSV format. The names of the values
+/// are the ones of JGaugeCloud (velx,vely,velz,rhop,press) when the number of
+/// values per point matches.
+//==============================================================================
+void JGaugeCloudFileLoad::SavePointCsv(unsigned p,const std::string &filecsv,bool csvsepcoma)const{
+  if(p>=Np)Run_ExceptioonFile(fun::PrintStr("The point %u is invalid (number of points: %u).",p,Np),FileName);
+  const char sep=(csvsepcoma? ',': ';');
+  const unsigned ns=GetNumSteps();
+  vector<float> values(size_t(ns)*Nvar);
+  if(ns)GetPointValues(p,&values[0]);
+  FILE *pf=fopen(filecsv.c_str(),"wb");
+  if(!pf)Run_ExceptioonFile("Cannot open the file.",filecsv);
+  //-Saves head.
+  const char* names[5]={"velx [m/s]","vely [m/s]","velz [m/s]","rhop [kg/m^3]","press [Pa]"};
+  string tx="time [s]";
+  for(unsigned cv=0;cv<Nvar;cv++){
+    tx=tx+sep+(Nvar==5? string(names[cv]): fun::PrintStr("value%u",cv));
+  }
+  tx=tx+"\n";
+  //-Saves values of each step.
+  const JNumFormat fmt("%r");
+  for(unsigned cs=0;cs<ns;cs++){
+    fmt.Append(tx,&Times[cs],1);
+    for(unsigned cv=0;cv<Nvar;cv++){
+      tx.push_back(sep);
+      fmt.Append(tx,&values[size_t(cs)*Nvar+cv],1);
+    }
+    tx.push_back('\n');
+  }
+  if(fwrite(tx.data(),1,tx.size(),pf)!=tx.size()){
+    fclose(pf);
+    Run_ExceptioonFile("File writing failure.",filecsv);
+  }
+  fclose(pf);
+}
+
+//==============================================================================
+/// Converts the time series of point p of binary file to CSV format.
+//==============================================================================
+void JGaugeCloudFileLoad::ConvertToCsv(const std::string &file,unsigned p
+  ,const std::string &filecsv,bool csvsepcoma)
+{
+  JGaugeCloudFileLoad rd;
+  rd.LoadFile(file);
+  rd.SavePointCsv(p,filecsv,csvsepcoma);
+}
@@ -0,0 +1,145 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Clases para grabar y leer las series temporales de una nube de puntos
+//:#   de medida (JGaugeCloud) en un fichero binario por bloques de instantes.
+//:#   (19-10-2026)
+//:# - Conversion de la serie de un punto a CSV (opcion -cloudcsv). (19-10-2026)
+//:#############################################################################
+
+/// \file JDsGaugeCloudFile.h \brief Declares the classes \ref JGaugeCloudFileSave and \ref JGaugeCloudFileLoad.
+
+#ifndef _JDsGaugeCloudFile_
+#define _JDsGaugeCloudFile_
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include "JObject.h"
+#include "TypesDef.h"
+
+//##############################################################################
+//# JGaugeCloudFileDef
+//##############################################################################
+/// \brief Defines the format of binary files of probe-cloud gauges.
+///
+/// File format (little-endian, native types):
+/// - Header [32 bytes]: magic "DSGCLOUD", version, number of points (np),
+///   number of values per point (nvar), padding and offset of first chunk.
+/// - Position of points [np*tdouble3].
+/// - Chunks of time steps appended during the simulation. Each chunk contains
+///   the number of steps (ns) and padding [8 bytes], the times [ns*double] and
+///   the values [np][ns][nvar] in float. The values of one point are contiguous
+///   in each chunk, so the series of one point is read with a single read per
+///   chunk.
+
+class JGaugeCloudFileDef
+{
+public:
+  static const unsigned VERSION=1;
+
+  ///Header of file.
+  typedef struct{
+    char magic[8];        ///<Magic string "DSGCLOUD".
+    unsigned version;     ///<Version of format.
+    unsigned np;          ///<Number of points.
+    unsigned nvar;        ///<Number of values per point and step.
+    unsigned pad;         ///<Padding (not used).
+    ullong chunksoffset;  ///<Offset of first chunk.
+  }StHead;
+
+  ///Header of chunk.
+  typedef struct{
+    unsigned nsteps;      ///<Number of time steps in chunk.
+    unsigned pad;         ///<Padding (not used).
+  }StChunkHead;
+
+  static ullong ChunkSize(unsigned np,unsigned nvar,unsigned nsteps){
+    return(sizeof(StChunkHead)+sizeof(double)*nsteps+sizeof(float)*ullong(np)*nvar*nsteps);
+  }
+};
+
+//##############################################################################
+//# JGaugeCloudFileSave
+//##############################################################################
+/// \brief Creates the binary file and appends chunks of time steps.
+
+class JGaugeCloudFileSave : protected JObject
+{
+protected:
+  const std::string FileName;
+  const unsigned Np;
+  const unsigned Nvar;
+  std::ofstream Pf;
+  std::vector<float> Buffer;    ///<Auxiliary memory to reorder values of chunk.
+  unsigned NumSteps;            ///<Number of saved time steps.
+
+public:
+  JGaugeCloudFileSave(const std::string &file,unsigned np,const tdouble3 *points,unsigned nvar);
+  ~JGaugeCloudFileSave();
+  void AddChunk(unsigned nsteps,const double *times,const float *data);
+  std::string GetFileName()const{ return(FileName); }
+  unsigned GetNumSteps()const{ return(NumSteps); }
+};
+
+//##############################################################################
+//# JGaugeCloudFileLoad
+//##############################################################################
+/// \brief Reads the binary file of a probe-cloud gauge.
+///
+/// Only the headers of chunks are read by LoadFile(), the values of each point
+/// are read on demand by GetPointValues(). An incomplete last chunk (e.g. of
+/// an interrupted simulation) is ignored. The series of one point can be
+/// saved in CSV format (option -cloudcsv of DualSPHysics).
+
+class JGaugeCloudFileLoad : protected JObject
+{
+protected:
+  std::string FileName;
+  unsigned Np;
+  unsigned Nvar;
+  std::vector<tdouble3> Points;
+  std::vector<double> Times;          ///<Times of all steps.
+  std::vector<ullong> ChunkOffset;    ///<Offset of each chunk.
+  std::vector<unsigned> ChunkSteps;   ///<Number of steps of each chunk.
+  mutable std::ifstream Pf;
+
+public:
+  JGaugeCloudFileLoad();
+  ~JGaugeCloudFileLoad();
+  void Reset();
+  void LoadFile(const std::string &file);
+
+  unsigned GetNp()const{ return(Np); }
+  unsigned GetNvar()const{ return(Nvar); }
+  unsigned GetNumSteps()const{ return(unsigned(Times.size())); }
+  unsigned GetNumChunks()const{ return(unsigned(ChunkOffset.size())); }
+  const tdouble3& GetPoint(unsigned p)const{ return(Points[p]); }
+  const std::vector<double>& GetTimes()const{ return(Times); }
+  void GetPointValues(unsigned p,float *values)const;
+
+  void SavePointCsv(unsigned p,const std::string &filecsv,bool csvsepcoma)const;
+  static void ConvertToCsv(const std::string &file,unsigned p,const std::string &filecsv,bool csvsepcoma);
+};
+
+#endif
+
+
@@ -25,11 +25,14 @@
 #include "JException.h"
 #include "JLog2.h"
 #include "JSaveCsv2.h"
+#include "JSeriesSink.h"
 #include "JAppInfo.h"
 #include "Functions.h"
 #include "FunctionsGeo3d.h"
 #include "JDataArrays.h"
 #include "JVtkLib.h"
+#include "JOutputVtu.h"
+#include "OmpDefs.h"
 #ifdef _WITHGPU
   #include "FunctionsCuda.h"
   #include "JDsGauge_ker.h"
@@ -39,6 +42,7 @@
 #include <cfloat>
 #include <climits>
 #include <algorithm>
+#include <algorithm>
 
 using namespace std;
 
@@ -52,6 +56,7 @@ JGaugeItem::JGaugeItem(TpGauge type,unsigned idx,std::string name,bool cpu,JLog2
   :Type(type),Idx(idx),Name(name),Cpu(cpu),Log(log)
 {
   ClassName="JGaugeItem";
+  OutStream=UINT_MAX;
   Reset();
 }
 
@@ -89,8 +94,11 @@ void JGaugeItem::Reset(){
   ConfigComputeTiming(0,0,0);
   ConfigOutputTiming(false,0,0,0);
   TimeStep=0;
+  BatchIdx=UINT_MAX;
   OutCount=0;
   OutFile="";
+  if(OutStream!=UINT_MAX)AppInfo.SeriesPtr()->CloseStream(OutStream);
+  OutStream=UINT_MAX;
 }
 
 //==============================================================================
@@ -107,6 +115,16 @@ void JGaugeItem::Config(const StCteSph & csp,bool symmetry,tdouble3 domposmin
   ScellDiv=scelldiv;
 }
 
+//==============================================================================
+/// Updates domain limits and cell configuration when the cell division changes.
+//==============================================================================
+void JGaugeItem::ConfigCells(tdouble3 domposmin,tdouble3 domposmax,float scell,int scelldiv){
+  DomPosMin=domposmin;
+  DomPosMax=domposmax;
+  Scell=scell;
+  ScellDiv=scelldiv;
+}
+
 //==============================================================================
 /// Configures compute timing.
 //==============================================================================
@@ -137,6 +155,8 @@ std::string JGaugeItem::GetNameType(TpGauge type){
     case GAUGE_Swl:   return("SWL");
     case GAUGE_MaxZ:  return("MaxZ");
     case GAUGE_Force: return("Force");
+    case GAUGE_Cloud: return("Cloud");
+    case GAUGE_Section: return("Section");
   }
   return("???");
 }
@@ -171,6 +191,25 @@ void JGaugeItem::GetConfig(std::vector<std::string> &lines)const{
     lines.push_back(fun::PrintStr("MkBound.....: %u (%s particles)",gau->GetMkBound(),TpPartGetStrCode(gau->GetTypeParts())));
     lines.push_back(fun::PrintStr("Particles id: %u - %u",gau->GetIdBegin(),gau->GetIdBegin()+gau->GetCount()-1));
   }
+  else if(Type==GAUGE_Cloud){
+    const JGaugeCloud* gau=(JGaugeCloud*)this;
+    lines.push_back(fun::PrintStr("Points.....: %u  (%s)",gau->GetNp(),gau->GetPointsDef().c_str()));
+    lines.push_back(fun::PrintStr("OutputSteps: %u  (per chunk)",gau->GetOutSteps()));
+  }
+  else if(Type==GAUGE_Section){
+    const JGaugeSection* gau=(JGaugeSection*)this;
+    const std::vector<tdouble3> &dpts=gau->GetDefPoints();
+    if(gau->IsPlane()){
+      lines.push_back(fun::PrintStr("Plane......: (%g,%g,%g)",dpts[0].x,dpts[0].y,dpts[0].z));
+      lines.push_back(fun::PrintStr("  Edge1....: (%g,%g,%g)",dpts[1].x,dpts[1].y,dpts[1].z));
+      lines.push_back(fun::PrintStr("  Edge2....: (%g,%g,%g)",dpts[2].x,dpts[2].y,dpts[2].z));
+      lines.push_back(fun::PrintStr("Points.....: %u x %u = %u  (dp:%g)",gau->GetPlaneSize().x,gau->GetPlaneSize().y,gau->GetNp(),gau->GetDp()));
+    }
+    else{
+      lines.push_back(fun::PrintStr("Polyline...: %u vertices",unsigned(dpts.size())));
+      lines.push_back(fun::PrintStr("Points.....: %u  (dp:%g)",gau->GetNp(),gau->GetDp()));
+    }
+  }
   else Run_Exceptioon("Type unknown.");
 }
 
@@ -200,6 +239,20 @@ void JGaugeItem::SetTimeStep(double timestep){
   TimeStep=timestep;
 }
 
+//==============================================================================
+/// Returns the builder of records of the time series of results. The stream
+/// is created with the first result (the file is created when it is saved).
+//==============================================================================
+JSeriesRec& JGaugeItem::OutRec(const std::string &head){
+  JSeriesSink *series=AppInfo.SeriesPtr();
+  if(OutStream==UINT_MAX){
+    OutFile=GetResultsFileCsv();
+    OutStream=series->AddStream(OutFile,head,false,FileInfo);
+    series->Rec(OutStream) << jcsv::Fmt(jcsv::TpFloat1,"%g") << jcsv::Fmt(jcsv::TpFloat3,"%g;%g;%g");
+  }
+  return(series->Rec(OutStream));
+}
+
 //==============================================================================
 /// Saves results in VTK and/or CSV file.
 //==============================================================================
@@ -245,13 +298,9 @@ void JGaugeVelocity::Reset(){
 //==============================================================================
 void JGaugeVelocity::StoreResult(){
   if(OutputSave){
-    //-Allocates memory.
-    while(unsigned(OutBuff.size())<OutSize)OutBuff.push_back(StrGaugeVelRes());
-    //-Empty buffer.
-    if(OutCount+1>=OutSize)SaveResults();
-    //-Stores last results.
-    OutBuff[OutCount]=Result;
-    OutCount++;
+    //-Stores last results in time series.
+    OutRec("time [s];velx [m/s];vely [m/s];velz [m/s];posx [m];posy [m];posz [m]")
+      << Result.timestep << Result.vel << Result.point << jcsv::Endl();
     //-Updates OutputNext.
     if(OutputDt){
       const unsigned nt=unsigned(TimeStep/OutputDt);
@@ -262,29 +311,10 @@ void JGaugeVelocity::StoreResult(){
 }
 
 //==============================================================================
-/// Saves stored results in CSV file.
+/// Requests the write of stored results in CSV file.
 //==============================================================================
 void JGaugeVelocity::SaveResults(){
-  if(OutCount){
-    const bool first=OutFile.empty();
-    if(first){
-      OutFile=GetResultsFileCsv();
-      Log->AddFileInfo(OutFile,FileInfo);
-    }
-    jcsv::JSaveCsv2 scsv(OutFile,!first,AppInfo.GetCsvSepComa());
-    //-Saves head.
-    if(first){
-      scsv.SetHead();
-      scsv << "time [s];velx [m/s];vely [m/s];velz [m/s];posx [m];posy [m];posz [m]" << jcsv::Endl();
-    }
-    //-Saves data.
-    scsv.SetData();
-    scsv << jcsv::Fmt(jcsv::TpFloat1,"%g") << jcsv::Fmt(jcsv::TpFloat3,"%g;%g;%g");
-    for(unsigned c=0;c<OutCount;c++){
-      scsv << OutBuff[c].timestep << OutBuff[c].vel << OutBuff[c].point << jcsv::Endl();
-    }
-    OutCount=0;
-  }
+  if(OutStream!=UINT_MAX)AppInfo.SeriesPtr()->Flush(OutStream);
 }
 
 //==============================================================================
@@ -357,6 +387,26 @@ template<TpKernel tker> void JGaugeVelocity::CalculeCpuT(double timestep
   //Log->Printf("------> t:%f",TimeStep);
   if(Output(timestep))StoreResult();
 }
+
+//==============================================================================
+/// Adds the measurement point to JGaugeBatch when it is within the domain.
+//==============================================================================
+void JGaugeVelocity::AddBatchPoints(JGaugeBatch &batch){
+  const bool ptout=PointIsOut(Point.x,Point.y,Point.z);//-Verify that the point is within domain boundaries. | Comprueba que el punto este dentro de limites del dominio.
+  BatchIdx=(ptout? UINT_MAX: batch.AddPoint(Point));
+}
+
+//==============================================================================
+/// Stores velocity using the kernel sums computed by JGaugeBatch (on CPU).
+/// The result is the same as CalculeCpu().
+//==============================================================================
+void JGaugeVelocity::CalculeBatchCpu(double timestep,const JGaugeBatch &batch){
+  SetTimeStep(timestep);
+  const tfloat3 ptvel=(BatchIdx!=UINT_MAX? ToTFloat3(batch.GetSums(BatchIdx).sumvel): TFloat3(0));
+  //-Stores result. | Guarda resultado.
+  Result.Set(timestep,ToTFloat3(Point),ptvel);
+  if(Output(timestep))StoreResult();
+}
 //==============================================================================
 /// Calculates velocity at indicated points (on CPU).
 //==============================================================================
@@ -427,6 +477,11 @@ JGaugeSwl::~JGaugeSwl(){
 void JGaugeSwl::Reset(){
   SetPoints(TDouble3(0),TDouble3(0),0);
   MassLimit=0;
+  CoarseStep=1;
+  RefineIdx=UINT_MAX;
+  RefineIni=RefineNp=0;
+  RefineMpre=0;
+  NoSurfPos=TDouble3(0);
   JGaugeItem::Reset();
 }
 
@@ -458,13 +513,9 @@ void JGaugeSwl::SetPoints(const tdouble3 &point0,const tdouble3 &point2,double p
 //==============================================================================
 void JGaugeSwl::StoreResult(){
   if(OutputSave){
-    //-Allocates memory.
-    while(unsigned(OutBuff.size())<OutSize)OutBuff.push_back(StrGaugeSwlRes());
-    //-Empty buffer.
-    if(OutCount+1>=OutSize)SaveResults();
-    //-Stores last results.
-    OutBuff[OutCount]=Result;
-    OutCount++;
+    //-Stores last results in time series.
+    OutRec("time [s];swlx [m];swly [m];swlz [m];pos0x [m];pos0y [m];pos0z [m];pos2x [m];pos2y [m];pos2z [m]")
+      << Result.timestep << Result.posswl << Result.point0 << Result.point2 << jcsv::Endl();
     //-Updates OutputNext.
     if(OutputDt){
       const unsigned nt=unsigned(TimeStep/OutputDt);
@@ -475,30 +526,10 @@ void JGaugeSwl::StoreResult(){
 }
 
 //==============================================================================
-/// Saves stored results in CSV file.
+/// Requests the write of stored results in CSV file.
 //==============================================================================
 void JGaugeSwl::SaveResults(){
-  if(OutCount){
-    const bool first=OutFile.empty();
-    if(first){
-      OutFile=GetResultsFileCsv();
-      Log->AddFileInfo(OutFile,FileInfo);
-    }
-    jcsv::JSaveCsv2 scsv(OutFile,!first,AppInfo.GetCsvSepComa());
-    //-Saves head.
-    if(first){
-      //-Head of values.
-      scsv.SetHead();
-      scsv <<"time [s];swlx [m];swly [m];swlz [m];pos0x [m];pos0y [m];pos0z [m];pos2x [m];pos2y [m];pos2z [m]" << jcsv::Endl();
-    }
-    //-Saves data.
-    scsv.SetData();
-    scsv << jcsv::Fmt(jcsv::TpFloat1,"%g") << jcsv::Fmt(jcsv::TpFloat3,"%g;%g;%g");
-    for(unsigned c=0;c<OutCount;c++){
-      scsv << OutBuff[c].timestep << OutBuff[c].posswl << OutBuff[c].point0 << OutBuff[c].point2 << jcsv::Endl();
-    }
-    OutCount=0;
-  }
+  if(OutStream!=UINT_MAX)AppInfo.SeriesPtr()->Flush(OutStream);
 }
 
 //==============================================================================
@@ -526,61 +557,75 @@ unsigned JGaugeSwl::GetPointDef(std::vector<tfloat3> &points)const{
 }
 
 //==============================================================================
-/// Returns the interpolated mass value at the indicated point. The point must 
-/// belong to the cell domain.
-///
-/// Devuelve valor de masa interpolado en el punto indicado. El punto debe 
-/// pertenecer al dominio de celdas.
+/// Adds the coarse points of the line to JGaugeBatch. The distance between
+/// coarse points is about Dp (CoarseStep points of the line) and the last
+/// point of the line is always included.
 //==============================================================================
-template<TpKernel tker> float JGaugeSwl::CalculeMassCpu(const tdouble3 &ptpos
-  ,const StDivDataCpu &dvd,const tdouble3 *pos,const typecode *code,const tfloat4 *velrhop)const
-{
-  //-Auxiliary variables.
-  double sumwab=0;
-  double summass=0;
-  //-Search for fluid neighbours in adjacent cells.
-  const StNgSearch ngs=nsearch::Init(ptpos,false,dvd);
-  for(int z=ngs.zini;z<ngs.zfin;z++)for(int y=ngs.yini;y<ngs.yfin;y++){
-    const tuint2 pif=nsearch::ParticleRange(y,z,ngs,dvd);
-    for(unsigned p2=pif.x;p2<pif.y;p2++){
-      const float rr2=nsearch::Distance2(ptpos,pos[p2]);
-      //-Interaction with real neighbouring particles.
-      if(rr2<=CSP.kernelsize2 && rr2>=ALMOSTZERO && CODE_IsFluid(code[p2])){
-        float wab=fsph::GetKernel_Wab<tker>(CSP,rr2);
-        wab*=CSP.massfluid/velrhop[p2].w;
-        sumwab+=wab;
-        summass+=wab*CSP.massfluid;
-      }
-    }
+void JGaugeSwl::AddBatchPoints(JGaugeBatch &batch){
+  const double dpdir=fgeo::PointDist(PointDir);
+  CoarseStep=(dpdir>0? max(unsigned(CSP.dp/dpdir),1u): 1u);
+  for(unsigned cp=0;cp<=PointNp;cp+=CoarseStep){
+    const unsigned idx=batch.AddPoint(Point0+(PointDir*double(cp)));
+    if(!cp)BatchIdx=idx;
   }
-  //-Applies kernel correction.
-  //if(sumwab!=0)summass/=sumwab;
-  return(float(summass));
+  if(PointNp%CoarseStep)batch.AddPoint(Point0+(PointDir*double(PointNp)));
 }
 
 //==============================================================================
-/// Calculates surface water level at indicated points (on CPU).
+/// Looks for the change of fluid to empty on the coarse points and adds the
+/// points of the line in that interval to the refinement JGaugeBatch.
+/// Returns the number of added points.
 //==============================================================================
-template<TpKernel tker> void JGaugeSwl::CalculeCpuT(double timestep
-  ,const StDivDataCpu &dvd,unsigned npbok,unsigned npb,unsigned np
-  ,const tdouble3 *pos,const typecode *code,const unsigned *idp,const tfloat4 *velrhop)
-{
-  SetTimeStep(timestep);
+unsigned JGaugeSwl::AddBatchRefinePoints(const JGaugeBatch &batch,JGaugeBatch &refine){
   //-Look for change of fluid to empty. | Busca paso de fluido a vacio.
-  tdouble3 ptsurf=TDouble3(DBL_MAX);
   float mpre=0;
-  tdouble3 ptpos=Point0;
-  for(unsigned cp=0;cp<=PointNp;cp++){
-    const float mass=CalculeMassCpu<tker>(ptpos,dvd,pos,code,velrhop);
-    if(mass>MassLimit)mpre=mass;
-    if(mass<MassLimit && mpre){
-      const float fxm1=(MassLimit-mpre)/(mass-mpre)-1;
-      ptsurf=ptpos+(PointDir*double(fxm1));
-      cp=PointNp+1;
+  unsigned cpre=0;
+  unsigned cfound=UINT_MAX;
+  const unsigned ncoarse=PointNp/CoarseStep+(PointNp%CoarseStep? 2: 1);
+  for(unsigned cc=0;cc<ncoarse && cfound==UINT_MAX;cc++){
+    const unsigned cp=min(cc*CoarseStep,PointNp);
+    const float mass=float(batch.GetSums(BatchIdx+cc).summass);
+    if(mass>MassLimit){ mpre=mass; cpre=cp; }
+    if(mass<MassLimit && mpre)cfound=cp;
+  }
+  RefineIdx=UINT_MAX;
+  RefineIni=cpre;
+  RefineNp=0;
+  RefineMpre=mpre;
+  NoSurfPos=Point0+(PointDir*(mpre? PointNp: 0));
+  if(cfound!=UINT_MAX){
+    //-Adds points after the last point with fluid until the first empty point.
+    RefineNp=cfound-cpre;
+    for(unsigned cp=cpre+1;cp<=cfound;cp++){
+      const unsigned idx=refine.AddPoint(Point0+(PointDir*double(cp)));
+      if(cp==cpre+1)RefineIdx=idx;
+    }
+  }
+  return(RefineNp);
+}
+
+//==============================================================================
+/// Calculates surface water level using the masses of refinement points 
+/// computed by JGaugeBatch (on CPU). The result is the same as the search 
+/// point by point on the whole line when the distance between changes of 
+/// fluid to empty is larger than Dp.
+//==============================================================================
+void JGaugeSwl::CalculeBatchRefineCpu(double timestep,const JGaugeBatch &refine){
+  SetTimeStep(timestep);
+  tdouble3 ptsurf=NoSurfPos;
+  if(RefineNp){
+    float mpre=RefineMpre;
+    ptsurf=Point0+(PointDir*double(RefineIni+RefineNp));
+    for(unsigned c=0;c<RefineNp;c++){
+      const float mass=float(refine.GetSums(RefineIdx+c).summass);
+      if(mass>MassLimit)mpre=mass;
+      if(mass<MassLimit && mpre){
+        const float fxm1=(MassLimit-mpre)/(mass-mpre)-1;
+        ptsurf=Point0+(PointDir*(double(RefineIni+1+c)+double(fxm1)));
+        break;
+      }
     }
-    ptpos=ptpos+PointDir;
   }
-  if(ptsurf.x==DBL_MAX)ptsurf=Point0+(PointDir*(mpre? PointNp: 0));
   //-Stores result. | Guarda resultado.
   Result.Set(timestep,ToTFloat3(Point0),ToTFloat3(Point2),ToTFloat3(ptsurf));
   //Log->Printf("------> t:%f",TimeStep);
@@ -594,11 +639,11 @@ void JGaugeSwl::CalculeCpu(double timestep,const StDivDataCpu &dvd
   ,unsigned npbok,unsigned npb,unsigned np,const tdouble3 *pos
   ,const typecode *code,const unsigned *idp,const tfloat4 *velrhop)
 {
-  switch(CSP.tkernel){
-    case KERNEL_Cubic:       //Kernel Wendland is used since Cubic is not available.
-    case KERNEL_Wendland:    CalculeCpuT<KERNEL_Wendland>  (timestep,dvd,npbok,npb,np,pos,code,idp,velrhop);  break;
-    default: Run_Exceptioon("Kernel unknown.");
-  }
+  JGaugeBatch batch,refine;
+  AddBatchPoints(batch);
+  batch.Calcule(CSP,dvd,pos,code,velrhop);
+  if(AddBatchRefinePoints(batch,refine))refine.Calcule(CSP,dvd,pos,code,velrhop);
+  CalculeBatchRefineCpu(timestep,refine);
 }
 #ifdef _WITHGPU
 //==============================================================================
@@ -663,13 +708,9 @@ void JGaugeMaxZ::Reset(){
 //==============================================================================
 void JGaugeMaxZ::StoreResult(){
   if(OutputSave){
-    //-Allocates memory.
-    while(unsigned(OutBuff.size())<OutSize)OutBuff.push_back(StrGaugeMaxzRes());
-    //-Empty buffer.
-    if(OutCount+1>=OutSize)SaveResults();
-    //-Stores last results.
-    OutBuff[OutCount]=Result;
-    OutCount++;
+    //-Stores last results in time series.
+    OutRec("time [s];zmax [m];posx [m];posy [m];posz [m]")
+      << Result.timestep << Result.zmax << Result.point0 << jcsv::Endl();
     //-Updates OutputNext.
     if(OutputDt){
       const unsigned nt=unsigned(TimeStep/OutputDt);
@@ -680,29 +721,10 @@ void JGaugeMaxZ::StoreResult(){
 }
 
 //==============================================================================
-/// Saves stored results in CSV file.
+/// Requests the write of stored results in CSV file.
 //==============================================================================
 void JGaugeMaxZ::SaveResults(){
-  if(OutCount){
-    const bool first=OutFile.empty();
-    if(first){
-      OutFile=GetResultsFileCsv();
-      Log->AddFileInfo(OutFile,FileInfo);
-    }
-    jcsv::JSaveCsv2 scsv(OutFile,!first,AppInfo.GetCsvSepComa());
-    //-Saves head.
-    if(first){
-      scsv.SetHead();
-      scsv << "time [s];zmax [m];posx [m];posy [m];posz [m]" << jcsv::Endl();
-    }
-    //-Saves data.
-    scsv.SetData();
-    scsv << jcsv::Fmt(jcsv::TpFloat1,"%g") << jcsv::Fmt(jcsv::TpFloat3,"%g;%g;%g");
-    for(unsigned c=0;c<OutCount;c++){
-      scsv << OutBuff[c].timestep << OutBuff[c].zmax << OutBuff[c].point0 << jcsv::Endl();
-    }
-    OutCount=0;
-  }
+  if(OutStream!=UINT_MAX)AppInfo.SeriesPtr()->Flush(OutStream);
 }
 
 //==============================================================================
@@ -902,13 +924,9 @@ void JGaugeForce::Reset(){
 //==============================================================================
 void JGaugeForce::StoreResult(){
   if(OutputSave){
-    //-Allocates memory.
-    while(unsigned(OutBuff.size())<OutSize)OutBuff.push_back(StrGaugeForceRes());
-    //-Empty buffer.
-    if(OutCount+1>=OutSize)SaveResults();
-    //-Stores last results.
-    OutBuff[OutCount]=Result;
-    OutCount++;
+    //-Stores last results in time series.
+    OutRec("time [s];force [N];forcex [N];forcey [N];forcez [N]")
+      << Result.timestep << fgeo::PointDist(Result.force) << Result.force << jcsv::Endl();
     //-Updates OutputNext.
     if(OutputDt){
       const unsigned nt=unsigned(TimeStep/OutputDt);
@@ -919,30 +937,10 @@ void JGaugeForce::StoreResult(){
 }
 
 //==============================================================================
-/// Saves stored results in CSV file.
+/// Requests the write of stored results in CSV file.
 //==============================================================================
 void JGaugeForce::SaveResults(){
-  if(OutCount){
-    const bool first=OutFile.empty();
-    if(first){
-      OutFile=GetResultsFileCsv();
-      Log->AddFileInfo(OutFile,FileInfo);
-    }
-    jcsv::JSaveCsv2 scsv(OutFile,!first,AppInfo.GetCsvSepComa());
-    //-Saves head.
-    if(first){
-      //-Head of values.
-      scsv.SetHead();
-      scsv <<"time [s];force [N];forcex [N];forcey [N];forcez [N]" << jcsv::Endl();
-    }
-    //-Saves data.
-    scsv.SetData();
-    scsv << jcsv::Fmt(jcsv::TpFloat1,"%g") << jcsv::Fmt(jcsv::TpFloat3,"%g;%g;%g");
-    for(unsigned c=0;c<OutCount;c++){
-      scsv << OutBuff[c].timestep << fgeo::PointDist(OutBuff[c].force) << OutBuff[c].force << jcsv::Endl();
-    }
-    OutCount=0;
-  }
+  if(OutStream!=UINT_MAX)AppInfo.SeriesPtr()->Flush(OutStream);
 }
 
 //==============================================================================
@@ -1079,5 +1077,465 @@ void JGaugeForce::CalculeGpu(double timestep,const StDivDataGpu &dvd
 #endif
 
 
+//##############################################################################
+//# JGaugeCloud
+//##############################################################################
+//==============================================================================
+/// Constructor.
+/// When outsteps is zero, the number of steps per chunk is limited by the
+/// size of the output buffer (64 MB) and OutSize.
+//==============================================================================
+JGaugeCloud::JGaugeCloud(unsigned idx,std::string name,const std::vector<tdouble3> &points
+  ,const std::string &pointsdef,unsigned outsteps,bool cpu,JLog2* log)
+  :JGaugeItem(GAUGE_Cloud,idx,name,cpu,log)
+{
+  ClassName="JGaugeCloud";
+  FileInfo=string("Saves velocity, density and pressure measured on a cloud of points (by ")+ClassName+").";
+  OutBin=NULL;
+  Reset();
+  Points=points;
+  PointsDef=pointsdef;
+  const unsigned np=GetNp();
+  const size_t sizebuff=size_t(64)*1024*1024;
+  const size_t sizestep=sizeof(float)*NVAR*max(np,1u);
+  OutSteps=(outsteps? outsteps: unsigned(max(size_t(1),min(size_t(OutSize),sizebuff/sizestep))));
+  ResData.assign(size_t(np)*NVAR,0);
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JGaugeCloud::~JGaugeCloud(){
+  DestructorActive=true;
+  Reset();
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JGaugeCloud::Reset(){
+  delete OutBin; OutBin=NULL;
+  Points.clear();
+  PointsDef="";
+  PointBatch.clear();
+  ResTimestep=0;
+  ResData.clear();
+  OutSteps=0;
+  OutTimes.clear();
+  OutData.clear();
+  JGaugeItem::Reset();
+}
+
+//==============================================================================
+/// Clears the last measure result.
+//==============================================================================
+void JGaugeCloud::ClearResult(){
+  ResTimestep=0;
+  ResData.assign(ResData.size(),0);
+}
+
+//==============================================================================
+/// Record the last measure result. The chunk is saved when it is full.
+//==============================================================================
+void JGaugeCloud::StoreResult(){
+  if(OutputSave){
+    //-Allocates memory.
+    if(OutData.capacity()<ResData.size()*OutSteps)OutData.reserve(ResData.size()*OutSteps);
+    //-Stores last results.
+    OutTimes.push_back(ResTimestep);
+    OutData.insert(OutData.end(),ResData.begin(),ResData.end());
+    OutCount++;
+    //-Saves full chunk.
+    if(OutCount>=OutSteps)SaveResults();
+    //-Updates OutputNext.
+    if(OutputDt){
+      const unsigned nt=unsigned(TimeStep/OutputDt);
+      OutputNext=OutputDt*nt;
+      if(OutputNext<=TimeStep)OutputNext=OutputDt*(nt+1);
+    }
+  }
+}
+
+//==============================================================================
+/// Returns filename for output results in binary file.
+//==============================================================================
+std::string JGaugeCloud::GetResultsFileBin()const{
+  return(AppInfo.GetDirOut()+"Gauges"+GetNameType(Type)+"_"+Name+".gcb");
+}
+
+//==============================================================================
+/// Appends stored results to binary file.
+//==============================================================================
+void JGaugeCloud::SaveResults(){
+  if(OutCount){
+    if(!OutBin){
+      OutFile=GetResultsFileBin();
+      Log->AddFileInfo(OutFile,FileInfo);
+      OutBin=new JGaugeCloudFileSave(OutFile,GetNp(),(Points.empty()? NULL: &Points[0]),NVAR);
+    }
+    OutBin->AddChunk(OutCount,&OutTimes[0],(OutData.empty()? NULL: &OutData[0]));
+    OutTimes.clear();
+    OutData.clear();
+    OutCount=0;
+  }
+}
+
+//==============================================================================
+/// Saves last result in VTK file.
+//==============================================================================
+void JGaugeCloud::SaveVtkResult(unsigned cpart){
+  if(JVtkLib::Available()){
+    const unsigned np=GetNp();
+    tfloat3 *vpos  =new tfloat3[np];
+    tfloat3 *vvel  =new tfloat3[np];
+    float   *vrhop =new float[np];
+    float   *vpress=new float[np];
+    for(unsigned p=0;p<np;p++){
+      const float *r=&ResData[size_t(p)*NVAR];
+      vpos[p]=ToTFloat3(Points[p]);
+      vvel[p]=TFloat3(r[0],r[1],r[2]);
+      vrhop[p]=r[3];
+      vpress[p]=r[4];
+    }
+    JDataArrays arrays;
+    arrays.AddArray("Pos",np,vpos,true);
+    arrays.AddArray("Vel",np,vvel,true);
+    arrays.AddArray("Rhop",np,vrhop,true);
+    arrays.AddArray("Press",np,vpress,true);
+    Log->AddFileInfo(fun::FileNameSec(GetResultsFileVtk(),UINT_MAX),FileInfo);
+    JVtkLib::SaveVtkData(fun::FileNameSec(GetResultsFileVtk(),cpart),arrays,"Pos");
+  }
+}
+
+//==============================================================================
+/// Loads and returns number definition points.
+//==============================================================================
+unsigned JGaugeCloud::GetPointDef(std::vector<tfloat3> &points)const{
+  const unsigned np=GetNp();
+  for(unsigned p=0;p<np;p++)points.push_back(ToTFloat3(Points[p]));
+  return(np);
+}
+
+//==============================================================================
+/// Adds the points within the domain to JGaugeBatch.
+//==============================================================================
+void JGaugeCloud::AddBatchPoints(JGaugeBatch &batch){
+  batch.RequestRhopPress();
+  const unsigned np=GetNp();
+  PointBatch.resize(np);
+  for(unsigned p=0;p<np;p++){
+    const tdouble3 ps=Points[p];
+    PointBatch[p]=(PointIsOut(ps.x,ps.y,ps.z)? UINT_MAX: batch.AddPoint(ps));
+  }
+}
+
+//==============================================================================
+/// Computes Shepard-corrected values using the kernel sums of JGaugeBatch
+/// (on CPU).
+//==============================================================================
+void JGaugeCloud::CalculeBatchCpu(double timestep,const JGaugeBatch &batch){
+  SetTimeStep(timestep);
+  const int np=int(GetNp());
+  float *res=(ResData.empty()? NULL: &ResData[0]);
+  #ifdef OMP_USE
+    #pragma omp parallel for schedule (static) if(np>OMP_LIMIT_COMPUTELIGHT)
+  #endif
+  for(int p=0;p<np;p++){
+    float *r=res+size_t(p)*NVAR;
+    const unsigned cb=PointBatch[p];
+    const JGaugeBatch::StSums *s=(cb!=UINT_MAX? &batch.GetSums(cb): NULL);
+    if(s && s->sumwab>0){
+      r[0]=float(s->sumvel.x/s->sumwab);
+      r[1]=float(s->sumvel.y/s->sumwab);
+      r[2]=float(s->sumvel.z/s->sumwab);
+      r[3]=float(s->sumrhop/s->sumwab);
+      r[4]=float(s->sumpress/s->sumwab);
+    }
+    else for(unsigned cv=0;cv<NVAR;cv++)r[cv]=0;
+  }
+  //-Stores result. | Guarda resultado.
+  ResTimestep=timestep;
+  if(Output(timestep))StoreResult();
+}
+
+//==============================================================================
+/// Calculates velocity, density and pressure at the points (on CPU).
+//==============================================================================
+void JGaugeCloud::CalculeCpu(double timestep,const StDivDataCpu &dvd
+  ,unsigned npbok,unsigned npb,unsigned np,const tdouble3 *pos
+  ,const typecode *code,const unsigned *idp,const tfloat4 *velrhop)
+{
+  JGaugeBatch batch;
+  AddBatchPoints(batch);
+  batch.Calcule(CSP,dvd,pos,code,velrhop);
+  CalculeBatchCpu(timestep,batch);
+}
+
+#ifdef _WITHGPU
+//==============================================================================
+/// Calculates velocity, density and pressure at the points (on GPU).
+//==============================================================================
+void JGaugeCloud::CalculeGpu(double timestep,const StDivDataGpu &dvd
+  ,unsigned npbok,unsigned npb,unsigned np,const double2 *posxy,const double *posz
+  ,const typecode *code,const unsigned *idp,const float4 *velrhop,float3 *aux)
+{
+  Run_Exceptioon("Gauge of cloud of points is not available on GPU.");
+}
+#endif
+
+
+//##############################################################################
+//# JGaugeSection
+//##############################################################################
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JGaugeSection::JGaugeSection(unsigned idx,std::string name,bool plane
+  ,const std::vector<tdouble3> &defpoints,double dp,bool cpu,JLog2* log)
+  :JGaugeItem(GAUGE_Section,idx,name,cpu,log)
+{
+  ClassName="JGaugeSection";
+  FileInfo=string("Saves velocity, density and pressure measured on a section (by ")+ClassName+").";
+  Reset();
+  Plane=plane;
+  DefPoints=defpoints;
+  Dp=dp;
+  ComputePoints();
+  ResData.assign(size_t(GetNp())*NVAR,0);
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JGaugeSection::~JGaugeSection(){
+  DestructorActive=true;
+  Reset();
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JGaugeSection::Reset(){
+  Plane=false;
+  DefPoints.clear();
+  Dp=0;
+  PlaneSize=TUint2(0);
+  Points.clear();
+  Conn.clear();
+  PointBatch.clear();
+  ResTimestep=0;
+  ResData.clear();
+  OutFiles.clear();
+  OutTimes.clear();
+  JGaugeItem::Reset();
+}
+
+//==============================================================================
+/// Computes sampling points and connectivity of cells. The number of points
+/// on each edge or segment is computed as in the grids of JGaugeCloud.
+//==============================================================================
+void JGaugeSection::ComputePoints(){
+  if(Dp<=0)Run_Exceptioon(fun::PrintStr("The dp (%g) of section \'%s\' is invalid.",Dp,Name.c_str()));
+  const unsigned ndef=unsigned(DefPoints.size());
+  if(Plane ? ndef!=3: ndef<2)Run_Exceptioon(fun::PrintStr("The number of definition points of section \'%s\' is invalid.",Name.c_str()));
+  Points.clear();
+  Conn.clear();
+  const unsigned nseg=(Plane? 2: ndef-1);
+  std::vector<unsigned> counts(nseg);
+  for(unsigned cs=0;cs<nseg;cs++){
+    const double ds=fgeo::PointsDist(DefPoints[Plane? 0: cs],DefPoints[cs+1]);
+    unsigned count=unsigned(ds/Dp);
+    if(ds-(Dp*count)>=Dp*0.1)count++;
+    counts[cs]=count+1;
+  }
+  if(Plane){
+    const unsigned n1=counts[0],n2=counts[1];
+    if(n1<2 || n2<2)Run_Exceptioon(fun::PrintStr("The plane of section \'%s\' is too small for the distance between points.",Name.c_str()));
+    if(ullong(n1)*n2>=UINT_MAX/NVAR)Run_Exceptioon(fun::PrintStr("The number of points of section \'%s\' is too large.",Name.c_str()));
+    PlaneSize=TUint2(n1,n2);
+    const tdouble3 v1=(DefPoints[1]-DefPoints[0])/double(n1-1);
+    const tdouble3 v2=(DefPoints[2]-DefPoints[0])/double(n2-1);
+    Points.reserve(size_t(n1)*n2);
+    for(unsigned c2=0;c2<n2;c2++)for(unsigned c1=0;c1<n1;c1++)Points.push_back(DefPoints[0]+v1*double(c1)+v2*double(c2));
+    Conn.reserve(size_t(n1-1)*(n2-1)*4);
+    for(unsigned c2=0;c2+1<n2;c2++)for(unsigned c1=0;c1+1<n1;c1++){
+      const unsigned p=c1+c2*n1;
+      Conn.push_back(p); Conn.push_back(p+1); Conn.push_back(p+1+n1); Conn.push_back(p+n1);
+    }
+  }
+  else{
+    Points.push_back(DefPoints[0]);
+    for(unsigned cs=0;cs<nseg;cs++){
+      const unsigned n=counts[cs];
+      if(n<2)continue; //-Segment shorter than dp/10 is ignored.
+      const tdouble3 vs=(DefPoints[cs+1]-DefPoints[cs])/double(n-1);
+      for(unsigned c=1;c<n;c++){
+        Conn.push_back(unsigned(Points.size())-1);
+        Conn.push_back(unsigned(Points.size()));
+        Points.push_back(DefPoints[cs]+vs*double(c));
+      }
+    }
+    if(Points.size()<2)Run_Exceptioon(fun::PrintStr("The polyline of section \'%s\' is too small for the distance between points.",Name.c_str()));
+  }
+}
+
+//==============================================================================
+/// Clears the last measure result.
+//==============================================================================
+void JGaugeSection::ClearResult(){
+  ResTimestep=0;
+  ResData.assign(ResData.size(),0);
+}
+
+//==============================================================================
+/// Returns filename of PVD file with the list of saved files.
+//==============================================================================
+std::string JGaugeSection::GetResultsFilePvd()const{
+  return(AppInfo.GetDirDataOut()+"Gauges"+GetNameType(Type)+"_"+Name+".pvd");
+}
+
+//==============================================================================
+/// Saves the last result in one VTU file and updates the PVD file.
+//==============================================================================
+void JGaugeSection::StoreResult(){
+  if(OutputSave){
+    const string file=AppInfo.GetDirDataOut()+"Gauges"+GetNameType(Type)+"_"+Name+"_Out.vtu";
+    if(OutFiles.empty()){
+      Log->AddFileInfo(fun::FileNameSec(file,UINT_MAX),FileInfo);
+      Log->AddFileInfo(GetResultsFilePvd(),"Saves list of files of section with their times (by JGaugeSection).");
+    }
+    const string filesec=fun::FileNameSec(file,unsigned(OutFiles.size()));
+    SaveVtu(filesec);
+    OutFiles.push_back(filesec);
+    OutTimes.push_back(ResTimestep);
+    JOutputVtu ovtu;
+    ovtu.SavePvd(GetResultsFilePvd(),OutFiles,OutTimes);
+    //-Updates OutputNext.
+    if(OutputDt){
+      const unsigned nt=unsigned(TimeStep/OutputDt);
+      OutputNext=OutputDt*nt;
+      if(OutputNext<=TimeStep)OutputNext=OutputDt*(nt+1);
+    }
+  }
+}
+
+//==============================================================================
+/// Loads arrays with the last result.
+//==============================================================================
+void JGaugeSection::GetResultArrays(JDataArrays &arrays)const{
+  const unsigned np=GetNp();
+  tfloat3 *vpos  =new tfloat3[np];
+  tfloat3 *vvel  =new tfloat3[np];
+  float   *vrhop =new float[np];
+  float   *vpress=new float[np];
+  for(unsigned p=0;p<np;p++){
+    const float *r=&ResData[size_t(p)*NVAR];
+    vpos[p]=ToTFloat3(Points[p]);
+    vvel[p]=TFloat3(r[0],r[1],r[2]);
+    vrhop[p]=r[3];
+    vpress[p]=r[4];
+  }
+  arrays.AddArray("Pos",np,vpos,true);
+  arrays.AddArray("Vel",np,vvel,true);
+  arrays.AddArray("Rhop",np,vrhop,true);
+  arrays.AddArray("Press",np,vpress,true);
+}
+
+//==============================================================================
+/// Saves last result in VTU file with the cells of the section.
+//==============================================================================
+void JGaugeSection::SaveVtu(const std::string &file)const{
+  JDataArrays arrays;
+  GetResultArrays(arrays);
+  JOutputVtu ovtu;
+  ovtu.SaveVtuCells(file,arrays,"Pos",(Plane? 4: 2),GetNumCells(),(Conn.empty()? NULL: &Conn[0]));
+}
 
+//==============================================================================
+/// Saves last result in VTK file.
+//==============================================================================
+void JGaugeSection::SaveVtkResult(unsigned cpart){
+  if(JVtkLib::Available()){
+    JDataArrays arrays;
+    GetResultArrays(arrays);
+    Log->AddFileInfo(fun::FileNameSec(GetResultsFileVtk(),UINT_MAX),FileInfo);
+    JVtkLib::SaveVtkData(fun::FileNameSec(GetResultsFileVtk(),cpart),arrays,"Pos");
+  }
+}
+
+//==============================================================================
+/// Loads and returns number definition points.
+//==============================================================================
+unsigned JGaugeSection::GetPointDef(std::vector<tfloat3> &points)const{
+  const unsigned np=GetNp();
+  for(unsigned p=0;p<np;p++)points.push_back(ToTFloat3(Points[p]));
+  return(np);
+}
+
+//==============================================================================
+/// Adds the points within the domain to JGaugeBatch.
+//==============================================================================
+void JGaugeSection::AddBatchPoints(JGaugeBatch &batch){
+  batch.RequestRhopPress();
+  const unsigned np=GetNp();
+  PointBatch.resize(np);
+  for(unsigned p=0;p<np;p++){
+    const tdouble3 ps=Points[p];
+    PointBatch[p]=(PointIsOut(ps.x,ps.y,ps.z)? UINT_MAX: batch.AddPoint(ps));
+  }
+}
+
+//==============================================================================
+/// Computes Shepard-corrected values using the kernel sums of JGaugeBatch
+/// (on CPU).
+//==============================================================================
+void JGaugeSection::CalculeBatchCpu(double timestep,const JGaugeBatch &batch){
+  SetTimeStep(timestep);
+  const int np=int(GetNp());
+  float *res=(ResData.empty()? NULL: &ResData[0]);
+  #ifdef OMP_USE
+    #pragma omp parallel for schedule (static) if(np>OMP_LIMIT_COMPUTELIGHT)
+  #endif
+  for(int p=0;p<np;p++){
+    float *r=res+size_t(p)*NVAR;
+    const unsigned cb=PointBatch[p];
+    const JGaugeBatch::StSums *s=(cb!=UINT_MAX? &batch.GetSums(cb): NULL);
+    if(s && s->sumwab>0){
+      r[0]=float(s->sumvel.x/s->sumwab);
+      r[1]=float(s->sumvel.y/s->sumwab);
+      r[2]=float(s->sumvel.z/s->sumwab);
+      r[3]=float(s->sumrhop/s->sumwab);
+      r[4]=float(s->sumpress/s->sumwab);
+    }
+    else for(unsigned cv=0;cv<NVAR;cv++)r[cv]=0;
+  }
+  //-Stores result. | Guarda resultado.
+  ResTimestep=timestep;
+  if(Output(timestep))StoreResult();
+}
+
+//==============================================================================
+/// Calculates velocity, density and pressure on the section (on CPU).
+//==============================================================================
+void JGaugeSection::CalculeCpu(double timestep,const StDivDataCpu &dvd
+  ,unsigned npbok,unsigned npb,unsigned np,const tdouble3 *pos
+  ,const typecode *code,const unsigned *idp,const tfloat4 *velrhop)
+{
+  JGaugeBatch batch;
+  AddBatchPoints(batch);
+  batch.Calcule(CSP,dvd,pos,code,velrhop);
+  CalculeBatchCpu(timestep,batch);
+}
+
+#ifdef _WITHGPU
+//==============================================================================
+/// Calculates velocity, density and pressure on the section (on GPU).
+//==============================================================================
+void JGaugeSection::CalculeGpu(double timestep,const StDivDataGpu &dvd
+  ,unsigned npbok,unsigned npb,unsigned np,const double2 *posxy,const double *posz
+  ,const typecode *code,const unsigned *idp,const float4 *velrhop,float3 *aux)
+{
+  Run_Exceptioon("Gauge of section is not available on GPU.");
+}
+#endif
 
@@ -23,6 +23,18 @@
 //:# - Se escriben las unidades en las cabeceras de los ficheros CSV. (26-04-2018)
 //:# - Gestion de excepciones mejorada.  (15-09-2019)
 //:# - Cambio de nombre de fichero J.GaugeItem a J.DsGaugeItem. (28-06-2020)
+//:# - Calculo agrupado de los puntos de JGaugeVelocity y JGaugeSwl mediante
+//:#   JGaugeBatch (AddBatchPoints() y CalculeBatchCpu()). (19-10-2026)
+//:# - Nueva medida JGaugeCloud de velocidad, densidad y presion (con correccion
+//:#   de Shepard) en una nube de puntos grabada en un fichero binario. (19-10-2026)
+//:# - Nueva medida JGaugeSection en planos y polilineas grabada como series de
+//:#   ficheros VTU binarios con indice .pvd. (19-10-2026)
+//:# - Busqueda del nivel en JGaugeSwl en dos niveles: puntos separados Dp para
+//:#   localizar el intervalo de la superficie y refinamiento con PointDp solo
+//:#   en dicho intervalo (AddBatchRefinePoints()). (19-10-2026)
+//:# - Los resultados de JGaugeVelocity, JGaugeSwl, JGaugeMaxZ y JGaugeForce se
+//:#   graban mediante series temporales de JSeriesSink (OutRec()). (19-10-2026)
+//:# - Permite cambiar la configuracion de celdas (ConfigCells()). (19-10-2026)
 //:#############################################################################
 
 /// \file JDsGaugeItem.h \brief Declares the class \ref JGaugeItem.
@@ -32,10 +44,13 @@
 
 #include <string>
 #include <vector>
+#include <climits>
 #include "JObject.h"
 #include "DualSphDef.h"
 #include "JSaveCsv2.h"
 #include "JCellDivDataCpu.h"
+#include "JDsGaugeBatch.h"
+#include "JDsGaugeCloudFile.h"
 
 #ifdef _WITHGPU
 #include "JCellDivDataGpu.h"
@@ -53,6 +68,8 @@
 #endif
 
 class JLog2;
+class JDataArrays;
+class JSeriesRec;
 
 //##############################################################################
 //# JGaugeItem
@@ -79,6 +96,8 @@ public:
     ,GAUGE_Swl
     ,GAUGE_MaxZ
     ,GAUGE_Force
+    ,GAUGE_Cloud
+    ,GAUGE_Section
   }TpGauge;
 
   ///Structure with default configuration for JGaugeItem objects.
@@ -121,10 +140,14 @@ protected:
   //-Results of measurement.
   double TimeStep;
 
+  //-Variables for calculation using JGaugeBatch.
+  unsigned BatchIdx;                 ///<Index of first point in JGaugeBatch (UINT_MAX when it is not used).
+
   //-Variables to store the results in buffer.
   static const unsigned OutSize=200; ///<Maximum number of results in buffer.
   unsigned OutCount;                 ///<Number of stored results in buffer.
   std::string OutFile;
+  unsigned OutStream;                ///<Id of time series of results in AppInfo.SeriesPtr() (UINT_MAX when it is not created).
 
   JGaugeItem(TpGauge type,unsigned idx,std::string name,bool cpu,JLog2* log);
   void Reset();
@@ -134,6 +157,7 @@ protected:
   bool PointIsOut(double px,double py)const{ return(px!=px || py!=py || px<DomPosMin.x || py<DomPosMin.y || px>=DomPosMax.x || py>=DomPosMax.y); }
 
   static std::string GetNameType(TpGauge type);
+  JSeriesRec& OutRec(const std::string &head);
 
   virtual void ClearResult()=0;
   virtual void StoreResult()=0;
@@ -145,6 +169,7 @@ public:
 
   void Config(const StCteSph & csp,bool symmetry,tdouble3 domposmin
     ,tdouble3 domposmax,float scell,int scelldiv);
+  void ConfigCells(tdouble3 domposmin,tdouble3 domposmax,float scell,int scelldiv);
   void SetSaveVtkPart(bool save){ SaveVtkPart=save; }
   void ConfigComputeTiming(double start,double end,double dt);
   void ConfigOutputTiming(bool save,double start,double end,double dt);
@@ -174,6 +199,13 @@ public:
     ,unsigned npbok,unsigned npb,unsigned np,const tdouble3 *pos
     ,const typecode *code,const unsigned *idp,const tfloat4 *velrhop)=0;
 
+  virtual bool UseBatchCpu()const{ return(false); }
+  virtual void AddBatchPoints(JGaugeBatch &batch){ BatchIdx=UINT_MAX; }
+  virtual void CalculeBatchCpu(double timestep,const JGaugeBatch &batch){}
+  virtual bool UseBatchRefineCpu()const{ return(false); }
+  virtual unsigned AddBatchRefinePoints(const JGaugeBatch &batch,JGaugeBatch &refine){ return(0); }
+  virtual void CalculeBatchRefineCpu(double timestep,const JGaugeBatch &refine){}
+
  #ifdef _WITHGPU
   virtual void CalculeGpu(double timestep,const StDivDataGpu &dvd
     ,unsigned npbok,unsigned npb,unsigned np,const double2 *posxy,const double *posz
@@ -211,8 +243,6 @@ protected:
 
   StGaugeVelRes Result; ///<Result of the last measure.
 
-  std::vector<StGaugeVelRes> OutBuff; ///<Results in buffer.
-
   void Reset();
   void ClearResult(){ Result.Reset(); }
   void StoreResult();
@@ -238,6 +268,10 @@ public:
     ,unsigned npbok,unsigned npb,unsigned np,const tdouble3 *pos
     ,const typecode *code,const unsigned *idp,const tfloat4 *velrhop);
 
+  bool UseBatchCpu()const{ return(true); }
+  void AddBatchPoints(JGaugeBatch &batch);
+  void CalculeBatchCpu(double timestep,const JGaugeBatch &batch);
+
  #ifdef _WITHGPU
   void CalculeGpu(double timestep,const StDivDataGpu &dvd
     ,unsigned npbok,unsigned npb,unsigned np,const double2 *posxy,const double *posz
@@ -280,16 +314,19 @@ protected:
   //-Auxiliary variables.
   unsigned PointNp;
   tdouble3 PointDir;
+  //-Variables of search in two levels.
+  unsigned CoarseStep;  ///<Number of points between coarse points (about Dp).
+  unsigned RefineIdx;   ///<Index of first refinement point in JGaugeBatch (UINT_MAX when it is not used).
+  unsigned RefineIni;   ///<Last point with fluid before the coarse interval with the surface.
+  unsigned RefineNp;    ///<Number of refinement points (0 when the surface was not found).
+  float RefineMpre;     ///<Mass at point RefineIni.
+  tdouble3 NoSurfPos;   ///<Result when the surface was not found.
 
   StGaugeSwlRes Result; ///<Result of the last measure.
 
-  std::vector<StGaugeSwlRes> OutBuff; ///<Results in buffer.
-
   void Reset();
   void ClearResult(){ Result.Reset(); }
   void StoreResult();
-  template<TpKernel tker> float CalculeMassCpu(const tdouble3 &ptpos,const StDivDataCpu &dvd
-    ,const tdouble3 *pos,const typecode *code,const tfloat4 *velrhop)const;
 
 public:
   JGaugeSwl(unsigned idx,std::string name,tdouble3 point0,tdouble3 point2,double pointdp,float masslimit,bool cpu,JLog2* log);
@@ -307,14 +344,16 @@ public:
 
   void SetPoints(const tdouble3 &point0,const tdouble3 &point2,double pointdp);
 
-  template<TpKernel tker> void CalculeCpuT(double timestep,const StDivDataCpu &dvd
-    ,unsigned npbok,unsigned npb,unsigned np,const tdouble3 *pos
-    ,const typecode *code,const unsigned *idp,const tfloat4 *velrhop);
-
    void CalculeCpu(double timestep,const StDivDataCpu &dvd
     ,unsigned npbok,unsigned npb,unsigned np,const tdouble3 *pos
     ,const typecode *code,const unsigned *idp,const tfloat4 *velrhop);
 
+  bool UseBatchCpu()const{ return(true); }
+  void AddBatchPoints(JGaugeBatch &batch);
+  bool UseBatchRefineCpu()const{ return(true); }
+  unsigned AddBatchRefinePoints(const JGaugeBatch &batch,JGaugeBatch &refine);
+  void CalculeBatchRefineCpu(double timestep,const JGaugeBatch &refine);
+
  #ifdef _WITHGPU
   void CalculeGpu(double timestep,const StDivDataGpu &dvd
     ,unsigned npbok,unsigned npb,unsigned np,const double2 *posxy,const double *posz
@@ -355,8 +394,6 @@ protected:
 
   StGaugeMaxzRes Result; ///<Result of the last measure.
 
-  std::vector<StGaugeMaxzRes> OutBuff; ///<Results in buffer.
-
   void Reset();
   void ClearResult(){ Result.Reset(); }
   void StoreResult();
@@ -433,8 +470,6 @@ protected:
 
   StGaugeForceRes Result; ///<Result of the last measure.
 
-  std::vector<StGaugeForceRes> OutBuff; ///<Results in buffer.
-
   void Reset();
   void ClearResult(){ Result.Reset(); }
   void StoreResult();
@@ -472,6 +507,146 @@ public:
 };
 
 
-#endif
+//##############################################################################
+//# JGaugeCloud
+//##############################################################################
+/// \brief Calculates velocity, density and pressure on a cloud of points in fluid domain.
+///
+/// The values are interpolated with Shepard correction (zero when there is no
+/// fluid around the point) and all the points are computed by JGaugeBatch.
+/// The results are stored in chunks of OutSteps time steps that are appended
+/// to a binary file (JGaugeCloudFileSave).
+class JGaugeCloud : public JGaugeItem
+{
+public:
+  static const unsigned NVAR=5; ///<Number of values per point: velx,vely,velz,rhop,press.
+
+protected:
+  //-Definition.
+  std::vector<tdouble3> Points;
+  std::string PointsDef;         ///<Description of points definition.
+
+  //-Auxiliary variables.
+  std::vector<unsigned> PointBatch; ///<Index of each point in JGaugeBatch (UINT_MAX for points out of domain).
+
+  double ResTimestep;            ///<Time of the last measure.
+  std::vector<float> ResData;    ///<Values of the last measure [Np*NVAR].
+
+  unsigned OutSteps;             ///<Number of time steps in each chunk of output file.
+  std::vector<double> OutTimes;  ///<Times of results in buffer [OutCount].
+  std::vector<float> OutData;    ///<Results in buffer [OutCount*Np*NVAR].
+  JGaugeCloudFileSave *OutBin;   ///<Output binary file.
+
+  void Reset();
+  void ClearResult();
+  void StoreResult();
+
+public:
+  JGaugeCloud(unsigned idx,std::string name,const std::vector<tdouble3> &points
+    ,const std::string &pointsdef,unsigned outsteps,bool cpu,JLog2* log);
+  ~JGaugeCloud();
+
+  void SaveResults();
+  void SaveVtkResult(unsigned cpart);
+  unsigned GetPointDef(std::vector<tfloat3> &points)const;
+  std::string GetResultsFileBin()const;
+
+  unsigned GetNp()const{ return(unsigned(Points.size())); }
+  std::string GetPointsDef()const{ return(PointsDef); }
+  unsigned GetOutSteps()const{ return(OutSteps); }
+  double GetResultTime()const{ return(ResTimestep); }
+  const float* GetResultData()const{ return(ResData.empty()? NULL: &ResData[0]); }
+
+  void CalculeCpu(double timestep,const StDivDataCpu &dvd
+    ,unsigned npbok,unsigned npb,unsigned np,const tdouble3 *pos
+    ,const typecode *code,const unsigned *idp,const tfloat4 *velrhop);
+
+  bool UseBatchCpu()const{ return(true); }
+  void AddBatchPoints(JGaugeBatch &batch);
+  void CalculeBatchCpu(double timestep,const JGaugeBatch &batch);
+
+ #ifdef _WITHGPU
+  void CalculeGpu(double timestep,const StDivDataGpu &dvd
+    ,unsigned npbok,unsigned npb,unsigned np,const double2 *posxy,const double *posz
+    ,const typecode *code,const unsigned *idp,const float4 *velrhop,float3 *aux);
+ #endif
+};
+
+
+//##############################################################################
+//# JGaugeSection
+//##############################################################################
+/// \brief Calculates velocity, density and pressure on planar sections and polylines.
+///
+/// The points are generated with a distance close to dp between them. A plane
+/// is defined by point0 and the ends of its two edges (point1 and point2) and
+/// a polyline by its vertices. The values are interpolated with Shepard
+/// correction using JGaugeBatch and each output time is saved in a binary VTU
+/// file (quads for planes and lines for polylines) listed in a PVD file.
+class JGaugeSection : public JGaugeItem
+{
+public:
+  static const unsigned NVAR=5; ///<Number of values per point: velx,vely,velz,rhop,press.
+
+protected:
+  //-Definition.
+  bool Plane;                    ///<Planar section (otherwise polyline).
+  std::vector<tdouble3> DefPoints; ///<Points of definition (point0,point1,point2 or vertices of polyline).
+  double Dp;                     ///<Requested distance between points.
+  tuint2 PlaneSize;              ///<Number of points in each direction of plane.
+  std::vector<tdouble3> Points;  ///<Sampling points.
+  std::vector<unsigned> Conn;    ///<Connectivity of cells (quads or lines).
+
+  //-Auxiliary variables.
+  std::vector<unsigned> PointBatch; ///<Index of each point in JGaugeBatch (UINT_MAX for points out of domain).
+
+  double ResTimestep;            ///<Time of the last measure.
+  std::vector<float> ResData;    ///<Values of the last measure [Np*NVAR].
+
+  std::vector<std::string> OutFiles; ///<Saved files of time series.
+  std::vector<double> OutTimes;      ///<Times of saved files.
+
+  void Reset();
+  void ClearResult();
+  void StoreResult();
+  void ComputePoints();
+  void GetResultArrays(JDataArrays &arrays)const;
+  void SaveVtu(const std::string &file)const;
 
+public:
+  JGaugeSection(unsigned idx,std::string name,bool plane,const std::vector<tdouble3> &defpoints
+    ,double dp,bool cpu,JLog2* log);
+  ~JGaugeSection();
+
+  void SaveResults(){}
+  void SaveVtkResult(unsigned cpart);
+  unsigned GetPointDef(std::vector<tfloat3> &points)const;
+  std::string GetResultsFilePvd()const;
+
+  bool IsPlane()const{ return(Plane); }
+  double GetDp()const{ return(Dp); }
+  tuint2 GetPlaneSize()const{ return(PlaneSize); }
+  const std::vector<tdouble3>& GetDefPoints()const{ return(DefPoints); }
+  unsigned GetNp()const{ return(unsigned(Points.size())); }
+  unsigned GetNumCells()const{ return(unsigned(Conn.size())/(Plane? 4: 2)); }
+  double GetResultTime()const{ return(ResTimestep); }
+  const float* GetResultData()const{ return(ResData.empty()? NULL: &ResData[0]); }
+
+  void CalculeCpu(double timestep,const StDivDataCpu &dvd
+    ,unsigned npbok,unsigned npb,unsigned np,const tdouble3 *pos
+    ,const typecode *code,const unsigned *idp,const tfloat4 *velrhop);
+
+  bool UseBatchCpu()const{ return(true); }
+  void AddBatchPoints(JGaugeBatch &batch);
+  void CalculeBatchCpu(double timestep,const JGaugeBatch &batch);
+
+ #ifdef _WITHGPU
+  void CalculeGpu(double timestep,const StDivDataGpu &dvd
+    ,unsigned npbok,unsigned npb,unsigned np,const double2 *posxy,const double *posz
+    ,const typecode *code,const unsigned *idp,const float4 *velrhop,float3 *aux);
+ #endif
+};
+
+
+#endif
 
@@ -28,6 +28,7 @@
 #include "JSphMk.h"
 #include "JDataArrays.h"
 #include "JVtkLib.h"
+#include "JReadDatafile.h"
 #include <cfloat>
 #include <climits>
 #include <algorithm>
@@ -45,6 +46,8 @@ using namespace std;
 //==============================================================================
 JGaugeSystem::JGaugeSystem(bool cpu,JLog2* log):Cpu(cpu),Log(log){
   ClassName="JGaugeSystem";
+  BatchCpu=(cpu? new JGaugeBatch(): NULL);
+  BatchRefineCpu=(cpu? new JGaugeBatch(): NULL);
  #ifdef _WITHGPU
   AuxMemoryg=NULL;
  #endif
@@ -57,6 +60,8 @@ JGaugeSystem::JGaugeSystem(bool cpu,JLog2* log):Cpu(cpu),Log(log){
 JGaugeSystem::~JGaugeSystem(){
   DestructorActive=true;
   Reset();
+  delete BatchCpu; BatchCpu=NULL;
+  delete BatchRefineCpu; BatchRefineCpu=NULL;
 }
 
 //==============================================================================
@@ -73,6 +78,8 @@ void JGaugeSystem::Reset(){
   ResetCfgDefault();
   for(unsigned c=0;c<Gauges.size();c++)delete Gauges[c];
   Gauges.clear();
+  if(BatchCpu)BatchCpu->Reset();
+  if(BatchRefineCpu)BatchRefineCpu->Reset();
  #ifdef _WITHGPU
   if(AuxMemoryg)cudaFree(AuxMemoryg); AuxMemoryg=NULL;
  #endif
@@ -114,6 +121,18 @@ void JGaugeSystem::Config(const StCteSph & csp,bool symmetry,double timemax,doub
   Configured=true;
 }
 
+//==============================================================================
+/// Updates domain limits and cell configuration of the system and of all
+/// gauges when the cell division changes during the simulation.
+//==============================================================================
+void JGaugeSystem::ConfigCells(tdouble3 posmin,tdouble3 posmax,float scell,int scelldiv){
+  DomPosMin=posmin;
+  DomPosMax=posmax;
+  Scell=scell;
+  ScellDiv=scelldiv;
+  for(unsigned cg=0;cg<GetCount();cg++)Gauges[cg]->ConfigCells(DomPosMin,DomPosMax,Scell,ScellDiv);
+}
+
 //==============================================================================
 /// Loads initial conditions of XML object.
 //==============================================================================
@@ -180,6 +199,48 @@ void JGaugeSystem::LoadPoints(JXml *sxml,TiXmlElement* lis,std::vector<tdouble3>
 
 }
 
+//==============================================================================
+/// Loads points of regular grid between point1 and point2 with distance dp.
+/// The points are ordered by x, y and z.
+//==============================================================================
+void JGaugeSystem::LoadGridPoints(const tdouble3 &point1,const tdouble3 &point2
+  ,double dp,std::vector<tdouble3> &points,const std::string &ref)const
+{
+  if(dp<=0)Run_ExceptioonFile(fun::PrintStr("The dp (%g) of grid is invalid.",dp),ref);
+  const tdouble3 dis=point2-point1;
+  if(dis.x<0 || dis.y<0 || dis.z<0)Run_ExceptioonFile("The point2 of grid must be greater than or equal to point1.",ref);
+  //-Computes number of points and distance in each direction.
+  tuint3 n;
+  tdouble3 dpg;
+  for(unsigned c=0;c<3;c++){
+    const double ds=(!c? dis.x: (c==1? dis.y: dis.z));
+    unsigned count=unsigned(ds/dp);
+    if(ds-(dp*count)>=dp*0.1)count++;
+    count++;
+    const double dpc=(count>1? ds/(count-1): 0);
+    if(!c){ n.x=count; dpg.x=dpc; }
+    else if(c==1){ n.y=count; dpg.y=dpc; }
+    else{ n.z=count; dpg.z=dpc; }
+  }
+  const ullong np=ullong(n.x)*n.y*n.z;
+  if(points.size()+np>UINT_MAX)Run_ExceptioonFile("The number of points of grid is too large.",ref);
+  points.reserve(size_t(points.size()+np));
+  for(unsigned cz=0;cz<n.z;cz++)for(unsigned cy=0;cy<n.y;cy++)for(unsigned cx=0;cx<n.x;cx++){
+    points.push_back(TDouble3(point1.x+dpg.x*cx,point1.y+dpg.y*cy,point1.z+dpg.z*cz));
+  }
+}
+
+//==============================================================================
+/// Loads points from CSV file with values x;y;z in each line.
+//==============================================================================
+void JGaugeSystem::LoadFilePoints(const std::string &file,std::vector<tdouble3> &points)const{
+  JReadDatafile rdat;
+  rdat.LoadFile(file);
+  const unsigned rows=rdat.Lines()-rdat.RemLines();
+  points.reserve(points.size()+rows);
+  for(unsigned r=0;r<rows;r++)points.push_back(rdat.ReadNextDouble3());
+}
+
 //==============================================================================
 /// Reads list of initial conditions in the XML node.
 //==============================================================================
@@ -264,6 +325,66 @@ void JGaugeSystem::ReadXml(const JXml *sxml,TiXmlElement* lis,const JSphMk* mkin
           const word mkbound=(word)sxml->ReadElementUnsigned(ele,"target","mkbound");
           gau=AddGaugeForce(name,cfg.computestart,cfg.computeend,cfg.computedt,mkinfo,mkbound);
         }
+        else if(cmd=="cloud"){
+          std::vector<tdouble3> points;
+          string pointsdef;
+          //-Loads points from files.
+          const string dircase=fun::GetDirWithSlash(fun::GetDirParent(sxml->FileReading));
+          TiXmlElement* elep=ele->FirstChildElement("pointsfile");
+          while(elep){
+            const string file=sxml->GetAttributeStr(elep,"file");
+            LoadFilePoints(dircase+file,points);
+            pointsdef=pointsdef+(pointsdef.empty()? "": ", ")+"file:"+file;
+            elep=elep->NextSiblingElement("pointsfile");
+          }
+          //-Loads points of regular grids.
+          elep=ele->FirstChildElement("grid");
+          while(elep){
+            const tdouble3 pt1=sxml->ReadElementDouble3(elep,"point1");
+            const tdouble3 pt2=sxml->ReadElementDouble3(elep,"point2");
+            double dp=0;
+            switch(sxml->CheckElementAttributes(elep,"dp","value coefdp",true,true)){
+              case 0:
+              case 1:  dp=sxml->ReadElementDouble(elep,"dp","value");          break;
+              case 2:  dp=CSP.dp*sxml->ReadElementDouble(elep,"dp","coefdp");  break;
+            }
+            LoadGridPoints(pt1,pt2,dp,points,sxml->ErrGetFileRow(elep));
+            pointsdef=pointsdef+(pointsdef.empty()? "": ", ")+"grid:"+fun::Double3gRangeStr(pt1,pt2)+fun::PrintStr(" dp:%g",dp);
+            elep=elep->NextSiblingElement("grid");
+          }
+          if(points.empty())Run_ExceptioonFile("There are no points defined for the gauge.",sxml->ErrGetFileRow(ele));
+          const unsigned outsteps=sxml->ReadElementUnsigned(ele,"outputsteps","value",true,0);
+          gau=AddGaugeCloud(name,cfg.computestart,cfg.computeend,cfg.computedt,points,pointsdef,outsteps);
+        }
+        else if(cmd=="section"){
+          //-Reads plane (point0 and ends of edges) or vertices of polyline.
+          TiXmlElement* elep=ele->FirstChildElement("plane");
+          TiXmlElement* elel=ele->FirstChildElement("polyline");
+          if((elep!=NULL)==(elel!=NULL))Run_ExceptioonFile("The section must be defined by one <plane> or one <polyline>.",sxml->ErrGetFileRow(ele));
+          std::vector<tdouble3> defpoints;
+          if(elep){
+            defpoints.push_back(sxml->ReadElementDouble3(elep,"point0"));
+            defpoints.push_back(sxml->ReadElementDouble3(elep,"point1"));
+            defpoints.push_back(sxml->ReadElementDouble3(elep,"point2"));
+          }
+          else{
+            TiXmlElement* elept=elel->FirstChildElement("point");
+            while(elept){
+              defpoints.push_back(sxml->GetAttributeDouble3(elept));
+              elept=elept->NextSiblingElement("point");
+            }
+            if(defpoints.size()<2)Run_ExceptioonFile("The polyline needs two or more points.",sxml->ErrGetFileRow(elel));
+          }
+          //-Reads distance between points.
+          double dp=0;
+          switch(sxml->CheckElementAttributes(ele,"dp","value coefdp",true,true)){
+            case 0:  dp=CSP.dp;                                          break;
+            case 1:  dp=sxml->ReadElementDouble(ele,"dp","value");       break;
+            case 2:  dp=CSP.dp*sxml->ReadElementDouble(ele,"dp","coefdp");  break;
+          }
+          if(dp<=0)Run_ExceptioonFile(fun::PrintStr("The dp (%g) is invalid.",dp),sxml->ErrGetFileRow(ele));
+          gau=AddGaugeSection(name,cfg.computestart,cfg.computeend,cfg.computedt,elep!=NULL,defpoints,dp);
+        }
         else Run_ExceptioonFile(fun::PrintStr("Gauge type \'%s\' is invalid.",cmd.c_str()),sxml->ErrGetFileRow(ele));
         gau->SetSaveVtkPart(cfg.savevtkpart);
         //gau->ConfigComputeTiming(cfg.computestart,cfg.computeend,cfg.computedt);
@@ -359,6 +480,45 @@ JGaugeForce* JGaugeSystem::AddGaugeForce(std::string name,double computestart
   return(gau);
 }
 
+//==============================================================================
+/// Creates new gauge-Cloud and returns pointer.
+//==============================================================================
+JGaugeCloud* JGaugeSystem::AddGaugeCloud(std::string name,double computestart
+  ,double computeend,double computedt,const std::vector<tdouble3> &points
+  ,const std::string &pointsdef,unsigned outsteps)
+{
+  if(GetGaugeIdx(name)!=UINT_MAX)Run_Exceptioon(fun::PrintStr("The name \'%s\' already exists.",name.c_str()));
+  if(!Cpu)Run_Exceptioon(fun::PrintStr("The gauge \'%s\' of cloud of points is only available on CPU.",name.c_str()));
+  //-Creates object.
+  JGaugeCloud* gau=new JGaugeCloud(GetCount(),name,points,pointsdef,outsteps,Cpu,Log);
+  gau->Config(CSP,Symmetry,DomPosMin,DomPosMax,Scell,ScellDiv);
+  gau->ConfigComputeTiming(computestart,computeend,computedt);
+  //-Uses common configuration.
+  gau->SetSaveVtkPart(CfgDefault.savevtkpart);
+  gau->ConfigOutputTiming(CfgDefault.output,CfgDefault.outputstart,CfgDefault.outputend,CfgDefault.outputdt);
+  Gauges.push_back(gau);
+  return(gau);
+}
+
+//==============================================================================
+/// Creates new gauge-Section and returns pointer.
+//==============================================================================
+JGaugeSection* JGaugeSystem::AddGaugeSection(std::string name,double computestart
+  ,double computeend,double computedt,bool plane,const std::vector<tdouble3> &defpoints,double dp)
+{
+  if(GetGaugeIdx(name)!=UINT_MAX)Run_Exceptioon(fun::PrintStr("The name \'%s\' already exists.",name.c_str()));
+  if(!Cpu)Run_Exceptioon(fun::PrintStr("The gauge \'%s\' of section is only available on CPU.",name.c_str()));
+  //-Creates object.
+  JGaugeSection* gau=new JGaugeSection(GetCount(),name,plane,defpoints,dp,Cpu,Log);
+  gau->Config(CSP,Symmetry,DomPosMin,DomPosMax,Scell,ScellDiv);
+  gau->ConfigComputeTiming(computestart,computeend,computedt);
+  //-Uses common configuration.
+  gau->SetSaveVtkPart(CfgDefault.savevtkpart);
+  gau->ConfigOutputTiming(CfgDefault.output,CfgDefault.outputstart,CfgDefault.outputend,CfgDefault.outputdt);
+  Gauges.push_back(gau);
+  return(gau);
+}
+
 //==============================================================================
 /// Shows object configuration using Log.
 //==============================================================================
@@ -441,16 +601,43 @@ JGaugeItem* JGaugeSystem::GetGauge(unsigned c)const{
 
 //==============================================================================
 /// Updates results on gauges (on CPU).
+/// The points of active gauges with batch support (velocity and SWL) are 
+/// computed together by JGaugeBatch and the results are assigned to each gauge.
+/// SWL gauges use coarse points in the first JGaugeBatch and the points of the
+/// interval with the surface are computed together in a second JGaugeBatch.
 //==============================================================================
 void JGaugeSystem::CalculeCpu(double timestep,bool svpart,const StDivDataCpu &dvd
   ,unsigned npbok,unsigned npb,unsigned np,const tdouble3 *pos
   ,const typecode *code,const unsigned *idp,const tfloat4 *velrhop)
 {
   const unsigned ng=GetCount();
+  //-Collects points of active gauges with batch support.
+  unsigned nbatch=0;
+  BatchCpu->ClearPoints();
+  for(unsigned cg=0;cg<ng;cg++){
+    JGaugeItem* gau=Gauges[cg];
+    if(gau->UseBatchCpu() && gau->Update(timestep)){
+      gau->AddBatchPoints(*BatchCpu);
+      nbatch++;
+    }
+  }
+  //-Computes all points.
+  if(nbatch)BatchCpu->Calcule(CSP,dvd,pos,code,velrhop);
+  //-Collects and computes refinement points of gauges with search in two levels (SWL).
+  unsigned nrefine=0;
+  BatchRefineCpu->ClearPoints();
+  for(unsigned cg=0;cg<ng;cg++){
+    JGaugeItem* gau=Gauges[cg];
+    if(gau->UseBatchRefineCpu() && gau->Update(timestep))nrefine+=gau->AddBatchRefinePoints(*BatchCpu,*BatchRefineCpu);
+  }
+  if(nrefine)BatchRefineCpu->Calcule(CSP,dvd,pos,code,velrhop);
+  //-Assigns results to gauges.
   for(unsigned cg=0;cg<ng;cg++){
     JGaugeItem* gau=Gauges[cg];
     if(gau->Update(timestep)){
-      gau->CalculeCpu(timestep,dvd,npbok,npb,np,pos,code,idp,velrhop);
+      if(gau->UseBatchRefineCpu())gau->CalculeBatchRefineCpu(timestep,*BatchRefineCpu);
+      else if(gau->UseBatchCpu())gau->CalculeBatchCpu(timestep,*BatchCpu);
+      else gau->CalculeCpu(timestep,dvd,npbok,npb,np,pos,code,idp,velrhop);
     }
   }
 }
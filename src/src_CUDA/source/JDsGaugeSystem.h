@@ -27,6 +27,15 @@
 //:# - Objeto JXml pasado como const para operaciones de lectura. (18-03-2020)  
 //:# - Comprueba opcion active en elementos de primer y segundo nivel. (18-03-2020)  
 //:# - Cambio de nombre de fichero J.GaugeSystem a J.DsGaugeSystem. (28-06-2020)
+//:# - En CPU los puntos de las medidas de velocidad y SWL se calculan juntos
+//:#   y en paralelo mediante JGaugeBatch. (19-10-2026)
+//:# - Nueva medida <cloud> en nubes de puntos definidas en fichero o por 
+//:#   rejillas regulares (JGaugeCloud). (19-10-2026)
+//:# - Nueva medida <section> en planos o polilineas (JGaugeSection). (19-10-2026)
+//:# - Segundo JGaugeBatch para refinar la busqueda de las medidas SWL en el
+//:#   intervalo de la superficie. (19-10-2026)
+//:# - Permite cambiar la configuracion de celdas durante la simulacion
+//:#   (ConfigCells()). (19-10-2026)
 //:#############################################################################
 
 /// \file JDsGaugeSystem.h \brief Declares the class \ref JGaugeSystem.
@@ -75,6 +84,10 @@ private:
   
   std::vector<JGaugeItem*> Gauges;
 
+  //-Variables for CPU.
+  JGaugeBatch* BatchCpu;  ///<Computes the points of several gauges at the same time.
+  JGaugeBatch* BatchRefineCpu; ///<Computes the refinement points of several gauges (SWL) at the same time.
+
   //-Variables for GPU.
  #ifdef _WITHGPU
   float3* AuxMemoryg;  ///<Auxiliary allocated memory on GPU [1].
@@ -85,6 +98,8 @@ private:
   void LoadLinePoints(double coefdp,const tdouble3 &point1,const tdouble3 &point2,std::vector<tdouble3> &points,const std::string &ref)const;
   void LoadLinePoints(unsigned count,const tdouble3 &point1,const tdouble3 &point2,std::vector<tdouble3> &points,const std::string &ref)const;
   void LoadPoints(JXml *sxml,TiXmlElement* lis,std::vector<tdouble3> &points)const;
+  void LoadGridPoints(const tdouble3 &point1,const tdouble3 &point2,double dp,std::vector<tdouble3> &points,const std::string &ref)const;
+  void LoadFilePoints(const std::string &file,std::vector<tdouble3> &points)const;
   JGaugeItem::StDefault ReadXmlCommon(const JXml *sxml,TiXmlElement* ele)const;
   void ReadXml(const JXml *sxml,TiXmlElement* ele,const JSphMk* mkinfo);
   void SaveVtkInitPoints()const;
@@ -96,6 +111,7 @@ public:
 
   void Config(const StCteSph & csp,bool symmetry,double timemax,double timepart
     ,tdouble3 posmin,tdouble3 posmax,float scell,int scelldiv);
+  void ConfigCells(tdouble3 posmin,tdouble3 posmax,float scell,int scelldiv);
 
   void LoadXml(const JXml *sxml,const std::string &place,const JSphMk* mkinfo);
   void VisuConfig(std::string txhead,std::string txfoot);
@@ -117,6 +133,8 @@ public:
   JGaugeSwl*      AddGaugeSwl  (std::string name,double computestart,double computeend,double computedt,tdouble3 point0,tdouble3 point2,double pointdp,float masslimit=0);
   JGaugeMaxZ*     AddGaugeMaxZ (std::string name,double computestart,double computeend,double computedt,tdouble3 point0,double height,float distlimit);
   JGaugeForce*    AddGaugeForce(std::string name,double computestart,double computeend,double computedt,const JSphMk* mkinfo,word mkbound);
+  JGaugeCloud*    AddGaugeCloud(std::string name,double computestart,double computeend,double computedt,const std::vector<tdouble3> &points,const std::string &pointsdef,unsigned outsteps=0);
+  JGaugeSection*  AddGaugeSection(std::string name,double computestart,double computeend,double computedt,bool plane,const std::vector<tdouble3> &defpoints,double dp);
 
   unsigned GetCount()const{ return(unsigned(Gauges.size())); }
   unsigned GetGaugeIdx(const std::string &name)const;
@@ -0,0 +1,378 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JDsGridStats.cpp \brief Implements the classes \ref JDsGridStatsItem and \ref JDsGridStats.
+
+#include "JDsGridStats.h"
+#include "JDsGaugeBatch.h"
+#include "JLog2.h"
+#include "JXml.h"
+#include "Functions.h"
+#include "JDataArrays.h"
+#include "JVtkLib.h"
+#include "OmpDefs.h"
+#include <cfloat>
+#include <climits>
+
+using namespace std;
+
+//##############################################################################
+//# JDsGridStatsItem
+//##############################################################################
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JDsGridStatsItem::JDsGridStatsItem(unsigned idx,const std::string &name)
+  :Idx(idx),Name(name)
+{
+  ClassName="JDsGridStatsItem";
+  Batch=NULL;
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JDsGridStatsItem::~JDsGridStatsItem(){
+  DestructorActive=true;
+  Reset();
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JDsGridStatsItem::Reset(){
+  Point1=Point2=TDouble3(0);
+  Dp=0;
+  Nodes=TUint3(0);
+  NodeDp=TDouble3(0);
+  ComputeDt=ComputeStart=ComputeEnd=ComputeNext=0;
+  SaveDt=0;
+  SaveNext=DBL_MAX;
+  Points.clear();
+  PointBatch.clear();
+  Stats.clear();
+  NumSamples=0;
+  SampleTimeIni=SampleTimeEnd=0;
+  delete Batch; Batch=NULL;
+  NumSaves=0;
+}
+
+//==============================================================================
+/// Reads configuration from the XML element of the grid.
+//==============================================================================
+void JDsGridStatsItem::ReadXml(const JXml *sxml,TiXmlElement* ele,double dp,double timemax){
+  sxml->CheckElementNames(ele,true,"point1 point2 dp computedt computetime savedt");
+  Point1=sxml->ReadElementDouble3(ele,"point1");
+  Point2=sxml->ReadElementDouble3(ele,"point2");
+  if(Point1.x>Point2.x || Point1.y>Point2.y || Point1.z>Point2.z)Run_ExceptioonFile(fun::PrintStr("The limits of grid \'%s\' are invalid.",Name.c_str()),sxml->ErrGetFileRow(ele));
+  switch(sxml->CheckElementAttributes(ele,"dp","value coefdp",true,true)){
+    case 0:
+    case 1:  Dp=sxml->ReadElementDouble(ele,"dp","value");        break;
+    case 2:  Dp=dp*sxml->ReadElementDouble(ele,"dp","coefdp");    break;
+  }
+  if(Dp<=0)Run_ExceptioonFile(fun::PrintStr("The dp (%g) of grid \'%s\' is invalid.",Dp,Name.c_str()),sxml->ErrGetFileRow(ele));
+  ComputeDt   =sxml->ReadElementDouble(ele,"computedt"  ,"value",true,0);
+  ComputeStart=sxml->ReadElementDouble(ele,"computetime","start",true,0);
+  ComputeEnd  =sxml->ReadElementDouble(ele,"computetime","end"  ,true,timemax);
+  SaveDt      =sxml->ReadElementDouble(ele,"savedt"     ,"value",true,0);
+  if(ComputeDt<0 || SaveDt<0 || ComputeEnd<ComputeStart)Run_ExceptioonFile(fun::PrintStr("The time configuration of grid \'%s\' is invalid.",Name.c_str()),sxml->ErrGetFileRow(ele));
+  ComputeNext=0;
+  SaveNext=(SaveDt>0? SaveDt: DBL_MAX);
+}
+
+//==============================================================================
+/// Computes the nodes of the grid and allocates the statistics.
+//==============================================================================
+void JDsGridStatsItem::ConfigNodes(const tdouble3 &domposmin,const tdouble3 &domposmax){
+  //-Computes number of nodes and distance in each direction.
+  const tdouble3 dis=Point2-Point1;
+  unsigned nc[3];
+  double dpc[3];
+  for(unsigned c=0;c<3;c++){
+    const double ds=(!c? dis.x: (c==1? dis.y: dis.z));
+    unsigned count=unsigned(ds/Dp);
+    if(ds-(Dp*count)>=Dp*0.1)count++;
+    count++;
+    nc[c]=count;
+    dpc[c]=(count>1? ds/(count-1): 0);
+  }
+  Nodes=TUint3(nc[0],nc[1],nc[2]);
+  NodeDp=TDouble3(dpc[0],dpc[1],dpc[2]);
+  const ullong np=ullong(Nodes.x)*Nodes.y*Nodes.z;
+  if(np*NVAR>=UINT_MAX)Run_Exceptioon(fun::PrintStr("The number of nodes of grid \'%s\' is too large.",Name.c_str()));
+  //-Computes position of nodes.
+  Points.resize(size_t(np));
+  unsigned p=0;
+  for(unsigned cz=0;cz<Nodes.z;cz++)for(unsigned cy=0;cy<Nodes.y;cy++)for(unsigned cx=0;cx<Nodes.x;cx++,p++){
+    Points[p]=TDouble3(Point1.x+NodeDp.x*cx,Point1.y+NodeDp.y*cy,Point1.z+NodeDp.z*cz);
+  }
+  //-Adds nodes within the domain to the batch.
+  Batch=new JGaugeBatch();
+  PointBatch.resize(size_t(np));
+  for(p=0;p<unsigned(np);p++){
+    const tdouble3 ps=Points[p];
+    const bool out=(ps.x<domposmin.x || ps.y<domposmin.y || ps.z<domposmin.z || ps.x>=domposmax.x || ps.y>=domposmax.y || ps.z>=domposmax.z);
+    PointBatch[p]=(out? UINT_MAX: Batch->AddPoint(ps));
+  }
+  Stats.assign(size_t(np)*NVAR,JMeanVarValue());
+}
+
+//==============================================================================
+/// Loads lines with configuration information.
+//==============================================================================
+void JDsGridStatsItem::GetConfig(std::vector<std::string> &lines)const{
+  lines.push_back(fun::PrintStr("Grid.......: %s",fun::Double3gRangeStr(Point1,Point2).c_str()));
+  lines.push_back(fun::PrintStr("Nodes......: %u x %u x %u = %u  (dp:%g)",Nodes.x,Nodes.y,Nodes.z,GetNp(),Dp));
+  lines.push_back(fun::PrintStr("NodesOut...: %u  (out of domain)",GetNp()-Batch->GetCount()));
+  const string cpend=fun::DoublexStr(ComputeEnd,"%g");
+  lines.push_back(fun::PrintStr("Compute....: %g - %s   dt:%g",ComputeStart,cpend.c_str(),ComputeDt));
+  if(SaveDt>0)lines.push_back(fun::PrintStr("SaveDt.....: %g",SaveDt));
+  else lines.push_back("SaveDt.....: only at the end");
+  lines.push_back(fun::PrintStr("Memory.....: %.2f MB",double(sizeof(JMeanVarValue)*Stats.size())/(1024*1024)));
+}
+
+//==============================================================================
+/// Interpolates values on the nodes and updates the statistics (on CPU).
+//==============================================================================
+void JDsGridStatsItem::CalculeCpu(double timestep,const StCteSph &csp
+  ,const StDivDataCpu &dvd,const tdouble3 *pos,const typecode *code,const tfloat4 *velrhop)
+{
+  //-Updates ComputeNext.
+  if(ComputeDt){
+    const unsigned nt=unsigned(timestep/ComputeDt);
+    ComputeNext=ComputeDt*nt;
+    if(ComputeNext<=timestep)ComputeNext=ComputeDt*(nt+1);
+  }
+  //-Computes kernel sums on the nodes.
+  Batch->ClearPoints();
+  Batch->RequestRhopPress();
+  const int np=int(GetNp());
+  for(int p=0;p<np;p++)if(PointBatch[p]!=UINT_MAX)Batch->AddPoint(Points[p]);
+  Batch->Calcule(csp,dvd,pos,code,velrhop);
+  //-Updates statistics of nodes with fluid.
+  JMeanVarValue *stats=(Stats.empty()? NULL: &Stats[0]);
+  const JGaugeBatch *batch=Batch;
+  #ifdef OMP_USE
+    #pragma omp parallel for schedule (static) if(np>OMP_LIMIT_COMPUTELIGHT)
+  #endif
+  for(int p=0;p<np;p++){
+    const unsigned cb=PointBatch[p];
+    if(cb!=UINT_MAX){
+      const JGaugeBatch::StSums &s=batch->GetSums(cb);
+      if(s.sumwab>0){
+        JMeanVarValue *st=stats+size_t(p)*NVAR;
+        st[0].AddValue(s.sumvel.x/s.sumwab);
+        st[1].AddValue(s.sumvel.y/s.sumwab);
+        st[2].AddValue(s.sumvel.z/s.sumwab);
+        st[3].AddValue(s.sumrhop/s.sumwab);
+        st[4].AddValue(s.sumpress/s.sumwab);
+      }
+    }
+  }
+  if(!NumSamples)SampleTimeIni=timestep;
+  SampleTimeEnd=timestep;
+  NumSamples++;
+}
+
+//==============================================================================
+/// Saves statistics of nodes in VTK file. Periodic files are numbered and the
+/// final file (timestep<0) is not.
+//==============================================================================
+void JDsGridStatsItem::SaveStats(double timestep,const std::string &dirout,JLog2 *log){
+  if(JVtkLib::Available()){
+    const unsigned np=GetNp();
+    tfloat3  *vpos   =new tfloat3[np];
+    unsigned *vnum   =new unsigned[np];
+    tfloat3  *vvel   =new tfloat3[np];
+    tfloat3  *vvelmin=new tfloat3[np];
+    tfloat3  *vvelmax=new tfloat3[np];
+    tfloat3  *vvelvar=new tfloat3[np];
+    float    *vtke   =new float[np];
+    float    *vrhop  =new float[np*4];
+    float    *vpress =new float[np*4];
+    for(unsigned p=0;p<np;p++){
+      const JMeanVarValue *st=&Stats[size_t(p)*NVAR];
+      const bool ok=(st[0].GetValues()!=0);
+      vpos[p]=ToTFloat3(Points[p]);
+      vnum[p]=unsigned(st[0].GetValues());
+      vvel[p]   =(ok? TFloat3(float(st[0].GetMean()),float(st[1].GetMean()),float(st[2].GetMean())): TFloat3(0));
+      vvelmin[p]=(ok? TFloat3(float(st[0].GetMin()),float(st[1].GetMin()),float(st[2].GetMin())): TFloat3(0));
+      vvelmax[p]=(ok? TFloat3(float(st[0].GetMax()),float(st[1].GetMax()),float(st[2].GetMax())): TFloat3(0));
+      vvelvar[p]=TFloat3(float(st[0].GetVariance()),float(st[1].GetVariance()),float(st[2].GetVariance()));
+      vtke[p]=(vvelvar[p].x+vvelvar[p].y+vvelvar[p].z)/2;
+      for(unsigned cv=0;cv<2;cv++){
+        const JMeanVarValue &sv=st[3+cv];
+        float *v=(!cv? vrhop: vpress);
+        v[p]     =(ok? float(sv.GetMean()): 0);
+        v[np+p]  =(ok? float(sv.GetMin()): 0);
+        v[np*2+p]=(ok? float(sv.GetMax()): 0);
+        v[np*3+p]=float(sv.GetVariance());
+      }
+    }
+    JDataArrays arrays;
+    arrays.AddArray("Pos",np,vpos,true);
+    arrays.AddArray("Samples",np,vnum,true);
+    arrays.AddArray("VelMean",np,vvel,true);
+    arrays.AddArray("VelMin",np,vvelmin,true);
+    arrays.AddArray("VelMax",np,vvelmax,true);
+    arrays.AddArray("VelVar",np,vvelvar,true);
+    arrays.AddArray("TKE",np,vtke,true);
+    arrays.AddArray("RhopMean",np,vrhop,true);
+    arrays.AddArray("RhopMin",np,vrhop+np,false);
+    arrays.AddArray("RhopMax",np,vrhop+np*2,false);
+    arrays.AddArray("RhopVar",np,vrhop+np*3,false);
+    arrays.AddArray("PressMean",np,vpress,true);
+    arrays.AddArray("PressMin",np,vpress+np,false);
+    arrays.AddArray("PressMax",np,vpress+np*2,false);
+    arrays.AddArray("PressVar",np,vpress+np*3,false);
+    const string file=dirout+"GridStats_"+Name+".vtk";
+    const string fileinfo=fun::PrintStr("Saves statistics of fluid values on grid nodes (by %s).",ClassName.c_str());
+    if(timestep>=0){
+      log->AddFileInfo(fun::FileNameSec(file,UINT_MAX),fileinfo);
+      JVtkLib::SaveVtkData(fun::FileNameSec(file,NumSaves),arrays,"Pos");
+      NumSaves++;
+    }
+    else{
+      log->AddFileInfo(file,fileinfo);
+      JVtkLib::SaveVtkData(file,arrays,"Pos");
+    }
+  }
+  if(timestep>=0){
+    const unsigned nt=unsigned(timestep/SaveDt);
+    SaveNext=SaveDt*nt;
+    if(SaveNext<=timestep)SaveNext=SaveDt*(nt+1);
+  }
+}
+
+
+//##############################################################################
+//# JDsGridStats
+//##############################################################################
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JDsGridStats::JDsGridStats(JLog2 *log):Log(log){
+  ClassName="JDsGridStats";
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JDsGridStats::~JDsGridStats(){
+  DestructorActive=true;
+  Reset();
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JDsGridStats::Reset(){
+  CSP=CteSphNull();
+  DomPosMin=DomPosMax=TDouble3(0);
+  TimeMax=0;
+  DirOut="";
+  for(unsigned c=0;c<GetCount();c++)delete List[c];
+  List.clear();
+}
+
+//==============================================================================
+/// Configures object.
+//==============================================================================
+void JDsGridStats::Config(const StCteSph &csp,tdouble3 domposmin,tdouble3 domposmax
+  ,double timemax,const std::string &dirout)
+{
+  CSP=csp;
+  DomPosMin=domposmin;
+  DomPosMax=domposmax;
+  TimeMax=timemax;
+  DirOut=dirout;
+  //-Wendland kernel is used when Cubic is selected.
+  if(CSP.tkernel==KERNEL_Cubic && (!CSP.kwend.awen || !CSP.kwend.bwen))Run_Exceptioon("Constants of kernel Wendland are not defined.");
+}
+
+//==============================================================================
+/// Loads configuration from XML object.
+//==============================================================================
+void JDsGridStats::LoadXml(const JXml *sxml,const std::string &place){
+  for(unsigned c=0;c<GetCount();c++)delete List[c];
+  List.clear();
+  TiXmlNode* node=sxml->GetNodeSimple(place,false);
+  if(!node)Run_Exceptioon(std::string("Cannot find the element \'")+place+"\'.");
+  if(sxml->CheckNodeActive(node))ReadXml(sxml,node->ToElement());
+}
+
+//==============================================================================
+/// Reads list of grids in the XML node.
+//==============================================================================
+void JDsGridStats::ReadXml(const JXml *sxml,TiXmlElement* lis){
+  sxml->CheckElementNames(lis,true,"*grid");
+  TiXmlElement* ele=lis->FirstChildElement("grid");
+  while(ele){
+    if(sxml->CheckElementActive(ele)){
+      const string name=sxml->GetAttributeStr(ele,"name");
+      if(name.empty() || int(name.find_first_of("/\\:*?\"<>| "))>=0)Run_ExceptioonFile(fun::PrintStr("The grid name \'%s\' is invalid.",name.c_str()),sxml->ErrGetFileRow(ele));
+      for(unsigned c=0;c<GetCount();c++)if(List[c]->Name==name)Run_ExceptioonFile(fun::PrintStr("The grid name \'%s\' already exists.",name.c_str()),sxml->ErrGetFileRow(ele));
+      JDsGridStatsItem* gr=new JDsGridStatsItem(GetCount(),name);
+      List.push_back(gr);
+      gr->ReadXml(sxml,ele,CSP.dp,TimeMax);
+      gr->ConfigNodes(DomPosMin,DomPosMax);
+    }
+    ele=ele->NextSiblingElement("grid");
+  }
+}
+
+//==============================================================================
+/// Shows object configuration using Log.
+//==============================================================================
+void JDsGridStats::VisuConfig(std::string txhead,std::string txfoot)const{
+  if(!txhead.empty())Log->Print(txhead);
+  for(unsigned c=0;c<GetCount();c++){
+    std::vector<std::string> lines;
+    List[c]->GetConfig(lines);
+    Log->Printf("Grid_%u: \'%s\'",List[c]->Idx,List[c]->Name.c_str());
+    for(unsigned i=0;i<unsigned(lines.size());i++)Log->Print(string("  ")+lines[i]);
+  }
+  if(!txfoot.empty())Log->Print(txfoot);
+}
+
+//==============================================================================
+/// Updates statistics of grids and saves periodic files (on CPU).
+//==============================================================================
+void JDsGridStats::CalculeCpu(double timestep,const StDivDataCpu &dvd
+  ,const tdouble3 *pos,const typecode *code,const tfloat4 *velrhop)
+{
+  for(unsigned c=0;c<GetCount();c++){
+    JDsGridStatsItem* gr=List[c];
+    if(gr->Update(timestep))gr->CalculeCpu(timestep,CSP,dvd,pos,code,velrhop);
+    if(gr->CheckSave(timestep))gr->SaveStats(timestep,DirOut,Log);
+  }
+}
+
+//==============================================================================
+/// Saves final statistics of grids.
+//==============================================================================
+void JDsGridStats::SaveFinal(){
+  for(unsigned c=0;c<GetCount();c++){
+    JDsGridStatsItem* gr=List[c];
+    gr->SaveStats(-1,DirOut,Log);
+    Log->Printf("GridStats \'%s\': %u samples saved in \"%s\".",gr->Name.c_str(),gr->GetNumSamples(),(string("GridStats_")+gr->Name+".vtk").c_str());
+  }
+}
+
@@ -0,0 +1,156 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Estadisticas (media, minimo, maximo y varianza) de velocidad, densidad y
+//:#   presion interpoladas durante la simulacion en los nodos de rejillas
+//:#   cartesianas. Solo se graban las estadisticas de los nodos. (19-10-2026)
+//:#############################################################################
+
+/// \file JDsGridStats.h \brief Declares the classes \ref JDsGridStatsItem and \ref JDsGridStats.
+
+#ifndef _JDsGridStats_
+#define _JDsGridStats_
+
+#include <string>
+#include <vector>
+#include "JObject.h"
+#include "DualSphDef.h"
+#include "JMeanValues.h"
+#include "JCellDivDataCpu.h"
+
+class JXml;
+class TiXmlElement;
+class JLog2;
+class JGaugeBatch;
+
+//##############################################################################
+//# XML format in _FmtXML_GridStats.xml.
+//##############################################################################
+//  <gridstats>
+//    <grid name="Tank">
+//      <point1 x="0" y="0" z="0" comment="Minimum position of grid" />
+//      <point2 x="1.6" y="0" z="0.6" comment="Maximum position of grid" />
+//      <dp coefdp="2" comment="Distance between nodes (value or coefdp*Dp)" />
+//      <computedt value="0.005" comment="Time between samples. 0:all steps (default=0)" />
+//      <computetime start="0.5" end="2" comment="Time interval of sampling (default=all simulation)" />
+//      <savedt value="0.5" comment="Time between saving of statistics. 0:only at the end (default=0)" />
+//    </grid>
+//  </gridstats>
+
+//##############################################################################
+//# JDsGridStatsItem
+//##############################################################################
+/// \brief Accumulates statistics of interpolated fluid values on the nodes of one grid.
+///
+/// Velocity, density and pressure are interpolated with Shepard correction
+/// using JGaugeBatch. Each sample updates mean, minimum, maximum and variance
+/// of the nodes with fluid around them (nodes without fluid are not sampled).
+
+class JDsGridStatsItem : protected JObject
+{
+public:
+  static const unsigned NVAR=5; ///<Number of values per node: velx,vely,velz,rhop,press.
+
+  const unsigned Idx;       ///<Index of grid.
+  const std::string Name;   ///<Name of grid.
+
+protected:
+  //-Definition.
+  tdouble3 Point1;          ///<Minimum position of grid.
+  tdouble3 Point2;          ///<Maximum position of grid.
+  double Dp;                ///<Requested distance between nodes.
+  tuint3 Nodes;             ///<Number of nodes in each direction.
+  tdouble3 NodeDp;          ///<Distance between nodes in each direction.
+
+  double ComputeDt;         ///<Time between samples (0:all steps).
+  double ComputeStart;      ///<Initial time of sampling.
+  double ComputeEnd;        ///<Final time of sampling.
+  double ComputeNext;       ///<Next time of sampling.
+  double SaveDt;            ///<Time between saving of statistics (0:only at the end).
+  double SaveNext;          ///<Next time of saving.
+
+  //-Accumulated data.
+  std::vector<tdouble3> Points;     ///<Position of nodes.
+  std::vector<unsigned> PointBatch; ///<Index of each node in JGaugeBatch (UINT_MAX for nodes out of domain).
+  std::vector<JMeanVarValue> Stats; ///<Statistics of each node [Np*NVAR].
+  unsigned NumSamples;              ///<Number of samples.
+  double SampleTimeIni;             ///<Time of first sample.
+  double SampleTimeEnd;             ///<Time of last sample.
+  JGaugeBatch *Batch;               ///<Computes interpolated values on the nodes.
+  unsigned NumSaves;                ///<Number of saved files.
+
+public:
+  JDsGridStatsItem(unsigned idx,const std::string &name);
+  ~JDsGridStatsItem();
+  void Reset();
+
+  void ReadXml(const JXml *sxml,TiXmlElement* ele,double dp,double timemax);
+  void ConfigNodes(const tdouble3 &domposmin,const tdouble3 &domposmax);
+  void GetConfig(std::vector<std::string> &lines)const;
+
+  unsigned GetNp()const{ return(unsigned(Points.size())); }
+  unsigned GetNumSamples()const{ return(NumSamples); }
+  bool Update(double timestep)const{ return(timestep>=ComputeNext && ComputeStart<=timestep && timestep<=ComputeEnd); }
+  bool CheckSave(double timestep)const{ return(SaveDt>0 && timestep>=SaveNext); }
+
+  void CalculeCpu(double timestep,const StCteSph &csp,const StDivDataCpu &dvd
+    ,const tdouble3 *pos,const typecode *code,const tfloat4 *velrhop);
+  void SaveStats(double timestep,const std::string &dirout,JLog2 *log);
+};
+
+
+//##############################################################################
+//# JDsGridStats
+//##############################################################################
+/// \brief Manages the in-situ statistics on Cartesian grids (only on CPU).
+
+class JDsGridStats : protected JObject
+{
+protected:
+  JLog2 *Log;
+  StCteSph CSP;             ///<Structure with main SPH constants values and configurations.
+  tdouble3 DomPosMin;       ///<Lower limit of simulation domain.
+  tdouble3 DomPosMax;       ///<Upper limit of simulation domain.
+  double TimeMax;           ///<Total time to simulate [s].
+  std::string DirOut;       ///<Directory for output files.
+  std::vector<JDsGridStatsItem*> List;
+
+  void ReadXml(const JXml *sxml,TiXmlElement* lis);
+
+public:
+  JDsGridStats(JLog2 *log);
+  ~JDsGridStats();
+  void Reset();
+
+  void Config(const StCteSph &csp,tdouble3 domposmin,tdouble3 domposmax,double timemax,const std::string &dirout);
+  void LoadXml(const JXml *sxml,const std::string &place);
+  void VisuConfig(std::string txhead,std::string txfoot)const;
+
+  unsigned GetCount()const{ return(unsigned(List.size())); }
+
+  void CalculeCpu(double timestep,const StDivDataCpu &dvd,const tdouble3 *pos
+    ,const typecode *code,const tfloat4 *velrhop);
+  void SaveFinal();
+};
+
+#endif
+
+
@@ -0,0 +1,381 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JDsOmpTuner.cpp \brief Implements the class \ref JDsOmpTuner.
+
+#include "JDsOmpTuner.h"
+#include "OmpDefs.h"
+#include "JAppInfo.h"
+#include "JLog2.h"
+#include "JXml.h"
+#include "Functions.h"
+#include <cfloat>
+#include <climits>
+#include <fstream>
+#include <algorithm>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JDsOmpTuner::JDsOmpTuner(int ompthreads,const std::string &fileprofile,JLog2 *log)
+  :Log(log),OmpThreads(ompthreads),FileProfile(!fileprofile.empty()? fileprofile: GetDefaultFile())
+  ,HostName(GetHostName())
+{
+  ClassName="JDsOmpTuner";
+  //-Candidate schedules for interaction loops (the first one is the default).
+  const int cands[]={3,0, 3,16, 2,16, 2,64, 2,256, 1,0, 1,64};
+  for(unsigned c=0;c<sizeof(cands)/sizeof(int);c+=2){
+    StOmpSched s={cands[c],cands[c+1]};
+    Cands.push_back(s);
+  }
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JDsOmpTuner::~JDsOmpTuner(){
+  DestructorActive=true;
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JDsOmpTuner::Reset(){
+  Limits[OLIM_ComputeStep]=OMP_LIMIT_COMPUTESTEP;
+  Limits[OLIM_ComputeLight]=OMP_LIMIT_COMPUTELIGHT;
+  for(unsigned c=0;c<OLOOP_COUNT;c++){
+    StLoopTune &lt=Loops[c];
+    #ifdef OMP_USE_RUNTIMESCHED
+      lt.tuned=false;
+    #else
+      lt.tuned=true;  //-Fixed schedule(guided) without OpenMP 3.0.
+    #endif
+    lt.sched=Cands[0];
+    lt.calls=lt.ccur=lt.nitems=0;
+    lt.tstart=0;
+    lt.tbest.assign(Cands.size(),DBL_MAX);
+  }
+}
+
+//==============================================================================
+/// Sets the schedule by default (guided) of the loops declared with
+/// schedule(runtime). Without OpenMP 3.0 these loops use schedule(guided).
+//==============================================================================
+void JDsOmpTuner::SetScheduleDefault(){
+#ifdef OMP_USE_RUNTIMESCHED
+  omp_set_schedule(omp_sched_guided,0);
+#endif
+}
+
+//==============================================================================
+/// Returns the name of the host.
+//==============================================================================
+std::string JDsOmpTuner::GetHostName(){
+  string host="unknown";
+#ifndef _WIN32
+  const int len=128; char hname[len];
+  if(!gethostname(hname,len)){ hname[len-1]='\0'; host=hname; }
+#endif
+  return(host);
+}
+
+//==============================================================================
+/// Returns the name of the loop.
+//==============================================================================
+std::string JDsOmpTuner::GetLoopName(TpOmpLoop loop){
+  switch(loop){
+    case OLOOP_ForcesBound:  return("ForcesBound");
+    case OLOOP_ForcesFluid:  return("ForcesFluid");
+    case OLOOP_ForcesFluidBound: return("ForcesFluidBound");
+    case OLOOP_ForcesDem:    return("ForcesDem");
+  }
+  return("???");
+}
+
+//==============================================================================
+/// Returns the name of the threshold.
+//==============================================================================
+std::string JDsOmpTuner::GetLimitName(TpOmpLimit lim){
+  switch(lim){
+    case OLIM_ComputeStep:   return("ComputeStep");
+    case OLIM_ComputeLight:  return("ComputeLight");
+  }
+  return("???");
+}
+
+//==============================================================================
+/// Returns the schedule as text.
+//==============================================================================
+std::string JDsOmpTuner::GetSchedStr(int kind,int chunk){
+  const string tkind=(kind==1? "static": (kind==2? "dynamic": (kind==3? "guided": "auto")));
+  return(chunk>0? tkind+","+fun::IntStr(chunk): tkind);
+}
+
+//==============================================================================
+/// Returns the profile file by default (next to the executable).
+//==============================================================================
+std::string JDsOmpTuner::GetDefaultFile(){
+  return(fun::GetDirWithSlash(AppInfo.GetRunPath())+"DsOmpProfile.xml");
+}
+
+//==============================================================================
+/// Returns the element with the profile of the current host and number of
+/// threads (NULL when it does not exist).
+//==============================================================================
+TiXmlElement* JDsOmpTuner::FindProfile(JXml &sxml)const{
+  TiXmlNode* node=sxml.GetNodeSimple("dsph_ompprofile");
+  TiXmlElement* ele=(node? node->FirstChildElement("profile"): NULL);
+  while(ele){
+    if(sxml.GetAttributeStr(ele,"host",true)==HostName && sxml.GetAttributeInt(ele,"threads",true,0)==OmpThreads)return(ele);
+    ele=ele->NextSiblingElement("profile");
+  }
+  return(NULL);
+}
+
+//==============================================================================
+/// Loads profile of the current host and number of threads. Returns true when
+/// the thresholds are available.
+//==============================================================================
+bool JDsOmpTuner::LoadProfile(){
+  if(!fun::FileExists(FileProfile))return(false);
+  JXml sxml;
+  sxml.LoadFile(FileProfile);
+  TiXmlElement* ele=FindProfile(sxml);
+  if(!ele)return(false);
+  unsigned nlim=0;
+  TiXmlElement* ele2=ele->FirstChildElement("limit");
+  while(ele2){
+    const string name=sxml.GetAttributeStr(ele2,"name");
+    for(unsigned c=0;c<OLIM_COUNT;c++)if(name==GetLimitName(TpOmpLimit(c))){
+      Limits[c]=sxml.GetAttributeUnsigned(ele2,"value");
+      nlim++;
+    }
+    ele2=ele2->NextSiblingElement("limit");
+  }
+  ele2=ele->FirstChildElement("loop");
+  while(ele2){
+    const string name=sxml.GetAttributeStr(ele2,"name");
+    const string tkind=fun::StrLower(sxml.GetAttributeStr(ele2,"schedule"));
+    const int kind=(tkind=="static"? 1: (tkind=="dynamic"? 2: (tkind=="guided"? 3: 0)));
+    if(!kind)Run_ExceptioonFile(string("Schedule \'")+tkind+"\' is invalid.",FileProfile);
+    for(unsigned c=0;c<OLOOP_COUNT;c++)if(name==GetLoopName(TpOmpLoop(c))){
+      Loops[c].tuned=true;
+      Loops[c].sched.kind=kind;
+      Loops[c].sched.chunk=max(0,sxml.GetAttributeInt(ele2,"chunk",true,0));
+    }
+    ele2=ele2->NextSiblingElement("loop");
+  }
+  return(nlim==OLIM_COUNT);
+}
+
+//==============================================================================
+/// Saves current profile of host and number of threads in the profile file
+/// keeping the profiles of other machines.
+//==============================================================================
+void JDsOmpTuner::SaveProfile()const{
+  const bool fexists=fun::FileExists(FileProfile);
+  {//-Checks write permission to avoid exception.
+    ofstream pf;
+    pf.open(FileProfile.c_str(),ios::app);
+    if(!pf){
+      Log->PrintfWarning("OpenMP profile cannot be saved in \'%s\'.",FileProfile.c_str());
+      return;
+    }
+    pf.close();
+  }
+  JXml sxml;
+  if(fexists)sxml.LoadFile(FileProfile);
+  TiXmlNode* node=sxml.GetNode("dsph_ompprofile",true);
+  TiXmlElement* ele=FindProfile(sxml);
+  if(ele)node->RemoveChild(ele);
+  ele=JXml::AddElement(node,"profile");
+  JXml::AddAttribute(ele,"host",HostName);
+  JXml::AddAttribute(ele,"threads",OmpThreads);
+  JXml::AddAttribute(ele,"date",fun::GetDateTime());
+  for(unsigned c=0;c<OLIM_COUNT;c++){
+    TiXmlElement* ele2=JXml::AddElement(ele,"limit");
+    JXml::AddAttribute(ele2,"name",GetLimitName(TpOmpLimit(c)));
+    JXml::AddAttribute(ele2,"value",Limits[c]);
+  }
+  for(unsigned c=0;c<OLOOP_COUNT;c++)if(Loops[c].tuned){
+    const StOmpSched &s=Loops[c].sched;
+    TiXmlElement* ele2=JXml::AddElement(ele,"loop");
+    JXml::AddAttribute(ele2,"name",GetLoopName(TpOmpLoop(c)));
+    JXml::AddAttribute(ele2,"schedule",GetSchedStr(s.kind,0));
+    JXml::AddAttribute(ele2,"chunk",s.chunk);
+  }
+  sxml.SaveFile(FileProfile,AppInfo.GetFullName(),false);
+}
+
+//==============================================================================
+/// Loads the profile of the machine or computes the thresholds of parallel
+/// execution when the profile does not exist (or retune is requested).
+//==============================================================================
+void JDsOmpTuner::Config(bool retune){
+  Reset();
+  Log->Printf("OpenMP autotuning (host:%s threads:%d) with profile \"%s\"",HostName.c_str(),OmpThreads,FileProfile.c_str());
+  if(!retune && LoadProfile())Log->Print("  Profile of machine was loaded.");
+  else{
+    TuneLimits();
+    SaveProfile();
+  }
+  Log->Printf("  Threshold %s: %u (default: %u)",GetLimitName(OLIM_ComputeStep).c_str(),Limits[OLIM_ComputeStep],OMP_LIMIT_COMPUTESTEP);
+  Log->Printf("  Threshold %s: %u (default: %u)",GetLimitName(OLIM_ComputeLight).c_str(),Limits[OLIM_ComputeLight],OMP_LIMIT_COMPUTELIGHT);
+  for(unsigned c=0;c<OLOOP_COUNT;c++){
+    const StLoopTune &lt=Loops[c];
+    Log->Printf("  Schedule %s: %s",GetLoopName(TpOmpLoop(c)).c_str()
+      ,(lt.tuned? GetSchedStr(lt.sched.kind,lt.sched.chunk).c_str(): "tuning in first steps"));
+  }
+}
+
+#ifdef OMP_USE
+//==============================================================================
+/// Representative loop of ComputeStep (update of position and velocity).
+/// Returns runtime in seconds.
+//==============================================================================
+static double TuneLoopStep(int n,bool par,tdouble3 *pos,tfloat4 *velrhop,const tfloat3 *ace){
+  const double t0=omp_get_wtime();
+  const double dt=1e-5,dt205=0.5*dt*dt;
+  #pragma omp parallel for schedule (static) if(par)
+  for(int p=0;p<n;p++){
+    const tfloat4 v=velrhop[p];
+    const tfloat3 a=ace[p];
+    pos[p]=pos[p]+TDouble3(v.x*dt+a.x*dt205,v.y*dt+a.y*dt205,v.z*dt+a.z*dt205);
+    velrhop[p]=TFloat4(float(v.x+a.x*dt),float(v.y+a.y*dt),float(v.z+a.z*dt),v.w);
+  }
+  return(omp_get_wtime()-t0);
+}
+
+//==============================================================================
+/// Representative light loop (computation of one value per particle).
+/// Returns runtime in seconds.
+//==============================================================================
+static double TuneLoopLight(int n,bool par,const tfloat4 *velrhop,float *res){
+  const double t0=omp_get_wtime();
+  #pragma omp parallel for schedule (static) if(par)
+  for(int p=0;p<n;p++){
+    const tfloat4 v=velrhop[p];
+    res[p]=v.x*v.x+v.y*v.y+v.z*v.z;
+  }
+  return(omp_get_wtime()-t0);
+}
+#endif
+
+//==============================================================================
+/// Computes the thresholds of parallel execution comparing the serial and
+/// parallel runtime of representative loops for several sizes. The threshold
+/// is the largest size where the serial execution is not slower.
+//==============================================================================
+void JDsOmpTuner::TuneLimits(){
+#ifdef OMP_USE
+  const unsigned sizes[]={1000,2000,5000,10000,20000,50000,100000,200000,500000};
+  const unsigned nsizes=unsigned(sizeof(sizes)/sizeof(unsigned));
+  const unsigned nmax=sizes[nsizes-1];
+  std::vector<tdouble3> pos(nmax,TDouble3(0));
+  std::vector<tfloat4> velrhop(nmax,TFloat4(0.1f,0.2f,0.3f,1000.f));
+  std::vector<tfloat3> ace(nmax,TFloat3(0,0,-9.81f));
+  std::vector<float> res(nmax,0);
+  TuneLoopStep(int(nmax),true,pos.data(),velrhop.data(),ace.data());
+  TuneLoopLight(int(nmax),true,velrhop.data(),res.data());
+  for(unsigned clim=0;clim<OLIM_COUNT;clim++){
+    std::vector<bool> parfaster(nsizes,false);
+    for(unsigned cs=0;cs<nsizes;cs++){
+      const int n=int(sizes[cs]);
+      const unsigned reps=min(2000u,max(5u,2000000u/sizes[cs]));
+      double tser=DBL_MAX,tpar=DBL_MAX;
+      for(unsigned r=0;r<reps;r++)for(unsigned cpar=0;cpar<2;cpar++){
+        const double t=(clim==OLIM_ComputeStep? TuneLoopStep(n,cpar!=0,pos.data(),velrhop.data(),ace.data()):
+                                                TuneLoopLight(n,cpar!=0,velrhop.data(),res.data()));
+        if(cpar)tpar=min(tpar,t); else tser=min(tser,t);
+      }
+      parfaster[cs]=(tpar<tser);
+    }
+    unsigned limit=nmax;
+    for(int cs=int(nsizes)-1;cs>=0 && parfaster[cs];cs--)limit=(cs? sizes[cs-1]: 0);
+    Limits[clim]=limit;
+  }
+#endif
+}
+
+//==============================================================================
+/// Returns true when some loop is being tuned.
+//==============================================================================
+bool JDsOmpTuner::GetTuning()const{
+  bool tuning=false;
+  for(unsigned c=0;c<OLOOP_COUNT;c++)tuning|=!Loops[c].tuned;
+  return(tuning);
+}
+
+//==============================================================================
+/// Configures the schedule before the execution of the loop. During tuning
+/// the candidate schedules are used alternately and measured.
+//==============================================================================
+void JDsOmpTuner::LoopStart(TpOmpLoop loop,unsigned n){
+  StLoopTune &lt=Loops[loop];
+  StOmpSched s=lt.sched;
+  if(!lt.tuned){
+    lt.ccur=lt.calls%unsigned(Cands.size());
+    s=Cands[lt.ccur];
+  }
+#ifdef OMP_USE_RUNTIMESCHED
+  omp_set_schedule(omp_sched_t(s.kind),s.chunk);
+#endif
+#ifdef OMP_USE
+  lt.tstart=omp_get_wtime();
+#endif
+  lt.nitems=n;
+}
+
+//==============================================================================
+/// Measures the execution of the loop during tuning and selects the fastest
+/// candidate when all of them were measured.
+//==============================================================================
+void JDsOmpTuner::LoopEnd(TpOmpLoop loop){
+  StLoopTune &lt=Loops[loop];
+  if(!lt.tuned && lt.nitems){
+  #ifdef OMP_USE
+    const double t=(omp_get_wtime()-lt.tstart)/lt.nitems;
+    lt.tbest[lt.ccur]=min(lt.tbest[lt.ccur],t);
+  #endif
+    lt.calls++;
+    if(lt.calls>=unsigned(Cands.size())*TUNE_REPS)SelectLoop(loop);
+  }
+}
+
+//==============================================================================
+/// Selects the fastest schedule of the loop and updates the profile.
+//==============================================================================
+void JDsOmpTuner::SelectLoop(TpOmpLoop loop){
+  StLoopTune &lt=Loops[loop];
+  unsigned cbest=0;
+  for(unsigned c=1;c<unsigned(Cands.size());c++)if(lt.tbest[c]<lt.tbest[cbest])cbest=c;
+  lt.sched=Cands[cbest];
+  lt.tuned=true;
+  const double gain=(lt.tbest[cbest]>0? lt.tbest[0]/lt.tbest[cbest]: 1);
+  Log->Printf("OpenMP autotuning: %s -> schedule(%s)  %.3f ns/item  (%.2fx vs %s)"
+    ,GetLoopName(loop).c_str(),GetSchedStr(lt.sched.kind,lt.sched.chunk).c_str()
+    ,lt.tbest[cbest]*1e9,gain,GetSchedStr(Cands[0].kind,Cands[0].chunk).c_str());
+  SaveProfile();
+}
+
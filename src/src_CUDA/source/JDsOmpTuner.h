@@ -0,0 +1,130 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Autoajuste de OpenMP en CPU: limites de paralelizacion de los bucles
+//:#   ligeros (medidos al inicio) y planificacion (schedule y chunk) de los
+//:#   bucles de interaccion (medida durante los primeros pasos). La eleccion
+//:#   se guarda por maquina y numero de hilos en un fichero XML. (19-10-2026)
+//:#############################################################################
+
+/// \file JDsOmpTuner.h \brief Declares the class \ref JDsOmpTuner.
+
+#ifndef _JDsOmpTuner_
+#define _JDsOmpTuner_
+
+#include "JObject.h"
+#include "TypesDef.h"
+#include <string>
+#include <vector>
+
+class JLog2;
+class JXml;
+class TiXmlElement;
+
+///Loops of interaction with tuned OpenMP schedule.
+typedef enum{
+   OLOOP_ForcesBound=0       ///<Interaction Bound-Fluid/Float.
+  ,OLOOP_ForcesFluid=1       ///<Interaction Fluid/Float-Fluid/Float.
+  ,OLOOP_ForcesFluidBound=2  ///<Interaction Fluid/Float-Bound.
+  ,OLOOP_ForcesDem=3         ///<DEM interaction of floating particles.
+}TpOmpLoop;
+#define OLOOP_COUNT 4
+
+///Thresholds of parallel execution tuned at startup.
+typedef enum{
+   OLIM_ComputeStep=0   ///<Update of particles in ComputeStep (OMP_LIMIT_COMPUTESTEP).
+  ,OLIM_ComputeLight=1  ///<Light loops over particles (OMP_LIMIT_COMPUTELIGHT).
+}TpOmpLimit;
+#define OLIM_COUNT 2
+
+//##############################################################################
+//# JDsOmpTuner
+//##############################################################################
+/// \brief Autotuning of OpenMP thresholds and schedules for the current machine.
+///
+/// The thresholds of parallel execution are obtained at startup comparing the
+/// serial and parallel runtime of representative loops for several sizes.
+/// The schedule of the interaction loops (declared with schedule(runtime)) is
+/// selected during the first steps of the simulation measuring each candidate
+/// schedule and chunk size several times. The results are saved in a profile
+/// file by host name and number of threads and reused in later executions.
+
+class JDsOmpTuner : protected JObject
+{
+protected:
+  ///Schedule of OpenMP loop.
+  typedef struct{
+    int kind;      ///<Kind of schedule (omp_sched_t: 1:static, 2:dynamic, 3:guided).
+    int chunk;     ///<Chunk size (0:default).
+  }StOmpSched;
+
+  ///State of tuning of one loop.
+  typedef struct{
+    bool tuned;                  ///<Schedule was selected (tuned or loaded).
+    StOmpSched sched;            ///<Selected schedule.
+    unsigned calls;              ///<Number of measured calls.
+    unsigned ccur;               ///<Candidate of current call.
+    double tstart;               ///<Start time of current call.
+    unsigned nitems;             ///<Number of items of current call.
+    std::vector<double> tbest;   ///<Best runtime per item of each candidate.
+  }StLoopTune;
+
+  static const unsigned TUNE_REPS=3;  ///<Measures of each candidate schedule.
+
+  JLog2 *Log;
+  const int OmpThreads;
+  const std::string FileProfile;
+  const std::string HostName;
+
+  std::vector<StOmpSched> Cands;      ///<Candidate schedules for interaction loops.
+  unsigned Limits[OLIM_COUNT];        ///<Tuned thresholds of parallel execution.
+  StLoopTune Loops[OLOOP_COUNT];
+
+  void Reset();
+  bool LoadProfile();
+  void SaveProfile()const;
+  TiXmlElement* FindProfile(JXml &sxml)const;
+
+  void TuneLimits();
+  void SelectLoop(TpOmpLoop loop);
+
+public:
+  JDsOmpTuner(int ompthreads,const std::string &fileprofile,JLog2 *log);
+  ~JDsOmpTuner();
+  void Config(bool retune);
+
+  unsigned GetLimit(TpOmpLimit lim)const{ return(Limits[lim]); }
+  bool GetTuning()const;
+
+  void LoopStart(TpOmpLoop loop,unsigned n);
+  void LoopEnd(TpOmpLoop loop);
+
+  static void SetScheduleDefault();
+  static std::string GetHostName();
+  static std::string GetLoopName(TpOmpLoop loop);
+  static std::string GetLimitName(TpOmpLimit lim);
+  static std::string GetSchedStr(int kind,int chunk);
+  static std::string GetDefaultFile();
+};
+
+#endif
+
+
@@ -0,0 +1,393 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JDsOutputParts.cpp \brief Implements the classes \ref JDsOutputPartsStream and \ref JDsOutputParts.
+
+#include "JDsOutputParts.h"
+#include "JDsOutputTime.h"
+#include "JPartDataHead.h"
+#include "JPartDataBi4.h"
+#include "JRangeFilter.h"
+#include "JSphMk.h"
+#include "JLog2.h"
+#include "JXml.h"
+#include "Functions.h"
+#include <cfloat>
+#include <climits>
+#include <algorithm>
+
+using namespace std;
+
+//##############################################################################
+//# JDsOutputPartsStream
+//##############################################################################
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JDsOutputPartsStream::JDsOutputPartsStream(unsigned idx,const std::string &name)
+  :Idx(idx),Name(name)
+{
+  ClassName="JDsOutputPartsStream";
+  OutTime=NULL;
+  DataBi4=NULL;
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JDsOutputPartsStream::~JDsOutputPartsStream(){
+  DestructorActive=true;
+  Reset();
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JDsOutputPartsStream::Reset(){
+  Decimation=1;
+  UseBox=false;
+  BoxMin=BoxMax=TDouble3(0);
+  MkFilter="";
+  TypeSel=TYPE_All;
+  BlockSel.clear();
+  SelOther=true;
+  delete OutTime; OutTime=NULL;
+  TimeNext=DBL_MAX;
+  Part=0;
+  DirOut="";
+  delete DataBi4; DataBi4=NULL;
+  LastNsel=0;
+}
+
+//==============================================================================
+/// Reads configuration from the XML element of the stream.
+//==============================================================================
+void JDsOutputPartsStream::ReadXml(const JXml *sxml,TiXmlElement* ele,double timeoutdef){
+  sxml->CheckElementNames(ele,true,"timeout *tout decimation box mk types");
+  //-Output time.
+  const double timeout=sxml->ReadElementDouble(ele,"timeout","value",true,timeoutdef);
+  if(timeout<=0)Run_ExceptioonFile(fun::PrintStr("The timeout (%g) of stream \'%s\' is invalid.",timeout,Name.c_str()),sxml->ErrGetFileRow(ele));
+  OutTime=new JDsOutputTime();
+  OutTime->Config(sxml,ele,timeout);
+  //-Decimation.
+  Decimation=sxml->ReadElementUnsigned(ele,"decimation","value",true,1);
+  if(!Decimation)Run_ExceptioonFile(fun::PrintStr("The decimation of stream \'%s\' is invalid.",Name.c_str()),sxml->ErrGetFileRow(ele));
+  //-Box filter.
+  TiXmlElement* ebox=sxml->GetFirstElement(ele,"box",true);
+  if(ebox && sxml->CheckElementActive(ebox)){
+    UseBox=true;
+    BoxMin=sxml->ReadElementDouble3(ebox,"posmin");
+    BoxMax=sxml->ReadElementDouble3(ebox,"posmax");
+    if(BoxMin.x>BoxMax.x || BoxMin.y>BoxMax.y || BoxMin.z>BoxMax.z)Run_ExceptioonFile(fun::PrintStr("The box limits of stream \'%s\' are invalid.",Name.c_str()),sxml->ErrGetFileRow(ebox));
+  }
+  //-Mk filter.
+  MkFilter=sxml->ReadElementStr(ele,"mk","value",true);
+  //-Type filter.
+  string types=fun::StrLower(sxml->ReadElementStr(ele,"types","value",true));
+  if(!types.empty()){
+    TypeSel=0;
+    while(!types.empty()){
+      const string tp=fun::StrTrim(fun::StrSplit(",",types));
+      if(tp=="fixed")        TypeSel|=TYPE_Fixed;
+      else if(tp=="moving")  TypeSel|=TYPE_Moving;
+      else if(tp=="floating")TypeSel|=TYPE_Floating;
+      else if(tp=="bound")   TypeSel|=(TYPE_Fixed|TYPE_Moving|TYPE_Floating);
+      else if(tp=="fluid")   TypeSel|=TYPE_Fluid;
+      else Run_ExceptioonFile(fun::PrintStr("The type \'%s\' of stream \'%s\' is invalid.",tp.c_str(),Name.c_str()),sxml->ErrGetFileRow(ele,"types"));
+    }
+  }
+}
+
+//==============================================================================
+/// Computes selection of each mk block according to mk and type filters.
+//==============================================================================
+void JDsOutputPartsStream::ConfigBlockSel(const JSphMk *mkinfo){
+  JRangeFilter mkfilter(MkFilter);
+  const unsigned nblocks=mkinfo->Size();
+  BlockSel.assign(nblocks,0);
+  unsigned nsel=0;
+  for(unsigned cb=0;cb<nblocks;cb++){
+    const JSphMkBlock* mblock=mkinfo->Mkblock(cb);
+    byte tsel=0;
+    switch(mblock->Type){
+      case TpPartFixed:     tsel=TYPE_Fixed;     break;
+      case TpPartMoving:    tsel=TYPE_Moving;    break;
+      case TpPartFloating:  tsel=TYPE_Floating;  break;
+      case TpPartFluid:     tsel=TYPE_Fluid;     break;
+      default: Run_Exceptioon("Type of block is invalid.");
+    }
+    const bool sel=((TypeSel&tsel)!=0 && (MkFilter.empty() || mkfilter.CheckValue(mblock->Mk)));
+    BlockSel[cb]=(sel? 1: 0);
+    if(sel)nsel++;
+  }
+  //-Particles without mk block (new inlet/outlet fluid) are only selected without mk filter.
+  SelOther=((TypeSel&TYPE_Fluid)!=0 && MkFilter.empty());
+  if(!nsel && !SelOther)Run_Exceptioon(fun::PrintStr("No particle block is selected by mk and type filters of stream \'%s\'.",Name.c_str()));
+}
+
+//==============================================================================
+/// Loads configuration from the XML element of the stream.
+//==============================================================================
+void JDsOutputPartsStream::LoadXml(const JXml *sxml,TiXmlElement* ele,const JSphMk *mkinfo,double timeoutdef){
+  Reset();
+  ReadXml(sxml,ele,timeoutdef);
+  ConfigBlockSel(mkinfo);
+}
+
+//==============================================================================
+/// Configures output files of the stream.
+//==============================================================================
+void JDsOutputPartsStream::ConfigSave(const std::string &dirout,const JPartDataHead *parthead
+  ,unsigned piece,unsigned npiece,double timestep)
+{
+  DirOut=fun::GetDirWithSlash(dirout);
+  fun::MkdirPath(DirOut);
+  JPartDataHead phead(*parthead);
+  phead.SaveFile(DirOut);
+  delete DataBi4;
+  DataBi4=new JPartDataBi4();
+  DataBi4->Config(piece,npiece,DirOut,parthead);
+  Part=0;
+  TimeNext=timestep;
+}
+
+//==============================================================================
+/// Returns strings with the configuration of the stream.
+//==============================================================================
+void JDsOutputPartsStream::GetConfig(std::vector<std::string> &lines)const{
+  lines.push_back(fun::PrintStr("Stream_%u: %s",Idx,Name.c_str()));
+  if(UseBox)lines.push_back(fun::PrintStr("  Box........: %s",fun::Double3gRangeStr(BoxMin,BoxMax).c_str()));
+  if(!MkFilter.empty())lines.push_back(fun::PrintStr("  Mk.........: %s",MkFilter.c_str()));
+  if(TypeSel!=TYPE_All){
+    string tx;
+    if(TypeSel&TYPE_Fixed)   tx=tx+(tx.empty()? "": ",")+"fixed";
+    if(TypeSel&TYPE_Moving)  tx=tx+(tx.empty()? "": ",")+"moving";
+    if(TypeSel&TYPE_Floating)tx=tx+(tx.empty()? "": ",")+"floating";
+    if(TypeSel&TYPE_Fluid)   tx=tx+(tx.empty()? "": ",")+"fluid";
+    lines.push_back(fun::PrintStr("  Types......: %s",tx.c_str()));
+  }
+  lines.push_back(fun::PrintStr("  Decimation.: %u",Decimation));
+  if(OutTime->UseSpecialConfig())lines.push_back("  TimeOut....: variable");
+  else lines.push_back(fun::PrintStr("  TimeOut....: %g",OutTime->GetNextTime(0)));
+}
+
+//==============================================================================
+/// Returns the list of selected particles (in the same order).
+/// The selection is computed in parallel by chunks. Returns number of selected.
+//==============================================================================
+unsigned JDsOutputPartsStream::FilterParticles(unsigned np,const unsigned *idp
+  ,const tdouble3 *pos,const typecode *code,const JSphMk *mkinfo,unsigned *sel)const
+{
+  const unsigned nblocks=unsigned(BlockSel.size());
+  const byte *blocksel=(nblocks? &(BlockSel[0]): NULL);
+ #ifdef OMP_USE
+  const int nchunks=(np>OMP_LIMIT_COMPUTELIGHT? min(omp_get_max_threads(),OMP_MAXTHREADS): 1);
+ #else
+  const int nchunks=1;
+ #endif
+  const unsigned sizechunk=(np+nchunks-1)/max(1,nchunks);
+  unsigned nsel[OMP_MAXTHREADS+1];
+  //-Counts selected particles in each chunk and stores the selection.
+  for(unsigned step=0;step<2;step++){
+    if(step){//-Computes initial position of each chunk.
+      unsigned n=0;
+      for(int cc=0;cc<nchunks;cc++){ const unsigned nc=nsel[cc]; nsel[cc]=n; n+=nc; }
+      nsel[nchunks]=n;
+    }
+    #ifdef OMP_USE
+      #pragma omp parallel for schedule (static) if(nchunks>1)
+    #endif
+    for(int cc=0;cc<nchunks;cc++){
+      const unsigned pini=sizechunk*unsigned(cc);
+      const unsigned pfin=min(np,pini+sizechunk);
+      unsigned n=(step? nsel[cc]: 0);
+      for(unsigned p=pini;p<pfin;p++){
+        const typecode rcode=code[p];
+        bool ok=CODE_IsNormal(rcode) && (Decimation==1 || idp[p]%Decimation==0);
+        if(ok){
+          const unsigned cb=mkinfo->GetMkBlockByCode(rcode);
+          ok=(cb<nblocks? blocksel[cb]!=0: SelOther);
+        }
+        if(ok && UseBox){
+          const tdouble3 ps=pos[p];
+          ok=(BoxMin.x<=ps.x && ps.x<=BoxMax.x && BoxMin.y<=ps.y && ps.y<=BoxMax.y && BoxMin.z<=ps.z && ps.z<=BoxMax.z);
+        }
+        if(ok){
+          if(step)sel[n]=p;
+          n++;
+        }
+      }
+      if(!step)nsel[cc]=n;
+    }
+  }
+  return(nsel[nchunks]);
+}
+
+//==============================================================================
+/// Saves PART of the stream with selected particles and updates next time.
+//==============================================================================
+void JDsOutputPartsStream::SavePart(double timestep,unsigned nstep,unsigned nsel
+  ,const unsigned *idp,const tdouble3 *pos,const tfloat3 *vel,const float *rhop
+  ,bool posdouble,tdouble3 domainmin,tdouble3 domainmax)
+{
+  DataBi4->AddPartInfo(Part,timestep,nsel,0,nstep,0,domainmin,domainmax);
+  tfloat3 *posf3=NULL;
+  if(posdouble)DataBi4->AddPartData(nsel,idp,pos,vel,rhop);
+  else{
+    posf3=new tfloat3[nsel];
+    for(unsigned p=0;p<nsel;p++)posf3[p]=ToTFloat3(pos[p]);
+    DataBi4->AddPartData(nsel,idp,posf3,vel,rhop);
+  }
+  DataBi4->SaveFilePart();
+  delete[] posf3;
+  LastNsel=nsel;
+  Part++;
+  TimeNext=OutTime->GetNextTime(timestep);
+}
+
+
+//##############################################################################
+//# JDsOutputParts
+//##############################################################################
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JDsOutputParts::JDsOutputParts(JLog2 *log):Log(log){
+  ClassName="JDsOutputParts";
+  MkInfo=NULL;
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JDsOutputParts::~JDsOutputParts(){
+  DestructorActive=true;
+  Reset();
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JDsOutputParts::Reset(){
+  for(unsigned c=0;c<GetCount();c++)delete List[c];
+  List.clear();
+  MkInfo=NULL;
+}
+
+//==============================================================================
+/// Loads configuration from XML object.
+//==============================================================================
+void JDsOutputParts::LoadXml(const JXml *sxml,const std::string &place,const JSphMk *mkinfo,double timeoutdef){
+  Reset();
+  MkInfo=mkinfo;
+  TiXmlNode* node=sxml->GetNodeSimple(place,false);
+  if(!node)Run_Exceptioon(std::string("Cannot find the element \'")+place+"\'.");
+  if(sxml->CheckNodeActive(node))ReadXml(sxml,node->ToElement(),timeoutdef);
+}
+
+//==============================================================================
+/// Reads list of streams in the XML node.
+//==============================================================================
+void JDsOutputParts::ReadXml(const JXml *sxml,TiXmlElement* lis,double timeoutdef){
+  sxml->CheckElementNames(lis,true,"*stream");
+  TiXmlElement* ele=lis->FirstChildElement("stream");
+  while(ele){
+    if(sxml->CheckElementActive(ele)){
+      const string name=sxml->GetAttributeStr(ele,"name");
+      if(name.empty() || int(name.find_first_of("/\\:*?\"<>| "))>=0)Run_ExceptioonFile(fun::PrintStr("The stream name \'%s\' is invalid.",name.c_str()),sxml->ErrGetFileRow(ele));
+      for(unsigned c=0;c<GetCount();c++)if(List[c]->Name==name)Run_ExceptioonFile(fun::PrintStr("The stream name \'%s\' already exists.",name.c_str()),sxml->ErrGetFileRow(ele));
+      JDsOutputPartsStream* st=new JDsOutputPartsStream(GetCount(),name);
+      List.push_back(st);
+      st->LoadXml(sxml,ele,MkInfo,timeoutdef);
+    }
+    ele=ele->NextSiblingElement("stream");
+  }
+}
+
+//==============================================================================
+/// Shows object configuration using Log.
+//==============================================================================
+void JDsOutputParts::VisuConfig(std::string txhead,std::string txfoot)const{
+  if(!txhead.empty())Log->Print(txhead);
+  for(unsigned c=0;c<GetCount();c++){
+    std::vector<std::string> lines;
+    List[c]->GetConfig(lines);
+    for(unsigned i=0;i<unsigned(lines.size());i++)Log->Print(lines[i]);
+  }
+  if(!txfoot.empty())Log->Print(txfoot);
+}
+
+//==============================================================================
+/// Configures output files of streams. First PART is saved at timestep.
+//==============================================================================
+void JDsOutputParts::ConfigSave(const std::string &dirdataout,const JPartDataHead *parthead
+  ,unsigned piece,unsigned npiece,double timestep)
+{
+  for(unsigned c=0;c<GetCount();c++){
+    JDsOutputPartsStream* st=List[c];
+    st->ConfigSave(dirdataout+"Stream_"+st->Name,parthead,piece,npiece,timestep);
+    Log->AddFileInfo(st->GetDirOut()+"Part_????.bi4",fun::PrintStr("Binary file with filtered particle data of output stream \'%s\'.",st->Name.c_str()));
+  }
+}
+
+//==============================================================================
+/// Returns true when some stream must save data.
+//==============================================================================
+bool JDsOutputParts::CheckTime(double timestep)const{
+  bool ret=false;
+  for(unsigned c=0;c<GetCount() && !ret;c++)ret=List[c]->CheckTime(timestep);
+  return(ret);
+}
+
+//==============================================================================
+/// Filters and saves particle data of streams whose output time was reached.
+/// Particle data must not include periodic particles.
+//==============================================================================
+void JDsOutputParts::SaveData(double timestep,unsigned nstep,unsigned np
+  ,const unsigned *idp,const tdouble3 *pos,const tfloat3 *vel,const float *rhop
+  ,const typecode *code,bool posdouble,tdouble3 domainmin,tdouble3 domainmax)
+{
+  unsigned *sel=NULL;
+  for(unsigned c=0;c<GetCount();c++)if(List[c]->CheckTime(timestep)){
+    JDsOutputPartsStream* st=List[c];
+    if(!sel)sel=new unsigned[np];
+    const unsigned nsel=st->FilterParticles(np,idp,pos,code,MkInfo,sel);
+    //-Gathers data of selected particles.
+    unsigned *idp2 =new unsigned[nsel];
+    tdouble3 *pos2 =new tdouble3[nsel];
+    tfloat3  *vel2 =new tfloat3 [nsel];
+    float    *rhop2=new float   [nsel];
+    const int n=int(nsel);
+    #ifdef OMP_USE
+      #pragma omp parallel for schedule (static) if(n>OMP_LIMIT_COMPUTELIGHT)
+    #endif
+    for(int p=0;p<n;p++){
+      const unsigned p1=sel[p];
+      idp2[p]=idp[p1]; pos2[p]=pos[p1]; vel2[p]=vel[p1]; rhop2[p]=rhop[p1];
+    }
+    st->SavePart(timestep,nstep,nsel,idp2,pos2,vel2,rhop2,posdouble,domainmin,domainmax);
+    delete[] idp2;
+    delete[] pos2;
+    delete[] vel2;
+    delete[] rhop2;
+  }
+  delete[] sel;
+}
+
@@ -0,0 +1,153 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Gestiona flujos de salida de particulas filtradas (caja, mk, tipo) y
+//:#   diezmadas, cada uno con su propio tiempo de salida (JDsOutputTime) y
+//:#   su propia serie de ficheros bi4. (19-10-2026)
+//:#############################################################################
+
+/// \file JDsOutputParts.h \brief Declares the classes \ref JDsOutputPartsStream and \ref JDsOutputParts.
+
+#ifndef _JDsOutputParts_
+#define _JDsOutputParts_
+
+#include <string>
+#include <vector>
+#include "JObject.h"
+#include "DualSphDef.h"
+
+class JXml;
+class TiXmlElement;
+class JLog2;
+class JSphMk;
+class JDsOutputTime;
+class JPartDataHead;
+class JPartDataBi4;
+
+//##############################################################################
+//# XML format in _FmtXML_OutputParts.xml.
+//##############################################################################
+//  <outputparts>
+//    <stream name="Structure">
+//      <timeout value="0.01" comment="Output time interval (default=TimeOut)" />
+//      <tout time="2" timeout="0.005" comment="Optional variable output time (as special.timeout)" />
+//      <decimation value="1" comment="Saves particles with Idp%decimation==0 (default=1)" />
+//      <box>
+//        <posmin x="0.5" y="-1" z="0" />
+//        <posmax x="1.5" y="1" z="1" />
+//      </box>
+//      <mk value="11,21-23" comment="Selected mk values (default=all)" />
+//      <types value="fluid,floating" comment="Selected types: fixed,moving,floating,bound,fluid (default=all)" />
+//    </stream>
+//  </outputparts>
+
+//##############################################################################
+//# JDsOutputPartsStream
+//##############################################################################
+/// \brief Manages the configuration and files of one stream of filtered particle output.
+
+class JDsOutputPartsStream : protected JObject
+{
+public:
+  ///Bits to select particle types.
+  typedef enum{ TYPE_Fixed=1,TYPE_Moving=2,TYPE_Floating=4,TYPE_Fluid=8,TYPE_All=15 }TpTypeSel;
+
+public:
+  const unsigned Idx;       ///<Index of stream.
+  const std::string Name;   ///<Name of stream.
+
+protected:
+  unsigned Decimation;      ///<Saves particles with idp%Decimation==0 (1 saves all selected particles).
+  bool UseBox;              ///<Uses box filter.
+  tdouble3 BoxMin;          ///<Minimum position of box filter.
+  tdouble3 BoxMax;          ///<Maximum position of box filter.
+  std::string MkFilter;     ///<List of selected mk values (empty means all).
+  byte TypeSel;             ///<Selected particle types (combination of TpTypeSel values).
+
+  std::vector<byte> BlockSel; ///<Selection of each mk block according to mk and type filters [MkInfo->Size()].
+  bool SelOther;            ///<Selection of particles without mk block (inlet/outlet fluid).
+
+  JDsOutputTime *OutTime;   ///<Output time configuration.
+  double TimeNext;          ///<Next time to save data.
+  unsigned Part;            ///<Number of next PART of the stream.
+  std::string DirOut;       ///<Directory for output files of the stream.
+  JPartDataBi4 *DataBi4;    ///<To store particle data in bi4 files.
+
+  unsigned LastNsel;        ///<Number of selected particles in last saved PART.
+
+  void ReadXml(const JXml *sxml,TiXmlElement* ele,double timeoutdef);
+  void ConfigBlockSel(const JSphMk *mkinfo);
+
+public:
+  JDsOutputPartsStream(unsigned idx,const std::string &name);
+  ~JDsOutputPartsStream();
+  void Reset();
+
+  void LoadXml(const JXml *sxml,TiXmlElement* ele,const JSphMk *mkinfo,double timeoutdef);
+  void ConfigSave(const std::string &dirout,const JPartDataHead *parthead,unsigned piece,unsigned npiece,double timestep);
+  void GetConfig(std::vector<std::string> &lines)const;
+
+  bool CheckTime(double timestep)const{ return(timestep>=TimeNext); }
+  double GetTimeNext()const{ return(TimeNext); }
+  std::string GetDirOut()const{ return(DirOut); }
+
+  unsigned FilterParticles(unsigned np,const unsigned *idp,const tdouble3 *pos
+    ,const typecode *code,const JSphMk *mkinfo,unsigned *sel)const;
+  void SavePart(double timestep,unsigned nstep,unsigned nsel,const unsigned *idp
+    ,const tdouble3 *pos,const tfloat3 *vel,const float *rhop,bool posdouble
+    ,tdouble3 domainmin,tdouble3 domainmax);
+};
+
+
+//##############################################################################
+//# JDsOutputParts
+//##############################################################################
+/// \brief Manages the streams of filtered and decimated particle output.
+
+class JDsOutputParts : protected JObject
+{
+protected:
+  JLog2 *Log;
+  const JSphMk *MkInfo;
+  std::vector<JDsOutputPartsStream*> List;
+
+  void ReadXml(const JXml *sxml,TiXmlElement* lis,double timeoutdef);
+
+public:
+  JDsOutputParts(JLog2 *log);
+  ~JDsOutputParts();
+  void Reset();
+
+  void LoadXml(const JXml *sxml,const std::string &place,const JSphMk *mkinfo,double timeoutdef);
+  void VisuConfig(std::string txhead,std::string txfoot)const;
+  void ConfigSave(const std::string &dirdataout,const JPartDataHead *parthead,unsigned piece,unsigned npiece,double timestep);
+
+  unsigned GetCount()const{ return(unsigned(List.size())); }
+  bool CheckTime(double timestep)const;
+
+  void SaveData(double timestep,unsigned nstep,unsigned np,const unsigned *idp
+    ,const tdouble3 *pos,const tfloat3 *vel,const float *rhop,const typecode *code
+    ,bool posdouble,tdouble3 domainmin,tdouble3 domainmax);
+};
+
+#endif
+
+
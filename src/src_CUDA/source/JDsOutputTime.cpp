@@ -89,6 +89,17 @@ void JDsOutputTime::Config(std::string filexml,const std::string &place,double t
   else SpecialConfig=true;
 }
 
+//==============================================================================
+/// Configures object using the <tout> elements of a given XML element.
+//==============================================================================
+void JDsOutputTime::Config(const JXml *sxml,TiXmlElement* ele,double timeoutdef){
+  Reset();
+  if(ele)ReadXml(sxml,ele);
+  //-It uses timeoutdef when there is not special configuration in the XML element.
+  if(!GetCount())Config(timeoutdef);
+  else SpecialConfig=true;
+}
+
 //==============================================================================
 /// Checks and adds new value of timeout. (returns true if it is wrong).
 //==============================================================================
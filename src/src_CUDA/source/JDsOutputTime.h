@@ -27,6 +27,7 @@
 //:# - Improved exception managment. (18-03-2020)
 //:# - Comprueba opcion active en elementos de primer y segundo nivel. (19-03-2020)  
 //:# - Cambio de nombre de J.TimeOut a J.DsOutputTime. (28-06-2020)
+//:# - Nuevo metodo Config() para cargar la configuracion de un elemento XML. (19-10-2026)
 //:#############################################################################
 
 /// \file JDsOutputTime.h \brief Declares the class \ref JDsOutputTime.
@@ -80,6 +81,7 @@ public:
   void Reset();
   void Config(double timeoutdef);
   void Config(std::string filexml,const std::string &place,double timeoutdef);
+  void Config(const JXml *sxml,TiXmlElement* ele,double timeoutdef);
   bool UseSpecialConfig()const{ return(SpecialConfig); }
   void VisuConfig(JLog2 *log,std::string txhead,std::string txfoot);
   double GetNextTime(double t);
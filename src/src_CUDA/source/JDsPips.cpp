@@ -19,7 +19,6 @@
 /// \file JDsPips.cpp \brief Implements the class \ref JDsPips.
 
 #include "JDsPips.h"
-#include "JCellSearch_inline.h"
 #include "JLog2.h"
 #include "JAppInfo.h"
 #include "Functions.h"
@@ -31,6 +30,8 @@
 #include <climits>
 #include <cfloat>
 #include <cstring>
+#include <cmath>
+#include <algorithm>
 
 using namespace std;
 
@@ -48,6 +49,16 @@ JDsPips::JDsPips(bool cpu,unsigned stepsnum,bool svdata,unsigned ntimes,JLog2* l
   NewData=0;
   SizeResultAux=0;
   ResultAux=NULL;
+  Sim2D=false;
+  CellMode=CELLMODE_None;
+  OmpThreads=0;
+  NumRegions=0;
+  memset(Model,0,sizeof(StPipsModel)*PIPSK_COUNT);
+  memset(&Sample,0,sizeof(StPipsSampleCpu));
+  SampleCounts=NULL;
+  SampleArmed=false;
+  memset(&SampleHead,0,sizeof(StPipsInfo));
+  NumSamples=0;
   //Reset();
 }
 
@@ -59,13 +70,17 @@ JDsPips::~JDsPips(){
   //Reset();
   SizeResultAux=0;
   delete[] ResultAux; ResultAux=NULL;
+  delete[] SampleCounts; SampleCounts=NULL;
 }
 
 //==============================================================================
 /// Returns the allocated memory.
 //==============================================================================
 long long JDsPips::GetAllocMemory()const{
-  return(sizeof(StPipsInfo)*int(Data.capacity()));
+  long long s=sizeof(StPipsInfo)*int(Data.capacity());
+  if(SampleCounts)s+=sizeof(ullong)*OmpThreads*Sample.stride;
+  s+=sizeof(ullong)*RegCounts.capacity();
+  return(s);
 }
 
 //==============================================================================
@@ -122,7 +137,12 @@ void JDsPips::SaveData(){
     scsv.SetHead();
     scsv << "Time [s];RunTime [s];Nstep";
     scsv << "RealFluid [PIs];RealBound [PIs];ChkFluid [PIs];ChkBound [PIs]";
-    scsv << "GPIPS;SumRealFluid [GPIs];SumRealBound [GPIs];SumChkFluid [GPIs];SumChkBound [GPIs]" << jcsv::Endl();
+    scsv << "GPIPS;SumRealFluid [GPIs];SumRealBound [GPIs];SumChkFluid [GPIs];SumChkBound [GPIs]";
+    if(Cpu){
+      scsv << "ChkFluidFluid [PIs];RealFluidFluid [PIs];ChkFluidBound [PIs];RealFluidBound [PIs]";
+      scsv << "ChkBoundFluid [PIs];RealBoundFluid [PIs]";
+    }
+    scsv << jcsv::Endl();
     scsv.SetData();
     for(unsigned c=NewData;c<ndata;c++){
       const StPipsInfo& v=Data[c];
@@ -134,7 +154,9 @@ void JDsPips::SaveData(){
       const double t=(c>0? Data[c].tsim - Data[c-1].tsim: 1);
       const double gpips=gpis/t;
       scsv << v.tstep << v.tsim << v.nstep << v.pirf << v.pirb << v.picf << v.picb;
-      scsv << gpips << rf << rb << cf << cb << jcsv::Endl();
+      scsv << gpips << rf << rb << cf << cb;
+      if(Cpu)for(unsigned k=0;k<PIPSK_COUNT;k++)scsv << v.kchk[k] << v.kreal[k];
+      scsv << jcsv::Endl();
     }
     NewData=ndata;
     scsv.SaveData(true);
@@ -182,83 +204,276 @@ std::string JDsPips::GetTotalPIsInfo()const{
 }
 
 //==============================================================================
-/// Compute number of particle interactions on CPU.
+/// Configures sampling of interactions on CPU and the performance model.
+/// The model counts bytes read and written without cache reuse (upper bound
+/// of memory traffic) and the floating-point operations of the main terms
+/// according to the interaction loops of JSphCpu.
 //==============================================================================
-void JDsPips::ComputeCpu(unsigned nstep,double tstep,double tsim
-  ,const StCteSph &csp,int ompthreads
-  ,unsigned np,unsigned npb,unsigned npbok
-  ,const StDivDataCpu &dvd,const unsigned *dcell,const tdouble3 *pos)
+void JDsPips::ConfigCpu(bool sim2d,TpCellMode cellmode,int ompthreads
+  ,const tdouble3 &posmin,const tdouble3 &posmax
+  ,bool floating,bool lamsps,bool ddt,bool shift)
 {
-  //-Compute bound & fluid PIs.
-  ullong npith[OMP_MAXTHREADS*OMP_STRIDE];
-  memset(npith,0,sizeof(ullong)*OMP_MAXTHREADS*OMP_STRIDE);
-  //-Counts bound PIs;
-  const int inpbok=int(npbok);
-  #ifdef OMP_USE
-    #pragma omp parallel for schedule (guided)
-  #endif
-  for(int p1=0;p1<inpbok;p1++){
-    unsigned picb=0,pirb=0;
-    const tdouble3 posp1=pos[p1];
-    //-Search for fluid neighbours in adjacent cells.
-    const StNgSearch ngs=nsearch::Init(dcell[p1],false,dvd);
-    for(int z=ngs.zini;z<ngs.zfin;z++)for(int y=ngs.yini;y<ngs.yfin;y++){
-      const tuint2 pif=nsearch::ParticleRange(y,z,ngs,dvd);
-      for(unsigned p2=pif.x;p2<pif.y;p2++){
-        const float rr2=nsearch::Distance2(posp1,pos[p2]);
-        if(rr2<=csp.kernelsize2 && rr2>=ALMOSTZERO)pirb++;
-        picb++;
-      }
+  Sim2D=sim2d;
+  CellMode=cellmode;
+  OmpThreads=unsigned(ompthreads>0? ompthreads: 1);
+  //-Regions of the domain.
+  Sample.nreg=TInt3(PIPSREG_DIV,(Sim2D? 1: PIPSREG_DIV),PIPSREG_DIV);
+  NumRegions=unsigned(Sample.nreg.x*Sample.nreg.y*Sample.nreg.z);
+  const tdouble3 size=posmax-posmin;
+  Sample.regposmin=posmin;
+  Sample.regovsize.x=(size.x>0? Sample.nreg.x/size.x: 0);
+  Sample.regovsize.y=(size.y>0? Sample.nreg.y/size.y: 0);
+  Sample.regovsize.z=(size.z>0? Sample.nreg.z/size.z: 0);
+  //-Allocates counters of threads.
+  Sample.stride=((NumRegions*PIPSK_COUNT*PIPSC_COUNT+7)/8)*8;
+  delete[] SampleCounts; SampleCounts=NULL;
+  try{
+    SampleCounts=new ullong[OmpThreads*Sample.stride];
+  }
+  catch(const std::bad_alloc){
+    Run_Exceptioon("Could not allocate the requested memory.");
+  }
+  Sample.counts=SampleCounts;
+  RegCounts.assign(NumRegions*PIPSK_COUNT*PIPSC_COUNT,0);
+  NumSamples=0;
+  //-Performance model.
+  const double codebytes=(floating? sizeof(typecode): 0);
+  for(unsigned k=0;k<PIPSK_COUNT;k++){
+    StPipsModel &m=Model[k];
+    m.chkbytes=sizeof(tdouble3);             //-pos[p2].
+    m.rangebytes=sizeof(unsigned)*2;         //-begincell[] of cell range.
+    m.chkflops=8;                            //-Distance.
+    if(k==PIPSK_BoundFluid){
+      m.realbytes=sizeof(tfloat4)+codebytes; //-velrhop[p2], code[p2].
+      m.partbytes=sizeof(tdouble3)+sizeof(tfloat4)+sizeof(unsigned)+sizeof(float)*2;
+      m.realflops=18+11+7;                   //-Kernel, continuity and viscdt.
+    }
+    else{
+      m.realbytes=sizeof(tfloat4)+sizeof(float)+codebytes; //-velrhop[p2], press[p2], code[p2].
+      if(lamsps && k==PIPSK_FluidFluid)m.realbytes+=sizeof(tsymatrix3f); //-tau[p2].
+      m.partbytes=sizeof(tdouble3)+sizeof(tfloat4)+sizeof(float)+sizeof(unsigned)+codebytes
+        +(sizeof(float)+sizeof(tfloat3))*2;  //-pos,velrhop,press,dcell,code and ar,ace (read+write).
+      if(ddt)m.partbytes+=sizeof(float)*2;
+      if(shift)m.partbytes+=sizeof(tfloat4)*2;
+      if(lamsps)m.partbytes+=sizeof(tsymatrix3f)*3;
+      m.realflops=18+10+9+(lamsps? 80: 21);  //-Kernel, momentum, continuity and viscosity.
+      if(ddt)m.realflops+=14;
+      if(shift)m.realflops+=12;
     }
-    //-Sum results.
-    const int cth=omp_get_thread_num()*OMP_STRIDE;
-    npith[cth  ]+=picb;
-    npith[cth+1]+=pirb;
   }
-  //-Counts fluid PIs;
-  const int inpb=int(npb);
-  const int inp =int(np);
-  #ifdef OMP_USE
-    #pragma omp parallel for schedule (guided)
-  #endif
-  for(int p1=inpb;p1<inp;p1++){
-    unsigned picf=0,pirf=0;
-    const tdouble3 posp1=pos[p1];
-    //-Search for bound & fluid neighbours in adjacent cells.
-    for(byte tpfluid=0;tpfluid<=1;tpfluid++){
-      const StNgSearch ngs=nsearch::Init(dcell[p1],!tpfluid,dvd);
-      for(int z=ngs.zini;z<ngs.zfin;z++)for(int y=ngs.yini;y<ngs.yfin;y++){
-        const tuint2 pif=nsearch::ParticleRange(y,z,ngs,dvd);
-        for(unsigned p2=pif.x;p2<pif.y;p2++){
-          const float rr2=nsearch::Distance2(posp1,pos[p2]);
-          if(rr2<=csp.kernelsize2 && rr2>=ALMOSTZERO)pirf++;
-          picf++;
+}
+
+//==============================================================================
+/// Enables counting of interactions in the next interaction of particles.
+//==============================================================================
+void JDsPips::SampleArm(unsigned nstep,double tstep,double tsim){
+  if(SampleCounts){
+    memset(&SampleHead,0,sizeof(StPipsInfo));
+    SampleHead.nstep=nstep;
+    SampleHead.tstep=tstep;
+    SampleHead.tsim=tsim;
+    memset(SampleCounts,0,sizeof(ullong)*OmpThreads*Sample.stride);
+    SampleArmed=true;
+  }
+}
+
+//==============================================================================
+/// Sums counters of threads and stores results of the armed sample.
+//==============================================================================
+void JDsPips::SampleEnd(){
+  if(SampleArmed){
+    StPipsInfo v=SampleHead;
+    const unsigned nc=NumRegions*PIPSK_COUNT*PIPSC_COUNT;
+    for(unsigned th=0;th<OmpThreads;th++){
+      const ullong *cth=SampleCounts+Sample.stride*th;
+      for(unsigned c=0;c<nc;c++)if(cth[c]){
+        RegCounts[c]+=cth[c];
+        const unsigned k=(c/PIPSC_COUNT)%PIPSK_COUNT;
+        switch(c%PIPSC_COUNT){
+          case 0: v.kchk  [k]+=cth[c];  break;
+          case 1: v.kreal [k]+=cth[c];  break;
+          case 2: v.krange[k]+=cth[c];  break;
+          case 3: v.kpart [k]+=cth[c];  break;
         }
       }
     }
-    //-Sum results.
-    const int cth=omp_get_thread_num()*OMP_STRIDE;
-    npith[cth+2]+=picf;
-    npith[cth+3]+=pirf;
+    v.picf=v.kchk [PIPSK_FluidFluid]+v.kchk [PIPSK_FluidBound];
+    v.pirf=v.kreal[PIPSK_FluidFluid]+v.kreal[PIPSK_FluidBound];
+    v.picb=v.kchk [PIPSK_BoundFluid];
+    v.pirb=v.kreal[PIPSK_BoundFluid];
+    Data.push_back(v);
+    NextNstep+=StepsNum;
+    NumSamples++;
+    SampleArmed=false;
   }
-  //-Sum total results.
-  StPipsInfo v;
-  v.nstep=nstep;
-  v.tstep=tstep;
-  v.tsim= tsim;
-  v.pirf=v.pirb=v.picf=v.picb=0;
-  for(int th=0;th<ompthreads;th++){
-    int cth=th*OMP_STRIDE;
-    v.picb+=npith[cth++];
-    v.pirb+=npith[cth++];
-    v.picf+=npith[cth++];
-    v.pirf+=npith[cth  ];
+}
+
+//==============================================================================
+/// Closes the armed sample when no more interactions are computed (end of
+/// simulation) using the counters of the last sample.
+//==============================================================================
+void JDsPips::SampleClose(){
+  if(SampleArmed){
+    StPipsInfo v=(Data.empty()? SampleHead: Data.back());
+    v.nstep=SampleHead.nstep;
+    v.tstep=SampleHead.tstep;
+    v.tsim =SampleHead.tsim;
+    Data.push_back(v);
+    NextNstep+=StepsNum;
+    SampleArmed=false;
   }
-  //-Stores results.
-  Data.push_back(v);
-  NextNstep+=StepsNum;
-  
-  //if(1)Log->Printf("%u> PIf: %llu/%llu   PIb: %llu/%llu",v.nstep,v.pirf,v.picf,v.pirb,v.picb);
+}
+
+//==============================================================================
+/// Returns sum of counter cv of interaction type kind in all regions and samples.
+//==============================================================================
+double JDsPips::GetSumType(unsigned kind,unsigned cv)const{
+  ullong v=0;
+  for(unsigned r=0;r<NumRegions;r++)v+=RegCounts[(r*PIPSK_COUNT+kind)*PIPSC_COUNT+cv];
+  return(double(v));
+}
+
+//==============================================================================
+/// Returns checked interactions, cell ranges, bytes and floating-point operations
+/// per sample of interaction type kind for the requested cell mode. Values of
+/// the cell mode of simulation are measured and values of the other mode are
+/// estimated with the size of the search box (Full:3 cells of KernelSize, 
+/// Half:5 cells of KernelSize/2) since real interactions do not change.
+//==============================================================================
+void JDsPips::GetModelValues(unsigned kind,TpCellMode cellmode,double &chk,double &range
+  ,double &bytes,double &flops)const
+{
+  const double ns=(NumSamples? NumSamples: 1);
+  chk=GetSumType(kind,0)/ns;
+  const double real=GetSumType(kind,1)/ns;
+  range=GetSumType(kind,2)/ns;
+  const double part=GetSumType(kind,3)/ns;
+  if(cellmode!=CellMode){
+    const unsigned dim=(Sim2D? 2: 3);
+    const double boxcur=(CellMode==CELLMODE_Half? 2.5: 3.),boxnew=(cellmode==CELLMODE_Half? 2.5: 3.);
+    const double ncur  =(CellMode==CELLMODE_Half? 5. : 3.),nnew  =(cellmode==CELLMODE_Half? 5. : 3.);
+    chk=max(real,chk*pow(boxnew/boxcur,double(dim)));
+    range=range*pow(nnew/ncur,double(dim-1));
+  }
+  const StPipsModel &m=Model[kind];
+  bytes=chk*m.chkbytes + real*m.realbytes + range*m.rangebytes + part*m.partbytes;
+  flops=chk*m.chkflops + real*m.realflops;
+}
+
+//==============================================================================
+/// Returns the sum of all interaction types of the performance model for the
+/// given cell mode (values per sampled interaction, estimated when cellmode
+/// is not the current one).
+//==============================================================================
+void JDsPips::GetModelCellMode(TpCellMode cellmode,double &chk,double &real
+  ,double &range,double &bytes)const
+{
+  const double ns=(NumSamples? NumSamples: 1);
+  chk=real=range=bytes=0;
+  for(unsigned k=0;k<PIPSK_COUNT;k++){
+    double c,r,b,f;
+    GetModelValues(k,cellmode,c,r,b,f);
+    chk+=c; range+=r; bytes+=b;
+    real+=GetSumType(k,1)/ns;
+  }
+}
+
+//==============================================================================
+/// Changes the cell mode of the simulation and discards the counters of the
+/// performance model obtained with the previous cell mode.
+//==============================================================================
+void JDsPips::ResetModel(TpCellMode cellmode){
+  CellMode=cellmode;
+  RegCounts.assign(RegCounts.size(),0);
+  NumSamples=0;
+}
+
+//==============================================================================
+/// Shows performance model of the sampled interactions using Log.
+//==============================================================================
+void JDsPips::VisuModel()const{
+  if(!NumSamples)return;
+  const char* names[PIPSK_COUNT]={"Fluid-Fluid","Fluid-Bound","Bound-Fluid"};
+  Log->Printf("\n[PIPS performance model] (%u samples on CPU, cell mode %s, values per interaction)",NumSamples,GetNameCellMode(CellMode));
+  Log->Print("  Type           Checked         Real   Eff[%]   Ranges  Bytes/PI  Flops/PI  AI[flop/B]");
+  const double ns=NumSamples;
+  double tchk=0,treal=0,trange=0,tbytes=0,tflops=0;
+  for(unsigned k=0;k<PIPSK_COUNT;k++){
+    double chk,range,bytes,flops;
+    GetModelValues(k,CellMode,chk,range,bytes,flops);
+    const double real=GetSumType(k,1)/ns;
+    tchk+=chk; treal+=real; trange+=range; tbytes+=bytes; tflops+=flops;
+    Log->Printf("  %-11s %12.0f %12.0f %8.2f %8.0f %9.1f %9.1f %11.3f",names[k],chk,real
+      ,(chk? real*100/chk: 0),range,(real? bytes/real: 0),(real? flops/real: 0),(bytes? flops/bytes: 0));
+  }
+  Log->Printf("  %-11s %12.0f %12.0f %8.2f %8.0f %9.1f %9.1f %11.3f","Total",tchk,treal
+    ,(tchk? treal*100/tchk: 0),trange,(treal? tbytes/treal: 0),(treal? tflops/treal: 0),(tbytes? tflops/tbytes: 0));
+  //-Comparison of cell modes.
+  for(unsigned cm=0;cm<2;cm++){
+    const TpCellMode cellmode=(!cm? CELLMODE_Full: CELLMODE_Half);
+    double chk=0,range=0,bytes=0,flops=0;
+    for(unsigned k=0;k<PIPSK_COUNT;k++){
+      double c,r,b,f;
+      GetModelValues(k,cellmode,c,r,b,f);
+      chk+=c; range+=r; bytes+=b; flops+=f;
+    }
+    Log->Printf("  CellMode %-4s %12.0f %12.0f %8.2f %8.0f %9.1f %9.1f %11.3f  (%s)",GetNameCellMode(cellmode)
+      ,chk,treal,(chk? treal*100/chk: 0),range,(treal? bytes/treal: 0),(treal? flops/treal: 0)
+      ,(bytes? flops/bytes: 0),(cellmode==CellMode? "measured": "estimated"));
+  }
+  //-Load of regions.
+  double rmax=0,rsum=0;
+  unsigned rused=0;
+  for(unsigned r=0;r<NumRegions;r++){
+    double real=0;
+    for(unsigned k=0;k<PIPSK_COUNT;k++)real+=double(RegCounts[(r*PIPSK_COUNT+k)*PIPSC_COUNT+1]);
+    if(real){ rused++; rsum+=real; rmax=max(rmax,real); }
+  }
+  Log->Printf("  Regions (%dx%dx%d): %u with interactions, max/mean real PIs: %.3f",Sample.nreg.x,Sample.nreg.y,Sample.nreg.z
+    ,rused,(rsum? rmax/(rsum/rused): 0));
+}
+
+//==============================================================================
+/// Saves CSV file with performance model per interaction type, cell mode and
+/// region (values per interaction of particles).
+//==============================================================================
+void JDsPips::SaveModelCsv(const std::string &file,bool csvsepcoma)const{
+  if(!NumSamples)return;
+  const char* names[PIPSK_COUNT]={"Fluid-Fluid","Fluid-Bound","Bound-Fluid"};
+  const double ns=NumSamples;
+  jcsv::JSaveCsv2 scsv(file,false,csvsepcoma);
+  Log->AddFileInfo(file,"Saves CSV with performance model of PIPS per interaction type, cell mode and region.");
+  scsv.SetHead();
+  scsv << "Region;Rx;Ry;Rz;Type;CellMode;Estimated;Particles;Checked;Real;Efficiency [%]";
+  scsv << "Ranges;Bytes;Flops;Bytes/PI;Flops/PI;AI [flop/byte]" << jcsv::Endl();
+  scsv.SetData();
+  scsv << jcsv::Fmt(jcsv::TpDouble1,"%.6g");
+  //-Domain per interaction type and cell mode.
+  for(unsigned cm=0;cm<2;cm++)for(unsigned k=0;k<PIPSK_COUNT;k++){
+    const TpCellMode cellmode=(!cm? CELLMODE_Full: CELLMODE_Half);
+    double chk,range,bytes,flops;
+    GetModelValues(k,cellmode,chk,range,bytes,flops);
+    const double real=GetSumType(k,1)/ns;
+    const double part=GetSumType(k,3)/ns;
+    scsv << "All" << "" << "" << "" << names[k] << GetNameCellMode(cellmode) << (cellmode!=CellMode? 1u: 0u);
+    scsv << part << chk << real << (chk? real*100/chk: 0) << range << bytes << flops;
+    scsv << (real? bytes/real: 0) << (real? flops/real: 0) << (bytes? flops/bytes: 0) << jcsv::Endl();
+  }
+  //-Regions of the domain (measured cell mode).
+  for(unsigned r=0;r<NumRegions;r++)for(unsigned k=0;k<PIPSK_COUNT;k++){
+    const ullong *c=RegCounts.data()+(r*PIPSK_COUNT+k)*PIPSC_COUNT;
+    if(c[3]){
+      const StPipsModel &m=Model[k];
+      const double chk=c[0]/ns,real=c[1]/ns,range=c[2]/ns,part=c[3]/ns;
+      const double bytes=chk*m.chkbytes + real*m.realbytes + range*m.rangebytes + part*m.partbytes;
+      const double flops=chk*m.chkflops + real*m.realflops;
+      const unsigned rx=r%Sample.nreg.x,ry=(r/Sample.nreg.x)%Sample.nreg.y,rz=r/(Sample.nreg.x*Sample.nreg.y);
+      scsv << r << rx << ry << rz << names[k] << GetNameCellMode(CellMode) << 0u;
+      scsv << part << chk << real << (chk? real*100/chk: 0) << range << bytes << flops;
+      scsv << (real? bytes/real: 0) << (real? flops/real: 0) << (bytes? flops/bytes: 0) << jcsv::Endl();
+    }
+  }
+  scsv.SaveData(true);
 }
 
 #ifdef _WITHGPU
@@ -308,6 +523,7 @@ void JDsPips::ComputeGpu(unsigned nstep,double tstep,double tsim
     totncb+=ResultAux[c4++];
   }
   StPipsInfo v;
+  memset(&v,0,sizeof(StPipsInfo));
   v.nstep=nstep;
   v.tstep=tstep;
   v.tsim= tsim;
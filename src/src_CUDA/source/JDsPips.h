@@ -21,6 +21,13 @@
 //:# =========
 //:# - Contabiliza numero de interacciones entre particulas para calcular PIPS
 //:#   (Particle Interactions Per Second). 03-06-2020
+//:# - En CPU los contadores se obtienen en los bucles reales de interaccion en
+//:#   los pasos muestreados (sin recorrido duplicado de vecinos) y se desglosan
+//:#   por tipo de interaccion (Fluid-Fluid, Fluid-Bound, Bound-Fluid) y region
+//:#   del dominio. Modelo de rendimiento con bytes por interaccion, intensidad
+//:#   aritmetica y estimacion para CELLMODE_Full y CELLMODE_Half. (19-10-2026)
+//:# - Coste total del modelo por modo de celda (GetModelCellMode()) y reinicio
+//:#   del modelo al cambiar el modo de celda durante la simulacion. (19-10-2026)
 //:#############################################################################
 
 /// \file JDsPips.h \brief Declares the class \ref JDsPips.
@@ -42,6 +49,53 @@
 
 class JLog2;
 
+///Types of interaction counted in the sampled steps on CPU.
+typedef enum{
+   PIPSK_FluidFluid=0   ///<Fluid/Float particles with fluid cells.
+  ,PIPSK_FluidBound=1   ///<Fluid/Float particles with bound cells.
+  ,PIPSK_BoundFluid=2   ///<Bound particles with fluid cells.
+}TpPipsKind;
+
+#define PIPSK_COUNT 3        ///<Number of types of interaction.
+#define PIPSC_COUNT 4        ///<Counters per region and type: checked, real, cell ranges and particles.
+#define PIPSREG_DIV 4        ///<Number of regions per axis of the domain.
+
+///Structure to count interactions in the interaction loops on CPU.
+typedef struct{
+  ullong *counts;       ///<Counters of each thread [ompthreads*stride] (NULL: sampling is disabled).
+  unsigned stride;      ///<Number of counters of each thread (multiple of 8 to avoid false sharing).
+  tint3 nreg;           ///<Number of regions per axis.
+  tdouble3 regposmin;   ///<Lower limit of regions.
+  tdouble3 regovsize;   ///<Inverse of size of regions.
+}StPipsSampleCpu;
+
+//==============================================================================
+/// Returns pointer to the counters of current thread (NULL when sampling is disabled).
+//==============================================================================
+inline ullong* PipsThreadCounts(const StPipsSampleCpu *pipss,int th){
+  return(pipss? pipss->counts+pipss->stride*th: NULL);
+}
+
+//==============================================================================
+/// Adds counters of one particle according to its region and interaction type.
+//==============================================================================
+inline void PipsAddCounts(const StPipsSampleCpu *pipss,ullong *cth,const tdouble3 &pos
+  ,TpPipsKind kind,unsigned nchk,unsigned nreal,unsigned nrange)
+{
+  int rx=int((pos.x-pipss->regposmin.x)*pipss->regovsize.x);
+  int ry=int((pos.y-pipss->regposmin.y)*pipss->regovsize.y);
+  int rz=int((pos.z-pipss->regposmin.z)*pipss->regovsize.z);
+  rx=(rx<0? 0: (rx>=pipss->nreg.x? pipss->nreg.x-1: rx));
+  ry=(ry<0? 0: (ry>=pipss->nreg.y? pipss->nreg.y-1: ry));
+  rz=(rz<0? 0: (rz>=pipss->nreg.z? pipss->nreg.z-1: rz));
+  const unsigned reg=unsigned(rx+pipss->nreg.x*(ry+pipss->nreg.y*rz));
+  ullong *c=cth+(reg*PIPSK_COUNT+kind)*PIPSC_COUNT;
+  c[0]+=nchk;
+  c[1]+=nreal;
+  c[2]+=nrange;
+  c[3]++;
+}
+
 //##############################################################################
 //# JDsPips
 //##############################################################################
@@ -59,8 +113,22 @@ typedef struct{
   ullong pirb;     ///<Real particle interactions between bound particles with other particles.
   ullong picf;     ///<Checked particle interactions between fluid particles with other particles.
   ullong picb;     ///<Checked particle interactions between bound particles with other particles.
+  ullong kchk[PIPSK_COUNT];   ///<Checked interactions of each type (only CPU).
+  ullong kreal[PIPSK_COUNT];  ///<Real interactions of each type (only CPU).
+  ullong krange[PIPSK_COUNT]; ///<Cell ranges visited of each type (only CPU).
+  ullong kpart[PIPSK_COUNT];  ///<Particles of each type (only CPU).
 }StPipsInfo;
 
+///Structure with the performance model of an interaction type.
+typedef struct{
+  double chkbytes;   ///<Bytes read per checked interaction (position of p2).
+  double realbytes;  ///<Additional bytes read per real interaction (data of p2).
+  double rangebytes; ///<Bytes read per cell range (begin and end of cell range).
+  double partbytes;  ///<Bytes read and written per particle p1.
+  double chkflops;   ///<Floating-point operations per checked interaction (distance).
+  double realflops;  ///<Additional floating-point operations per real interaction.
+}StPipsModel;
+
 protected:
   JLog2* Log;
 
@@ -71,11 +139,27 @@ protected:
   unsigned SizeResultAux;
   ullong* ResultAux;  //-To copy final result from GPU memory. [SizeResultAux]
 
+  //-Variables for sampling on CPU.
+  bool Sim2D;                   ///<2D simulation.
+  TpCellMode CellMode;          ///<Cell division mode of simulation.
+  unsigned OmpThreads;          ///<Number of OpenMP threads.
+  unsigned NumRegions;          ///<Number of regions of the domain.
+  StPipsModel Model[PIPSK_COUNT]; ///<Performance model of each interaction type.
+  StPipsSampleCpu Sample;       ///<Counters of current sample.
+  ullong *SampleCounts;         ///<Memory for counters of threads [OmpThreads*Sample.stride].
+  bool SampleArmed;             ///<The next interaction is counted.
+  StPipsInfo SampleHead;        ///<Step data of armed sample.
+  std::vector<ullong> RegCounts; ///<Sum of counters of all samples per region [NumRegions*PIPSK_COUNT*PIPSC_COUNT].
+  unsigned NumSamples;          ///<Number of samples counted in interaction loops.
+
 
   double GetGPIs(unsigned cdata)const;
   double GetGPIsType(unsigned cdata,bool fluid)const;
   double GetCheckGPIsType(unsigned cdata,bool fluid)const;
   tdouble2 GetTotalPIs()const;
+  double GetSumType(unsigned kind,unsigned cv)const;
+  void GetModelValues(unsigned kind,TpCellMode cellmode,double &chk,double &range
+    ,double &bytes,double &flops)const;
 
 public:
   const bool Cpu;
@@ -91,14 +175,27 @@ public:
   void SaveData();
 
   double GetGPIPS(double tsim)const;
+  double GetTotalGPIs()const{ const tdouble2 v=GetTotalPIs(); return(v.x+v.y); }
   std::string GetTotalPIsInfo()const;
 
   bool CheckRun(unsigned nstep)const{ return(nstep>=NextNstep); }
 
-  void ComputeCpu(unsigned nstep,double tstep,double tsim
-    ,const StCteSph &csp,int ompthreads
-    ,unsigned np,unsigned npb,unsigned npbok
-    ,const StDivDataCpu &dvd,const unsigned *dcell,const tdouble3 *pos);
+  void ConfigCpu(bool sim2d,TpCellMode cellmode,int ompthreads
+    ,const tdouble3 &posmin,const tdouble3 &posmax
+    ,bool floating,bool lamsps,bool ddt,bool shift);
+
+  void SampleArm(unsigned nstep,double tstep,double tsim);
+  const StPipsSampleCpu* GetSampleCpu()const{ return(SampleArmed? &Sample: NULL); }
+  void SampleEnd();
+  void SampleClose();
+
+  unsigned GetNumSamples()const{ return(NumSamples); }
+  TpCellMode GetCellMode()const{ return(CellMode); }
+  void GetModelCellMode(TpCellMode cellmode,double &chk,double &real,double &range,double &bytes)const;
+  void ResetModel(TpCellMode cellmode);
+
+  void VisuModel()const;
+  void SaveModelCsv(const std::string &file,bool csvsepcoma)const;
 
 #ifdef _WITHGPU
   void ComputeGpu(unsigned nstep,double tstep,double tsim
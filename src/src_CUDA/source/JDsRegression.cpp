@@ -0,0 +1,453 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JDsRegression.cpp \brief Implements the class \ref JDsRegression.
+
+#include "JDsRegression.h"
+#include "JDsOmpTuner.h"
+#include "JSphCfgRun.h"
+#include "JAppInfo.h"
+#include "JLog2.h"
+#include "JXml.h"
+#include "JPartDataBi4.h"
+#include "Functions.h"
+#include <cmath>
+#include <cfloat>
+#include <climits>
+#include <fstream>
+#include <algorithm>
+
+using namespace std;
+
+const std::string JDsRegression::FileBaseline="RegressionBaseline.xml";
+
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JDsRegression::JDsRegression(const JSphCfgRun *cfg,const std::string &dirout,JLog2 *log)
+  :Log(log),Cfg(cfg),DirOut(fun::GetDirWithSlash(dirout)),Update(cfg->RegUpdate)
+  ,HostName(JDsOmpTuner::GetHostName())
+{
+  ClassName="JDsRegression";
+  LoadDef(Cfg->RegDef);
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JDsRegression::~JDsRegression(){
+  DestructorActive=true;
+}
+
+//==============================================================================
+/// Reads the tolerances defined in the element (undefined values are kept).
+//==============================================================================
+void JDsRegression::ReadTolerances(JXml &sxml,TiXmlElement* ele,StRegTolerances &tol)const{
+  if(ele){
+    tol.pos       =sxml.GetAttributeDouble(ele,"pos"       ,true,tol.pos);
+    tol.vel       =sxml.GetAttributeDouble(ele,"vel"       ,true,tol.vel);
+    tol.rhop      =sxml.GetAttributeDouble(ele,"rhop"      ,true,tol.rhop);
+    tol.throughput=sxml.GetAttributeDouble(ele,"throughput",true,tol.throughput);
+    if(tol.pos<0 || tol.vel<0 || tol.rhop<0 || tol.throughput<0)sxml.ErrReadElement(ele,"tolerances",false,"Tolerances can not be negative.");
+  }
+}
+
+//==============================================================================
+/// Loads definition of tests from XML file. Paths are relative to the
+/// directory of the XML file.
+//==============================================================================
+void JDsRegression::LoadDef(const std::string &filedef){
+  if(!fun::FileExists(filedef))Run_ExceptioonFile("The definition file of regression tests was not found.",filedef);
+  FileDef=filedef;
+  const string dirdef=fun::GetDirParent(filedef);
+  JXml sxml;
+  sxml.LoadFile(filedef);
+  TiXmlNode* node=sxml.GetNodeError("dsph_regression");
+  //-Reference directory.
+  TiXmlElement* ele=sxml.GetFirstElement(node,"reference");
+  DirRef=fun::GetDirWithSlash(fun::GetCanonicalPath(dirdef,sxml.GetAttributeStr(ele,"dir")));
+  //-Default configuration of cases.
+  unsigned steps=100;
+  int threads=1;
+  ele=sxml.GetFirstElement(node,"defaults",true);
+  if(ele){
+    steps=sxml.GetAttributeUnsigned(ele,"steps",true,steps);
+    threads=sxml.GetAttributeInt(ele,"threads",true,threads);
+  }
+  StRegTolerances tol={1e-4,1e-4,1e-5,0.15};
+  ReadTolerances(sxml,sxml.GetFirstElement(node,"tolerances",true),tol);
+  //-Cases.
+  TiXmlNode* nodecases=sxml.GetFirstElement(node,"cases");
+  ele=sxml.GetFirstElement(nodecases,"case",true);
+  while(ele){
+    if(sxml.CheckElementActive(ele)){
+      StRegCase c;
+      c.name=sxml.GetAttributeStr(ele,"name");
+      c.casename=fun::GetCanonicalPath(dirdef,sxml.GetAttributeStr(ele,"file"));
+      c.steps=sxml.GetAttributeUnsigned(ele,"steps",true,steps);
+      c.threads=sxml.GetAttributeInt(ele,"threads",true,threads);
+      c.tol=tol;
+      ReadTolerances(sxml,sxml.GetFirstElement(ele,"tolerances",true),c.tol);
+      if(c.name.empty() || c.name.find_first_of("/\\ ")!=string::npos)sxml.ErrReadElement(ele,"case",false,"The name of the case is invalid.");
+      if(!c.steps || c.threads<1)sxml.ErrReadElement(ele,"case",false,"Number of steps or threads is invalid.");
+      for(unsigned cc=0;cc<unsigned(Cases.size());cc++)if(Cases[cc].name==c.name)sxml.ErrReadElement(ele,"case",false,"The name of the case is repeated.");
+      Cases.push_back(c);
+    }
+    ele=sxml.GetNextElement(ele,"case",true);
+  }
+  if(Cases.empty())Run_ExceptioonFile("There are no regression cases.",filedef);
+}
+
+//==============================================================================
+/// Saves the particle state in BI4 format (dir/name.bi4).
+//==============================================================================
+void JDsRegression::SaveState(const StRegCase &c,const std::string &dir,const std::string &name
+  ,const std::vector<unsigned> &idp,const std::vector<tdouble3> &pos
+  ,const std::vector<tfloat3> &vel,const std::vector<float> &rhop)const
+{
+  //-Configuration of the case is copied from the initial state.
+  JPartDataBi4 pdc;
+  pdc.LoadFileCase(fun::GetDirParent(c.casename),fun::GetFile(c.casename));
+  const unsigned np=unsigned(idp.size());
+  tdouble3 posmin=TDouble3(0),posmax=TDouble3(0);
+  if(np){
+    posmin=posmax=pos[0];
+    for(unsigned p=1;p<np;p++){ posmin=MinValues(posmin,pos[p]); posmax=MaxValues(posmax,pos[p]); }
+  }
+  JPartDataBi4 pd;
+  pd.ConfigBasic(0,1,"",ClassName,c.name,pdc.Get_Data2d(),pdc.Get_Data2dPosY(),dir);
+  pd.ConfigParticles(pdc.Get_CaseNp(),pdc.Get_CaseNfixed(),pdc.Get_CaseNmoving(),pdc.Get_CaseNfloat()
+    ,pdc.Get_CaseNfluid(),pdc.Get_CasePosMin(),pdc.Get_CasePosMax(),pdc.Get_NpDynamic(),pdc.Get_ReuseIds());
+  pd.ConfigCtes(pdc.Get_Dp(),pdc.Get_H(),pdc.Get_B(),pdc.Get_Rhop0(),pdc.Get_Gamma(),pdc.Get_MassBound(),pdc.Get_MassFluid());
+  pd.AddPartInfo(0,c.rs.timestep,np,0,c.rs.nstep,c.rs.tsim,posmin,posmax);
+  pd.AddPartData(np,idp.data(),pos.data(),vel.data(),rhop.data());
+  fun::MkdirPath(dir);
+  pd.SaveFileCase(name);
+}
+
+//==============================================================================
+/// Compares the particle state with the reference state. Particles are
+/// matched using Idp.
+//==============================================================================
+void JDsRegression::CompareState(StRegCase &c,const std::vector<unsigned> &idp,const std::vector<tdouble3> &pos
+  ,const std::vector<tfloat3> &vel,const std::vector<float> &rhop)const
+{
+  StRegState &s=c.state;
+  const string fileref=DirRef+JPartDataBi4::GetFileNameCase(c.name);
+  s.found=fun::FileExists(fileref);
+  if(!s.found){
+    c.error="Reference state was not found (use -regupdate to create it).";
+    return;
+  }
+  //-Loads reference state.
+  JPartDataBi4 pd;
+  pd.LoadFileCase(DirRef,c.name);
+  if(pd.Get_Step()!=c.rs.nstep){
+    c.error=fun::PrintStr("Reference state was created after %u steps instead of %u.",pd.Get_Step(),c.rs.nstep);
+    return;
+  }
+  const unsigned npref=s.npref=pd.Get_Npok();
+  std::vector<unsigned> idpref(npref);
+  std::vector<tdouble3> posref(npref);
+  std::vector<tfloat3> velref(npref);
+  std::vector<float> rhopref(npref);
+  if(npref){
+    pd.Get_Idp(npref,idpref.data());
+    if(pd.Get_PosSimple()){
+      std::vector<tfloat3> posf(npref);
+      pd.Get_Pos(npref,posf.data());
+      for(unsigned p=0;p<npref;p++)posref[p]=ToTDouble3(posf[p]);
+    }
+    else pd.Get_Posd(npref,posref.data());
+    pd.Get_Vel(npref,velref.data());
+    pd.Get_Rhop(npref,rhopref.data());
+  }
+  //-Index of reference particles by Idp.
+  unsigned idmax=0;
+  for(unsigned p=0;p<npref;p++)idmax=max(idmax,idpref[p]);
+  const unsigned np=unsigned(idp.size());
+  for(unsigned p=0;p<np;p++)idmax=max(idmax,idp[p]);
+  std::vector<unsigned> ridx(size_t(idmax)+1,UINT_MAX);
+  for(unsigned p=0;p<npref;p++)ridx[idpref[p]]=p;
+  //-Compares particles.
+  const double fpos=(c.dp? 1./c.dp: 1.);
+  const double frhop=(c.rhop0? 1./c.rhop0: 1.);
+  unsigned nfound=0;
+  for(unsigned p=0;p<np;p++){
+    const unsigned pr=ridx[idp[p]];
+    if(pr==UINT_MAX){ s.nmissing++; continue; }
+    nfound++;
+    const tdouble3 dpos=pos[p]-posref[pr];
+    const tfloat3 dvel=vel[p]-velref[pr];
+    const double ep=sqrt(dpos.x*dpos.x+dpos.y*dpos.y+dpos.z*dpos.z)*fpos;
+    const double ev=sqrt(double(dvel.x)*dvel.x+double(dvel.y)*dvel.y+double(dvel.z)*dvel.z);
+    const double er=fabs(double(rhop[p])-rhopref[pr])*frhop;
+    s.maxpos=max(s.maxpos,ep);
+    s.maxvel=max(s.maxvel,ev);
+    s.maxrhop=max(s.maxrhop,er);
+    if(ep>c.tol.pos || ev>c.tol.vel || er>c.tol.rhop)s.nbad++;
+  }
+  s.nmissing+=npref-nfound;
+  s.pass=(!s.nmissing && !s.nbad && np==npref);
+}
+
+//==============================================================================
+/// Returns the baseline of the case for this host and number of threads.
+//==============================================================================
+TiXmlElement* JDsRegression::FindBaseline(JXml &sxml,const StRegCase &c)const{
+  TiXmlNode* node=sxml.GetNodeSimple("dsph_regbaseline");
+  TiXmlElement* ele=(node? node->FirstChildElement("case"): NULL);
+  while(ele){
+    if(sxml.GetAttributeStr(ele,"name",true)==c.name && sxml.GetAttributeStr(ele,"host",true)==HostName
+      && sxml.GetAttributeInt(ele,"threads",true,0)==c.threads)return(ele);
+    ele=ele->NextSiblingElement("case");
+  }
+  return(NULL);
+}
+
+//==============================================================================
+/// Compares the throughput with the baseline. Throughput is only compared
+/// with baselines of the same host, number of threads and steps.
+//==============================================================================
+void JDsRegression::CompareBaseline(StRegCase &c)const{
+  StRegSpeed &s=c.speed;
+  s.psps=(c.rs.tsim? double(c.rs.nstep)*c.rs.np/c.rs.tsim: 0);
+  s.pass=true;
+  const string filebase=DirRef+FileBaseline;
+  if(!fun::FileExists(filebase))return;
+  JXml sxml;
+  sxml.LoadFile(filebase);
+  TiXmlElement* ele=FindBaseline(sxml,c);
+  if(ele && sxml.GetAttributeUnsigned(ele,"steps",true,0)==c.rs.nstep){
+    s.found=true;
+    s.basepsps=sxml.GetAttributeDouble(ele,"particlestepspersec");
+    s.diff=(s.basepsps? s.psps/s.basepsps-1.: 0);
+    s.pass=(s.diff>=-c.tol.throughput);
+  }
+}
+
+//==============================================================================
+/// Saves the throughput of the executed cases in the baseline file. The
+/// baselines of other hosts or numbers of threads are kept.
+//==============================================================================
+void JDsRegression::UpdateBaseline()const{
+  const string filebase=DirRef+FileBaseline;
+  JXml sxml;
+  if(fun::FileExists(filebase))sxml.LoadFile(filebase);
+  TiXmlNode* node=sxml.GetNode("dsph_regbaseline",true);
+  for(unsigned cc=0;cc<unsigned(Cases.size());cc++){
+    const StRegCase &c=Cases[cc];
+    if(!c.executed)continue;
+    TiXmlElement* ele=FindBaseline(sxml,c);
+    if(ele)node->RemoveChild(ele);
+    ele=JXml::AddElement(node,"case");
+    JXml::AddAttribute(ele,"name",c.name);
+    JXml::AddAttribute(ele,"host",HostName);
+    JXml::AddAttribute(ele,"threads",c.threads);
+    JXml::AddAttribute(ele,"steps",c.rs.nstep);
+    JXml::AddAttribute(ele,"np",c.rs.np);
+    JXml::AddAttribute(ele,"runtime",c.rs.tsim,"%.6e");
+    JXml::AddAttribute(ele,"particlestepspersec",c.speed.psps,"%.6e");
+    JXml::AddAttribute(ele,"date",fun::GetDateTime());
+  }
+  fun::MkdirPath(DirRef);
+  sxml.SaveFile(filebase,ClassName,false);
+  Log->AddFileInfo(filebase,"Throughput baseline of regression tests.");
+}
+
+//==============================================================================
+/// Executes the case and compares the results with the references.
+//==============================================================================
+void JDsRegression::RunCase(StRegCase &c,const std::string &appname){
+  const string dirrun=DirOut+c.name;
+  Log->Printf("\nRunning %s (%u steps, %d threads)...",c.name.c_str(),c.steps,c.threads);
+  Log->Printf("  Case: %s",c.casename.c_str());
+  c.executed=false;
+  c.error="";
+  memset(&c.rs,0,sizeof(StRunSummaryCpu));
+  memset(&c.state,0,sizeof(StRegState));
+  memset(&c.speed,0,sizeof(StRegSpeed));
+  c.dp=c.rhop0=0;
+  c.pass=false;
+  //-Configuration of execution.
+  JSphCfgRun cfg=*Cfg;
+  cfg.CaseName=c.casename;
+  cfg.RunName="";
+  cfg.DirOut=dirrun;
+  cfg.DirDataOut="";
+  cfg.OmpThreads=c.threads;
+  cfg.NstepsBreak=int(c.steps);
+  cfg.PartBeginDir=""; cfg.PartBegin=0;
+  cfg.CheckpointBegin=""; cfg.CheckpointTime=-1;
+  cfg.Sv_Binx=false; cfg.Sv_Info=false; cfg.Sv_Csv=false;
+  cfg.Sv_Vtk=false;  cfg.Sv_Vtu=false;  cfg.SvDomainVtk=false;
+  cfg.SvRes=false;   cfg.SvTimers=true;
+  //-Executes simulation with its own log file.
+  std::vector<unsigned> idp;
+  std::vector<tdouble3> pos;
+  std::vector<tfloat3> vel;
+  std::vector<float> rhop;
+  //-Other output files of the case (e.g. gauges) are also created in its directory.
+  const string dirout0=AppInfo.GetDirOut();
+  fun::MkdirPath(dirrun);
+  AppInfo.ConfigOutput(Cfg->CreateDirs,Cfg->CsvSepComa,dirrun,"");
+  try{
+    JLog2 logrun(JLog2::Out_File);
+    logrun.Init(dirrun+"/Run.out");
+    JSphCpuSingle sph;
+    sph.Run(appname,&cfg,&logrun);
+    sph.GetRunSummary(c.rs);
+    sph.GetParticlesState(idp,pos,vel,rhop);
+    c.executed=true;
+  }
+  catch(const std::exception &e){
+    c.error=string("Execution failed: ")+e.what();
+  }
+  AppInfo.ConfigOutput(Cfg->CreateDirs,Cfg->CsvSepComa,dirout0,"");
+  if(!c.executed){
+    Log->Printf("  *** %s",c.error.c_str());
+    return;
+  }
+  {
+    JPartDataBi4 pdc;
+    pdc.LoadFileCase(fun::GetDirParent(c.casename),fun::GetFile(c.casename));
+    c.dp=pdc.Get_Dp();
+    c.rhop0=pdc.Get_Rhop0();
+  }
+  //-Saves final state.
+  SaveState(c,dirrun,"RegState",idp,pos,vel,rhop);
+  Log->AddFileInfo(dirrun+"/"+JPartDataBi4::GetFileNameCase("RegState"),"Final particle state of regression case.");
+  if(Update){
+    SaveState(c,DirRef,c.name,idp,pos,vel,rhop);
+    Log->AddFileInfo(DirRef+JPartDataBi4::GetFileNameCase(c.name),"Reference particle state of regression case.");
+  }
+  //-Comparison with references.
+  CompareState(c,idp,pos,vel,rhop);
+  CompareBaseline(c);
+  c.pass=(c.error.empty() && c.state.pass && c.speed.pass);
+  const StRegState &s=c.state;
+  const StRegSpeed &v=c.speed;
+  Log->Printf("  Steps:%u  Np:%u  Runtime:%.3f s  Particle-steps/s:%.4e",c.rs.nstep,c.rs.np,c.rs.tsim,v.psps);
+  if(s.found)Log->Printf("  State: %s  (max. diff. pos:%.3e dp  vel:%.3e m/s  rhop:%.3e rhop0  out of tolerance:%u  missing:%u)"
+    ,(s.pass? "Ok": "FAILED"),s.maxpos,s.maxvel,s.maxrhop,s.nbad,s.nmissing);
+  if(v.found)Log->Printf("  Throughput: %s  (baseline:%.4e  diff:%+.2f%%)",(v.pass? "Ok": "FAILED"),v.basepsps,v.diff*100);
+  else Log->Print("  Throughput: no baseline for this host and number of threads.");
+  if(!c.error.empty())Log->Printf("  *** %s",c.error.c_str());
+}
+
+//==============================================================================
+/// Executes all regression cases.
+//==============================================================================
+void JDsRegression::Run(const std::string &appname){
+  Log->Printf("Regression tests: %s  (%u cases)",FileDef.c_str(),unsigned(Cases.size()));
+  Log->Printf("  Reference: %s  Host: %s%s",DirRef.c_str(),HostName.c_str(),(Update? "  (update mode)": ""));
+  for(unsigned cc=0;cc<unsigned(Cases.size());cc++)RunCase(Cases[cc],appname);
+  if(Update)UpdateBaseline();
+}
+
+//==============================================================================
+/// Returns number of failed cases.
+//==============================================================================
+unsigned JDsRegression::GetFailed()const{
+  unsigned n=0;
+  for(unsigned cc=0;cc<unsigned(Cases.size());cc++)if(!Cases[cc].pass)n++;
+  return(n);
+}
+
+//==============================================================================
+/// Shows results of regression tests.
+//==============================================================================
+void JDsRegression::VisuResults()const{
+  Log->Print("\n[Regression results]");
+  Log->Printf("%-20s %7s %9s %10s %10s %10s %8s %13s %9s  %s","Case","Steps","Np","Pos[dp]","Vel[m/s]","Rhop[r0]","Bad","Part-steps/s","Diff","Result");
+  for(unsigned cc=0;cc<unsigned(Cases.size());cc++){
+    const StRegCase &c=Cases[cc];
+    const StRegState &s=c.state;
+    const StRegSpeed &v=c.speed;
+    Log->Printf("%-20s %7u %9u %10.3e %10.3e %10.3e %8u %13.4e %9s  %s",c.name.c_str(),c.rs.nstep,c.rs.np
+      ,s.maxpos,s.maxvel,s.maxrhop,s.nbad+s.nmissing,v.psps,(v.found? fun::PrintStr("%+.2f%%",v.diff*100).c_str(): "-")
+      ,(c.pass? "PASS": "FAIL"));
+  }
+  const unsigned nfail=GetFailed();
+  Log->Printf("\nRegression %s: %u of %u cases failed.",(nfail? "FAILED": "PASSED"),nfail,unsigned(Cases.size()));
+}
+
+//==============================================================================
+/// Saves results of regression tests in JSON format.
+//==============================================================================
+void JDsRegression::SaveJson(const std::string &file)const{
+  std::vector<std::string> vcases;
+  for(unsigned cc=0;cc<unsigned(Cases.size());cc++){
+    const StRegCase &c=Cases[cc];
+    const StRegState &s=c.state;
+    const StRegSpeed &v=c.speed;
+    std::vector<std::string> vtol;
+    vtol.push_back(fun::JSONPropertyValue("pos_dp",fun::DoubleStr(c.tol.pos,"%.6e")));
+    vtol.push_back(fun::JSONPropertyValue("vel",fun::DoubleStr(c.tol.vel,"%.6e")));
+    vtol.push_back(fun::JSONPropertyValue("rhop_rhop0",fun::DoubleStr(c.tol.rhop,"%.6e")));
+    vtol.push_back(fun::JSONPropertyValue("throughput_loss",fun::DoubleStr(c.tol.throughput,"%.6e")));
+    std::vector<std::string> vstate;
+    vstate.push_back(fun::JSONProperty("reference",s.found));
+    vstate.push_back(fun::JSONProperty("passed",s.pass));
+    vstate.push_back(fun::JSONProperty("np_reference",s.npref));
+    vstate.push_back(fun::JSONProperty("out_of_tolerance",s.nbad));
+    vstate.push_back(fun::JSONProperty("missing",s.nmissing));
+    vstate.push_back(fun::JSONPropertyValue("max_pos_dp",fun::DoubleStr(s.maxpos,"%.6e")));
+    vstate.push_back(fun::JSONPropertyValue("max_vel",fun::DoubleStr(s.maxvel,"%.6e")));
+    vstate.push_back(fun::JSONPropertyValue("max_rhop_rhop0",fun::DoubleStr(s.maxrhop,"%.6e")));
+    std::vector<std::string> vspeed;
+    vspeed.push_back(fun::JSONProperty("baseline",v.found));
+    vspeed.push_back(fun::JSONProperty("passed",v.pass));
+    vspeed.push_back(fun::JSONPropertyValue("runtime_s",fun::DoubleStr(c.rs.tsim,"%.6e")));
+    vspeed.push_back(fun::JSONPropertyValue("steps_per_s",fun::DoubleStr((c.rs.tsim? c.rs.nstep/c.rs.tsim: 0),"%.6e")));
+    vspeed.push_back(fun::JSONPropertyValue("particle_steps_per_s",fun::DoubleStr(v.psps,"%.6e")));
+    vspeed.push_back(fun::JSONPropertyValue("baseline_particle_steps_per_s",fun::DoubleStr(v.basepsps,"%.6e")));
+    vspeed.push_back(fun::JSONPropertyValue("diff_pct",fun::DoubleStr(v.diff*100,"%.4f")));
+    std::vector<std::string> v2;
+    v2.push_back(fun::JSONProperty("name",c.name));
+    v2.push_back(fun::JSONProperty("case",c.casename));
+    v2.push_back(fun::JSONProperty("passed",c.pass));
+    v2.push_back(fun::JSONProperty("error",c.error));
+    v2.push_back(fun::JSONProperty("threads",c.threads));
+    v2.push_back(fun::JSONProperty("steps",c.rs.nstep));
+    v2.push_back(fun::JSONProperty("np",c.rs.np));
+    v2.push_back(fun::JSONPropertyValue("timestep",fun::DoubleStr(c.rs.timestep,"%.9e")));
+    v2.push_back(fun::JSONPropertyValue("tolerances",fun::JSONObject(vtol)));
+    v2.push_back(fun::JSONPropertyValue("state",fun::JSONObject(vstate)));
+    v2.push_back(fun::JSONPropertyValue("throughput",fun::JSONObject(vspeed)));
+    vcases.push_back(fun::JSONObject(v2));
+  }
+  const unsigned nfail=GetFailed();
+  std::vector<std::string> vres;
+  vres.push_back(fun::JSONProperty("definition",FileDef));
+  vres.push_back(fun::JSONProperty("reference",DirRef));
+  vres.push_back(fun::JSONProperty("host",HostName));
+  vres.push_back(fun::JSONProperty("date",fun::GetDateTime()));
+  vres.push_back(fun::JSONProperty("update",Update));
+  vres.push_back(fun::JSONProperty("passed",nfail==0));
+  vres.push_back(fun::JSONProperty("failed",nfail));
+  vres.push_back(fun::JSONPropertyValue("cases",fun::JSONArray(vcases)));
+  ofstream pf;
+  pf.open(file.c_str());
+  if(!pf)Run_ExceptioonFile("Cannot open the file.",file);
+  pf << fun::JSONObject(vres) << endl;
+  if(pf.fail())Run_ExceptioonFile("File writing failure.",file);
+  pf.close();
+  Log->AddFileInfo(file,"Results of regression tests in JSON format.");
+}
+
@@ -0,0 +1,150 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Modo regresion (-regression) que ejecuta en CPU los casos definidos en
+//:#   un fichero XML durante un numero fijo de pasos y compara el estado final
+//:#   de las particulas (BI4 de referencia con JPartDataBi4) y el rendimiento
+//:#   (linea base por host y numero de hilos) con tolerancias configurables.
+//:#   El resultado se graba en JSON y -regupdate crea las referencias. (19-10-2026)
+//:#############################################################################
+
+/// \file JDsRegression.h \brief Declares the class \ref JDsRegression.
+
+#ifndef _JDsRegression_
+#define _JDsRegression_
+
+#include "JObject.h"
+#include "TypesDef.h"
+#include "JSphCpuSingle.h"
+#include <string>
+#include <vector>
+
+class JLog2;
+class JSphCfgRun;
+class JXml;
+class TiXmlElement;
+
+//##############################################################################
+//# JDsRegression
+//##############################################################################
+/// \brief Regression tests of correctness and throughput on CPU.
+///
+/// The cases (already generated by GenCase) are defined in a XML file with
+/// the number of steps, the number of OpenMP threads (1 by default to obtain
+/// deterministic results) and the tolerances. Each case is executed with
+/// JSphCpuSingle for the fixed number of steps and the final particle state
+/// is saved in BI4 format and compared particle by particle (using Idp) with
+/// the reference state stored in the reference directory. The throughput
+/// (particle-steps per second) is compared with the baseline stored for the
+/// same host and number of threads. In update mode the reference states and
+/// the baseline are replaced with the results of the execution.
+
+class JDsRegression : protected JObject
+{
+protected:
+  static const std::string FileBaseline;  ///<Name of file with throughput baseline in the reference directory.
+
+  ///Tolerances of comparison.
+  typedef struct{
+    double pos;         ///<Maximum distance between positions (relative to Dp).
+    double vel;         ///<Maximum difference of velocity (in m/s).
+    double rhop;        ///<Maximum difference of density (relative to Rhop0).
+    double throughput;  ///<Maximum loss of throughput with respect to the baseline (fraction).
+  }StRegTolerances;
+
+  ///Comparison of the final state with the reference state.
+  typedef struct{
+    bool found;         ///<Reference state was found.
+    unsigned npref;     ///<Number of particles of reference state.
+    unsigned nmissing;  ///<Number of particles not found in both states.
+    unsigned nbad;      ///<Number of particles out of tolerances.
+    double maxpos;      ///<Maximum distance between positions (relative to Dp).
+    double maxvel;      ///<Maximum difference of velocity (in m/s).
+    double maxrhop;     ///<Maximum difference of density (relative to Rhop0).
+    bool pass;
+  }StRegState;
+
+  ///Comparison of throughput with the baseline.
+  typedef struct{
+    bool found;         ///<Baseline was found for this host and number of threads.
+    double psps;        ///<Particle-steps per second of this execution.
+    double basepsps;    ///<Particle-steps per second of the baseline.
+    double diff;        ///<Relative difference with respect to the baseline (negative: slower).
+    bool pass;
+  }StRegSpeed;
+
+  ///Definition and results of one case.
+  typedef struct{
+    std::string name;       ///<Name of test (name of reference state and output directory).
+    std::string casename;   ///<Case file (with path and without extension).
+    unsigned steps;         ///<Number of simulation steps.
+    int threads;            ///<Number of OpenMP threads.
+    StRegTolerances tol;
+    //-Results.
+    bool executed;          ///<Simulation was completed.
+    std::string error;      ///<Error of execution (empty: no error).
+    StRunSummaryCpu rs;     ///<Summary of execution.
+    double dp;              ///<Distance between particles of the case.
+    double rhop0;           ///<Reference density of the case.
+    StRegState state;
+    StRegSpeed speed;
+    bool pass;
+  }StRegCase;
+
+  JLog2 *Log;
+  const JSphCfgRun *Cfg;    ///<Configuration of execution (options of command line).
+  const std::string DirOut; ///<Output directory.
+  const bool Update;        ///<Creates or replaces the reference states and the baseline.
+  const std::string HostName;
+
+  std::string FileDef;      ///<XML file with definition of tests.
+  std::string DirRef;       ///<Directory of reference states and baseline.
+  std::vector<StRegCase> Cases;
+
+  void ReadTolerances(JXml &sxml,TiXmlElement* ele,StRegTolerances &tol)const;
+  void LoadDef(const std::string &filedef);
+
+  void SaveState(const StRegCase &c,const std::string &dir,const std::string &name
+    ,const std::vector<unsigned> &idp,const std::vector<tdouble3> &pos
+    ,const std::vector<tfloat3> &vel,const std::vector<float> &rhop)const;
+  void CompareState(StRegCase &c,const std::vector<unsigned> &idp,const std::vector<tdouble3> &pos
+    ,const std::vector<tfloat3> &vel,const std::vector<float> &rhop)const;
+
+  TiXmlElement* FindBaseline(JXml &sxml,const StRegCase &c)const;
+  void CompareBaseline(StRegCase &c)const;
+  void UpdateBaseline()const;
+
+  void RunCase(StRegCase &c,const std::string &appname);
+
+public:
+  JDsRegression(const JSphCfgRun *cfg,const std::string &dirout,JLog2 *log);
+  ~JDsRegression();
+
+  void Run(const std::string &appname);
+  void VisuResults()const;
+  void SaveJson(const std::string &file)const;
+
+  unsigned GetFailed()const;
+};
+
+#endif
+
+
@@ -24,7 +24,9 @@
 #include "JAppInfo.h"
 #include "Functions.h"
 #include "JSaveCsv2.h"
+#include "JSeriesSink.h"
 #include <cfloat>
+#include <climits>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -39,6 +41,7 @@ using namespace std;
 //==============================================================================
 JDsSaveDt::JDsSaveDt(JLog2* log):Log(log){
   ClassName="JDsSaveDt";
+  StreamDtInfo=StreamDtAllInfo=UINT_MAX;
   Reset();
 }
 
@@ -61,7 +64,9 @@ void JDsSaveDt::Reset(){
   memset(&ValueNull,0,sizeof(StValue));
   LastDtf=LastDt1=LastDt2=ValueNull;
   LastAceMax=LastViscDtMax=LastVelMax=ValueNull;
-  CountAllDts=0;
+  if(StreamDtInfo!=UINT_MAX)AppInfo.SeriesPtr()->CloseStream(StreamDtInfo);
+  if(StreamDtAllInfo!=UINT_MAX)AppInfo.SeriesPtr()->CloseStream(StreamDtAllInfo);
+  StreamDtInfo=StreamDtAllInfo=UINT_MAX;
 }
 
 //==============================================================================
@@ -108,46 +113,44 @@ void JDsSaveDt::VisuConfig(std::string txhead,std::string txfoot){
 }
 
 //==============================================================================
-/// Stores file buffer values.
-/// Graba valores de buffer en fichero.
+/// Returns the builder of records of DtInfo.csv (it is created when needed).
 //==============================================================================
-void JDsSaveDt::SaveFileValues(){ 
-  const bool firstsv=FileDtInfo.empty();
-  if(firstsv){
-    FileDtInfo=AppInfo.GetDirOut()+"DtInfo.csv";
-    Log->AddFileInfo(FileDtInfo,"Saves statistical information about DT values.");
-  }
-  jcsv::JSaveCsv2 scsv(FileDtInfo,!firstsv,AppInfo.GetCsvSepComa());
-  //-Saves head.
-  if(firstsv){
-    scsv.SetHead();
-    scsv << "Time [s];Values";
-    scsv << "Dtf_mean [s];Dtf_min [s];Dtf_max [s]";
-    scsv << "Dt1_mean [s];Dt1_min [s];Dt1_max [s]";
-    scsv << "Dt2_mean [s];Dt2_min [s];Dt2_max [s]";
+JSeriesRec& JDsSaveDt::RecDtInfo(){
+  JSeriesSink *series=AppInfo.SeriesPtr();
+  if(StreamDtInfo==UINT_MAX){
+    string head="Time [s];Values";
+    head=head+";Dtf_mean [s];Dtf_min [s];Dtf_max [s]";
+    head=head+";Dt1_mean [s];Dt1_min [s];Dt1_max [s]";
+    head=head+";Dt2_mean [s];Dt2_min [s];Dt2_max [s]";
     if(FullInfo){
-      scsv << "AceMax_mean [m/s^2];AceMax_min [m/s^2];AceMax_max [m/s^2]";
-      scsv << "ViscDtMax_mean;ViscDtMax_min;ViscDtMax_max";
-      scsv << "VelMax_mean [m/s];VelMax_min [m/s];VelMax_max [m/s]";
+      head=head+";AceMax_mean [m/s^2];AceMax_min [m/s^2];AceMax_max [m/s^2]";
+      head=head+";ViscDtMax_mean;ViscDtMax_min;ViscDtMax_max";
+      head=head+";VelMax_mean [m/s];VelMax_min [m/s];VelMax_max [m/s]";
     }
-    scsv << jcsv::Endl();
+    StreamDtInfo=series->AddStream(AppInfo.GetDirOut()+"DtInfo.csv",head,false,"Saves statistical information about DT values.");
+    series->Rec(StreamDtInfo) << jcsv::Fmt(jcsv::TpDouble1,"%20.12E");
   }
-  //-Saves data.
-  scsv.SetData();
-  scsv << jcsv::Fmt(jcsv::TpDouble1,"%20.12E");
-  for(unsigned c=0;c<Count;c++){
-    StValue v;
-    v=DtFinal[c];    scsv << v.tini << v.num << v.vmean << v.vmin << v.vmax;
-    v=Dt1[c];        scsv << v.vmean << v.vmin << v.vmax;
-    v=Dt2[c];        scsv << v.vmean << v.vmin << v.vmax;
-    if(FullInfo){
-      v=AceMax[c];     scsv << v.vmean << v.vmin << v.vmax;
-      v=ViscDtMax[c];  scsv << v.vmean << v.vmin << v.vmax;
-      v=VelMax[c];     scsv << v.vmean << v.vmin << v.vmax;
-    }
-    scsv << jcsv::Endl();
+  return(series->Rec(StreamDtInfo));
+}
+
+//==============================================================================
+/// Returns the builder of records of DtAllInfo.csv (it is created when needed).
+//==============================================================================
+JSeriesRec& JDsSaveDt::RecDtAllInfo(){
+  JSeriesSink *series=AppInfo.SeriesPtr();
+  if(StreamDtAllInfo==UINT_MAX){
+    StreamDtAllInfo=series->AddStream(AppInfo.GetDirOut()+"DtAllInfo.csv","Time [s];Dtf [s]",false,"Saves DT values for each simulation step.");
+    series->Rec(StreamDtAllInfo) << jcsv::Fmt(jcsv::TpDouble1,"%20.12E");
   }
-  scsv.SaveData();
+  return(series->Rec(StreamDtAllInfo));
+}
+
+//==============================================================================
+/// Requests the write of stored values in file.
+/// Solicita la grabacion de valores almacenados en fichero.
+//==============================================================================
+void JDsSaveDt::SaveFileValues(){ 
+  if(StreamDtInfo!=UINT_MAX)AppInfo.SeriesPtr()->Flush(StreamDtInfo);
   Count=0;
 }
 
@@ -161,26 +164,12 @@ void JDsSaveDt::SaveFileValuesEnd(){
 }
 
 //==============================================================================
-/// Stores file buffer values.
-/// Graba valores de buffer en fichero.
+/// Requests the write of stored dt values in file (it is created with head).
+/// Solicita la grabacion de valores de dt almacenados en fichero.
 //==============================================================================
 void JDsSaveDt::SaveFileAllDts(){
-  const bool firstsv=FileDtAllInfo.empty();
-  if(firstsv){
-    FileDtAllInfo=AppInfo.GetDirOut()+"DtAllInfo.csv";
-    Log->AddFileInfo(FileDtAllInfo,"Saves DT values for each simulation step.");
-  }
-  jcsv::JSaveCsv2 scsv(FileDtAllInfo,!firstsv,AppInfo.GetCsvSepComa());
-  //-Saves head.
-  if(firstsv){
-    scsv.SetHead();
-    scsv << "Time [s];Dtf [s]" << jcsv::Endl();
-  }
-  //-Saves data.
-  scsv.SetData();
-  scsv << jcsv::Fmt(jcsv::TpDouble1,"%20.12E");
-  for(unsigned c=0;c<CountAllDts;c++)scsv << AllDts[c].x << AllDts[c].y << jcsv::Endl();
-  CountAllDts=0;
+  RecDtAllInfo();
+  AppInfo.SeriesPtr()->Flush(StreamDtAllInfo);
 }
 
 //==============================================================================
@@ -207,16 +196,19 @@ void JDsSaveDt::AddValueData(double timestep,double dt,StValue &value){
 //==============================================================================
 void JDsSaveDt::AddLastValues(){
   if(Count>=GetSizeValues())SaveFileValues();
-  DtFinal[Count]=LastDtf;
-  Dt1[Count]=LastDt1;
-  Dt2[Count]=LastDt2;
+  JSeriesRec &rec=RecDtInfo();
+  StValue v;
+  v=LastDtf;  rec << v.tini << v.num << v.vmean << v.vmin << v.vmax;
+  v=LastDt1;  rec << v.vmean << v.vmin << v.vmax;
+  v=LastDt2;  rec << v.vmean << v.vmin << v.vmax;
   LastDtf=LastDt1=LastDt2=ValueNull;
   if(FullInfo){
-    AceMax[Count]=LastAceMax;
-    ViscDtMax[Count]=LastViscDtMax;
-    VelMax[Count]=LastVelMax;
+    v=LastAceMax;     rec << v.vmean << v.vmin << v.vmax;
+    v=LastViscDtMax;  rec << v.vmean << v.vmin << v.vmax;
+    v=LastVelMax;     rec << v.vmean << v.vmin << v.vmax;
     LastAceMax=LastViscDtMax=LastVelMax=ValueNull;
   }
+  rec << jcsv::Endl();
   Count++;
 }
 
@@ -242,11 +234,7 @@ void JDsSaveDt::AddValues(double timestep,double dtfinal,double dt1,double dt2,d
     }
     //-Management of AllDt.
     //-Gestion de AllDt.
-    if(AllDt){
-      if(CountAllDts>=SizeAllDts)SaveFileAllDts();
-      AllDts[CountAllDts]=TDouble2(timestep,dtfinal);
-      CountAllDts++;
-    }
+    if(AllDt)RecDtAllInfo() << timestep << dtfinal << jcsv::Endl();
   }
   else if(timestep>TimeFinish && Count)SaveFileValuesEnd();
 }
@@ -29,6 +29,8 @@
 //:# - Objeto JXml pasado como const para operaciones de lectura. (19-03-2020)  
 //:# - Comprueba opcion active en elementos de primer y segundo nivel. (19-03-2020)  
 //:# - Cambio de nombre de J.SaveDt a J.DsSaveDt. (28-06-2020)
+//:# - Los valores se graban mediante series temporales de JSeriesSink en lugar
+//:#   de buffers propios y JSaveCsv2. (19-10-2026)
 //:#############################################################################
 
 /// \file JDsSaveDt.h \brief Declares the class \ref JDsSaveDt.
@@ -44,6 +46,7 @@
 class JXml;
 class TiXmlElement;
 class JLog2;
+class JSeriesRec;
 
 //##############################################################################
 //# XML format in _FmtXML_SaveDt.xml.
@@ -69,8 +72,8 @@ public:
 
 private:
   JLog2* Log;
-  std::string FileDtInfo;
-  std::string FileDtAllInfo;
+  unsigned StreamDtInfo;    ///<Id of time series of DtInfo.csv (UINT_MAX when it is not created).
+  unsigned StreamDtAllInfo; ///<Id of time series of DtAllInfo.csv (UINT_MAX when it is not created).
   double TimeStart;    ///<Time from which information about the DT begins to be collected. | Instante a partir del cual se empieza a recopilar informacion del dt.
   double TimeFinish;   ///<Time from which dt information is not collected. | Instante a partir del cual se deja de recopilar informacion del dt.
   double TimeInterval; ///<Time lapse every time dt information is saved. | Cada cuanto se guarda info del dt.
@@ -80,21 +83,11 @@ private:
 
   StValue ValueNull;
 
-  unsigned Count;                       ///<Number of stored intervals. | Numero de intervalos almacenados.
-  static const unsigned SizeValues=100; ///<Maximum number of intervals to be buffered. | Numero maximo de intervalos a almacenar en buffer.
-  StValue DtFinal[SizeValues];          ///<Resultant minimum Dt [SizeValues]. | Dt minimo resultante [SizeValues].
-  StValue Dt1[SizeValues];              ///<Dt1 [SizeValues].
-  StValue Dt2[SizeValues];              ///<Dt2 [SizeValues].
-  StValue AceMax[SizeValues];           ///<AceMax [SizeValues].
-  StValue ViscDtMax[SizeValues];        ///<ViscDtMax [SizeValues].
-  StValue VelMax[SizeValues];           ///<VelMax [SizeValues].
+  unsigned Count;                       ///<Number of stored intervals since last write. | Numero de intervalos almacenados desde la ultima grabacion.
+  static const unsigned SizeValues=100; ///<Maximum number of intervals between writes. | Numero maximo de intervalos entre grabaciones.
 
   unsigned GetSizeValues()const{ return(SizeValues); }
 
-  static const unsigned SizeAllDts=1000;
-  tdouble2 AllDts[SizeAllDts];           
-  unsigned CountAllDts;
-
   unsigned LastInterval;
   StValue LastDtf,LastDt1,LastDt2;
   StValue LastAceMax,LastViscDtMax,LastVelMax;
@@ -104,6 +97,8 @@ private:
   void SaveFileValues();
   void SaveFileValuesEnd();
   void SaveFileAllDts();
+  JSeriesRec& RecDtInfo();
+  JSeriesRec& RecDtAllInfo();
   void AddValueData(double timestep,double dt,StValue &value);
   void AddLastValues();
 public:
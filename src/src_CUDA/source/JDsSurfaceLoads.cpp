@@ -0,0 +1,415 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JDsSurfaceLoads.cpp \brief Implements the classes \ref JDsSurfaceLoadsItem and \ref JDsSurfaceLoads.
+
+#include "JDsSurfaceLoads.h"
+#include "JSphMk.h"
+#include "JLog2.h"
+#include "JXml.h"
+#include "JRangeFilter.h"
+#include "Functions.h"
+#include "FunctionsMath.h"
+#include "FunSphKernel.h"
+#include "FunSphEos.h"
+#include "JCellSearch_inline.h"
+#include "JDataArrays.h"
+#include "JOutputVtu.h"
+#include "OmpDefs.h"
+#include <cfloat>
+#include <climits>
+#include <cmath>
+
+using namespace std;
+
+//##############################################################################
+//# JDsSurfaceLoadsItem
+//##############################################################################
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JDsSurfaceLoadsItem::JDsSurfaceLoadsItem(unsigned idx,const std::string &name)
+  :Idx(idx),Name(name)
+{
+  ClassName="JDsSurfaceLoadsItem";
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JDsSurfaceLoadsItem::~JDsSurfaceLoadsItem(){
+  DestructorActive=true;
+  Reset();
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JDsSurfaceLoadsItem::Reset(){
+  MkBoundList="";
+  Blocks.clear();
+  Np=0;
+  Floatings=false;
+  WindowDt=0;
+  ComputeStart=ComputeEnd=0;
+  WindowIni=WindowTime=0;
+  WindowSteps=0;
+  LastTime=0;
+  Pos.clear();
+  PressMax.clear();
+  PressInt.clear();
+  ForceMax.clear();
+  Impulse.clear();
+  NumSaves=0;
+  OutFiles.clear();
+  OutTimes.clear();
+}
+
+//==============================================================================
+/// Reads configuration from the XML element of the surface.
+//==============================================================================
+void JDsSurfaceLoadsItem::ReadXml(const JXml *sxml,TiXmlElement* ele){
+  sxml->CheckElementNames(ele,true,"window computetime");
+  MkBoundList=sxml->GetAttributeStr(ele,"mkbound");
+  WindowDt=sxml->ReadElementDouble(ele,"window","value",true,0);
+  if(WindowDt<0)Run_ExceptioonFile(fun::PrintStr("The window of surface \'%s\' is invalid.",Name.c_str()),sxml->ErrGetFileRow(ele));
+  ComputeStart=sxml->ReadElementDouble(ele,"computetime","start",true,0);
+  ComputeEnd=sxml->ReadElementDouble(ele,"computetime","end",true,DBL_MAX);
+  if(ComputeStart<0 || ComputeStart>=ComputeEnd)Run_ExceptioonFile(fun::PrintStr("The computetime of surface \'%s\' is invalid.",Name.c_str()),sxml->ErrGetFileRow(ele));
+  WindowIni=ComputeStart;
+}
+
+//==============================================================================
+/// Selects the boundary blocks according to MkBoundList and allocates memory.
+//==============================================================================
+void JDsSurfaceLoadsItem::ConfigBlocks(const JSphMk *mkinfo,const StCteSph &csp
+  ,unsigned ftcount,const StFloatingData *ftobjs)
+{
+  JRangeFilter rg(MkBoundList);
+  vector<unsigned> mkbounds;
+  rg.GetValues(mkbounds);
+  if(mkbounds.empty())Run_Exceptioon(fun::PrintStr("The list of mkbound of surface \'%s\' is empty.",Name.c_str()));
+  Blocks.clear();
+  Np=0;
+  for(unsigned c=0;c<unsigned(mkbounds.size());c++){
+    const word mkbound=word(mkbounds[c]);
+    const unsigned cb=mkinfo->GetMkBlockByMkBound(mkbound);
+    if(cb>=mkinfo->Size())Run_Exceptioon(fun::PrintStr("The mkbound %u of surface \'%s\' does not exist.",mkbound,Name.c_str()));
+    const JSphMkBlock* mkb=mkinfo->Mkblock(cb);
+    StBlock blk;
+    blk.mkbound=mkbound;
+    blk.code=mkb->Code;
+    blk.idbegin=mkb->Begin;
+    blk.count=mkb->Count;
+    blk.offset=Np;
+    blk.floating=(mkb->Type==TpPartFloating);
+    blk.massp=csp.massbound;
+    if(blk.floating){
+      unsigned cf=0;
+      for(;cf<ftcount && ftobjs[cf].mkbound!=mkbound;cf++);
+      if(cf>=ftcount)Run_Exceptioon(fun::PrintStr("The floating body with mkbound %u of surface \'%s\' was not found.",mkbound,Name.c_str()));
+      blk.massp=ftobjs[cf].massp;
+      Floatings=true;
+    }
+    Blocks.push_back(blk);
+    Np+=blk.count;
+  }
+  if(!Np)Run_Exceptioon(fun::PrintStr("The surface \'%s\' has no particles.",Name.c_str()));
+  Pos.resize(Np,TDouble3(0));
+  PressMax.resize(Np);
+  PressInt.resize(Np);
+  ForceMax.resize(Np);
+  Impulse.resize(Np);
+  ResetWindow(WindowIni);
+}
+
+//==============================================================================
+/// Loads lines with configuration information.
+//==============================================================================
+void JDsSurfaceLoadsItem::GetConfig(std::vector<std::string> &lines)const{
+  lines.push_back(fun::PrintStr("MkBound....: %s  (%u blocks, %u particles%s)",MkBoundList.c_str(),unsigned(Blocks.size()),Np,(Floatings? ", with floatings": "")));
+  if(WindowDt>0)lines.push_back(fun::PrintStr("Window.....: %g",WindowDt));
+  else lines.push_back("Window.....: whole simulation");
+  if(ComputeStart>0 || ComputeEnd<DBL_MAX)lines.push_back(fun::PrintStr("ComputeTime: %g - %g",ComputeStart,ComputeEnd));
+  lines.push_back(fun::PrintStr("Memory.....: %.2f MB",double((sizeof(tdouble3)*2+sizeof(float)*2+sizeof(double))*Np)/(1024*1024)));
+}
+
+//==============================================================================
+/// Clears accumulated values for a new window.
+//==============================================================================
+void JDsSurfaceLoadsItem::ResetWindow(double timeini){
+  WindowIni=timeini;
+  WindowTime=0;
+  WindowSteps=0;
+  for(unsigned p=0;p<Np;p++){
+    PressMax[p]=-FLT_MAX;
+    PressInt[p]=0;
+    ForceMax[p]=0;
+    Impulse[p]=TDouble3(0);
+  }
+}
+
+//==============================================================================
+/// Accumulates pressure and force exerted by the fluid on the selected
+/// particles during dt. Force is computed as in JGaugeForce but using the
+/// pressure values of the interaction (press[]).
+//==============================================================================
+template<TpKernel tker> void JDsSurfaceLoadsItem::ComputeCpuT(double dt
+  ,const StCteSph &csp,const StDivDataCpu &dvd,unsigned npbok,unsigned npb,unsigned np
+  ,const tdouble3 *pos,const typecode *code,const unsigned *idp,const tfloat4 *velrhop
+  ,const float *press)
+{
+  const int n=int(Floatings? np: npbok);
+  const unsigned nblocks=unsigned(Blocks.size());
+  const StBlock *blocks=&Blocks[0];
+  #ifdef OMP_USE
+    #pragma omp parallel for schedule (guided)
+  #endif
+  for(int p1=0;p1<n;p1++)if(CODE_IsNormal(code[p1]) && !CODE_IsFluid(code[p1])){//-Ignores periodic boundaries.
+    const typecode code1=CODE_GetTypeAndValue(code[p1]);
+    unsigned cb=0;
+    for(;cb<nblocks && blocks[cb].code!=code1;cb++);
+    if(cb<nblocks){
+      const unsigned ip=blocks[cb].offset+(idp[p1]-blocks[cb].idbegin);
+      const tdouble3 pos1=pos[p1];
+      const float rhop1=velrhop[p1].w;
+      const float press1=press[p1];
+      tfloat3 ace=TFloat3(0);
+      //-Search for fluid neighbours in adjacent cells.
+      const StNgSearch ngs=nsearch::Init(pos1,false,dvd);
+      for(int z=ngs.zini;z<ngs.zfin;z++)for(int y=ngs.yini;y<ngs.yfin;y++){
+        const tuint2 pif=nsearch::ParticleRange(y,z,ngs,dvd);
+        for(unsigned p2=pif.x;p2<pif.y;p2++){
+          const tfloat4 dr=nsearch::Distances(pos1,pos[p2]);
+          if(dr.w<=csp.kernelsize2 && dr.w>=ALMOSTZERO && CODE_IsFluid(code[p2])){
+            const float fac=fsph::GetKernel_Fac<tker>(csp,dr.w);
+            const float prs=(press1+press[p2])/(rhop1*velrhop[p2].w);
+            const float p_vpm1=-prs*csp.massfluid;
+            ace.x+=p_vpm1*fac*dr.x;  ace.y+=p_vpm1*fac*dr.y;  ace.z+=p_vpm1*fac*dr.z;
+          }
+        }
+      }
+      if(csp.simulate2d)ace.y=0;
+      //-Updates accumulated values of particle.
+      const tfloat3 force=ace*blocks[cb].massp;
+      const float fmod=sqrt(force.x*force.x+force.y*force.y+force.z*force.z);
+      Pos[ip]=pos1;
+      if(PressMax[ip]<press1)PressMax[ip]=press1;
+      PressInt[ip]+=press1*dt;
+      if(ForceMax[ip]<fmod)ForceMax[ip]=fmod;
+      Impulse[ip]=Impulse[ip]+ToTDouble3(force)*dt;
+    }
+  }
+}
+
+//==============================================================================
+/// Accumulates loads of the step (on CPU) and saves the current window when
+/// it is finished. The step that crosses the end of the window is included
+/// in the window it closes.
+//==============================================================================
+void JDsSurfaceLoadsItem::ComputeCpu(double timestep,double dt,const StCteSph &csp
+  ,const StDivDataCpu &dvd,unsigned npbok,unsigned npb,unsigned np,const tdouble3 *pos
+  ,const typecode *code,const unsigned *idp,const tfloat4 *velrhop,const float *press
+  ,const std::string &dirout,bool compress,JLog2 *log)
+{
+  switch(csp.tkernel){
+    case KERNEL_Cubic:       //Kernel Wendland is used since Cubic is not available.
+    case KERNEL_Wendland:    ComputeCpuT<KERNEL_Wendland>(dt,csp,dvd,npbok,npb,np,pos,code,idp,velrhop,press);  break;
+    default: Run_Exceptioon("Kernel unknown.");
+  }
+  WindowTime+=dt;
+  WindowSteps++;
+  LastTime=timestep;
+  //-Saves current window when it is finished.
+  if(WindowDt>0 && timestep>=WindowIni+WindowDt){
+    SaveWindow(WindowIni+WindowDt,dirout,compress,log);
+    ResetWindow(ComputeStart+WindowDt*floor((timestep-ComputeStart)/WindowDt));
+  }
+}
+
+//==============================================================================
+/// Saves the accumulated values of the current window in a VTU file and
+/// updates the PVD file with the final time of the windows.
+//==============================================================================
+void JDsSurfaceLoadsItem::SaveWindow(double timestep,const std::string &dirout
+  ,bool compress,JLog2 *log)
+{
+  if(!WindowSteps)return;
+  tfloat3  *vpos   =new tfloat3[Np];
+  unsigned *vidp   =new unsigned[Np];
+  float    *vpmax  =new float[Np];
+  float    *vpmean =new float[Np];
+  float    *vpint  =new float[Np];
+  float    *vfmax  =new float[Np];
+  tfloat3  *vfmean =new tfloat3[Np];
+  tfloat3  *vimp   =new tfloat3[Np];
+  const double itime=(WindowTime>0? 1./WindowTime: 0);
+  for(unsigned cb=0;cb<unsigned(Blocks.size());cb++){
+    const StBlock &blk=Blocks[cb];
+    for(unsigned c=0;c<blk.count;c++)vidp[blk.offset+c]=blk.idbegin+c;
+  }
+  for(unsigned p=0;p<Np;p++){
+    vpos[p]  =ToTFloat3(Pos[p]);
+    vpmax[p] =(PressMax[p]!=-FLT_MAX? PressMax[p]: 0);
+    vpint[p] =float(PressInt[p]);
+    vpmean[p]=float(PressInt[p]*itime);
+    vfmax[p] =ForceMax[p];
+    vimp[p]  =ToTFloat3(Impulse[p]);
+    vfmean[p]=ToTFloat3(Impulse[p]*itime);
+  }
+  JDataArrays arrays;
+  arrays.AddArray("Pos",Np,vpos,true);
+  arrays.AddArray("Idp",Np,vidp,true);
+  arrays.AddArray("PressMax",Np,vpmax,true);
+  arrays.AddArray("PressMean",Np,vpmean,true);
+  arrays.AddArray("PressInt",Np,vpint,true);
+  arrays.AddArray("ForceMax",Np,vfmax,true);
+  arrays.AddArray("ForceMean",Np,vfmean,true);
+  arrays.AddArray("Impulse",Np,vimp,true);
+  const string file=dirout+"SurfaceLoads_"+Name+".vtu";
+  const string filepvd=dirout+"SurfaceLoads_"+Name+".pvd";
+  if(!NumSaves){
+    log->AddFileInfo(fun::FileNameSec(file,UINT_MAX),fun::PrintStr("Saves accumulated loads on boundary particles for each time window (by %s).",ClassName.c_str()));
+    log->AddFileInfo(filepvd,"Saves list of files of loads with the final time of each window (by JDsSurfaceLoads).");
+  }
+  const string filesec=fun::FileNameSec(file,NumSaves);
+  JOutputVtu ovtu(compress);
+  ovtu.SaveVtu(filesec,arrays,"Pos");
+  OutFiles.push_back(filesec);
+  OutTimes.push_back(timestep);
+  ovtu.SavePvd(filepvd,OutFiles,OutTimes);
+  NumSaves++;
+}
+
+
+//##############################################################################
+//# JDsSurfaceLoads
+//##############################################################################
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JDsSurfaceLoads::JDsSurfaceLoads(JLog2 *log):Log(log){
+  ClassName="JDsSurfaceLoads";
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JDsSurfaceLoads::~JDsSurfaceLoads(){
+  DestructorActive=true;
+  Reset();
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JDsSurfaceLoads::Reset(){
+  CSP=CteSphNull();
+  DirOut="";
+  Compress=false;
+  for(unsigned c=0;c<GetCount();c++)delete List[c];
+  List.clear();
+}
+
+//==============================================================================
+/// Configures object.
+//==============================================================================
+void JDsSurfaceLoads::Config(const StCteSph &csp,const std::string &dirout,bool compress){
+  CSP=csp;
+  DirOut=dirout;
+  Compress=compress;
+  //-Wendland kernel is used when Cubic is selected.
+  if(CSP.tkernel==KERNEL_Cubic && (!CSP.kwend.awen || !CSP.kwend.bwen))Run_Exceptioon("Constants of kernel Wendland are not defined.");
+}
+
+//==============================================================================
+/// Loads configuration from XML object.
+//==============================================================================
+void JDsSurfaceLoads::LoadXml(const JXml *sxml,const std::string &place,const JSphMk *mkinfo
+  ,unsigned ftcount,const StFloatingData *ftobjs)
+{
+  for(unsigned c=0;c<GetCount();c++)delete List[c];
+  List.clear();
+  TiXmlNode* node=sxml->GetNodeSimple(place,false);
+  if(!node)Run_Exceptioon(std::string("Cannot find the element \'")+place+"\'.");
+  if(sxml->CheckNodeActive(node))ReadXml(sxml,node->ToElement(),mkinfo,ftcount,ftobjs);
+}
+
+//==============================================================================
+/// Reads list of surfaces in the XML node.
+//==============================================================================
+void JDsSurfaceLoads::ReadXml(const JXml *sxml,TiXmlElement* lis,const JSphMk *mkinfo
+  ,unsigned ftcount,const StFloatingData *ftobjs)
+{
+  sxml->CheckElementNames(lis,true,"*surface");
+  TiXmlElement* ele=lis->FirstChildElement("surface");
+  while(ele){
+    if(sxml->CheckElementActive(ele)){
+      const string name=sxml->GetAttributeStr(ele,"name");
+      if(name.empty() || int(name.find_first_of("/\\:*?\"<>| "))>=0)Run_ExceptioonFile(fun::PrintStr("The surface name \'%s\' is invalid.",name.c_str()),sxml->ErrGetFileRow(ele));
+      for(unsigned c=0;c<GetCount();c++)if(List[c]->Name==name)Run_ExceptioonFile(fun::PrintStr("The surface name \'%s\' already exists.",name.c_str()),sxml->ErrGetFileRow(ele));
+      JDsSurfaceLoadsItem* sf=new JDsSurfaceLoadsItem(GetCount(),name);
+      List.push_back(sf);
+      sf->ReadXml(sxml,ele);
+      sf->ConfigBlocks(mkinfo,CSP,ftcount,ftobjs);
+    }
+    ele=ele->NextSiblingElement("surface");
+  }
+}
+
+//==============================================================================
+/// Shows object configuration using Log.
+//==============================================================================
+void JDsSurfaceLoads::VisuConfig(std::string txhead,std::string txfoot)const{
+  if(!txhead.empty())Log->Print(txhead);
+  for(unsigned c=0;c<GetCount();c++){
+    std::vector<std::string> lines;
+    List[c]->GetConfig(lines);
+    Log->Printf("Surface_%u: \'%s\'",List[c]->Idx,List[c]->Name.c_str());
+    for(unsigned i=0;i<unsigned(lines.size());i++)Log->Print(string("  ")+lines[i]);
+  }
+  if(!txfoot.empty())Log->Print(txfoot);
+}
+
+//==============================================================================
+/// Accumulates loads of the step on the selected particles (on CPU).
+/// The timestep is the final time of the step with duration dt.
+//==============================================================================
+void JDsSurfaceLoads::ComputeCpu(double timestep,double dt,const StDivDataCpu &dvd
+  ,unsigned npbok,unsigned npb,unsigned np,const tdouble3 *pos,const typecode *code
+  ,const unsigned *idp,const tfloat4 *velrhop,const float *press)
+{
+  for(unsigned c=0;c<GetCount();c++){
+    JDsSurfaceLoadsItem* sf=List[c];
+    if(sf->Update(timestep))sf->ComputeCpu(timestep,dt,CSP,dvd,npbok,npb,np,pos,code,idp,velrhop,press,DirOut,Compress,Log);
+  }
+}
+
+//==============================================================================
+/// Saves the last window of loads when it has accumulated steps after the
+/// last finished window.
+//==============================================================================
+void JDsSurfaceLoads::SaveFinal(){
+  for(unsigned c=0;c<GetCount();c++){
+    JDsSurfaceLoadsItem* sf=List[c];
+    sf->SaveWindow(sf->GetLastTime(),DirOut,Compress,Log);
+    Log->Printf("SurfaceLoads \'%s\': %u windows saved in \"%s\".",sf->Name.c_str(),sf->GetNumSaves(),(string("SurfaceLoads_")+sf->Name+".pvd").c_str());
+  }
+}
@@ -0,0 +1,167 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Acumulacion de presion, fuerza e impulso en cada particula de contorno de
+//:#   los bloques mk seleccionados por ventanas de tiempo. Cada ventana se graba
+//:#   en un fichero VTU binario. (19-10-2026)
+//:#############################################################################
+
+/// \file JDsSurfaceLoads.h \brief Declares the classes \ref JDsSurfaceLoadsItem and \ref JDsSurfaceLoads.
+
+#ifndef _JDsSurfaceLoads_
+#define _JDsSurfaceLoads_
+
+#include <string>
+#include <vector>
+#include "JObject.h"
+#include "DualSphDef.h"
+#include "JCellDivDataCpu.h"
+
+class JXml;
+class TiXmlElement;
+class JLog2;
+class JSphMk;
+
+//##############################################################################
+//# XML format in _FmtXML_SurfaceLoads.xml.
+//##############################################################################
+//  <surfaceloads>
+//    <surface name="Hull" mkbound="1,3-4" comment="List of mkbound of fixed, moving or floating particles">
+//      <window value="0.5" comment="Duration of time windows. 0:whole simulation (default=0)" />
+//      <computetime start="0.5" end="2" comment="Time interval of accumulation (default=all simulation)" />
+//    </surface>
+//  </surfaceloads>
+
+//##############################################################################
+//# JDsSurfaceLoadsItem
+//##############################################################################
+/// \brief Accumulates loads on the boundary particles of selected mk blocks.
+///
+/// For each particle the pressure (from Pressc) and the force exerted by the
+/// fluid (pressure term of momentum equation with fluid neighbours, as in
+/// JGaugeForce) are accumulated: peak, time integral and mean values over
+/// each time window. Particles are processed in parallel and each one only
+/// updates its own values.
+
+class JDsSurfaceLoadsItem : protected JObject
+{
+public:
+  const unsigned Idx;       ///<Index of surface.
+  const std::string Name;   ///<Name of surface.
+
+protected:
+  ///Selected block of particles.
+  typedef struct{
+    word mkbound;           ///<Mkbound of block.
+    typecode code;          ///<Code of particles (type and value).
+    unsigned idbegin;       ///<Id of first particle.
+    unsigned count;         ///<Number of particles.
+    unsigned offset;        ///<Position of first particle in accumulated data.
+    float massp;            ///<Mass of particles.
+    bool floating;          ///<Floating particles.
+  }StBlock;
+
+  //-Definition.
+  std::string MkBoundList;  ///<List of selected mkbound.
+  std::vector<StBlock> Blocks;
+  unsigned Np;              ///<Number of selected particles.
+  bool Floatings;           ///<Some floating block is selected.
+  double WindowDt;          ///<Duration of time windows (0:whole simulation).
+  double ComputeStart;      ///<Initial time of accumulation.
+  double ComputeEnd;        ///<Final time of accumulation.
+
+  //-Accumulated data of current window.
+  double WindowIni;         ///<Initial time of current window.
+  double WindowTime;        ///<Accumulated time of current window.
+  unsigned WindowSteps;     ///<Number of accumulated steps of current window.
+  double LastTime;          ///<Final time of last accumulated step.
+  std::vector<tdouble3> Pos;     ///<Last position of particles.
+  std::vector<float> PressMax;   ///<Peak pressure.
+  std::vector<double> PressInt;  ///<Time integral of pressure.
+  std::vector<float> ForceMax;   ///<Peak force modulus.
+  std::vector<tdouble3> Impulse; ///<Time integral of force.
+  unsigned NumSaves;        ///<Number of saved windows.
+  std::vector<std::string> OutFiles; ///<Saved files for PVD collection.
+  std::vector<double> OutTimes;      ///<Final time of saved windows for PVD collection.
+
+  void ResetWindow(double timeini);
+  template<TpKernel tker> void ComputeCpuT(double dt,const StCteSph &csp,const StDivDataCpu &dvd
+    ,unsigned npbok,unsigned npb,unsigned np,const tdouble3 *pos,const typecode *code
+    ,const unsigned *idp,const tfloat4 *velrhop,const float *press);
+
+public:
+  JDsSurfaceLoadsItem(unsigned idx,const std::string &name);
+  ~JDsSurfaceLoadsItem();
+  void Reset();
+
+  void ReadXml(const JXml *sxml,TiXmlElement* ele);
+  void ConfigBlocks(const JSphMk *mkinfo,const StCteSph &csp,unsigned ftcount,const StFloatingData *ftobjs);
+  void GetConfig(std::vector<std::string> &lines)const;
+
+  unsigned GetNp()const{ return(Np); }
+  unsigned GetNumSaves()const{ return(NumSaves); }
+  double GetLastTime()const{ return(LastTime); }
+  bool Update(double timestep)const{ return(ComputeStart<timestep && timestep<=ComputeEnd); }
+
+  void ComputeCpu(double timestep,double dt,const StCteSph &csp,const StDivDataCpu &dvd
+    ,unsigned npbok,unsigned npb,unsigned np,const tdouble3 *pos,const typecode *code
+    ,const unsigned *idp,const tfloat4 *velrhop,const float *press
+    ,const std::string &dirout,bool compress,JLog2 *log);
+  void SaveWindow(double timestep,const std::string &dirout,bool compress,JLog2 *log);
+};
+
+
+//##############################################################################
+//# JDsSurfaceLoads
+//##############################################################################
+/// \brief Manages the in-situ accumulation of loads on boundary particles (only on CPU).
+
+class JDsSurfaceLoads : protected JObject
+{
+protected:
+  JLog2 *Log;
+  StCteSph CSP;             ///<Structure with main SPH constants values and configurations.
+  std::string DirOut;       ///<Directory for output files.
+  bool Compress;            ///<Compresses binary data of VTU files using zlib.
+  std::vector<JDsSurfaceLoadsItem*> List;
+
+  void ReadXml(const JXml *sxml,TiXmlElement* lis,const JSphMk *mkinfo,unsigned ftcount,const StFloatingData *ftobjs);
+
+public:
+  JDsSurfaceLoads(JLog2 *log);
+  ~JDsSurfaceLoads();
+  void Reset();
+
+  void Config(const StCteSph &csp,const std::string &dirout,bool compress);
+  void LoadXml(const JXml *sxml,const std::string &place,const JSphMk *mkinfo,unsigned ftcount,const StFloatingData *ftobjs);
+  void VisuConfig(std::string txhead,std::string txfoot)const;
+
+  unsigned GetCount()const{ return(unsigned(List.size())); }
+
+  void ComputeCpu(double timestep,double dt,const StDivDataCpu &dvd
+    ,unsigned npbok,unsigned npb,unsigned np,const tdouble3 *pos,const typecode *code
+    ,const unsigned *idp,const tfloat4 *velrhop,const float *press);
+  void SaveFinal();
+};
+
+#endif
+
+
@@ -0,0 +1,351 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JDsTelemetry.cpp \brief Implements the class \ref JDsTelemetry.
+
+#include "JDsTelemetry.h"
+#include "JLog2.h"
+#include "Functions.h"
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <algorithm>
+#ifndef _WIN32
+  #include <unistd.h>
+  #include <poll.h>
+  #include <sys/socket.h>
+  #include <sys/stat.h>
+  #include <sys/un.h>
+#endif
+
+using namespace std;
+
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JDsTelemetry::JDsTelemetry(const std::string &socketfile,const std::string &runcode,JLog2 *log)
+  :Log(log),SocketFile(socketfile),RunCode(runcode),TimeIni(std::chrono::steady_clock::now())
+{
+  ClassName="JDsTelemetry";
+  Worker=NULL;
+  SockFd=-1;
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JDsTelemetry::~JDsTelemetry(){
+  DestructorActive=true;
+  Reset();
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JDsTelemetry::Reset(){
+  StopWorker();
+  TimerNames.clear();
+  Gauges.clear();
+  InitData(Data);
+  InitData(Shared);
+  Served=0;
+  History.clear();
+}
+
+//==============================================================================
+/// Initialisation of values of the run.
+//==============================================================================
+void JDsTelemetry::InitData(StData &d)const{
+  d.version=0;
+  d.skipped=0;
+  d.wall=0;
+  d.nstep=0;
+  d.part=0;
+  d.timestep=d.timemax=0;
+  d.np=d.npok=0;
+  d.memcpu=0;
+  d.dtcount=0;
+  d.dtmin=d.dtmax=0;
+  memset(d.dts,0,sizeof(double)*DTHISTORY);
+  d.timers.assign(TimerNames.size(),0);
+  StGaugeValue g={0,{0,0,0}};
+  d.gauges.assign(Gauges.size(),g);
+}
+
+//==============================================================================
+/// Adds timer to the published values (before Start()).
+//==============================================================================
+void JDsTelemetry::AddTimer(const std::string &name){
+  if(Worker)Run_Exceptioon("Timers can not be added after start.");
+  TimerNames.push_back(name);
+}
+
+//==============================================================================
+/// Adds gauge with 1 or 3 values to the published values (before Start()).
+//==============================================================================
+void JDsTelemetry::AddGauge(const std::string &name,const std::string &type,unsigned ncomp){
+  if(Worker)Run_Exceptioon("Gauges can not be added after start.");
+  if(ncomp!=1 && ncomp!=3)Run_Exceptioon("Number of values of gauge is invalid.");
+  StGaugeDef g={name,type,ncomp};
+  Gauges.push_back(g);
+}
+
+//==============================================================================
+/// Creates the socket and starts the secondary thread.
+//==============================================================================
+void JDsTelemetry::Start(){
+  if(Worker)Run_Exceptioon("Telemetry server is already started.");
+  InitData(Data);
+  InitData(Shared);
+ #ifdef _WIN32
+  Run_Exceptioon("Telemetry server is not available on Windows.");
+ #else
+  struct sockaddr_un addr;
+  memset(&addr,0,sizeof(addr));
+  addr.sun_family=AF_UNIX;
+  if(SocketFile.empty() || SocketFile.size()>=sizeof(addr.sun_path))Run_ExceptioonFile("Path of the socket file is empty or too long.",SocketFile);
+  strcpy(addr.sun_path,SocketFile.c_str());
+  //-Removes socket file of a previous run (other files are not removed).
+  struct stat st;
+  if(!lstat(SocketFile.c_str(),&st)){
+    if(!S_ISSOCK(st.st_mode))Run_ExceptioonFile("The file already exists and it is not a socket.",SocketFile);
+    unlink(SocketFile.c_str());
+  }
+  SockFd=socket(AF_UNIX,SOCK_STREAM,0);
+  if(SockFd<0)Run_Exceptioon(string("Socket could not be created (")+strerror(errno)+").");
+  if(bind(SockFd,(struct sockaddr*)&addr,sizeof(addr))<0 || listen(SockFd,16)<0){
+    const string err=strerror(errno);
+    close(SockFd); SockFd=-1;
+    Run_ExceptioonFile(string("Socket could not be bound (")+err+").",SocketFile);
+  }
+  Stop=false;
+  Worker=new std::thread(WorkerRun,this);
+ #endif
+}
+
+//==============================================================================
+/// Stops the secondary thread and removes the socket.
+//==============================================================================
+void JDsTelemetry::StopWorker(){
+  if(Worker){
+    Stop=true;
+    Worker->join();
+    delete Worker; Worker=NULL;
+  }
+ #ifndef _WIN32
+  if(SockFd>=0){
+    close(SockFd); SockFd=-1;
+    unlink(SocketFile.c_str());
+  }
+ #endif
+}
+
+//==============================================================================
+/// Stops the server at the end of the run.
+//==============================================================================
+void JDsTelemetry::Finish(){
+  StopWorker();
+}
+
+//==============================================================================
+/// Shows configuration.
+//==============================================================================
+void JDsTelemetry::VisuConfig()const{
+  Log->Printf("Telemetry: JSON lines served on socket \"%s\" (%u timers, %u gauges)."
+    ,SocketFile.c_str(),unsigned(TimerNames.size()),unsigned(Gauges.size()));
+}
+
+//==============================================================================
+/// Adds value of dt to the history (main thread).
+//==============================================================================
+void JDsTelemetry::AddDt(double dt){
+  Data.dts[Data.dtcount%DTHISTORY]=dt;
+  if(!Data.dtcount || dt<Data.dtmin)Data.dtmin=dt;
+  if(!Data.dtcount || dt>Data.dtmax)Data.dtmax=dt;
+  Data.dtcount++;
+}
+
+//==============================================================================
+/// Publishes the values of the main thread without waiting. When the shared
+/// values are being copied by the secondary thread the publication is skipped.
+//==============================================================================
+void JDsTelemetry::Publish(){
+  std::unique_lock<std::mutex> lock(Mtx,std::try_to_lock);
+  if(lock.owns_lock()){
+    Data.version++;
+    Data.wall=Now();
+    Shared=Data;
+  }
+  else Data.skipped++;
+}
+
+//==============================================================================
+/// Function of secondary thread.
+//==============================================================================
+void JDsTelemetry::WorkerRun(JDsTelemetry *tel){
+  tel->WorkerLoop();
+}
+
+//==============================================================================
+/// Copies the last published values. Returns false when there is not any one.
+//==============================================================================
+bool JDsTelemetry::CopyShared(StData &d){
+  std::lock_guard<std::mutex> lock(Mtx);
+  if(!Shared.version)return(false);
+  d=Shared;
+  return(true);
+}
+
+//==============================================================================
+/// Stores sample to compute rates and removes the old ones.
+//==============================================================================
+void JDsTelemetry::AddSample(const StData &d){
+  if(History.empty() || d.wall>=History.back().wall+SAMPLEMS/1000.){
+    if(!History.empty() && History.back().version==d.version)return;
+    History.push_back(d);
+    while(History.size()>2 && History[1].wall<=d.wall-RATEWINDOW)History.pop_front();
+  }
+}
+
+//==============================================================================
+/// Loop of secondary thread. Takes samples of the published values and
+/// serves the requests of clients.
+//==============================================================================
+void JDsTelemetry::WorkerLoop(){
+ #ifndef _WIN32
+  StData d;
+  InitData(d);
+  while(!Stop){
+    struct pollfd pfd;
+    pfd.fd=SockFd;
+    pfd.events=POLLIN;
+    pfd.revents=0;
+    const int rp=poll(&pfd,1,POLLMS);
+    if(CopyShared(d))AddSample(d);
+    if(rp>0 && (pfd.revents&POLLIN)){
+      const int fd=accept(SockFd,NULL,NULL);
+      if(fd>=0){
+        ServeClient(fd,(d.version? GetJson(d): string("{ \"run\" : \"")+RunCode+"\", \"state\" : \"starting\" }")+"\n");
+        close(fd);
+        Served++;
+      }
+    }
+  }
+ #endif
+}
+
+//==============================================================================
+/// Writes the text to the client with a limited waiting time.
+//==============================================================================
+void JDsTelemetry::ServeClient(int fd,const std::string &tx)const{
+ #ifndef _WIN32
+  struct timeval tv={1,0};
+  setsockopt(fd,SOL_SOCKET,SO_SNDTIMEO,&tv,sizeof(tv));
+  int flags=0;
+  #ifdef MSG_NOSIGNAL
+    flags=MSG_NOSIGNAL;
+  #endif
+  size_t sent=0;
+  while(sent<tx.size()){
+    const ssize_t n=send(fd,tx.c_str()+sent,tx.size()-sent,flags);
+    if(n<=0)break;
+    sent+=size_t(n);
+  }
+ #endif
+}
+
+//==============================================================================
+/// Returns JSON line with the values and the rates of the last seconds.
+//==============================================================================
+std::string JDsTelemetry::GetJson(const StData &d)const{
+  //-Reference sample for rates.
+  const StData *r=(!History.empty() && History.front().version<d.version? &History.front(): NULL);
+  const double dwall=(r? d.wall-r->wall: 0);
+  const int dsteps=(r? d.nstep-r->nstep: 0);
+  std::vector<std::string> v;
+  v.push_back(fun::JSONProperty("run",RunCode));
+  v.push_back(fun::JSONProperty("state",string("running")));
+  v.push_back(fun::JSONPropertyValue("wall_s",fun::DoubleStr(d.wall,"%.3f")));
+  v.push_back(fun::JSONPropertyValue("age_s",fun::DoubleStr(max(Now()-d.wall,0.),"%.3f")));
+  v.push_back(fun::JSONProperty("nstep",d.nstep));
+  v.push_back(fun::JSONProperty("part",d.part));
+  v.push_back(fun::JSONPropertyValue("time",fun::DoubleStr(d.timestep,"%.9g")));
+  v.push_back(fun::JSONPropertyValue("timemax",fun::DoubleStr(d.timemax,"%.9g")));
+  v.push_back(fun::JSONPropertyValue("progress",fun::DoubleStr(d.timemax? d.timestep/d.timemax: 0,"%.6f")));
+  v.push_back(fun::JSONProperty("np",d.np));
+  v.push_back(fun::JSONProperty("npok",d.npok));
+  v.push_back(fun::JSONPropertyValue("memory_cpu",fun::LongStr(d.memcpu)));
+  //-Values of dt.
+  {
+    const unsigned n=unsigned(min(d.dtcount,ullong(DTHISTORY)));
+    std::vector<std::string> dts;
+    for(unsigned c=0;c<n;c++)dts.push_back(fun::DoubleStr(d.dts[(d.dtcount-n+c)%DTHISTORY],"%.6e"));
+    std::vector<std::string> vdt;
+    vdt.push_back(fun::JSONPropertyValue("last",fun::DoubleStr(n? d.dts[(d.dtcount-1)%DTHISTORY]: 0,"%.6e")));
+    vdt.push_back(fun::JSONPropertyValue("min",fun::DoubleStr(d.dtmin,"%.6e")));
+    vdt.push_back(fun::JSONPropertyValue("max",fun::DoubleStr(d.dtmax,"%.6e")));
+    vdt.push_back(fun::JSONPropertyValue("history",fun::JSONArray(dts)));
+    v.push_back(fun::JSONPropertyValue("dt",fun::JSONObject(vdt)));
+  }
+  //-Rates of the last seconds.
+  {
+    std::vector<std::string> vr;
+    vr.push_back(fun::JSONPropertyValue("window_s",fun::DoubleStr(dwall,"%.3f")));
+    vr.push_back(fun::JSONPropertyValue("steps_per_s",fun::DoubleStr(dwall>0? dsteps/dwall: 0,"%.6g")));
+    vr.push_back(fun::JSONPropertyValue("simtime_per_s",fun::DoubleStr(dwall>0? (d.timestep-r->timestep)/dwall: 0,"%.6g")));
+    v.push_back(fun::JSONPropertyValue("rates",fun::JSONObject(vr)));
+  }
+  //-Timers.
+  if(!TimerNames.empty()){
+    std::vector<std::string> vt;
+    for(unsigned c=0;c<unsigned(TimerNames.size());c++){
+      const double dt=(r? d.timers[c]-r->timers[c]: 0);
+      std::vector<std::string> t;
+      t.push_back(fun::JSONProperty("name",TimerNames[c]));
+      t.push_back(fun::JSONPropertyValue("total_s",fun::DoubleStr(d.timers[c],"%.6g")));
+      t.push_back(fun::JSONPropertyValue("ms_per_step",fun::DoubleStr(dsteps>0? dt*1000/dsteps: 0,"%.6g")));
+      t.push_back(fun::JSONPropertyValue("fraction",fun::DoubleStr(dwall>0? dt/dwall: 0,"%.4f")));
+      vt.push_back(fun::JSONObject(t));
+    }
+    v.push_back(fun::JSONPropertyValue("timers",fun::JSONArray(vt)));
+  }
+  //-Gauges.
+  if(!Gauges.empty()){
+    std::vector<std::string> vg;
+    for(unsigned c=0;c<unsigned(Gauges.size());c++){
+      const StGaugeDef &gd=Gauges[c];
+      const StGaugeValue &gv=d.gauges[c];
+      std::vector<std::string> g;
+      g.push_back(fun::JSONProperty("name",gd.name));
+      g.push_back(fun::JSONProperty("type",gd.type));
+      g.push_back(fun::JSONPropertyValue("time",fun::DoubleStr(gv.time,"%.9g")));
+      if(gd.ncomp==1)g.push_back(fun::JSONPropertyValue("value",fun::DoubleStr(gv.v[0],"%.7g")));
+      else{
+        std::vector<std::string> vv;
+        for(unsigned cv=0;cv<gd.ncomp;cv++)vv.push_back(fun::DoubleStr(gv.v[cv],"%.7g"));
+        g.push_back(fun::JSONPropertyValue("value",fun::JSONArray(vv)));
+      }
+      vg.push_back(fun::JSONObject(g));
+    }
+    v.push_back(fun::JSONPropertyValue("gauges",fun::JSONArray(vg)));
+  }
+  v.push_back(fun::JSONPropertyValue("skipped",fun::UlongStr(d.skipped)));
+  return(fun::JSONObject(v));
+}
+
@@ -0,0 +1,155 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Servidor de telemetria de la ejecucion en un socket Unix local. Cada
+//:#   conexion recibe una linea JSON con el estado actual (paso, tiempo,
+//:#   historial de dt, particulas, memoria, tiempos por fase y valores de
+//:#   gauges). Un hilo secundario atiende las conexiones y calcula las tasas,
+//:#   el bucle principal solo copia valores. (19-10-2026)
+//:#############################################################################
+
+/// \file JDsTelemetry.h \brief Declares the class \ref JDsTelemetry.
+
+#ifndef _JDsTelemetry_
+#define _JDsTelemetry_
+
+#include "TypesDef.h"
+#include "JObject.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+class JLog2;
+
+//##############################################################################
+//# JDsTelemetry
+//##############################################################################
+/// \brief Serves the state of the run as JSON lines on a local Unix socket.
+///
+/// The main thread fills the values of the current step (GetData()) and
+/// publishes them with Publish(), which never waits: when the secondary thread
+/// is copying the shared values the publication is skipped until the next
+/// step. The secondary thread accepts the connections on the socket, writes
+/// one JSON line with the last published values to each client and closes the
+/// connection, so clients only need to connect and read one line. The rates
+/// (steps per second and milliseconds per step of each timer) are computed by
+/// the secondary thread over the last seconds of the run.
+
+class JDsTelemetry : protected JObject
+{
+public:
+  static const unsigned DTHISTORY=100;   ///<Number of stored values of dt.
+
+  ///Values of one gauge.
+  typedef struct{
+    double time;        ///<Time of the last measurement.
+    double v[3];        ///<Values of the last measurement.
+  }StGaugeValue;
+
+  ///Values of the run published by the main thread.
+  typedef struct{
+    ullong version;     ///<Number of publication.
+    ullong skipped;     ///<Number of publications skipped because the shared values were locked.
+    double wall;        ///<Wall time since start (in seconds).
+    int nstep;          ///<Number of step.
+    unsigned part;      ///<Number of next PART.
+    double timestep;    ///<Simulated time.
+    double timemax;     ///<Final simulated time.
+    unsigned np;        ///<Number of particles.
+    unsigned npok;      ///<Number of particles excluding periodic ones.
+    llong memcpu;       ///<Allocated memory on CPU (in bytes).
+    ullong dtcount;     ///<Number of dt values stored in history.
+    double dtmin;       ///<Minimum dt of the run.
+    double dtmax;       ///<Maximum dt of the run.
+    double dts[DTHISTORY];            ///<Last values of dt (ring buffer).
+    std::vector<double> timers;       ///<Accumulated time of timers (in seconds).
+    std::vector<StGaugeValue> gauges; ///<Last values of gauges.
+  }StData;
+
+protected:
+  static const unsigned POLLMS=200;      ///<Maximum waiting time of secondary thread (in milliseconds).
+  static const unsigned SAMPLEMS=500;    ///<Minimum time between samples for rates (in milliseconds).
+  static const unsigned RATEWINDOW=5;    ///<Time window to compute rates (in seconds).
+
+  ///Definition of one gauge.
+  typedef struct{
+    std::string name;
+    std::string type;
+    unsigned ncomp;     ///<Number of values (1 or 3).
+  }StGaugeDef;
+
+  JLog2 *Log;
+  const std::string SocketFile;
+  const std::string RunCode;
+  const std::chrono::steady_clock::time_point TimeIni;  ///<Reference of wall time.
+
+  //-Definitions (constant after Start()).
+  std::vector<std::string> TimerNames;
+  std::vector<StGaugeDef> Gauges;
+
+  StData Data;                     ///<Values of main thread.
+  StData Shared;                   ///<Last published values (protected by Mtx).
+  std::mutex Mtx;                  ///<Protects Shared.
+
+  std::thread *Worker;             ///<Secondary thread.
+  std::atomic<bool> Stop;          ///<Secondary thread has to finish.
+  int SockFd;                      ///<Listening socket (-1: not created).
+  ullong Served;                   ///<Number of served requests (only used by secondary thread).
+  std::deque<StData> History;      ///<Samples to compute rates (only used by secondary thread).
+
+  void InitData(StData &d)const;
+  double Now()const{ return(std::chrono::duration<double>(std::chrono::steady_clock::now()-TimeIni).count()); }
+  void StopWorker();
+  static void WorkerRun(JDsTelemetry *tel);
+  void WorkerLoop();
+  bool CopyShared(StData &d);
+  void AddSample(const StData &d);
+  std::string GetJson(const StData &d)const;
+  void ServeClient(int fd,const std::string &tx)const;
+
+public:
+  JDsTelemetry(const std::string &socketfile,const std::string &runcode,JLog2 *log);
+  ~JDsTelemetry();
+  void Reset();
+
+  void AddTimer(const std::string &name);
+  void AddGauge(const std::string &name,const std::string &type,unsigned ncomp);
+  void Start();
+  void VisuConfig()const;
+
+  void Finish();
+
+  std::string GetSocketFile()const{ return(SocketFile); }
+  ullong GetServed()const{ return(Worker? 0: Served); }
+
+  //-Methods used by the main thread.
+  StData& GetData(){ return(Data); }
+  void AddDt(double dt);
+  void Publish();
+};
+
+#endif
+
+
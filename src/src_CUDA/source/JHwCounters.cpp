@@ -0,0 +1,340 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JHwCounters.cpp \brief Implements the class \ref JHwCounters.
+
+#include "JHwCounters.h"
+#include "JLog2.h"
+#include "JSaveCsv2.h"
+#include "Functions.h"
+#include "OmpDefs.h"
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <fstream>
+#include <algorithm>
+
+#ifdef __linux__
+  #include <linux/perf_event.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+using namespace std;
+
+JHwCounters* JHwCounters::Active=NULL;
+
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JHwCounters::JHwCounters(JLog2 *log):Log(log),TimeIni(std::chrono::steady_clock::now()){
+  ClassName="JHwCounters";
+  Threads=0;
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JHwCounters::~JHwCounters(){
+  DestructorActive=true;
+  SetActive(false);
+  Reset();
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JHwCounters::Reset(){
+  CloseAll();
+  Regions.clear();
+}
+
+//==============================================================================
+/// Closes all counters.
+//==============================================================================
+void JHwCounters::CloseAll(){
+#ifdef __linux__
+  for(unsigned cg=0;cg<unsigned(Groups.size());cg++){
+    const StGroup &g=Groups[cg];
+    for(unsigned c=0;c<unsigned(g.fds.size());c++)close(g.fds[c]);
+  }
+#endif
+  Groups.clear();
+  Threads=0;
+  for(unsigned c=0;c<HWC_COUNT;c++)Avail[c]=false;
+  ErrorHw="";
+}
+
+//==============================================================================
+/// Returns the name of the counter.
+//==============================================================================
+const char* JHwCounters::GetName(TpHwCounter c){
+  switch(c){
+    case HWC_Cycles:       return("Cycles");
+    case HWC_Instructions: return("Instructions");
+    case HWC_LlcRefs:      return("LlcRefs");
+    case HWC_LlcMisses:    return("LlcMisses");
+    case HWC_FpScalar:     return("FpScalar");
+    case HWC_FpVec128:     return("FpVec128");
+    case HWC_FpVec256:     return("FpVec256");
+    case HWC_FpVec512:     return("FpVec512");
+    case HWC_TaskClock:    return("TaskClock");
+    case HWC_PageFaults:   return("PageFaults");
+  }
+  return("???");
+}
+
+//==============================================================================
+/// Returns true when the vendor of the CPU is Intel (the events of
+/// floating-point instructions are specific of Intel).
+//==============================================================================
+bool JHwCounters::CpuIsIntel(){
+  bool intel=false;
+#ifdef __linux__
+  ifstream pf("/proc/cpuinfo");
+  string line;
+  while(pf && getline(pf,line)){
+    if(line.find("vendor_id")==0){
+      intel=(line.find("GenuineIntel")!=string::npos);
+      break;
+    }
+  }
+#endif
+  return(intel);
+}
+
+//==============================================================================
+/// Opens one counter for the calling thread in the group of groupfd (-1 to
+/// create a new group). Returns the file descriptor or -1 and the error code.
+//==============================================================================
+int JHwCounters::OpenCounter(unsigned type,ullong config,int groupfd,int &err){
+  int fd=-1;
+  err=0;
+#ifdef __linux__
+  struct perf_event_attr attr;
+  memset(&attr,0,sizeof(attr));
+  attr.size=sizeof(attr);
+  attr.type=type;
+  attr.config=config;
+  attr.exclude_kernel=1;
+  attr.exclude_hv=1;
+  attr.read_format=PERF_FORMAT_GROUP|PERF_FORMAT_TOTAL_TIME_ENABLED|PERF_FORMAT_TOTAL_TIME_RUNNING;
+  fd=int(syscall(__NR_perf_event_open,&attr,0,-1,groupfd,0));
+  if(fd<0)err=errno;
+#else
+  err=ENOSYS;
+#endif
+  return(fd);
+}
+
+//==============================================================================
+/// Opens the counters for each OpenMP thread. Returns true when some counter
+/// is available.
+//==============================================================================
+bool JHwCounters::Config(int threads){
+  CloseAll();
+#ifdef __linux__
+  //-Definition of counters (type, config and group).
+  const bool intel=CpuIsIntel();
+  const unsigned fpevent=0xC7; //-FP_ARITH_INST_RETIRED with umask: scalar(0x03), 128b(0x0C), 256b(0x30), 512b(0xC0).
+  const unsigned types[HWC_COUNT]={PERF_TYPE_HARDWARE,PERF_TYPE_HARDWARE,PERF_TYPE_HARDWARE,PERF_TYPE_HARDWARE
+    ,PERF_TYPE_RAW,PERF_TYPE_RAW,PERF_TYPE_RAW,PERF_TYPE_RAW,PERF_TYPE_SOFTWARE,PERF_TYPE_SOFTWARE};
+  const ullong configs[HWC_COUNT]={PERF_COUNT_HW_CPU_CYCLES,PERF_COUNT_HW_INSTRUCTIONS
+    ,PERF_COUNT_HW_CACHE_REFERENCES,PERF_COUNT_HW_CACHE_MISSES
+    ,(0x03<<8)|fpevent,(0x0C<<8)|fpevent,(0x30<<8)|fpevent,(0xC0<<8)|fpevent
+    ,PERF_COUNT_SW_TASK_CLOCK,PERF_COUNT_SW_PAGE_FAULTS};
+  const unsigned groups[HWC_COUNT]={0,0,0,0,1,1,1,1,2,2};
+  //-Opens counters in each thread.
+  Threads=unsigned(max(threads,1));
+  Groups.resize(Threads*GROUPS);
+  vector<int> errs(Threads*HWC_COUNT,0);
+  #ifdef OMP_USE
+    #pragma omp parallel num_threads(Threads)
+  #endif
+  {
+    #ifdef OMP_USE
+      const unsigned th=unsigned(omp_get_thread_num());
+    #else
+      const unsigned th=0;
+    #endif
+    for(unsigned cg=0;cg<GROUPS;cg++){
+      StGroup &g=Groups[th*GROUPS+cg];
+      g.leader=-1;
+      for(unsigned c=0;c<HWC_COUNT;c++)if(groups[c]==cg){
+        if(groups[c]==1 && !intel){ errs[th*HWC_COUNT+c]=ENOENT; continue; }
+        int err=0;
+        const int fd=OpenCounter(types[c],configs[c],g.leader,err);
+        if(fd>=0){
+          if(g.leader<0)g.leader=fd;
+          g.fds.push_back(fd);
+          g.members.push_back(c);
+        }
+        else errs[th*HWC_COUNT+c]=err;
+      }
+    }
+  }
+  //-A counter is available when it was opened in all threads.
+  for(unsigned c=0;c<HWC_COUNT;c++){
+    bool ok=true;
+    for(unsigned th=0;th<Threads && ok;th++){
+      const StGroup &g=Groups[th*GROUPS+groups[c]];
+      ok=(find(g.members.begin(),g.members.end(),c)!=g.members.end());
+    }
+    Avail[c]=ok;
+  }
+  if(!Avail[HWC_Cycles]){
+    const int err=errs[HWC_Cycles];
+    ErrorHw=(err? strerror(err): "not available in all threads");
+  }
+#endif
+  return(GetAvailableAny());
+}
+
+//==============================================================================
+/// Returns true when some counter is available.
+//==============================================================================
+bool JHwCounters::GetAvailableAny()const{
+  bool ok=false;
+  for(unsigned c=0;c<HWC_COUNT && !ok;c++)ok=Avail[c];
+  return(ok);
+}
+
+//==============================================================================
+/// Activates or deactivates the counters of regions.
+//==============================================================================
+void JHwCounters::SetActive(bool active){
+  if(active)Active=this;
+  else if(Active==this)Active=NULL;
+}
+
+//==============================================================================
+/// Defines a region with the given index.
+//==============================================================================
+void JHwCounters::AddRegion(unsigned id,const char *name){
+  if(id>=Regions.size()){
+    StRegion r;
+    memset(&r,0,sizeof(StRegion));
+    Regions.resize(id+1,r);
+  }
+  Regions[id].name=name;
+}
+
+//==============================================================================
+/// Initialises the values accumulated by all regions.
+//==============================================================================
+void JHwCounters::ResetValues(){
+  for(unsigned id=0;id<unsigned(Regions.size());id++){
+    StRegion &r=Regions[id];
+    r.calls=0;
+    r.time=0;
+    for(unsigned c=0;c<HWC_COUNT;c++)r.values[c]=0;
+  }
+}
+
+//==============================================================================
+/// Reads the current values of all counters adding all threads. The values
+/// are scaled when the counters were multiplexed by the kernel.
+//==============================================================================
+void JHwCounters::ReadValues(double *values)const{
+  for(unsigned c=0;c<HWC_COUNT;c++)values[c]=0;
+#ifdef __linux__
+  ullong buf[3+HWC_COUNT];
+  for(unsigned cg=0;cg<unsigned(Groups.size());cg++){
+    const StGroup &g=Groups[cg];
+    if(g.leader>=0){
+      const size_t size=sizeof(ullong)*(3+g.members.size());
+      if(read(g.leader,buf,size)==ssize_t(size) && buf[2]){
+        const double scale=double(buf[1])/double(buf[2]);
+        for(unsigned c=0;c<unsigned(g.members.size());c++)values[g.members[c]]+=double(buf[3+c])*scale;
+      }
+    }
+  }
+#endif
+}
+
+//==============================================================================
+/// Ends the region and accumulates the values of counters.
+//==============================================================================
+void JHwCounters::Stop(unsigned id){
+  if(id<Regions.size() && Regions[id].open){
+    StRegion &r=Regions[id];
+    double v[HWC_COUNT];
+    ReadValues(v);
+    for(unsigned c=0;c<HWC_COUNT;c++)r.values[c]+=v[c]-r.vstart[c];
+    r.time+=Now()-r.tstart;
+    r.calls++;
+    r.open=false;
+  }
+}
+
+//==============================================================================
+/// Returns text with the value of counter c divided by factor or "-" when the
+/// counter is not available.
+//==============================================================================
+std::string JHwCounters::ValueStr(const StRegion &r,unsigned c,double factor,const char *fmt)const{
+  return(Avail[c] && factor? fun::PrintStr(fmt,r.values[c]/factor): string("-"));
+}
+
+//==============================================================================
+/// Shows summary of regions with derived metrics using Log.
+//==============================================================================
+void JHwCounters::VisuSummary(const std::string &title)const{
+  Log->Print(title);
+  string unavail;
+  for(unsigned c=0;c<HWC_COUNT;c++)if(!Avail[c])unavail=unavail+(unavail.empty()? "": ", ")+GetName(TpHwCounter(c));
+  if(!unavail.empty())Log->Printf("  Not available: %s%s",unavail.c_str(),(ErrorHw.empty()? "": fun::PrintStr(" (%s)",ErrorHw.c_str()).c_str()));
+  Log->Print("  Region             Calls   Time[s]   Gcycles     IPC  LLCmiss[%]  BW[GB/s]  FpVec[%]  CPUs");
+  for(unsigned id=0;id<unsigned(Regions.size());id++){
+    const StRegion &r=Regions[id];
+    if(!r.name || !r.calls)continue;
+    const double fp=r.values[HWC_FpScalar]+r.values[HWC_FpVec128]+r.values[HWC_FpVec256]+r.values[HWC_FpVec512];
+    const bool fpok=(Avail[HWC_FpScalar] && Avail[HWC_FpVec128] && Avail[HWC_FpVec256] && Avail[HWC_FpVec512] && fp>0);
+    const string ipc=(Avail[HWC_Cycles] && Avail[HWC_Instructions] && r.values[HWC_Cycles]>0? fun::PrintStr("%.3f",r.values[HWC_Instructions]/r.values[HWC_Cycles]): string("-"));
+    const string llc=(Avail[HWC_LlcRefs] && Avail[HWC_LlcMisses] && r.values[HWC_LlcRefs]>0? fun::PrintStr("%.2f",r.values[HWC_LlcMisses]*100/r.values[HWC_LlcRefs]): string("-"));
+    const string bw=ValueStr(r,HWC_LlcMisses,(r.time>0? r.time*1.e9/CACHELINE: 0),"%.3f");
+    const string vec=(fpok? fun::PrintStr("%.2f",(fp-r.values[HWC_FpScalar])*100/fp): string("-"));
+    const string cpus=ValueStr(r,HWC_TaskClock,r.time*1.e9,"%.2f");
+    Log->Printf("  %-15s %8llu %9.3f %9s %7s %11s %9s %9s %5s",r.name,r.calls,r.time
+      ,ValueStr(r,HWC_Cycles,1.e9,"%.3f").c_str(),ipc.c_str(),llc.c_str(),bw.c_str(),vec.c_str(),cpus.c_str());
+  }
+}
+
+//==============================================================================
+/// Saves CSV file with the values of counters per region (-1 when the counter
+/// is not available).
+//==============================================================================
+void JHwCounters::SaveCsv(const std::string &file,bool csvsepcoma)const{
+  jcsv::JSaveCsv2 scsv(file,false,csvsepcoma);
+  scsv.SetHead();
+  scsv << "Region;Calls;Time [s]";
+  for(unsigned c=0;c<HWC_COUNT;c++)scsv << GetName(TpHwCounter(c));
+  scsv << jcsv::Endl();
+  scsv.SetData();
+  scsv << jcsv::Fmt(jcsv::TpDouble1,"%.9g");
+  for(unsigned id=0;id<unsigned(Regions.size());id++){
+    const StRegion &r=Regions[id];
+    if(!r.name || !r.calls)continue;
+    scsv << r.name << r.calls << r.time;
+    for(unsigned c=0;c<HWC_COUNT;c++)scsv << (Avail[c]? r.values[c]: -1.);
+    scsv << jcsv::Endl();
+  }
+  scsv.SaveData(true);
+  if(Log)Log->AddFileInfo(file,"Saves values of performance counters per region.");
+}
+
@@ -0,0 +1,141 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Contadores de rendimiento (perf_event_open en Linux) por region medida:
+//:#   ciclos, instrucciones, accesos y fallos de LLC, instrucciones FP
+//:#   escalares y vectoriales (solo Intel) y contadores software. Los
+//:#   contadores no disponibles (p.ej. en contenedores) se ignoran. (19-10-2026)
+//:#############################################################################
+
+/// \file JHwCounters.h \brief Declares the class \ref JHwCounters.
+
+#ifndef _JHwCounters_
+#define _JHwCounters_
+
+#include "TypesDef.h"
+#include "JObject.h"
+#include <string>
+#include <vector>
+#include <chrono>
+
+class JLog2;
+
+///Performance counters.
+typedef enum{
+   HWC_Cycles=0        ///<CPU cycles.
+  ,HWC_Instructions=1  ///<Retired instructions.
+  ,HWC_LlcRefs=2       ///<Last level cache references.
+  ,HWC_LlcMisses=3     ///<Last level cache misses.
+  ,HWC_FpScalar=4      ///<Retired scalar floating-point instructions (only Intel).
+  ,HWC_FpVec128=5      ///<Retired 128-bit packed floating-point instructions (only Intel).
+  ,HWC_FpVec256=6      ///<Retired 256-bit packed floating-point instructions (only Intel).
+  ,HWC_FpVec512=7      ///<Retired 512-bit packed floating-point instructions (only Intel).
+  ,HWC_TaskClock=8     ///<CPU time of threads in nanoseconds (software counter).
+  ,HWC_PageFaults=9    ///<Page faults (software counter).
+}TpHwCounter;
+#define HWC_COUNT 10
+
+//##############################################################################
+//# JHwCounters
+//##############################################################################
+/// \brief Hardware performance counters per region using perf_event_open.
+///
+/// The counters are opened for each OpenMP thread in three groups (hardware,
+/// floating-point and software) and they are read at the start and end of
+/// each region in the main thread. The values of all threads are added and
+/// scaled when the kernel multiplexes the counters. Counters that can not be
+/// opened (e.g. without access to the PMU in containers or virtual machines)
+/// are reported as not available. Only one object can be active
+/// (JHwCounters::Active).
+
+class JHwCounters : protected JObject
+{
+public:
+  static JHwCounters *Active;      ///<Active object (NULL: counters are disabled).
+  static const unsigned CACHELINE=64;  ///<Bytes per LLC miss to estimate memory traffic.
+
+protected:
+  static const unsigned GROUPS=3;  ///<Groups of counters (hardware, floating-point, software).
+
+  ///Group of counters of one thread.
+  typedef struct{
+    int leader;                    ///<File descriptor of group leader (-1: not available).
+    std::vector<int> fds;          ///<File descriptors of counters in the group.
+    std::vector<unsigned> members; ///<Counters (TpHwCounter) in order of the group.
+  }StGroup;
+
+  ///Values of one region.
+  typedef struct{
+    const char *name;              ///<Name of region.
+    bool open;                     ///<Region is started.
+    ullong calls;                  ///<Number of calls.
+    double time;                   ///<Accumulated wall time (in seconds).
+    double tstart;                 ///<Wall time at start.
+    double vstart[HWC_COUNT];      ///<Values of counters at start.
+    double values[HWC_COUNT];      ///<Accumulated values of counters.
+  }StRegion;
+
+  JLog2 *Log;
+  const std::chrono::steady_clock::time_point TimeIni;  ///<Reference of time.
+  unsigned Threads;                ///<Number of threads with counters.
+  std::vector<StGroup> Groups;     ///<Groups of each thread [Threads*GROUPS].
+  bool Avail[HWC_COUNT];           ///<Counter is available in all threads.
+  std::string ErrorHw;             ///<Error opening hardware counters.
+  std::vector<StRegion> Regions;
+
+  static bool CpuIsIntel();
+  static int OpenCounter(unsigned type,ullong config,int groupfd,int &err);
+  void CloseAll();
+  void ReadValues(double *values)const;
+  double Now()const{ return(std::chrono::duration<double>(std::chrono::steady_clock::now()-TimeIni).count()); }
+  std::string ValueStr(const StRegion &r,unsigned c,double factor,const char *fmt)const;
+
+public:
+  JHwCounters(JLog2 *log);
+  ~JHwCounters();
+  void Reset();
+
+  bool Config(int threads);
+  void SetActive(bool active);
+  void AddRegion(unsigned id,const char *name);
+  void ResetValues();
+
+  //-Regions are started and stopped in the main thread.
+  void Start(unsigned id){ if(id<Regions.size()){ StRegion &r=Regions[id]; r.open=true; r.tstart=Now(); ReadValues(r.vstart); } }
+  void Stop(unsigned id);
+
+  bool GetAvailable(TpHwCounter c)const{ return(Avail[c]); }
+  bool GetAvailableAny()const;
+  std::string GetErrorHw()const{ return(ErrorHw); }
+  bool GetAvailableHw()const{ return(Avail[HWC_Cycles] || Avail[HWC_Instructions]); }
+  ullong GetCalls(unsigned id)const{ return(id<Regions.size()? Regions[id].calls: 0); }
+  double GetTime(unsigned id)const{ return(id<Regions.size()? Regions[id].time: 0); }
+  double GetValue(unsigned id,TpHwCounter c)const{ return(id<Regions.size() && Avail[c]? Regions[id].values[c]: 0); }
+
+  void VisuSummary(const std::string &title)const;
+  void SaveCsv(const std::string &file,bool csvsepcoma)const;
+
+  static const char* GetName(TpHwCounter c);
+};
+
+#endif
+
+
@@ -20,9 +20,10 @@
 //:# Cambios:
 //:# =========
 //:# - Clases para calcular promedios simples, moviles y ponderados. (20-02-2016)
+//:# - Nueva clase JMeanVarValue que calcula tambien la varianza. (19-10-2026)
 //:#############################################################################
 
-/// \file JMeanValues.h \brief Declares the class \ref JMeanValue and class \ref JMeanMoving.
+/// \file JMeanValues.h \brief Declares the classes \ref JMeanValue, \ref JMeanVarValue and \ref JMeanMoving.
 
 #ifndef _JMeanValues_
 #define _JMeanValues_
@@ -59,6 +60,40 @@ public:
 };
 
 
+//##############################################################################
+//# JMeanVarValue
+//##############################################################################
+/// \brief Calculates the average value and the variance of a sequence of values.
+/// The variance is updated with the algorithm of Welford to avoid cancellation.
+
+class JMeanVarValue
+{
+public:
+  double Max;
+  double Min;
+  double Mean;
+  double M2;     ///<Sum of squares of differences from the current mean.
+  ullong Values;
+
+public:
+  JMeanVarValue():Max(-DBL_MAX),Min(DBL_MAX),Mean(0),M2(0),Values(0){ }
+  void Reset(){ Max=-DBL_MAX; Min=DBL_MAX; Mean=0; M2=0; Values=0; }
+  void AddValue(double v){ 
+    Max=(Max<v? v: Max);
+    Min=(Min>v? v: Min);
+    Values++;
+    const double dv=v-Mean;
+    Mean+=dv/Values;
+    M2+=dv*(v-Mean);
+  }
+  double GetMax()const{ return(Max); }
+  double GetMin()const{ return(Min); }
+  double GetMean()const{ return(Mean); }
+  double GetVariance()const{ return(Values? M2/Values: 0); }
+  ullong GetValues()const{ return(Values); }
+};
+
+
 //##############################################################################
 //# JMeanMoving
 //##############################################################################
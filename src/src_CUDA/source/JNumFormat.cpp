@@ -0,0 +1,655 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JNumFormat.cpp \brief Implements the class \ref JNumFormat.
+
+#include "JNumFormat.h"
+#include "Functions.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+using namespace std;
+
+//##############################################################################
+//# Grisu algorithm (Florian Loitsch, "Printing floating-point numbers quickly
+//# and accurately with integers", PLDI 2010). Digit generation uses the
+//# Grisu3 variant that rejects the results that can not be guaranteed.
+//##############################################################################
+namespace{
+
+///Floating point number with 64-bit significand (f*2^e).
+typedef struct{
+  ullong f;
+  int e;
+}StDiyFp;
+
+///Cached power of ten (f*2^e = 10^k, rounded).
+typedef struct{
+  ullong f;
+  short e;
+  short k;
+}StCachedPower;
+
+static const StCachedPower CachedPowers[87]={
+  {0xFA8FD5A0081C0288ULL,-1220,-348},{0xBAAEE17FA23EBF76ULL,-1193,-340},{0x8B16FB203055AC76ULL,-1166,-332},
+  {0xCF42894A5DCE35EAULL,-1140,-324},{0x9A6BB0AA55653B2DULL,-1113,-316},{0xE61ACF033D1A45DFULL,-1087,-308},
+  {0xAB70FE17C79AC6CAULL,-1060,-300},{0xFF77B1FCBEBCDC4FULL,-1034,-292},{0xBE5691EF416BD60CULL,-1007,-284},
+  {0x8DD01FAD907FFC3CULL, -980,-276},{0xD3515C2831559A83ULL, -954,-268},{0x9D71AC8FADA6C9B5ULL, -927,-260},
+  {0xEA9C227723EE8BCBULL, -901,-252},{0xAECC49914078536DULL, -874,-244},{0x823C12795DB6CE57ULL, -847,-236},
+  {0xC21094364DFB5637ULL, -821,-228},{0x9096EA6F3848984FULL, -794,-220},{0xD77485CB25823AC7ULL, -768,-212},
+  {0xA086CFCD97BF97F4ULL, -741,-204},{0xEF340A98172AACE5ULL, -715,-196},{0xB23867FB2A35B28EULL, -688,-188},
+  {0x84C8D4DFD2C63F3BULL, -661,-180},{0xC5DD44271AD3CDBAULL, -635,-172},{0x936B9FCEBB25C996ULL, -608,-164},
+  {0xDBAC6C247D62A584ULL, -582,-156},{0xA3AB66580D5FDAF6ULL, -555,-148},{0xF3E2F893DEC3F126ULL, -529,-140},
+  {0xB5B5ADA8AAFF80B8ULL, -502,-132},{0x87625F056C7C4A8BULL, -475,-124},{0xC9BCFF6034C13053ULL, -449,-116},
+  {0x964E858C91BA2655ULL, -422,-108},{0xDFF9772470297EBDULL, -396,-100},{0xA6DFBD9FB8E5B88FULL, -369, -92},
+  {0xF8A95FCF88747D94ULL, -343, -84},{0xB94470938FA89BCFULL, -316, -76},{0x8A08F0F8BF0F156BULL, -289, -68},
+  {0xCDB02555653131B6ULL, -263, -60},{0x993FE2C6D07B7FACULL, -236, -52},{0xE45C10C42A2B3B06ULL, -210, -44},
+  {0xAA242499697392D3ULL, -183, -36},{0xFD87B5F28300CA0EULL, -157, -28},{0xBCE5086492111AEBULL, -130, -20},
+  {0x8CBCCC096F5088CCULL, -103, -12},{0xD1B71758E219652CULL,  -77,  -4},{0x9C40000000000000ULL,  -50,   4},
+  {0xE8D4A51000000000ULL,  -24,  12},{0xAD78EBC5AC620000ULL,    3,  20},{0x813F3978F8940984ULL,   30,  28},
+  {0xC097CE7BC90715B3ULL,   56,  36},{0x8F7E32CE7BEA5C70ULL,   83,  44},{0xD5D238A4ABE98068ULL,  109,  52},
+  {0x9F4F2726179A2245ULL,  136,  60},{0xED63A231D4C4FB27ULL,  162,  68},{0xB0DE65388CC8ADA8ULL,  189,  76},
+  {0x83C7088E1AAB65DBULL,  216,  84},{0xC45D1DF942711D9AULL,  242,  92},{0x924D692CA61BE758ULL,  269, 100},
+  {0xDA01EE641A708DEAULL,  295, 108},{0xA26DA3999AEF774AULL,  322, 116},{0xF209787BB47D6B85ULL,  348, 124},
+  {0xB454E4A179DD1877ULL,  375, 132},{0x865B86925B9BC5C2ULL,  402, 140},{0xC83553C5C8965D3DULL,  428, 148},
+  {0x952AB45CFA97A0B3ULL,  455, 156},{0xDE469FBD99A05FE3ULL,  481, 164},{0xA59BC234DB398C25ULL,  508, 172},
+  {0xF6C69A72A3989F5CULL,  534, 180},{0xB7DCBF5354E9BECEULL,  561, 188},{0x88FCF317F22241E2ULL,  588, 196},
+  {0xCC20CE9BD35C78A5ULL,  614, 204},{0x98165AF37B2153DFULL,  641, 212},{0xE2A0B5DC971F303AULL,  667, 220},
+  {0xA8D9D1535CE3B396ULL,  694, 228},{0xFB9B7CD9A4A7443CULL,  720, 236},{0xBB764C4CA7A44410ULL,  747, 244},
+  {0x8BAB8EEFB6409C1AULL,  774, 252},{0xD01FEF10A657842CULL,  800, 260},{0x9B10A4E5E9913129ULL,  827, 268},
+  {0xE7109BFBA19C0C9DULL,  853, 276},{0xAC2820D9623BF429ULL,  880, 284},{0x80444B5E7AA7CF85ULL,  907, 292},
+  {0xBF21E44003ACDD2DULL,  933, 300},{0x8E679C2F5E44FF8FULL,  960, 308},{0xD433179D9C8CB841ULL,  986, 316},
+  {0x9E19DB92B4E31BA9ULL, 1013, 324},{0xEB96BF6EBADF77D9ULL, 1039, 332},{0xAF87023B9BF0EE6BULL, 1066, 340}
+};
+static const int CACHEDOFFSET=348;  ///<Minus the first decimal exponent of CachedPowers.
+static const int CACHEDSTEP=8;      ///<Distance between decimal exponents of CachedPowers.
+static const int MINTARGETEXP=-60;  ///<Minimum binary exponent of scaled values.
+static const int MAXDIGITS=30;      ///<Maximum number of generated digits.
+
+//==============================================================================
+/// Returns DiyFp value.
+//==============================================================================
+inline StDiyFp DiyFp(ullong f,int e){
+  StDiyFp r={f,e};
+  return(r);
+}
+
+//==============================================================================
+/// Returns normalized DiyFp value (highest bit of significand is 1).
+//==============================================================================
+inline StDiyFp DiyNormalize(StDiyFp v){
+  while(!(v.f&0xFFC0000000000000ULL)){ v.f<<=10; v.e-=10; }
+  while(!(v.f&0x8000000000000000ULL)){ v.f<<=1; v.e--; }
+  return(v);
+}
+
+//==============================================================================
+/// Returns x*y with the 64 highest bits rounded.
+//==============================================================================
+inline StDiyFp DiyMultiply(const StDiyFp &x,const StDiyFp &y){
+  const ullong m32=0xFFFFFFFFULL;
+  const ullong a=x.f>>32,b=x.f&m32;
+  const ullong c=y.f>>32,d=y.f&m32;
+  const ullong ac=a*c,bc=b*c,ad=a*d,bd=b*d;
+  ullong tmp=(bd>>32)+(ad&m32)+(bc&m32);
+  tmp+=1U<<31;
+  return(DiyFp(ac+(ad>>32)+(bc>>32)+(tmp>>32),x.e+y.e+64));
+}
+
+//==============================================================================
+/// Returns cached power of ten so the binary exponent of the product with a
+/// normalized value of exponent e is in range [-60,-32].
+//==============================================================================
+inline void CachedPower(int e,StDiyFp &c,int &k){
+  const int minexp=MINTARGETEXP-(e+64);
+  const int dk=int(ceil((minexp+64-1)*0.30102999566398114));
+  const int idx=(CACHEDOFFSET+dk-1)/CACHEDSTEP+1;
+  c=DiyFp(CachedPowers[idx].f,CachedPowers[idx].e);
+  k=CachedPowers[idx].k;
+}
+
+//==============================================================================
+/// Returns the biggest power of ten <= v (v>0) and its number of digits.
+//==============================================================================
+inline unsigned BiggestPowerTen(unsigned v,int &ndigits){
+  unsigned p=1;
+  ndigits=1;
+  while(ndigits<10 && v>=p*10){ p*=10; ndigits++; }
+  return(p);
+}
+
+//==============================================================================
+/// Decomposes positive double value in significand and exponent.
+//==============================================================================
+inline void DecomposeDouble(double v,ullong &f,int &e,bool &lowercloser){
+  ullong bits;
+  memcpy(&bits,&v,sizeof(ullong));
+  const ullong frac=bits&0x000FFFFFFFFFFFFFULL;
+  const int bexp=int((bits>>52)&0x7FF);
+  if(bexp){ f=frac|0x0010000000000000ULL; e=bexp-1075; }
+  else{ f=frac; e=-1074; }
+  lowercloser=(frac==0 && bexp>1);
+}
+
+//==============================================================================
+/// Decomposes positive float value in significand and exponent.
+//==============================================================================
+inline void DecomposeFloat(float v,ullong &f,int &e,bool &lowercloser){
+  unsigned bits;
+  memcpy(&bits,&v,sizeof(unsigned));
+  const unsigned frac=bits&0x007FFFFF;
+  const int bexp=int((bits>>23)&0xFF);
+  if(bexp){ f=frac|0x00800000; e=bexp-150; }
+  else{ f=frac; e=-149; }
+  lowercloser=(frac==0 && bexp>1);
+}
+
+//==============================================================================
+/// Adjusts last digit of shortest representation and checks that it is safe.
+//==============================================================================
+bool RoundWeed(char *buffer,int length,ullong distance_too_high_w,ullong unsafe_interval
+  ,ullong rest,ullong ten_kappa,ullong unit)
+{
+  const ullong small_distance=distance_too_high_w-unit;
+  const ullong big_distance=distance_too_high_w+unit;
+  while(rest<small_distance && unsafe_interval-rest>=ten_kappa
+    && (rest+ten_kappa<small_distance || small_distance-rest>=rest+ten_kappa-small_distance))
+  {
+    buffer[length-1]--;
+    rest+=ten_kappa;
+  }
+  if(rest<big_distance && unsafe_interval-rest>=ten_kappa
+    && (rest+ten_kappa<big_distance || big_distance-rest>rest+ten_kappa-big_distance))return(false);
+  return(2*unit<=rest && rest<=unsafe_interval-4*unit);
+}
+
+//==============================================================================
+/// Generates the shortest digits in interval (low,high) of scaled value w.
+//==============================================================================
+bool DigitGen(const StDiyFp &low,const StDiyFp &w,const StDiyFp &high
+  ,char *buffer,int &length,int &kappa)
+{
+  ullong unit=1;
+  const StDiyFp too_low=DiyFp(low.f-unit,low.e);
+  const StDiyFp too_high=DiyFp(high.f+unit,high.e);
+  ullong unsafe_interval=too_high.f-too_low.f;
+  const int shift=-w.e;
+  const ullong one=ullong(1)<<shift;
+  unsigned integrals=unsigned(too_high.f>>shift);
+  ullong fractionals=too_high.f&(one-1);
+  unsigned divisor=BiggestPowerTen(integrals,kappa);
+  length=0;
+  while(kappa>0){
+    buffer[length++]=char('0'+integrals/divisor);
+    integrals%=divisor;
+    kappa--;
+    const ullong rest=(ullong(integrals)<<shift)+fractionals;
+    if(rest<unsafe_interval)return(RoundWeed(buffer,length,too_high.f-w.f,unsafe_interval,rest,ullong(divisor)<<shift,unit));
+    divisor/=10;
+  }
+  while(length<MAXDIGITS){
+    fractionals*=10; unit*=10; unsafe_interval*=10;
+    buffer[length++]=char('0'+unsigned(fractionals>>shift));
+    fractionals&=one-1;
+    kappa--;
+    if(fractionals<unsafe_interval)return(RoundWeed(buffer,length,(too_high.f-w.f)*unit,unsafe_interval,fractionals,one,unit));
+  }
+  return(false);
+}
+
+//==============================================================================
+/// Rounds the last digit of counted representation and checks that it is safe.
+//==============================================================================
+bool RoundWeedCounted(char *buffer,int length,ullong rest,ullong ten_kappa,ullong unit,int &kappa){
+  if(unit>=ten_kappa || ten_kappa-unit<=unit)return(false);
+  if(ten_kappa-rest>rest && ten_kappa-2*rest>=2*unit)return(true);
+  if(rest>unit && ten_kappa-(rest-unit)<=(rest-unit)){
+    buffer[length-1]++;
+    for(int c=length-1;c>0;c--){
+      if(buffer[c]!='0'+10)break;
+      buffer[c]='0'; buffer[c-1]++;
+    }
+    if(buffer[0]=='0'+10){ buffer[0]='1'; kappa++; }
+    return(true);
+  }
+  return(false);
+}
+
+//==============================================================================
+/// Generates the requested number of digits of scaled value w.
+//==============================================================================
+bool DigitGenCounted(const StDiyFp &w,int requested,char *buffer,int &length,int &kappa){
+  ullong w_error=1;
+  const int shift=-w.e;
+  const ullong one=ullong(1)<<shift;
+  unsigned integrals=unsigned(w.f>>shift);
+  ullong fractionals=w.f&(one-1);
+  unsigned divisor=BiggestPowerTen(integrals,kappa);
+  length=0;
+  while(kappa>0){
+    buffer[length++]=char('0'+integrals/divisor);
+    requested--;
+    integrals%=divisor;
+    kappa--;
+    if(requested==0)break;
+    divisor/=10;
+  }
+  if(requested==0){
+    const ullong rest=(ullong(integrals)<<shift)+fractionals;
+    return(RoundWeedCounted(buffer,length,rest,ullong(divisor)<<shift,w_error,kappa));
+  }
+  while(requested>0 && fractionals>w_error){
+    fractionals*=10; w_error*=10;
+    buffer[length++]=char('0'+unsigned(fractionals>>shift));
+    requested--;
+    fractionals&=one-1;
+    kappa--;
+  }
+  if(requested!=0)return(false);
+  return(RoundWeedCounted(buffer,length,fractionals,one,w_error,kappa));
+}
+
+//==============================================================================
+/// Shortest digits of positive value f*2^e (value=0.digits*10^k).
+/// Returns the number of digits or 0 when Grisu fails.
+//==============================================================================
+unsigned GrisuShortest(ullong f,int e,bool lowercloser,char *digits,int &k){
+  const StDiyFp w=DiyNormalize(DiyFp(f,e));
+  const StDiyFp mp=DiyNormalize(DiyFp((f<<1)+1,e-1));
+  StDiyFp mm=(lowercloser? DiyFp((f<<2)-1,e-2): DiyFp((f<<1)-1,e-1));
+  mm.f<<=(mm.e-mp.e); mm.e=mp.e;
+  StDiyFp cp; int mk;
+  CachedPower(w.e,cp,mk);
+  int length=0,kappa=0;
+  if(!DigitGen(DiyMultiply(mm,cp),DiyMultiply(w,cp),DiyMultiply(mp,cp),digits,length,kappa))return(0);
+  digits[length]='\0';
+  k=length-mk+kappa;
+  return(unsigned(length));
+}
+
+//==============================================================================
+/// Shortest digits of positive value using snprintf() and strtod().
+//==============================================================================
+unsigned PrintfShortest(double v,bool isfloat,char *digits,int &k){
+  char tx[64];
+  for(int p=1;p<=17;p++){
+    snprintf(tx,sizeof(tx),"%.*e",p-1,v);
+    if(isfloat? strtof(tx,NULL)==float(v): strtod(tx,NULL)==v)break;
+  }
+  unsigned nd=0;
+  const char *c=tx;
+  for(;*c && *c!='e';c++)if(*c>='0' && *c<='9')digits[nd++]=*c;
+  while(nd>1 && digits[nd-1]=='0')nd--;
+  digits[nd]='\0';
+  k=(*c=='e'? atoi(c+1)+1: 1);
+  return(nd);
+}
+
+//==============================================================================
+/// Writes digits in exponential notation.
+//==============================================================================
+int WriteSci(char *s,const char *dig,unsigned nd,unsigned ndec,int x,char ech,bool point){
+  int n=0;
+  s[n++]=dig[0];
+  if(ndec || point)s[n++]='.';
+  for(unsigned c=1;c<=ndec;c++)s[n++]=(c<nd? dig[c]: '0');
+  s[n++]=ech;
+  if(x<0){ s[n++]='-'; x=-x; }
+  else s[n++]='+';
+  if(x>=100){ s[n++]=char('0'+x/100); x%=100; }
+  s[n++]=char('0'+x/10);
+  s[n++]=char('0'+x%10);
+  return(n);
+}
+
+//==============================================================================
+/// Writes digits in fixed notation (value=0.dig*10^k) with ndec decimals.
+//==============================================================================
+int WriteFix(char *s,const char *dig,unsigned nd,int k,unsigned ndec,bool point){
+  int n=0;
+  if(k<=0)s[n++]='0';
+  else for(int c=0;c<k;c++)s[n++]=(unsigned(c)<nd? dig[c]: '0');
+  if(ndec || point)s[n++]='.';
+  for(unsigned c=0;c<ndec;c++){
+    const int i=k+int(c);
+    s[n++]=(i>=0 && unsigned(i)<nd? dig[i]: '0');
+  }
+  return(n);
+}
+
+}
+
+//##############################################################################
+//# JNumFormat
+//##############################################################################
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JNumFormat::JNumFormat(const std::string &fmt){
+  SetFormat(fmt);
+}
+
+//==============================================================================
+/// Changes the format.
+//==============================================================================
+void JNumFormat::SetFormat(const std::string &fmt){
+  Format=fmt;
+  Fast=ParseFormat();
+}
+
+//==============================================================================
+/// Parses the format and returns false when it is not supported by fast
+/// conversion (flags or types not implemented, width>128 or precision>64).
+//==============================================================================
+bool JNumFormat::ParseFormat(){
+  Convs.clear();
+  Suffix="";
+  bool ok=true;
+  string lit;
+  const char *f=Format.c_str();
+  const unsigned size=unsigned(Format.size());
+  unsigned c=0;
+  while(c<size){
+    if(f[c]!='%'){ lit.push_back(f[c]); c++; continue; }
+    if(f[c+1]=='%'){ lit.push_back('%'); c+=2; continue; }
+    const unsigned cini=c; c++;
+    StConv cv;
+    cv.prefix=lit; lit="";
+    cv.conv=CONV_Int;
+    cv.upper=cv.left=cv.zero=cv.alt=cv.ll=false;
+    cv.sign=0; cv.width=0; cv.prec=-1;
+    //-Flags.
+    for(bool flag=true;flag && c<size;){
+      switch(f[c]){
+        case '-':  cv.left=true;  c++;  break;
+        case '0':  cv.zero=true;  c++;  break;
+        case '+':  cv.sign='+';   c++;  break;
+        case ' ':  if(!cv.sign)cv.sign=' ';  c++;  break;
+        case '#':  cv.alt=true;   c++;  break;
+        default:   flag=false;
+      }
+    }
+    if(cv.left)cv.zero=false;
+    //-Width and precision.
+    for(;c<size && f[c]>='0' && f[c]<='9';c++)if(cv.width<=128)cv.width=cv.width*10+(f[c]-'0');
+    if(cv.width>128)ok=false;
+    if(c<size && f[c]=='.'){
+      c++; cv.prec=0;
+      for(;c<size && f[c]>='0' && f[c]<='9';c++)if(cv.prec<=64)cv.prec=cv.prec*10+(f[c]-'0');
+      if(cv.prec>64)ok=false;
+    }
+    //-Length modifiers.
+    unsigned nl=0;
+    for(;c<size && strchr("lhLqjzt",f[c]);c++){
+      if(f[c]=='l')nl++;
+      else ok=false;
+    }
+    if(c>=size){ ok=false; break; }
+    //-Type of conversion.
+    const char t=f[c]; c++;
+    switch(t){
+      case 'd': case 'i':  cv.conv=CONV_Int;    break;
+      case 'u':            cv.conv=CONV_Uint;   break;
+      case 'e': case 'E':  cv.conv=CONV_Exp;    break;
+      case 'f': case 'F':  cv.conv=CONV_Fix;    break;
+      case 'g': case 'G':  cv.conv=CONV_Gen;    break;
+      case 'r': case 'R':  cv.conv=CONV_Short;  break;
+      default:             ok=false;
+    }
+    cv.upper=(t=='E' || t=='F' || t=='G' || t=='R');
+    if(cv.conv==CONV_Int || cv.conv==CONV_Uint){
+      //-Size of long is not the same in all systems and precision is not implemented for integers.
+      if(nl==1 || nl>2 || cv.prec>=0)ok=false;
+      cv.ll=(nl==2);
+    }
+    else if(nl>1)ok=false;
+    cv.fmt=Format.substr(cini,c-cini);
+    //-Non finite values of %r are written using %g.
+    if(cv.conv==CONV_Short)cv.fmt[cv.fmt.size()-1]=(cv.upper? 'G': 'g');
+    Convs.push_back(cv);
+  }
+  Suffix=lit;
+  return(ok);
+}
+
+//==============================================================================
+/// Writes text with sign and padding according to the flags of conversion.
+//==============================================================================
+int JNumFormat::WritePadded(char *out,const StConv &c,bool neg,const char *body,int nbody){
+  const char sg=(neg? '-': c.sign);
+  const int len=nbody+(sg? 1: 0);
+  const int pad=(c.width>len? c.width-len: 0);
+  int n=0;
+  if(pad && !c.left && !c.zero){ memset(out,' ',pad); n+=pad; }
+  if(sg)out[n++]=sg;
+  if(pad && !c.left && c.zero){ memset(out+n,'0',pad); n+=pad; }
+  memcpy(out+n,body,nbody); n+=nbody;
+  if(pad && c.left){ memset(out+n,' ',pad); n+=pad; }
+  return(n);
+}
+
+//==============================================================================
+/// Writes integer value and returns the number of characters.
+//==============================================================================
+int JNumFormat::ConvInteger(char *out,const StConv &c,bool neg,ullong v)const{
+  char tx[24];
+  int n=24;
+  do{ tx[--n]=char('0'+v%10); v/=10; }while(v);
+  return(WritePadded(out,c,neg,tx+n,24-n));
+}
+
+//==============================================================================
+/// Writes real value and returns the number of characters or -1 when the
+/// fast conversion can not guarantee the same result as printf().
+//==============================================================================
+int JNumFormat::ConvReal(char *out,const StConv &c,double v,bool isfloat)const{
+  if(!(v-v==0))return(-1); //-Infinite or NaN.
+  const bool neg=(signbit(v)!=0);
+  const double av=fabs(v);
+  const char ech=(c.upper? 'E': 'e');
+  char dig[MAXDIGITS+2];
+  char body[256];
+  int nb=0;
+  int k=1;
+  switch(c.conv){
+    case CONV_Exp:{
+      const int p=(c.prec<0? 6: c.prec);
+      if(p+1>17)return(-1);
+      const unsigned nd=unsigned(p+1);
+      if(av==0)memset(dig,'0',nd);
+      else if(!DigitsPrecision(av,nd,dig,k))return(-1);
+      nb=WriteSci(body,dig,nd,unsigned(p),(av==0? 0: k-1),ech,c.alt);
+    }break;
+    case CONV_Fix:{
+      const int p=(c.prec<0? 6: c.prec);
+      unsigned nd=1;
+      if(av==0)dig[0]='0';
+      else{
+        int kest=int(floor(log10(av)))+1;
+        bool ok=false;
+        for(int t=0;t<3 && !ok;t++){
+          const int nreq=kest+p;
+          if(nreq<=-2){ dig[0]='0'; k=1; nd=1; ok=true; } //-Value is rounded to zero.
+          else if(nreq<=0 || nreq>17)return(-1);
+          else{
+            if(!DigitsPrecision(av,unsigned(nreq),dig,k))return(-1);
+            if(k==kest){ nd=unsigned(nreq); ok=true; }
+            else kest=k;
+          }
+        }
+        if(!ok)return(-1);
+      }
+      nb=WriteFix(body,dig,nd,k,unsigned(p),c.alt);
+    }break;
+    case CONV_Gen:{
+      const int p=(c.prec<0? 6: (c.prec? c.prec: 1));
+      if(p>17)return(-1);
+      const unsigned nd=unsigned(p);
+      if(av==0)memset(dig,'0',nd);
+      else if(!DigitsPrecision(av,nd,dig,k))return(-1);
+      const int x=(av==0? 0: k-1);
+      unsigned ndig=nd;
+      if(!c.alt)while(ndig>1 && dig[ndig-1]=='0')ndig--;
+      if(x<p && x>=-4){
+        const int kk=x+1;
+        const unsigned ndec=(c.alt? unsigned(p-1-x): (int(ndig)>kk? unsigned(int(ndig)-kk): 0));
+        nb=WriteFix(body,dig,nd,kk,ndec,c.alt);
+      }
+      else nb=WriteSci(body,dig,nd,(c.alt? nd-1: ndig-1),x,ech,c.alt);
+    }break;
+    case CONV_Short:{
+      const unsigned nd=(isfloat? DigitsShortest(float(av),dig,k): DigitsShortest(av,dig,k));
+      const int x=k-1;
+      if(x>=-5 && x<17)nb=WriteFix(body,dig,nd,k,(int(nd)>k? unsigned(int(nd)-k): 0),c.alt);
+      else nb=WriteSci(body,dig,nd,nd-1,x,ech,c.alt);
+    }break;
+    default: return(-1);
+  }
+  return(WritePadded(out,c,neg,body,nb));
+}
+
+//==============================================================================
+/// Appends one value using snprintf() with the format of the conversion.
+//==============================================================================
+template<class T> void JNumFormat::AppendConvPrintf(std::string &tx,const StConv &c,T v)const{
+  char buf[512];
+  int len=0;
+  switch(c.conv){
+    case CONV_Int:   len=(c.ll? snprintf(buf,sizeof(buf),c.fmt.c_str(),llong(v)):  snprintf(buf,sizeof(buf),c.fmt.c_str(),int(v)));       break;
+    case CONV_Uint:  len=(c.ll? snprintf(buf,sizeof(buf),c.fmt.c_str(),ullong(v)): snprintf(buf,sizeof(buf),c.fmt.c_str(),unsigned(v)));  break;
+    default:         len=snprintf(buf,sizeof(buf),c.fmt.c_str(),double(v));
+  }
+  if(len>0)tx.append(buf,(len<int(sizeof(buf))? len: int(sizeof(buf))-1));
+}
+
+//==============================================================================
+/// Appends values using the complete format with printf().
+//==============================================================================
+template<class T> void JNumFormat::AppendPrintf(std::string &tx,const T *v,unsigned n)const{
+  const char *fmt=Format.c_str();
+  switch(n){
+    case 1:  tx.append(fun::PrintStr(fmt,v[0]));                break;
+    case 2:  tx.append(fun::PrintStr(fmt,v[0],v[1]));           break;
+    case 3:  tx.append(fun::PrintStr(fmt,v[0],v[1],v[2]));      break;
+    case 4:  tx.append(fun::PrintStr(fmt,v[0],v[1],v[2],v[3])); break;
+    default: tx.append(Format);
+  }
+}
+
+//==============================================================================
+/// Appends values according to the format (one value for each conversion).
+//==============================================================================
+template<class T> void JNumFormat::AppendT(std::string &tx,const T *v,unsigned n,bool isfloat)const{
+  if(!Fast || n!=unsigned(Convs.size())){
+    AppendPrintf(tx,v,n);
+    return;
+  }
+  char buf[512];
+  for(unsigned cv=0;cv<n;cv++){
+    const StConv &c=Convs[cv];
+    if(!c.prefix.empty())tx.append(c.prefix);
+    int len=-1;
+    switch(c.conv){
+      case CONV_Int:{
+        const llong vv=(c.ll? llong(v[cv]): llong(int(v[cv])));
+        len=ConvInteger(buf,c,vv<0,(vv<0? ullong(0)-ullong(vv): ullong(vv)));
+      }break;
+      case CONV_Uint:{
+        const ullong vv=(c.ll? ullong(v[cv]): ullong(unsigned(v[cv])));
+        len=ConvInteger(buf,c,false,vv);
+      }break;
+      default: len=ConvReal(buf,c,double(v[cv]),isfloat);
+    }
+    if(len>=0)tx.append(buf,len);
+    else AppendConvPrintf(tx,c,v[cv]);
+  }
+  if(!Suffix.empty())tx.append(Suffix);
+}
+
+//==============================================================================
+/// Appends values according to the format (one value for each conversion).
+//==============================================================================
+void JNumFormat::Append(std::string &tx,const int      *v,unsigned n)const{ AppendT(tx,v,n,false); }
+void JNumFormat::Append(std::string &tx,const unsigned *v,unsigned n)const{ AppendT(tx,v,n,false); }
+void JNumFormat::Append(std::string &tx,const llong    *v,unsigned n)const{ AppendT(tx,v,n,false); }
+void JNumFormat::Append(std::string &tx,const ullong   *v,unsigned n)const{ AppendT(tx,v,n,false); }
+void JNumFormat::Append(std::string &tx,const float    *v,unsigned n)const{ AppendT(tx,v,n,true);  }
+void JNumFormat::Append(std::string &tx,const double   *v,unsigned n)const{ AppendT(tx,v,n,false); }
+
+//==============================================================================
+/// Returns the shortest digits that recover the finite double value
+/// (|v|=0.digits*10^k). The buffer digits must have 32 characters.
+//==============================================================================
+unsigned JNumFormat::DigitsShortest(double v,char *digits,int &k){
+  v=fabs(v);
+  if(v==0){ digits[0]='0'; digits[1]='\0'; k=1; return(1); }
+  ullong f; int e; bool lowercloser;
+  DecomposeDouble(v,f,e,lowercloser);
+  const unsigned nd=GrisuShortest(f,e,lowercloser,digits,k);
+  return(nd? nd: PrintfShortest(v,false,digits,k));
+}
+
+//==============================================================================
+/// Returns the shortest digits that recover the finite float value
+/// (|v|=0.digits*10^k). The buffer digits must have 32 characters.
+//==============================================================================
+unsigned JNumFormat::DigitsShortest(float v,char *digits,int &k){
+  v=fabs(v);
+  if(v==0){ digits[0]='0'; digits[1]='\0'; k=1; return(1); }
+  ullong f; int e; bool lowercloser;
+  DecomposeFloat(v,f,e,lowercloser);
+  const unsigned nd=GrisuShortest(f,e,lowercloser,digits,k);
+  return(nd? nd: PrintfShortest(double(v),true,digits,k));
+}
+
+//==============================================================================
+/// Computes ndigits (1-17) correctly rounded digits of positive finite value
+/// (v=0.digits*10^k). Returns false when the result can not be guaranteed.
+//==============================================================================
+bool JNumFormat::DigitsPrecision(double v,unsigned ndigits,char *digits,int &k){
+  if(!(v>0) || !ndigits || ndigits>17)return(false);
+  ullong f; int e; bool lowercloser;
+  DecomposeDouble(v,f,e,lowercloser);
+  const StDiyFp w=DiyNormalize(DiyFp(f,e));
+  StDiyFp cp; int mk;
+  CachedPower(w.e,cp,mk);
+  int length=0,kappa=0;
+  if(!DigitGenCounted(DiyMultiply(w,cp),int(ndigits),digits,length,kappa))return(false);
+  digits[length]='\0';
+  k=length-mk+kappa;
+  return(true);
+}
+
+//==============================================================================
+/// Returns the shortest text that recovers the double value.
+//==============================================================================
+std::string JNumFormat::ShortestStr(double v){
+  static const JNumFormat fmt("%r");
+  return(fmt.ToStr(v));
+}
+
+//==============================================================================
+/// Returns the shortest text that recovers the float value.
+//==============================================================================
+std::string JNumFormat::ShortestStr(float v){
+  static const JNumFormat fmt("%r");
+  return(fmt.ToStr(v));
+}
+
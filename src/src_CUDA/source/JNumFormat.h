@@ -0,0 +1,120 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Clase para convertir valores numericos a texto sin usar printf(). Los
+//:#   formatos habituales (%d, %u, %lld, %llu, %e, %E, %f, %g, %G) generan el
+//:#   mismo texto que printf() y el formato %r genera el texto mas corto que
+//:#   recupera el mismo valor float o double (Grisu). (19-10-2026)
+//:#############################################################################
+
+/// \file JNumFormat.h \brief Declares the class \ref JNumFormat.
+
+#ifndef _JNumFormat_
+#define _JNumFormat_
+
+#include "TypesDef.h"
+#include <string>
+#include <vector>
+
+//##############################################################################
+//# JNumFormat
+//##############################################################################
+/// \brief Converts numeric values to text using a printf() format without printf().
+///
+/// The format is parsed once and the digits are generated with the Grisu
+/// algorithm (Florian Loitsch, 2010) using 64-bit integer arithmetic. The fast
+/// conversion only accepts the results that are guaranteed to be correctly
+/// rounded, otherwise snprintf() is used for that value, so the output of the
+/// usual formats is the same as printf(). Unsupported formats always use
+/// snprintf(). The conversion %r (not available in printf) writes the shortest
+/// text that recovers exactly the same float or double value.
+/// Methods are const and they can be used by several threads at the same time.
+
+class JNumFormat
+{
+protected:
+  ///Types of conversion.
+  typedef enum{
+    CONV_Int=1,     ///<Signed integer (%d, %i).
+    CONV_Uint=2,    ///<Unsigned integer (%u).
+    CONV_Exp=3,     ///<Exponential notation (%e, %E).
+    CONV_Fix=4,     ///<Fixed notation (%f, %F).
+    CONV_Gen=5,     ///<General notation (%g, %G).
+    CONV_Short=6    ///<Shortest text to recover the value (%r).
+  }TpConv;
+
+  ///Conversion of one value.
+  typedef struct{
+    std::string prefix; ///<Literal text before the conversion.
+    TpConv conv;        ///<Type of conversion.
+    bool upper;         ///<Uppercase letters (E,G).
+    bool left;          ///<Left alignment (flag '-').
+    bool zero;          ///<Fills with zeros (flag '0').
+    bool alt;           ///<Alternative form (flag '#').
+    char sign;          ///<Sign of positive values (flags '+' or ' ', 0:none).
+    bool ll;            ///<Length modifier ll for integers.
+    int width;          ///<Minimum width (0:none).
+    int prec;           ///<Precision (-1:default).
+    std::string fmt;    ///<printf() format of the conversion (used when fast conversion fails).
+  }StConv;
+
+  std::string Format;          ///<Original format.
+  bool Fast;                   ///<Format is supported by fast conversion.
+  std::vector<StConv> Convs;   ///<Conversions of format.
+  std::string Suffix;          ///<Literal text after last conversion.
+
+  bool ParseFormat();
+  int ConvReal(char *out,const StConv &c,double v,bool isfloat)const;
+  int ConvInteger(char *out,const StConv &c,bool neg,ullong v)const;
+  static int WritePadded(char *out,const StConv &c,bool neg,const char *body,int nbody);
+  template<class T> void AppendT(std::string &tx,const T *v,unsigned n,bool isfloat)const;
+  template<class T> void AppendPrintf(std::string &tx,const T *v,unsigned n)const;
+  template<class T> void AppendConvPrintf(std::string &tx,const StConv &c,T v)const;
+
+public:
+  JNumFormat(const std::string &fmt="");
+  ~JNumFormat(){}
+  void SetFormat(const std::string &fmt);
+
+  const std::string& GetFormat()const{ return(Format); }
+  bool GetFast()const{ return(Fast); }
+  unsigned GetCount()const{ return(unsigned(Convs.size())); }
+
+  void Append(std::string &tx,const int      *v,unsigned n)const;
+  void Append(std::string &tx,const unsigned *v,unsigned n)const;
+  void Append(std::string &tx,const llong    *v,unsigned n)const;
+  void Append(std::string &tx,const ullong   *v,unsigned n)const;
+  void Append(std::string &tx,const float    *v,unsigned n)const;
+  void Append(std::string &tx,const double   *v,unsigned n)const;
+
+  template<class T> std::string ToStr(T v)const{ std::string tx; Append(tx,&v,1); return(tx); }
+
+  static unsigned DigitsShortest(double v,char *digits,int &k);
+  static unsigned DigitsShortest(float v,char *digits,int &k);
+  static bool DigitsPrecision(double v,unsigned ndigits,char *digits,int &k);
+
+  static std::string ShortestStr(double v);
+  static std::string ShortestStr(float v);
+};
+
+#endif
+
+
@@ -21,11 +21,13 @@
 #include "JOutputCsv.h"
 #include "JDataArrays.h"
 #include "Functions.h"
+#include "OmpDefs.h"
 #include <iostream>
 #include <sstream>
 #include <fstream>
 #include <cstdlib>
 #include <cmath>
+#include <algorithm>
 
 using namespace std;
 
@@ -57,8 +59,38 @@ void JOutputCsv::Reset(){
   FileName="";
 }
 
+//==============================================================================
+/// Appends the text of rows [rini,rend) of arrays to tx.
+//==============================================================================
+void JOutputCsv::FormatRows(const JDataArrays &arrays,const std::vector<JNumFormat> &outfmt
+  ,char csvsep,unsigned rini,unsigned rend,std::string &tx)const
+{
+  const unsigned nf=unsigned(outfmt.size());
+  for(unsigned cv=rini;cv<rend;cv++){
+    for(unsigned cf=0;cf<nf;cf++){
+      const JDataArrays::StDataArray& ar=arrays.GetArrayCte(cf);
+      const JNumFormat &fmt=outfmt[cf];
+      switch(ar.type){
+        case TypeUchar:  { const unsigned v=((const byte*)ar.ptr)[cv];  fmt.Append(tx,&v,1); }break;
+        case TypeUshort: { const unsigned v=((const word*)ar.ptr)[cv];  fmt.Append(tx,&v,1); }break;
+        case TypeUint:     fmt.Append(tx,((const unsigned*)ar.ptr)+cv,1);      break;
+        case TypeFloat:    fmt.Append(tx,((const float   *)ar.ptr)+cv,1);      break;
+        case TypeDouble:   fmt.Append(tx,((const double  *)ar.ptr)+cv,1);      break;
+        case TypeUint3:    fmt.Append(tx,&(((const tuint3  *)ar.ptr)[cv].x),3); break;
+        case TypeFloat3:   fmt.Append(tx,&(((const tfloat3 *)ar.ptr)[cv].x),3); break;
+        case TypeDouble3:  fmt.Append(tx,&(((const tdouble3*)ar.ptr)[cv].x),3); break;
+        default: break;
+      }
+      tx.push_back(csvsep);
+    }
+    tx.push_back('\n');
+  }
+}
+
 //==============================================================================
 /// Stores data in CSV format.
+/// The rows are formatted in parallel by chunks of ROWSCHUNK rows and each
+/// block of chunks is written with one large write.
 //==============================================================================
 void JOutputCsv::SaveCsv(std::string fname,const JDataArrays &arrays,std::string head){
   if(fun::GetExtension(fname).empty())FileName=fname=fun::AddExtension(fname,".csv");
@@ -71,48 +103,53 @@ void JOutputCsv::SaveCsv(std::string fname,const JDataArrays &arrays,std::string
   pf.open(fname.c_str());
   if(pf){
     //-Saves lines of head.
-    while(!head.empty())pf << fun::StrSplit("\n",head) << endl;
+    string tx;
+    while(!head.empty())tx=tx+fun::StrSplit("\n",head)+"\n";
     //-Saves head.
     for(unsigned cf=0;cf<nf;cf++){
       const string keyname=arrays.GetArrayCte(cf).keyname;
       const string units=arrays.GetArrayUnits(cf);
       const int dim=arrays.GetArrayDim(cf);
-      if(dim==1)pf << keyname << units << csvsep;
-      else if(dim==3)for(unsigned c=0;c<3;c++)pf << keyname << (c? (c==2? ".z": ".y"): ".x") << units << csvsep;
+      if(dim==1)tx=tx+keyname+units+csvsep;
+      else if(dim==3)for(unsigned c=0;c<3;c++)tx=tx+keyname+(c? (c==2? ".z": ".y"): ".x")+units+csvsep;
       else Run_ExceptioonFile(fun::PrintStr("Dimension %d of array \'%s\' is invalid.",dim,keyname.c_str()),fname);
     }
-    pf << endl;
+    tx=tx+"\n";
+    pf.write(tx.c_str(),tx.size());
     //-Creates vector with output format of arrays.
-    std::vector<std::string> outfmt;
+    std::vector<JNumFormat> outfmt;
     for(unsigned cf=0;cf<nf;cf++){
+      const JDataArrays::StDataArray& ar=arrays.GetArrayCte(cf);
       string fmt=arrays.GetArrayFmt(cf);
       const int dim=arrays.GetArrayDim(cf);
       if(dim==3)fmt=fmt+csvsep+fmt+csvsep+fmt;
-      else if(dim!=1)Run_ExceptioonFile(fun::PrintStr("Dimension %d of array \'%s\' is invalid.",dim,arrays.GetArrayCte(cf).keyname.c_str()),fname);
-      outfmt.push_back(fmt);
+      else if(dim!=1)Run_ExceptioonFile(fun::PrintStr("Dimension %d of array \'%s\' is invalid.",dim,ar.keyname.c_str()),fname);
+      switch(ar.type){
+        case TypeUchar:  case TypeUshort:  case TypeUint:  case TypeFloat:  case TypeDouble:
+        case TypeUint3:  case TypeFloat3:  case TypeDouble3:  break;
+        default: Run_ExceptioonFile(fun::PrintStr("Type of array \'%s\' is invalid.",TypeToStr(ar.type)),fname);
+      }
+      outfmt.push_back(JNumFormat(fmt));
     }
     //-Saves data.
-    for(unsigned cv=0;cv<nv;cv++){
-      for(unsigned cf=0;cf<nf;cf++){
-        const JDataArrays::StDataArray& ar=arrays.GetArrayCte(cf);
-        if(1){
-          string fmt=outfmt[cf];
-          string values;
-          switch(ar.type){
-            case TypeUchar:  { const byte     *v=(byte    *)ar.ptr;  values=fun::PrintStr(fmt.c_str(),v[cv])+csvsep; }break;
-            case TypeUshort: { const word     *v=(word    *)ar.ptr;  values=fun::PrintStr(fmt.c_str(),v[cv])+csvsep; }break;
-            case TypeUint:   { const unsigned *v=(unsigned*)ar.ptr;  values=fun::PrintStr(fmt.c_str(),v[cv])+csvsep; }break;
-            case TypeFloat:  { const float    *v=(float   *)ar.ptr;  values=fun::PrintStr(fmt.c_str(),v[cv])+csvsep; }break;
-            case TypeDouble: { const double   *v=(double  *)ar.ptr;  values=fun::PrintStr(fmt.c_str(),v[cv])+csvsep; }break;
-            case TypeUint3:  { const tuint3   *v=(tuint3  *)ar.ptr;  values=fun::PrintStr(fmt.c_str(),v[cv].x,v[cv].y,v[cv].z)+csvsep; }break;
-            case TypeFloat3: { const tfloat3  *v=(tfloat3 *)ar.ptr;  values=fun::PrintStr(fmt.c_str(),v[cv].x,v[cv].y,v[cv].z)+csvsep; }break;
-            case TypeDouble3:{ const tdouble3 *v=(tdouble3*)ar.ptr;  values=fun::PrintStr(fmt.c_str(),v[cv].x,v[cv].y,v[cv].z)+csvsep; }break;
-            default: Run_ExceptioonFile(fun::PrintStr("Type of array \'%s\' is invalid.",TypeToStr(ar.type)),fname);
-          }
-          pf << values;
-        }
+    const unsigned nrchunk=ROWSCHUNK;
+    const unsigned nchunks=unsigned(omp_get_max_threads())*4;
+    std::vector<std::string> txs(nchunks);
+    for(unsigned rblock=0;rblock<nv;rblock+=nrchunk*nchunks){
+      const unsigned nrows=min(nv-rblock,nrchunk*nchunks);
+      const int nc=int((nrows+nrchunk-1)/nrchunk);
+      #ifdef OMP_USE
+        #pragma omp parallel for schedule (dynamic) if(nc>1)
+      #endif
+      for(int cc=0;cc<nc;cc++){
+        const unsigned rini=rblock+unsigned(cc)*nrchunk;
+        const unsigned rend=min(rini+nrchunk,rblock+nrows);
+        txs[cc].clear();
+        FormatRows(arrays,outfmt,csvsep,rini,rend,txs[cc]);
       }
-      pf << endl;
+      tx.clear();
+      for(int cc=0;cc<nc;cc++)tx.append(txs[cc]);
+      pf.write(tx.c_str(),tx.size());
     }
     if(pf.fail())Run_ExceptioonFile("File writing failure.",fname);
     pf.close();
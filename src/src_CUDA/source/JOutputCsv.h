@@ -23,6 +23,8 @@
 //:# - Codigo actualizado para trabajar con ultima version de JDataArrays. (10-12-2019)
 //:# - CsvSepComa se define en el constructor y por defecto es false. (27-12-2019)
 //:# - CreatPath se define en el constructor y por defecto es true. (27-12-2019)
+//:# - SaveCsv() usa JNumFormat y da formato a los datos en paralelo por bloques
+//:#   de filas que se graban con escrituras grandes. (19-10-2026)
 //:#############################################################################
 
 /// \file JOutputCsv.h \brief Declares the class \ref JOutputCsv.
@@ -33,6 +35,7 @@
 #include "TypesDef.h"
 #include "JObject.h"
 #include "JDataArrays.h"
+#include "JNumFormat.h"
 #include <string>
 #include <cstring>
 #include <string>
@@ -51,7 +54,11 @@ public:
   bool CsvSepComa;  ///<Separator character in CSV files (0=semicolon, 1=coma).
 
 protected:
+  static const unsigned ROWSCHUNK=4096; ///<Number of rows formatted by each thread in SaveCsv().
+
   std::string FileName; ///<Last file generated.
+  void FormatRows(const JDataArrays &arrays,const std::vector<JNumFormat> &outfmt
+    ,char csvsep,unsigned rini,unsigned rend,std::string &tx)const;
   template<typename T> void CalculateStatsArray1(unsigned ndata,T *data
     ,double &valmin,double &valmax,double &valmean)const;
   template<typename T> void CalculateStatsArray3(unsigned ndata,T *data
@@ -0,0 +1,104 @@
+//HEAD_DSCODES
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Clase para grabar arrays de datos en ficheros VTK XML (.vtu) con datos
+//:#   binarios en bloque appended (raw) y compresion zlib opcional. (19-10-2026)
+//:# - Los datos se pueden dividir en piezas grabadas en paralelo con un
+//:#   fichero indice .pvtu. (19-10-2026)
+//:# - Grabacion de mallas con celdas de tipo linea o triangulo definidas por
+//:#   una lista de conectividad (SaveVtuCells()). (19-10-2026)
+//:# - Celdas de tipo cuadrilatero y fichero indice .pvd de series temporales
+//:#   (SavePvd()). (19-10-2026)
+//:#############################################################################
+
+/// \file JOutputVtu.h \brief Declares the class \ref JOutputVtu.
+
+#ifndef _JOutputVtu_
+#define _JOutputVtu_
+
+#include "TypesDef.h"
+#include "JObject.h"
+#include "JDataArrays.h"
+#include <string>
+#include <vector>
+
+//##############################################################################
+//# JOutputVtu
+//##############################################################################
+/// \brief Saves data arrays in binary VTK XML files (.vtu and .pvtu).
+
+class JOutputVtu : protected JObject
+{
+public:
+  //-Output configuration.
+  bool Compress;      ///<Compresses data blocks using zlib (false by default).
+  bool CreatPath;     ///<Creates full path for output files (true by default).
+  unsigned PieceSize; ///<Maximum number of points per piece when the number of pieces is automatic (2M by default).
+
+protected:
+  static const unsigned BLOCKSIZE=1048576; ///<Size of data blocks for compression and generated arrays (in bytes).
+
+  /// Structure with the information of one array to write in the appended data.
+  typedef struct{
+    std::string name;     ///<Name of array (empty for Points).
+    std::string vtktype;  ///<VTK type name (Float32, UInt32...).
+    unsigned ncomp;       ///<Number of components.
+    unsigned tsize;       ///<Size of one tuple (in bytes).
+    const byte *ptr;      ///<Pointer to first tuple of the piece (NULL for generated arrays).
+    int gen;              ///<Generated array (0:none, 1:connectivity, 2:offsets, 3:types).
+    unsigned cellnv;      ///<Number of vertices per cell (for generated arrays of cells).
+    ullong nbytes;        ///<Size of uncompressed data (in bytes).
+    ullong offset;        ///<Offset in appended data (in bytes).
+    std::vector<ullong> zhead;  ///<Header of compressed data [3+nblocks].
+    std::vector<byte> zdata;    ///<Compressed data.
+  }StVtuArray;
+
+  std::string FileName; ///<Last file generated.
+
+  std::string VtkTypeName(TpTypeData type,unsigned &ncomp,unsigned &tsize)const;
+  static byte VtkCellType(unsigned cellnv);
+  static void FillBlock(const StVtuArray &ar,ullong byteini,unsigned nbytes,byte *buf);
+  unsigned GetPosIdx(const JDataArrays &arrays,const std::string &posfield)const;
+  void PrepareArrays(const JDataArrays &arrays,unsigned posidx,unsigned pini,unsigned np
+    ,unsigned ncells,unsigned cellnv,const unsigned *conn,std::vector<StVtuArray> &vars)const;
+  std::string CompressArray(StVtuArray &ar)const;
+  std::string SavePiece(const std::string &fname,const JDataArrays &arrays,unsigned posidx,unsigned pini,unsigned np
+    ,unsigned ncells,unsigned cellnv,const unsigned *conn)const;
+
+public:
+  JOutputVtu(bool compress=false,bool createpath=true);
+  ~JOutputVtu();
+  void Reset();
+
+  static bool AvailableZlib();
+
+  std::string GetFileName()const{ return(FileName); }
+
+  void SaveVtu(std::string fname,const JDataArrays &arrays,std::string posfield);
+  void SavePvtu(std::string fname,const JDataArrays &arrays,std::string posfield,unsigned npieces=0);
+  void SaveVtuCells(std::string fname,const JDataArrays &arrays,std::string posfield
+    ,unsigned cellnv,unsigned ncells,const unsigned *conn);
+  void SavePvd(const std::string &fname,const std::vector<std::string> &files,const std::vector<double> &times);
+};
+
+#endif
+
+
@@ -24,6 +24,9 @@
 #include "JRadixSort.h"
 #include <climits>
 #include <cfloat>
+#include <fstream>
+#include <algorithm>
+#include <vector>
 
 using namespace std;
 
@@ -99,6 +102,49 @@ llong JPartsLoad4::GetAllocMemory()const{
   return(s);
 }
 
+//==============================================================================
+/// Reads data of array from PART file. Big arrays which are not in memory are
+/// read in chunks by several threads, each one with its own file stream.
+/// Lee datos de array del fichero PART. Los arrays grandes que no estan en
+/// memoria se leen por bloques con varios hilos, cada uno con su fichero.
+//==============================================================================
+void JPartsLoad4::ReadArray(const JPartDataBi4 &pd,const std::string &file,const std::string &name
+  ,JBinaryDataDef::TpData type,unsigned count,void *ptr)const
+{
+  const JBinaryDataArray *ar=pd.GetArray(name,type);
+  const ullong size=ullong(JBinaryDataDef::SizeOfType(type))*count;
+  if(!UseOmp || !ar->DataInFile() || size<ullong(SIZECHUNK)*2){
+    if(ar->GetDataCopy(count,ptr)!=count)Run_ExceptioonFile(string("The number of elements of array \'")+name+"\' is invalid.",file);
+  }
+  else{
+    if(ar->GetFileDataCount()!=count)Run_ExceptioonFile(string("The number of elements of array \'")+name+"\' is invalid.",file);
+    const llong filepos=ar->GetFileDataPos();
+    const int nchunks=int((size+SIZECHUNK-1)/SIZECHUNK);
+    int nerr=0;
+    #ifdef OMP_USE
+      #pragma omp parallel reduction(+:nerr)
+    #endif
+    {
+      ifstream pf;
+      pf.open(file.c_str(),ios::binary|ios::in);
+      #ifdef OMP_USE
+        #pragma omp for schedule (static)
+      #endif
+      for(int cc=0;cc<nchunks;cc++){
+        const ullong ini=ullong(SIZECHUNK)*cc;
+        const ullong n=min(ullong(SIZECHUNK),size-ini);
+        if(pf){
+          pf.seekg(std::streamoff(filepos+ini),ios::beg);
+          pf.read((char*)ptr+ini,std::streamsize(n));
+        }
+        if(!pf)nerr++;
+      }
+      if(pf.is_open())pf.close();
+    }
+    if(nerr)Run_ExceptioonFile(string("Reading of array \'")+name+"\' failed.",file);
+  }
+}
+
 //==============================================================================
 /// Sorts values according to vsort[].
 /// Ordena valores segun vsort[].
@@ -117,9 +163,19 @@ template<typename T> T* JPartsLoad4::SortParticles(const unsigned *vsort,unsigne
 void JPartsLoad4::CheckSortParticles(){
   const unsigned nbound=unsigned(CaseNfixed+CaseNmoving);
   if(nbound){
+    //-Computes position of last boundary particle (partial results of each thread).
+    const int n=int(Count);
+    const int nth=(UseOmp? min(int(omp_get_max_threads()),OMP_MAXTHREADS): 1);
+    std::vector<unsigned> lastth(nth*OMP_STRIDE,0);
+    #ifdef OMP_USE
+      #pragma omp parallel for schedule (static) num_threads(nth) if(UseOmp && n>OMP_LIMIT_COMPUTELIGHT)
+    #endif
+    for(int p=0;p<n;p++)if(Idp[p]<nbound){
+      unsigned &last=lastth[omp_get_thread_num()*OMP_STRIDE];
+      if(unsigned(p)>last)last=unsigned(p);
+    }
     unsigned lastbound=0;
-    //-Computes position of last boundary particle.
-    for(unsigned p=0;p<Count;p++)if(Idp[p]<nbound && p>lastbound)lastbound=p;
+    for(int th=0;th<nth;th++)lastbound=max(lastbound,lastth[th*OMP_STRIDE]);
     if(lastbound+1!=nbound)Run_Exceptioon("Order of boundary (fixed and moving) particles is invalid.");
   }
 }
@@ -130,9 +186,13 @@ void JPartsLoad4::CheckSortParticles(){
 //==============================================================================
 void JPartsLoad4::SortParticles(){
   //-Checks order. | Comprueba orden.
-  bool sorted=true;
-  for(unsigned p=1;p<Count && sorted;p++)sorted=(Idp[p-1]<Idp[p]);
-  if(!sorted){
+  int nunsorted=0;
+  const int n=int(Count);
+  #ifdef OMP_USE
+    #pragma omp parallel for schedule (static) reduction(+:nunsorted) if(UseOmp && n>OMP_LIMIT_COMPUTELIGHT)
+  #endif
+  for(int p=1;p<n;p++)if(Idp[p-1]>=Idp[p])nunsorted++;
+  if(nunsorted){
     //-Sorts points according to id. | Ordena puntos segun id.
     JRadixSort rs(UseOmp);
     rs.Sort(true,Count,Idp);
@@ -200,7 +260,7 @@ void JPartsLoad4::LoadParticles(const std::string &casedir,const std::string &ca
     JPartDataBi4 pd2;
     if(!PartBegin)pd2.LoadFileCase(dir,casename,piece,Npiece);
     else pd2.LoadFilePart(dir,PartBegin,piece,Npiece);
-    sizetot+=pd.Get_Npok();
+    sizetot+=pd2.Get_Npok();
   }
   //-Allocates memory.
   AllocMemory(sizetot);
@@ -215,6 +275,7 @@ void JPartsLoad4::LoadParticles(const std::string &casedir,const std::string &ca
         if(!PartBegin)pd.LoadFileCase(dir,casename,piece,Npiece);
         else pd.LoadFilePart(dir,PartBegin,piece,Npiece);
       }
+      const string file=dir+(!PartBegin? JPartDataBi4::GetFileNameCase(casename,piece,Npiece): JPartDataBi4::GetFileNamePart(PartBegin,piece,Npiece));
       const unsigned npok=pd.Get_Npok();
       if(npok){
         if(auxsize<npok){
@@ -224,15 +285,24 @@ void JPartsLoad4::LoadParticles(const std::string &casedir,const std::string &ca
           auxf3=new tfloat3[auxsize];
           auxf=new float[auxsize];
         }
+        const int n=int(npok);
         if(possingle){
-          pd.Get_Pos(npok,auxf3);
-          for(unsigned p=0;p<npok;p++)Pos[ntot+p]=ToTDouble3(auxf3[p]);
+          ReadArray(pd,file,"Pos",JBinaryDataDef::DatFloat3,npok,auxf3);
+          tdouble3 *pos=Pos+ntot;
+          #ifdef OMP_USE
+            #pragma omp parallel for schedule (static) if(UseOmp && n>OMP_LIMIT_COMPUTELIGHT)
+          #endif
+          for(int p=0;p<n;p++)pos[p]=ToTDouble3(auxf3[p]);
         }
-        else pd.Get_Posd(npok,Pos+ntot);
-        pd.Get_Idp(npok,Idp+ntot);  
-        pd.Get_Vel(npok,auxf3);  
-        pd.Get_Rhop(npok,auxf);  
-        for(unsigned p=0;p<npok;p++)VelRhop[ntot+p]=TFloat4(auxf3[p].x,auxf3[p].y,auxf3[p].z,auxf[p]);
+        else ReadArray(pd,file,"Posd",JBinaryDataDef::DatDouble3,npok,Pos+ntot);
+        ReadArray(pd,file,"Idp" ,JBinaryDataDef::DatUint  ,npok,Idp+ntot);
+        ReadArray(pd,file,"Vel" ,JBinaryDataDef::DatFloat3,npok,auxf3);
+        ReadArray(pd,file,"Rhop",JBinaryDataDef::DatFloat ,npok,auxf);
+        tfloat4 *velrhop=VelRhop+ntot;
+        #ifdef OMP_USE
+          #pragma omp parallel for schedule (static) if(UseOmp && n>OMP_LIMIT_COMPUTELIGHT)
+        #endif
+        for(int p=0;p<n;p++)velrhop[p]=TFloat4(auxf3[p].x,auxf3[p].y,auxf3[p].z,auxf[p]);
       }
       ntot+=npok;
     }
@@ -314,11 +384,20 @@ void JPartsLoad4::GetMapSize(tdouble3 &mapmin,tdouble3 &mapmax)const{
 //==============================================================================
 void JPartsLoad4::CalculateCasePos(){
   if(!PartBegin)Run_Exceptioon("The limits of the initial case cannot be calculated from a file PART.");
-  tdouble3 pmin=TDouble3(DBL_MAX),pmax=TDouble3(-DBL_MAX);
-  //-Calculates minimum and maximum position. 
-  //-Calcula posicion minima y maxima. 
-  for(unsigned p=0;p<Count;p++){
+  //-Calculates minimum and maximum position (partial results of each thread). 
+  //-Calcula posicion minima y maxima (resultados parciales de cada hilo). 
+  const int n=int(Count);
+  const int nth=(UseOmp? min(int(omp_get_max_threads()),OMP_MAXTHREADS): 1);
+  std::vector<tdouble3> minth(nth*OMP_STRIDE,TDouble3(DBL_MAX));
+  std::vector<tdouble3> maxth(nth*OMP_STRIDE,TDouble3(-DBL_MAX));
+  #ifdef OMP_USE
+    #pragma omp parallel for schedule (static) num_threads(nth) if(UseOmp && n>OMP_LIMIT_COMPUTELIGHT)
+  #endif
+  for(int p=0;p<n;p++){
+    const int th=omp_get_thread_num()*OMP_STRIDE;
     const tdouble3 ps=Pos[p];
+    tdouble3 &pmin=minth[th];
+    tdouble3 &pmax=maxth[th];
     if(pmin.x>ps.x)pmin.x=ps.x;
     if(pmin.y>ps.y)pmin.y=ps.y;
     if(pmin.z>ps.z)pmin.z=ps.z;
@@ -326,6 +405,11 @@ void JPartsLoad4::CalculateCasePos(){
     if(pmax.y<ps.y)pmax.y=ps.y;
     if(pmax.z<ps.z)pmax.z=ps.z;
   }
+  tdouble3 pmin=minth[0],pmax=maxth[0];
+  for(int th=1;th<nth;th++){
+    pmin=MinValues(pmin,minth[th*OMP_STRIDE]);
+    pmax=MaxValues(pmax,maxth[th*OMP_STRIDE]);
+  }
   CasePosMin=pmin; CasePosMax=pmax;
 }
 
@@ -34,6 +34,9 @@
 //:# - No reordena paraticulas para reducir diferencias usando restart. (23-04-2018)
 //:# - Improved definition of the periodic conditions. (27-04-2018)
 //:# - Mejora la gestion de excepciones. (06-05-2020)
+//:# - Carga paralela: los arrays se leen por bloques con varios hilos, la
+//:#   conversion de datos, el calculo de limites y las comprobaciones de orden
+//:#   usan OpenMP. Corrige el numero de particulas con varias piezas. (19-10-2026)
 //:#############################################################################
 
 /// \file JPartsLoad4.h \brief Declares the class \ref JPartsLoad4.
@@ -44,8 +47,12 @@
 #include "TypesDef.h"
 #include "JPeriodicDef.h"
 #include "JObject.h"
+#include "JBinaryData.h"
+#include "OmpDefs.h"
 #include <cstring>
 
+class JPartDataBi4;
+
 //##############################################################################
 //# JPartsLoad4
 //##############################################################################
@@ -54,6 +61,8 @@
 class JPartsLoad4 : protected JObject
 {
 protected:
+  static const unsigned SIZECHUNK=16777216; ///<Size of chunks for parallel reading of arrays (16 MB).
+
   const bool UseOmp;
 
   unsigned Npiece;
@@ -92,6 +101,8 @@ protected:
   tfloat4 *VelRhop;
 
   void AllocMemory(unsigned count);
+  void ReadArray(const JPartDataBi4 &pd,const std::string &file,const std::string &name
+    ,JBinaryDataDef::TpData type,unsigned count,void *ptr)const;
   template<typename T> T* SortParticles(const unsigned *vsort,unsigned count,T *v)const;
   void CheckSortParticles();
   void SortParticles();
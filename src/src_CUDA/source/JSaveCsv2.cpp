@@ -173,6 +173,27 @@ std::string JSaveCsv2::ToStr(const char *format,...)const{
   return(ret);
 }
 
+//==============================================================================
+/// Returns values converted with the current format using JNumFormat.
+//==============================================================================
+template<class T> std::string JSaveCsv2::NumStrT(TpFormat tfmt,const T *v,unsigned n){
+  JNumFormat &nfmt=NumFmt[tfmt];
+  if(nfmt.GetFormat()!=FmtCurrent[tfmt])nfmt.SetFormat(FmtCurrent[tfmt]);
+  std::string tx;
+  nfmt.Append(tx,v,n);
+  return(tx);
+}
+
+//==============================================================================
+/// Returns values converted with the current format (same result as ToStr()).
+//==============================================================================
+std::string JSaveCsv2::NumStr(TpFormat tfmt,const int      *v,unsigned n){ return(NumStrT(tfmt,v,n)); }
+std::string JSaveCsv2::NumStr(TpFormat tfmt,const unsigned *v,unsigned n){ return(NumStrT(tfmt,v,n)); }
+std::string JSaveCsv2::NumStr(TpFormat tfmt,const llong    *v,unsigned n){ return(NumStrT(tfmt,v,n)); }
+std::string JSaveCsv2::NumStr(TpFormat tfmt,const ullong   *v,unsigned n){ return(NumStrT(tfmt,v,n)); }
+std::string JSaveCsv2::NumStr(TpFormat tfmt,const float    *v,unsigned n){ return(NumStrT(tfmt,v,n)); }
+std::string JSaveCsv2::NumStr(TpFormat tfmt,const double   *v,unsigned n){ return(NumStrT(tfmt,v,n)); }
+
 //==============================================================================
 /// Operator: Adds one or several field separators.
 //==============================================================================
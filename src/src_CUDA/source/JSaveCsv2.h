@@ -32,6 +32,7 @@
 //:# - Nuevo metodo GetAppendMode() para saber si se va ampliar un fichero existente. (06-07-2018)
 //:# - Error corregido en SaveData() por el que siempre se grababa el head. (13-08-2018)
 //:# - Gestion de excepciones mejorada.  (15-09-2019)
+//:# - Los valores numericos se convierten con JNumFormat en lugar de printf(). (19-10-2026)
 //:#############################################################################
 
 /// \file JSaveCsv2.h \brief Declares the class \ref JSaveCsv2.
@@ -41,6 +42,7 @@
 
 #include "TypesDef.h"
 #include "JObject.h"
+#include "JNumFormat.h"
 
 #include <string>
 #include <fstream>
@@ -152,6 +154,7 @@ private:
   static const unsigned SizeFmt=18;  ///<Number of different formats.
   std::string FmtDefault[SizeFmt];   ///<Default formats.
   std::string FmtCurrent[SizeFmt];   ///<Current formats.
+  JNumFormat NumFmt[SizeFmt];        ///<Parsed current formats.
 
   bool DataSelected;
   std::string Head;
@@ -166,6 +169,7 @@ private:
   void Save(const std::string &tx);
   void SetSeparators(std::string &tx)const;
   void OpenFile();
+  template<class T> std::string NumStrT(TpFormat tfmt,const T *v,unsigned n);
   //void R unException(const std::string &method,const std::string &msg){
   //  ExceptionThrown=true; JObject::R unException(method,msg);
   //}
@@ -189,6 +193,12 @@ public:
   void SetData(){ DataSelected=true;  }
 
   std::string ToStr(const char *format,...)const;
+  std::string NumStr(TpFormat tfmt,const int      *v,unsigned n);
+  std::string NumStr(TpFormat tfmt,const unsigned *v,unsigned n);
+  std::string NumStr(TpFormat tfmt,const llong    *v,unsigned n);
+  std::string NumStr(TpFormat tfmt,const ullong   *v,unsigned n);
+  std::string NumStr(TpFormat tfmt,const float    *v,unsigned n);
+  std::string NumStr(TpFormat tfmt,const double   *v,unsigned n);
 
   JSaveCsv2& operator <<(const Sep &obj);
   JSaveCsv2& operator <<(const AutoSepOn &obj);
@@ -198,34 +208,34 @@ public:
 
   JSaveCsv2& operator <<(const std::string &v){ AddStr(v); return(*this); }
 
-  JSaveCsv2& operator <<(char     v){ AddStr(ToStr(FmtCurrent[TpSigned1  ].c_str(),v)); return(*this); }
-  JSaveCsv2& operator <<(short    v){ AddStr(ToStr(FmtCurrent[TpSigned1  ].c_str(),v)); return(*this); }
-  JSaveCsv2& operator <<(int      v){ AddStr(ToStr(FmtCurrent[TpSigned1  ].c_str(),v)); return(*this); }
-  JSaveCsv2& operator <<(byte     v){ AddStr(ToStr(FmtCurrent[TpUnsigned1].c_str(),v)); return(*this); }
-  JSaveCsv2& operator <<(word     v){ AddStr(ToStr(FmtCurrent[TpUnsigned1].c_str(),v)); return(*this); }
-  JSaveCsv2& operator <<(unsigned v){ AddStr(ToStr(FmtCurrent[TpUnsigned1].c_str(),v)); return(*this); }
+  JSaveCsv2& operator <<(char     v){ const int      vv=v; AddStr(NumStr(TpSigned1  ,&vv,1)); return(*this); }
+  JSaveCsv2& operator <<(short    v){ const int      vv=v; AddStr(NumStr(TpSigned1  ,&vv,1)); return(*this); }
+  JSaveCsv2& operator <<(int      v){                      AddStr(NumStr(TpSigned1  ,&v ,1)); return(*this); }
+  JSaveCsv2& operator <<(byte     v){ const unsigned vv=v; AddStr(NumStr(TpUnsigned1,&vv,1)); return(*this); }
+  JSaveCsv2& operator <<(word     v){ const unsigned vv=v; AddStr(NumStr(TpUnsigned1,&vv,1)); return(*this); }
+  JSaveCsv2& operator <<(unsigned v){                      AddStr(NumStr(TpUnsigned1,&v ,1)); return(*this); }
 
-  JSaveCsv2& operator <<(llong    v){ AddStr(ToStr(FmtCurrent[TpLlong1   ].c_str(),v)); return(*this); }
-  JSaveCsv2& operator <<(ullong   v){ AddStr(ToStr(FmtCurrent[TpUllong1  ].c_str(),v)); return(*this); }
+  JSaveCsv2& operator <<(llong    v){ AddStr(NumStr(TpLlong1   ,&v,1)); return(*this); }
+  JSaveCsv2& operator <<(ullong   v){ AddStr(NumStr(TpUllong1  ,&v,1)); return(*this); }
 
-  JSaveCsv2& operator <<(float    v){ AddStr(ToStr(FmtCurrent[TpFloat1   ].c_str(),v)); return(*this); }
-  JSaveCsv2& operator <<(double   v){ AddStr(ToStr(FmtCurrent[TpDouble1  ].c_str(),v)); return(*this); }
+  JSaveCsv2& operator <<(float    v){ AddStr(NumStr(TpFloat1   ,&v,1)); return(*this); }
+  JSaveCsv2& operator <<(double   v){ AddStr(NumStr(TpDouble1  ,&v,1)); return(*this); }
 
-  JSaveCsv2& operator <<(const tint2   &v){ AddStr(ToStr(FmtCurrent[TpSigned2  ].c_str(),v.x,v.y));         return(*this); }
-  JSaveCsv2& operator <<(const tint3   &v){ AddStr(ToStr(FmtCurrent[TpSigned3  ].c_str(),v.x,v.y,v.z));     return(*this); }
-  JSaveCsv2& operator <<(const tint4   &v){ AddStr(ToStr(FmtCurrent[TpSigned4  ].c_str(),v.x,v.y,v.z,v.w)); return(*this); }
+  JSaveCsv2& operator <<(const tint2   &v){ AddStr(NumStr(TpSigned2  ,&v.x,2)); return(*this); }
+  JSaveCsv2& operator <<(const tint3   &v){ AddStr(NumStr(TpSigned3  ,&v.x,3)); return(*this); }
+  JSaveCsv2& operator <<(const tint4   &v){ AddStr(NumStr(TpSigned4  ,&v.x,4)); return(*this); }
 
-  JSaveCsv2& operator <<(const tuint2  &v){ AddStr(ToStr(FmtCurrent[TpUnsigned2].c_str(),v.x,v.y));         return(*this); }
-  JSaveCsv2& operator <<(const tuint3  &v){ AddStr(ToStr(FmtCurrent[TpUnsigned3].c_str(),v.x,v.y,v.z));     return(*this); }
-  JSaveCsv2& operator <<(const tuint4  &v){ AddStr(ToStr(FmtCurrent[TpUnsigned4].c_str(),v.x,v.y,v.z,v.w)); return(*this); }
+  JSaveCsv2& operator <<(const tuint2  &v){ AddStr(NumStr(TpUnsigned2,&v.x,2)); return(*this); }
+  JSaveCsv2& operator <<(const tuint3  &v){ AddStr(NumStr(TpUnsigned3,&v.x,3)); return(*this); }
+  JSaveCsv2& operator <<(const tuint4  &v){ AddStr(NumStr(TpUnsigned4,&v.x,4)); return(*this); }
 
-  JSaveCsv2& operator <<(const tfloat2  &v){ AddStr(ToStr(FmtCurrent[TpFloat2  ].c_str(),v.x,v.y));         return(*this); }
-  JSaveCsv2& operator <<(const tfloat3  &v){ AddStr(ToStr(FmtCurrent[TpFloat3  ].c_str(),v.x,v.y,v.z));     return(*this); }
-  JSaveCsv2& operator <<(const tfloat4  &v){ AddStr(ToStr(FmtCurrent[TpFloat4  ].c_str(),v.x,v.y,v.z,v.w)); return(*this); }
+  JSaveCsv2& operator <<(const tfloat2  &v){ AddStr(NumStr(TpFloat2  ,&v.x,2)); return(*this); }
+  JSaveCsv2& operator <<(const tfloat3  &v){ AddStr(NumStr(TpFloat3  ,&v.x,3)); return(*this); }
+  JSaveCsv2& operator <<(const tfloat4  &v){ AddStr(NumStr(TpFloat4  ,&v.x,4)); return(*this); }
 
-  JSaveCsv2& operator <<(const tdouble2 &v){ AddStr(ToStr(FmtCurrent[TpDouble2 ].c_str(),v.x,v.y));         return(*this); }
-  JSaveCsv2& operator <<(const tdouble3 &v){ AddStr(ToStr(FmtCurrent[TpDouble3 ].c_str(),v.x,v.y,v.z));     return(*this); }
-  JSaveCsv2& operator <<(const tdouble4 &v){ AddStr(ToStr(FmtCurrent[TpDouble4 ].c_str(),v.x,v.y,v.z,v.w)); return(*this); }
+  JSaveCsv2& operator <<(const tdouble2 &v){ AddStr(NumStr(TpDouble2 ,&v.x,2)); return(*this); }
+  JSaveCsv2& operator <<(const tdouble3 &v){ AddStr(NumStr(TpDouble3 ,&v.x,3)); return(*this); }
+  JSaveCsv2& operator <<(const tdouble4 &v){ AddStr(NumStr(TpDouble4 ,&v.x,4)); return(*this); }
 
   void SaveData(bool closefile=false);
 };
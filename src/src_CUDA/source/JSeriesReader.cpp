@@ -0,0 +1,304 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JSeriesReader.cpp \brief Implements the class \ref JSeriesReader.
+
+#include "JSeriesReader.h"
+#include "JNumFormat.h"
+#include "Functions.h"
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+//==============================================================================
+/// Returns type of components of the data type (TypeLlong, TypeUllong,
+/// TypeFloat or TypeDouble).
+//==============================================================================
+static TpTypeData TypeOfComponent(TpTypeData type){
+  switch(type){
+    case TypeUchar:  case TypeUshort:  case TypeUint:  case TypeUllong:
+    case TypeUint2:  case TypeUint3:   case TypeUint4:                   return(TypeUllong);
+    case TypeFloat:  case TypeFloat2:  case TypeFloat3:  case TypeFloat4:
+    case TypeSyMatrix3f:                                                 return(TypeFloat);
+    case TypeDouble: case TypeDouble2: case TypeDouble3: case TypeDouble4: return(TypeDouble);
+    default:                                                             return(TypeLlong);
+  }
+}
+
+//==============================================================================
+/// Returns component of value as llong, ullong or double.
+//==============================================================================
+template<class T> static T ValueOfComponent(TpTypeData type,const byte *ptr,unsigned comp){
+  switch(type){
+    case TypeInt:     case TypeInt2:  case TypeInt3:  case TypeInt4:  { int      v; memcpy(&v,ptr+comp*sizeof(v),sizeof(v)); return(T(v)); }
+    case TypeChar:    { char           v; memcpy(&v,ptr,sizeof(v)); return(T(v)); }
+    case TypeUchar:   { unsigned char  v; memcpy(&v,ptr,sizeof(v)); return(T(v)); }
+    case TypeShort:   { short          v; memcpy(&v,ptr,sizeof(v)); return(T(v)); }
+    case TypeUshort:  { unsigned short v; memcpy(&v,ptr,sizeof(v)); return(T(v)); }
+    case TypeUint:    case TypeUint2:   case TypeUint3:   case TypeUint4:   { unsigned v; memcpy(&v,ptr+comp*sizeof(v),sizeof(v)); return(T(v)); }
+    case TypeLlong:   { llong          v; memcpy(&v,ptr,sizeof(v)); return(T(v)); }
+    case TypeUllong:  { ullong         v; memcpy(&v,ptr,sizeof(v)); return(T(v)); }
+    case TypeFloat:   case TypeFloat2:  case TypeFloat3:  case TypeFloat4:  case TypeSyMatrix3f:  { float  v; memcpy(&v,ptr+comp*sizeof(v),sizeof(v)); return(T(v)); }
+    case TypeDouble:  case TypeDouble2: case TypeDouble3: case TypeDouble4: { double v; memcpy(&v,ptr+comp*sizeof(v),sizeof(v)); return(T(v)); }
+    default: return(T(0));
+  }
+}
+
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JSeriesReader::JSeriesReader(){
+  ClassName="JSeriesReader";
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JSeriesReader::~JSeriesReader(){
+  DestructorActive=true;
+  Reset();
+}
+
+//==============================================================================
+/// Initialization of variables.
+//==============================================================================
+void JSeriesReader::Reset(){
+  FileName="";
+  Cols.clear();
+  Chunks.clear();
+  RecSize=0;
+  Count=0;
+  Truncated=false;
+}
+
+//==============================================================================
+/// Loads header of file and positions of chunks.
+//==============================================================================
+void JSeriesReader::LoadFile(const std::string &file){
+  Reset();
+  ifstream pf;
+  pf.open(file.c_str(),ios::binary);
+  if(!pf)Run_ExceptioonFile("Cannot open the file.",file);
+  pf.seekg(0,ios::end);
+  const ullong fsize=ullong(pf.tellg());
+  pf.seekg(0,ios::beg);
+  //-Loads header.
+  char magic[8];
+  unsigned head[2];
+  pf.read(magic,sizeof(magic));
+  pf.read((char*)head,sizeof(head));
+  if(pf.fail() || strncmp(magic,"JSERIES",8))Run_ExceptioonFile("The file is not a valid time series file.",file);
+  if(head[0]!=1)Run_ExceptioonFile(fun::PrintStr("Version %u of time series file is not supported.",head[0]),file);
+  const unsigned ncols=head[1];
+  for(unsigned c=0;c<ncols;c++){
+    unsigned v[2];
+    pf.read((char*)v,sizeof(v));
+    if(pf.fail() || v[1]>fsize)Run_ExceptioonFile("Error reading the definition of columns.",file);
+    StColumn col;
+    col.type=TpTypeData(v[0]);
+    col.name.resize(v[1]);
+    if(v[1])pf.read(&col.name[0],v[1]);
+    col.size=SizeOfType(col.type);
+    col.offset=RecSize;
+    if(pf.fail() || !col.size)Run_ExceptioonFile("Error reading the definition of columns.",file);
+    RecSize+=col.size;
+    Cols.push_back(col);
+  }
+  //-Loads positions of chunks.
+  ullong pos=ullong(pf.tellg());
+  while(pos+8<=fsize){
+    unsigned ck[2];
+    pf.seekg(pos,ios::beg);
+    pf.read((char*)ck,sizeof(ck));
+    if(pf.fail() || ck[0]!=0x4B4E4843)Run_ExceptioonFile(fun::PrintStr("Invalid chunk at position %llu.",pos),file);
+    const ullong size=ullong(ck[1])*RecSize;
+    if(pos+8+size>fsize)break;
+    StChunk chk={pos+8,ck[1],Count};
+    Chunks.push_back(chk);
+    Count+=ck[1];
+    pos+=8+size;
+  }
+  Truncated=(pos!=fsize);
+  pf.close();
+  FileName=file;
+}
+
+//==============================================================================
+/// Returns the definition of one column.
+//==============================================================================
+const JSeriesReader::StColumn& JSeriesReader::GetColumn(unsigned col)const{
+  if(col>=GetColumns())Run_ExceptioonFile(fun::PrintStr("Column %u is not available.",col),FileName);
+  return(Cols[col]);
+}
+
+//==============================================================================
+/// Returns index of column with the given name (or name of one of its
+/// components). Returns -1 when it does not exist.
+//==============================================================================
+int JSeriesReader::GetColumnIdx(const std::string &name)const{
+  for(unsigned c=0;c<GetColumns();c++){
+    if(Cols[c].name==name)return(int(c));
+    string tx=Cols[c].name;
+    while(!tx.empty())if(fun::StrSplit(";",tx)==name)return(int(c));
+  }
+  return(-1);
+}
+
+//==============================================================================
+/// Returns the number of records of one chunk.
+//==============================================================================
+unsigned JSeriesReader::GetChunkRecords(unsigned ck)const{
+  if(ck>=GetChunks())Run_ExceptioonFile(fun::PrintStr("Chunk %u is not available.",ck),FileName);
+  return(Chunks[ck].nrec);
+}
+
+//==============================================================================
+/// Reads data from file.
+//==============================================================================
+void JSeriesReader::ReadData(ullong pos,size_t size,void *data)const{
+  ifstream pf;
+  pf.open(FileName.c_str(),ios::binary);
+  if(!pf)Run_ExceptioonFile("Cannot open the file.",FileName);
+  pf.seekg(pos,ios::beg);
+  pf.read((char*)data,size);
+  if(pf.fail())Run_ExceptioonFile("File reading failure.",FileName);
+  pf.close();
+}
+
+//==============================================================================
+/// Reads the values of one column in one chunk. The size of data must be
+/// GetChunkRecords(ck)*GetColumn(col).size bytes.
+//==============================================================================
+void JSeriesReader::ReadChunk(unsigned ck,unsigned col,void *data)const{
+  const StColumn &cl=GetColumn(col);
+  const unsigned nrec=GetChunkRecords(ck);
+  if(nrec)ReadData(Chunks[ck].pos+cl.offset*nrec,size_t(nrec)*cl.size,data);
+}
+
+//==============================================================================
+/// Reads all the values of one chunk (values of each column are contiguous).
+//==============================================================================
+void JSeriesReader::ReadChunk(unsigned ck,std::vector<byte> &data)const{
+  const unsigned nrec=GetChunkRecords(ck);
+  data.resize(size_t(nrec)*RecSize);
+  if(nrec)ReadData(Chunks[ck].pos,data.size(),data.data());
+}
+
+//==============================================================================
+/// Returns one component of the values of one column for all the records.
+//==============================================================================
+void JSeriesReader::GetValues(unsigned col,unsigned comp,std::vector<double> &values)const{
+  const StColumn &cl=GetColumn(col);
+  if(comp>=unsigned(DimOfType(cl.type)))Run_ExceptioonFile(fun::PrintStr("Component %u of column \'%s\' is not available.",comp,cl.name.c_str()),FileName);
+  values.resize(size_t(Count));
+  vector<byte> data;
+  for(unsigned ck=0;ck<GetChunks();ck++){
+    const unsigned nrec=Chunks[ck].nrec;
+    data.resize(size_t(nrec)*cl.size);
+    ReadChunk(ck,col,data.data());
+    double *vs=values.data()+Chunks[ck].rini;
+    for(unsigned r=0;r<nrec;r++)vs[r]=ValueOfComponent<double>(cl.type,data.data()+size_t(r)*cl.size,comp);
+  }
+}
+
+//==============================================================================
+/// Saves all the records in CSV format. Floating point values are written
+/// with the shortest text that recovers the same value.
+//==============================================================================
+void JSeriesReader::SaveCsv(const std::string &filecsv,bool csvsepcoma)const{
+  const char sep=(csvsepcoma? ',': ';');
+  const char sep0=(csvsepcoma? ';': ',');
+  const unsigned ncols=GetColumns();
+  FILE *pf=fopen(filecsv.c_str(),"wb");
+  if(!pf)Run_ExceptioonFile("Cannot open the file.",filecsv);
+  //-Saves head.
+  string tx;
+  for(unsigned c=0;c<ncols;c++){
+    string name=Cols[c].name;
+    for(unsigned cc=0;cc<unsigned(name.size());cc++)if(name[cc]==sep0 || name[cc]==';')name[cc]=sep;
+    tx=tx+(c? string(1,sep): string(""))+name;
+  }
+  tx=tx+"\n";
+  //-Output formats.
+  vector<JNumFormat> fmts;
+  for(unsigned c=0;c<ncols;c++){
+    const TpTypeData tcomp=TypeOfComponent(Cols[c].type);
+    const string fmt1=(tcomp==TypeLlong? "%lld": (tcomp==TypeUllong? "%llu": "%r"));
+    string fmt=fmt1;
+    for(int cd=1;cd<DimOfType(Cols[c].type);cd++)fmt=fmt+sep+fmt1;
+    fmts.push_back(JNumFormat(fmt));
+  }
+  //-Saves data of each chunk.
+  vector<byte> data;
+  for(unsigned ck=0;ck<=GetChunks();ck++){
+    if(ck<GetChunks()){
+      const unsigned nrec=Chunks[ck].nrec;
+      ReadChunk(ck,data);
+      for(unsigned r=0;r<nrec;r++){
+        for(unsigned c=0;c<ncols;c++){
+          const StColumn &cl=Cols[c];
+          const byte *ptr=data.data()+cl.offset*nrec+size_t(r)*cl.size;
+          const unsigned dim=unsigned(DimOfType(cl.type));
+          if(c)tx.push_back(sep);
+          switch(TypeOfComponent(cl.type)){
+            case TypeLlong:{
+              llong v[6];
+              for(unsigned cd=0;cd<dim;cd++)v[cd]=ValueOfComponent<llong>(cl.type,ptr,cd);
+              fmts[c].Append(tx,v,dim);
+            }break;
+            case TypeUllong:{
+              ullong v[6];
+              for(unsigned cd=0;cd<dim;cd++)v[cd]=ValueOfComponent<ullong>(cl.type,ptr,cd);
+              fmts[c].Append(tx,v,dim);
+            }break;
+            case TypeFloat:{
+              float v[6];
+              memcpy(v,ptr,cl.size);
+              fmts[c].Append(tx,v,dim);
+            }break;
+            default:{
+              double v[6];
+              memcpy(v,ptr,cl.size);
+              fmts[c].Append(tx,v,dim);
+            }
+          }
+        }
+        tx.push_back('\n');
+      }
+    }
+    if(!tx.empty() && fwrite(tx.data(),1,tx.size(),pf)!=tx.size()){
+      fclose(pf);
+      Run_ExceptioonFile("File writing failure.",filecsv);
+    }
+    tx.clear();
+  }
+  fclose(pf);
+}
+
+//==============================================================================
+/// Converts binary time series file to CSV format.
+//==============================================================================
+void JSeriesReader::ConvertToCsv(const std::string &file,const std::string &filecsv,bool csvsepcoma){
+  JSeriesReader rd;
+  rd.LoadFile(file);
+  rd.SaveCsv(filecsv,csvsepcoma);
+}
+
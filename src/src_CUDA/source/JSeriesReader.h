@@ -0,0 +1,99 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Clase para leer ficheros binarios de series temporales (.tsb) creados por
+//:#   JSeriesSink y convertirlos a CSV. (19-10-2026)
+//:#############################################################################
+
+/// \file JSeriesReader.h \brief Declares the class \ref JSeriesReader.
+
+#ifndef _JSeriesReader_
+#define _JSeriesReader_
+
+#include "TypesDef.h"
+#include "JObject.h"
+#include <string>
+#include <vector>
+
+//##############################################################################
+//# JSeriesReader
+//##############################################################################
+/// \brief Reads binary time series files (.tsb) created by \ref JSeriesSink.
+///
+/// LoadFile() only reads the header and the position of the chunks, the
+/// values are read from the file on demand. An incomplete last chunk (file
+/// of an interrupted execution) is ignored.
+
+class JSeriesReader : protected JObject
+{
+public:
+  /// Definition of one column.
+  typedef struct{
+    TpTypeData type;    ///<Type of data.
+    std::string name;   ///<Name of column (names of components separated by ';').
+    unsigned size;      ///<Size of one value (in bytes).
+    ullong offset;      ///<Offset of values of the column in the chunk data (in bytes per record).
+  }StColumn;
+
+protected:
+  /// Position of one chunk.
+  typedef struct{
+    ullong pos;         ///<Position of data in file.
+    unsigned nrec;      ///<Number of records.
+    ullong rini;        ///<Index of first record.
+  }StChunk;
+
+  std::string FileName;
+  std::vector<StColumn> Cols;
+  std::vector<StChunk> Chunks;
+  unsigned RecSize;     ///<Size of one record (in bytes).
+  ullong Count;         ///<Number of records.
+  bool Truncated;       ///<The last chunk was incomplete.
+
+  void ReadData(ullong pos,size_t size,void *data)const;
+
+public:
+  JSeriesReader();
+  ~JSeriesReader();
+  void Reset();
+
+  void LoadFile(const std::string &file);
+
+  std::string GetFileName()const{ return(FileName); }
+  unsigned GetColumns()const{ return(unsigned(Cols.size())); }
+  const StColumn& GetColumn(unsigned col)const;
+  int GetColumnIdx(const std::string &name)const;
+  ullong GetCount()const{ return(Count); }
+  unsigned GetChunks()const{ return(unsigned(Chunks.size())); }
+  unsigned GetChunkRecords(unsigned ck)const;
+  bool GetTruncated()const{ return(Truncated); }
+
+  void ReadChunk(unsigned ck,unsigned col,void *data)const;
+  void ReadChunk(unsigned ck,std::vector<byte> &data)const;
+  void GetValues(unsigned col,unsigned comp,std::vector<double> &values)const;
+
+  void SaveCsv(const std::string &filecsv,bool csvsepcoma)const;
+  static void ConvertToCsv(const std::string &file,const std::string &filecsv,bool csvsepcoma);
+};
+
+#endif
+
+
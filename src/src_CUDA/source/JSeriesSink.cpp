@@ -0,0 +1,537 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JSeriesSink.cpp \brief Implements the classes \ref JSeriesRec and \ref JSeriesSink.
+
+#include "JSeriesSink.h"
+#include "Functions.h"
+#include "JLog2.h"
+
+#include <cstring>
+#include <chrono>
+#include <climits>
+#include <algorithm>
+
+using namespace std;
+
+//##############################################################################
+//# JSeriesRec
+//##############################################################################
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JSeriesRec::JSeriesRec(JSeriesSink *sink,unsigned id):Sink(sink),Id(id){
+  ClassName="JSeriesRec";
+  InitFmt();
+  Defined=false;
+  Col=0;
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JSeriesRec::~JSeriesRec(){
+  DestructorActive=true;
+}
+
+//==============================================================================
+/// Initialization of output formats (the same as JSaveCsv2).
+//==============================================================================
+void JSeriesRec::InitFmt(){
+  FmtCurrent[jcsv::TpSigned1]  =FmtDefault[jcsv::TpSigned1]  ="%d";
+  FmtCurrent[jcsv::TpSigned2]  =FmtDefault[jcsv::TpSigned2]  ="%d;%d";
+  FmtCurrent[jcsv::TpSigned3]  =FmtDefault[jcsv::TpSigned3]  ="%d;%d;%d";
+  FmtCurrent[jcsv::TpSigned4]  =FmtDefault[jcsv::TpSigned4]  ="%d;%d;%d;%d";
+  FmtCurrent[jcsv::TpUnsigned1]=FmtDefault[jcsv::TpUnsigned1]="%u";
+  FmtCurrent[jcsv::TpUnsigned2]=FmtDefault[jcsv::TpUnsigned2]="%u;%u";
+  FmtCurrent[jcsv::TpUnsigned3]=FmtDefault[jcsv::TpUnsigned3]="%u;%u;%u";
+  FmtCurrent[jcsv::TpUnsigned4]=FmtDefault[jcsv::TpUnsigned4]="%u;%u;%u;%u";
+  FmtCurrent[jcsv::TpLlong1]   =FmtDefault[jcsv::TpLlong1 ]  ="%lld";
+  FmtCurrent[jcsv::TpUllong1]  =FmtDefault[jcsv::TpUllong1]  ="%llu";
+  FmtCurrent[jcsv::TpFloat1]   =FmtDefault[jcsv::TpFloat1]   ="%f";
+  FmtCurrent[jcsv::TpFloat2]   =FmtDefault[jcsv::TpFloat2]   ="%f;%f";
+  FmtCurrent[jcsv::TpFloat3]   =FmtDefault[jcsv::TpFloat3]   ="%f;%f;%f";
+  FmtCurrent[jcsv::TpFloat4]   =FmtDefault[jcsv::TpFloat4]   ="%f;%f;%f;%f";
+  FmtCurrent[jcsv::TpDouble1]  =FmtDefault[jcsv::TpDouble1]  ="%f";
+  FmtCurrent[jcsv::TpDouble2]  =FmtDefault[jcsv::TpDouble2]  ="%f;%f";
+  FmtCurrent[jcsv::TpDouble3]  =FmtDefault[jcsv::TpDouble3]  ="%f;%f;%f";
+  FmtCurrent[jcsv::TpDouble4]  =FmtDefault[jcsv::TpDouble4]  ="%f;%f;%f;%f";
+}
+
+//==============================================================================
+/// Adds value to current record. The first record defines the columns.
+//==============================================================================
+void JSeriesRec::AddValue(TpTypeData type,jcsv::TpFormat tfmt,const void *v){
+  const unsigned size=SizeOfType(type);
+  if(!Defined){
+    StSeriesCol col={type,FmtCurrent[tfmt],unsigned(Data.size())};
+    Cols.push_back(col);
+  }
+  else if(Col>=unsigned(Cols.size()) || Cols[Col].type!=type){
+    Run_Exceptioon(fun::PrintStr("The value %u (%s) does not match the columns defined by the first record.",Col,TypeToStr(type)));
+  }
+  const byte *pv=(const byte*)v;
+  Data.insert(Data.end(),pv,pv+size);
+  Col++;
+}
+
+//==============================================================================
+/// Operator: Sets format for output (only used by the first record).
+//==============================================================================
+JSeriesRec& JSeriesRec::operator <<(const jcsv::Fmt &obj){
+  FmtCurrent[obj.TypeFmt]=(obj.Format.empty()? FmtDefault[obj.TypeFmt]: obj.Format);
+  return(*this);
+}
+
+//==============================================================================
+/// Operator: Ends current record and stores it in the stream.
+//==============================================================================
+JSeriesRec& JSeriesRec::operator <<(const jcsv::Endl &obj){
+  if(!Defined){
+    if(Cols.empty())Run_Exceptioon("The first record has no values.");
+    Sink->DefineColumns(Id,Cols,unsigned(Data.size()));
+    Defined=true;
+  }
+  else if(Col!=unsigned(Cols.size())){
+    Run_Exceptioon(fun::PrintStr("The record has %u values but %u were defined by the first record.",Col,unsigned(Cols.size())));
+  }
+  Sink->PushRecord(Id,Data.data());
+  Data.clear();
+  Col=0;
+  return(*this);
+}
+
+
+//##############################################################################
+//# JSeriesSink
+//##############################################################################
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JSeriesSink::JSeriesSink(bool svcsv,bool svbin,bool csvsepcoma,JLog2 *log)
+  :Log(log),SvCsv(svcsv),SvBin(svbin),CsvSepComa(csvsepcoma)
+{
+  ClassName="JSeriesSink";
+  Worker=NULL;
+  WorkRequested=Stop=false;
+}
+
+//==============================================================================
+/// Destructor. Pending records are written without throwing exceptions.
+//==============================================================================
+JSeriesSink::~JSeriesSink(){
+  DestructorActive=true;
+  StopWorker();
+  for(unsigned id=0;id<unsigned(Streams.size());id++){
+    StStream *st=Streams[id];
+    if(st){
+      if(st->pfcsv)fclose(st->pfcsv);
+      if(st->pfbin)fclose(st->pfbin);
+      delete st;
+    }
+    delete Recs[id];
+  }
+  Streams.clear();
+  Recs.clear();
+}
+
+//==============================================================================
+/// Returns name of binary file of time series.
+//==============================================================================
+std::string JSeriesSink::GetFileBin(const std::string &file){
+  return(fun::GetWithoutExtension(file)+".tsb");
+}
+
+//==============================================================================
+/// Starts the secondary thread when it is not running.
+//==============================================================================
+void JSeriesSink::StartWorker(){
+  if(!Worker){
+    Stop=false;
+    Worker=new std::thread(WorkerRun,this);
+  }
+}
+
+//==============================================================================
+/// Writes all pending records, closes files and finishes the secondary thread.
+//==============================================================================
+void JSeriesSink::StopWorker(){
+  if(Worker){
+    {
+      std::lock_guard<std::mutex> lock(Mtx);
+      Stop=true;
+    }
+    CvWork.notify_one();
+    Worker->join();
+    delete Worker; Worker=NULL;
+    Stop=false;
+  }
+}
+
+//==============================================================================
+/// Throws exception with the last error of the secondary thread.
+//==============================================================================
+void JSeriesSink::CheckError(){
+  string errtext,errfile;
+  {
+    std::lock_guard<std::mutex> lock(Mtx);
+    errtext=ErrText; ErrText="";
+    errfile=ErrFile; ErrFile="";
+  }
+  if(!errtext.empty())Run_ExceptioonFile(errtext,errfile);
+}
+
+//==============================================================================
+/// Entry point of secondary thread.
+//==============================================================================
+void JSeriesSink::WorkerRun(JSeriesSink *sink){
+  sink->WorkerLoop();
+}
+
+//==============================================================================
+/// Main loop of secondary thread. Streams are processed when their ring
+/// buffer is half full, when flush or close is requested, after WRITEMS
+/// without requests and when the thread has to finish.
+//==============================================================================
+void JSeriesSink::WorkerLoop(){
+  std::unique_lock<std::mutex> lock(Mtx);
+  bool run=true;
+  while(run){
+    bool timeout=false;
+    if(!WorkRequested && !Stop){
+      timeout=(CvWork.wait_for(lock,std::chrono::milliseconds(WRITEMS))==std::cv_status::timeout);
+    }
+    WorkRequested=false;
+    const bool stop=Stop;
+    for(unsigned id=0;id<unsigned(Streams.size());id++){
+      const StStream *st=Streams[id];
+      if(st){
+        const ullong pending=st->pushed-st->written;
+        if(stop || st->flush || st->close || (pending && (timeout || pending>=st->capacity/2))){
+          ProcessStream(id,lock,stop);
+        }
+      }
+    }
+    CvDone.notify_all();
+    if(stop)run=false;
+  }
+}
+
+//==============================================================================
+/// Formats and writes pending records of one stream. The mutex is released
+/// during the file operations, the main thread does not modify the records
+/// between written and pushed. The columns are only used when they were
+/// already defined before releasing the mutex.
+//==============================================================================
+void JSeriesSink::ProcessStream(unsigned id,std::unique_lock<std::mutex> &lock,bool stop){
+  StStream *st=Streams[id];
+  const bool defined=(st->recsize!=0);
+  const ullong rini=st->written;
+  const ullong rend=st->pushed;
+  const bool close=st->close;
+  const bool flush=(st->flush || close || stop);
+  st->flush=false;
+  lock.unlock();
+  string errtext,errfile;
+  if(!st->failed){
+    if(!OpenFiles(st,defined,errfile))errtext="File could not be opened.";
+    //-Writes CSV data.
+    if(errtext.empty() && st->pfcsv && rend>rini){
+      string tx;
+      FormatCsv(st,rini,rend,tx);
+      if(fwrite(tx.data(),1,tx.size(),st->pfcsv)!=tx.size()){
+        errtext="File writing failure."; errfile=st->file;
+      }
+    }
+    //-Writes binary data.
+    if(errtext.empty() && st->pfbin && rend>rini){
+      vector<byte> buf;
+      FormatBin(st,rini,rend,buf);
+      if(fwrite(buf.data(),1,buf.size(),st->pfbin)!=buf.size()){
+        errtext="File writing failure."; errfile=st->filebin;
+      }
+    }
+    if(errtext.empty() && flush){
+      if(st->pfcsv && fflush(st->pfcsv)){ errtext="File writing failure."; errfile=st->file; }
+      if(st->pfbin && fflush(st->pfbin)){ errtext="File writing failure."; errfile=st->filebin; }
+    }
+    if(!errtext.empty())st->failed=true;
+  }
+  //-Closes files when stream is closed or thread finishes.
+  if(close || stop || st->failed){
+    if(st->pfcsv)fclose(st->pfcsv);
+    if(st->pfbin)fclose(st->pfbin);
+    st->pfcsv=st->pfbin=NULL;
+  }
+  lock.lock();
+  st->written=rend;
+  if(!errtext.empty() && ErrText.empty()){
+    ErrText=errtext; ErrFile=errfile;
+  }
+  if(close){
+    delete st;
+    Streams[id]=NULL;
+  }
+}
+
+//==============================================================================
+/// Opens output files of stream when they are not open. The head is written
+/// when the file is created. The binary file is created when the columns
+/// were defined by the first record.
+//==============================================================================
+bool JSeriesSink::OpenFiles(StStream *st,bool defined,std::string &errfile)const{
+  if(SvCsv && !st->pfcsv){
+    const bool app=(st->createdcsv || (st->append && fun::FileExists(st->file)));
+    st->pfcsv=fopen(st->file.c_str(),(app? "ab": "wb"));
+    if(!st->pfcsv){ errfile=st->file; return(false); }
+    if(!app && fwrite(st->head.data(),1,st->head.size(),st->pfcsv)!=st->head.size()){
+      errfile=st->file; return(false);
+    }
+    st->createdcsv=true;
+  }
+  if(SvBin && !st->pfbin && defined){
+    const bool app=(st->createdbin || (st->append && fun::FileExists(st->filebin)));
+    st->pfbin=fopen(st->filebin.c_str(),(app? "ab": "wb"));
+    if(!st->pfbin){ errfile=st->filebin; return(false); }
+    if(!app){
+      //-Names of columns from the head.
+      vector<string> fields;
+      string tx=st->headnames;
+      while(!tx.empty())fields.push_back(fun::StrSplit(";",tx));
+      //-Writes header.
+      vector<byte> buf;
+      const char magic[8]="JSERIES";
+      buf.insert(buf.end(),(const byte*)magic,(const byte*)magic+8);
+      const unsigned ncols=unsigned(st->cols.size());
+      unsigned head[2]={1,ncols};
+      buf.insert(buf.end(),(const byte*)head,(const byte*)head+sizeof(head));
+      unsigned cf=0;
+      for(unsigned c=0;c<ncols;c++){
+        const TpTypeData type=st->cols[c].type;
+        string name;
+        for(int cd=0;cd<DimOfType(type);cd++,cf++){
+          name=name+(cd? ";": "")+(cf<unsigned(fields.size())? fields[cf]: fun::PrintStr("col%u",cf));
+        }
+        const unsigned v[2]={unsigned(type),unsigned(name.size())};
+        buf.insert(buf.end(),(const byte*)v,(const byte*)v+sizeof(v));
+        buf.insert(buf.end(),(const byte*)name.data(),(const byte*)name.data()+name.size());
+      }
+      if(fwrite(buf.data(),1,buf.size(),st->pfbin)!=buf.size()){
+        errfile=st->filebin; return(false);
+      }
+    }
+    st->createdbin=true;
+  }
+  return(true);
+}
+
+//==============================================================================
+/// Sets separators according configuration (the same as JSaveCsv2).
+//==============================================================================
+void JSeriesSink::SetSeparators(char *tx)const{
+  const char sep0=(CsvSepComa? ';': ',');
+  const char sep1=(CsvSepComa? ',': ';');
+  for(;*tx;tx++)if(*tx==sep0)*tx=sep1;
+}
+
+//==============================================================================
+/// Formats records [rini,rend) as lines of CSV file.
+//==============================================================================
+void JSeriesSink::FormatCsv(const StStream *st,ullong rini,ullong rend,std::string &tx)const{
+  const unsigned ncols=unsigned(st->cols.size());
+  tx.reserve(size_t(rend-rini)*ncols*24);
+  string val;
+  for(ullong r=rini;r<rend;r++){
+    const byte *rec=st->ring.data()+size_t(r%st->capacity)*st->recsize;
+    for(unsigned c=0;c<ncols;c++){
+      const StSeriesCol &col=st->cols[c];
+      const JNumFormat &fmt=col.fmt;
+      const byte *pv=rec+col.offset;
+      val.clear();
+      switch(col.type){
+        case TypeInt:     { int      v[1]; memcpy(v,pv,sizeof(v)); fmt.Append(val,v,1); }break;
+        case TypeUint:    { unsigned v[1]; memcpy(v,pv,sizeof(v)); fmt.Append(val,v,1); }break;
+        case TypeLlong:   { llong    v[1]; memcpy(v,pv,sizeof(v)); fmt.Append(val,v,1); }break;
+        case TypeUllong:  { ullong   v[1]; memcpy(v,pv,sizeof(v)); fmt.Append(val,v,1); }break;
+        case TypeFloat:   { float    v[1]; memcpy(v,pv,sizeof(v)); fmt.Append(val,v,1); }break;
+        case TypeDouble:  { double   v[1]; memcpy(v,pv,sizeof(v)); fmt.Append(val,v,1); }break;
+        case TypeFloat2:  { float    v[2]; memcpy(v,pv,sizeof(v)); fmt.Append(val,v,2); }break;
+        case TypeFloat3:  { float    v[3]; memcpy(v,pv,sizeof(v)); fmt.Append(val,v,3); }break;
+        case TypeFloat4:  { float    v[4]; memcpy(v,pv,sizeof(v)); fmt.Append(val,v,4); }break;
+        case TypeDouble2: { double   v[2]; memcpy(v,pv,sizeof(v)); fmt.Append(val,v,2); }break;
+        case TypeDouble3: { double   v[3]; memcpy(v,pv,sizeof(v)); fmt.Append(val,v,3); }break;
+        case TypeDouble4: { double   v[4]; memcpy(v,pv,sizeof(v)); fmt.Append(val,v,4); }break;
+        default: break;
+      }
+      if(!val.empty())SetSeparators(&val[0]);
+      if(c)tx.push_back(';');
+      tx.append(val);
+    }
+    tx.push_back('\n');
+  }
+}
+
+//==============================================================================
+/// Formats records [rini,rend) as one chunk of binary file.
+//==============================================================================
+void JSeriesSink::FormatBin(const StStream *st,ullong rini,ullong rend,std::vector<byte> &buf)const{
+  const unsigned nrec=unsigned(rend-rini);
+  const unsigned head[2]={0x4B4E4843,nrec};
+  buf.resize(sizeof(head)+size_t(nrec)*st->recsize);
+  memcpy(buf.data(),head,sizeof(head));
+  byte *ptr=buf.data()+sizeof(head);
+  const unsigned ncols=unsigned(st->cols.size());
+  for(unsigned c=0;c<ncols;c++){
+    const unsigned offset=st->cols[c].offset;
+    const unsigned size=SizeOfType(st->cols[c].type);
+    for(ullong r=rini;r<rend;r++,ptr+=size){
+      memcpy(ptr,st->ring.data()+size_t(r%st->capacity)*st->recsize+offset,size);
+    }
+  }
+}
+
+//==============================================================================
+/// Defines the columns of stream and allocates its ring buffer.
+//==============================================================================
+void JSeriesSink::DefineColumns(unsigned id,const std::vector<StSeriesCol> &cols,unsigned recsize){
+  std::lock_guard<std::mutex> lock(Mtx);
+  StStream *st=Streams[id];
+  st->cols=cols;
+  st->recsize=recsize;
+  st->capacity=max(16u,st->ringsize/recsize);
+  st->ring.resize(size_t(st->capacity)*recsize);
+}
+
+//==============================================================================
+/// Copies record in ring buffer of stream. Waits for the secondary thread
+/// when the buffer is full.
+//==============================================================================
+void JSeriesSink::PushRecord(unsigned id,const byte *data){
+  CheckError();
+  StartWorker();
+  bool notify=false;
+  {
+    std::unique_lock<std::mutex> lock(Mtx);
+    StStream *st=Streams[id];
+    while(st->pushed-st->written>=st->capacity){
+      WorkRequested=true;
+      CvWork.notify_one();
+      CvDone.wait(lock);
+    }
+    memcpy(st->ring.data()+size_t(st->pushed%st->capacity)*st->recsize,data,st->recsize);
+    st->pushed++;
+    if(st->pushed-st->written==st->capacity/2){
+      WorkRequested=notify=true;
+    }
+  }
+  if(notify)CvWork.notify_one();
+}
+
+//==============================================================================
+/// Adds new stream and returns its id. Returns the id of the open stream
+/// when the file was already added. Waits for the pending close of a previous
+/// stream of the same file before creating the new one. The size of ring
+/// buffer in bytes is RINGSIZE when ringsize is zero.
+//==============================================================================
+unsigned JSeriesSink::AddStream(const std::string &file,const std::string &head
+  ,bool append,const std::string &fileinfo,unsigned ringsize)
+{
+  CheckError();
+  StartWorker();
+  std::unique_lock<std::mutex> lock(Mtx);
+  for(unsigned id=0;id<unsigned(Streams.size());id++){
+    while(Streams[id] && Streams[id]->close && Streams[id]->file==file){
+      WorkRequested=true;
+      CvWork.notify_one();
+      CvDone.wait(lock);
+    }
+    if(Streams[id] && Streams[id]->file==file)return(id);
+  }
+  StStream *st=new StStream;
+  st->file=file;
+  st->filebin=GetFileBin(file);
+  st->headnames=head;
+  st->head=head+"\n";
+  SetSeparators(&st->head[0]);
+  st->append=append;
+  st->ringsize=(ringsize? ringsize: RINGSIZE);
+  st->recsize=st->capacity=0;
+  st->pushed=st->written=0;
+  st->flush=st->close=false;
+  st->createdcsv=st->createdbin=false;
+  st->failed=false;
+  st->pfcsv=st->pfbin=NULL;
+  const unsigned id=unsigned(Streams.size());
+  Streams.push_back(st);
+  Recs.push_back(new JSeriesRec(this,id));
+  if(Log && !fileinfo.empty()){
+    if(SvCsv)Log->AddFileInfo(st->file,fileinfo);
+    if(SvBin)Log->AddFileInfo(st->filebin,fileinfo+" (binary format)");
+  }
+  return(id);
+}
+
+//==============================================================================
+/// Returns the builder of records of the stream.
+//==============================================================================
+JSeriesRec& JSeriesSink::Rec(unsigned id){
+  if(id>=unsigned(Recs.size()) || !Recs[id])Run_Exceptioon(fun::PrintStr("Stream %u is not available.",id));
+  return(*Recs[id]);
+}
+
+//==============================================================================
+/// Requests the write of pending records of the stream (asynchronous).
+//==============================================================================
+void JSeriesSink::Flush(unsigned id){
+  CheckError();
+  StartWorker();
+  {
+    std::lock_guard<std::mutex> lock(Mtx);
+    if(id<unsigned(Streams.size()) && Streams[id]){
+      Streams[id]->flush=true;
+      WorkRequested=true;
+    }
+  }
+  CvWork.notify_one();
+}
+
+//==============================================================================
+/// Closes the stream. Pending records are written by the secondary thread.
+//==============================================================================
+void JSeriesSink::CloseStream(unsigned id){
+  if(id<unsigned(Recs.size()) && Recs[id]){
+    delete Recs[id]; Recs[id]=NULL;
+    StartWorker();
+    {
+      std::lock_guard<std::mutex> lock(Mtx);
+      Streams[id]->close=true;
+      WorkRequested=true;
+    }
+    CvWork.notify_one();
+  }
+}
+
+//==============================================================================
+/// Writes all pending records and closes the files. The streams remain open
+/// and the secondary thread is started again with the next record.
+//==============================================================================
+void JSeriesSink::Finish(){
+  StopWorker();
+  CheckError();
+}
+
@@ -0,0 +1,215 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Clase para grabar series temporales de registros con tipo. Los registros
+//:#   se almacenan en un buffer circular por serie y un hilo secundario les da
+//:#   formato y los graba en ficheros CSV (compatibles con JSaveCsv2) y/o en
+//:#   ficheros binarios por columnas (.tsb). (19-10-2026)
+//:# - Los valores de los ficheros CSV se convierten con JNumFormat. (19-10-2026)
+//:# - Tamano del buffer circular configurable para cada serie. (19-10-2026)
+//:#############################################################################
+
+/// \file JSeriesSink.h \brief Declares the classes \ref JSeriesRec and \ref JSeriesSink.
+
+#ifndef _JSeriesSink_
+#define _JSeriesSink_
+
+#include "TypesDef.h"
+#include "JObject.h"
+#include "JSaveCsv2.h"
+#include "JNumFormat.h"
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class JLog2;
+class JSeriesSink;
+
+//##############################################################################
+//# File format of binary time series (.tsb)
+//##############################################################################
+//  Header:
+//    char[8]  "JSERIES"  (with final \0)
+//    uint     version (1)
+//    uint     number of columns
+//    For each column:
+//      uint   type of data (TpTypeData)
+//      uint   size of name
+//      char[] name (names of components separated by ';')
+//  Chunks (until end of file):
+//    uint     "CHNK" (0x4B4E4843)
+//    uint     number of records
+//    For each column: values of all records of the chunk.
+
+/// Definition of one column of a time series.
+typedef struct{
+  TpTypeData type;    ///<Type of data.
+  JNumFormat fmt;     ///<Output format for CSV.
+  unsigned offset;    ///<Offset in record (in bytes).
+}StSeriesCol;
+
+
+//##############################################################################
+//# JSeriesRec
+//##############################################################################
+/// \brief Builds the records of one time series (operator use as JSaveCsv2).
+///
+/// The columns and output formats are fixed by the first record, the next
+/// records must have the same types of data in the same order.
+
+class JSeriesRec : protected JObject
+{
+  friend class JSeriesSink;
+protected:
+  JSeriesSink *Sink;
+  const unsigned Id;       ///<Id of stream.
+
+  static const unsigned SizeFmt=18;  ///<Number of different formats.
+  std::string FmtDefault[SizeFmt];   ///<Default formats.
+  std::string FmtCurrent[SizeFmt];   ///<Current formats.
+
+  bool Defined;                      ///<Columns were defined by first record.
+  std::vector<StSeriesCol> Cols;     ///<Columns of records.
+  unsigned Col;                      ///<Next column of current record.
+  std::vector<byte> Data;            ///<Values of current record.
+
+  JSeriesRec(JSeriesSink *sink,unsigned id);
+  void InitFmt();
+  void AddValue(TpTypeData type,jcsv::TpFormat tfmt,const void *v);
+
+public:
+  ~JSeriesRec();
+
+  JSeriesRec& operator <<(const jcsv::Fmt &obj);
+  JSeriesRec& operator <<(const jcsv::Endl &obj);
+
+  JSeriesRec& operator <<(int      v){ AddValue(TypeInt   ,jcsv::TpSigned1  ,&v); return(*this); }
+  JSeriesRec& operator <<(unsigned v){ AddValue(TypeUint  ,jcsv::TpUnsigned1,&v); return(*this); }
+  JSeriesRec& operator <<(word     v){ const unsigned vv=v; AddValue(TypeUint,jcsv::TpUnsigned1,&vv); return(*this); }
+  JSeriesRec& operator <<(llong    v){ AddValue(TypeLlong ,jcsv::TpLlong1   ,&v); return(*this); }
+  JSeriesRec& operator <<(ullong   v){ AddValue(TypeUllong,jcsv::TpUllong1  ,&v); return(*this); }
+  JSeriesRec& operator <<(float    v){ AddValue(TypeFloat ,jcsv::TpFloat1   ,&v); return(*this); }
+  JSeriesRec& operator <<(double   v){ AddValue(TypeDouble,jcsv::TpDouble1  ,&v); return(*this); }
+
+  JSeriesRec& operator <<(const tfloat2  &v){ AddValue(TypeFloat2 ,jcsv::TpFloat2 ,&v); return(*this); }
+  JSeriesRec& operator <<(const tfloat3  &v){ AddValue(TypeFloat3 ,jcsv::TpFloat3 ,&v); return(*this); }
+  JSeriesRec& operator <<(const tfloat4  &v){ AddValue(TypeFloat4 ,jcsv::TpFloat4 ,&v); return(*this); }
+  JSeriesRec& operator <<(const tdouble2 &v){ AddValue(TypeDouble2,jcsv::TpDouble2,&v); return(*this); }
+  JSeriesRec& operator <<(const tdouble3 &v){ AddValue(TypeDouble3,jcsv::TpDouble3,&v); return(*this); }
+  JSeriesRec& operator <<(const tdouble4 &v){ AddValue(TypeDouble4,jcsv::TpDouble4,&v); return(*this); }
+};
+
+
+//##############################################################################
+//# JSeriesSink
+//##############################################################################
+/// \brief Saves time series of typed records using a background thread.
+///
+/// Each stream stores the binary records in a ring buffer. A secondary thread
+/// formats the pending records and writes them in large blocks when the buffer
+/// is half full, when a flush is requested or every second, so the simulation
+/// loop only copies the values. The CSV output is the same as JSaveCsv2.
+/// Errors of the secondary thread are thrown in the main thread in the next
+/// call to the object.
+
+class JSeriesSink : protected JObject
+{
+  friend class JSeriesRec;
+protected:
+  static const unsigned RINGSIZE=262144;  ///<Size of ring buffer of each stream (in bytes).
+  static const unsigned WRITEMS=1000;     ///<Maximum time between writes of pending records (in milliseconds).
+
+  /// Structure with the information of one stream.
+  typedef struct{
+    std::string file;         ///<CSV file (also identifies the stream).
+    std::string filebin;      ///<Binary file.
+    std::string head;         ///<Head of CSV file with separators according configuration.
+    std::string headnames;    ///<Original head used for the names of columns.
+    bool append;              ///<Appends data when file already exists.
+    unsigned ringsize;        ///<Size of ring buffer (in bytes).
+    std::vector<StSeriesCol> cols;  ///<Columns of records.
+    unsigned recsize;         ///<Size of one record (in bytes).
+    unsigned capacity;        ///<Number of records in ring buffer.
+    std::vector<byte> ring;   ///<Ring buffer of records [capacity*recsize].
+    ullong pushed;            ///<Number of records stored.
+    ullong written;           ///<Number of records written.
+    bool flush;               ///<Write of pending records was requested.
+    bool close;               ///<Stream was closed by main thread.
+    bool createdcsv;          ///<CSV file was created (head was written).
+    bool createdbin;          ///<Binary file was created (header was written).
+    bool failed;              ///<Error in output files (next records are discarded).
+    FILE *pfcsv;              ///<CSV file (only used by secondary thread).
+    FILE *pfbin;              ///<Binary file (only used by secondary thread).
+  }StStream;
+
+  JLog2 *Log;
+  const bool SvCsv;           ///<Saves CSV files.
+  const bool SvBin;           ///<Saves binary files (.tsb).
+  const bool CsvSepComa;      ///<Separator character in CSV files (0=semicolon, 1=coma).
+
+  std::vector<StStream*> Streams;  ///<Streams (closed streams are NULL).
+  std::vector<JSeriesRec*> Recs;   ///<Builders of records of streams (only used by main thread).
+
+  std::mutex Mtx;                  ///<Protects streams and state of thread.
+  std::condition_variable CvWork;  ///<Wakes up the secondary thread.
+  std::condition_variable CvDone;  ///<Wakes up the main thread waiting for free space.
+  std::thread *Worker;             ///<Secondary thread.
+  bool WorkRequested;              ///<Some stream requires to be processed.
+  bool Stop;                       ///<Secondary thread has to write all and finish.
+  std::string ErrText;             ///<Error of secondary thread.
+  std::string ErrFile;             ///<File of error of secondary thread.
+
+  void StartWorker();
+  void StopWorker();
+  void CheckError();
+  static void WorkerRun(JSeriesSink *sink);
+  void WorkerLoop();
+  void ProcessStream(unsigned id,std::unique_lock<std::mutex> &lock,bool stop);
+  bool OpenFiles(StStream *st,bool defined,std::string &errfile)const;
+  void FormatCsv(const StStream *st,ullong rini,ullong rend,std::string &tx)const;
+  void FormatBin(const StStream *st,ullong rini,ullong rend,std::vector<byte> &buf)const;
+  void SetSeparators(char *tx)const;
+
+  void DefineColumns(unsigned id,const std::vector<StSeriesCol> &cols,unsigned recsize);
+  void PushRecord(unsigned id,const byte *data);
+
+public:
+  JSeriesSink(bool svcsv,bool svbin,bool csvsepcoma,JLog2 *log);
+  ~JSeriesSink();
+
+  bool GetSvCsv()const{ return(SvCsv); }
+  bool GetSvBin()const{ return(SvBin); }
+  static std::string GetFileBin(const std::string &file);
+
+  unsigned AddStream(const std::string &file,const std::string &head,bool append=false
+    ,const std::string &fileinfo="",unsigned ringsize=0);
+  JSeriesRec& Rec(unsigned id);
+  void Flush(unsigned id);
+  void CloseStream(unsigned id);
+  void Finish();
+};
+
+#endif
+
+
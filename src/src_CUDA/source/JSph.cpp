@@ -24,6 +24,7 @@
 #include "FunctionsGeo3d.h"
 #include "FunSphKernelsCfg.h"
 #include "FunSphKernel.h"
+#include "OmpDefs.h"
 #include "JPartDataHead.h"
 #include "JSphMk.h"
 #include "JDsPartsInit.h"
@@ -51,6 +52,12 @@
 #include "JDsPartsOut.h"
 #include "JSphShifting.h"
 #include "JDsDamping.h"
+#include "JDsOutputParts.h"
+#include "JDsGridStats.h"
+#include "JDsFreeSurface.h"
+#include "JDsSurfaceLoads.h"
+#include "JDsFtSeries.h"
+#include "JDsCheckpoint.h"
 #include "JDsInitialize.h"
 #include "JSphInOut.h"       //<vs_innlet> 
 #include "JSphBoundCorr.h"   //<vs_innlet> 
@@ -60,6 +67,7 @@
 #include "JNormalsMarrone.h" //<vs_mddbc>
 #include "JDataArrays.h"
 #include "JOutputCsv.h"
+#include "JOutputVtu.h"
 #include "JVtkLib.h"
 #include "JNumexLib.h"
 #include "JCaseUserVars.h"
@@ -101,6 +109,11 @@ JSph::JSph(bool cpu,bool mgpu,bool withmpi):Cpu(cpu),Mgpu(mgpu),WithMpi(withmpi)
   ForcePoints=NULL; //<vs_moordyyn>
   Shifting=NULL;
   Damping=NULL;
+  OutputParts=NULL;
+  GridStats=NULL;
+  FreeSurface=NULL;
+  SurfaceLoads=NULL;
+  FtSeries=NULL;
   AccInput=NULL;
   PartsLoaded=NULL;
   InOut=NULL;       //<vs_innlet>
@@ -137,6 +150,11 @@ JSph::~JSph(){
   delete ForcePoints;   ForcePoints=NULL;   //<vs_moordyyn>
   delete Shifting;      Shifting=NULL;
   delete Damping;       Damping=NULL;
+  delete OutputParts;   OutputParts=NULL;
+  delete GridStats;     GridStats=NULL;
+  delete FreeSurface;   FreeSurface=NULL;
+  delete SurfaceLoads;  SurfaceLoads=NULL;
+  delete FtSeries;      FtSeries=NULL;
   delete AccInput;      AccInput=NULL; 
   delete PartsLoaded;   PartsLoaded=NULL;
   delete InOut;         InOut=NULL;       //<vs_innlet>
@@ -193,6 +211,7 @@ void JSph::InitVars(){
   PartsOutWrn=1; PartsOutTotWrn=10;
 
   SvData=byte(SDAT_Binx)|byte(SDAT_Info);
+  SvVtuZip=false;
   SvRes=false;
   SvTimers=false;
   SvDomainVtk=false;
@@ -219,6 +238,9 @@ void JSph::InitVars(){
   PartBegin=PartBeginFirst=0;
   PartBeginTimeStep=0; 
   PartBeginTotalNp=0;
+  CheckpointBegin="";
+  CheckpointTime=-1;
+  CheckpointDelta=0;
 
   WrnPartsOut=true;
 
@@ -270,6 +292,7 @@ void JSph::InitVars(){
   MaxNumbers.Clear();
 
   SaveFtAce=false;
+  FtSeriesDt=-1;
 }
 
 //==============================================================================
@@ -486,6 +509,9 @@ void JSph::LoadConfig(const JSphCfgRun *cfg){
   RunName=(cfg->RunName.length()? cfg->RunName: CaseName);
   FileXml=DirCase+CaseName+".xml";
   PartBeginDir=cfg->PartBeginDir; PartBegin=cfg->PartBegin; PartBeginFirst=cfg->PartBeginFirst;
+  CheckpointBegin=cfg->CheckpointBegin; CheckpointTime=cfg->CheckpointTime; CheckpointDelta=cfg->CheckpointDelta;
+  if(!Cpu && (!CheckpointBegin.empty() || CheckpointTime>=0))Run_Exceptioon("Checkpoints are only available on CPU executions.");
+  if(PartBegin && !CheckpointBegin.empty())Run_Exceptioon("Simulation restart from PART and from checkpoint can not be combined.");
   //-Output options:
   CsvSepComa=cfg->CsvSepComa;
   SvData=byte(SDAT_None); 
@@ -493,6 +519,8 @@ void JSph::LoadConfig(const JSphCfgRun *cfg){
   if(cfg->Sv_Binx)SvData|=byte(SDAT_Binx);
   if(cfg->Sv_Info)SvData|=byte(SDAT_Info);
   if(cfg->Sv_Vtk)SvData|=byte(SDAT_Vtk);
+  if(cfg->Sv_Vtu)SvData|=byte(SDAT_Vtu);
+  SvVtuZip=cfg->Sv_VtuZip;
   SvRes=cfg->SvRes;
   SvTimers=cfg->SvTimers;
   SvDomainVtk=cfg->SvDomainVtk;
@@ -501,6 +529,7 @@ void JSph::LoadConfig(const JSphCfgRun *cfg){
   RunTimeDate=fun::GetDateTime();
   Log->Printf("[Initialising %s  %s]",ClassName.c_str(),RunTimeDate.c_str());
   if(!JVtkLib::Available())Log->PrintWarning("Code for VTK format files is not included in the current compilation, so no output VTK files will be created.");
+  if(SvVtuZip && !JOutputVtu::AvailableZlib())Run_Exceptioon("Compression of VTU files (-sv:vtuz) is not available since zlib is not included in the current compilation.");
   const string runpath=AppInfo.GetRunPath();
   Log->Printf("ProgramFile=\"%s\"",fun::GetPathLevels(fun::GetCanonicalPath(runpath,AppInfo.GetRunCommand()),3).c_str());
   Log->Printf("ExecutionDir=\"%s\"",fun::GetPathLevels(runpath,3).c_str());
@@ -519,6 +548,8 @@ void JSph::LoadConfig(const JSphCfgRun *cfg){
     Log->Print(fun::VarStr("PartBeginDir",PartBeginDir));
     Log->Print(fun::VarStr("PartBeginFirst",PartBeginFirst));
   }
+  if(!CheckpointBegin.empty())Log->Print(fun::VarStr("CheckpointBegin",CheckpointBegin));
+  if(CheckpointTime>=0 && CheckpointDelta)Log->Print(fun::VarStr("CheckpointDelta",CheckpointDelta));
 
   //-Loads case configuration from XML and command line.
   LoadCaseConfig(cfg);
@@ -667,6 +698,7 @@ void JSph::LoadConfigParameters(const JXml *xml){
 
   WrnPartsOut=(eparms.GetValueInt("WrnPartsOut",true,1)!=0);
   FtPause=eparms.GetValueFloat("FtPause",true,0);
+  FtSeriesDt=eparms.GetValueDouble("FtSaveSeries",true,-1);
   FtIgnoreRadius=(eparms.GetValueInt("FtIgnoreRadius",true,0)!=0);
 
   TimeMax=eparms.GetValueDouble("TimeMax");
@@ -807,6 +839,7 @@ void JSph::LoadConfigCommands(const JSphCfgRun *cfg){
   }
 
   if(cfg->FtPause>=0)FtPause=cfg->FtPause;
+  if(cfg->SvFtSeries>=0)FtSeriesDt=cfg->SvFtSeries;
   if(cfg->TimeMax>0)TimeMax=cfg->TimeMax;
   NstepsBreak=cfg->NstepsBreak;
   if(NstepsBreak)Log->PrintfWarning("The execution will be cancelled after %d simulation steps.",NstepsBreak);
@@ -1010,6 +1043,16 @@ void JSph::LoadCaseConfig(const JSphCfgRun *cfg){
     Damping->LoadXml(&xml,"case.execution.special.damping");
   }
 
+  //-Configuration of filtered particle output streams.
+  if(xml.GetNodeSimple("case.execution.special.outputparts",true)){
+    if(!Cpu)Log->PrintWarning("Output streams of filtered particles (special.outputparts) are only available on CPU executions.");
+    else{
+      OutputParts=new JDsOutputParts(Log);
+      OutputParts->LoadXml(&xml,"case.execution.special.outputparts",MkInfo,TimePart);
+      if(!OutputParts->GetCount()){ delete OutputParts; OutputParts=NULL; }
+    }
+  }
+
   //-Loads floating objects.
   FtCount=parts.CountBlocks(TpPartFloating);
   if(FtCount){
@@ -1514,6 +1557,7 @@ void JSph::VisuConfig(){
   if(FtCount)Log->Print(fun::VarStr("FtPause",FtPause));
   if(FtCount)Log->Print(fun::VarStr("FtConstraints",FtConstraints));
   if(FtCount)Log->Print(fun::VarStr("FtIgnoreRadius",FtIgnoreRadius));
+  if(FtCount)Log->Print(fun::VarStr("FtSaveSeries",FtSeriesDt));
   Log->Print(fun::VarStr("CaseNp",CaseNp));
   Log->Print(fun::VarStr("CaseNbound",CaseNbound));
   Log->Print(fun::VarStr("CaseNfixed",CaseNfixed));
@@ -1590,7 +1634,12 @@ void JSph::VisuParticleSummary()const{
 /// excluidas de las previstas.
 //==============================================================================
 void JSph::LoadDcellParticles(unsigned n,const typecode *code,const tdouble3 *pos,unsigned *dcell)const{
-  for(unsigned p=0;p<n;p++){
+  const int np=int(n);
+  int nout=0;
+  #ifdef OMP_USE
+    #pragma omp parallel for schedule (static) reduction(+:nout) if(np>OMP_LIMIT_COMPUTELIGHT)
+  #endif
+  for(int p=0;p<np;p++){
     typecode codeout=CODE_GetSpecialValue(code[p]);
     if(codeout<CODE_OUTIGNORE){
       const tdouble3 ps=pos[p];
@@ -1602,12 +1651,14 @@ void JSph::LoadDcellParticles(unsigned n,const typecode *code,const tdouble3 *po
         dcell[p]=PC__Cell(DomCellCode,cx,cy,cz);
       }
       else{//-Particle out.
-        Run_Exceptioon("Found new particles out."); //-There can not be new particles excluded. | No puede haber nuevas particulas excluidas.
+        nout++;
         dcell[p]=PC__CodeMapOut;
       }
     }
     else dcell[p]=PC__CodeMapOut;
   }
+  //-There can not be new particles excluded. | No puede haber nuevas particulas excluidas.
+  if(nout)Run_Exceptioon("Found new particles out.");
 }
 
 //==============================================================================
@@ -1660,14 +1711,21 @@ void JSph::FreePartsInit(){
 }
 
 //==============================================================================
-/// Configures cell division.
+/// Computes cell size and number of cells of the map according to CellMode.
 //==============================================================================
-void JSph::ConfigCellDivision(){
+void JSph::ConfigCellSize(){
   if(CellMode!=CELLMODE_Full && CellMode!=CELLMODE_Half)Run_Exceptioon("The CellMode is invalid.");
   ScellDiv=(CellMode==CELLMODE_Full? 1: 2);
   Scell=KernelSize/ScellDiv;
   MovLimit=Scell*0.9f;
   Map_Cells=TUint3(unsigned(ceil(Map_Size.x/Scell)),unsigned(ceil(Map_Size.y/Scell)),unsigned(ceil(Map_Size.z/Scell)));
+}
+
+//==============================================================================
+/// Configures cell division.
+//==============================================================================
+void JSph::ConfigCellDivision(){
+  ConfigCellSize();
   //-Prints configuration.
   Log->Print(fun::VarStr("CellMode",string(GetNameCellMode(CellMode))));
   Log->Print(fun::VarStr("ScellDiv",ScellDiv));
@@ -1945,12 +2003,16 @@ void JSph::RestartCheckData(){
 void JSph::CheckRhopLimits(){
   const tfloat4 *velrhop=PartsLoaded->GetVelRhop(); ///<Velocity and density of each particle
   const unsigned *idp   =PartsLoaded->GetIdp();     ///<Identifier of each particle
-  const unsigned n=PartsLoaded->GetCount();
+  const int n=int(PartsLoaded->GetCount());
   //-Checks the initial density of each fluid particle
-  for(unsigned p=0;p<n;p++)if(idp[p]>=CaseNbound){
-    if(velrhop[p].w<RhopOutMin || RhopOutMax<velrhop[p].w)
-      Run_Exceptioon("Initial fluid density is out of limits. *** To change the limits modify the value of \'RhopOutMin\' and \'RhopOutMax\' in the XML file (parameters section).");
+  int nout=0;
+  #ifdef OMP_USE
+    #pragma omp parallel for schedule (static) reduction(+:nout) if(n>OMP_LIMIT_COMPUTELIGHT)
+  #endif
+  for(int p=0;p<n;p++)if(idp[p]>=CaseNbound){
+    if(velrhop[p].w<RhopOutMin || RhopOutMax<velrhop[p].w)nout++;
   }
+  if(nout)Run_Exceptioon("Initial fluid density is out of limits. *** To change the limits modify the value of \'RhopOutMin\' and \'RhopOutMax\' in the XML file (parameters section).");
 }
 
 //==============================================================================
@@ -2057,6 +2119,49 @@ void JSph::InitRun(unsigned np,const unsigned *idp,const tdouble3 *pos){
   if(xml.GetNodeSimple("case.execution.special.gauges",true))
     GaugeSystem->LoadXml(&xml,"case.execution.special.gauges",MkInfo);
 
+  //-Configuration of in-situ statistics on Cartesian grids.
+  if(xml.GetNodeSimple("case.execution.special.gridstats",true)){
+    if(!Cpu)Log->PrintWarning("Statistics on grids (special.gridstats) are only available on CPU executions.");
+    else{
+      GridStats=new JDsGridStats(Log);
+      GridStats->Config(CSP,DomPosMin,DomPosMax,TimeMax,DirOut);
+      GridStats->LoadXml(&xml,"case.execution.special.gridstats");
+      if(!GridStats->GetCount()){ delete GridStats; GridStats=NULL; }
+      else GridStats->VisuConfig("GridStats configuration:"," ");
+    }
+  }
+
+  //-Configuration of in-situ extraction of free surface.
+  if(xml.GetNodeSimple("case.execution.special.freesurface",true)){
+    if(!Cpu)Log->PrintWarning("Extraction of free surface (special.freesurface) is only available on CPU executions.");
+    else{
+      FreeSurface=new JDsFreeSurface(Log);
+      FreeSurface->Config(CSP,DomPosMin,DomPosMax,DirOut,SvVtuZip);
+      FreeSurface->LoadXml(&xml,"case.execution.special.freesurface");
+      if(!FreeSurface->GetCount()){ delete FreeSurface; FreeSurface=NULL; }
+      else FreeSurface->VisuConfig("FreeSurface configuration:"," ");
+    }
+  }
+
+  //-Configuration of accumulation of loads on boundary particles.
+  if(xml.GetNodeSimple("case.execution.special.surfaceloads",true)){
+    if(!Cpu)Log->PrintWarning("Loads on boundary particles (special.surfaceloads) are only available on CPU executions.");
+    else{
+      SurfaceLoads=new JDsSurfaceLoads(Log);
+      SurfaceLoads->Config(CSP,DirOut,SvVtuZip);
+      SurfaceLoads->LoadXml(&xml,"case.execution.special.surfaceloads",MkInfo,FtCount,FtObjs);
+      if(!SurfaceLoads->GetCount()){ delete SurfaceLoads; SurfaceLoads=NULL; }
+      else SurfaceLoads->VisuConfig("SurfaceLoads configuration:"," ");
+    }
+  }
+
+  //-Configuration of binary time series of floating bodies.
+  if(FtCount && FtSeriesDt>=0){
+    FtSeries=new JDsFtSeries(Log);
+    FtSeries->Config(DirOut,FtSeriesDt,AppInfo.GetCsvSepComa(),Gravity,FtCount,FtObjs);
+    FtSeries->VisuConfig("FtSeries configuration:"," ");
+  }
+
   //-Prepares WaveGen configuration.
   if(WaveGen){
     Log->Print("Wave paddles configuration:");
@@ -2107,6 +2212,11 @@ void JSph::InitRun(unsigned np,const unsigned *idp,const tdouble3 *pos){
     Damping->VisuConfig("Damping configuration:"," ");
   }
 
+  //-Shows configuration of filtered particle output streams.
+  if(OutputParts){
+    OutputParts->VisuConfig("OutputParts configuration:"," ");
+  }
+
   //-Prepares AccInput configuration.
   if(AccInput){
     Log->Print("AccInput configuration:");
@@ -2270,6 +2380,15 @@ void JSph::ConfigSaveData(unsigned piece,unsigned pieces,std::string div){
     DataFloatBi4->SaveInitial();
     Log->AddFileInfo(DirDataOut+"PartFloat.fbi4","Binary file with floating body information for each instant (input for FloatingInfo program).");
   }
+  if(CheckpointTime>=0)Log->AddFileInfo(JDsCheckpointChain::GetFilesPattern(DirOut+"Checkpoint",CheckpointDelta)
+    ,(CheckpointDelta? "Chain of full and delta checkpoint files with the exact state of execution (input for -checkpointbegin).":
+      "Checkpoint file with the exact state of execution (input for -checkpointbegin)."));
+  //-Configures output streams of filtered particles.
+  if(OutputParts)OutputParts->ConfigSave(DirDataOut,&parthead,piece,pieces,TimeStep);
+  if(SvData&SDAT_Vtu){
+    Log->AddFileInfo(DirDataOut+"PartVtu_????.vtu","VTK XML file with binary particle data in different instants.");
+    Log->AddFileInfo(DirDataOut+"PartVtu_????.pvtu","VTK XML index of particle data split in several pieces (PartVtu_????_???.vtu).");
+  }
   //-Creates object to store excluded particles until recordering. 
   //-Crea objeto para almacenar las particulas excluidas hasta su grabacion.
   PartsOut=new JDsPartsOut();
@@ -2470,7 +2589,7 @@ void JSph::SavePartData(unsigned npok,unsigned nout,const JDataArrays& arrays
   }
 
   //-Stores VTK nd/or CSV files.
-  if((SvData&SDAT_Csv) || (SvData&SDAT_Vtk)){
+  if((SvData&SDAT_Csv) || (SvData&SDAT_Vtk) || (SvData&SDAT_Vtu)){
     JDataArrays arrays2;
     arrays2.CopyFrom(arrays);
 
@@ -2495,6 +2614,12 @@ void JSph::SavePartData(unsigned npok,unsigned nout,const JDataArrays& arrays
     if(SvData&SDAT_Vtk){
       JVtkLib::SaveVtkData(DirDataOut+fun::FileNameSec("PartVtk.vtk",Part),arrays2,"Pos");
     }
+    if(SvData&SDAT_Vtu){
+      JOutputVtu ovtu(SvVtuZip);
+      //-Large data is split in pieces written in parallel.
+      if(npok>ovtu.PieceSize)ovtu.SavePvtu(DirDataOut+fun::FileNameSec("PartVtu.pvtu",Part),arrays2,"Pos");
+      else ovtu.SaveVtu(DirDataOut+fun::FileNameSec("PartVtu.vtu",Part),arrays2,"Pos");
+    }
     if(SvData&SDAT_Csv){ 
       JOutputCsv ocsv(AppInfo.GetCsvSepComa());
       ocsv.SaveCsv(DirDataOut+fun::FileNameSec("PartCsv.csv",Part),arrays2);
@@ -2825,6 +2950,8 @@ void JSph::ShowResume(bool stop,float tsim,float ttot,bool all,std::string infop
     if(DsPips){
       Log->Printf("Particle Interactions Per Second.: %.8f GPIPS",DsPips->GetGPIPS(tsim));
       Log->Printf("Total particle interactions (f+b): %s",DsPips->GetTotalPIsInfo().c_str());
+      DsPips->VisuModel();
+      if(DsPips->SvData)DsPips->SaveModelCsv(DirOut+"PipsModel.csv",CsvSepComa);
     }
     Log->Printf("PART files.......................: %d",Part-PartIni);
     while(!infoplus.empty()){
@@ -64,6 +64,11 @@ class JPartFloatBi4Save;
 class JDsPartsOut;
 class JSphShifting;
 class JDsDamping;
+class JDsOutputParts;
+class JDsGridStats;
+class JDsFreeSurface;
+class JDsSurfaceLoads;
+class JDsFtSeries;
 class JXml;
 class JDsOutputTime;
 class JGaugeSystem;
@@ -219,6 +224,7 @@ protected:
   //-Configuration for result output.
   bool CsvSepComa;           ///<Separator character in CSV files (0=semicolon, 1=coma).
   byte SvData;               ///<Combination of the TpSaveDat values.                            | Combinacion de valores TpSaveDat.                                                      
+  bool SvVtuZip;             ///<Compresses binary data of VTU files using zlib.                 | Comprime datos binarios de ficheros VTU con zlib.
   bool SvRes;                ///<Creates file with execution summary.                            | Graba fichero con resumen de ejecucion.
   bool SvTimers;             ///<Computes the time for each process.                             | Obtiene tiempo para cada proceso.
   bool SvDomainVtk;          ///<Stores VTK file with the domain of particles of each PART file. | Graba fichero vtk con el dominio de las particulas en cada Part. 
@@ -276,6 +282,9 @@ protected:
   unsigned PartBeginFirst;    ///<Indicates the number of the first PART to be generated. | Indica el numero del primer PART a generar.                                    
   double PartBeginTimeStep;   ///<initial instant of the simulation                       | Instante de inicio de la simulacion.                                          
   ullong PartBeginTotalNp;    ///<Total number of simulated particles.
+  std::string CheckpointBegin; ///<Checkpoint file to restart the simulation (empty: no resumption).
+  double CheckpointTime;      ///<Minimum runtime (in seconds) between checkpoints (-1:disabled, 0:each PART).
+  unsigned CheckpointDelta;   ///<Number of delta checkpoints after each full checkpoint (0:only full checkpoints).
 
   JDsPartsOut *PartsOut;        ///<Stores excluded particles until they are saved. | Almacena las particulas excluidas hasta su grabacion.
   bool WrnPartsOut;           ///<Active warning according to number of out particles (default=1).
@@ -329,6 +338,13 @@ protected:
 
   JDsDamping *Damping;          ///<Object for damping zones.
 
+  JDsOutputParts *OutputParts;  ///<Object for filtered and decimated particle output streams.
+
+  JDsGridStats *GridStats;      ///<Object for in-situ statistics on Cartesian grids.
+  JDsFreeSurface *FreeSurface;  ///<Object for in-situ extraction of free surface meshes.
+  JDsSurfaceLoads *SurfaceLoads;///<Object for accumulation of loads on boundary particles.
+  JDsFtSeries *FtSeries;        ///<Object for binary time series of floating bodies.
+
   JDsAccInput *AccInput;    ///<Object for variable acceleration functionality.
 
   JSphInOut *InOut;         ///<Object for inlet/outlet conditions.  //<vs_innlet> 
@@ -408,6 +424,7 @@ protected:
 
 
   bool SaveFtAce;    ///<Indicates whether linear and angular accelerations of each floating objects are saved.
+  double FtSeriesDt; ///<Time between saved steps in binary time series of floating bodies (-1:disabled, 0:all steps).
   void SaveFtAceFun(double dt,bool predictor,StFtoForces *ftoforces);
 
 
@@ -444,6 +461,7 @@ protected:
   void CreatePartsInit(unsigned np,const tdouble3 *pos,const typecode *code);
   void FreePartsInit();
 
+  void ConfigCellSize();
   void ConfigCellDivision();
   void SelecDomain(tuint3 celini,tuint3 celfin);
   static tuint3 CalcCellDistribution(tuint3 ncells);
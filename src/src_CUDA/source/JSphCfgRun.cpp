@@ -42,8 +42,15 @@ void JSphCfgRun::Reset(){
   Stable=false;
   SvPosDouble=-1;
   OmpThreads=0;
+  OmpAutotune=0;
+  OmpProfile="";
   SvTimers=true;
+  SvProfile=0;
+  SvHwCounters=false;
+  SvMemProfile=0;
+  Telemetry="";
   CellMode=CELLMODE_Full;
+  CellModeAuto=false; CellModeTrial=10; CellModeReeval=2;
   TBoundary=0; SlipMode=0; MdbcThreshold=-1;
   DomainMode=0;
   DomainFixedMin=DomainFixedMax=TDouble3(0);
@@ -56,14 +63,21 @@ void JSphCfgRun::Reset(){
   SvRes=true; SvDomainVtk=false;
   Sv_Binx=true; Sv_Info=true;
   Sv_Vtk=false; Sv_Csv=false;
+  Sv_Vtu=false; Sv_VtuZip=false;
+  SvSeriesCsv=true; SvSeriesBin=false;
   CaseName=""; RunName=""; DirOut=""; DirDataOut=""; 
   PartBegin=0; PartBeginFirst=0; PartBeginDir="";
+  CheckpointTime=-1; CheckpointBegin=""; CheckpointDelta=0;
   TimeMax=-1; TimePart=-1;
   RhopOutModif=false; RhopOutMin=700; RhopOutMax=1300;
   FtPause=-1;
+  SvFtSeries=-1;
   NstepsBreak=0;
   SvAllSteps=false;
   PipsMode=1; PipsSteps=100;
+  BenchNp=0; BenchSim2D=false; BenchBoundFrac=0.1f; BenchFloating=false;
+  BenchSteps=100; BenchThreads=""; BenchScaling=1;
+  RegDef=""; RegUpdate=false;
   CreateDirs=true;
   CsvSepComa=false;
 }
@@ -94,11 +108,23 @@ void JSphCfgRun::VisuInfo()const{
   printf("    -ompthreads:<int>  Only for CPU execution, indicates the number of threads\n");
   printf("                   by host for parallel execution, this takes the number of \n");
   printf("                   cores of the device by default (or using zero value)\n");
+  printf("    -ompautotune:<mode>  Autotuning of OpenMP parallel thresholds and loop\n");
+  printf("                   schedules of interaction (only CPU execution)\n");
+  printf("        0  Disabled, uses values by default (by default)\n");
+  printf("        1  Uses the profile of the machine or tunes and saves it\n");
+  printf("        2  Tunes again and updates the profile of the machine\n");
+  printf("    -ompprofile:<file>  File with OpenMP profiles of machines\n");
+  printf("                   (DsOmpProfile.xml next to the executable by default)\n");
   printf("\n");
 #endif
   printf("    -cellmode:<mode>  Specifies the cell division mode\n");
   printf("        full      Lowest and the least expensive in memory (by default)\n");
   printf("        half      Fastest and the most expensive in memory\n");
+  printf("        auto[:steps[:change]]  Selects full or half during the simulation\n");
+  printf("                  (only CPU) from the neighbour statistics of PIPS and from\n");
+  printf("                  timed trials of each mode with the given steps (10 by\n");
+  printf("                  default). The selection is repeated when the number of\n");
+  printf("                  particles per cell changes by the given factor (2 by default)\n");
   printf("\n");
 
   printf("  Formulation options:\n");
@@ -145,11 +171,23 @@ void JSphCfgRun::VisuInfo()const{
   printf("     Specifies the beginning of the simulation starting from a given PART\n");
   printf("     (begin) and located in the directory (dir), (first) indicates the\n");
   printf("     number of the first PART to be generated\n\n");
+  printf("    -checkpoint[:<float>]  Saves a checkpoint file with the exact state of\n");
+  printf("     the execution after a PART when the given runtime in seconds has elapsed\n");
+  printf("     since the previous checkpoint (0 by default, at each PART). Only on CPU\n");
+  printf("    -checkpointdelta:<int>  Number of delta checkpoints after each full\n");
+  printf("     checkpoint. Delta checkpoints only save the data blocks that changed\n");
+  printf("     since the previous checkpoint (0 by default, only full checkpoints)\n");
+  printf("    -checkpointbegin <file>  Restarts the simulation from a checkpoint file\n");
+  printf("     with the same case and execution options. Only on CPU\n");
+  printf("    -checkpointrebuild <file> <fileout>  Creates a full checkpoint file from\n");
+  printf("     a delta checkpoint and the previous files of its chain\n\n");
   printf("\n");
   printf("    -tmax:<float>   Maximum time of simulation\n");
   printf("    -tout:<float>   Time between output files\n");
   printf("\n");
   printf("    -ftpause:<float> Time to start floating bodies movement. By default 0\n");
+  printf("    -svftseries:<float> Saves binary time series of floating bodies (.tsb)\n");
+  printf("     each <float> seconds (all steps by default)\n");
   printf("    -rhopout:min:max Excludes fluid particles out of these density limits\n");
   printf("    -domain_fixed:xmin:ymin:zmin:xmax:ymax:zmax    The domain is fixed\n");
   printf("     with the specified values\n");
@@ -162,12 +200,37 @@ void JSphCfgRun::VisuInfo()const{
   printf("        info    Information about execution in .ibi4 format (by default)\n");
   printf("        vtk     VTK files\n");
   printf("        csv     CSV files\n");
+  printf("        vtu     VTK XML files with binary data (.vtu or .pvtu)\n");
+  printf("        vtuz    VTK XML files with binary data compressed using zlib\n");
   printf("    -svres:<0/1>     Generates file that summarises the execution process\n");
   printf("    -svtimers:<0/1>  Obtains timing for each individual process\n");
+  printf("    -svprofile:<maxevents>  Profiles regions of the simulation (only on CPU)\n");
+  printf("     and saves summary, histograms per step and Chrome trace-event JSON\n");
+  printf("     with up to <maxevents> events per thread (1000000 by default)\n");
+  printf("    -svhwcounters:<0/1>  Measures performance counters of Linux (cycles,\n");
+  printf("     instructions, LLC misses and vectorisation) for each timer (only on CPU)\n");
+  printf("    -svmemprofile:<mode>  Profiles use of particle arrays (only on CPU)\n");
+  printf("        0  Disabled (default)\n");
+  printf("        1  Reports peak use, spare arrays and arrays that could share memory\n");
+  printf("        2  Also reduces the number of arrays to the used ones in resizes\n");
+  printf("    -telemetry:<socketfile>  Serves the state of the run (step, time, dt,\n");
+  printf("     particles, memory, timers and gauges) as JSON lines on a local Unix\n");
+  printf("     socket, one line for each connection (only on CPU)\n");
   printf("    -svdomainvtk:<0/1>  Generates VTK file with domain limits\n");
 /////////|---------1---------2---------3---------4---------5---------6---------7--------X8
   printf("    -svpips:<mode>:n  Compute PIPS of simulation each n steps (100 by default),\n");
   printf("       mode options: 0=disabled, 1=no save details (by default), 2=save details\n");
+  printf("       On CPU it also shows a performance model with interactions per type,\n");
+  printf("       bytes and arithmetic intensity for cell modes full and half (mode 2\n");
+  printf("       saves PipsModel.csv with results per region of the domain)\n");
+  printf("    -svseries:[formats,...] Output formats of time series (gauges, dt...)\n");
+  printf("        none    No time series files are generated\n");
+  printf("        csv     CSV files (by default)\n");
+  printf("        bin     Binary files by columns (.tsb)\n");
+  printf("    -seriescsv <file.tsb> [<file.csv>]  Converts a binary time series file\n");
+  printf("     to CSV format\n");
+  printf("    -cloudcsv <file.gcb> <point> [<file.csv>]  Converts the time series of\n");
+  printf("     one point of a probe-cloud gauge file to CSV format\n");
   printf("\n");
   printf("    -createdirs:<0/1> Creates full path for output files\n");
   printf("                      (value by default is read from DsphConfig.xml or 1)\n");
@@ -175,6 +238,33 @@ void JSphCfgRun::VisuInfo()const{
   printf("                      (value by default is read from DsphConfig.xml or 0)\n");
   printf("\n");
 
+  printf("  Benchmark options:\n");
+  printf("    -benchmark[:np[:dim]]  Creates a synthetic case (tank with walls) of np\n");
+  printf("     particles (100000 by default) and dimension 2 or 3 (3 by default) without\n");
+  printf("     GenCase and runs some steps to measure throughput. The first parameter\n");
+  printf("     without option is the output directory. Other formulation options\n");
+  printf("     (e.g. -mdbc, -symplectic, -cellmode) are applied to the case\n");
+  printf("    -bmsteps:<uint>     Number of steps of each execution (100 by default)\n");
+  printf("    -bmbound:<float>    Fraction of boundary particles (0.1 by default)\n");
+  printf("    -bmfloating:<0/1>   Adds a floating body to the case (0 by default)\n");
+  printf("    -bmthreads:<list>   Numbers of OpenMP threads separated by commas\n");
+  printf("                        (e.g. 1,2,4,8). By default uses -ompthreads\n");
+  printf("    -bmscaling:<mode>   Scaling test over the list of threads\n");
+  printf("        strong    Same number of particles (by default)\n");
+  printf("        weak      Number of particles proportional to the threads\n");
+  printf("        both      Strong and weak scaling\n");
+  printf("\n");
+
+  printf("  Regression options:\n");
+  printf("    -regression:<file.xml>  Runs the cases defined in the XML file for a fixed\n");
+  printf("     number of steps on CPU and compares the final particle states and the\n");
+  printf("     throughput with the stored references. The first parameter without option\n");
+  printf("     is the output directory. Results are saved in Regression.json and the\n");
+  printf("     exit code is 1 when some case fails\n");
+  printf("    -regupdate[:<0/1>]  Creates or replaces the reference states and the\n");
+  printf("     throughput baseline with the results of this execution\n");
+  printf("\n");
+
   printf("  Debug options:\n");
   printf("    -nsteps:<uint>  Maximum number of steps allowed (debug)\n");
   printf("    -svsteps:<0/1>  Saves a PART for each step (debug)\n");
@@ -198,13 +288,21 @@ void JSphCfgRun::VisuConfig()const{
   fun::PrintVar("  PartBegin",PartBegin,ln);
   fun::PrintVar("  PartBeginFirst",PartBeginFirst,ln);
   fun::PrintVar("  PartBeginDir",PartBeginDir,ln);
+  fun::PrintVar("  CheckpointTime",CheckpointTime,ln);
+  fun::PrintVar("  CheckpointBegin",CheckpointBegin,ln);
+  fun::PrintVar("  CheckpointDelta",CheckpointDelta,ln);
   fun::PrintVar("  Cpu",Cpu,ln);
   printf("  %s  %s\n",fun::VarStr("Gpu",Gpu).c_str(),fun::VarStr("GpuId",GpuId).c_str());
   fun::PrintVar("  GpuFree",GpuFree,ln);
   fun::PrintVar("  Stable",Stable,ln);
   fun::PrintVar("  SvPosDouble",SvPosDouble,ln);
   fun::PrintVar("  OmpThreads",OmpThreads,ln);
+  fun::PrintVar("  OmpAutotune",OmpAutotune,ln);
+  fun::PrintVar("  OmpProfile",OmpProfile,ln);
   fun::PrintVar("  CellMode",GetNameCellMode(CellMode),ln);
+  fun::PrintVar("  CellModeAuto",CellModeAuto,ln);
+  fun::PrintVar("  CellModeTrial",CellModeTrial,ln);
+  fun::PrintVar("  CellModeReeval",CellModeReeval,ln);
   fun::PrintVar("  TStep",TStep,ln);
   fun::PrintVar("  VerletSteps",VerletSteps,ln);
   fun::PrintVar("  TKernel",TKernel,ln);
@@ -216,11 +314,19 @@ void JSphCfgRun::VisuConfig()const{
   fun::PrintVar("  Shifting",Shifting,ln);
   fun::PrintVar("  SvRes",SvRes,ln);
   fun::PrintVar("  SvTimers",SvTimers,ln);
+  fun::PrintVar("  SvProfile",SvProfile,ln);
+  fun::PrintVar("  SvHwCounters",SvHwCounters,ln);
+  fun::PrintVar("  SvMemProfile",SvMemProfile,ln);
+  fun::PrintVar("  Telemetry",Telemetry,ln);
   fun::PrintVar("  SvDomainVtk",SvDomainVtk,ln);
   fun::PrintVar("  Sv_Binx",Sv_Binx,ln);
   fun::PrintVar("  Sv_Info",Sv_Info,ln);
   fun::PrintVar("  Sv_Vtk",Sv_Vtk,ln);
   fun::PrintVar("  Sv_Csv",Sv_Csv,ln);
+  fun::PrintVar("  SvSeriesCsv",SvSeriesCsv,ln);
+  fun::PrintVar("  SvSeriesBin",SvSeriesBin,ln);
+  fun::PrintVar("  Sv_Vtu",Sv_Vtu,ln);
+  fun::PrintVar("  Sv_VtuZip",Sv_VtuZip,ln);
   fun::PrintVar("  RhopOutModif",RhopOutModif,ln);
   if(RhopOutModif){
     fun::PrintVar("  RhopOutMin",RhopOutMin,ln);
@@ -233,6 +339,7 @@ void JSphCfgRun::VisuConfig()const{
     fun::PrintVar("  DomainFixedMax",DomainFixedMax,ln);
   }
   fun::PrintVar("  FtPause",FtPause,ln);
+  fun::PrintVar("  SvFtSeries",SvFtSeries,ln);
 }
 
 //==============================================================================
@@ -249,8 +356,8 @@ void JSphCfgRun::LoadOpts(string *optlis,int optn,int lv,const std::string &file
     }
     else if(opt[0]=='-'){
       //-Splits options in txoptfull, txopt1, txopt2, txopt3 and txopt4.
-      string txword,txoptfull,txopt1,txopt2;
-      SplitsOpts(opt,txword,txoptfull,txopt1,txopt2);
+      string txword,txoptfull,txopt1,txopt2,txopt3;
+      SplitsOpts(opt,txword,txoptfull,txopt1,txopt2,txopt3);
       //-Checks keywords in commands.
       if(txword=="CPU"){ Cpu=true; Gpu=false; }
       else if(txword=="GPU"){ Gpu=true; Cpu=false;
@@ -265,13 +372,27 @@ void JSphCfgRun::LoadOpts(string *optlis,int optn,int lv,const std::string &file
       else if(txword=="OMPTHREADS"){ 
         OmpThreads=atoi(txoptfull.c_str()); if(OmpThreads<0)OmpThreads=0;
       } 
+      else if(txword=="OMPAUTOTUNE"){ 
+        OmpAutotune=(txoptfull!=""? atoi(txoptfull.c_str()): 1);
+        if(OmpAutotune<0 || OmpAutotune>2)ErrorParm(opt,c,lv,file);
+      } 
+      else if(txword=="OMPPROFILE")OmpProfile=txoptfull;
 #endif
       else if(txword=="CELLMODE"){
         bool ok=true;
         if(!txoptfull.empty()){
           txoptfull=fun::StrUpper(txoptfull);
+          txopt1=fun::StrUpper(txopt1);
+          CellModeAuto=false;
           if(txoptfull=="HALF" || txoptfull=="H")CellMode=CELLMODE_Half;
           else if(txoptfull=="FULL" || txoptfull=="2H")CellMode=CELLMODE_Full;
+          else if(txopt1=="AUTO"){
+            CellMode=CELLMODE_Full;
+            CellModeAuto=true;
+            if(!txopt2.empty())CellModeTrial=(unsigned)atoi(txopt2.c_str());
+            if(!txopt3.empty())CellModeReeval=float(atof(txopt3.c_str()));
+            if(CellModeTrial<1 || CellModeReeval<=1.f)ok=false;
+          }
           else ok=false;
         }
         else ok=false;
@@ -323,16 +444,44 @@ void JSphCfgRun::LoadOpts(string *optlis,int optn,int lv,const std::string &file
       }
       else if(txword=="SVRES")SvRes=(txoptfull!=""? atoi(txoptfull.c_str()): 1)!=0;
       else if(txword=="SVTIMERS")SvTimers=(txoptfull!=""? atoi(txoptfull.c_str()): 1)!=0;
+      else if(txword=="SVPROFILE"){
+        const int v=(txoptfull!=""? atoi(txoptfull.c_str()): 1000000);
+        if(v<0)ErrorParm(opt,c,lv,file);
+        else SvProfile=unsigned(v);
+      }
+      else if(txword=="SVHWCOUNTERS")SvHwCounters=(txoptfull!=""? atoi(txoptfull.c_str()): 1)!=0;
+      else if(txword=="SVMEMPROFILE"){
+        const int v=(txoptfull!=""? atoi(txoptfull.c_str()): 1);
+        if(v<0 || v>2)ErrorParm(opt,c,lv,file);
+        else SvMemProfile=unsigned(v);
+      }
+      else if(txword=="TELEMETRY"){
+        if(txoptfull.empty())ErrorParm(opt,c,lv,file);
+        else Telemetry=txoptfull;
+      }
       else if(txword=="SVDOMAINVTK")SvDomainVtk=(txoptfull!=""? atoi(txoptfull.c_str()): 1)!=0;
       else if(txword=="SV"){
         string txop=fun::StrUpper(txoptfull);
         while(!txop.empty()){
           string op=fun::StrSplit(",",txop);
-          if(op=="NONE")Sv_Binx=Sv_Info=Sv_Csv=Sv_Vtk=false;
+          if(op=="NONE")Sv_Binx=Sv_Info=Sv_Csv=Sv_Vtk=Sv_Vtu=Sv_VtuZip=false;
           else if(op=="BINX" || op=="BIN")Sv_Binx=true;
           else if(op=="INFO" || op=="INF")Sv_Info=true;
           else if(op=="VTK")Sv_Vtk=true;
           else if(op=="CSV")Sv_Csv=true;
+          else if(op=="VTU")Sv_Vtu=true;
+          else if(op=="VTUZ")Sv_Vtu=Sv_VtuZip=true;
+          else ErrorParm(opt,c,lv,file);
+        }
+      }
+      else if(txword=="SVSERIES"){
+        string txop=fun::StrUpper(txoptfull);
+        SvSeriesCsv=SvSeriesBin=false;
+        while(!txop.empty()){
+          string op=fun::StrSplit(",",txop);
+          if(op=="NONE")SvSeriesCsv=SvSeriesBin=false;
+          else if(op=="CSV")SvSeriesCsv=true;
+          else if(op=="BIN")SvSeriesBin=true;
           else ErrorParm(opt,c,lv,file);
         }
       }
@@ -352,6 +501,16 @@ void JSphCfgRun::LoadOpts(string *optlis,int optn,int lv,const std::string &file
         }
         PartBeginDir=optlis[c+1]; c++; 
       }
+      else if(txword=="CHECKPOINT"){
+        CheckpointTime=(txoptfull!=""? atof(txoptfull.c_str()): 0);
+        if(CheckpointTime<0)ErrorParm(opt,c,lv,file);
+      }
+      else if(txword=="CHECKPOINTDELTA"){
+        const int v=atoi(txoptfull.c_str());
+        if(v<0)ErrorParm(opt,c,lv,file);
+        else CheckpointDelta=unsigned(v);
+      }
+      else if(txword=="CHECKPOINTBEGIN"&&c+1<optn){ CheckpointBegin=optlis[c+1]; c++; }
       else if(txword=="RHOPOUT"){ 
         RhopOutMin=float(atof(txopt1.c_str())); 
         RhopOutMax=float(atof(txopt2.c_str())); 
@@ -361,6 +520,10 @@ void JSphCfgRun::LoadOpts(string *optlis,int optn,int lv,const std::string &file
         FtPause=float(atof(txoptfull.c_str())); 
         if(FtPause<0)ErrorParm(opt,c,lv,file);
       }
+      else if(txword=="SVFTSERIES"){ 
+        SvFtSeries=(txoptfull!=""? atof(txoptfull.c_str()): 0); 
+        if(SvFtSeries<0)ErrorParm(opt,c,lv,file);
+      }
       else if(txword=="TMAX"){ 
         TimeMax=float(atof(txoptfull.c_str())); 
         if(TimeMax<0)ErrorParm(opt,c,lv,file);
@@ -380,6 +543,34 @@ void JSphCfgRun::LoadOpts(string *optlis,int optn,int lv,const std::string &file
         if(PipsMode>2)ErrorParm(opt,c,lv,file);
         if(!txopt2.empty())PipsSteps=(unsigned)atoi(txopt2.c_str());
       }
+      else if(txword=="BENCHMARK"){
+        BenchNp=(txopt1.empty()? 100000: unsigned(atoi(txopt1.c_str())));
+        const int dim=(txopt2.empty()? 3: atoi(txopt2.c_str()));
+        if(!BenchNp || (dim!=2 && dim!=3))ErrorParm(opt,c,lv,file);
+        BenchSim2D=(dim==2);
+      }
+      else if(txword=="BMSTEPS"){
+        BenchSteps=unsigned(atoi(txoptfull.c_str()));
+        if(!BenchSteps)ErrorParm(opt,c,lv,file);
+      }
+      else if(txword=="BMBOUND"){
+        BenchBoundFrac=float(atof(txoptfull.c_str()));
+        if(BenchBoundFrac<=0 || BenchBoundFrac>=1)ErrorParm(opt,c,lv,file);
+      }
+      else if(txword=="BMFLOATING")BenchFloating=(txoptfull!=""? atoi(txoptfull.c_str()): 1)!=0;
+      else if(txword=="BMTHREADS")BenchThreads=txoptfull;
+      else if(txword=="BMSCALING"){
+        const string tx=fun::StrUpper(txoptfull);
+        if(tx=="STRONG")BenchScaling=1;
+        else if(tx=="WEAK")BenchScaling=2;
+        else if(tx=="BOTH")BenchScaling=3;
+        else ErrorParm(opt,c,lv,file);
+      }
+      else if(txword=="REGRESSION"){
+        if(txoptfull.empty())ErrorParm(opt,c,lv,file);
+        RegDef=txoptfull;
+      }
+      else if(txword=="REGUPDATE")RegUpdate=(txoptfull!=""? atoi(txoptfull.c_str()): 1)!=0;
       else if(txword=="OPT"&&c+1<optn){ LoadFile(optlis[c+1],lv+1); c++; }
       else if(txword=="H"||txword=="HELP"||txword=="?")PrintInfo=true;
       else ErrorParm(opt,c,lv,file);
@@ -43,8 +43,13 @@ public:
   int SvPosDouble;  ///<Saves particle position using double precision (default=0)
 
   int OmpThreads;
+  int OmpAutotune;          ///<Autotuning of OpenMP thresholds and schedules: 0:No (default), 1:Uses machine profile or tunes, 2:Tunes again.
+  std::string OmpProfile;   ///<File with OpenMP profiles of machines (empty:DsOmpProfile.xml next to the executable).
 
   TpCellMode CellMode;
+  bool CellModeAuto;        ///<Selects CellMode automatically during the simulation (only CPU).
+  unsigned CellModeTrial;   ///<Number of measured steps of each timed trial of CellModeAuto (default=10).
+  float CellModeReeval;     ///<Change of particles per cell to repeat the selection of CellModeAuto (default=2).
   int TBoundary;        ///<Boundary method: 0:None, 1:DBC (by default), 2:mDBC (SlipMode: 1:DBC vel=0)
   int SlipMode;         ///<Slip mode for mDBC: 0:None, 1:DBC vel=0, 2:No-slip, 3:Free slip (default=1).
   float MdbcThreshold;  ///<Kernel support limit to apply mDBC correction (default=0).
@@ -59,11 +64,21 @@ public:
   float DDTValue; ///<Value used with Density Diffusion Term (default=0.1)
   int Shifting;   ///<Shifting mode -1:no defined, 0:none, 1:nobound, 2:nofixed, 3:full
   bool SvRes,SvTimers,SvDomainVtk;
+  unsigned SvProfile;  ///<Maximum number of trace events of the profiler of regions (0:disabled).
+  bool SvHwCounters;   ///<Measures performance counters of Linux for each timer (only on CPU).
+  unsigned SvMemProfile;  ///<Profiles use of particle arrays on CPU (0:disabled, 1:report, 2:report and reduces number of arrays in resizes).
+  std::string Telemetry;  ///<Unix socket to serve telemetry of the run as JSON lines (empty:disabled).
   bool Sv_Binx,Sv_Info,Sv_Csv,Sv_Vtk;
+  bool Sv_Vtu,Sv_VtuZip;
+  bool SvSeriesCsv,SvSeriesBin; ///<Output formats of time series (gauges, dt, force points...).
   std::string CaseName,RunName,DirOut,DirDataOut;
   std::string PartBeginDir;
   unsigned PartBegin,PartBeginFirst;
+  double CheckpointTime;        ///<Minimum runtime (in seconds) between checkpoints (-1:disabled, 0:each PART).
+  std::string CheckpointBegin;  ///<Checkpoint file to restart the simulation.
+  unsigned CheckpointDelta;     ///<Number of delta checkpoints after each full checkpoint (0:only full checkpoints).
   float FtPause;
+  double SvFtSeries;  ///<Time between saved steps in binary time series of floating bodies (-1:no defined, 0:all steps).
   bool RhopOutModif;              ///<Indicates whether \ref RhopOutMin or RhopOutMax is changed.
   float RhopOutMin,RhopOutMax;    ///<Limits for \ref RhopOut density correction.
 
@@ -76,6 +91,17 @@ public:
   unsigned PipsMode;   ///<Defines mode of PIPS calculation (0:No computed, 1:Computed (default), 2:computed and save detail).
   unsigned PipsSteps;  ///<Number of steps per interval to compute PIPS (100 by default).
 
+  unsigned BenchNp;          ///<Benchmark mode: number of particles of synthetic case (0:normal execution).
+  bool BenchSim2D;           ///<Benchmark mode: 2D case.
+  float BenchBoundFrac;      ///<Benchmark mode: requested fraction of boundary particles (0.1 by default).
+  bool BenchFloating;        ///<Benchmark mode: case with a floating body.
+  unsigned BenchSteps;       ///<Benchmark mode: number of simulation steps of each execution (100 by default).
+  std::string BenchThreads;  ///<Benchmark mode: list of numbers of OpenMP threads (empty:OmpThreads).
+  byte BenchScaling;         ///<Benchmark mode: scaling tests 1:strong (by default), 2:weak, 3:both.
+
+  std::string RegDef;        ///<Regression mode: XML file with cases, tolerances and reference directory (empty:normal execution).
+  bool RegUpdate;            ///<Regression mode: creates or replaces the reference states and throughput baseline.
+
 public:
   JSphCfgRun();
   void Reset();
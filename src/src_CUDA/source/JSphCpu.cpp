@@ -57,6 +57,11 @@ JSphCpu::JSphCpu(bool withmpi):JSph(true,false,withmpi){
   ClassName="JSphCpu";
   CellDiv=NULL;
   ArraysCpu=new JArraysCpu;
+  Profiler=NULL;
+  HwCounters=NULL;
+  MemProfiler=NULL;
+  MemTighten=false;
+  OmpTuner=NULL;
   InitVars();
   TmcCreation(Timers,false);
 }
@@ -70,6 +75,10 @@ JSphCpu::~JSphCpu(){
   FreeCpuMemoryFixed();
   delete ArraysCpu;
   TmcDestruction(Timers);
+  delete Profiler; Profiler=NULL;
+  delete HwCounters; HwCounters=NULL;
+  delete MemProfiler; MemProfiler=NULL;
+  delete OmpTuner; OmpTuner=NULL;
 }
 
 //==============================================================================
@@ -78,6 +87,8 @@ JSphCpu::~JSphCpu(){
 void JSphCpu::InitVars(){
   RunMode="";
   OmpThreads=1;
+  OmpLimitComputeStep=OMP_LIMIT_COMPUTESTEP;
+  OmpLimitComputeLight=OMP_LIMIT_COMPUTELIGHT;
 
   DivData=DivDataCpuNull();
 
@@ -222,20 +233,24 @@ void JSphCpu::ResizeCpuMemoryParticles(unsigned npnew){
   ArraysCpu->Free(MotionVelc);    //<vs_mddbc>
   //-Resizes CPU memory allocation.
   const double mbparticle=(double(MemCpuParticles)/(1024*1024))/CpuParticlesSize; //-MB por particula.
+  if(MemTighten){
+    const llong mfree=ArraysCpu->TightenArrayCount();
+    if(mfree)Log->Printf("**JSphCpu: Number of arrays is reduced to the used ones (%.1f MB released).",double(mfree)/(1024*1024));
+  }
   Log->Printf("**JSphCpu: Requesting cpu memory for %u particles: %.1f MB.",npnew,mbparticle*npnew);
   ArraysCpu->SetArraySize(npnew);
   //-Reserve pointers.
-  Idpc    =ArraysCpu->ReserveUint();
-  Codec   =ArraysCpu->ReserveTypeCode();
-  Dcellc  =ArraysCpu->ReserveUint();
-  Posc    =ArraysCpu->ReserveDouble3();
-  Velrhopc=ArraysCpu->ReserveFloat4();
-  if(velrhopm1)  VelrhopM1c  =ArraysCpu->ReserveFloat4();
-  if(pospre)     PosPrec     =ArraysCpu->ReserveDouble3();
-  if(velrhoppre) VelrhopPrec =ArraysCpu->ReserveFloat4();
-  if(spstau)     SpsTauc     =ArraysCpu->ReserveSymatrix3f();
-  if(boundnormal)BoundNormalc=ArraysCpu->ReserveFloat3(); //<vs_mddbc>
-  if(motionvel)  MotionVelc  =ArraysCpu->ReserveFloat3(); //<vs_mddbc>
+  Idpc    =ArraysCpu->ReserveUint("Idpc");
+  Codec   =ArraysCpu->ReserveTypeCode("Codec");
+  Dcellc  =ArraysCpu->ReserveUint("Dcellc");
+  Posc    =ArraysCpu->ReserveDouble3("Posc");
+  Velrhopc=ArraysCpu->ReserveFloat4("Velrhopc");
+  if(velrhopm1)  VelrhopM1c  =ArraysCpu->ReserveFloat4("VelrhopM1c");
+  if(pospre)     PosPrec     =ArraysCpu->ReserveDouble3("PosPrec");
+  if(velrhoppre) VelrhopPrec =ArraysCpu->ReserveFloat4("VelrhopPrec");
+  if(spstau)     SpsTauc     =ArraysCpu->ReserveSymatrix3f("SpsTauc");
+  if(boundnormal)BoundNormalc=ArraysCpu->ReserveFloat3("BoundNormalc"); //<vs_mddbc>
+  if(motionvel)  MotionVelc  =ArraysCpu->ReserveFloat3("MotionVelc"); //<vs_mddbc>
   //-Restore data in CPU memory.
   RestoreArrayCpu(Np,idp,Idpc);
   RestoreArrayCpu(Np,code,Codec);
@@ -283,16 +298,16 @@ template<class T> void JSphCpu::TRestoreArrayCpu(unsigned np,T *data,T *datanew)
 /// Arrays para datos basicos de las particulas. 
 //==============================================================================
 void JSphCpu::ReserveBasicArraysCpu(){
-  Idpc=ArraysCpu->ReserveUint();
-  Codec=ArraysCpu->ReserveTypeCode();
-  Dcellc=ArraysCpu->ReserveUint();
-  Posc=ArraysCpu->ReserveDouble3();
-  Velrhopc=ArraysCpu->ReserveFloat4();
-  if(TStep==STEP_Verlet)VelrhopM1c=ArraysCpu->ReserveFloat4();
-  if(TVisco==VISCO_LaminarSPS)SpsTauc=ArraysCpu->ReserveSymatrix3f();
+  Idpc=ArraysCpu->ReserveUint("Idpc");
+  Codec=ArraysCpu->ReserveTypeCode("Codec");
+  Dcellc=ArraysCpu->ReserveUint("Dcellc");
+  Posc=ArraysCpu->ReserveDouble3("Posc");
+  Velrhopc=ArraysCpu->ReserveFloat4("Velrhopc");
+  if(TStep==STEP_Verlet)VelrhopM1c=ArraysCpu->ReserveFloat4("VelrhopM1c");
+  if(TVisco==VISCO_LaminarSPS)SpsTauc=ArraysCpu->ReserveSymatrix3f("SpsTauc");
   if(UseNormals){ //<vs_mddbc_ini>
-    BoundNormalc=ArraysCpu->ReserveFloat3();
-    if(SlipMode!=SLIP_Vel0)MotionVelc=ArraysCpu->ReserveFloat3();
+    BoundNormalc=ArraysCpu->ReserveFloat3("BoundNormalc");
+    if(SlipMode!=SLIP_Vel0)MotionVelc=ArraysCpu->ReserveFloat3("MotionVelc");
   } //<vs_mddbc_end>
 }
 
@@ -352,7 +367,7 @@ unsigned JSphCpu::GetParticlesData(unsigned n,unsigned pini,bool onlynormal
     if(!idp || !pos || !vel || !rhop)Run_Exceptioon("Pointers without data.");
     typecode *code2=code;
     if(!code2){
-      code2=ArraysCpu->ReserveTypeCode();
+      code2=ArraysCpu->ReserveTypeCode("code2");
       memcpy(code2,Codec+pini,sizeof(typecode)*n);
     }
     unsigned ndel=0;
@@ -392,6 +407,18 @@ void JSphCpu::ConfigOmp(const JSphCfgRun *cfg){
     OmpThreads=1;
     omp_set_num_threads(OmpThreads);
   }
+  //-Autotuning of thresholds and schedules of OpenMP.
+  JDsOmpTuner::SetScheduleDefault();
+  delete OmpTuner; OmpTuner=NULL;
+  if(cfg->OmpAutotune){
+    if(OmpThreads>1){
+      OmpTuner=new JDsOmpTuner(OmpThreads,cfg->OmpProfile,Log);
+      OmpTuner->Config(cfg->OmpAutotune==2);
+      OmpLimitComputeStep=int(OmpTuner->GetLimit(OLIM_ComputeStep));
+      OmpLimitComputeLight=int(OmpTuner->GetLimit(OLIM_ComputeLight));
+    }
+    else Log->PrintWarning("OpenMP autotuning is ignored for execution with one thread.");
+  }
 #else
   OmpThreads=1;
 #endif
@@ -452,7 +479,7 @@ void JSphCpu::PreInteractionVars_Forces(unsigned np,unsigned npb){
   //-Prepare press values for interaction.
   const int n=int(np);
   #ifdef OMP_USE
-    #pragma omp parallel for schedule (static) if(n>OMP_LIMIT_COMPUTELIGHT)
+    #pragma omp parallel for schedule (static) if(n>OmpLimitComputeLight)
   #endif
   for(int p=0;p<n;p++){
     Pressc[p]=fsph::ComputePress(Velrhopc[p].w,CSP);
@@ -466,12 +493,12 @@ void JSphCpu::PreInteractionVars_Forces(unsigned np,unsigned npb){
 void JSphCpu::PreInteraction_Forces(){
   TmcStart(Timers,TMC_CfPreForces);
   //-Assign memory.
-  Arc=ArraysCpu->ReserveFloat();
-  Acec=ArraysCpu->ReserveFloat3();
-  if(DDTArray)Deltac=ArraysCpu->ReserveFloat();
-  if(Shifting)ShiftPosfsc=ArraysCpu->ReserveFloat4();
-  Pressc=ArraysCpu->ReserveFloat();
-  if(TVisco==VISCO_LaminarSPS)SpsGradvelc=ArraysCpu->ReserveSymatrix3f();
+  Arc=ArraysCpu->ReserveFloat("Arc");
+  Acec=ArraysCpu->ReserveFloat3("Acec");
+  if(DDTArray)Deltac=ArraysCpu->ReserveFloat("Deltac");
+  if(Shifting)ShiftPosfsc=ArraysCpu->ReserveFloat4("ShiftPosfsc");
+  Pressc=ArraysCpu->ReserveFloat("Pressc");
+  if(TVisco==VISCO_LaminarSPS)SpsGradvelc=ArraysCpu->ReserveSymatrix3f("SpsGradvelc");
 
   //-Initialise arrays.
   PreInteractionVars_Forces(Np,Npb);
@@ -505,7 +532,7 @@ float JSphCpu::CalcVelMaxSeq(unsigned np,const tfloat4* velrhop)const{
 float JSphCpu::CalcVelMaxOmp(unsigned np,const tfloat4* velrhop)const{
   float velmax=0;
   #ifdef OMP_USE
-    if(np>OMP_LIMIT_COMPUTELIGHT){
+    if(int(np)>OmpLimitComputeLight){
       const int n=int(np);
       if(n<0)Run_Exceptioon("Number of values is too big.");
       float vmax=0;
@@ -554,18 +581,28 @@ void JSphCpu::PosInteraction_Forces(){
 template<TpKernel tker,TpFtMode ftmode> void JSphCpu::InteractionForcesBound
   (unsigned n,unsigned pinit,StDivDataCpu divdata,const unsigned *dcell
   ,const tdouble3 *pos,const tfloat4 *velrhop,const typecode *code,const unsigned *idp
-  ,float &viscdt,float *ar)const
+  ,float &viscdt,float *ar,const StPipsSampleCpu *pipss)const
 {
   //-Initialize viscth to calculate max viscdt with OpenMP. | Inicializa viscth para calcular visdt maximo con OpenMP.
   float viscth[OMP_MAXTHREADS*OMP_STRIDE];
   for(int th=0;th<OmpThreads;th++)viscth[th*OMP_STRIDE]=0;
   //-Starts execution using OpenMP.
   const int pfin=int(pinit+n);
+  if(OmpTuner)OmpTuner->LoopStart(OLOOP_ForcesBound,n);
   #ifdef OMP_USE
-    #pragma omp parallel for schedule (guided)
+    #pragma omp parallel
   #endif
+  {
+    TprThread();
+    ullong *pipsth=PipsThreadCounts(pipss,omp_get_thread_num());
+    #ifdef OMP_USE_RUNTIMESCHED
+      #pragma omp for schedule (runtime) nowait
+    #elif defined(OMP_USE)
+      #pragma omp for schedule (guided) nowait
+    #endif
   for(int p1=int(pinit);p1<pfin;p1++){
     float visc=0,arp1=0;
+    unsigned npic=0,npir=0; //-Checked and real interactions for PIPS.
 
     //-Load data of particle p1. | Carga datos de particula p1.
     const tdouble3 posp1=pos[p1];
@@ -576,6 +613,7 @@ template<TpKernel tker,TpFtMode ftmode> void JSphCpu::InteractionForcesBound
     const StNgSearch ngs=nsearch::Init(dcell[p1],false,divdata);
     for(int z=ngs.zini;z<ngs.zfin;z++)for(int y=ngs.yini;y<ngs.yfin;y++){
       const tuint2 pif=nsearch::ParticleRange(y,z,ngs,divdata);
+      npic+=pif.y-pif.x;
 
       //-Interaction of boundary with type Fluid/Float | Interaccion de Bound con varias Fluid/Float.
       //---------------------------------------------------------------------------------------------
@@ -587,6 +625,7 @@ template<TpKernel tker,TpFtMode ftmode> void JSphCpu::InteractionForcesBound
         const float drz=float(posp1.z-pos[p2].z);
         const float rr2=drx*drx+dry*dry+drz*drz;
         if(rr2<=KernelSize2 && rr2>=ALMOSTZERO){
+          npir++;
           //-Computes kernel.
           const float fac=fsph::GetKernel_Fac<tker>(CSP,rr2);
           const float frx=fac*drx,fry=fac*dry,frz=fac*drz; //-Gradients.
@@ -619,6 +658,7 @@ template<TpKernel tker,TpFtMode ftmode> void JSphCpu::InteractionForcesBound
         else rsym=false;                                            //<vs_syymmetry>
       }
     }
+    if(pipsth)PipsAddCounts(pipss,pipsth,posp1,PIPSK_BoundFluid,npic,npir,unsigned((ngs.zfin-ngs.zini)*(ngs.yfin-ngs.yini)));
     //-Sum results together. | Almacena resultados.
     if(arp1||visc){
       ar[p1]+=arp1;
@@ -626,6 +666,8 @@ template<TpKernel tker,TpFtMode ftmode> void JSphCpu::InteractionForcesBound
       if(visc>viscth[th*OMP_STRIDE])viscth[th*OMP_STRIDE]=visc;
     }
   }
+  }
+  if(OmpTuner)OmpTuner->LoopEnd(OLOOP_ForcesBound);
   //-Keep max value in viscdt. | Guarda en viscdt el valor maximo.
   for(int th=0;th<OmpThreads;th++)if(viscdt<viscth[th*OMP_STRIDE])viscdt=viscth[th*OMP_STRIDE];
 }
@@ -641,18 +683,28 @@ template<TpKernel tker,TpFtMode ftmode,TpVisco tvisco,TpDensity tdensity,bool sh
   ,const tdouble3 *pos,const tfloat4 *velrhop,const typecode *code,const unsigned *idp
   ,const float *press 
   ,float &viscdt,float *ar,tfloat3 *ace,float *delta
-  ,TpShifting shiftmode,tfloat4 *shiftposfs)const
+  ,TpShifting shiftmode,tfloat4 *shiftposfs,const StPipsSampleCpu *pipss)const
 {
   //-Initialize viscth to calculate viscdt maximo con OpenMP. | Inicializa viscth para calcular visdt maximo con OpenMP.
   float viscth[OMP_MAXTHREADS*OMP_STRIDE];
   for(int th=0;th<OmpThreads;th++)viscth[th*OMP_STRIDE]=0;
   //-Initialise execution with OpenMP. | Inicia ejecucion con OpenMP.
   const int pfin=int(pinit+n);
+  if(OmpTuner)OmpTuner->LoopStart((boundp2? OLOOP_ForcesFluidBound: OLOOP_ForcesFluid),n);
   #ifdef OMP_USE
-    #pragma omp parallel for schedule (guided)
+    #pragma omp parallel
   #endif
+  {
+    TprThread();
+    ullong *pipsth=PipsThreadCounts(pipss,omp_get_thread_num());
+    #ifdef OMP_USE_RUNTIMESCHED
+      #pragma omp for schedule (runtime) nowait
+    #elif defined(OMP_USE)
+      #pragma omp for schedule (guided) nowait
+    #endif
   for(int p1=int(pinit);p1<pfin;p1++){
     float visc=0,arp1=0,deltap1=0;
+    unsigned npic=0,npir=0; //-Checked and real interactions for PIPS.
     tfloat3 acep1=TFloat3(0);
     tsymatrix3f gradvelp1={0,0,0,0,0,0};
 
@@ -680,6 +732,7 @@ template<TpKernel tker,TpFtMode ftmode,TpVisco tvisco,TpDensity tdensity,bool sh
     const StNgSearch ngs=nsearch::Init(dcell[p1],boundp2,divdata);
     for(int z=ngs.zini;z<ngs.zfin;z++)for(int y=ngs.yini;y<ngs.yfin;y++){
       const tuint2 pif=nsearch::ParticleRange(y,z,ngs,divdata);
+      npic+=pif.y-pif.x;
 
       //-Interaction of Fluid with type Fluid or Bound. | Interaccion de Fluid con varias Fluid o Bound.
       //------------------------------------------------------------------------------------------------
@@ -691,6 +744,7 @@ template<TpKernel tker,TpFtMode ftmode,TpVisco tvisco,TpDensity tdensity,bool sh
         const float drz=float(posp1.z-pos[p2].z);
         const float rr2=drx*drx+dry*dry+drz*drz;
         if(rr2<=KernelSize2 && rr2>=ALMOSTZERO){
+          npir++;
           //-Computes kernel.
           const float fac=fsph::GetKernel_Fac<tker>(CSP,rr2);
           const float frx=fac*drx,fry=fac*dry,frz=fac*drz; //-Gradients.
@@ -802,6 +856,7 @@ template<TpKernel tker,TpFtMode ftmode,TpVisco tvisco,TpDensity tdensity,bool sh
         else rsym=false;                                            //<vs_syymmetry>
       }
     }
+    if(pipsth)PipsAddCounts(pipss,pipsth,posp1,(boundp2? PIPSK_FluidBound: PIPSK_FluidFluid),npic,npir,unsigned((ngs.zfin-ngs.zini)*(ngs.yfin-ngs.yini)));
     //-Sum results together. | Almacena resultados.
     if(shift||arp1||acep1.x||acep1.y||acep1.z||visc){
       if(tdensity!=DDT_None){
@@ -823,6 +878,8 @@ template<TpKernel tker,TpFtMode ftmode,TpVisco tvisco,TpDensity tdensity,bool sh
       if(shift)shiftposfs[p1]=shiftposfsp1;
     }
   }
+  }
+  if(OmpTuner)OmpTuner->LoopEnd(boundp2? OLOOP_ForcesFluidBound: OLOOP_ForcesFluid);
   //-Keep max value in viscdt. | Guarda en viscdt el valor maximo.
   for(int th=0;th<OmpThreads;th++)if(viscdt<viscth[th*OMP_STRIDE])viscdt=viscth[th*OMP_STRIDE];
 }
@@ -842,7 +899,10 @@ void JSphCpu::InteractionForcesDEM(unsigned nfloat,StDivDataCpu divdata,const un
   for(int th=0;th<OmpThreads;th++)demdtth[th*OMP_STRIDE]=-FLT_MAX;
   //-Initialise execution with OpenMP. | Inicia ejecucion con OpenMP.
   const int nft=int(nfloat);
-  #ifdef OMP_USE
+  if(OmpTuner)OmpTuner->LoopStart(OLOOP_ForcesDem,nfloat);
+  #ifdef OMP_USE_RUNTIMESCHED
+    #pragma omp parallel for schedule (runtime)
+  #elif defined(OMP_USE)
     #pragma omp parallel for schedule (guided)
   #endif
   for(int cf=0;cf<nft;cf++){
@@ -924,6 +984,7 @@ void JSphCpu::InteractionForcesDEM(unsigned nfloat,StDivDataCpu divdata,const un
       }
     }
   }
+  if(OmpTuner)OmpTuner->LoopEnd(OLOOP_ForcesDem);
   //-Update viscdt with max value of viscdt or demdt* | Actualiza viscdt con el valor maximo de viscdt y demdt*.
   float demdt=demdtth[0];
   for(int th=1;th<OmpThreads;th++)if(demdt<demdtth[th*OMP_STRIDE])demdt=demdtth[th*OMP_STRIDE];
@@ -969,25 +1030,34 @@ template<TpKernel tker,TpFtMode ftmode,TpVisco tvisco,TpDensity tdensity,bool sh
   float viscdt=res.viscdt;
   if(t.npf){
     //-Interaction Fluid-Fluid.
+    TprStart("Fluid-Fluid");
     InteractionForcesFluid<tker,ftmode,tvisco,tdensity,shift> (t.npf,t.npb,false,Visco                 
       ,t.divdata,t.dcell,t.spstau,t.spsgradvel,t.pos,t.velrhop,t.code,t.idp,t.press
-      ,viscdt,t.ar,t.ace,t.delta,t.shiftmode,t.shiftposfs);
+      ,viscdt,t.ar,t.ace,t.delta,t.shiftmode,t.shiftposfs,t.pipss);
+    TprStop("Fluid-Fluid");
     //-Interaction Fluid-Bound.
+    TprStart("Fluid-Bound");
     InteractionForcesFluid<tker,ftmode,tvisco,tdensity,shift> (t.npf,t.npb,true ,Visco*ViscoBoundFactor
       ,t.divdata,t.dcell,t.spstau,t.spsgradvel,t.pos,t.velrhop,t.code,t.idp,t.press
-      ,viscdt,t.ar,t.ace,t.delta,t.shiftmode,t.shiftposfs);
+      ,viscdt,t.ar,t.ace,t.delta,t.shiftmode,t.shiftposfs,t.pipss);
+    TprStop("Fluid-Bound");
 
     //-Interaction of DEM Floating-Bound & Floating-Floating. //(DEM)
-    if(UseDEM)InteractionForcesDEM(CaseNfloat,t.divdata,t.dcell
-      ,FtRidp,DemData,t.pos,t.velrhop,t.code,t.idp,viscdt,t.ace);
+    if(UseDEM){
+      TprScope("DEM");
+      InteractionForcesDEM(CaseNfloat,t.divdata,t.dcell
+        ,FtRidp,DemData,t.pos,t.velrhop,t.code,t.idp,viscdt,t.ace);
+    }
 
     //-Computes tau for Laminar+SPS.
     if(tvisco==VISCO_LaminarSPS)ComputeSpsTau(t.npf,t.npb,t.velrhop,t.spsgradvel,t.spstau);
   }
   if(t.npbok){
     //-Interaction Bound-Fluid.
+    TprStart("Bound-Fluid");
     InteractionForcesBound<tker,ftmode> (t.npbok,0,t.divdata,t.dcell
-      ,t.pos,t.velrhop,t.code,t.idp,viscdt,t.ar);
+      ,t.pos,t.velrhop,t.code,t.idp,viscdt,t.ar,t.pipss);
+    TprStop("Bound-Fluid");
   }
   res.viscdt=viscdt;
 }
@@ -1311,7 +1381,7 @@ void JSphCpu::ComputeVerletVarsFluid(bool shift,
   const tdouble3 gravity=ToTDouble3(Gravity);
   const int pini=int(Npb),pfin=int(Np),npf=int(Np-Npb);
   #ifdef OMP_USE
-    #pragma omp parallel for schedule (static) if(npf>OMP_LIMIT_COMPUTESTEP)
+    #pragma omp parallel for schedule (static) if(npf>OmpLimitComputeStep)
   #endif
   for(int p=pini;p<pfin;p++){
     //-Calculate density. | Calcula densidad.
@@ -1363,7 +1433,7 @@ void JSphCpu::ComputeVerletVarsFluid(bool shift,
 void JSphCpu::ComputeVelrhopBound(const tfloat4* velrhopold,double armul,tfloat4* velrhopnew)const{
   const int npb=int(Npb);
   #ifdef OMP_USE
-    #pragma omp parallel for schedule (static) if(npb>OMP_LIMIT_COMPUTESTEP)
+    #pragma omp parallel for schedule (static) if(npb>OmpLimitComputeStep)
   #endif
   for(int p=0;p<npb;p++){
     const float rhopnew=float(double(velrhopold[p].w)+armul*Arc[p]);
@@ -1402,8 +1472,8 @@ void JSphCpu::ComputeSymplecticPre(double dt){
   TmcStart(Timers,TMC_SuComputeStep);
   const bool shift=false; //(ShiftingMode!=SHIFT_None); //-We strongly recommend running the shifting correction only for the corrector. If you want to re-enable shifting in the predictor, change the value here to "true".
   //-Assign memory to variables Pre. | Asigna memoria a variables Pre.
-  PosPrec=ArraysCpu->ReserveDouble3();
-  VelrhopPrec=ArraysCpu->ReserveFloat4();
+  PosPrec=ArraysCpu->ReserveDouble3("PosPrec");
+  VelrhopPrec=ArraysCpu->ReserveFloat4("VelrhopPrec");
   //-Change data to variables Pre to calculate new data. | Cambia datos a variables Pre para calcular nuevos datos.
   swap(PosPrec,Posc);         //Put value of Pos[] in PosPre[].         | Es decir... PosPre[] <= Pos[].
   swap(VelrhopPrec,Velrhopc); //Put value of Velrhop[] in VelrhopPre[]. | Es decir... VelrhopPre[] <= Velrhop[].
@@ -1413,7 +1483,7 @@ void JSphCpu::ComputeSymplecticPre(double dt){
   //-Calculate new density for boundary and copy velocity. | Calcula nueva densidad para el contorno y copia velocidad.
   const int npb=int(Npb);
   #ifdef OMP_USE
-    #pragma omp parallel for schedule (static) if(npb>OMP_LIMIT_COMPUTESTEP)
+    #pragma omp parallel for schedule (static) if(npb>OmpLimitComputeStep)
   #endif
   for(int p=0;p<npb;p++){
     const tfloat4 vr=VelrhopPrec[p];
@@ -1424,7 +1494,7 @@ void JSphCpu::ComputeSymplecticPre(double dt){
   //-Calculate new values of fluid. | Calcula nuevos datos del fluido.
   const int np=int(Np);
   #ifdef OMP_USE
-    #pragma omp parallel for schedule (static) if(np>OMP_LIMIT_COMPUTESTEP)
+    #pragma omp parallel for schedule (static) if(np>OmpLimitComputeStep)
   #endif
   for(int p=npb;p<np;p++){
     //-Calculate density.
@@ -1480,7 +1550,7 @@ void JSphCpu::ComputeSymplecticCorr(double dt){
   //-Calculate rhop of boudary and set velocity=0. | Calcula rhop de contorno y vel igual a cero.
   const int npb=int(Npb);
   #ifdef OMP_USE
-    #pragma omp parallel for schedule (static) if(npb>OMP_LIMIT_COMPUTESTEP)
+    #pragma omp parallel for schedule (static) if(npb>OmpLimitComputeStep)
   #endif
   for(int p=0;p<npb;p++){
     const double epsilon_rdot=(-double(Arc[p])/double(Velrhopc[p].w))*dt;
@@ -1492,7 +1562,7 @@ void JSphCpu::ComputeSymplecticCorr(double dt){
   const double dt05=dt*.5;
   const int np=int(Np);
   #ifdef OMP_USE
-    #pragma omp parallel for schedule (static) if(np>OMP_LIMIT_COMPUTESTEP)
+    #pragma omp parallel for schedule (static) if(np>OmpLimitComputeStep)
   #endif
   for(int p=npb;p<np;p++){
     const double epsilon_rdot=(-double(Arc[p])/double(Velrhopc[p].w))*dt;
@@ -1598,7 +1668,7 @@ void JSphCpu::CalcRidp(bool periactive,unsigned np,unsigned pini,unsigned idini,
   const int pfin=int(pini+np);
   if(periactive){//-Calculate position according to id checking that the particles are normal (i.e. not periodic). | Calcula posicion segun id comprobando que las particulas son normales (no periodicas).
     #ifdef OMP_USE
-      #pragma omp parallel for schedule (static) if(pfin>OMP_LIMIT_COMPUTELIGHT)
+      #pragma omp parallel for schedule (static) if(pfin>OmpLimitComputeLight)
     #endif
     for(int p=int(pini);p<pfin;p++){
       const unsigned id=idp[p];
@@ -1609,7 +1679,7 @@ void JSphCpu::CalcRidp(bool periactive,unsigned np,unsigned pini,unsigned idini,
   }
   else{//-Calculate position according to id assuming that all the particles are normal (i.e. not periodic). | Calcula posicion segun id suponiendo que todas las particulas son normales (no periodicas).
     #ifdef OMP_USE
-      #pragma omp parallel for schedule (static) if(pfin>OMP_LIMIT_COMPUTELIGHT)
+      #pragma omp parallel for schedule (static) if(pfin>OmpLimitComputeLight)
     #endif
     for(int p=int(pini);p<pfin;p++){
       const unsigned id=idp[p];
@@ -1855,6 +1925,51 @@ void JSphCpu::ShowTimers(bool onlyfile){
   else for(unsigned c=0;c<TimerGetCount();c++)if(TimerIsActive(c))Log->Print(TimerToText(c),mode);
 }
 
+//==============================================================================
+/// Opens performance counters of Linux for each OpenMP thread and assigns
+/// them to the timers. When they are not available (e.g. in containers) the
+/// execution continues without counters.
+//==============================================================================
+void JSphCpu::ConfigHwCounters(){
+  delete HwCounters; HwCounters=NULL;
+  HwCounters=new JHwCounters(Log);
+  if(HwCounters->Config(OmpThreads)){
+    for(unsigned ct=0;ct<TMC_COUNT;ct++)HwCounters->AddRegion(ct,TmcGetName(CsTypeTimerCPU(ct)));
+    HwCounters->SetActive(true);
+    if(!HwCounters->GetAvailableHw())Log->PrintfWarning("Hardware performance counters are not available (%s), so only software counters are measured.",HwCounters->GetErrorHw().c_str());
+  }
+  else{
+    Log->PrintfWarning("Performance counters of Linux are not available (%s), so they are not measured.",HwCounters->GetErrorHw().c_str());
+    delete HwCounters; HwCounters=NULL;
+  }
+}
+
+//==============================================================================
+/// Shows values of performance counters for each timer and for each particle
+/// interaction (PIPS) and saves them in CSV file.
+//==============================================================================
+void JSphCpu::ShowHwCounters(){
+  HwCounters->SetActive(false);
+  HwCounters->VisuSummary("[Performance counters]");
+  //-Values per particle interaction of CF-Forces.
+  const double pis=(DsPips? DsPips->GetTotalGPIs()*1.e9: 0);
+  if(pis>0 && HwCounters->GetCalls(TMC_CfForces)){
+    const unsigned ct=TMC_CfForces;
+    string tx;
+    if(HwCounters->GetAvailable(HWC_Cycles))tx=tx+fun::PrintStr("  %.2f cycles",HwCounters->GetValue(ct,HWC_Cycles)/pis);
+    if(HwCounters->GetAvailable(HWC_Instructions))tx=tx+fun::PrintStr("  %.2f instructions",HwCounters->GetValue(ct,HWC_Instructions)/pis);
+    if(HwCounters->GetAvailable(HWC_LlcMisses))tx=tx+fun::PrintStr("  %.2f bytes from memory",HwCounters->GetValue(ct,HWC_LlcMisses)*JHwCounters::CACHELINE/pis);
+    if(HwCounters->GetAvailable(HWC_TaskClock))tx=tx+fun::PrintStr("  %.2f ns of CPU",HwCounters->GetValue(ct,HWC_TaskClock)/pis);
+    if(DsPips->GetNumSamples()){
+      double chk,real,range,bytes;
+      DsPips->GetModelCellMode(CellMode,chk,real,range,bytes);
+      if(real)tx=tx+fun::PrintStr("  (model: %.2f bytes read)",bytes/real);
+    }
+    Log->Printf("  Per interaction in %s:%s",TmcGetName(TMC_CfForces),tx.c_str());
+  }
+  HwCounters->SaveCsv(DirOut+"HwCounters.csv",CsvSepComa);
+}
+
 //==============================================================================
 /// Return string with names and values of active timers.
 /// Devuelve string con nombres y valores de los timers activos.
@@ -24,7 +24,9 @@
 #include "DualSphDef.h"
 #include "JSphTimersCpu.h"
 #include "JCellDivDataCpu.h"
+#include "JDsPips.h"
 #include "JSph.h"
+#include "JDsOmpTuner.h"
 #include <string>
 
 
@@ -45,6 +47,7 @@ typedef struct{
   tfloat4 *shiftposfs;
   tsymatrix3f *spstau;
   tsymatrix3f *spsgradvel;
+  const StPipsSampleCpu *pipss; ///<Counters of interactions for PIPS (NULL: disabled).
 }stinterparmsc;
 
 ///Collects parameters for particle interaction on CPU.
@@ -55,6 +58,7 @@ inline stinterparmsc StInterparmsc(unsigned np,unsigned npb,unsigned npbok
   ,float* ar,tfloat3 *ace,float *delta
   ,TpShifting shiftmode,tfloat4 *shiftposfs
   ,tsymatrix3f *spstau,tsymatrix3f *spsgradvel
+  ,const StPipsSampleCpu *pipss=NULL
 )
 {
   stinterparmsc d={np,npb,npbok,(np-npb)
@@ -64,6 +68,7 @@ inline stinterparmsc StInterparmsc(unsigned np,unsigned npb,unsigned npbok
     ,ar,ace,delta
     ,shiftmode,shiftposfs
     ,spstau,spsgradvel
+    ,pipss
   };
   return(d);
 }
@@ -91,6 +96,9 @@ private:
 
 protected:
   int OmpThreads;       ///<Max number of OpenMP threads in execution on CPU host (minimum 1). | Numero maximo de hilos OpenMP en ejecucion por host en CPU (minimo 1).
+  int OmpLimitComputeStep;        ///<Minimum number of particles for parallel execution in ComputeStep (OMP_LIMIT_COMPUTESTEP by default).
+  int OmpLimitComputeLight;       ///<Minimum number of particles for parallel execution of light loops (OMP_LIMIT_COMPUTELIGHT by default).
+  JDsOmpTuner *OmpTuner;          ///<Autotuning of OpenMP thresholds and schedules (NULL: disabled).
 
   StDivDataCpu DivData; ///<Current data of cell division for neighborhood search on CPU.
 
@@ -157,6 +165,10 @@ protected:
   tsymatrix3f *SpsGradvelc;   ///<Velocity gradients.
 
   TimersCpu Timers;
+  JTraceProfiler *Profiler;   ///<Profiler of regions (NULL: disabled).
+  JHwCounters *HwCounters;    ///<Performance counters for each timer (NULL: disabled).
+  JArraysCpuProfiler *MemProfiler;  ///<Profiler of use of ArraysCpu (NULL: disabled).
+  bool MemTighten;            ///<Reduces the number of arrays of ArraysCpu to the used ones in resizes (after the first step).
 
 
   void InitVars();
@@ -214,7 +226,7 @@ protected:
   template<TpKernel tker,TpFtMode ftmode> void InteractionForcesBound
     (unsigned n,unsigned pini,StDivDataCpu divdata,const unsigned *dcell
     ,const tdouble3 *pos,const tfloat4 *velrhop,const typecode *code,const unsigned *id
-    ,float &viscdt,float *ar)const;
+    ,float &viscdt,float *ar,const StPipsSampleCpu *pipss)const;
 
   template<TpKernel tker,TpFtMode ftmode,TpVisco tvisco,TpDensity tdensity,bool shift> 
     void InteractionForcesFluid(unsigned n,unsigned pini,bool boundp2,float visco
@@ -223,7 +235,7 @@ protected:
     ,const tdouble3 *pos,const tfloat4 *velrhop,const typecode *code,const unsigned *idp
     ,const float *press
     ,float &viscdt,float *ar,tfloat3 *ace,float *delta
-    ,TpShifting shiftmode,tfloat4 *shiftposfs)const;
+    ,TpShifting shiftmode,tfloat4 *shiftposfs,const StPipsSampleCpu *pipss)const;
 
   void InteractionForcesDEM(unsigned nfloat,StDivDataCpu divdata,const unsigned *dcell
     ,const unsigned *ftridp,const StDemData* demobjs
@@ -285,6 +297,8 @@ protected:
   //<vs_mlapiston_end>
 
   void ShowTimers(bool onlyfile=false);
+  void ConfigHwCounters();
+  void ShowHwCounters();
   void GetTimersInfo(std::string &hinfo,std::string &dinfo)const;
   unsigned TimerGetCount()const{ return(TmcGetCount()); }
   bool TimerIsActive(unsigned ct)const{ return(TmcIsActive(Timers,(CsTypeTimerCPU)ct)); }
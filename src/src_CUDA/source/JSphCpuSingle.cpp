@@ -42,6 +42,14 @@
 #include "JDataArrays.h"
 #include "JSphShifting.h"
 #include "JDsPips.h"
+#include "JDsOutputParts.h"
+#include "JDsGridStats.h"
+#include "JDsFreeSurface.h"
+#include "JDsSurfaceLoads.h"
+#include "JDsFtSeries.h"
+#include "JDsCheckpoint.h"
+#include "JDsCellModeAuto.h"
+#include "JDsTelemetry.h"
 
 #include <climits>
 
@@ -52,6 +60,9 @@ using namespace std;
 JSphCpuSingle::JSphCpuSingle():JSphCpu(false){
   ClassName="JSphCpuSingle";
   CellDivSingle=NULL;
+  CheckpointChain=NULL;
+  CellModeAuto=NULL;
+  Telemetry=NULL;
 }
 
 //==============================================================================
@@ -60,6 +71,9 @@ JSphCpuSingle::JSphCpuSingle():JSphCpu(false){
 JSphCpuSingle::~JSphCpuSingle(){
   DestructorActive=true;
   delete CellDivSingle; CellDivSingle=NULL;
+  delete CheckpointChain; CheckpointChain=NULL;
+  delete CellModeAuto; CellModeAuto=NULL;
+  delete Telemetry; Telemetry=NULL;
 }
 
 //==============================================================================
@@ -94,6 +108,15 @@ void JSphCpuSingle::LoadConfig(JSphCfgRun *cfg){
   ConfigOmp(cfg);
   //-Load basic general configuraction. | Carga configuracion basica general.
   JSph::LoadConfig(cfg);
+  //-Automatic selection of CellMode.
+  delete CellModeAuto; CellModeAuto=NULL;
+  if(cfg->CellModeAuto){
+    if(InOut)Log->PrintWarning("Automatic selection of CellMode is not available with Inlet/Outlet conditions, so CellMode Full is used.");  //<vs_innlet>
+    else{                                                                                                                                  //<vs_innlet>
+      CellModeAuto=new JDsCellModeAuto(Simulate2D,cfg->CellModeTrial,cfg->CellModeReeval,Log);
+      CellModeAuto->Config(CellMode);
+    }                                                                                                                                      //<vs_innlet>
+  }
   //-Checks compatibility of selected options.
   Log->Print("**Special case configuration is loaded");
 }
@@ -166,6 +189,58 @@ void JSphCpuSingle::ConfigDomain(){
   RunCellDivide(true);
 }
 
+//==============================================================================
+/// Changes CellMode and configures cell size, local domain and cell division
+/// object for the new mode. Objects depending on the cells are also updated.
+/// The cells of particles are not computed.
+///
+/// Cambia CellMode y configura tamanho de celda, dominio local y objeto de
+/// division en celdas para el nuevo modo.
+//==============================================================================
+void JSphCpuSingle::ConfigCellMode(TpCellMode cellmode){
+  CellMode=cellmode;
+  ConfigCellSize();
+  SelecDomain(TUint3(0,0,0),Map_Cells);
+  //-Creates new object for Celldiv on the CPU.
+  delete CellDivSingle; CellDivSingle=NULL;
+  CellDivSingle=new JCellDivCpuSingle(Stable,FtCount!=0,PeriActive,CellMode
+    ,Scell,Map_PosMin,Map_PosMax,Map_Cells,CaseNbound,CaseNfixed,CaseNpb,Log,DirOut);
+  CellDivSingle->DefineDomain(DomCellCode,DomCelIni,DomCelFin,DomPosMin,DomPosMax);
+  ConfigCellDiv((JCellDivCpu*)CellDivSingle);
+  //-Updates objects depending on the cell configuration.
+  if(GaugeSystem)GaugeSystem->ConfigCells(DomPosMin,DomPosMax,Scell,ScellDiv);
+  if(DsPips)DsPips->ResetModel(CellMode);
+}
+
+//==============================================================================
+/// Changes CellMode during the simulation after a cell division. The cells of
+/// particles are computed again and the new cell division is executed.
+///
+/// Cambia CellMode durante la simulacion despues de un divide. Se calculan de
+/// nuevo las celdas de las particulas y se ejecuta el nuevo divide.
+//==============================================================================
+void JSphCpuSingle::SwitchCellMode(TpCellMode cellmode){
+  TprScope("SwitchCellMode");
+  const TpCellMode cellmode0=CellMode;
+  ConfigCellMode(cellmode);
+  //-Computes cells of particles for the new mode (all particles are within the
+  //-domain after the last divide, including periodic duplicates).
+  const int np=int(Np);
+  #ifdef OMP_USE
+    #pragma omp parallel for schedule (static) if(np>OmpLimitComputeLight)
+  #endif
+  for(int p=0;p<np;p++){
+    const tdouble3 ps=Posc[p];
+    const unsigned cx=unsigned((ps.x-DomPosMin.x)/Scell);
+    const unsigned cy=unsigned((ps.y-DomPosMin.y)/Scell);
+    const unsigned cz=unsigned((ps.z-DomPosMin.z)/Scell);
+    Dcellc[p]=PC__Cell(DomCellCode,cx,cy,cz);
+  }
+  BoundChanged=true;
+  RunCellDivide(true);
+  Log->Printf("CellMode changed from %s to %s at step %d (Scell=%g).",GetNameCellMode(cellmode0),GetNameCellMode(CellMode),Nstep,Scell);
+}
+
 //==============================================================================
 /// Redimension space reserved for particles in CPU, measure 
 /// time consumed using TMC_SuResizeNp. On finishing, update divide.
@@ -267,7 +342,7 @@ void JSphCpuSingle::PeriodicDuplicateVerlet(unsigned np,unsigned pini,tuint3 cel
 {
   const int n=int(np);
   #ifdef OMP_USE
-    #pragma omp parallel for schedule (static) if(n>OMP_LIMIT_COMPUTELIGHT)
+    #pragma omp parallel for schedule (static) if(n>OmpLimitComputeLight)
   #endif
   for(int p=0;p<n;p++){
     const unsigned pnew=unsigned(p)+pini;
@@ -298,7 +373,7 @@ void JSphCpuSingle::PeriodicDuplicateSymplectic(unsigned np,unsigned pini,tuint3
 {
   const int n=int(np);
   #ifdef OMP_USE
-    #pragma omp parallel for schedule (static) if(n>OMP_LIMIT_COMPUTELIGHT)
+    #pragma omp parallel for schedule (static) if(n>OmpLimitComputeLight)
   #endif
   for(int p=0;p<n;p++){
     const unsigned pnew=unsigned(p)+pini;
@@ -331,7 +406,7 @@ void JSphCpuSingle::PeriodicDuplicateNormals(unsigned np,unsigned pini,tuint3 ce
 {
   const int n=int(np);
   #ifdef OMP_USE
-    #pragma omp parallel for schedule (static) if(n>OMP_LIMIT_COMPUTELIGHT)
+    #pragma omp parallel for schedule (static) if(n>OmpLimitComputeLight)
   #endif
   for(int p=0;p<n;p++){
     const unsigned pnew=unsigned(p)+pini;
@@ -390,7 +465,7 @@ void JSphCpuSingle::RunPeriodic(){
         bool run=true;
         while(run && num2){
           //-Reserve memory to create list of periodic particles. | Reserva memoria para crear lista de particulas periodicas.
-          unsigned* listp=ArraysCpu->ReserveUint();
+          unsigned* listp=ArraysCpu->ReserveUint("listp");
           unsigned nmax=CpuParticlesSize-1; //-Maximmum number of particles that fit in the list. | Numero maximo de particulas que caben en la lista.
           //-Generate list of new periodic particles. | Genera lista de nuevas periodicas.
           if(Np>=0x80000000)Run_Exceptioon("The number of particles is too big.");//-Because the last bit is used to mark the direction in which a new periodic particle is created. | Porque el ultimo bit se usa para marcar el sentido en que se crea la nueva periodica.
@@ -433,6 +508,7 @@ void JSphCpuSingle::RunPeriodic(){
 /// Ejecuta divide de particulas en celdas.
 //==============================================================================
 void JSphCpuSingle::RunCellDivide(bool updateperiodic){
+  TprScope("RunCellDivide");
   DivData=DivDataCpuNull();
   //-Creates new periodic particles and marks the old ones to be ignored.
   //-Crea nuevas particulas periodicas y marca las viejas para ignorarlas.
@@ -480,11 +556,11 @@ void JSphCpuSingle::RunCellDivide(bool updateperiodic){
   TmcStart(Timers,TMC_NlOutCheck);
   unsigned npfout=CellDivSingle->GetNpfOut();
   if(npfout){
-    unsigned* idp=ArraysCpu->ReserveUint();
-    tdouble3* pos=ArraysCpu->ReserveDouble3();
-    tfloat3* vel=ArraysCpu->ReserveFloat3();
-    float* rhop=ArraysCpu->ReserveFloat();
-    typecode* code=ArraysCpu->ReserveTypeCode();
+    unsigned* idp=ArraysCpu->ReserveUint("idp");
+    tdouble3* pos=ArraysCpu->ReserveDouble3("pos");
+    tfloat3* vel=ArraysCpu->ReserveFloat3("vel");
+    float* rhop=ArraysCpu->ReserveFloat("rhop");
+    typecode* code=ArraysCpu->ReserveTypeCode("code");
     unsigned num=GetParticlesData(npfout,Np,false,idp,pos,vel,rhop,code);
     AddParticlesOut(npfout,idp,pos,vel,rhop,code);
     ArraysCpu->Free(idp);
@@ -504,11 +580,11 @@ void JSphCpuSingle::RunCellDivide(bool updateperiodic){
 void JSphCpuSingle::AbortBoundOut(){
   const unsigned nboundout=CellDivSingle->GetNpbOut();
   //-Get data of excluded boundary particles.
-  unsigned* idp=ArraysCpu->ReserveUint();
-  tdouble3* pos=ArraysCpu->ReserveDouble3();
-  tfloat3* vel=ArraysCpu->ReserveFloat3();
-  float* rhop=ArraysCpu->ReserveFloat();
-  typecode* code=ArraysCpu->ReserveTypeCode();
+  unsigned* idp=ArraysCpu->ReserveUint("idp");
+  tdouble3* pos=ArraysCpu->ReserveDouble3("pos");
+  tfloat3* vel=ArraysCpu->ReserveFloat3("vel");
+  float* rhop=ArraysCpu->ReserveFloat("rhop");
+  typecode* code=ArraysCpu->ReserveTypeCode("code");
   GetParticlesData(nboundout,Np,false,idp,pos,vel,rhop,code);
   //-Shows excluded particles information and aborts execution.
   JSph::AbortBoundOut(Log,nboundout,idp,pos,vel,rhop,code);
@@ -519,6 +595,7 @@ void JSphCpuSingle::AbortBoundOut(){
 /// Interaccion para el calculo de fuerzas.
 //==============================================================================
 void JSphCpuSingle::Interaction_Forces(TpInterStep interstep){
+  TprScope("Interaction_Forces");
   if(TBoundary==BC_MDBC && (MdbcCorrector || interstep!=INTERSTEP_SymCorrector))MdbcBoundCorrection(); //-Boundary correction for mDBC.  //<vs_mddbc>
   InterStep=interstep;
   PreInteraction_Forces();
@@ -530,16 +607,18 @@ void JSphCpuSingle::Interaction_Forces(TpInterStep interstep){
     ,Posc,Velrhopc,Idpc,Codec,Pressc,Arc,Acec,Deltac
     ,ShiftingMode,ShiftPosfsc
     ,SpsTauc,SpsGradvelc
+    ,(DsPips? DsPips->GetSampleCpu(): NULL)
   );
   StInterResultc res;
   res.viscdt=0;
   JSphCpu::Interaction_Forces_ct(parms,res);
+  if(parms.pipss)DsPips->SampleEnd();
 
   //-For 2-D simulations zero the 2nd component. | Para simulaciones 2D anula siempre la 2nd componente.
   if(Simulate2D){
     const int ini=int(Npb),fin=int(Np),npf=int(Np-Npb);
     #ifdef OMP_USE
-      #pragma omp parallel for schedule (static) if(npf>OMP_LIMIT_COMPUTELIGHT)
+      #pragma omp parallel for schedule (static) if(npf>OmpLimitComputeLight)
     #endif
     for(int p=ini;p<fin;p++)Acec[p].y=0;
   }
@@ -548,7 +627,7 @@ void JSphCpuSingle::Interaction_Forces(TpInterStep interstep){
   if(Deltac){
     const int ini=int(Npb),fin=int(Np),npf=int(Np-Npb);
     #ifdef OMP_USE
-      #pragma omp parallel for schedule (static) if(npf>OMP_LIMIT_COMPUTELIGHT)
+      #pragma omp parallel for schedule (static) if(npf>OmpLimitComputeLight)
     #endif
     for(int p=ini;p<fin;p++)if(Deltac[p]!=FLT_MAX)Arc[p]+=Deltac[p];
   }
@@ -568,7 +647,9 @@ void JSphCpuSingle::Interaction_Forces(TpInterStep interstep){
 //==============================================================================
 void JSphCpuSingle::MdbcBoundCorrection(){
   TmcStart(Timers,TMC_CfPreForces);
+  TprStart("mDBC");
   Interaction_MdbcCorrection(SlipMode,DivData,Posc,Codec,Idpc,BoundNormalc,MotionVelc,Velrhopc);
+  TprStop("mDBC");
   TmcStop(Timers,TMC_CfPreForces);
 }
 //<vs_mddbc_end>
@@ -610,7 +691,7 @@ template<bool checkcode> double JSphCpuSingle::ComputeAceMaxOmp(unsigned np
 {
   double acemax=0;
   #ifdef OMP_USE
-    if(np>OMP_LIMIT_COMPUTELIGHT){
+    if(int(np)>OmpLimitComputeLight){
       const int n=int(np);
       if(n<0)Run_Exceptioon("Number of values is too big.");
       float amax=0;
@@ -647,9 +728,11 @@ template<bool checkcode> double JSphCpuSingle::ComputeAceMaxOmp(unsigned np
 /// calculadas en la interaccion usando Verlet.
 //==============================================================================
 double JSphCpuSingle::ComputeStep_Ver(){
+  TprScope("ComputeStep_Ver");
   if(BoundCorr)BoundCorrectionData();      //-Apply BoundCorrection.  //<vs_innlet>
   Interaction_Forces(INTERSTEP_Verlet);    //-Interaction.
   const double dt=DtVariable(true);        //-Calculate new dt.
+  if(SurfaceLoads)RunSurfaceLoads(dt);     //-Accumulates loads on boundary particles.
   if(CaseNmoving)CalcMotion(dt);           //-Calculate motion for moving bodies.
   DemDtForce=dt;                           //(DEM)
   if(Shifting)RunShifting(dt);             //-Shifting.
@@ -669,10 +752,12 @@ double JSphCpuSingle::ComputeStep_Ver(){
 /// calculadas en la interaccion usando Symplectic.
 //==============================================================================
 double JSphCpuSingle::ComputeStep_Sym(){
+  TprScope("ComputeStep_Sym");
   const double dt=SymplecticDtPre;
   if(CaseNmoving)CalcMotion(dt);               //-Calculate motion for moving bodies.
   //-Predictor
   //-----------
+  TprStart("Predictor");
   DemDtForce=dt*0.5f;                          //(DEM)
   if(BoundCorr)BoundCorrectionData();          //-Apply BoundCorrection.  //<vs_innlet>
   Interaction_Forces(INTERSTEP_SymPredictor);  //-Interaction.
@@ -681,18 +766,22 @@ double JSphCpuSingle::ComputeStep_Sym(){
   ComputeSymplecticPre(dt);                    //-Apply Symplectic-Predictor to particles (periodic particles become invalid).
   if(CaseNfloat)RunFloating(dt*.5,true);       //-Control of floating bodies.
   PosInteraction_Forces();                     //-Free memory used for interaction.
+  TprStop("Predictor");
   //-Corrector
   //-----------
+  TprStart("Corrector");
   DemDtForce=dt;                               //(DEM)
   RunCellDivide(true);
   Interaction_Forces(INTERSTEP_SymCorrector);  //-Interaction.
   const double ddt_c=DtVariable(true);         //-Calculate dt of corrector step.
+  if(SurfaceLoads)RunSurfaceLoads(dt);         //-Accumulates loads on boundary particles.
   if(Shifting)RunShifting(dt);                 //-Shifting.
   ComputeSymplecticCorr(dt);                   //-Apply Symplectic-Corrector to particles (periodic particles become invalid).
   if(CaseNfloat)RunFloating(dt,false);         //-Control of floating bodies.
   PosInteraction_Forces();                     //-Free memory used for interaction.
   if(Damping)RunDamping(dt,Np,Npb,Posc,Codec,Velrhopc); //-Applies Damping.
   if(RelaxZones)RunRelaxZone(dt);              //-Generate waves using RZ.  //<vs_rzone>
+  TprStop("Corrector");
   SymplecticDtPre=min(ddt_p,ddt_c);            //-Calculate dt for next ComputeStep.
   return(dt);
 }
@@ -904,6 +993,8 @@ void JSphCpuSingle::RunFloating(double dt,bool predictor){
     //-Applies imposed velocity.                          //<vs_fttvel>
     if(FtLinearVel!=NULL)FtApplyImposedVel(FtoForcesRes); //<vs_fttvel>
     //-Applies motion constraints.
+    const bool svftseries=(FtSeries && !predictor && FtSeries->CheckTime(TimeStep+dt));
+    if(svftseries && FtConstraints)FtSeries->SetForcesFree(FtoForces);
     if(FtConstraints)FtApplyConstraints(FtoForces,FtoForcesRes);
 
     //-Saves face and fomegace for debug.
@@ -973,29 +1064,104 @@ void JSphCpuSingle::RunFloating(double dt,bool predictor){
       if(Moorings)Moorings->ComputeForces(Nstep,TimeStep,dt,ForcePoints);
       ForcePoints->ComputeFtMotion();
     }  //<vs_moordyyn_end>
+
+    //-Saves binary time series of floating bodies.
+    if(svftseries)FtSeries->AddStep(Nstep,TimeStep+dt,dt,FtoForces,FtObjs);
     TmcStop(Timers,TMC_SuFloating);
   }
 }
 
 //==============================================================================
-/// Runs calculations in configured gauges.
-/// Ejecuta calculos en las posiciones de medida configuradas.
+/// Runs calculations in configured gauges, statistics on grids and extraction
+/// of free surface.
+/// Ejecuta calculos en las posiciones de medida configuradas, estadisticas en
+/// rejillas y extraccion de superficie libre.
 //==============================================================================
 void JSphCpuSingle::RunGaugeSystem(double timestep){
   const bool svpart=(TimeStep>=TimePartNext);
   GaugeSystem->CalculeCpu(timestep,svpart,DivData,NpbOk,Npb,Np,Posc,Codec,Idpc,Velrhopc);
+  if(GridStats)GridStats->CalculeCpu(timestep,DivData,Posc,Codec,Velrhopc);
+  if(FreeSurface)FreeSurface->SaveCpu(timestep,(timestep>=TimePartNext),DivData,Posc,Codec,Velrhopc);
+}
+
+//==============================================================================
+/// Accumulates loads on selected boundary particles using the pressure of
+/// the interaction (Pressc) during the step dt.
+/// Acumula cargas en las particulas de contorno seleccionadas usando la 
+/// presion de la interaccion (Pressc) durante el paso dt.
+//==============================================================================
+void JSphCpuSingle::RunSurfaceLoads(double dt){
+  SurfaceLoads->ComputeCpu(TimeStep+dt,dt,DivData,NpbOk,Npb,Np,Posc,Codec,Idpc,Velrhopc,Pressc);
+}
+
+//==============================================================================
+/// Creates the server of telemetry with the active timers and the gauges
+/// with one result per measurement (velocity, SWL, maximum z and force).
+//==============================================================================
+void JSphCpuSingle::ConfigTelemetry(const std::string &socketfile){
+  delete Telemetry; Telemetry=NULL;
+  Telemetry=new JDsTelemetry(socketfile,RunCode,Log);
+  for(unsigned ct=0;ct<TMC_COUNT;ct++)if(TmcIsActive(Timers,CsTypeTimerCPU(ct)))Telemetry->AddTimer(TmcGetName(CsTypeTimerCPU(ct)));
+  for(unsigned cg=0;cg<GaugeSystem->GetCount();cg++){
+    const JGaugeItem *gau=GaugeSystem->GetGauge(cg);
+    switch(gau->Type){
+      case JGaugeItem::GAUGE_Vel:   Telemetry->AddGauge(gau->Name,"vel",3);    break;
+      case JGaugeItem::GAUGE_Swl:   Telemetry->AddGauge(gau->Name,"swl",3);    break;
+      case JGaugeItem::GAUGE_MaxZ:  Telemetry->AddGauge(gau->Name,"maxz",1);   break;
+      case JGaugeItem::GAUGE_Force: Telemetry->AddGauge(gau->Name,"force",3);  break;
+      default: break;
+    }
+  }
+  Telemetry->Start();
+  Telemetry->VisuConfig();
+}
+
+//==============================================================================
+/// Copies the values of the current step and publishes them to the server of
+/// telemetry (it never waits for the secondary thread).
+//==============================================================================
+void JSphCpuSingle::UpdateTelemetry(double dt){
+  Telemetry->AddDt(dt);
+  JDsTelemetry::StData &d=Telemetry->GetData();
+  d.nstep=Nstep;
+  d.part=Part;
+  d.timestep=TimeStep;
+  d.timemax=TimeMax;
+  d.np=Np;
+  d.npok=Np-NpbPer-NpfPer;
+  d.memcpu=GetAllocMemoryCpu();
+  unsigned ctt=0;
+  for(unsigned ct=0;ct<TMC_COUNT && ctt<unsigned(d.timers.size());ct++){
+    if(TmcIsActive(Timers,CsTypeTimerCPU(ct)))d.timers[ctt++]=TmcGetValueD(Timers,CsTypeTimerCPU(ct))/1000.;
+  }
+  unsigned cgg=0;
+  for(unsigned cg=0;cg<GaugeSystem->GetCount() && cgg<unsigned(d.gauges.size());cg++){
+    const JGaugeItem *gau=GaugeSystem->GetGauge(cg);
+    JDsTelemetry::StGaugeValue &g=d.gauges[cgg];
+    tfloat3 v=TFloat3(0);
+    switch(gau->Type){
+      case JGaugeItem::GAUGE_Vel:  { const JGaugeVelocity::StGaugeVelRes &r=((const JGaugeVelocity*)gau)->GetResult(); g.time=r.timestep; v=r.vel;    }break;
+      case JGaugeItem::GAUGE_Swl:  { const JGaugeSwl::StGaugeSwlRes      &r=((const JGaugeSwl*)     gau)->GetResult(); g.time=r.timestep; v=r.posswl; }break;
+      case JGaugeItem::GAUGE_MaxZ: { const JGaugeMaxZ::StGaugeMaxzRes    &r=((const JGaugeMaxZ*)    gau)->GetResult(); g.time=r.timestep; v.x=r.zmax; }break;
+      case JGaugeItem::GAUGE_Force:{ const JGaugeForce::StGaugeForceRes  &r=((const JGaugeForce*)   gau)->GetResult(); g.time=r.timestep; v=r.force;  }break;
+      default: continue;
+    }
+    g.v[0]=v.x; g.v[1]=v.y; g.v[2]=v.z;
+    cgg++;
+  }
+  Telemetry->Publish();
 }
 
  //==============================================================================
-/// Compute PIPS information of current particles.
-/// Calcula datos de PIPS de particulas actuales.
+/// Enables the count of PIPS information in the next interaction of particles.
+/// Activa el calculo de datos de PIPS en la siguiente interaccion de particulas.
 //==============================================================================
 void JSphCpuSingle::ComputePips(bool run){
   if(run || DsPips->CheckRun(Nstep)){
     TimerSim.Stop();
     const double timesim=TimerSim.GetElapsedTimeD()/1000.;
-    DsPips->ComputeCpu(Nstep,TimeStep,timesim,CSP,OmpThreads,Np,Npb,NpbOk
-      ,DivData,Dcellc,Posc);
+    //-Interactions are counted in the next interaction of particles.
+    DsPips->SampleArm(Nstep,TimeStep,timesim);
   }
 }
 
@@ -1007,9 +1173,18 @@ void JSphCpuSingle::Run(std::string appname,JSphCfgRun *cfg,JLog2 *log){
   if(!cfg||!log)return;
   AppName=appname; Log=log;
 
-  //-Configure timers.
-  //-------------------
+  //-Configure timers and profiler of regions.
+  //--------------------------------------------
   TmcCreation(Timers,cfg->SvTimers);
+  if(cfg->SvProfile){
+    Profiler=new JTraceProfiler(Log,cfg->SvProfile);
+    Profiler->SetActive(true);
+  }
+  if(cfg->SvMemProfile){
+    MemProfiler=new JArraysCpuProfiler(Log);
+    MemProfiler->SetActive(true);
+  }
+  TprStart("Run");
   TmcStart(Timers,TMC_Init);
 
   //-Load parameters and values of input. | Carga de parametros y datos de entrada.
@@ -1024,27 +1199,43 @@ void JSphCpuSingle::Run(std::string appname,JSphCfgRun *cfg,JLog2 *log){
   //-Initialisation of execution variables. | Inicializacion de variables de ejecucion.
   //------------------------------------------------------------------------------------
   InitRunCpu();
+  if(!CheckpointBegin.empty())LoadCheckpoint();
   RunGaugeSystem(TimeStep);
   if(InOut)InOutInit(TimeStepIni);  //<vs_innlet>
   FreePartsInit();
   UpdateMaxValues();
   PrintAllocMemory(GetAllocMemoryCpu());
-  SaveData(); 
+  if(CheckpointBegin.empty()){
+    SaveData(); 
+    if(OutputParts && OutputParts->CheckTime(TimeStep))SaveOutputParts();
+  }
   TmcResetValues(Timers);
   TmcStop(Timers,TMC_Init);
+  if(cfg->SvHwCounters)ConfigHwCounters();
   if(Log->WarningCount())Log->PrintWarningList("\n[WARNINGS]","");
-  PartNstep=-1; Part++;
+  if(CheckpointBegin.empty()){ PartNstep=-1; Part++; }
 
   //-Main Loop.
   //------------
   JTimeControl tc("30,60,300,600");//-Shows information at 0.5, 1, 5 y 10 minutes (before first PART).
   bool partoutstop=false;
+  bool svcheckpoint=false;
+  bool memtighten=(MemProfiler && cfg->SvMemProfile>=2);
   TimerSim.Start();
+  TimerCheckpoint.Start();
   TimerPart.Start();
   Log->Print(string("\n[Initialising simulation (")+RunCode+")  "+fun::GetDateTime()+"]");
-  if(DsPips)ComputePips(true);
+  if(DsPips){
+    DsPips->ConfigCpu(Simulate2D,CellMode,OmpThreads,Map_PosMin,Map_PosMax
+      ,CaseNfloat>0,TVisco==VISCO_LaminarSPS,TDensity!=DDT_None,Shifting!=NULL);
+    ComputePips(true);
+  }
+  if(!cfg->Telemetry.empty())ConfigTelemetry(cfg->Telemetry);
   PrintHeadPart();
+  if(CellModeAuto)CellModeAuto->VisuConfig();
   while(TimeStep<TimeMax){
+    TprStep();
+    if(CellModeAuto)CellModeAuto->StepStart();
     InterStep=(TStep==STEP_Symplectic? INTERSTEP_SymPredictor: INTERSTEP_Verlet);
     if(ViscoTime)Visco=ViscoTime->GetVisco(float(TimeStep));
     double stepdt=ComputeStep();
@@ -1053,6 +1244,10 @@ void JSphCpuSingle::Run(std::string appname,JSphCfgRun *cfg,JLog2 *log){
     //RunCellDivide(true);                  //<vs_no_innlet>
     if(InOut)InOutComputeStep(stepdt);      //<vs_innlet>
     else RunCellDivide(true);               //<vs_innlet>
+    if(CellModeAuto){
+      const TpCellMode cellmode=CellModeAuto->StepEnd(unsigned(Nstep),Np,DivData,DsPips);
+      if(cellmode!=CellMode)SwitchCellMode(cellmode);
+    }
     TimeStep+=stepdt;
     LastDt=stepdt;
     partoutstop=(Np<NpMinimum || !Np);
@@ -1067,26 +1262,68 @@ void JSphCpuSingle::Run(std::string appname,JSphCfgRun *cfg,JLog2 *log){
       TimeStepM1=TimeStep;
       TimePartNext=(SvAllSteps? TimeStep: OutputTime->GetNextTime(TimeStep));
       TimerPart.Start();
+      svcheckpoint=(CheckpointTime>=0 && !partoutstop);
     }
+    if(OutputParts && OutputParts->CheckTime(TimeStep))SaveOutputParts();
     UpdateMaxValues();
     Nstep++;
+    if(Telemetry)UpdateTelemetry(stepdt);
+    if(memtighten){ MemTighten=true; memtighten=false; } //-Number of arrays is reduced after the first complete step.
+    if(svcheckpoint){
+      TimerCheckpoint.Stop();
+      if(TimerCheckpoint.GetElapsedTimeD()/1000.>=CheckpointTime){
+        SaveCheckpoint();
+        TimerCheckpoint.Start();
+      }
+      svcheckpoint=false;
+    }
     const bool laststep=(TimeStep>=TimeMax || (NstepsBreak && Nstep>=NstepsBreak));
     if(DsPips)ComputePips(laststep);
     if(Part<=PartIni+1 && tc.CheckTime())Log->Print(string("  ")+tc.GetInfoFinish((TimeStep-TimeStepIni)/(TimeMax-TimeStepIni)));
     if(NstepsBreak && Nstep>=NstepsBreak)break; //-For debugging.
   }
   TimerSim.Stop(); TimerTot.Stop();
+  TprStop("Run");
 
   //-End of Simulation.
   //--------------------
   FinishRun(partoutstop);
 }
 
+//==============================================================================
+/// Returns summary of the execution (number of steps, runtime, interactions
+/// and timers).
+//==============================================================================
+void JSphCpuSingle::GetRunSummary(StRunSummaryCpu &rs){
+  memset(&rs,0,sizeof(StRunSummaryCpu));
+  rs.np=Np;
+  rs.npb=Npb;
+  rs.nstep=unsigned(max(Nstep,0));
+  rs.timestep=TimeStep;
+  rs.tsim=TimerSim.GetElapsedTimeD()/1000.;
+  rs.gpis=(DsPips? DsPips->GetTotalGPIs(): 0);
+  for(unsigned ct=0;ct<TMC_COUNT;ct++)rs.timers[ct]=(TimerIsActive(ct)? TmcGetValueD(Timers,CsTypeTimerCPU(ct))/1000.: -1);
+}
+
+//==============================================================================
+/// Returns particle data of the current step without periodic particles.
+/// Used to compare the final state of the simulation (regression mode).
+//==============================================================================
+unsigned JSphCpuSingle::GetParticlesState(std::vector<unsigned> &idp,std::vector<tdouble3> &pos
+  ,std::vector<tfloat3> &vel,std::vector<float> &rhop)
+{
+  idp.resize(Np); pos.resize(Np); vel.resize(Np); rhop.resize(Np);
+  const unsigned n=(Np? GetParticlesData(Np,0,PeriActive!=0,idp.data(),pos.data(),vel.data(),rhop.data(),NULL): 0);
+  idp.resize(n); pos.resize(n); vel.resize(n); rhop.resize(n);
+  return(n);
+}
+
 //==============================================================================
 /// Generates files with output data.
 /// Genera los ficheros de salida de datos.
 //==============================================================================
 void JSphCpuSingle::SaveData(){
+  TprScope("SaveData");
   const bool save=(SvData!=SDAT_None && SvData!=SDAT_Info);
   const unsigned npsave=Np-NpbPer-NpfPer; //-Subtracts the periodic particles if they exist. | Resta las periodicas si las hubiera.
   TmcStart(Timers,TMC_SuSavePart);
@@ -1097,10 +1334,10 @@ void JSphCpuSingle::SaveData(){
   float *rhop=NULL;
   if(save){
     //-Assign memory and collect particle values. | Asigna memoria y recupera datos de las particulas.
-    idp=ArraysCpu->ReserveUint();
-    pos=ArraysCpu->ReserveDouble3();
-    vel=ArraysCpu->ReserveFloat3();
-    rhop=ArraysCpu->ReserveFloat();
+    idp=ArraysCpu->ReserveUint("idp");
+    pos=ArraysCpu->ReserveDouble3("pos");
+    vel=ArraysCpu->ReserveFloat3("vel");
+    rhop=ArraysCpu->ReserveFloat("rhop");
     unsigned npnormal=GetParticlesData(Np,0,PeriActive!=0,idp,pos,vel,rhop,NULL);
     if(npnormal!=npsave)Run_Exceptioon("The number of particles is invalid.");
   }
@@ -1135,11 +1372,169 @@ void JSphCpuSingle::SaveData(){
   TmcStop(Timers,TMC_SuSavePart);
 }
 
+//==============================================================================
+/// Generates files of output streams with filtered particle data.
+/// Genera los ficheros de los flujos de salida con datos de particulas filtradas.
+//==============================================================================
+void JSphCpuSingle::SaveOutputParts(){
+  TmcStart(Timers,TMC_SuSavePart);
+  //-Collect particle values in original order. | Recupera datos de particulas en orden original.
+  unsigned *idp=ArraysCpu->ReserveUint("idp");
+  tdouble3 *pos=ArraysCpu->ReserveDouble3("pos");
+  tfloat3  *vel=ArraysCpu->ReserveFloat3("vel");
+  float   *rhop=ArraysCpu->ReserveFloat("rhop");
+  typecode *code=ArraysCpu->ReserveTypeCode("code");
+  const unsigned npnormal=GetParticlesData(Np,0,PeriActive!=0,idp,pos,vel,rhop,code);
+  //-Filters and stores particle data of output streams.
+  const tdouble3 vdom[2]={CellDivSingle->GetDomainLimits(true),CellDivSingle->GetDomainLimits(false)};
+  OutputParts->SaveData(TimeStep,Nstep,npnormal,idp,pos,vel,rhop,code,SvPosDouble,vdom[0],vdom[1]);
+  //-Free auxiliary memory for particle data. | Libera memoria auxiliar para datos de particulas.
+  ArraysCpu->Free(idp);
+  ArraysCpu->Free(pos);
+  ArraysCpu->Free(vel);
+  ArraysCpu->Free(rhop);
+  ArraysCpu->Free(code);
+  TmcStop(Timers,TMC_SuSavePart);
+}
+
+//==============================================================================
+/// Saves checkpoint file with the exact state of execution at the end of the
+/// current step. Particle data is stored in cell order with the divide state.
+/// With delta checkpoints only the changed data blocks are saved.
+///
+/// Graba fichero de checkpoint con el estado exacto de ejecucion al final del
+/// paso actual. Los datos de particulas se guardan ordenados por celdas junto
+/// con el estado del divide. Con checkpoints delta solo se graban los bloques
+/// de datos modificados.
+//==============================================================================
+void JSphCpuSingle::SaveCheckpoint(){
+  TmcStart(Timers,TMC_SuSavePart);
+  JDsCheckpoint chk;
+  //-Configuration to check the restart.
+  chk.AddStr("CaseName",CaseName);
+  chk.AddValue("CaseNp",CaseNp);
+  chk.AddValue("FtCount",FtCount);
+  const int cfg[]={int(TStep),int(TVisco),int(TKernel),(UseNormals? 1: 0),int(PeriActive)};
+  chk.AddArray("Config",sizeof(cfg)/sizeof(int),cfg,true);
+  //-Execution variables.
+  chk.AddValue("TimeStep",TimeStep);
+  chk.AddValue("TimeStepM1",TimeStepM1);
+  chk.AddValue("TimePartNext",TimePartNext);
+  chk.AddValue("LastDt",LastDt);
+  const int steps[]={Part,Nstep,PartNstep,VerletStep};
+  chk.AddArray("Steps",sizeof(steps)/sizeof(int),steps,true);
+  chk.AddValue("SymplecticDtPre",SymplecticDtPre);
+  chk.AddValue("DemDtForce",DemDtForce);
+  chk.AddValue("PartOut",PartOut);
+  chk.AddValue("TotalNp",TotalNp);
+  chk.AddValue("DtModif",DtModif);
+  chk.AddValue("MaxNumbers",MaxNumbers);
+  //-Number of particles and particle data in cell order.
+  const unsigned nps[]={Np,Npb,NpbOk,NpbPer,NpfPer,NpbPerM1,NpfPerM1,CpuParticlesSize};
+  chk.AddArray("Nps",sizeof(nps)/sizeof(unsigned),nps,true);
+  chk.AddValue("BoundChanged",byte(BoundChanged? 1: 0));
+  chk.AddArray("Idp"    ,Np,Idpc);
+  chk.AddArray("Code"   ,Np,Codec);
+  chk.AddArray("Dcell"  ,Np,Dcellc);
+  chk.AddArray("Pos"    ,Np,Posc);
+  chk.AddArray("Velrhop",Np,Velrhopc);
+  if(VelrhopM1c)  chk.AddArray("VelrhopM1"  ,Np,VelrhopM1c);
+  if(SpsTauc)     chk.AddArray("SpsTau"     ,Np,SpsTauc);
+  if(BoundNormalc)chk.AddArray("BoundNormal",Np,BoundNormalc); //<vs_mddbc>
+  if(MotionVelc)  chk.AddArray("MotionVel"  ,Np,MotionVelc);   //<vs_mddbc>
+  //-Floating bodies state.
+  if(FtCount)chk.AddArray("FtObjs",FtCount,FtObjs);
+  //-State of cell division.
+  CellDivSingle->SaveCheckpoint(&chk);
+  //-Saves full or delta checkpoint file of the chain.
+  if(!CheckpointChain)CheckpointChain=new JDsCheckpointChain(DirOut+"Checkpoint",CheckpointDelta);
+  CheckpointChain->Save(chk);
+  TmcStop(Timers,TMC_SuSavePart);
+}
+
+//==============================================================================
+/// Restores the exact state of execution from checkpoint file. Particle data
+/// is already sorted so divide is not executed.
+///
+/// Restaura el estado exacto de ejecucion desde fichero de checkpoint. Los
+/// datos de particulas ya estan ordenados y no se ejecuta el divide.
+//==============================================================================
+void JSphCpuSingle::LoadCheckpoint(){
+  if(InOut)Run_Exceptioon("Simulation restart from checkpoint is not allowed when Inlet/Outlet is used.");         //<vs_innlet>
+  if(UseChrono)Run_Exceptioon("Simulation restart from checkpoint is not allowed when Chrono is used.");            //<vs_chroono>
+  if(Moorings || ForcePoints)Run_Exceptioon("Simulation restart from checkpoint is not allowed when moorings are used."); //<vs_moordyyn>
+  TmcStart(Timers,TMC_SuSavePart);
+  JDsCheckpoint chk;
+  chk.LoadFile(CheckpointBegin);
+  const string file=chk.GetFileName();
+  //-Checks configuration.
+  int cfg[5];
+  chk.GetArray("Config",5,cfg);
+  if(chk.GetStr("CaseName")!=CaseName || chk.GetValue<unsigned>("CaseNp")!=CaseNp || chk.GetValue<unsigned>("FtCount")!=FtCount)
+    Run_ExceptioonFile("The checkpoint does not belong to the current case.",file);
+  if(cfg[0]!=int(TStep) || cfg[1]!=int(TVisco) || cfg[2]!=int(TKernel) || cfg[3]!=(UseNormals? 1: 0) || cfg[4]!=int(PeriActive))
+    Run_ExceptioonFile("The execution configuration of the checkpoint does not match the current configuration.",file);
+  //-Allocates the same memory for particles and restores particle data.
+  unsigned nps[8];
+  chk.GetArray("Nps",8,nps);
+  if(nps[7]!=CpuParticlesSize)ResizeCpuMemoryParticles(nps[7]-PARTICLES_OVERMEMORY_MIN);
+  Np=nps[0]; Npb=nps[1]; NpbOk=nps[2];
+  NpbPer=nps[3]; NpfPer=nps[4]; NpbPerM1=nps[5]; NpfPerM1=nps[6];
+  BoundChanged=(chk.GetValue<byte>("BoundChanged")!=0);
+  chk.GetArray("Idp"    ,Np,Idpc);
+  chk.GetArray("Code"   ,Np,Codec);
+  chk.GetArray("Dcell"  ,Np,Dcellc);
+  chk.GetArray("Pos"    ,Np,Posc);
+  chk.GetArray("Velrhop",Np,Velrhopc);
+  if(VelrhopM1c)  chk.GetArray("VelrhopM1"  ,Np,VelrhopM1c);
+  if(SpsTauc)     chk.GetArray("SpsTau"     ,Np,SpsTauc);
+  if(BoundNormalc)chk.GetArray("BoundNormal",Np,BoundNormalc); //<vs_mddbc>
+  if(MotionVelc)  chk.GetArray("MotionVel"  ,Np,MotionVelc);   //<vs_mddbc>
+  if(FtCount)chk.GetArray("FtObjs",FtCount,FtObjs);
+  //-Restores execution variables.
+  TimeStep=chk.GetValue<double>("TimeStep");
+  TimeStepM1=chk.GetValue<double>("TimeStepM1");
+  TimePartNext=chk.GetValue<double>("TimePartNext");
+  LastDt=chk.GetValue<double>("LastDt");
+  int steps[4];
+  chk.GetArray("Steps",4,steps);
+  Part=steps[0]; Nstep=steps[1]; PartNstep=steps[2]; VerletStep=steps[3];
+  SymplecticDtPre=chk.GetValue<double>("SymplecticDtPre");
+  DemDtForce=chk.GetValue<double>("DemDtForce");
+  PartOut=chk.GetValue<unsigned>("PartOut");
+  TotalNp=chk.GetValue<ullong>("TotalNp");
+  DtModif=chk.GetValue<unsigned>("DtModif");
+  MaxNumbers=chk.GetValue<StMaxNumbers>("MaxNumbers");
+  PartIni=Part-1;
+  TimeStepIni=TimeStep;
+  //-Restores state of cell division.
+  if(CellModeAuto && chk.GetValue<int>("cd.ScellDiv")!=ScellDiv){
+    ConfigCellMode(chk.GetValue<int>("cd.ScellDiv")==2? CELLMODE_Half: CELLMODE_Full);
+    CellModeAuto->Config(CellMode);
+  }
+  CellDivSingle->LoadCheckpoint(&chk);
+  DivData=CellDivSingle->GetCellDivData();
+  if(CaseNfloat)CalcRidp(PeriActive!=0,Np-Npb,Npb,CaseNpb,CaseNpb+CaseNfloat,Codec,Idpc,FtRidp);
+  //-Adjusts motion for the instant of the checkpoint.
+  if(DsMotion)DsMotion->ProcesTime(JDsMotion::MOMT_Simple,0,TimeStep);
+  //-Following checkpoints continue the numbering of the loaded one.
+  if(CheckpointTime>=0){
+    delete CheckpointChain;
+    CheckpointChain=new JDsCheckpointChain(DirOut+"Checkpoint",CheckpointDelta,chk.GetChainIndex()+1);
+  }
+  TmcStop(Timers,TMC_SuSavePart);
+  Log->Printf("Simulation restarts from checkpoint \"%s\" (Part:%d  Nstep:%d  TimeStep:%g  ChainFiles:%u).",file.c_str(),Part,Nstep,TimeStep,chk.GetChainSize());
+}
+
 //==============================================================================
 /// Displays and stores final summary of the execution.
 /// Muestra y graba resumen final de ejecucion.
 //==============================================================================
 void JSphCpuSingle::FinishRun(bool stop){
+  if(GridStats)GridStats->SaveFinal();
+  if(SurfaceLoads)SurfaceLoads->SaveFinal();
+  if(FtSeries)FtSeries->Finish();
+  if(DsPips)DsPips->SampleClose();
   float tsim=TimerSim.GetElapsedTimeF()/1000.f,ttot=TimerTot.GetElapsedTimeF()/1000.f;
   JSph::ShowResume(stop,tsim,ttot,true,"");
   Log->Print(" ");
@@ -1149,6 +1544,33 @@ void JSphCpuSingle::FinishRun(bool stop){
     GetTimersInfo(hinfo,dinfo);
     Log->Print(" ");
   }
+  if(Profiler){
+    Profiler->SetActive(false);
+    Profiler->VisuSummary(fun::PrintStr("[Profile of regions] (%llu steps)",Profiler->GetSteps()));
+    Profiler->SaveSummaryCsv(DirOut+"ProfileSummary.csv",CsvSepComa);
+    Profiler->SaveHistogramCsv(DirOut+"ProfileHistogram.csv",CsvSepComa);
+    Profiler->SaveTraceJson(DirOut+"ProfileTrace.json");
+    Log->Print(" ");
+  }
+  if(HwCounters){
+    ShowHwCounters();
+    Log->Print(" ");
+  }
+  if(MemProfiler){
+    MemProfiler->SetActive(false);
+    MemProfiler->VisuSummary(ArraysCpu);
+    MemProfiler->SaveCsv(DirOut+"MemArraysCpu.csv",CsvSepComa);
+    Log->Print(" ");
+  }
+  if(Telemetry){
+    Telemetry->Finish();
+    Log->Printf("[Telemetry] %llu requests served on socket \"%s\".",Telemetry->GetServed(),Telemetry->GetSocketFile().c_str());
+    Log->Print(" ");
+  }
+  if(CellModeAuto){
+    CellModeAuto->VisuSummary();
+    Log->Print(" ");
+  }
   if(SvRes)SaveRes(tsim,ttot,hinfo,dinfo);
   Log->PrintFilesList();
   Log->PrintWarningList();
@@ -24,8 +24,23 @@
 #include "DualSphDef.h"
 #include "JSphCpu.h"
 #include <string>
+#include <vector>
 
 class JCellDivCpuSingle;
+class JDsCheckpointChain;
+class JDsCellModeAuto;
+class JDsTelemetry;
+
+///Summary of the execution of the simulation (used by benchmark and regression modes).
+typedef struct{
+  unsigned np;              ///<Number of particles at the end of simulation.
+  unsigned npb;             ///<Number of boundary particles at the end of simulation.
+  unsigned nstep;           ///<Number of computed steps.
+  double timestep;          ///<Simulated time at the end of simulation.
+  double tsim;              ///<Runtime of the main loop (in seconds).
+  double gpis;              ///<Total particle interactions in GigaPIs (0 when PIPS is not computed).
+  double timers[TMC_COUNT]; ///<Accumulated time of each timer (in seconds, -1 when it is not active).
+}StRunSummaryCpu;
 
 //##############################################################################
 //# JSphCpuSingle
@@ -36,11 +51,19 @@ class JSphCpuSingle : public JSphCpu
 {
 protected:
   JCellDivCpuSingle* CellDivSingle;
+  JTimer TimerCheckpoint;  ///<Measures runtime since last checkpoint.
+  JDsCheckpointChain* CheckpointChain; ///<Chain of full and delta checkpoint files.
+  JDsCellModeAuto* CellModeAuto;       ///<Automatic selection of CellMode (NULL: disabled).
+  JDsTelemetry* Telemetry;             ///<Server of telemetry of the run (NULL: disabled).
 
   llong GetAllocMemoryCpu()const;
   void UpdateMaxValues();
   void LoadConfig(JSphCfgRun *cfg);
   void ConfigDomain();
+  void ConfigCellMode(TpCellMode cellmode);
+  void SwitchCellMode(TpCellMode cellmode);
+  void ConfigTelemetry(const std::string &socketfile);
+  void UpdateTelemetry(double dt);
 
   void ResizeParticlesSize(unsigned newsize,float oversize,bool updatedivide);
   unsigned PeriodicMakeList(unsigned np,unsigned pini,bool stable,unsigned nmax,tdouble3 perinc,const tdouble3 *pos,const typecode *code,unsigned *listp)const;
@@ -76,16 +99,23 @@ protected:
   void FtApplyConstraints(StFtoForces *ftoforces,StFtoForcesRes *ftoforcesres)const;
   void RunFloating(double dt,bool predictor);
   void RunGaugeSystem(double timestep);
+  void RunSurfaceLoads(double dt);
 
   void ComputePips(bool run);
   
   void SaveData();
+  void SaveOutputParts();
+  void SaveCheckpoint();
+  void LoadCheckpoint();
   void FinishRun(bool stop);
 
 public:
   JSphCpuSingle();
   ~JSphCpuSingle();
   void Run(std::string appname,JSphCfgRun *cfg,JLog2 *log);
+  void GetRunSummary(StRunSummaryCpu &rs);
+  unsigned GetParticlesState(std::vector<unsigned> &idp,std::vector<tdouble3> &pos
+    ,std::vector<tfloat3> &vel,std::vector<float> &rhop);
 
 //<vs_innlet_ini>
 //-Code for InOut in JSphCpuSingle_InOut.cpp
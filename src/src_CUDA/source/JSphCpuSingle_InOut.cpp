@@ -125,7 +125,7 @@ void JSphCpuSingle::InOutInit(double timestepini){
   if(DBG_INOUT_PARTINIT)DgSaveVtkParticlesCpu("CfgInOut_InletIni.vtk",1,0,Np,Posc,Codec,Idpc,Velrhopc);
 
   //-Create list of current inout particles (normal and periodic).
-  int* inoutpart=ArraysCpu->ReserveInt();
+  int* inoutpart=ArraysCpu->ReserveInt("inoutpart");
   const unsigned inoutcount=InOut->CreateListSimpleCpu(Nstep,Np-Npb,Npb,Codec,inoutpart);
   InOut->SetCurrentNp(inoutcount);
 
@@ -173,19 +173,19 @@ void JSphCpuSingle::InOutComputeStep(double stepdt){
   unsigned newnp=0;
   {
     //-Creates list with current inout particles and normal fluid (no periodic) in inout zones.
-    int *inoutpart=ArraysCpu->ReserveInt();
+    int *inoutpart=ArraysCpu->ReserveInt("inoutpart");
     const unsigned inoutcountpre=InOut->CreateListCpu(Nstep,Np-Npb,Npb,Posc,Idpc,Codec,inoutpart);
 
     //-Updates code of inout particles according its position and create new inlet particles when refilling=false.
     //if(1)for(unsigned p=0;p<Np;p++)if(Idpc[p]==4382)Log->Printf("%d>=CS_005>> vel[%d].x:%f",Nstep,p,Velrhopc[p].x);
-    byte *newizone=ArraysCpu->ReserveByte();
+    byte *newizone=ArraysCpu->ReserveByte("newizone");
     newnp=InOut->ComputeStepCpu(Nstep,stepdt,inoutcountpre,inoutpart,this,IdMax+1,CpuParticlesSize,Np,Posc,Dcellc,Codec,Idpc,Velrhopc,newizone);
     ArraysCpu->Free(newizone);  newizone=NULL;
 
     //-Creates new inlet particles using advanced refilling mode.
     if(InOut->GetRefillAdvanced()){
-      float    *prodist=ArraysCpu->ReserveFloat();
-      tdouble3 *propos =ArraysCpu->ReserveDouble3();
+      float    *prodist=ArraysCpu->ReserveFloat("prodist");
+      tdouble3 *propos =ArraysCpu->ReserveDouble3("propos");
       newnp+=InOut->ComputeStepFillingCpu(Nstep,stepdt,inoutcountpre,inoutpart
         ,this,IdMax+1+newnp,CpuParticlesSize,Np+newnp,Posc,Dcellc,Codec,Idpc,Velrhopc
         ,prodist,propos);
@@ -212,7 +212,7 @@ void JSphCpuSingle::InOutComputeStep(double stepdt){
   TmcStart(Timers,TMC_SuInOut);
 
   //-Create list of current inout particles (normal and periodic).
-  int* inoutpart=ArraysCpu->ReserveInt();
+  int* inoutpart=ArraysCpu->ReserveInt("inoutpart");
   const unsigned inoutcount=InOut->CreateListSimpleCpu(Nstep,Np-Npb,Npb,Codec,inoutpart);
   InOut->SetCurrentNp(inoutcount);
 
@@ -44,6 +44,7 @@
 #include "JDebugSphGpu.h"
 #include "JSphShifting.h"
 #include "JDsPips.h"
+#include "JDsFtSeries.h"
 
 #include <climits>
 
@@ -127,6 +128,8 @@ void JSphGpuSingle::LoadConfig(JSphCfgRun *cfg){
   //-Loads general configuration.
   JSph::LoadConfig(cfg);
   //-Checks compatibility of selected options.
+  if(cfg->CellModeAuto)Log->PrintWarning("Automatic selection of CellMode is only available on CPU, so CellMode Full is used.");
+  if(!cfg->Telemetry.empty())Log->PrintWarning("Telemetry server is only available on CPU, so it is disabled.");
   Log->Print("**Special case configuration is loaded");
 }
 
@@ -700,6 +703,12 @@ void JSphGpuSingle::RunFloating(double dt,bool predictor){
     //-Applies imposed velocity.                           //<vs_fttvel>
     if(FtLinearVel!=NULL)FtApplyImposedVel(FtoForcesResg); //<vs_fttvel>
     //-Applies motion constraints.
+    const bool svftseries=(FtSeries && !predictor && FtSeries->CheckTime(TimeStep+dt));
+    if(svftseries && FtConstraints){
+      StFtoForces *ftoforces=(StFtoForces *)FtoAuxFloat9;
+      cudaMemcpy(ftoforces,FtoForcesg,sizeof(tfloat3)*FtCount*2,cudaMemcpyDeviceToHost);
+      FtSeries->SetForcesFree(ftoforces);
+    }
     if(FtConstraints)cusph::FtApplyConstraints(FtCount,FtoConstraintsg,FtoForcesg,FtoForcesResg);
     
     //-Saves face and fomegace for debug.
@@ -749,6 +758,14 @@ void JSphGpuSingle::RunFloating(double dt,bool predictor){
       if(Moorings)Moorings->ComputeForces(Nstep,TimeStep,dt,ForcePoints);
       ForcePoints->ComputeFtMotion();
     }  //<vs_moordyyn_end>
+
+    //-Saves binary time series of floating bodies.
+    if(svftseries){
+      UpdateFtObjs();
+      StFtoForces *ftoforces=(StFtoForces *)FtoAuxFloat9;
+      cudaMemcpy(ftoforces,FtoForcesg,sizeof(tfloat3)*FtCount*2,cudaMemcpyDeviceToHost);
+      FtSeries->AddStep(Nstep,TimeStep+dt,dt,ftoforces,FtObjs);
+    }
     TmgStop(Timers,TMG_SuFloating);
   }
 }
@@ -920,6 +937,7 @@ void JSphGpuSingle::SaveData(){
 /// Muestra y graba resumen final de ejecucion.
 //==============================================================================
 void JSphGpuSingle::FinishRun(bool stop){
+  if(FtSeries)FtSeries->Finish();
   float tsim=TimerSim.GetElapsedTimeF()/1000.f,ttot=TimerTot.GetElapsedTimeF()/1000.f;
   JSph::ShowResume(stop,tsim,ttot,true,"");
   Log->Print(" ");
@@ -30,6 +30,9 @@
 #endif
 
 #include "JTimer.h" //"JTimerClock.h"
+#include "JTraceProfiler.h"
+#include "JHwCounters.h"
+#include "JArraysCpuProfiler.h"
 
 /// Structure with information of the timer and time value in CPU.
 typedef struct{
@@ -111,12 +114,19 @@ inline void TmcCreation(TimersCpu vtimer,bool active){
 inline void TmcDestruction(TimersCpu vtimer){ TmcCreation(vtimer,false); }
 
 //==============================================================================
-/// Marks start of timer.
+/// Marks start of timer (and starts the region in the active profiler,
+/// performance counters and memory profiler).
 //==============================================================================
-inline void _TmcStart(TimersCpu vtimer,CsTypeTimerCPU ct){ if(vtimer[ct].active)vtimer[ct].timer.Start(); }
+inline void _TmcStart(TimersCpu vtimer,CsTypeTimerCPU ct){
+  if(vtimer[ct].active)vtimer[ct].timer.Start();
+  if(JTraceProfiler::Active)JTraceProfiler::Active->Start(TmcGetName(ct));
+  if(JHwCounters::Active)JHwCounters::Active->Start(unsigned(ct));
+  if(JArraysCpuProfiler::Active)JArraysCpuProfiler::Active->PhaseStart(TmcGetName(ct));
+}
 
 //==============================================================================
-/// Marks end of timer and accumulates time.
+/// Marks end of timer and accumulates time (and stops the region in the
+/// active profiler, performance counters and memory profiler).
 //==============================================================================
 inline void _TmcStop(TimersCpu vtimer,CsTypeTimerCPU ct){
   StSphTimerCpu* t=vtimer+unsigned(ct);
@@ -124,6 +134,9 @@ inline void _TmcStop(TimersCpu vtimer,CsTypeTimerCPU ct){
     t->timer.Stop();
     t->time+=t->timer.GetElapsedTimeD();
   }
+  if(JArraysCpuProfiler::Active)JArraysCpuProfiler::Active->PhaseStop();
+  if(JHwCounters::Active)JHwCounters::Active->Stop(unsigned(ct));
+  if(JTraceProfiler::Active)JTraceProfiler::Active->Stop(TmcGetName(ct));
 }
 
 //==============================================================================
@@ -0,0 +1,393 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JTraceProfiler.cpp \brief Implements the class \ref JTraceProfiler.
+
+#include "JTraceProfiler.h"
+#include "JLog2.h"
+#include "JSaveCsv2.h"
+#include "Functions.h"
+#include "OmpDefs.h"
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+using namespace std;
+
+JTraceProfiler* JTraceProfiler::Active=NULL;
+
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JTraceProfiler::JTraceProfiler(JLog2 *log,ullong maxevents)
+  :Log(log),TimeIni(std::chrono::steady_clock::now()),MaxEvents(maxevents)
+{
+  ClassName="JTraceProfiler";
+  Threads=OMP_MAXTHREADS;
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JTraceProfiler::~JTraceProfiler(){
+  DestructorActive=true;
+  SetActive(false);
+  Reset();
+}
+
+//==============================================================================
+/// Initialisation of variables.
+//==============================================================================
+void JTraceProfiler::Reset(){
+  Regions.clear();
+  Stack.clear();
+  StackTime.clear();
+  Touched.clear();
+  Steps=0;
+  Events.clear();
+  ThEvents.clear();
+  ThEvents.resize(Threads);
+  LostEvents=0;
+  //-Creates root region.
+  GetChild(0,"Root");
+  Stack.push_back(0);
+  StackTime.push_back(Now());
+}
+
+//==============================================================================
+/// Activates or deactivates the profiler.
+//==============================================================================
+void JTraceProfiler::SetActive(bool active){
+  if(active)Active=this;
+  else if(Active==this)Active=NULL;
+}
+
+//==============================================================================
+/// Returns index of the child region with the given name (it is created when
+/// it does not exist).
+//==============================================================================
+unsigned JTraceProfiler::GetChild(unsigned parent,const char *name){
+  if(!Regions.empty()){
+    const vector<unsigned> &ch=Regions[parent].children;
+    for(unsigned c=0;c<unsigned(ch.size());c++){
+      const char *nm=Regions[ch[c]].name;
+      if(nm==name || !strcmp(nm,name))return(ch[c]);
+    }
+  }
+  const unsigned id=unsigned(Regions.size());
+  StRegion r;
+  r.name=name;
+  r.parent=parent;
+  r.depth=(id? Regions[parent].depth+1: 0);
+  r.calls=0;
+  r.total=r.steptime=0;
+  r.steps=0;
+  r.stepmin=DBL_MAX; r.stepmax=0;
+  r.stepsum=r.stepsum2=0;
+  r.hist.resize(HISTOBINS,0);
+  r.thbusy.resize(Threads*THSTRIDE,0);
+  r.thused=false;
+  Regions.push_back(r);
+  if(id)Regions[parent].children.push_back(id);
+  return(id);
+}
+
+//==============================================================================
+/// Starts a region as child of the current region.
+//==============================================================================
+void JTraceProfiler::Start(const char *name){
+  const unsigned id=GetChild(Stack.back(),name);
+  Stack.push_back(id);
+  StackTime.push_back(Now());
+}
+
+//==============================================================================
+/// Stops the last open region with the given name. Open regions started
+/// after it are also stopped. Unknown names are ignored.
+//==============================================================================
+void JTraceProfiler::Stop(const char *name){
+  const double tend=Now();
+  unsigned cs=unsigned(Stack.size());
+  while(cs>1){
+    const char *nm=Regions[Stack[cs-1]].name;
+    if(nm==name || !strcmp(nm,name))break;
+    cs--;
+  }
+  if(cs>1){
+    while(unsigned(Stack.size())>=cs){
+      CloseRegion(Stack.back(),StackTime.back(),tend);
+      Stack.pop_back();
+      StackTime.pop_back();
+    }
+  }
+}
+
+//==============================================================================
+/// Accumulates time of one call of a region and stores the trace event.
+//==============================================================================
+void JTraceProfiler::CloseRegion(unsigned id,double tini,double tend){
+  StRegion &r=Regions[id];
+  const double dur=tend-tini;
+  r.calls++;
+  r.total+=dur;
+  if(r.steptime==0)Touched.push_back(id);
+  r.steptime+=(dur>0? dur: DBL_MIN);
+  if(Events.size()<MaxEvents){
+    StEvent ev={id,tini,dur};
+    Events.push_back(ev);
+  }
+  else LostEvents++;
+}
+
+//==============================================================================
+/// Starts a simulation step. Times of regions out of steps are discarded
+/// from the statistics per step.
+//==============================================================================
+void JTraceProfiler::StepBegin(){
+  for(unsigned c=0;c<unsigned(Touched.size());c++)Regions[Touched[c]].steptime=0;
+  Touched.clear();
+}
+
+//==============================================================================
+/// Finishes a simulation step and updates the statistics per step of the
+/// regions with calls in the step.
+//==============================================================================
+void JTraceProfiler::StepEnd(){
+  for(unsigned c=0;c<unsigned(Touched.size());c++){
+    StRegion &r=Regions[Touched[c]];
+    const double v=r.steptime;
+    r.steps++;
+    if(r.stepmin>v)r.stepmin=v;
+    if(r.stepmax<v)r.stepmax=v;
+    r.stepsum+=v;
+    r.stepsum2+=v*v;
+    r.hist[HistBin(v)]++;
+    r.steptime=0;
+  }
+  Touched.clear();
+  Steps++;
+}
+
+//==============================================================================
+/// Accumulates busy time of current OpenMP thread in the current region of
+/// the main thread. It can be called from several threads at the same time.
+//==============================================================================
+void JTraceProfiler::ThreadBusy(double tini,double tend){
+  const unsigned th=unsigned(omp_get_thread_num());
+  if(th<Threads){
+    StRegion &r=Regions[Stack.back()];
+    r.thbusy[th*THSTRIDE]+=tend-tini;
+    r.thused=true;
+    vector<StEvent> &evs=ThEvents[th];
+    if(evs.size()<MaxEvents){
+      StEvent ev={Stack.back(),tini,tend-tini};
+      evs.push_back(ev);
+    }
+  }
+}
+
+//==============================================================================
+/// Returns bin of histogram for the given time in microseconds.
+/// Bin 0 is [0,1) and bin b>0 is [2^((b-1)/4),2^(b/4)).
+//==============================================================================
+unsigned JTraceProfiler::HistBin(double us){
+  if(us<1.)return(0);
+  const unsigned b=1+unsigned(floor(log2(us)*4.));
+  return(b<HISTOBINS? b: HISTOBINS-1);
+}
+
+//==============================================================================
+/// Returns the lower limit of the bin in microseconds.
+//==============================================================================
+double JTraceProfiler::HistBinIni(unsigned bin){
+  return(bin? pow(2.,double(bin-1)/4.): 0.);
+}
+
+//==============================================================================
+/// Returns approximated percentile (0-1) of times per step from the histogram
+/// (geometric centre of the bin limited to the minimum and maximum values).
+//==============================================================================
+double JTraceProfiler::HistPercentile(const StRegion &r,double pc)const{
+  if(!r.steps)return(0);
+  const ullong nv=ullong(ceil(pc*double(r.steps)));
+  ullong n=0;
+  unsigned b=0;
+  for(;b<HISTOBINS;b++){
+    n+=r.hist[b];
+    if(n>=nv && n)break;
+  }
+  if(b>=HISTOBINS)b=HISTOBINS-1;
+  const double v=(b? HistBinIni(b)*pow(2.,1./8.): 0.5);
+  return(max(r.stepmin,min(r.stepmax,v)));
+}
+
+//==============================================================================
+/// Returns the path of the region (names of parent regions separated by '/').
+//==============================================================================
+std::string JTraceProfiler::GetPath(unsigned id)const{
+  string path=Regions[id].name;
+  for(unsigned p=Regions[id].parent;p;p=Regions[p].parent)path=string(Regions[p].name)+"/"+path;
+  return(path);
+}
+
+//==============================================================================
+/// Returns minimum, mean and maximum busy time of the threads (in seconds).
+//==============================================================================
+void JTraceProfiler::GetThreadsBusy(const StRegion &r,double &bmin,double &bmean,double &bmax)const{
+  const unsigned nth=GetThreadsUsed();
+  bmin=DBL_MAX; bmean=bmax=0;
+  for(unsigned th=0;th<nth;th++){
+    const double v=r.thbusy[th*THSTRIDE]/1.e6;
+    bmin=min(bmin,v); bmax=max(bmax,v); bmean+=v;
+  }
+  bmean/=nth;
+}
+
+//==============================================================================
+/// Returns the number of OpenMP threads with measured busy time.
+//==============================================================================
+unsigned JTraceProfiler::GetThreadsUsed()const{
+  unsigned nth=1;
+  for(unsigned id=0;id<GetRegions();id++)if(Regions[id].thused){
+    for(unsigned th=nth;th<Threads;th++)if(Regions[id].thbusy[th*THSTRIDE]>0)nth=th+1;
+  }
+  return(nth);
+}
+
+//==============================================================================
+/// Shows the summary table of regions (times per step in milliseconds).
+//==============================================================================
+void JTraceProfiler::VisuSummary(const std::string &title)const{
+  if(!title.empty())Log->Print(title);
+  double ttot=0;
+  for(unsigned c=0;c<unsigned(Regions[0].children.size());c++)ttot+=Regions[Regions[0].children[c]].total;
+  Log->Printf("%-34s %9s %10s %6s %8s %9s %9s %9s %9s %9s %9s %6s %6s","Region","Calls","Total[s]","%Run","Steps"
+    ,"Mean[ms]","Std[ms]","Min[ms]","P50[ms]","P95[ms]","Max[ms]","Busy%","Imbal");
+  //-Depth-first order of regions.
+  vector<unsigned> pend;
+  for(unsigned c=unsigned(Regions[0].children.size());c>0;c--)pend.push_back(Regions[0].children[c-1]);
+  while(!pend.empty()){
+    const unsigned id=pend.back(); pend.pop_back();
+    const StRegion &r=Regions[id];
+    for(unsigned c=unsigned(r.children.size());c>0;c--)pend.push_back(r.children[c-1]);
+    const string name=string(2*(r.depth-1),' ')+r.name;
+    string tx=fun::PrintStr("%-34s %9llu %10.3f %6.2f",name.c_str(),r.calls,r.total/1.e6,(ttot? r.total/ttot*100.: 0));
+    if(r.steps){
+      const double mean=r.stepsum/r.steps;
+      const double std=sqrt(max(0.,r.stepsum2/r.steps-mean*mean));
+      tx=tx+fun::PrintStr(" %8llu %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f",r.steps,mean/1.e3,std/1.e3
+        ,r.stepmin/1.e3,HistPercentile(r,0.5)/1.e3,HistPercentile(r,0.95)/1.e3,r.stepmax/1.e3);
+    }
+    else tx=tx+fun::PrintStr(" %8s %9s %9s %9s %9s %9s %9s","-","-","-","-","-","-","-");
+    if(r.thused){
+      double bmin,bmean,bmax;
+      GetThreadsBusy(r,bmin,bmean,bmax);
+      tx=tx+fun::PrintStr(" %6.1f %6.2f",(r.total? bmean*1.e6/r.total*100.: 0),(bmean? bmax/bmean: 0));
+    }
+    Log->Print(tx);
+  }
+  if(LostEvents)Log->Printf("*** %llu trace events were not stored (maximum %llu).",LostEvents,MaxEvents);
+}
+
+//==============================================================================
+/// Saves CSV file with the summary of regions (times in seconds).
+//==============================================================================
+void JTraceProfiler::SaveSummaryCsv(const std::string &file,bool csvsepcoma)const{
+  jcsv::JSaveCsv2 scsv(file,false,csvsepcoma);
+  scsv.SetHead();
+  scsv << "Region;Depth;Calls;Total [s];Steps;StepMean [s];StepStd [s];StepMin [s];StepP50 [s];StepP95 [s];StepMax [s]";
+  scsv << "ThreadBusyMin [s];ThreadBusyMean [s];ThreadBusyMax [s]";
+  const unsigned nth=GetThreadsUsed();
+  for(unsigned th=0;th<nth;th++)scsv << fun::PrintStr("Thread%u [s]",th);
+  scsv << jcsv::Endl();
+  scsv.SetData();
+  scsv << jcsv::Fmt(jcsv::TpDouble1,"%.9g");
+  for(unsigned id=1;id<GetRegions();id++){
+    const StRegion &r=Regions[id];
+    const double mean=(r.steps? r.stepsum/r.steps: 0);
+    const double std=(r.steps? sqrt(max(0.,r.stepsum2/r.steps-mean*mean)): 0);
+    scsv << GetPath(id) << r.depth << r.calls << r.total/1.e6 << r.steps << mean/1.e6 << std/1.e6;
+    scsv << (r.steps? r.stepmin/1.e6: 0) << HistPercentile(r,0.5)/1.e6 << HistPercentile(r,0.95)/1.e6 << r.stepmax/1.e6;
+    double bmin=0,bmean=0,bmax=0;
+    if(r.thused)GetThreadsBusy(r,bmin,bmean,bmax);
+    scsv << bmin << bmean << bmax;
+    for(unsigned th=0;th<nth;th++)scsv << r.thbusy[th*THSTRIDE]/1.e6;
+    scsv << jcsv::Endl();
+  }
+  scsv.SaveData(true);
+  if(Log)Log->AddFileInfo(file,"Saves summary of profiled regions of the simulation.");
+}
+
+//==============================================================================
+/// Saves CSV file with the histograms of time per step of regions.
+//==============================================================================
+void JTraceProfiler::SaveHistogramCsv(const std::string &file,bool csvsepcoma)const{
+  jcsv::JSaveCsv2 scsv(file,false,csvsepcoma);
+  scsv.SetHead();
+  scsv << "Region;BinIni [s];BinEnd [s];Steps" << jcsv::Endl();
+  scsv.SetData();
+  scsv << jcsv::Fmt(jcsv::TpDouble1,"%.6g");
+  for(unsigned id=1;id<GetRegions();id++){
+    const StRegion &r=Regions[id];
+    const string path=GetPath(id);
+    for(unsigned b=0;b<HISTOBINS;b++)if(r.hist[b]){
+      const double bend=(b+1<HISTOBINS? HistBinIni(b+1): DBL_MAX*1.e-6);
+      scsv << path << HistBinIni(b)/1.e6 << bend/1.e6 << r.hist[b] << jcsv::Endl();
+    }
+  }
+  scsv.SaveData(true);
+  if(Log)Log->AddFileInfo(file,"Saves histograms of time per step of profiled regions.");
+}
+
+//==============================================================================
+/// Saves trace events in Chrome trace-event JSON format (for chrome://tracing
+/// or https://ui.perfetto.dev). Thread 0 is the main thread and threads 1-n
+/// are the busy times of OpenMP threads.
+//==============================================================================
+void JTraceProfiler::SaveTraceJson(const std::string &file)const{
+  FILE *pf=fopen(file.c_str(),"wb");
+  if(!pf)Run_ExceptioonFile("Cannot open the file.",file);
+  string tx="{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  tx=tx+"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"DualSPHysics\"}}";
+  tx=tx+",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Main\"}}";
+  for(unsigned th=0;th<Threads;th++)if(!ThEvents[th].empty())
+    tx=tx+fun::PrintStr(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"OpenMP %u\"}}",th+1,th);
+  //-Writes events.
+  char buf[512];
+  for(unsigned th=0;th<=Threads;th++){
+    const vector<StEvent> &evs=(th? ThEvents[th-1]: Events);
+    for(size_t c=0;c<evs.size();c++){
+      const StEvent &ev=evs[c];
+      const int n=snprintf(buf,sizeof(buf),",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}"
+        ,Regions[ev.region].name,(th? "thread": "region"),ev.ts,ev.dur,th);
+      if(n>0)tx.append(buf,min(size_t(n),sizeof(buf)-1));
+      if(tx.size()>(1<<22)){
+        if(fwrite(tx.data(),1,tx.size(),pf)!=tx.size()){ fclose(pf); Run_ExceptioonFile("File writing failure.",file); }
+        tx.clear();
+      }
+    }
+  }
+  tx=tx+"\n]}\n";
+  if(fwrite(tx.data(),1,tx.size(),pf)!=tx.size()){ fclose(pf); Run_ExceptioonFile("File writing failure.",file); }
+  fclose(pf);
+  if(Log)Log->AddFileInfo(file,"Saves profiled regions in Chrome trace-event format (chrome://tracing or ui.perfetto.dev).");
+}
+
@@ -0,0 +1,200 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//:#############################################################################
+//:# Cambios:
+//:# =========
+//:# - Perfilador jerarquico de regiones con estadisticas e histogramas por paso,
+//:#   tiempo ocupado de cada hilo OpenMP y salida en formato Chrome trace-event
+//:#   JSON (chrome://tracing, Perfetto). (19-10-2026)
+//:#############################################################################
+
+/// \file JTraceProfiler.h \brief Declares the class \ref JTraceProfiler and the profiling macros.
+
+#ifndef _JTraceProfiler_
+#define _JTraceProfiler_
+
+#include "TypesDef.h"
+#include "JObject.h"
+#include <string>
+#include <vector>
+#include <chrono>
+
+class JLog2;
+
+//##############################################################################
+//# Profiling macros
+//##############################################################################
+// TprStart(name) / TprStop(name): Starts and stops a region in the main thread.
+// TprScope(name): Region until the end of current scope.
+// TprStep():      Region "Step" until the end of current scope that closes the
+//                 statistics of the simulation step.
+// TprThread():    Busy time of current OpenMP thread until the end of current
+//                 scope (inside a parallel region). It is assigned to the
+//                 region that is open in the main thread.
+// The name must be a string literal. When no profiler is active the cost is
+// one test of a global pointer. With DISABLE_TIMERS the macros are empty.
+#ifdef DISABLE_TIMERS
+  #define TprStart(name) ;
+  #define TprStop(name) ;
+  #define TprScope(name) ;
+  #define TprStep() ;
+  #define TprThread() ;
+#else
+  #define TprStart(name) { if(JTraceProfiler::Active)JTraceProfiler::Active->Start(name); }
+  #define TprStop(name)  { if(JTraceProfiler::Active)JTraceProfiler::Active->Stop(name); }
+  #define TprScope(name) JTraceScope _tprscope(name)
+  #define TprStep()      JTraceStepScope _tprstep
+  #define TprThread()    JTraceThreadScope _tprthread
+#endif
+
+
+//##############################################################################
+//# JTraceProfiler
+//##############################################################################
+/// \brief Hierarchical profiler of regions of the simulation.
+///
+/// Regions are started and stopped in the main thread and form a tree where
+/// the same name under a different parent is a different region. For each
+/// region it stores the number of calls and the total time, the statistics
+/// and a histogram (quarter-octave bins) of the time per simulation step and
+/// the busy time of each OpenMP thread. Each call is also stored as a trace
+/// event (up to a maximum number) to generate a Chrome trace-event JSON file.
+/// Only one profiler can be active (JTraceProfiler::Active).
+
+class JTraceProfiler : protected JObject
+{
+public:
+  static JTraceProfiler *Active;          ///<Active profiler (NULL: profiling is disabled).
+
+protected:
+  static const unsigned HISTOBINS=136;    ///<Bins of histograms (quarter-octave from 1 microsecond).
+  static const unsigned THSTRIDE=8;       ///<Stride of busy time of threads to avoid false sharing.
+
+  /// Region of the tree.
+  typedef struct{
+    const char *name;       ///<Name of region.
+    unsigned parent;        ///<Index of parent region.
+    unsigned depth;         ///<Depth in the tree (root is 0).
+    std::vector<unsigned> children;  ///<Index of child regions.
+    ullong calls;           ///<Number of calls.
+    double total;           ///<Total time (in microseconds).
+    double steptime;        ///<Time in current step (in microseconds).
+    ullong steps;           ///<Number of steps with calls.
+    double stepmin;         ///<Minimum time per step (in microseconds).
+    double stepmax;         ///<Maximum time per step (in microseconds).
+    double stepsum;         ///<Sum of times per step (in microseconds).
+    double stepsum2;        ///<Sum of squared times per step.
+    std::vector<unsigned> hist;      ///<Histogram of times per step [HISTOBINS].
+    std::vector<double> thbusy;      ///<Busy time of each thread [Threads*THSTRIDE] (in microseconds).
+    bool thused;            ///<Busy time of threads was measured.
+  }StRegion;
+
+  /// Trace event.
+  typedef struct{
+    unsigned region;        ///<Index of region.
+    double ts;              ///<Start time (in microseconds).
+    double dur;             ///<Duration (in microseconds).
+  }StEvent;
+
+  JLog2 *Log;
+  const std::chrono::steady_clock::time_point TimeIni;  ///<Reference of time.
+  unsigned Threads;                       ///<Maximum number of OpenMP threads.
+  ullong MaxEvents;                       ///<Maximum number of stored trace events.
+
+  std::vector<StRegion> Regions;          ///<Tree of regions (0 is root).
+  std::vector<unsigned> Stack;            ///<Open regions.
+  std::vector<double> StackTime;          ///<Start time of open regions.
+  std::vector<unsigned> Touched;          ///<Regions with time in current step.
+  ullong Steps;                           ///<Number of closed steps.
+
+  std::vector<StEvent> Events;            ///<Trace events of main thread.
+  std::vector< std::vector<StEvent> > ThEvents;  ///<Trace events of OpenMP threads [Threads].
+  ullong LostEvents;                      ///<Number of events not stored.
+
+  unsigned GetChild(unsigned parent,const char *name);
+  void CloseRegion(unsigned id,double tini,double tend);
+  static unsigned HistBin(double us);
+  static double HistBinIni(unsigned bin);
+  double HistPercentile(const StRegion &r,double pc)const;
+  std::string GetPath(unsigned id)const;
+  void GetThreadsBusy(const StRegion &r,double &bmin,double &bmean,double &bmax)const;
+  unsigned GetThreadsUsed()const;
+
+public:
+  JTraceProfiler(JLog2 *log,ullong maxevents);
+  ~JTraceProfiler();
+  void Reset();
+
+  void SetActive(bool active);
+
+  double Now()const{ return(std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now()-TimeIni).count()); }
+  void Start(const char *name);
+  void Stop(const char *name);
+  void StepBegin();
+  void StepEnd();
+  void ThreadBusy(double tini,double tend);
+
+  ullong GetSteps()const{ return(Steps); }
+  unsigned GetRegions()const{ return(unsigned(Regions.size())); }
+
+  void VisuSummary(const std::string &title)const;
+  void SaveSummaryCsv(const std::string &file,bool csvsepcoma)const;
+  void SaveHistogramCsv(const std::string &file,bool csvsepcoma)const;
+  void SaveTraceJson(const std::string &file)const;
+};
+
+
+//##############################################################################
+//# JTraceScope, JTraceStepScope, JTraceThreadScope
+//##############################################################################
+/// \brief Region of the active profiler until the end of current scope.
+class JTraceScope
+{
+protected:
+  JTraceProfiler *Prof;
+  const char *Name;
+public:
+  JTraceScope(const char *name):Prof(JTraceProfiler::Active),Name(name){ if(Prof)Prof->Start(Name); }
+  ~JTraceScope(){ if(Prof)Prof->Stop(Name); }
+};
+
+/// \brief Region "Step" of the active profiler that closes the statistics of the step.
+class JTraceStepScope
+{
+protected:
+  JTraceProfiler *Prof;
+public:
+  JTraceStepScope():Prof(JTraceProfiler::Active){ if(Prof){ Prof->StepBegin(); Prof->Start("Step"); } }
+  ~JTraceStepScope(){ if(Prof){ Prof->Stop("Step"); Prof->StepEnd(); } }
+};
+
+/// \brief Busy time of current OpenMP thread until the end of current scope.
+class JTraceThreadScope
+{
+protected:
+  JTraceProfiler *Prof;
+  double TimeIni;
+public:
+  JTraceThreadScope():Prof(JTraceProfiler::Active),TimeIni(0){ if(Prof)TimeIni=Prof->Now(); }
+  ~JTraceThreadScope(){ if(Prof)Prof->ThreadBusy(TimeIni,Prof->Now()); }
+};
+
+#endif
+
+
@@ -31,6 +31,7 @@
 #include "JAppInfo.h"
 #include "Functions.h"
 #include "JSaveCsv2.h"
+#include "JSeriesSink.h"
 //:#include "JShapeVtk.h"
 
 #include <cstring>
@@ -55,7 +56,7 @@ JWaveAwasZsurf::JWaveAwasZsurf(JLog2 *log,word mkbound,const JXml *sxml,TiXmlEle
   ClassName="JWaveAwasZsurf";
   GaugeSwl=NULL;
   FileSurf=NULL; FileData=NULL; 
-  FileSurfStep=NULL; 
+  FileSurfStep=UINT_MAX; 
   Reset();
   ReadXml(sxml,lis);
 }
@@ -77,8 +78,8 @@ void JWaveAwasZsurf::Reset(){
   SaveData=0;
   if(FileSurf)delete FileSurf; FileSurf=NULL;
   if(FileData)delete FileData; FileData=NULL;
-  if(FileSurfStep)SaveFileSurfStep();
-  if(FileSurfStep)delete FileSurfStep; FileSurfStep=NULL;
+  if(FileSurfStep!=UINT_MAX)AppInfo.SeriesPtr()->CloseStream(FileSurfStep);
+  FileSurfStep=UINT_MAX;
   GaugeSwl=NULL;
   LimMotionAceMax=LimAceMax=0;
   LimVel=LimAcePre=LimAce=DBL_MAX;
@@ -165,7 +166,6 @@ void JWaveAwasZsurf::Init(JGaugeSystem *gaugesystem,const JSphMk *mkinfo,tdouble
   TimeStepM1=ZsurfM1=0;
   VarNum=0;
   VarZsurf=VarDt=VarZsurfDt=TDouble3(0);
-  SurfStepCount=0;
   if(SaveData)CreateFileSurf(initphase==DBL_MAX,waveperiod,waveheight,wavelength,amplitude,initphase);
   if(SaveData==3)CreateFileSurfStep(0);
   //-Correction for extreme movements.
@@ -233,31 +233,11 @@ void JWaveAwasZsurf::CreateFileSurf(bool spectrum,double waveperiod,double waveh
 //==============================================================================
 void JWaveAwasZsurf::CreateFileSurfStep(unsigned numfile){
   SurfStepFile=numfile;
-  delete FileSurfStep;
+  JSeriesSink *series=AppInfo.SeriesPtr();
+  if(FileSurfStep!=UINT_MAX)series->CloseStream(FileSurfStep);
   Log->AddFileInfo(AppInfo.GetDirOut()+"AWASFreeSurfStep_????.csv","Saves free surface and acceleration information about AWAS operation for each simulation step.");
-  FileSurfStep=new jcsv::JSaveCsv2(AppInfo.GetDirOut()+fun::FileNameSec("AWASFreeSurfStep.csv",SurfStepFile),false,AppInfo.GetCsvSepComa());
-  //-Saves head.
-  FileSurfStep->SetHead();
-  *FileSurfStep << "Timestep [s];Xsurf [m];Zsurf [m];ZsurfTarget [m];AcePre [m/s^2];Ace [m/s^2]" << jcsv::Endl();
-}
-
-//==============================================================================
-/// Graba informacion de free-surface por step.
-//==============================================================================
-void JWaveAwasZsurf::SaveFileSurfStep(){
-  FileSurfStep->SetData();
-  *FileSurfStep << jcsv::Fmt(jcsv::TpDouble1,"%20.12E");
-  for(unsigned c=0;c<SurfStepCount;c++){
-    const tdouble4 v=SurfStepData[c];
-    *FileSurfStep << v.x << v.y << v.z << v.w;
-    if(1){
-      const tdouble2 w=SurfStepData2[c];
-      *FileSurfStep << w.x << w.y;
-    }
-    *FileSurfStep << jcsv::Endl();
-  }
-  FileSurfStep->SaveData();
-  SurfStepCount=0;
+  FileSurfStep=series->AddStream(AppInfo.GetDirOut()+fun::FileNameSec("AWASFreeSurfStep.csv",SurfStepFile),"Timestep [s];Xsurf [m];Zsurf [m];ZsurfTarget [m];AcePre [m/s^2];Ace [m/s^2]");
+  series->Rec(FileSurfStep) << jcsv::Fmt(jcsv::TpDouble1,"%20.12E");
 }
 
 //==============================================================================
@@ -265,11 +245,10 @@ void JWaveAwasZsurf::SaveFileSurfStep(){
 //==============================================================================
 void JWaveAwasZsurf::SaveFileSurfStep(double timestep,double xpos,double zsurf,double zsurftarget){
   const double tmax=(SurfStepFile+1)*5;
-  if(timestep>=tmax || SvDataStep || SurfStepCount==SurfStepSize)SaveFileSurfStep();
   if(timestep>=tmax)CreateFileSurfStep(SurfStepFile+1);
-  SurfStepData[SurfStepCount]=TDouble4(timestep,xpos,zsurf,zsurftarget);
-  SurfStepData2[SurfStepCount]=TDouble2(LimAcePre,LimAce);
-  SurfStepCount++;
+  JSeriesSink *series=AppInfo.SeriesPtr();
+  series->Rec(FileSurfStep) << timestep << xpos << zsurf << zsurftarget << LimAcePre << LimAce << jcsv::Endl();
+  if(SvDataStep)series->Flush(FileSurfStep);
 }
 
 //==============================================================================
@@ -298,7 +277,7 @@ void JWaveAwasZsurf::RunAwas(double timestep,double ztarget,bool svdata){
   if(SaveData){
     TimeStepM1=timestep; ZsurfM1=Zsurf;
     if(SvDataStep)SaveInfoSurf();
-    if(FileSurfStep)SaveFileSurfStep(GaugeSwl->GetResult().timestep,GaugeSwl->GetResult().point0.x,Zsurf,Ztarget);
+    if(FileSurfStep!=UINT_MAX)SaveFileSurfStep(GaugeSwl->GetResult().timestep,GaugeSwl->GetResult().point0.x,Zsurf,Ztarget);
   }
 }
 
@@ -28,6 +28,7 @@
 //# =========
 //# - Clase para la generacion de oleaje con absorcion activa (Didier et al 2012).
 //# - Se escriben las unidades en las cabeceras de los ficheros CSV. (26-04-2018)
+//# - La informacion por step se graba mediante series temporales de JSeriesSink. (19-10-2026)
 //#############################################################################
 
 #ifndef _JWaveAwasZsurf_
@@ -106,7 +107,7 @@ private:
   unsigned NumSave;
   jcsv::JSaveCsv2 *FileSurf;     //-Saves CSV with free-surface information (AWASFreeSurf.csv).
   jcsv::JSaveCsv2 *FileData;     //-Saves CSV with information (AWASData.csv).
-  jcsv::JSaveCsv2 *FileSurfStep; //-Saves CSV with free-surface information (AWASFreeSurfStep_XXXX.csv).
+  unsigned FileSurfStep;         //-Time series with free-surface information (AWASFreeSurfStep_XXXX.csv) (UINT_MAX when it is not used).
 
   //-Variables for stadistical information of zsurf variation.
   double TimeStepM1,ZsurfM1;
@@ -116,11 +117,6 @@ private:
   void SetStats(tdouble3 &var,double v){ var=TDouble3((var.x*VarNum)/(VarNum+1)+v/(VarNum+1),(var.y<=v? var.y: v),(var.z>=v? var.z: v)); }
 
   //-Saves infor per step.
-  //static const unsigned SurfStepSize=1u;       //-Desactiva la grabacion de info por step.
-  static const unsigned SurfStepSize=1000u;  //-Activa la grabacion de info por step.
-  tdouble4 SurfStepData[SurfStepSize]; //-{timestep,xpos,zsurf,zsurftarget}
-  tdouble2 SurfStepData2[SurfStepSize]; //-{LimAcePre,LimAce}
-  unsigned SurfStepCount;
   unsigned SurfStepFile;
 
   //-Limits extreme movements.
@@ -142,7 +138,6 @@ private:
   double GetDriftCorrection(double timecorr)const;
 
   void CreateFileSurfStep(unsigned numfile);
-  void SaveFileSurfStep();
   void SaveFileSurfStep(double timestep,double xpos,double zsurf,double zsurftarget);
 
 public:
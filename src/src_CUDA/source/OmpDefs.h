@@ -27,6 +27,9 @@
 #ifdef OMP_USE
   //#define OMP_USE_RADIXSORT ///<Enables/disables OpenMP in JRadixSort.
   #define OMP_USE_WAVEGEN    ///<Enables/disables OpenMP in JWaveGen.
+  #if defined(_OPENMP) && _OPENMP>=200805
+    #define OMP_USE_RUNTIMESCHED ///<Schedule of interaction loops is set by JDsOmpTuner (requires OpenMP 3.0, otherwise schedule(guided) is used).
+  #endif
 #endif
 
 #ifdef OMP_USE
@@ -38,9 +41,9 @@
 
 #define OMP_MAXTHREADS 64  
 #define OMP_STRIDE 200
-#define OMP_LIMIT_COMPUTESTEP 25000
+#define OMP_LIMIT_COMPUTESTEP 25000    ///<Value by default (it can be tuned by JDsOmpTuner).
 #define OMP_LIMIT_COMPUTEMEDIUM 10000
-#define OMP_LIMIT_COMPUTELIGHT 100000
+#define OMP_LIMIT_COMPUTELIGHT 100000  ///<Value by default (it can be tuned by JDsOmpTuner).
 #define OMP_LIMIT_PREINTERACTION 100000
 #define OMP_LIMIT_TRIANGLESCELLS 3000
 #define OMP_LIMIT_LIGHT 100000
@@ -48,6 +48,11 @@ Please download source files and documentation from <a href="http://dual.sphysic
 #include "JException.h"
 #include "JSphCfgRun.h"
 #include "JSphCpuSingle.h"
+#include "JDsCheckpoint.h"
+#include "JSeriesReader.h"
+#include "JDsGaugeCloudFile.h"
+#include "JDsBenchmark.h"
+#include "JDsRegression.h"
 #ifdef _WITHGPU
   #include "JSphGpuSingle.h"
 #endif
@@ -124,6 +129,74 @@ bool ShowsVersionInfo(int argc,char** argv){
   return(finish);
 }
 
+//==============================================================================
+///  Creates a full checkpoint file from a delta checkpoint and the previous
+///  files of its chain (-checkpointrebuild <file> <fileout>) and finishes the
+///  execution.
+//==============================================================================
+bool RebuildCheckpoint(int argc,char** argv,int &errcode){
+  const string option=fun::StrLower(argc==4? argv[1]: "");
+  if(option!="-checkpointrebuild")return(false);
+  try{
+    JDsCheckpoint::RebuildFile(argv[2],argv[3]);
+    printf("Checkpoint file \"%s\" was created.\n",argv[3]);
+    errcode=0;
+  }
+  catch(const JException &e){}
+  catch(const exception &e){
+    printf("\n*** Exception(exc): %s\n",e.what());
+  }
+  return(true);
+}
+
+//==============================================================================
+///  Converts a binary time series file (.tsb) to CSV format
+///  (-seriescsv <file.tsb> [<file.csv>]) and finishes the execution.
+//==============================================================================
+bool ConvertSeries(int argc,char** argv,int &errcode){
+  const string option=fun::StrLower(argc==3 || argc==4? argv[1]: "");
+  if(option!="-seriescsv")return(false);
+  try{
+    const string file=argv[2];
+    const string filecsv=(argc==4? string(argv[3]): fun::GetWithoutExtension(file)+".csv");
+    JSeriesReader::ConvertToCsv(file,filecsv,false);
+    printf("CSV file \"%s\" was created.\n",filecsv.c_str());
+    errcode=0;
+  }
+  catch(const JException &e){}
+  catch(const exception &e){
+    printf("\n*** Exception(exc): %s\n",e.what());
+  }
+  return(true);
+}
+
+//==============================================================================
+///  Converts the time series of one point of a binary file of probe-cloud
+///  gauge (.gcb) to CSV format (-cloudcsv <file.gcb> <point> [<file.csv>])
+///  and finishes the execution.
+//==============================================================================
+bool ConvertCloud(int argc,char** argv,int &errcode){
+  const string option=fun::StrLower(argc==4 || argc==5? argv[1]: "");
+  if(option!="-cloudcsv")return(false);
+  try{
+    const string file=argv[2];
+    if(!fun::StrIsIntegerNumber(argv[3]) || atoi(argv[3])<0){
+      printf("\n*** Exception: The point '%s' is invalid.\n",argv[3]);
+      return(true);
+    }
+    const unsigned p=unsigned(atoi(argv[3]));
+    const string filecsv=(argc==5? string(argv[4]): fun::GetWithoutExtension(file)+fun::PrintStr("_p%u.csv",p));
+    JGaugeCloudFileLoad::ConvertToCsv(file,p,filecsv,false);
+    printf("CSV file \"%s\" was created.\n",filecsv.c_str());
+    errcode=0;
+  }
+  catch(const JException &e){}
+  catch(const exception &e){
+    printf("\n*** Exception(exc): %s\n",e.what());
+  }
+  return(true);
+}
+
 //==============================================================================
 ///  Print exception message on screen and log file.
 //==============================================================================
@@ -150,6 +223,9 @@ int main(int argc, char** argv){
 #endif
   AppInfo.ConfigRunPaths(argv[0]);
   if(ShowsVersionInfo(argc,argv))return(errcode);
+  if(RebuildCheckpoint(argc,argv,errcode))return(errcode);
+  if(ConvertSeries(argc,argv,errcode))return(errcode);
+  if(ConvertCloud(argc,argv,errcode))return(errcode);
   std::string license=getlicense_lgpl(AppInfo.GetShortName(),false);
   printf("%s",license.c_str());
   std::string appname=AppInfo.GetFullName();
@@ -158,10 +234,46 @@ int main(int argc, char** argv){
   printf("\n%s\n%s\n",appname.c_str(),appnamesub.c_str());
   JLog2 *log=NULL;
   JSphCfgRun cfg;
+  bool testfailed=false;
   try{
     cfg.LoadArgv(argc,argv);
     //cfg.VisuConfig();
-    if(!cfg.PrintInfo){
+    if(!cfg.PrintInfo && cfg.BenchNp){
+      //-Benchmark execution with synthetic case.
+      const string dirout=(!cfg.DirOut.empty()? cfg.DirOut: (!cfg.CaseName.empty()? cfg.CaseName: string("BenchmarkOut")));
+      AppInfo.ConfigOutput(cfg.CreateDirs,cfg.CsvSepComa,dirout,"");
+      AppInfo.LogInit(AppInfo.GetDirOut()+"/Benchmark.out");
+      log=AppInfo.LogPtr();
+      log->AddFileInfo(dirout+"/Benchmark.out","Log file of the benchmark.");
+      log->Print(appname,JLog2::Out_File);
+      log->Print(appnamesub,JLog2::Out_File);
+      AppInfo.SeriesInit(cfg.SvSeriesCsv,cfg.SvSeriesBin);
+      JDsBenchmark bench(&cfg,dirout,log);
+      bench.Run(appname);
+      bench.VisuResults();
+      bench.SaveJson(dirout+"/Benchmark.json");
+      log->PrintFilesList();
+      AppInfo.SeriesFinish();
+    }
+    else if(!cfg.PrintInfo && !cfg.RegDef.empty()){
+      //-Regression tests with reference states and throughput baseline.
+      const string dirout=(!cfg.DirOut.empty()? cfg.DirOut: (!cfg.CaseName.empty()? cfg.CaseName: string("RegressionOut")));
+      AppInfo.ConfigOutput(cfg.CreateDirs,cfg.CsvSepComa,dirout,"");
+      AppInfo.LogInit(AppInfo.GetDirOut()+"/Regression.out");
+      log=AppInfo.LogPtr();
+      log->AddFileInfo(dirout+"/Regression.out","Log file of the regression tests.");
+      log->Print(appname,JLog2::Out_File);
+      log->Print(appnamesub,JLog2::Out_File);
+      AppInfo.SeriesInit(cfg.SvSeriesCsv,cfg.SvSeriesBin);
+      JDsRegression reg(&cfg,dirout,log);
+      reg.Run(appname);
+      reg.VisuResults();
+      reg.SaveJson(dirout+"/Regression.json");
+      log->PrintFilesList();
+      AppInfo.SeriesFinish();
+      testfailed=(reg.GetFailed()!=0);
+    }
+    else if(!cfg.PrintInfo){
       AppInfo.ConfigOutput(cfg.CreateDirs,cfg.CsvSepComa,cfg.DirOut,cfg.DirDataOut);
       AppInfo.LogInit(AppInfo.GetDirOut()+"/Run.out");
       log=AppInfo.LogPtr();
@@ -169,6 +281,7 @@ int main(int argc, char** argv){
       log->Print(license,JLog2::Out_File);
       log->Print(appname,JLog2::Out_File);
       log->Print(appnamesub,JLog2::Out_File);
+      AppInfo.SeriesInit(cfg.SvSeriesCsv,cfg.SvSeriesBin);
       //-SPH Execution.
       #ifndef _WITHGPU
         cfg.Cpu=true;
@@ -183,8 +296,9 @@ int main(int argc, char** argv){
         sph.Run(appname,&cfg,log);
       }
       #endif
+      AppInfo.SeriesFinish();
     }
-    errcode=0;
+    errcode=(testfailed? 1: 0);
   }
   catch(const char *cad){
     PrintExceptionLog("\n*** Exception(chr): ",cad,log);
@@ -0,0 +1,155 @@
+//HEAD_DSPH
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file mainbench.cpp \brief Main file of the micro-benchmarks of the CPU kernels (see \ref JDsBenchCpu).
+
+#include <string>
+#include <cstring>
+#include <fstream>
+#include "JAppInfo.h"
+#include "JLog2.h"
+#include "JException.h"
+#include "JDsBenchCpu.h"
+#include "Functions.h"
+
+#pragma warning(disable : 4996) //Cancels sprintf() deprecated.
+
+using namespace std;
+
+JAppInfo AppInfo("DualSPHysicsBench5","v5.0.140","18-07-2020");
+
+//==============================================================================
+/// Shows help of command line options.
+//==============================================================================
+void PrintHelp(){
+  printf("Usage: %s [options]\n",AppInfo.GetShortName().c_str());
+  printf("  -lattice:<list>   Lattices: tank,dambreak,random (default: tank)\n");
+  printf("  -np:<list>        Number of fluid particles (default: 100000)\n");
+  printf("  -dim:<list>       Dimensions: 2,3 (default: 3)\n");
+  printf("  -cellmode:<list>  Cell modes: full,half (default: full)\n");
+  printf("  -kernel:<list>    Kernels: wendland,cubic (default: wendland)\n");
+  printf("  -reps:<n>         Measured repetitions (default: 10)\n");
+  printf("  -warmup:<n>       Repetitions before measurement (default: 2)\n");
+  printf("  -ompthreads:<n>   OpenMP threads (default: 0 all)\n");
+  printf("  -kernels:<list>   Benchmarked kernels: celldiv,radixsort,ngsearch,\n");
+  printf("                    kernel,interaction (default: all)\n");
+  printf("  -json:<file>      Saves results in JSON format\n");
+  printf("  -h                Shows information about options\n\n");
+  printf("  Lists are separated by commas and all combinations are executed.\n");
+  printf("  Example: %s -lattice:tank,dambreak -np:50000,200000 -cellmode:full,half -json:bench.json\n\n"
+    ,AppInfo.GetShortName().c_str());
+}
+
+//==============================================================================
+/// Splits list of values separated by commas.
+//==============================================================================
+std::vector<std::string> SplitList(const std::string &tx){
+  std::vector<std::string> vec;
+  fun::VectorSplitStr(",",fun::StrLower(tx),vec);
+  return(vec);
+}
+
+//==============================================================================
+//==============================================================================
+int main(int argc, char** argv){
+  int errcode=1;
+#ifdef CODE_SIZE4
+  AppInfo.AddNameExtra("MK65k");
+#endif
+  AppInfo.ConfigRunPaths(argv[0]);
+  const std::string appname=AppInfo.GetFullName();
+  printf("\n%s\n",appname.c_str());
+  JLog2 log(JLog2::Out_Screen);
+  try{
+    //-Loads options.
+    std::vector<std::string> lattices(1,"tank"),nps(1,"100000"),dims(1,"3"),cellmodes(1,"full"),tkernels(1,"wendland");
+    unsigned reps=10,warmup=2;
+    int ompthreads=0;
+    string kernels,filejson;
+    for(int c=1;c<argc;c++){
+      const string opt=argv[c];
+      const string optl=fun::StrLower(opt);
+      const int pos=int(opt.find(':'));
+      const string key=(pos>0? optl.substr(0,pos): optl);
+      const string val=(pos>0? opt.substr(pos+1): string(""));
+      if(key=="-h" || key=="-help" || key=="?"){ PrintHelp(); return(0); }
+      else if(key=="-lattice")   lattices=SplitList(val);
+      else if(key=="-np")        nps=SplitList(val);
+      else if(key=="-dim")       dims=SplitList(val);
+      else if(key=="-cellmode")  cellmodes=SplitList(val);
+      else if(key=="-kernel")    tkernels=SplitList(val);
+      else if(key=="-reps")      reps=max(1u,unsigned(atoi(val.c_str())));
+      else if(key=="-warmup")    warmup=unsigned(max(0,atoi(val.c_str())));
+      else if(key=="-ompthreads")ompthreads=atoi(val.c_str());
+      else if(key=="-kernels")   kernels=fun::StrLower(val);
+      else if(key=="-json")      filejson=val;
+      else fun::Run_ExceptioonFun(string("Parameter \'")+opt+"\' is invalid. Use -h to show the options.");
+    }
+    //-Runs all combinations of cases.
+    std::vector<std::string> vcases;
+    for(unsigned cl=0;cl<unsigned(lattices.size());cl++)
+    for(unsigned cd=0;cd<unsigned(dims.size());cd++)
+    for(unsigned cn=0;cn<unsigned(nps.size());cn++)
+    for(unsigned cm=0;cm<unsigned(cellmodes.size());cm++)
+    for(unsigned ck=0;ck<unsigned(tkernels.size());ck++){
+      StBenchCase cfg;
+      cfg.lattice=JDsBenchCpu::GetLatticeType(lattices[cl]);
+      cfg.sim2d=(dims[cd]=="2" || dims[cd]=="2d");
+      if(!cfg.sim2d && dims[cd]!="3" && dims[cd]!="3d")fun::Run_ExceptioonFun(string("Dimension \'")+dims[cd]+"\' is invalid.");
+      cfg.np=unsigned(atoi(nps[cn].c_str()));
+      if(!cfg.np)fun::Run_ExceptioonFun(string("Number of particles \'")+nps[cn]+"\' is invalid.");
+      if(cellmodes[cm]=="full" || cellmodes[cm]=="2h")cfg.cellmode=CELLMODE_Full;
+      else if(cellmodes[cm]=="half" || cellmodes[cm]=="h")cfg.cellmode=CELLMODE_Half;
+      else fun::Run_ExceptioonFun(string("Cell mode \'")+cellmodes[cm]+"\' is invalid.");
+      if(tkernels[ck]=="wendland")cfg.tkernel=KERNEL_Wendland;
+      else if(tkernels[ck]=="cubic")cfg.tkernel=KERNEL_Cubic;
+      else fun::Run_ExceptioonFun(string("Kernel \'")+tkernels[ck]+"\' is invalid.");
+      cfg.reps=reps;
+      cfg.warmup=warmup;
+      cfg.ompthreads=ompthreads;
+      cfg.kernels=kernels;
+      JDsBenchCpu bench(cfg,&log);
+      bench.RunBench();
+      bench.VisuResults();
+      vcases.push_back(bench.GetJson());
+    }
+    //-Saves results in JSON file.
+    if(!filejson.empty()){
+      std::vector<std::string> v;
+      v.push_back(fun::JSONPropertyValue("build",JDsBenchCpu::GetBuildInfoJson(ompthreads)));
+      v.push_back(fun::JSONPropertyValue("cases",fun::JSONArray(vcases)));
+      ofstream pf;
+      pf.open(filejson.c_str());
+      if(!pf)fun::Run_ExceptioonFileFun("Cannot open the file.",filejson);
+      pf << fun::JSONObject(v) << endl;
+      if(pf.fail())fun::Run_ExceptioonFileFun("File writing failure.",filejson);
+      pf.close();
+      log.Printf("\nFile JSON with results: %s",filejson.c_str());
+    }
+    errcode=0;
+  }
+  catch(const JException &e){
+    printf("\n*** Exception: %s\n",e.what());
+  }
+  catch(const exception &e){
+    printf("\n*** Exception(exc): %s\n",e.what());
+  }
+  printf("\nFinished execution (code=%d).\n",errcode);
+  return(errcode);
+}
+
@@ -39,6 +39,7 @@ void JCfgRun::Reset(){
   FileXml="";
   First=-1;  Last=-1;
   SaveVtk=""; SaveCsv="";
+  SaveVtu=""; VtuZip=false;
 }
 
 //==============================================================================
@@ -58,7 +59,9 @@ void JCfgRun::VisuInfo()const{
   printf("    -last:<int>        Indicates the last file to be computed\n\n");
   printf("  Define output files:\n");
   printf("    -savevtk <file>    Generates VTK(polydata) files with particle data\n");
-  printf("    -savecsv <file>    Generates CSV files with particle data\n\n");
+  printf("    -savecsv <file>    Generates CSV files with particle data\n");
+  printf("    -savevtu <file>    Generates VTK XML files (.vtu) with binary particle data\n");
+  printf("    -vtuzip:<0/1>      Compresses binary data of VTU files using zlib\n\n");
   printf("  Examples:\n");
   printf("     ToVtk4 -dirin . -filexml case.xml -savevkt part.vtk -savecsv: data\n");
   printf("\n");
@@ -77,6 +80,8 @@ void JCfgRun::VisuConfig()const{
   if(Last>=0)PrintVar("  Last",Last,ln);
   PrintVar("  SaveVtk",SaveVtk,ln);
   PrintVar("  SaveCsv",SaveCsv,ln);
+  PrintVar("  SaveVtu",SaveVtu,ln);
+  PrintVar("  VtuZip",VtuZip,ln);
   printf("\n");
 }
 
@@ -190,6 +195,8 @@ void JCfgRun::LoadOpts(std::string *optlis,int optn,int lv,std::string file){
       else if(txword=="LAST"){  Last=atoi(txopt.c_str()); if(Last<0)Last=-1; } 
       else if(txword=="SAVEVTK"&&c+1<optn){ SaveVtk=optlis[c+1]; c++; }
       else if(txword=="SAVECSV"&&c+1<optn){ SaveCsv=optlis[c+1]; c++; }
+      else if(txword=="SAVEVTU"&&c+1<optn){ SaveVtu=optlis[c+1]; c++; }
+      else if(txword=="VTUZIP")VtuZip=(txopt!=""? atoi(txopt.c_str()): 1)!=0;
       else if(txword=="OPT"&&c+1<optn){ LoadFile(optlis[c+1],lv+1); c++; }
       else if(txword=="H"||txword=="HELP"||txword=="?")PrintInfo=true;
       else ErrorParm(opt,c,lv,file);
@@ -202,6 +209,6 @@ void JCfgRun::LoadOpts(std::string *optlis,int optn,int lv,std::string file){
 //==============================================================================
 void JCfgRun::ValidaCfg(){
   const char met[]="ValidaCfg";
-  if(SaveVtk.empty()&&SaveCsv.empty())RunException(met,"Output files were not defined.");
+  if(SaveVtk.empty()&&SaveCsv.empty()&&SaveVtu.empty())RunException(met,"Output files were not defined.");
 }
 
@@ -54,6 +54,8 @@ public:
 
   std::string SaveVtk;
   std::string SaveCsv;
+  std::string SaveVtu;
+  bool VtuZip;
   
 public:
   void ClearFilesIn(){ DirIn=""; FileIn=""; }
@@ -0,0 +1,416 @@
+//HEAD_DSCODES
+/*
+ <DUALSPHYSICS>  Copyright (c) 2020 by Dr Jose M. Dominguez et al. (see http://dual.sphysics.org/index.php/developers/).
+
+ EPHYSLAB Environmental Physics Laboratory, Universidade de Vigo, Ourense, Spain.
+ School of Mechanical, Aerospace and Civil Engineering, University of Manchester, Manchester, U.K.
+
+ This file is part of DualSPHysics.
+
+ DualSPHysics is free software: you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ as published by the Free Software Foundation; either version 2.1 of the License, or (at your option) any later version.
+
+ DualSPHysics is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along with DualSPHysics. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// \file JOutputVtu.cpp \brief Implements the class \ref JOutputVtu.
+
+#include "JOutputVtu.h"
+#include "JDataArrays.h"
+#include "Functions.h"
+#include <fstream>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+#ifndef DISABLE_ZLIB
+  #include <zlib.h>
+#endif
+
+using namespace std;
+
+//##############################################################################
+//# JOutputVtu
+//##############################################################################
+//==============================================================================
+/// Constructor.
+//==============================================================================
+JOutputVtu::JOutputVtu(bool compress,bool createpath)
+  :Compress(compress),CreatPath(createpath)
+{
+  ClassName="JOutputVtu";
+  Reset();
+}
+
+//==============================================================================
+/// Destructor.
+//==============================================================================
+JOutputVtu::~JOutputVtu(){
+  DestructorActive=true;
+  Reset();
+}
+
+//==============================================================================
+/// Initialization of variables.
+//==============================================================================
+void JOutputVtu::Reset(){
+  PieceSize=2000000;
+  FileName="";
+}
+
+//==============================================================================
+/// Returns true when zlib compression is included in the current compilation.
+//==============================================================================
+bool JOutputVtu::AvailableZlib(){
+#ifdef DISABLE_ZLIB
+  return(false);
+#else
+  return(true);
+#endif
+}
+
+//==============================================================================
+/// Returns VTK type name, number of components and size of tuple.
+/// Returns empty string when the type is not supported.
+//==============================================================================
+std::string JOutputVtu::VtkTypeName(TpTypeData type,unsigned &ncomp,unsigned &tsize)const{
+  string tname;
+  ncomp=unsigned(DimOfType(type));
+  tsize=SizeOfType(type);
+  switch(type){
+    case TypeUchar:    tname="UInt8";    break;
+    case TypeUshort:   tname="UInt16";   break;
+    case TypeUint:
+    case TypeUint3:    tname="UInt32";   break;
+    case TypeInt:
+    case TypeInt3:     tname="Int32";    break;
+    case TypeFloat:
+    case TypeFloat3:   tname="Float32";  break;
+    case TypeDouble:
+    case TypeDouble3:  tname="Float64";  break;
+    default: Run_Exceptioon(fun::PrintStr("Type of array \'%s\' is invalid.",TypeToStr(type)));
+  }
+  return(tname);
+}
+
+//==============================================================================
+/// Returns index of position array.
+//==============================================================================
+unsigned JOutputVtu::GetPosIdx(const JDataArrays &arrays,const std::string &posfield)const{
+  const unsigned posidx=arrays.GetIdxName(posfield);
+  if(posidx==UINT_MAX)Run_Exceptioon(fun::PrintStr("Array \'%s\' with positions is missing.",posfield.c_str()));
+  const TpTypeData tpos=arrays.GetArrayCte(posidx).type;
+  if(tpos!=TypeFloat3 && tpos!=TypeDouble3)Run_Exceptioon(fun::PrintStr("Type of array \'%s\' with positions is invalid.",posfield.c_str()));
+  return(posidx);
+}
+
+//==============================================================================
+/// Returns VTK cell type according to the number of vertices per cell.
+//==============================================================================
+byte JOutputVtu::VtkCellType(unsigned cellnv){
+  return(cellnv==4? 9: (cellnv==3? 5: (cellnv==2? 3: 1))); //-VTK_QUAD=9, VTK_TRIANGLE=5, VTK_LINE=3, VTK_VERTEX=1
+}
+
+//==============================================================================
+/// Prepares list of arrays (points, point data and cells) for one piece.
+/// Without connectivity (conn=NULL) one VTK_VERTEX cell is generated per point.
+//==============================================================================
+void JOutputVtu::PrepareArrays(const JDataArrays &arrays,unsigned posidx
+  ,unsigned pini,unsigned np,unsigned ncells,unsigned cellnv,const unsigned *conn
+  ,std::vector<StVtuArray> &vars)const
+{
+  vars.clear();
+  const unsigned na=arrays.Count();
+  for(unsigned ca=0;ca<=na;ca++){
+    //-Points are stored first and then the other arrays.
+    const unsigned cf=(!ca? posidx: ca-1);
+    if(ca && cf==posidx)continue;
+    const JDataArrays::StDataArray &arr=arrays.GetArrayCte(cf);
+    if(!arr.ptr && arr.count)continue; //-Ignores arrays without data.
+    StVtuArray ar;
+    ar.name=(!ca? string(""): arr.keyname);
+    ar.vtktype=VtkTypeName(arr.type,ar.ncomp,ar.tsize);
+    ar.ptr=(const byte*)arr.ptr+ullong(ar.tsize)*pini;
+    ar.gen=0;
+    ar.cellnv=0;
+    ar.nbytes=ullong(ar.tsize)*np;
+    ar.offset=0;
+    vars.push_back(ar);
+  }
+  //-Cells (connectivity, offsets and types).
+  for(int cg=1;cg<=3;cg++){
+    StVtuArray ar;
+    ar.name=(cg==1? "connectivity": (cg==2? "offsets": "types"));
+    ar.vtktype=(cg==3? "UInt8": "Int32");
+    ar.ncomp=1;
+    ar.tsize=(cg==3? 1: 4);
+    ar.ptr=(cg==1 && conn? (const byte*)conn: NULL);
+    ar.gen=(ar.ptr? 0: cg);
+    ar.cellnv=cellnv;
+    ar.nbytes=ullong(ar.tsize)*ncells*(cg==1? cellnv: 1);
+    ar.offset=0;
+    vars.push_back(ar);
+  }
+}
+
+//==============================================================================
+/// Copies or generates data of one block of an array.
+/// The value of byteini must be a multiple of BLOCKSIZE.
+//==============================================================================
+void JOutputVtu::FillBlock(const StVtuArray &ar,ullong byteini,unsigned nbytes,byte *buf){
+  if(!ar.gen)memcpy(buf,ar.ptr+byteini,nbytes);
+  else if(ar.gen==3)memset(buf,VtkCellType(ar.cellnv),nbytes);
+  else{
+    const int e0=int(byteini/4)+(ar.gen==2? 1: 0);
+    const int step=(ar.gen==2? int(ar.cellnv): 1);
+    const unsigned n=nbytes/4;
+    int *v=(int*)buf;
+    for(unsigned c=0;c<n;c++)v[c]=(e0+int(c))*step;
+  }
+}
+
+//==============================================================================
+/// Compresses data of array by blocks using zlib. Returns error message.
+//==============================================================================
+std::string JOutputVtu::CompressArray(StVtuArray &ar)const{
+  string err;
+#ifdef DISABLE_ZLIB
+  err="Compression of VTU files is not available (zlib is not included in the current compilation).";
+#else
+  const ullong nblocks=(ar.nbytes+BLOCKSIZE-1)/BLOCKSIZE;
+  ar.zhead.assign(size_t(3+nblocks),0);
+  ar.zhead[0]=nblocks;
+  ar.zhead[1]=BLOCKSIZE;
+  ar.zhead[2]=ar.nbytes%BLOCKSIZE;
+  ar.zdata.clear();
+  const uLong zbound=compressBound(BLOCKSIZE);
+  byte *buf=(ar.gen? new byte[BLOCKSIZE]: NULL);
+  byte *zbuf=new byte[zbound];
+  for(ullong cb=0;cb<nblocks && err.empty();cb++){
+    const ullong byteini=cb*BLOCKSIZE;
+    const unsigned nbytes=unsigned(min(ullong(BLOCKSIZE),ar.nbytes-byteini));
+    const byte *src=ar.ptr+byteini;
+    if(buf){ FillBlock(ar,byteini,nbytes,buf); src=buf; }
+    uLongf zsize=zbound;
+    if(compress2(zbuf,&zsize,src,uLong(nbytes),Z_DEFAULT_COMPRESSION)!=Z_OK)err="Error compressing data with zlib.";
+    else{
+      ar.zhead[3+cb]=zsize;
+      ar.zdata.insert(ar.zdata.end(),zbuf,zbuf+zsize);
+    }
+  }
+  delete[] buf;
+  delete[] zbuf;
+#endif
+  return(err);
+}
+
+//==============================================================================
+/// Saves one piece in VTU format with appended raw data. Returns error message.
+/// Does not throw exceptions so it can be called from parallel regions.
+//==============================================================================
+std::string JOutputVtu::SavePiece(const std::string &fname,const JDataArrays &arrays
+  ,unsigned posidx,unsigned pini,unsigned np,unsigned ncells,unsigned cellnv,const unsigned *conn)const
+{
+  if(np>unsigned(INT_MAX) || ullong(ncells)*cellnv>unsigned(INT_MAX))return("The number of points of one piece exceeds the limit of Int32 connectivity.");
+  std::vector<StVtuArray> vars;
+  PrepareArrays(arrays,posidx,pini,np,ncells,cellnv,conn,vars);
+  const unsigned nv=unsigned(vars.size());
+  //-Compresses data and computes offsets in appended data.
+  string err;
+  ullong offset=0;
+  for(unsigned cv=0;cv<nv && err.empty();cv++){
+    StVtuArray &ar=vars[cv];
+    ar.offset=offset;
+    if(Compress){
+      err=CompressArray(ar);
+      offset+=sizeof(ullong)*ar.zhead.size()+ar.zdata.size();
+    }
+    else offset+=sizeof(ullong)+ar.nbytes;
+  }
+  if(!err.empty())return(err);
+  //-Saves XML head.
+  const unsigned tst=1;
+  const bool littleendian=(*((const byte*)&tst)==1);
+  ofstream pf;
+  pf.open(fname.c_str(),ios::binary);
+  if(!pf)return("Cannot open the file.");
+  pf << "<?xml version=\"1.0\"?>\n";
+  pf << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"" << (littleendian? "LittleEndian": "BigEndian") << "\" header_type=\"UInt64\"";
+  if(Compress)pf << " compressor=\"vtkZLibDataCompressor\"";
+  pf << ">\n";
+  pf << "  <UnstructuredGrid>\n";
+  pf << "    <Piece NumberOfPoints=\"" << np << "\" NumberOfCells=\"" << ncells << "\">\n";
+  for(unsigned cv=0;cv<nv;cv++){
+    const StVtuArray &ar=vars[cv];
+    if(cv==1 && nv>4)pf << "      <PointData>\n";
+    if(cv==nv-3)pf << (nv>4? "      </PointData>\n": "") << "      <Cells>\n";
+    if(!cv)pf << "      <Points>\n";
+    pf << "        <DataArray type=\"" << ar.vtktype << "\"";
+    if(!ar.name.empty())pf << " Name=\"" << ar.name << "\"";
+    if(ar.ncomp>1)pf << " NumberOfComponents=\"" << ar.ncomp << "\"";
+    pf << " format=\"appended\" offset=\"" << ar.offset << "\"/>\n";
+    if(!cv)pf << "      </Points>\n";
+  }
+  pf << "      </Cells>\n";
+  pf << "    </Piece>\n";
+  pf << "  </UnstructuredGrid>\n";
+  pf << "  <AppendedData encoding=\"raw\">\n   _";
+  //-Saves appended data.
+  byte *buf=NULL;
+  for(unsigned cv=0;cv<nv && !pf.fail();cv++){
+    const StVtuArray &ar=vars[cv];
+    if(Compress){
+      pf.write((const char*)ar.zhead.data(),sizeof(ullong)*ar.zhead.size());
+      if(!ar.zdata.empty())pf.write((const char*)ar.zdata.data(),ar.zdata.size());
+    }
+    else{
+      const ullong nbytes=ar.nbytes;
+      pf.write((const char*)&nbytes,sizeof(ullong));
+      if(!ar.gen)pf.write((const char*)ar.ptr,ar.nbytes);
+      else{
+        if(!buf)buf=new byte[BLOCKSIZE];
+        for(ullong byteini=0;byteini<ar.nbytes;byteini+=BLOCKSIZE){
+          const unsigned nb=unsigned(min(ullong(BLOCKSIZE),ar.nbytes-byteini));
+          FillBlock(ar,byteini,nb,buf);
+          pf.write((const char*)buf,nb);
+        }
+      }
+    }
+  }
+  delete[] buf;
+  pf << "\n  </AppendedData>\n";
+  pf << "</VTKFile>\n";
+  if(pf.fail())err="File writing failure.";
+  pf.close();
+  return(err);
+}
+
+//==============================================================================
+/// Stores data in one VTU file (UnstructuredGrid with vertex cells).
+//==============================================================================
+void JOutputVtu::SaveVtu(std::string fname,const JDataArrays &arrays,std::string posfield){
+  if(fun::GetExtension(fname).empty())fname=fun::AddExtension(fname,".vtu");
+  FileName=fname;
+  const unsigned np=arrays.GetDataCount(true);
+  if(np!=arrays.GetDataCount(false))Run_ExceptioonFile("The number of values in arrays is not the same.",fname);
+  const unsigned posidx=GetPosIdx(arrays,posfield);
+  if(CreatPath)fun::MkdirPath(fun::GetDirParent(fname));
+  const string err=SavePiece(fname,arrays,posidx,0,np,np,1,NULL);
+  if(!err.empty())Run_ExceptioonFile(err,fname);
+}
+
+//==============================================================================
+/// Stores data in one VTU file (UnstructuredGrid) with cells of cellnv vertices
+/// (2:lines, 3:triangles, 4:quads). Connectivity conn[ncells*cellnv] contains indices
+/// of points.
+//==============================================================================
+void JOutputVtu::SaveVtuCells(std::string fname,const JDataArrays &arrays,std::string posfield
+  ,unsigned cellnv,unsigned ncells,const unsigned *conn)
+{
+  if(fun::GetExtension(fname).empty())fname=fun::AddExtension(fname,".vtu");
+  FileName=fname;
+  if(cellnv<1 || cellnv>4)Run_ExceptioonFile(fun::PrintStr("The number of vertices per cell (%u) is invalid.",cellnv),fname);
+  if(ncells && !conn)Run_ExceptioonFile("The connectivity of cells is missing.",fname);
+  const unsigned np=arrays.GetDataCount(true);
+  if(np!=arrays.GetDataCount(false))Run_ExceptioonFile("The number of values in arrays is not the same.",fname);
+  const unsigned posidx=GetPosIdx(arrays,posfield);
+  if(CreatPath)fun::MkdirPath(fun::GetDirParent(fname));
+  const string err=SavePiece(fname,arrays,posidx,0,np,ncells,cellnv,conn);
+  if(!err.empty())Run_ExceptioonFile(err,fname);
+}
+
+//==============================================================================
+/// Stores data in several VTU pieces written in parallel and one PVTU index.
+/// When npieces is 0, the number of pieces is computed using PieceSize.
+/// Pieces are named <fname>_000.vtu, <fname>_001.vtu...
+//==============================================================================
+void JOutputVtu::SavePvtu(std::string fname,const JDataArrays &arrays,std::string posfield,unsigned npieces){
+  if(fun::GetExtension(fname).empty())fname=fun::AddExtension(fname,".pvtu");
+  FileName=fname;
+  const unsigned np=arrays.GetDataCount(true);
+  if(np!=arrays.GetDataCount(false))Run_ExceptioonFile("The number of values in arrays is not the same.",fname);
+  const unsigned posidx=GetPosIdx(arrays,posfield);
+  if(!npieces)npieces=max(1u,(np+PieceSize-1)/max(1u,PieceSize));
+  if(CreatPath)fun::MkdirPath(fun::GetDirParent(fname));
+  std::vector<StVtuArray> vars;
+  PrepareArrays(arrays,posidx,0,0,0,1,NULL,vars);
+  //-Saves pieces in parallel.
+  const string fbase=fun::GetWithoutExtension(fname);
+  const int npie=int(npieces);
+  string err,errfile;
+  #ifdef _OPENMP
+    #pragma omp parallel for schedule (dynamic)
+  #endif
+  for(int cp=0;cp<npie;cp++){
+    const unsigned pini=unsigned(ullong(np)*cp/npie);
+    const unsigned pfin=unsigned(ullong(np)*(cp+1)/npie);
+    const string fpie=fbase+fun::PrintStr("_%03d.vtu",cp);
+    const string e=SavePiece(fpie,arrays,posidx,pini,pfin-pini,pfin-pini,1,NULL);
+    if(!e.empty()){
+      #ifdef _OPENMP
+        #pragma omp critical
+      #endif
+      { err=e; errfile=fpie; }
+    }
+  }
+  if(!err.empty())Run_ExceptioonFile(err,errfile);
+  //-Saves PVTU index.
+  const unsigned tst=1;
+  const bool littleendian=(*((const byte*)&tst)==1);
+  const unsigned nv=unsigned(vars.size())-3;
+  ofstream pf;
+  pf.open(fname.c_str());
+  if(pf){
+    pf << "<?xml version=\"1.0\"?>\n";
+    pf << "<VTKFile type=\"PUnstructuredGrid\" version=\"1.0\" byte_order=\"" << (littleendian? "LittleEndian": "BigEndian") << "\" header_type=\"UInt64\">\n";
+    pf << "  <PUnstructuredGrid GhostLevel=\"0\">\n";
+    if(nv>1){
+      pf << "    <PPointData>\n";
+      for(unsigned cv=1;cv<nv;cv++){
+        const StVtuArray &ar=vars[cv];
+        pf << "      <PDataArray type=\"" << ar.vtktype << "\" Name=\"" << ar.name << "\"";
+        if(ar.ncomp>1)pf << " NumberOfComponents=\"" << ar.ncomp << "\"";
+        pf << "/>\n";
+      }
+      pf << "    </PPointData>\n";
+    }
+    pf << "    <PPoints>\n";
+    pf << "      <PDataArray type=\"" << vars[0].vtktype << "\" NumberOfComponents=\"3\"/>\n";
+    pf << "    </PPoints>\n";
+    for(int cp=0;cp<npie;cp++)pf << "    <Piece Source=\"" << fun::GetFile(fbase) << fun::PrintStr("_%03d.vtu",cp) << "\"/>\n";
+    pf << "  </PUnstructuredGrid>\n";
+    pf << "</VTKFile>\n";
+    if(pf.fail())Run_ExceptioonFile("File writing failure.",fname);
+    pf.close();
+  }
+  else Run_ExceptioonFile("Cannot open the file.",fname);
+}
+
+//==============================================================================
+/// Stores PVD file with the list of files of a time series. The names of files
+/// are written relative to the directory of the PVD file.
+//==============================================================================
+void JOutputVtu::SavePvd(const std::string &fname,const std::vector<std::string> &files
+  ,const std::vector<double> &times)
+{
+  if(files.size()!=times.size())Run_ExceptioonFile("The number of files and times is not the same.",fname);
+  ofstream pf;
+  pf.open(fname.c_str());
+  if(!pf)Run_ExceptioonFile("Cannot open the file.",fname);
+  pf << "<?xml version=\"1.0\"?>\n";
+  pf << "<VTKFile type=\"Collection\" version=\"1.0\">\n";
+  pf << "  <Collection>\n";
+  for(size_t c=0;c<files.size();c++){
+    pf << "    <DataSet timestep=\"" << fun::DoubleStr(times[c],"%.12g") << "\" part=\"0\" file=\"" << fun::GetFile(files[c]) << "\"/>\n";
+  }
+  pf << "  </Collection>\n";
+  pf << "</VTKFile>\n";
+  if(pf.fail())Run_ExceptioonFile("File writing failure.",fname);
+  pf.close();
+}
+
@@ -23,6 +23,7 @@
 #include "JVtkLib.h"
 #include "JDataArrays.h"
 #include "JOutputCsv.h"
+#include "JOutputVtu.h"
 #include "JXml.h"
 #include "JSpaceCtes.h"
 #include "JSpaceEParms.h"
@@ -40,7 +41,7 @@
 using std::string;
 using std::exception;
 
-const char *APP_NAME="ToVtk v5.0.027 (28-06-2020)";
+const char *APP_NAME="ToVtk v5.0.028 (19-10-2026)";
 
 //==============================================================================
 // Invoca una excepcion referente a gestion de ficheros
@@ -200,6 +201,15 @@ void RunFiles(const JCfgRun *cfg){
       JOutputCsv ocsv(false,true);
       ocsv.SaveCsv(fileout,arrays);
     }
+    //-Saves VTU files.
+    if(!cfg->SaveVtu.empty()){
+      string fileout=(onefile? cfg->SaveVtu: fun::FileNameSec(cfg->SaveVtu,part));
+      if(fun::GetExtension(fileout).empty())fileout=fun::AddExtension(fileout,"vtu");
+      printf("SaveVTU> %s\n",fun::ShortFileName(fileout,68).c_str());
+      JOutputVtu ovtu(cfg->VtuZip,true);
+      if(np>ovtu.PieceSize)ovtu.SavePvtu(fun::GetWithoutExtension(fileout)+".pvtu",arrays,"Pos");
+      else ovtu.SaveVtu(fileout,arrays,"Pos");
+    }
 
     firstdata=false;
     if(!onefile){